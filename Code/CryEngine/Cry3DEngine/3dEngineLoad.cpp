@@ -816,24 +816,35 @@ bool C3DEngine::LoadLevel(const char* szFolderName, const char* szMissionName)
 	SAFE_DELETE(m_pGlobalIlluminationManager);
 	m_pGlobalIlluminationManager = new CGlobalIlluminationManager();
 
+	// the level CGF's are read and parsed by job workers while the main thread loads the materials
+	const bool bPreloadObjects = GetCVars()->e_StatObjPreload && !gEnv->IsEditor();
+	if (bPreloadObjects)
+		m_pObjManager->BeginPreloadLevelObjects();
+
 	gEnv->pSystem->SetSystemGlobalState(ESYSTEM_GLOBAL_STATE_LEVEL_LOAD_START_MATERIALS);
-	if (GetCVars()->e_PreloadMaterials)
 	{
-		// Preload materials.
-		GetMatMan()->PreloadLevelMaterials();
+		LOADING_TIME_PROFILE_SECTION_NAMED("C3DEngine::LoadLevel_Materials");
+		if (GetCVars()->e_PreloadMaterials)
+		{
+			// Preload materials.
+			GetMatMan()->PreloadLevelMaterials();
+		}
+		if (GetCVars()->e_PreloadDecals)
+		{
+			// Preload materials.
+			GetMatMan()->PreloadDecalMaterials();
+		}
 	}
-	if (GetCVars()->e_PreloadDecals)
+
 	{
-		// Preload materials.
-		GetMatMan()->PreloadDecalMaterials();
+		LOADING_TIME_PROFILE_SECTION_NAMED("C3DEngine::LoadLevel_MergedMeshes");
+		// Preload any geometry used by merged meshes
+		m_pMergedMeshesManager->PreloadMeshes();
 	}
 
-	// Preload any geometry used by merged meshes
-	m_pMergedMeshesManager->PreloadMeshes();
-
 	gEnv->pSystem->SetSystemGlobalState(ESYSTEM_GLOBAL_STATE_LEVEL_LOAD_START_OBJECTS);
 	// preload level cgfs
-	if (GetCVars()->e_StatObjPreload && !gEnv->IsEditor())
+	if (bPreloadObjects)
 	{
 		if (GetCVars()->e_StatObjPreload == 2)
 			GetSystem()->OutputLoadingTimeStats();
@@ -848,6 +859,7 @@ bool C3DEngine::LoadLevel(const char* szFolderName, const char* szMissionName)
 		gEnv->pSystem->SetSystemGlobalState(ESYSTEM_GLOBAL_STATE_LEVEL_LOAD_START_CHARACTERS);
 		if (gEnv->pCharacterManager)
 		{
+			LOADING_TIME_PROFILE_SECTION_NAMED("C3DEngine::LoadLevel_Characters");
 			PrintMessage("Starting loading level characters ...");
 			INDENT_LOG_DURING_SCOPE();
 			float fStartTime = GetCurAsyncTimeSec();
@@ -942,10 +954,13 @@ bool C3DEngine::LoadLevel(const char* szFolderName, const char* szMissionName)
 
 	COctreeNode::FreeLoadingCache();
 
-	// Preload any geometry used by merged meshes
-	if (m_pMergedMeshesManager->SyncPreparationStep() == false)
 	{
-		Error("some merged meshes failed to prepare properly (missing cgfs, re-export?!)");
+		LOADING_TIME_PROFILE_SECTION_NAMED("C3DEngine::LoadLevel_MergedMeshesSync");
+		// Preload any geometry used by merged meshes
+		if (m_pMergedMeshesManager->SyncPreparationStep() == false)
+		{
+			Error("some merged meshes failed to prepare properly (missing cgfs, re-export?!)");
+		}
 	}
 
 	// re-create particles and decals
@@ -983,8 +998,11 @@ bool C3DEngine::LoadLevel(const char* szFolderName, const char* szMissionName)
 	}
 
 	PrintMessage("===== Load level physics data =====");
-	LoadPhysicsData();
-	LoadFlaresData();
+	{
+		LOADING_TIME_PROFILE_SECTION_NAMED("C3DEngine::LoadLevel_Physics");
+		LoadPhysicsData();
+		LoadFlaresData();
+	}
 
 	// restore game state
 	EnableOceanRendering(true);
@@ -992,7 +1010,10 @@ bool C3DEngine::LoadLevel(const char* szFolderName, const char* szMissionName)
 
 	PrintMessage("===== loading occlusion mesh =====");
 
-	GetObjManager()->LoadOcclusionMesh(szFolderName);
+	{
+		LOADING_TIME_PROFILE_SECTION_NAMED("C3DEngine::LoadLevel_OcclusionMesh");
+		GetObjManager()->LoadOcclusionMesh(szFolderName);
+	}
 
 	PrintMessage("===== Finished loading static world =====");
 
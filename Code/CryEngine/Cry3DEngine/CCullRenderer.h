@@ -85,8 +85,23 @@ class CCullRenderer
 public:
 	enum { RESOLUTION_X = SIZEX };
 	enum { RESOLUTION_Y = SIZEY };
+	enum { DEPTH_BLOCK_SIZE = 8 };
+	enum { DEPTH_BLOCKS_X = SIZEX / DEPTH_BLOCK_SIZE };
+	enum { DEPTH_BLOCKS_Y = SIZEY / DEPTH_BLOCK_SIZE };
+	enum { TILE_LINES = DEPTH_BLOCK_SIZE };            // a tile is a line of depth blocks
+	enum { TILE_COUNT = SIZEY / TILE_LINES };
 private:
 
+	// triangle as set up by Triangle2D, V0 holds the projected x and y but the unprojected z like V1 and V2
+	struct SBinnedTriangle
+	{
+		NVMath::vec4 V0;
+		NVMath::vec4 V1;
+		NVMath::vec4 V2;
+		NVMath::vec4 VMinMax;
+		NVMath::vec4 V210;
+	};
+
 	CRY_ALIGN(16) NVMath::vec4 m_VMaxXY;
 	static CRY_ALIGN(128) float m_ZBufferMainMemory[SIZEX * SIZEY];
 	uint32    m_SizeX4;
@@ -105,7 +120,16 @@ private:
 	uint32 m_DrawCall;
 	uint32 m_PolyCount;
 
-	template<bool WRITE, bool CULL, bool CULL_BACKFACES>
+	SBinnedTriangle* m_pBinnedTriangles;
+	uint32           m_BinnedTriangleCount;
+	uint32           m_BinnedTriangleCapacity;
+	PodArray<uint32> m_TileBins[TILE_COUNT];
+
+	// farthest depth of each block, boxes behind all blocks they cover are occluded without testing their pixels
+	tdZexel m_DepthBlockMax[DEPTH_BLOCKS_X * DEPTH_BLOCKS_Y];
+	bool    m_DepthBlocksValid;
+
+	template<bool WRITE, bool CULL, bool CULL_BACKFACES, bool BIN = false>
 	CULLINLINE bool Triangle(
 	  const NVMath::vec4& rV0,
 	  const NVMath::vec4& rV1,
@@ -137,7 +161,7 @@ private:
 				const vec4 M1 = Div(F0, Sub(F0, F1));
 				const vec4 P0 = Madd(Sub(V2, V0), M0, V0);
 				const vec4 P1 = Madd(Sub(V1, V0), M1, V0);
-				Visible = Triangle2D<WRITE, CULL, true, CULL_BACKFACES>(P0, P1, V1);
+				Visible = Triangle2D<WRITE, CULL, true, CULL_BACKFACES, BIN>(P0, P1, V1);
 				V0 = P0;
 			}
 			break;
@@ -150,7 +174,7 @@ private:
 				const vec4 M1 = Div(F1, Sub(F1, F2));
 				const vec4 P0 = Madd(Sub(V0, V1), M0, V1);
 				const vec4 P1 = Madd(Sub(V2, V1), M1, V1);
-				Visible = Triangle2D<WRITE, CULL, true, CULL_BACKFACES>(P0, P1, V2);
+				Visible = Triangle2D<WRITE, CULL, true, CULL_BACKFACES, BIN>(P0, P1, V2);
 				V1 = P0;
 			}
 			break;
@@ -174,7 +198,7 @@ private:
 				const vec4 M1 = Div(F2, Sub(F2, F0));
 				const vec4 P0 = Madd(Sub(V1, V2), M0, V2);
 				const vec4 P1 = Madd(Sub(V0, V2), M1, V2);
-				Visible = Triangle2D<WRITE, CULL, true, CULL_BACKFACES>(V0, P0, P1);
+				Visible = Triangle2D<WRITE, CULL, true, CULL_BACKFACES, BIN>(V0, P0, P1);
 				V2 = P0;
 			}
 			break;
@@ -208,10 +232,10 @@ private:
 #endif
 		}
 
-		return Visible | Triangle2D<WRITE, CULL, true, CULL_BACKFACES>(V0, V1, V2);
+		return Visible | Triangle2D<WRITE, CULL, true, CULL_BACKFACES, BIN>(V0, V1, V2);
 	}
 
-	template<bool WRITE, bool CULL, bool PROJECT, bool CULL_BACKFACES>
+	template<bool WRITE, bool CULL, bool PROJECT, bool CULL_BACKFACES, bool BIN = false>
 #if CRY_PLATFORM_WINDOWS && CRY_PLATFORM_32BIT
 	CULLINLINE bool Triangle2D(NVMath::vec4 rV0, NVMath::vec4 rV1, NVMath::vec4 rV2, uint32 MinX = 0, uint32 MinY = 0, uint32 MaxX = 0, uint32 MaxY = 0, NVMath::vec4& VMinMax = NVMath::Vec4Zero(), NVMath::vec4& V210 = NVMath::Vec4Zero())
 #else
@@ -271,6 +295,24 @@ private:
 
 		VMinMax = And(VMinMax, MaskNot3);
 
+		if (BIN)                                //compile time
+		{
+			BinTriangle(V0, rV0, rV1, rV2, MinY, MaxY, VMinMax, V210);
+			return false;
+		}
+
+		return Triangle2DLines<WRITE, CULL>(V0, rV0, rV1, rV2, MinX, MinY, MaxX, MinY, MaxY, VMinMax, V210);
+	}
+
+	// Rasterizes the lines StartY to EndY of a triangle set up by Triangle2D. The edge functions are stepped line by
+	// line from MinY, so a tile gets the same values as rasterizing the whole triangle at once.
+	template<bool WRITE, bool CULL>
+	CULLINLINE bool Triangle2DLines(const NVMath::vec4& V0, const NVMath::vec4& rV0, const NVMath::vec4& rV1, const NVMath::vec4& rV2,
+	                                uint32 MinX, uint32 MinY, uint32 MaxX, uint32 StartY, uint32 EndY,
+	                                NVMath::vec4 VMinMax, const NVMath::vec4& V210)
+	{
+		using namespace NVMath;
+
 #ifdef CULL_RENDERER_MINZ
 		const vec4 VMinZ = Splat<2>(Min(Min(rV0, rV1), rV2));
 #endif
@@ -292,8 +334,13 @@ private:
 		const vec4 Y24 = Sub(Vec4Zero(), Mul(Y20, Vec4Four()));
 		const vec4 Y34 = Add(Y14, Y24);
 
+		for (uint32 Line = MinY; Line < StartY; Line++)
+		{
+			dy4 = Add(dy4, Vec4One());
+		}
+
 		vec4 Visible = Vec4FFFFFFFF();
-		uint16 y = MinY;
+		uint16 y = StartY;
 		do
 		{
 			vec4 Px = Madd(X10, dy4, Y1x);
@@ -342,7 +389,7 @@ private:
 
 			dy4 = Add(dy4, Vec4One());
 		}
-		while (y < MaxY);
+		while (y < EndY);
 
 		return CULL && (SignMask(Visible) & (BitX | BitY | BitZ | BitW)) != (BitX | BitY | BitZ | BitW);
 	}
@@ -445,6 +492,111 @@ private:
 		return false;
 	}
 
+	CULLINLINE void BinTriangle(const NVMath::vec4& V0, const NVMath::vec4& rV0, const NVMath::vec4& rV1, const NVMath::vec4& rV2,
+	                            uint32 MinY, uint32 MaxY, const NVMath::vec4& VMinMax, const NVMath::vec4& V210)
+	{
+		using namespace NVMath;
+		if (m_BinnedTriangleCount == m_BinnedTriangleCapacity)
+		{
+			GrowBinnedTriangles();
+		}
+
+		SBinnedTriangle& rTriangle = m_pBinnedTriangles[m_BinnedTriangleCount];
+		rTriangle.V0 = SelectBits(rV0, V0, NVMath::Vec4(~0u, ~0u, 0u, ~0u));
+		rTriangle.V1 = rV1;
+		rTriangle.V2 = rV2;
+		rTriangle.VMinMax = VMinMax;
+		rTriangle.V210 = V210;
+
+		for (uint32 Tile = MinY / TILE_LINES, LastTile = (MaxY - 1) / TILE_LINES; Tile <= LastTile; Tile++)
+		{
+			m_TileBins[Tile].push_back(m_BinnedTriangleCount);
+		}
+		m_BinnedTriangleCount++;
+	}
+
+	void GrowBinnedTriangles()
+	{
+		const uint32 Capacity = max(m_BinnedTriangleCapacity * 2, 4096u);
+		SBinnedTriangle* pTriangles = reinterpret_cast<SBinnedTriangle*>(CryModuleMemalign(sizeof(SBinnedTriangle) * Capacity, 128));
+		if (m_pBinnedTriangles)
+		{
+			memcpy(pTriangles, m_pBinnedTriangles, sizeof(SBinnedTriangle) * m_BinnedTriangleCount);
+			CryModuleMemalignFree(m_pBinnedTriangles);
+		}
+		m_pBinnedTriangles = pTriangles;
+		m_BinnedTriangleCapacity = Capacity;
+	}
+
+	// True if the triangle can't pass the depth test anywhere in the blocks of a tile it overlaps
+	CULLINLINE bool IsBehindDepthBlocks(const SBinnedTriangle& rTriangle, const tdZexel* pBlockMax, uint32 MinX, uint32 MaxX) const
+	{
+		const float Z0 = reinterpret_cast<const float*>(&rTriangle.V0)[2];
+		const float Z1 = reinterpret_cast<const float*>(&rTriangle.V1)[2];
+		const float Z2 = reinterpret_cast<const float*>(&rTriangle.V2)[2];
+		// the interpolated depth can be a bit below the nearest vertex by rounding
+		const float MinZ = min(min(Z0, Z1), Z2) - max(max(fabsf(Z0), fabsf(Z1)), fabsf(Z2)) * 1e-4f;
+
+		// the last group of 4 pixels may reach beyond MaxX
+		for (uint32 Block = MinX / DEPTH_BLOCK_SIZE, LastBlock = (((MaxX + 3) & ~3) - 1) / DEPTH_BLOCK_SIZE; Block <= LastBlock; Block++)
+		{
+			if (pBlockMax[Block] >= MinZ)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// True if the box is behind all blocks its projection covers, its faces would fail the depth test in every pixel.
+	// Only valid if all corners are in front of the near plane.
+	CULLINLINE bool IsBehindDepthBlocks(const NVMath::vec4& VB0, const NVMath::vec4& VB1, const NVMath::vec4& VB2, const NVMath::vec4& VB3,
+	                                    const NVMath::vec4& VB4, const NVMath::vec4& VB5, const NVMath::vec4& VB6, const NVMath::vec4& VB7) const
+	{
+		using namespace NVMath;
+		const vec4 P0 = Div(VB0, Splat<3>(VB0));
+		const vec4 P1 = Div(VB1, Splat<3>(VB1));
+		const vec4 P2 = Div(VB2, Splat<3>(VB2));
+		const vec4 P3 = Div(VB3, Splat<3>(VB3));
+		const vec4 P4 = Div(VB4, Splat<3>(VB4));
+		const vec4 P5 = Div(VB5, Splat<3>(VB5));
+		const vec4 P6 = Div(VB6, Splat<3>(VB6));
+		const vec4 P7 = Div(VB7, Splat<3>(VB7));
+		const vec4 PMin = Min(Min(Min(P0, P1), Min(P2, P3)), Min(Min(P4, P5), Min(P6, P7)));
+		const vec4 PMax = Max(Max(Max(P0, P1), Max(P2, P3)), Max(Max(P4, P5), Max(P6, P7)));
+		const vec4 VMinZ = Min(Min(Min(VB0, VB1), Min(VB2, VB3)), Min(Min(VB4, VB5), Min(VB6, VB7)));
+
+		// a pixel of border for the rounding of the edge functions
+		const float* pMin = reinterpret_cast<const float*>(&PMin);
+		const float* pMax = reinterpret_cast<const float*>(&PMax);
+		const float MinX = pMin[0] - 1.f;
+		const float MinY = pMin[1] - 1.f;
+		const float MaxX = pMax[0] + 1.f;
+		const float MaxY = pMax[1] + 1.f;
+		if (!(MinX < MaxX && MinY < MaxY))
+		{
+			return false;
+		}
+
+		const float MinZ = reinterpret_cast<const float*>(&VMinZ)[2];
+		const uint32 BlockMinX = static_cast<uint32>(clamp_tpl(MinX, 0.f, SIZEX - 1.f)) / DEPTH_BLOCK_SIZE;
+		const uint32 BlockMinY = static_cast<uint32>(clamp_tpl(MinY, 0.f, SIZEY - 1.f)) / DEPTH_BLOCK_SIZE;
+		const uint32 BlockMaxX = static_cast<uint32>(clamp_tpl(MaxX, 0.f, SIZEX - 1.f)) / DEPTH_BLOCK_SIZE;
+		const uint32 BlockMaxY = static_cast<uint32>(clamp_tpl(MaxY, 0.f, SIZEY - 1.f)) / DEPTH_BLOCK_SIZE;
+		for (uint32 y = BlockMinY; y <= BlockMaxY; y++)
+		{
+			const tdZexel* pBlockMax = &m_DepthBlockMax[y * DEPTH_BLOCKS_X];
+			for (uint32 x = BlockMinX; x <= BlockMaxX; x++)
+			{
+				if (pBlockMax[x] > MinZ)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
 	void Show();
 public:
 
@@ -456,10 +608,18 @@ public:
 		m_DebugRender = 0;
 		m_nNumWorker = 0;
 		m_ZBufferSwap = NULL;
+		m_pBinnedTriangles = NULL;
+		m_BinnedTriangleCount = 0;
+		m_BinnedTriangleCapacity = 0;
+		m_DepthBlocksValid = false;
 	}
 
 	~CCullRenderer()
 	{
+		if (m_pBinnedTriangles)
+		{
+			CryModuleMemalignFree(m_pBinnedTriangles);
+		}
 		for (uint32 i = 0; i < m_nNumWorker; ++i)
 		{
 			CryModuleMemalignFree(m_ZBufferSwap[i]);
@@ -491,6 +651,81 @@ public:
 		}
 		m_DrawCall = 0;
 		m_PolyCount = 0;
+		m_DepthBlocksValid = false;
+	}
+
+	// Drops the triangles binned by Rasterize<NEEDCLIPPING, true>
+	void ResetBins()
+	{
+		m_BinnedTriangleCount = 0;
+		for (uint32 a = 0; a < TILE_COUNT; a++)
+		{
+			m_TileBins[a].clear();
+		}
+	}
+
+	// Rasterizes the binned triangles into the tiles of the lines StartLine to StartLine + NumLines. Tiles don't
+	// share pixels, jobs can rasterize different tiles at the same time. The result is the same as rasterizing the
+	// triangles directly, the triangles are drawn in the order they were binned.
+	void RasterizeTiles(uint32 StartLine, uint32 NumLines)
+	{
+		for (uint32 Tile = StartLine / TILE_LINES, EndTile = (StartLine + NumLines) / TILE_LINES; Tile < EndTile; Tile++)
+		{
+			const uint32 TileMinY = Tile * TILE_LINES;
+			const uint32 TileMaxY = TileMinY + TILE_LINES;
+			const PodArray<uint32>& rBin = m_TileBins[Tile];
+
+			// the triangles only lower the depth, the blocks before rasterizing skip the triangles behind them
+			UpdateDepthBlocks(TileMinY, TILE_LINES);
+			const tdZexel* pBlockMax = &m_DepthBlockMax[Tile * DEPTH_BLOCKS_X];
+
+			for (size_t a = 0, S = rBin.size(); a < S; a++)
+			{
+				const SBinnedTriangle& rTriangle = m_pBinnedTriangles[rBin[a]];
+				const uint32* pMM = reinterpret_cast<const uint32*>(&rTriangle.VMinMax);
+				const uint32 MinX = pMM[0];
+				const uint32 MinY = pMM[1];
+				const uint32 MaxX = pMM[2];
+				const uint32 MaxY = pMM[3];
+				if (IsBehindDepthBlocks(rTriangle, pBlockMax, MinX, MaxX))
+				{
+					continue;
+				}
+
+				Triangle2DLines<true, false>(rTriangle.V0, rTriangle.V0, rTriangle.V1, rTriangle.V2, MinX, MinY, MaxX,
+				                             max(MinY, TileMinY), min(MaxY, TileMaxY), rTriangle.VMinMax, rTriangle.V210);
+			}
+
+			UpdateDepthBlocks(TileMinY, TILE_LINES);
+		}
+	}
+
+	void UpdateDepthBlocks(uint32 StartLine, uint32 NumLines)
+	{
+		using namespace NVMath;
+		for (uint32 y = StartLine / DEPTH_BLOCK_SIZE, EndY = (StartLine + NumLines) / DEPTH_BLOCK_SIZE; y < EndY; y++)
+		{
+			const vec4* pSrcZ = reinterpret_cast<const vec4*>(&m_ZBuffer[y * DEPTH_BLOCK_SIZE * SIZEX]);
+			for (uint32 x = 0; x < DEPTH_BLOCKS_X; x++, pSrcZ += DEPTH_BLOCK_SIZE / 4)
+			{
+				vec4 VMax = pSrcZ[0];
+				for (uint32 b = 0; b < DEPTH_BLOCK_SIZE; b++)
+				{
+					for (uint32 c = 0; c < DEPTH_BLOCK_SIZE / 4; c++)
+					{
+						VMax = Max(VMax, pSrcZ[b * (SIZEX / 4) + c]);
+					}
+				}
+				const float* pMax = reinterpret_cast<const float*>(&VMax);
+				m_DepthBlockMax[y * DEPTH_BLOCKS_X + x] = max(max(pMax[0], pMax[1]), max(pMax[2], pMax[3]));
+			}
+		}
+	}
+
+	// TestAABB uses the depth blocks once they are updated for the whole buffer
+	void SetDepthBlocksValid(bool bValid)
+	{
+		m_DepthBlocksValid = bValid;
 	}
 
 	bool DownLoadHWDepthBuffer(float nearPlane, float farPlane, float nearestMax, float Bias)
@@ -498,6 +733,7 @@ public:
 		Matrix44A& Reproject = m_Reproject;
 
 		m_VMaxXY = NVMath::int32Tofloat(NVMath::Vec4(SIZEX, SIZEY, SIZEX, SIZEY));
+		m_DepthBlocksValid = false;
 
 		Matrix44 Dummy;
 		if (!gEnv->pRenderer->GetOcclusionBuffer((uint16*)&m_ZBuffer[0], SizeX(), SizeY(), &Dummy, reinterpret_cast<Matrix44*>(&Reproject)))
@@ -1108,6 +1344,11 @@ public:
 		}
 		else
 		{
+			if (m_DepthBlocksValid && IsBehindDepthBlocks(VB0, VB1, VB2, VB3, VB4, VB5, VB6, VB7))
+			{
+				return false;
+			}
+
 			if (Max.x < ViewPos.x)
 			{
 				//if(Quad2D(VB3,VB2,VB6,VB7))return true;
@@ -1184,13 +1425,15 @@ public:
 		return false;
 	}
 
-	template<bool NEEDCLIPPING>
+	// With BIN the triangles are only set up and binned into tiles, RasterizeTiles draws them
+	template<bool NEEDCLIPPING, bool BIN = false>
 	CULLNOINLINE void Rasterize(const NVMath::vec4* pViewProj, const NVMath::vec4* __restrict pTriangles, size_t TriCount)
 	{
 		using namespace NVMath;
 		Prefetch<ECL_LVL1>(pTriangles);
 		m_DrawCall++;
 		m_PolyCount += TriCount;
+		m_DepthBlocksValid = false;
 
 		const vec4 M0 = pViewProj[0];
 		const vec4 M1 = pViewProj[1];
@@ -1237,7 +1480,7 @@ public:
 			{
 				for (size_t b = 0; b < VTmpCount; b += 3)
 				{
-					Triangle<true, false, true>(VTmp[b], VTmp[b + 2], VTmp[b + 1]);
+					Triangle<true, false, true, BIN>(VTmp[b], VTmp[b + 2], VTmp[b + 1]);
 				}
 			}
 			else
@@ -1381,7 +1624,7 @@ public:
 					const uint16 MaxY = pMM[3];
 					if (MinX < MaxX && MinY < MaxY)
 					{
-						Triangle2D<true, false, false, true>(VTmp[b], VTmp[b + 2], VTmp[b + 1], MinX, MinY, MaxX, MaxY, pDetTmp[0], pDetTmp[1]);
+						Triangle2D<true, false, false, true, BIN>(VTmp[b], VTmp[b + 2], VTmp[b + 1], MinX, MinY, MaxX, MaxY, pDetTmp[0], pDetTmp[1]);
 					}
 				}
 			}
@@ -1559,6 +1802,10 @@ public:
 #endif
 	}
 
+	CULLINLINE const tdZexel* ZBuffer() const
+	{
+		return m_ZBuffer;
+	}
 	CULLINLINE uint32 SizeX() const
 	{
 		return SIZEX;
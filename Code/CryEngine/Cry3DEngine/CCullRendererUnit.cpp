@@ -0,0 +1,143 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Compares the tiled rasterization and the depth blocks of the
+//               coverage buffer with the direct rasterization
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include <CrySystem/CryUnitTest.h>
+#include "CCullRenderer.h"
+
+CRY_UNIT_TEST_SUITE(CryCoverageBufferTest)
+{
+	typedef NAsyncCull::CCullRenderer<64, 32> TCullRenderer;
+
+	CRY_UNIT_TEST_FIXTURE(CCoverageBufferTests)
+	{
+	public:
+		enum { MAX_TRIANGLES = 512 };
+
+		virtual void Init()
+		{
+			m_pRenderer = new(CryModuleMemalign(sizeof(TCullRenderer), 128))TCullRenderer();
+			m_pViewProj = reinterpret_cast<NVMath::vec4*>(CryModuleMemalign(sizeof(NVMath::vec4) * (4 + MAX_TRIANGLES * 3), 16));
+			m_pVertices = m_pViewProj + 4;
+			m_RandomState = 0x5eed;
+
+			// camera at the origin looking along z, the near plane at 0.5
+			m_pViewProj[0] = NVMath::Vec4(32.f, 0.f, 0.f, 0.f);
+			m_pViewProj[1] = NVMath::Vec4(0.f, 32.f, 0.f, 0.f);
+			m_pViewProj[2] = NVMath::Vec4(32.f, 16.f, 1.f, 1.f);
+			m_pViewProj[3] = NVMath::Vec4(0.f, 0.f, -0.5f, 0.f);
+		}
+
+		virtual void Done()
+		{
+			m_pRenderer->~TCullRenderer();
+			CryModuleMemalignFree(m_pRenderer);
+			CryModuleMemalignFree(m_pViewProj);
+		}
+
+		float Random(float min, float max)
+		{
+			m_RandomState = m_RandomState * 1664525u + 1013904223u;
+			return min + (max - min) * float(m_RandomState >> 8) / float(1 << 24);
+		}
+
+		void MakeTriangles(size_t count, float minZ, float maxZ, float size)
+		{
+			for (size_t a = 0; a < count * 3; a += 3)
+			{
+				const float z = Random(minZ, maxZ);
+				const Vec3 center(Random(-1.2f, 1.2f) * z, Random(-1.2f, 1.2f) * z, z);
+				for (size_t b = 0; b < 3; b++)
+				{
+					const Vec3 v = center + Vec3(Random(-size, size) * z, Random(-size, size) * z, Random(-size, size) * z);
+					m_pVertices[a + b] = NVMath::Vec4(v.x, v.y, max(v.z, 0.01f), 1.f);
+				}
+			}
+		}
+
+		template<bool NEEDCLIPPING>
+		void Rasterize(size_t count, bool bTiles)
+		{
+			m_pRenderer->Clear();
+			if (!bTiles)
+			{
+				m_pRenderer->Rasterize<NEEDCLIPPING>(m_pViewProj, m_pVertices, count * 3);
+				return;
+			}
+
+			m_pRenderer->ResetBins();
+			m_pRenderer->Rasterize<NEEDCLIPPING, true>(m_pViewProj, m_pVertices, count * 3);
+			// the tiles are independent, the order they are rasterized in doesn't matter
+			for (int Line = TCullRenderer::RESOLUTION_Y - TCullRenderer::TILE_LINES; Line >= 0; Line -= TCullRenderer::TILE_LINES)
+			{
+				m_pRenderer->RasterizeTiles(Line, TCullRenderer::TILE_LINES);
+			}
+		}
+
+		template<bool NEEDCLIPPING>
+		bool TilesMatchDirect(size_t count)
+		{
+			const size_t size = TCullRenderer::RESOLUTION_X * TCullRenderer::RESOLUTION_Y;
+			Rasterize<NEEDCLIPPING>(count, false);
+			std::vector<float> direct(m_pRenderer->ZBuffer(), m_pRenderer->ZBuffer() + size);
+			Rasterize<NEEDCLIPPING>(count, true);
+
+			size_t covered = 0;
+			for (size_t a = 0; a < size; a++)
+			{
+				covered += direct[a] < 9999999999.f ? 1 : 0;
+			}
+			return covered > 0 && memcmp(&direct[0], m_pRenderer->ZBuffer(), size * sizeof(float)) == 0;
+		}
+
+		TCullRenderer* m_pRenderer;
+		NVMath::vec4*  m_pViewProj;
+		NVMath::vec4*  m_pVertices;
+		uint32         m_RandomState;
+	};
+
+	CRY_UNIT_TEST_WITH_FIXTURE(CCullRenderer_TilesMatchDirect, CCoverageBufferTests)
+	{
+		MakeTriangles(MAX_TRIANGLES, 1.f, 20.f, 0.4f);
+		CRY_UNIT_TEST_ASSERT(TilesMatchDirect<false>(MAX_TRIANGLES));
+	}
+
+	CRY_UNIT_TEST_WITH_FIXTURE(CCullRenderer_TilesMatchDirectClipped, CCoverageBufferTests)
+	{
+		// triangles crossing the near plane
+		MakeTriangles(MAX_TRIANGLES, 0.2f, 4.f, 0.6f);
+		CRY_UNIT_TEST_ASSERT(TilesMatchDirect<true>(MAX_TRIANGLES));
+	}
+
+	CRY_UNIT_TEST_WITH_FIXTURE(CCullRenderer_DepthBlocksMatchPixelTest, CCoverageBufferTests)
+	{
+		MakeTriangles(64, 2.f, 10.f, 0.5f);
+		Rasterize<false>(64, false);
+
+		uint32 numVisible = 0;
+		uint32 numMismatches = 0;
+		for (uint32 a = 0; a < 2000; a++)
+		{
+			const float z = Random(1.f, 30.f);
+			const Vec3 center(Random(-1.2f, 1.2f) * z, Random(-1.2f, 1.2f) * z, z);
+			const Vec3 extents(Random(0.02f, 0.2f) * z, Random(0.02f, 0.2f) * z, Random(0.02f, 0.2f) * z);
+
+			m_pRenderer->SetDepthBlocksValid(false);
+			const bool bPixelTest = m_pRenderer->TestAABB(m_pViewProj, center - extents, center + extents, Vec3(ZERO));
+			m_pRenderer->UpdateDepthBlocks(0, TCullRenderer::RESOLUTION_Y);
+			m_pRenderer->SetDepthBlocksValid(true);
+			const bool bDepthBlocks = m_pRenderer->TestAABB(m_pViewProj, center - extents, center + extents, Vec3(ZERO));
+
+			numVisible += bPixelTest ? 1 : 0;
+			numMismatches += bPixelTest != bDepthBlocks ? 1 : 0;
+		}
+		CRY_UNIT_TEST_ASSERT(numVisible > 0 && numVisible < 2000);
+		CRY_UNIT_TEST_ASSERT(numMismatches == 0);
+	}
+}
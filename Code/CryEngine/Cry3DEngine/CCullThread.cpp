@@ -13,6 +13,7 @@ DECLARE_JOB("PrepareOcclusion_ReprojectZBuffer", TOcclusionPrepareReprojectJob,
 DECLARE_JOB("PrepareOcclusion_ReprojectZBufferLine", TOcclusionPrepareReprojectLineJob, NAsyncCull::CCullThread::PrepareOcclusion_ReprojectZBufferLine);
 DECLARE_JOB("PrepareOcclusion_ReprojectZBufferLineAfterMerge", TOcclusionPrepareReprojectLineJob2, NAsyncCull::CCullThread::PrepareOcclusion_ReprojectZBufferLineAfterMerge);
 DECLARE_JOB("PrepareOcclusion_RasterizeZBuffer", TOcclusionPrepareRasterizeJob, NAsyncCull::CCullThread::PrepareOcclusion_RasterizeZBuffer);
+DECLARE_JOB("PrepareOcclusion_RasterizeZBufferTiles", TOcclusionPrepareRasterizeTilesJob, NAsyncCull::CCullThread::PrepareOcclusion_RasterizeZBufferTiles);
 
 typedef NAsyncCull::CCullRenderer<CULL_SIZEX, CULL_SIZEY> tdCullRasterizer;
 
@@ -32,6 +33,7 @@ CCullThread::CCullThread()
 	, m_nPrepareState(IDLE)
 	, m_nRunningReprojJobs(0)
 	, m_nRunningReprojJobsAfterMerge(0)
+	, m_nRunningRasterizeTileJobs(0)
 	, m_bCheckOcclusionRequested(0)
 	, m_pCheckOcclusionJob(nullptr)
 	, m_ViewDir(ZERO)
@@ -414,7 +416,7 @@ float DistToBox(Vec3 Center, Vec3 Extends, Vec3 ViewPos)
 	return Delta.x * Delta.x + Delta.y * Delta.y + Delta.z * Delta.z;
 }
 
-void CCullThread::RasterizeZBuffer(uint32 PolyLimit)
+void CCullThread::RasterizeZBuffer(uint32 PolyLimit, bool bBinTiles)
 {
 	if (m_OCMInstCount == 0)
 	{
@@ -533,7 +535,14 @@ void CCullThread::RasterizeZBuffer(uint32 PolyLimit)
 		const size_t TriCount = *reinterpret_cast<const uint32*>(pMesh);
 		const size_t Tris16 = (reinterpret_cast<size_t>(pMesh + 4) + 15) & ~15;
 		const int8* pTris = reinterpret_cast<const int8*>(Tris16);
-		if (InFrustum & 2)
+		if (bBinTiles)
+		{
+			if (InFrustum & 2)
+				RASTERIZER.Rasterize<true, true>(reinterpret_cast<NVMath::vec4*>(&rTmp1), reinterpret_cast<const NVMath::vec4*>(pTris), TriCount);
+			else
+				RASTERIZER.Rasterize<false, true>(reinterpret_cast<NVMath::vec4*>(&rTmp1), reinterpret_cast<const NVMath::vec4*>(pTris), TriCount);
+		}
+		else if (InFrustum & 2)
 			RASTERIZER.Rasterize<true>(reinterpret_cast<NVMath::vec4*>(&rTmp1), reinterpret_cast<const NVMath::vec4*>(pTris), TriCount);
 		else
 			RASTERIZER.Rasterize<false>(reinterpret_cast<NVMath::vec4*>(&rTmp1), reinterpret_cast<const NVMath::vec4*>(pTris), TriCount);
@@ -660,6 +669,7 @@ void CCullThread::PrepareOcclusion_ReprojectZBufferLineAfterMerge(int nStartLine
 void CCullThread::PrepareOcclusion_RasterizeZBuffer()
 {
 	m_Enabled = true;
+	bool bBinTiles = false;
 	if (!GetCVars()->e_CameraFreeze)
 	{
 		int bHWZBuffer = GetCVars()->e_CoverageBufferReproj;
@@ -673,10 +683,50 @@ void CCullThread::PrepareOcclusion_RasterizeZBuffer()
 			CRY_PROFILE_REGION(PROFILE_3DENGINE, "Rasterize Z-Buffer");
 			CRYPROFILE_SCOPE_PROFILE_MARKER("Rasterize Z-Buffer");
 			m_Enabled = true;
-			RasterizeZBuffer((uint32)PolyLimit);
+			bBinTiles = GetCVars()->e_CoverageBufferTiles != 0;
+			if (bBinTiles)
+				RASTERIZER.ResetBins();
+			RasterizeZBuffer((uint32)PolyLimit, bBinTiles);
 		}
 	}
 
+	if (bBinTiles)
+	{
+		// the tile jobs update the depth blocks of their lines, the last one finishes the preparation
+		enum { nLinesPerJob = tdCullRasterizer::TILE_LINES };
+		m_nRunningRasterizeTileJobs = tdCullRasterizer::RESOLUTION_Y / nLinesPerJob;
+		for (int i = 0; i < tdCullRasterizer::RESOLUTION_Y; i += nLinesPerJob)
+		{
+			TOcclusionPrepareRasterizeTilesJob job((int)i, (int)nLinesPerJob);
+			job.SetClassInstance(this);
+			job.SetPriorityLevel(JobManager::eHighPriority);
+			job.Run();
+		}
+		return;
+	}
+
+	RASTERIZER.UpdateDepthBlocks(0, tdCullRasterizer::RESOLUTION_Y);
+	RASTERIZER.SetDepthBlocksValid(true);
+	PrepareOcclusion_Finish();
+}
+
+void CCullThread::PrepareOcclusion_RasterizeZBufferTiles(int nStartLine, int nNumLines)
+{
+	{
+		CRY_PROFILE_REGION(PROFILE_3DENGINE, "Rasterize Z-Buffer Tiles");
+		RASTERIZER.RasterizeTiles(nStartLine, nNumLines);
+	}
+
+	uint32 nRemainingJobs = CryInterlockedDecrement((volatile int*)&m_nRunningRasterizeTileJobs);
+	if (nRemainingJobs == 0)
+	{
+		RASTERIZER.SetDepthBlocksValid(true);
+		PrepareOcclusion_Finish();
+	}
+}
+
+void CCullThread::PrepareOcclusion_Finish()
+{
 	bool bNeedJobStart = false;
 	{
 		AUTO_LOCK(m_FollowUpLock);
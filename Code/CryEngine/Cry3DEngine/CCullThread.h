@@ -21,6 +21,7 @@ public:
 	char m_passInfoForCheckOcclusion[sizeof(SRenderingPassInfo)];
 	uint32 m_nRunningReprojJobs;
 	uint32 m_nRunningReprojJobsAfterMerge;
+	uint32 m_nRunningRasterizeTileJobs;
 	int m_bCheckOcclusionRequested;
 private:
 	void* m_pCheckOcclusionJob;
@@ -69,7 +70,8 @@ private:
 		return rData;
 	}
 
-	void RasterizeZBuffer(uint32 PolyLimit);
+	void RasterizeZBuffer(uint32 PolyLimit, bool bBinTiles);
+	void PrepareOcclusion_Finish();
 	void OutputMeshList();
 
 public:
@@ -78,6 +80,7 @@ public:
 	void PrepareOcclusion();
 
 	void PrepareOcclusion_RasterizeZBuffer();
+	void PrepareOcclusion_RasterizeZBufferTiles(int nStartLine, int nNumLines);
 	void PrepareOcclusion_ReprojectZBuffer();
 	void PrepareOcclusion_ReprojectZBufferLine(int nStartLine, int nNumLines);
 	void PrepareOcclusion_ReprojectZBufferLineAfterMerge(int nStartLine, int nNumLines);
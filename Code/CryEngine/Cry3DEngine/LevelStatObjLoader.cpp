@@ -0,0 +1,283 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "LevelStatObjLoader.h"
+#include "ObjMan.h"
+#include "CGF/CGFLoader.h"
+#include <Cry3DEngine/CGF/CGFContent.h>
+#include <CryThreading/IJobManager_JobDelegator.h>
+
+struct CLevelStatObjLoader::SFile
+{
+	string                pathName;
+	int                   nFamily;
+	bool                  bLod;
+	unsigned long         nLoadingFlags;
+	IReadStreamPtr        pStream;
+	JobManager::SJobState jobState;
+	SParsedCGF*           pParsed; // set by the stream callback, reset by the job if parsing fails
+};
+
+DECLARE_JOB("LevelStatObjParse", TLevelStatObjParseJob, CLevelStatObjLoader::ParseJobEntry);
+
+CLevelStatObjLoader* CLevelStatObjLoader::s_pActive = NULL;
+
+//////////////////////////////////////////////////////////////////////////
+CLevelStatObjLoader::SParsedCGF::SParsedCGF(const char* szFileName, bool bLod)
+	: chunkFile(false, bLod)
+	, pContent(new CContentCGF(szFileName))
+{
+}
+
+CLevelStatObjLoader::SParsedCGF::~SParsedCGF()
+{
+	delete pContent;
+}
+
+//////////////////////////////////////////////////////////////////////////
+CLevelStatObjLoader::CLevelStatObjLoader()
+	: m_nNextFamily(0)
+	, m_nNextToLoad(0)
+	, m_nInLevelCacheCount(0)
+	, m_nParseTimeUS(0)
+	, m_nNumParsed(0)
+{
+}
+
+CLevelStatObjLoader::~CLevelStatObjLoader()
+{
+	assert(s_pActive != this);
+
+	for (TFileMap::iterator it = m_files.begin(); it != m_files.end(); ++it)
+	{
+		if (it->second->pStream)
+			it->second->pStream->Abort();
+	}
+
+	while (!m_files.empty())
+	{
+		SFile* pFile = m_files.begin()->second;
+		m_files.erase(m_files.begin());
+		FinishFile(pFile);
+	}
+}
+
+void CLevelStatObjLoader::AddFile(const char* szFileName, bool bUseStreaming)
+{
+	SFamily family;
+	family.name = szFileName;
+	family.name.replace('\\', '/'); // as CObjManager::LoadStatObj names the object
+	family.bUseStreaming = bUseStreaming;
+	m_families.push_back(family);
+}
+
+void CLevelStatObjLoader::StartReading()
+{
+	const int nEnd = min((int)m_families.size(), m_nNextToLoad + max(GetCVars()->e_StatObjPreloadAhead, 0));
+	for (; m_nNextFamily < nEnd; ++m_nNextFamily)
+		StartFamily(m_nNextFamily);
+}
+
+void CLevelStatObjLoader::LoadAll()
+{
+	LOADING_TIME_PROFILE_SECTION;
+
+	const bool bVerboseLogging = GetCVars()->e_StatObjPreload > 1;
+	const float fStartTime = GetCurAsyncTimeSec();
+
+	s_pActive = this;
+
+	for (; m_nNextToLoad < (int)m_families.size(); ++m_nNextToLoad)
+	{
+		StartReading();
+
+		const SFamily& family = m_families[m_nNextToLoad];
+		if (bVerboseLogging)
+			CryLog("%s", family.name.c_str());
+
+		CStatObj* pStatObj = GetObjManager()->LoadStatObj(family.name.c_str(), NULL, 0, family.bUseStreaming, 0);
+		if (pStatObj && pStatObj->m_bMeshStrippedCGF)
+			m_nInLevelCacheCount++;
+
+		// the LODs which weren't asked for
+		FinishFamily(m_nNextToLoad);
+
+		//This loop can take a few seconds, so we should refresh the loading screen and call the loading tick functions to ensure that no big gaps in coverage occur.
+		SYNCHRONOUS_LOADING_TICK();
+	}
+
+	s_pActive = NULL;
+
+	if (m_nNumParsed)
+		PrintMessage("Parsed %d CGF's ahead in %.1f sec of job time, %.1f sec on the main thread", (int)m_nNumParsed, m_nParseTimeUS / 1000000.f, GetCurAsyncTimeSec() - fStartTime);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CLevelStatObjLoader::StartFamily(int nFamily)
+{
+	const SFamily& family = m_families[nFamily];
+	const unsigned long nLoadingFlags = GetLoadingFlags(family.name.c_str());
+
+	StartFile(family.name.c_str(), nFamily, nLoadingFlags);
+
+	if (!GetCVars()->e_Lods || strstr(family.name.c_str(), "_lod"))
+		return;
+
+	// the same names as CStatObj::LoadLowLODS_Load
+	const char* szFileExt = PathUtil::GetExt(family.name.c_str());
+	for (int nLodLevel = 1; nLodLevel < MAX_STATOBJ_LODS_NUM; nLodLevel++)
+	{
+		char szLodFileName[512];
+		char szLodNum[8];
+		cry_strcpy(szLodFileName, family.name.c_str());
+		char* szPointSeparator = strchr(szLodFileName, '.');
+		if (szPointSeparator)
+			*szPointSeparator = '\0';
+		cry_strcat(szLodFileName, "_lod");
+		ltoa(nLodLevel, szLodNum, 10);
+		cry_strcat(szLodFileName, szLodNum);
+		cry_strcat(szLodFileName, ".");
+		cry_strcat(szLodFileName, szFileExt);
+
+		if (!IsValidFile(szLodFileName))
+			break;
+
+		StartFile(szLodFileName, nFamily, nLoadingFlags);
+	}
+}
+
+void CLevelStatObjLoader::StartFile(const char* szFileName, int nFamily, unsigned long nLoadingFlags)
+{
+	if (m_files.find(CONST_TEMP_STRING(szFileName)) != m_files.end() || stl::find_in_map(GetObjManager()->m_nameToObjectMap, CONST_TEMP_STRING(szFileName), NULL))
+		return;
+
+	SFile* pFile = new SFile;
+	pFile->pathName = szFileName;
+	pFile->nFamily = nFamily;
+	pFile->bLod = strstr(szFileName, "_lod") != NULL;
+	pFile->nLoadingFlags = nLoadingFlags;
+	pFile->pParsed = NULL;
+	m_files[pFile->pathName] = pFile;
+
+	StreamReadParams params;
+	params.dwUserData = (DWORD_PTR)pFile;
+	params.ePriority = estpUrgent;
+	pFile->pStream = GetSystem()->GetStreamEngine()->StartRead(eStreamTaskTypeGeometry, szFileName, this, &params);
+}
+
+void CLevelStatObjLoader::WaitForFile(SFile* pFile)
+{
+	if (pFile->pStream)
+	{
+		// the stream callback starts the job before the stream is finished
+		if (!pFile->pStream->IsFinished())
+			pFile->pStream->Wait();
+		pFile->pStream = NULL;
+	}
+	gEnv->GetJobManager()->WaitForJob(pFile->jobState);
+}
+
+void CLevelStatObjLoader::FinishFile(SFile* pFile)
+{
+	WaitForFile(pFile);
+	delete pFile->pParsed;
+	delete pFile;
+}
+
+void CLevelStatObjLoader::FinishFamily(int nFamily)
+{
+	for (TFileMap::iterator it = m_files.begin(); it != m_files.end(); )
+	{
+		SFile* pFile = it->second;
+		if (pFile->nFamily == nFamily)
+		{
+			it = m_files.erase(it);
+			FinishFile(pFile);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+unsigned long CLevelStatObjLoader::GetLoadingFlags(const char* szFileName)
+{
+	// as CObjManager::LoadStatObj loads the level CGF's
+	return strstr(szFileName, "break") ? IStatObj::ELoadingFlagsForceBreakable : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+CLevelStatObjLoader::SParsedCGF* CLevelStatObjLoader::TakeParsedCGF(const char* szFileName, bool bLod, unsigned long nLoadingFlags)
+{
+	CLevelStatObjLoader* pLoader = s_pActive;
+	if (!pLoader || CryGetCurrentThreadId() != gEnv->mMainThreadId)
+		return NULL;
+
+	TFileMap::iterator it = pLoader->m_files.find(CONST_TEMP_STRING(szFileName));
+	if (it == pLoader->m_files.end())
+		return NULL;
+
+	SFile* pFile = it->second;
+	pLoader->m_files.erase(it);
+	pLoader->WaitForFile(pFile);
+
+	SParsedCGF* pParsed = NULL;
+	if (pFile->bLod == bLod && pFile->nLoadingFlags == nLoadingFlags)
+		std::swap(pParsed, pFile->pParsed);
+
+	pLoader->FinishFile(pFile);
+	return pParsed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CLevelStatObjLoader::StreamAsyncOnComplete(IReadStream* pStream, unsigned nError)
+{
+	SFile* pFile = (SFile*)pStream->GetUserData();
+
+	// failed files are loaded by the main thread, which reports the error
+	if (!nError && !pStream->IsError() && pStream->GetBytesRead())
+	{
+		const char* pData = (const char*)pStream->GetBuffer();
+		SParsedCGF* pParsed = new SParsedCGF(pFile->pathName.c_str(), pFile->bLod);
+		pParsed->fileData.assign(pData, pData + pStream->GetBytesRead());
+		pFile->pParsed = pParsed;
+
+		TLevelStatObjParseJob job(pFile);
+		job.SetClassInstance(this);
+		job.RegisterJobState(&pFile->jobState);
+		job.Run();
+	}
+
+	pStream->FreeTemporaryMemory();
+}
+
+void CLevelStatObjLoader::ParseJobEntry(SFile* pFile)
+{
+	LOADING_TIME_PROFILE_SECTION_ARGS(pFile->pathName.c_str());
+
+	class Listener : public ILoaderCGFListener
+	{
+	public:
+		virtual void Warning(const char* format) { Cry3DEngineBase::Warning("%s", format); }
+		virtual void Error(const char* format)   {} // reported when the main thread parses the file again
+		virtual bool IsValidationEnabled()       { return Cry3DEngineBase::GetCVars()->e_StatObjValidate != 0; }
+	};
+
+	const int64 nStartTicks = CryGetTicks();
+
+	// Not from the temporary pool like CStatObj::LoadCGF_Int, the content is kept until the main thread gets to it
+	SParsedCGF* pParsed = pFile->pParsed;
+	CLoaderCGF cgfLoader(::operator new, ::operator delete, GetCVars()->e_StatObjTessellationMode != 2 || pFile->bLod);
+	Listener listener;
+
+	if (!pParsed->chunkFile.ReadFromMemory(&pParsed->fileData[0], (int)pParsed->fileData.size()) ||
+	    !cgfLoader.LoadCGF(pParsed->pContent, pFile->pathName.c_str(), pParsed->chunkFile, &listener, pFile->nLoadingFlags))
+	{
+		pFile->pParsed = NULL;
+		delete pParsed;
+	}
+
+	CryInterlockedAdd(&m_nParseTimeUS, (LONG)((CryGetTicks() - nStartTicks) * 1000000 / gEnv->pTimer->GetTicksPerSecond()));
+	CryInterlockedIncrement(&m_nNumParsed);
+}
@@ -0,0 +1,88 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Preloading of the level CGF's. The files and their LODs are
+//               read by the stream engine and parsed by job workers a few
+//               files ahead of the main thread, which creates the static
+//               objects from the parsed content in the original order.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __LEVELSTATOBJLOADER_H__
+#define __LEVELSTATOBJLOADER_H__
+#pragma once
+
+#include "CGF/ReadOnlyChunkFile.h"
+#include <CryThreading/IJobManager.h>
+
+class CContentCGF;
+
+class CLevelStatObjLoader : public IStreamCallback, public Cry3DEngineBase
+{
+public:
+	// A CGF parsed by a job, as CStatObj::LoadCGF_Int would have parsed it
+	struct SParsedCGF
+	{
+		SParsedCGF(const char* szFileName, bool bLod);
+		~SParsedCGF();
+
+		std::vector<char>  fileData;
+		CReadOnlyChunkFile chunkFile; // the content points into the file data
+		CContentCGF*       pContent;
+	};
+
+	struct SFile;
+
+	CLevelStatObjLoader();
+	~CLevelStatObjLoader();
+
+	// Only to be called by the main thread
+	void AddFile(const char* szFileName, bool bUseStreaming);
+	void StartReading();
+	void LoadAll();
+
+	int  GetNumFiles() const           { return (int)m_families.size(); }
+	int  GetNumInLevelCache() const    { return m_nInLevelCacheCount; }
+
+	// The file parsed ahead, NULL if it isn't parsed by the active loader or with other settings. The caller deletes it.
+	static SParsedCGF* TakeParsedCGF(const char* szFileName, bool bLod, unsigned long nLoadingFlags);
+
+	// Job entry, public for the job delegator
+	void               ParseJobEntry(SFile* pFile);
+
+protected:
+	// IStreamCallback
+	virtual void StreamAsyncOnComplete(IReadStream* pStream, unsigned nError);
+	virtual void StreamOnComplete(IReadStream* pStream, unsigned nError) {}
+
+private:
+	// A CGF and its LODs
+	struct SFamily
+	{
+		string name;
+		bool   bUseStreaming;
+	};
+
+	typedef std::map<string, SFile*, stl::less_stricmp<string>> TFileMap;
+
+	void                StartFamily(int nFamily);
+	void                StartFile(const char* szFileName, int nFamily, unsigned long nLoadingFlags);
+	void                WaitForFile(SFile* pFile);
+	void                FinishFile(SFile* pFile);
+	void                FinishFamily(int nFamily);
+
+	static unsigned long GetLoadingFlags(const char* szFileName);
+
+	std::vector<SFamily>        m_families;
+	TFileMap                    m_files;          // the files being read, parsed or waiting for the main thread
+	int                         m_nNextFamily;    // to start reading
+	int                         m_nNextToLoad;
+	int                         m_nInLevelCacheCount;
+	volatile LONG               m_nParseTimeUS;   // of all jobs
+	volatile LONG               m_nNumParsed;
+
+	static CLevelStatObjLoader* s_pActive;        // while LoadAll runs
+};
+
+#endif // __LEVELSTATOBJLOADER_H__
@@ -26,6 +26,7 @@
 #include "ObjectsTree.h"
 #include <CrySystem/File/IResourceManager.h>
 #include "DecalRenderNode.h"
+#include "LevelStatObjLoader.h"
 
 #define BRUSH_LIST_FILE     "brushlist.txt"
 #define CGF_LEVEL_CACHE_PAK "cgf.pak"
@@ -79,6 +80,8 @@ void CObjManager::UnloadVegetationModels(bool bDeleteAll)
 //////////////////////////////////////////////////////////////////////////
 void CObjManager::UnloadObjects(bool bDeleteAll)
 {
+	SAFE_DELETE(m_pLevelStatObjLoader);
+
 	UnloadVegetationModels(bDeleteAll);
 	UnloadFarObjects();
 
@@ -176,79 +179,18 @@ void CObjManager::CleanStreamingData()
 }
 
 //////////////////////////////////////////////////////////////////////////
-// class for asyncronous preloading of level CGF's
+// Starts reading and parsing the level CGF's, so that it overlaps with loading the level materials
 //////////////////////////////////////////////////////////////////////////
-struct CLevelStatObjLoader : public IStreamCallback, public Cry3DEngineBase
-{
-	int m_nTasksNum;
-
-	CLevelStatObjLoader()
-	{
-		m_nTasksNum = 0;
-	}
-
-	void StartStreaming(const char* pFileName)
-	{
-		m_nTasksNum++;
-
-		// request the file
-		StreamReadParams params;
-		params.dwUserData = 0;
-		params.nSize = 0;
-		params.pBuffer = NULL;
-		params.nLoadTime = 0;
-		params.nMaxLoadTime = 0;
-		params.ePriority = estpUrgent;
-		GetSystem()->GetStreamEngine()->StartRead(eStreamTaskTypeGeometry, pFileName, this, &params);
-	}
-
-	virtual void StreamOnComplete(IReadStream* pStream, unsigned nError)
-	{
-		if (!nError)
-		{
-			string szName = pStream->GetName();
-			// remove game folder from path
-			const char* szInGameName = strstr(szName, "\\");
-			// load CGF from memory
-			GetObjManager()->LoadStatObj(szInGameName + 1, NULL, NULL, true, 0, pStream->GetBuffer(), pStream->GetBytesRead());
-		}
-
-		m_nTasksNum--;
-	}
-};
-
-//////////////////////////////////////////////////////////////////////////
-// Preload in efficient way all CGF's used in level
-//////////////////////////////////////////////////////////////////////////
-void CObjManager::PreloadLevelObjects()
+void CObjManager::BeginPreloadLevelObjects()
 {
 	LOADING_TIME_PROFILE_SECTION;
 
-	// Starting a new level, so make sure the round ids are ahead of what they were in the last level
-	m_nUpdateStreamingPrioriryRoundId += 8;
-	m_nUpdateStreamingPrioriryRoundIdFast += 8;
-
-	PrintMessage("Starting loading level CGF's ...");
-	INDENT_LOG_DURING_SCOPE();
-
-	float fStartTime = GetCurAsyncTimeSec();
+	SAFE_DELETE(m_pLevelStatObjLoader);
+	m_pLevelStatObjLoader = new CLevelStatObjLoader();
 
-	bool bCgfCacheExist = false;
-	if (GetCVars()->e_StreamCgf != 0)
-	{
-		// Only when streaming enable use no-mesh cgf pak.
-		//bCgfCacheExist = GetISystem()->GetIResourceManager()->LoadLevelCachePak( CGF_LEVEL_CACHE_PAK,"" );
-	}
 	IResourceList* pResList = GetISystem()->GetIResourceManager()->GetLevelResourceList();
 
-	// Construct streamer object
-	CLevelStatObjLoader cgfStreamer;
-
 	CryPathString cgfFilename;
-	int nCgfCounter = 0;
-	int nInLevelCacheCount = 0;
-
-	bool bVerboseLogging = GetCVars()->e_StatObjPreload > 1;
 
 	//////////////////////////////////////////////////////////////////////////
 	// Enumerate all .CGF inside level from the "brushlist.txt" file.
@@ -277,26 +219,16 @@ void CObjManager::PreloadLevelObjects()
 					cgfFilename = token;
 				}
 
-				if (bVerboseLogging)
-				{
-					CryLog("%s", cgfFilename.c_str());
-				}
 				// Do not use streaming for the Brushes from level.pak.
-				GetObjManager()->LoadStatObj(cgfFilename.c_str(), NULL, 0, false, 0);
-				//cgfStreamer.StartStreaming(cgfFilename.c_str());
-				nCgfCounter++;
+				m_pLevelStatObjLoader->AddFile(cgfFilename.c_str(), false);
 
 				token = strtok(NULL, seps);
-
-				//This loop can take a few seconds, so we should refresh the loading screen and call the loading tick functions to ensure that no big gaps in coverage occur.
-				SYNCHRONOUS_LOADING_TICK();
 			}
 			delete[]buf;
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
 
-	// Request objects loading from Streaming System.
 	if (const char* pCgfName = pResList->GetFirst())
 	{
 		while (pCgfName)
@@ -311,44 +243,40 @@ void CObjManager::PreloadLevelObjects()
 					continue;
 				}
 
-				cgfFilename = pCgfName;
-
-				if (bVerboseLogging)
-				{
-					CryLog("%s", cgfFilename.c_str());
-				}
-				CStatObj* pStatObj = GetObjManager()->LoadStatObj(cgfFilename.c_str(), NULL, 0, true, 0);
-				if (pStatObj)
-				{
-					if (pStatObj->m_bMeshStrippedCGF)
-					{
-						nInLevelCacheCount++;
-					}
-				}
-				//cgfStreamer.StartStreaming(cgfFilename.c_str());
-				nCgfCounter++;
-
-				//This loop can take a few seconds, so we should refresh the loading screen and call the loading tick functions to ensure that no big gaps in coverage occur.
-				SYNCHRONOUS_LOADING_TICK();
+				m_pLevelStatObjLoader->AddFile(pCgfName, true);
 			}
 
 			pCgfName = pResList->GetNext();
 		}
 	}
 
-	//  PrintMessage("Finished requesting level CGF's: %d objects in %.1f sec", nCgfCounter, GetCurAsyncTimeSec()-fStartTime);
+	m_pLevelStatObjLoader->StartReading();
+}
 
-	// Continue updating streaming system until all CGF's are loaded
-	if (cgfStreamer.m_nTasksNum > 0)
-	{
-		LOADING_TIME_PROFILE_SECTION_NAMED("CObjManager::PreloadLevelObjects_StreamEngine_Update");
-		GetSystem()->GetStreamEngine()->UpdateAndWait();
-	}
+//////////////////////////////////////////////////////////////////////////
+// Preload in efficient way all CGF's used in level
+//////////////////////////////////////////////////////////////////////////
+void CObjManager::PreloadLevelObjects()
+{
+	LOADING_TIME_PROFILE_SECTION;
 
-	if (bCgfCacheExist)
-	{
-		//GetISystem()->GetIResourceManager()->UnloadLevelCachePak( CGF_LEVEL_CACHE_PAK );
-	}
+	// Starting a new level, so make sure the round ids are ahead of what they were in the last level
+	m_nUpdateStreamingPrioriryRoundId += 8;
+	m_nUpdateStreamingPrioriryRoundIdFast += 8;
+
+	PrintMessage("Starting loading level CGF's ...");
+	INDENT_LOG_DURING_SCOPE();
+
+	float fStartTime = GetCurAsyncTimeSec();
+
+	if (!m_pLevelStatObjLoader)
+		BeginPreloadLevelObjects();
+
+	m_pLevelStatObjLoader->LoadAll();
+
+	const int nCgfCounter = m_pLevelStatObjLoader->GetNumFiles();
+	const int nInLevelCacheCount = m_pLevelStatObjLoader->GetNumInLevelCache();
+	SAFE_DELETE(m_pLevelStatObjLoader);
 
 	float dt = GetCurAsyncTimeSec() - fStartTime;
 	PrintMessage("Finished loading level CGF's: %d objects loaded (%d from LevelCache) in %.1f sec", nCgfCounter, nInLevelCacheCount, dt);
@@ -587,6 +515,7 @@ void CObjManager::FreeStatObj(CStatObj* pObj)
 
 CObjManager::CObjManager() :
 	m_pDefaultCGF(NULL),
+	m_pLevelStatObjLoader(NULL),
 	m_decalsToPrecreate(),
 	m_bNeedProcessObjectsStreaming_Finish(false),
 	m_CullThread()
@@ -707,6 +636,8 @@ void CObjManager::MakeUnitCube()
 
 CObjManager::~CObjManager()
 {
+	SAFE_DELETE(m_pLevelStatObjLoader);
+
 	// free default object
 	m_pDefaultCGF = 0;
 
@@ -41,6 +41,7 @@ struct SCheckOcclusionOutput;
 class CVegetation;
 
 class C3DEngine;
+class CLevelStatObjLoader;
 struct IMaterial;
 
 #define SMC_EXTEND_FRUSTUM              8
@@ -182,6 +183,7 @@ public:
 	CObjManager();
 	~CObjManager();
 
+	void      BeginPreloadLevelObjects();
 	void      PreloadLevelObjects();
 	void      UnloadObjects(bool bDeleteAll);
 	void      UnloadVegetationModels(bool bDeleteAll);
@@ -520,6 +522,7 @@ public:
 
 	//	bool LoadStaticObjectsFromXML(XmlNodeRef xmlVegetation);
 	_smart_ptr<CStatObj>    m_pDefaultCGF;
+	CLevelStatObjLoader*    m_pLevelStatObjLoader;
 	_smart_ptr<IRenderMesh> m_pRMBox;
 
 	//////////////////////////////////////////////////////////////////////////
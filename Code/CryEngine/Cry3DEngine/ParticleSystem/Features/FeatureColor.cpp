@@ -9,6 +9,7 @@
 
 #include "StdAfx.h"
 #include "ParticleSystem/ParticleEmitter.h"
+#include "ParticleSystem/ParticleKernels.h"
 #include <CrySerialization/SmartPtr.h>
 #include "FeatureColor.h"
 #include "TimeSource.h"
@@ -302,15 +303,11 @@ public:
 		attribute.r = pow(attribute.r, m_gamma) * m_scale + m_bias;
 		attribute.g = pow(attribute.g, m_gamma) * m_scale + m_bias;
 		attribute.b = pow(attribute.b, m_gamma) * m_scale + m_bias;
-		const ColorFv value = ToColorFv(attribute);
 
-		CRY_PFX2_FOR_RANGE_PARTICLESGROUP(range)
-		{
-			const ColorFv color0 = ToColorFv(stream.Load(particleGroupId));
-			const ColorFv color1 = color0 * value;
-			stream.Store(particleGroupId, ColorFvToUColv(color1));
-		}
-		CRY_PFX2_FOR_END;
+		SColorKernelData data;
+		data.m_pColors = reinterpret_cast<UCol*>(container.GetData(EPDT_Color));
+		data.m_scale = attribute;
+		GetParticleKernels().ColorScale(data, range);
 	}
 
 private:
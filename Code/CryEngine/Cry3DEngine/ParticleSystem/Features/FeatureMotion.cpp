@@ -13,6 +13,7 @@
 #include <CrySerialization/SmartPtr.h>
 #include "ParticleSystem/ParticleFeature.h"
 #include "ParticleSystem/ParticleEmitter.h"
+#include "ParticleSystem/ParticleKernels.h"
 #include "ParamMod.h"
 #include "Target.h"
 #include <CryMath/SNoise.h>
@@ -24,6 +25,13 @@ volatile bool gFeatureMotion = false;
 namespace pfx2
 {
 
+template<typename TStream>
+ILINE void GetVec3Streams(CParticleContainer& container, EParticleVec3Field field, TStream (&streams)[3])
+{
+	for (uint axis = 0; axis < 3; ++axis)
+		streams[axis] = reinterpret_cast<float*>(container.GetData(EParticleDataType(field + axis)));
+}
+
 class ILocalEffectors : public _i_reference_target_t
 {
 public:
@@ -174,22 +182,14 @@ void CFeatureMotionPhysics::LinearIntegral(const SUpdateContext& context)
 	CRY_PFX2_PROFILE_DETAIL;
 
 	CParticleContainer& container = context.m_container;
-	IOVec3Stream position = container.GetIOVec3Stream(EPVF_Position);
-	IVec3Stream velocity = container.GetIVec3Stream(EPVF_Velocity);
-	IFStream normAges = container.GetIFStream(EPDT_NormalAge);
-	const float deltaTime = context.m_deltaTime;
-	const floatv deltaTimeV = ToFloatv(deltaTime);
-
-	CRY_PFX2_FOR_ACTIVE_PARTICLESGROUP(context)
-	{
-		const Vec3v p0 = position.Load(particleGroupId);
-		const Vec3v v0 = velocity.Load(particleGroupId);
-		const floatv normAge = normAges.Load(particleGroupId);
-		const floatv dT = DeltaTime(normAge, deltaTimeV);
-		const Vec3v p1 = MAdd(v0, dT, p0);
-		position.Store(particleGroupId, p1);
-	}
-	CRY_PFX2_FOR_END;
+	SMotionKernelData data;
+	ZeroStruct(data);
+	GetVec3Streams(container, EPVF_Position, data.m_pPositions);
+	GetVec3Streams(container, EPVF_Velocity, data.m_pVelocities);
+	data.m_pNormAges = reinterpret_cast<const float*>(container.GetData(EPDT_NormalAge));
+	data.m_deltaTime = context.m_deltaTime;
+
+	GetParticleKernels().LinearIntegral(data, context.m_updateRange);
 }
 
 void CFeatureMotionPhysics::DragFastIntegral(const SUpdateContext& context)
@@ -199,45 +199,24 @@ void CFeatureMotionPhysics::DragFastIntegral(const SUpdateContext& context)
 	CParticleEmitter* pEmitter = context.m_runtime.GetEmitter();
 	CParticleContainer& container = context.m_container;
 
-	IOVec3Stream positions = container.GetIOVec3Stream(EPVF_Position);
-	IOVec3Stream velocities = container.GetIOVec3Stream(EPVF_Velocity);
-	IVec3Stream velocityField = container.GetIVec3Stream(EPVF_VelocityField);
-	IVec3Stream accelerations = container.GetIVec3Stream(EPVF_Acceleration);
-	IFStream gravities = container.GetIFStream(EPDT_Gravity, 0.0f);
-	IFStream drags = container.GetIFStream(EPDT_Drag);
-	IFStream normAges = container.GetIFStream(EPDT_NormalAge);
-	const floatv fTime = ToFloatv(context.m_deltaTime);
+	SMotionKernelData data;
+	GetVec3Streams(container, EPVF_Position, data.m_pPositions);
+	GetVec3Streams(container, EPVF_Velocity, data.m_pVelocities);
+	GetVec3Streams(container, EPVF_VelocityField, data.m_pVelocityField);
+	GetVec3Streams(container, EPVF_Acceleration, data.m_pAccelerations);
+	data.m_pGravities = reinterpret_cast<const float*>(container.GetData(EPDT_Gravity));
+	data.m_pDrags = reinterpret_cast<const float*>(container.GetData(EPDT_Drag));
+	data.m_pNormAges = reinterpret_cast<const float*>(container.GetData(EPDT_NormalAge));
+	data.m_deltaTime = context.m_deltaTime;
 
-	const Vec3v physAccel = ToVec3v(pEmitter->GetPhysicsEnv().m_UniformForces.vAccel);
-	const Vec3v physWind = ToVec3v(pEmitter->GetPhysicsEnv().m_UniformForces.vWind * m_windMultiplier + m_uniformWind);
-	const Vec3v uniformAccel = ToVec3v(m_uniformAcceleration);
+	data.m_physAccel = pEmitter->GetPhysicsEnv().m_UniformForces.vAccel;
+	data.m_physWind = pEmitter->GetPhysicsEnv().m_UniformForces.vWind * m_windMultiplier + m_uniformWind;
+	data.m_uniformAccel = m_uniformAcceleration;
 
 	const float maxDragFactor = m_drag.GetValueRange(context).end * context.m_deltaTime;
-	const floatv dragReduction = ToFloatv(div_min(1.0f - exp_tpl(-maxDragFactor), maxDragFactor, 1.0f));
+	data.m_dragReduction = div_min(1.0f - exp_tpl(-maxDragFactor), maxDragFactor, 1.0f);
 
-	CRY_PFX2_FOR_ACTIVE_PARTICLESGROUP(context)
-	{
-		const floatv normAge = normAges.Load(particleGroupId);
-		const floatv dT = DeltaTime(normAge, fTime);
-
-		const Vec3v partAccel = accelerations.SafeLoad(particleGroupId);
-		const Vec3v fieldVel = velocityField.SafeLoad(particleGroupId);
-		const Vec3v partVel = Add(physWind, fieldVel);
-
-		const floatv gravMult = gravities.SafeLoad(particleGroupId);
-		const floatv drag = Mul(drags.SafeLoad(particleGroupId), dragReduction);
-		const Vec3v p0 = positions.Load(particleGroupId);
-		const Vec3v v0 = velocities.Load(particleGroupId);
-
-		const Vec3v a = Add(MAdd(physAccel, gravMult, partAccel), uniformAccel);
-		const Vec3v accel = MAdd(Sub(partVel, v0), drag, a);          // (partVel-v0)*drag + a
-		const Vec3v p1 = MAdd(v0, dT, p0);                            // v0*dT + p0
-		const Vec3v v1 = MAdd(accel, dT, v0);                         // accel*dT + v0
-
-		positions.Store(particleGroupId, p1);
-		velocities.Store(particleGroupId, v1);
-	}
-	CRY_PFX2_FOR_END;
+	GetParticleKernels().DragFastIntegral(data, context.m_updateRange);
 }
 
 //////////////////////////////////////////////////////////////////////////
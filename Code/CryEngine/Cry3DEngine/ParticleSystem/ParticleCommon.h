@@ -43,6 +43,8 @@
 #endif
 
 #define CRY_PFX2_PARTICLES_ALIGNMENT 16
+#define CRY_PFX2_STREAMS_ALIGNMENT   64 // container streams, one vector of the widest update kernels
+#define CRY_PFX2_MAX_LANES           16
 
 #if (CRY_PLATFORM_WINDOWS || CRY_PLATFORM_LINUX || CRY_PLATFORM_DURANGO || CRY_PLATFORM_ORBIS || CRY_PLATFORM_APPLE) && !CRY_PLATFORM_NEON
 	#define CRY_PFX2_USE_SSE
@@ -55,6 +57,12 @@
 	#// msvc x86 only supports up to 3 arguments by copy of type __m128. More than that will require
 	#// references. That makes it incompatible with Vec4_tpl.
 #endif
+#if defined(CRY_PFX2_USE_SSE) && (CRY_PLATFORM_WINDOWS || CRY_PLATFORM_LINUX || CRY_PLATFORM_MAC)
+	#define CRY_PFX2_USE_AVX // update kernels for 8 lanes, used when the CPU supports AVX2
+	#if !CRY_COMPILER_MSVC || _MSC_VER >= 1911
+		#define CRY_PFX2_USE_AVX512 // and for 16 lanes with AVX-512
+	#endif
+#endif
 
 namespace pfx2
 {
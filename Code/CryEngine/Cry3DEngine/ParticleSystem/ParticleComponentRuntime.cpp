@@ -11,6 +11,7 @@
 #include "ParticleComponentRuntime.h"
 #include "ParticleEmitter.h"
 #include "ParticleFeature.h"
+#include "ParticleKernels.h"
 
 namespace pfx2
 {
@@ -472,21 +473,13 @@ void CParticleComponentRuntime::AgeUpdate(const SUpdateContext& context)
 {
 	CRY_PFX2_PROFILE_DETAIL;
 
-	IFStream invLifeTimes = m_container.GetIFStream(EPDT_InvLifeTime);
-	IOFStream normAges = m_container.GetIOFStream(EPDT_NormalAge);
-	const floatv frameTime = ToFloatv(context.m_deltaTime);
-	const floatv zero = ToFloatv(0.0f);
-
-	CRY_PFX2_FOR_ACTIVE_PARTICLESGROUP(context)
-	{
-		const floatv invLifeTime = invLifeTimes.Load(particleGroupId);
-		const floatv normAge0 = normAges.Load(particleGroupId);
-		const floatv dT = DeltaTime(normAge0, frameTime);
-		const floatv normalAge1 = MAdd(dT, invLifeTime, Max(zero, normAge0));
-		normAges.Store(particleGroupId, normalAge1);
-	}
-	CRY_PFX2_FOR_END;
+	SAgeKernelData data;
+	data.m_pNormAges = reinterpret_cast<float*>(m_container.GetData(EPDT_NormalAge));
+	data.m_pInvLifeTimes = reinterpret_cast<const float*>(m_container.GetData(EPDT_InvLifeTime));
+	data.m_deltaTime = context.m_deltaTime;
+	GetParticleKernels().AgeUpdate(data, context.m_updateRange);
 
+	IOFStream normAges = m_container.GetIOFStream(EPDT_NormalAge);
 	TIOStream<uint8> states = m_container.GetTIOStream<uint8>(EPDT_State);
 	CRY_PFX2_FOR_ACTIVE_PARTICLES(context)
 	{
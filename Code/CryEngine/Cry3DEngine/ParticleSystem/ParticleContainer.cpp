@@ -19,7 +19,7 @@ static std::set<void*> g_allocMems;
 
 void* ParticleAlloc(size_t sz)
 {
-	void* ptr = CryModuleMemalign(sz, CRY_PFX2_PARTICLES_ALIGNMENT);
+	void* ptr = CryModuleMemalign(sz, CRY_PFX2_STREAMS_ALIGNMENT);
 	memset(ptr, 0, sz);
 	return ptr;
 }
@@ -58,7 +58,8 @@ void CParticleContainer::Resize(size_t newSize)
 	if (newSize < m_maxParticles)
 		return;
 
-	const size_t newMaxParticles = CRY_PFX2_PARTICLESGROUP_UPPER(newSize + (newSize >> 1)) + 1;
+	// padded to whole vectors of the widest update kernels
+	const size_t newMaxParticles = (newSize + (newSize >> 1) + CRY_PFX2_MAX_LANES) & ~size_t(CRY_PFX2_MAX_LANES - 1);
 
 	void* prevBuffers[EPDT_Count];
 	for (size_t type = 0; type < EPDT_Count; ++type)
@@ -149,7 +150,7 @@ void CParticleContainer::Clear()
 		m_pData[i] = 0;
 		m_useData[i] = false;
 	}
-	m_maxParticles = CRY_PFX2_PARTICLESGROUP_STRIDE;
+	m_maxParticles = CRY_PFX2_MAX_LANES;
 	m_lastId = 0;
 	m_firstSpawnId = 0;
 	m_lastSpawnId = 0;
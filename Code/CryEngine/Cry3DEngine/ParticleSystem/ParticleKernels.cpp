@@ -0,0 +1,136 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Update kernels on the particle group vectors, and the
+//               selection of the widest kernels the CPU supports
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "ParticleKernels.h"
+#include "ParticleKernelsImpl.h"
+
+CRY_PFX2_DBG
+
+namespace
+{
+
+// The floatv of the particle groups, the same operations as the features use.
+struct SLanesGroup
+{
+	typedef pfx2::floatv TFloat;
+	typedef pfx2::UColv  TColor;
+	enum { Count = CRY_PFX2_PARTICLESGROUP_STRIDE };
+
+	static ILINE TFloat Set(float v)                                    { return pfx2::ToFloatv(v); }
+	static ILINE TFloat Load(const float* p)                            { return *reinterpret_cast<const TFloat*>(p); }
+	static ILINE void   Store(float* p, TFloat v)                       { *reinterpret_cast<TFloat*>(p) = v; }
+	static ILINE TFloat Add(TFloat a, TFloat b)                         { return pfx2::Add(a, b); }
+	static ILINE TFloat Sub(TFloat a, TFloat b)                         { return pfx2::Sub(a, b); }
+	static ILINE TFloat Mul(TFloat a, TFloat b)                         { return pfx2::Mul(a, b); }
+	static ILINE TFloat MAdd(TFloat a, TFloat b, TFloat c)              { return pfx2::MAdd(a, b, c); }
+	static ILINE TFloat Max(TFloat a, TFloat b)                         { return pfx2::Max(a, b); }
+	static ILINE TFloat DeltaTime(TFloat normAge, TFloat frameTime)     { return pfx2::DeltaTime(normAge, frameTime); }
+	static ILINE TColor LoadColor(const UCol* p)                        { return *reinterpret_cast<const TColor*>(p); }
+	static ILINE void   StoreColor(UCol* p, TColor color)               { *reinterpret_cast<TColor*>(p) = color; }
+	static ILINE TColor ScaleColor(TColor color, TFloat r, TFloat g, TFloat b)
+	{
+		return pfx2::ColorFvToUColv(pfx2::ToColorFv(color) * pfx2::ColorFv(r, g, b));
+	}
+};
+
+}
+
+namespace pfx2
+{
+
+#ifdef CRY_PFX2_USE_AVX
+extern const SParticleKernels gParticleKernelsAVX2;
+#endif
+#ifdef CRY_PFX2_USE_AVX512
+extern const SParticleKernels gParticleKernelsAVX512;
+#endif
+
+namespace
+{
+
+#ifdef CRY_PFX2_USE_SSE
+const SParticleKernels gParticleKernelsGroup = CRY_PFX2_PARTICLE_KERNELS("SSE", SLanesGroup);
+#else
+const SParticleKernels gParticleKernelsGroup = CRY_PFX2_PARTICLE_KERNELS("Scalar", SLanesGroup);
+#endif
+
+template<typename TData, typename TKernel>
+ILINE void RunKernel(TKernel pKernel, uint32 lanes, TKernel pGroupKernel, const TData& data, const SUpdateRange& range)
+{
+	const uint32 first = range.m_firstParticleId;
+	const uint32 last = CRY_PFX2_PARTICLESGROUP_LOWER(range.m_lastParticleId + CRY_PFX2_PARTICLESGROUP_STRIDE - 1);
+	if (last <= first)
+		return;
+	const uint32 lastVector = first + (last - first) / lanes * lanes;
+	if (lastVector != first)
+		pKernel(data, first, lastVector);
+	if (lastVector != last)
+		pGroupKernel(data, lastVector, last);
+}
+
+const SParticleKernels* SelectParticleKernels()
+{
+	for (uint32 lanes = CRY_PFX2_MAX_LANES; lanes > gParticleKernelsGroup.m_lanes; lanes /= 2)
+	{
+		if (const SParticleKernels* pKernels = GetParticleKernels(lanes))
+		{
+			CryLog("Particle update kernels: %s, %u lanes", pKernels->m_name, pKernels->m_lanes);
+			return pKernels;
+		}
+	}
+	return &gParticleKernelsGroup;
+}
+
+}
+
+void SParticleKernels::LinearIntegral(const SMotionKernelData& data, const SUpdateRange& range) const
+{
+	RunKernel(m_linearIntegral, m_lanes, gParticleKernelsGroup.m_linearIntegral, data, range);
+}
+
+void SParticleKernels::DragFastIntegral(const SMotionKernelData& data, const SUpdateRange& range) const
+{
+	RunKernel(m_dragFastIntegral, m_lanes, gParticleKernelsGroup.m_dragFastIntegral, data, range);
+}
+
+void SParticleKernels::AgeUpdate(const SAgeKernelData& data, const SUpdateRange& range) const
+{
+	RunKernel(m_ageUpdate, m_lanes, gParticleKernelsGroup.m_ageUpdate, data, range);
+}
+
+void SParticleKernels::ColorScale(const SColorKernelData& data, const SUpdateRange& range) const
+{
+	RunKernel(m_colorScale, m_lanes, gParticleKernelsGroup.m_colorScale, data, range);
+}
+
+const SParticleKernels& GetParticleKernels()
+{
+	static const SParticleKernels* pKernels = SelectParticleKernels();
+	return *pKernels;
+}
+
+const SParticleKernels* GetParticleKernels(uint32 lanes)
+{
+	if (lanes == gParticleKernelsGroup.m_lanes)
+		return &gParticleKernelsGroup;
+
+#ifdef CRY_PFX2_USE_AVX
+	const int cpuFlags = gEnv->pSystem->GetCPUFlags();
+	if (lanes == gParticleKernelsAVX2.m_lanes && (cpuFlags & CPUF_AVX2))
+		return &gParticleKernelsAVX2;
+#endif
+#ifdef CRY_PFX2_USE_AVX512
+	if (lanes == gParticleKernelsAVX512.m_lanes && (cpuFlags & CPUF_AVX512))
+		return &gParticleKernelsAVX512;
+#endif
+	return nullptr;
+}
+
+}
@@ -0,0 +1,83 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Update kernels over the raw particle streams. The kernels are
+//               written once for any vector width and compiled for 4, 8 and
+//               16 lanes, the widest the CPU supports is used.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef PARTICLEKERNELS_H
+#define PARTICLEKERNELS_H
+
+#pragma once
+
+#include "ParticleCommon.h"
+#include "ParticleMath.h"
+#include "ParticleUpdate.h"
+
+namespace pfx2
+{
+
+// Absent optional streams (null) read as 0, as the SafeLoad of the streams does.
+struct SMotionKernelData
+{
+	float*       m_pPositions[3];
+	float*       m_pVelocities[3];
+	const float* m_pVelocityField[3]; // optional
+	const float* m_pAccelerations[3]; // optional
+	const float* m_pGravities;        // optional
+	const float* m_pDrags;            // optional
+	const float* m_pNormAges;
+	Vec3         m_physAccel;
+	Vec3         m_physWind;
+	Vec3         m_uniformAccel;
+	float        m_dragReduction;
+	float        m_deltaTime;
+};
+
+struct SAgeKernelData
+{
+	float*       m_pNormAges;
+	const float* m_pInvLifeTimes;
+	float        m_deltaTime;
+};
+
+struct SColorKernelData
+{
+	UCol*  m_pColors;
+	ColorF m_scale;
+};
+
+struct SParticleKernels
+{
+	// the ranges passed to the kernels are whole vectors of m_lanes particles
+	typedef void (* TMotionKernel)(const SMotionKernelData& data, uint32 first, uint32 last);
+	typedef void (* TAgeKernel)(const SAgeKernelData& data, uint32 first, uint32 last);
+	typedef void (* TColorKernel)(const SColorKernelData& data, uint32 first, uint32 last);
+
+	const char*   m_name;
+	uint32        m_lanes;
+	TMotionKernel m_linearIntegral;
+	TMotionKernel m_dragFastIntegral;
+	TAgeKernel    m_ageUpdate;
+	TColorKernel  m_colorScale;
+
+	// Run over the particle groups of the range, as CRY_PFX2_FOR_RANGE_PARTICLESGROUP does. The groups which
+	// don't fill a whole vector at the end are updated by the CRY_PFX2_PARTICLESGROUP_STRIDE kernels.
+	void LinearIntegral(const SMotionKernelData& data, const SUpdateRange& range) const;
+	void DragFastIntegral(const SMotionKernelData& data, const SUpdateRange& range) const;
+	void AgeUpdate(const SAgeKernelData& data, const SUpdateRange& range) const;
+	void ColorScale(const SColorKernelData& data, const SUpdateRange& range) const;
+};
+
+// The widest kernels the CPU supports, selected on first use.
+const SParticleKernels& GetParticleKernels();
+
+// The kernels with the given number of lanes, null if they aren't compiled in or the CPU lacks the instructions.
+const SParticleKernels* GetParticleKernels(uint32 lanes);
+
+}
+
+#endif // PARTICLEKERNELS_H
@@ -0,0 +1,90 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Update kernels for 8 lanes with AVX2. Not part of an uber
+//               file, everything after the target pragma may use AVX2.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "ParticleKernels.h"
+
+#ifdef CRY_PFX2_USE_AVX
+
+	#include <immintrin.h>
+
+	#if CRY_COMPILER_CLANG
+		#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+	#elif CRY_COMPILER_GCC
+		#pragma GCC push_options
+		#pragma GCC target("avx2")
+	#endif
+
+	#include "ParticleKernelsImpl.h"
+
+namespace
+{
+
+// The operations match the ones of the SSE floatv, the results are the same for any number of lanes.
+struct SLanesAVX2
+{
+	typedef __m256  TFloat;
+	typedef __m256i TColor;
+	enum { Count = 8 };
+
+	static ILINE TFloat Set(float v)                        { return _mm256_set1_ps(v); }
+	static ILINE TFloat Load(const float* p)                { return _mm256_loadu_ps(p); }
+	static ILINE void   Store(float* p, TFloat v)           { _mm256_storeu_ps(p, v); }
+	static ILINE TFloat Add(TFloat a, TFloat b)             { return _mm256_add_ps(a, b); }
+	static ILINE TFloat Sub(TFloat a, TFloat b)             { return _mm256_sub_ps(a, b); }
+	static ILINE TFloat Mul(TFloat a, TFloat b)             { return _mm256_mul_ps(a, b); }
+	static ILINE TFloat MAdd(TFloat a, TFloat b, TFloat c)  { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+	static ILINE TFloat Max(TFloat a, TFloat b)             { return _mm256_max_ps(a, b); }
+
+	// normAge < 0 ? -normAge * frameTime : frameTime
+	static ILINE TFloat DeltaTime(TFloat normAge, TFloat frameTime)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 mask = _mm256_cmp_ps(normAge, zero, _CMP_LT_OQ);
+		const __m256 spawned = _mm256_sub_ps(zero, _mm256_mul_ps(normAge, frameTime));
+		return _mm256_or_ps(_mm256_and_ps(mask, spawned), _mm256_andnot_ps(mask, frameTime));
+	}
+
+	static ILINE TColor LoadColor(const UCol* p)            { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+	static ILINE void   StoreColor(UCol* p, TColor color)   { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), color); }
+
+	static ILINE TColor ScaleColor(TColor color, TFloat r, TFloat g, TFloat b)
+	{
+		const __m256 toFloat = _mm256_set1_ps(1.0f / 255.0f);
+		const __m256 fromFloat = _mm256_set1_ps(255.0f);
+		const __m256i mask = _mm256_set1_epi32(0x000000ff);
+		const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+
+		const __m256 r0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(color, 16), mask)), toFloat);
+		const __m256 g0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(color, 8), mask)), toFloat);
+		const __m256 b0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(color, mask)), toFloat);
+
+		const __m256i r1 = _mm256_slli_epi32(_mm256_and_si256(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_mul_ps(r0, r), fromFloat)), mask), 16);
+		const __m256i g1 = _mm256_slli_epi32(_mm256_and_si256(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_mul_ps(g0, g), fromFloat)), mask), 8);
+		const __m256i b1 = _mm256_and_si256(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_mul_ps(b0, b), fromFloat)), mask);
+		return _mm256_or_si256(alphaMask, _mm256_or_si256(r1, _mm256_or_si256(g1, b1)));
+	}
+};
+
+}
+
+namespace pfx2
+{
+
+extern const SParticleKernels gParticleKernelsAVX2 = CRY_PFX2_PARTICLE_KERNELS("AVX2", SLanesAVX2);
+
+}
+
+	#if CRY_COMPILER_CLANG
+		#pragma clang attribute pop
+	#elif CRY_COMPILER_GCC
+		#pragma GCC pop_options
+	#endif
+
+#endif // CRY_PFX2_USE_AVX
@@ -0,0 +1,90 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Update kernels for 16 lanes with AVX-512. Not part of an uber
+//               file, everything after the target pragma may use AVX-512.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "ParticleKernels.h"
+
+#ifdef CRY_PFX2_USE_AVX512
+
+	#include <immintrin.h>
+
+	#if CRY_COMPILER_CLANG
+		#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+	#elif CRY_COMPILER_GCC
+		#pragma GCC push_options
+		#pragma GCC target("avx512f")
+	#endif
+
+	#include "ParticleKernelsImpl.h"
+
+namespace
+{
+
+// The operations match the ones of the SSE floatv, the results are the same for any number of lanes.
+struct SLanesAVX512
+{
+	typedef __m512  TFloat;
+	typedef __m512i TColor;
+	enum { Count = 16 };
+
+	static ILINE TFloat Set(float v)                        { return _mm512_set1_ps(v); }
+	static ILINE TFloat Load(const float* p)                { return _mm512_loadu_ps(p); }
+	static ILINE void   Store(float* p, TFloat v)           { _mm512_storeu_ps(p, v); }
+	static ILINE TFloat Add(TFloat a, TFloat b)             { return _mm512_add_ps(a, b); }
+	static ILINE TFloat Sub(TFloat a, TFloat b)             { return _mm512_sub_ps(a, b); }
+	static ILINE TFloat Mul(TFloat a, TFloat b)             { return _mm512_mul_ps(a, b); }
+	static ILINE TFloat MAdd(TFloat a, TFloat b, TFloat c)  { return _mm512_add_ps(_mm512_mul_ps(a, b), c); }
+	static ILINE TFloat Max(TFloat a, TFloat b)             { return _mm512_max_ps(a, b); }
+
+	// normAge < 0 ? -normAge * frameTime : frameTime
+	static ILINE TFloat DeltaTime(TFloat normAge, TFloat frameTime)
+	{
+		const __m512 zero = _mm512_setzero_ps();
+		const __mmask16 mask = _mm512_cmp_ps_mask(normAge, zero, _CMP_LT_OQ);
+		const __m512 spawned = _mm512_sub_ps(zero, _mm512_mul_ps(normAge, frameTime));
+		return _mm512_mask_blend_ps(mask, frameTime, spawned);
+	}
+
+	static ILINE TColor LoadColor(const UCol* p)            { return _mm512_loadu_si512(p); }
+	static ILINE void   StoreColor(UCol* p, TColor color)   { _mm512_storeu_si512(p, color); }
+
+	static ILINE TColor ScaleColor(TColor color, TFloat r, TFloat g, TFloat b)
+	{
+		const __m512 toFloat = _mm512_set1_ps(1.0f / 255.0f);
+		const __m512 fromFloat = _mm512_set1_ps(255.0f);
+		const __m512i mask = _mm512_set1_epi32(0x000000ff);
+		const __m512i alphaMask = _mm512_set1_epi32(0xff000000);
+
+		const __m512 r0 = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(color, 16), mask)), toFloat);
+		const __m512 g0 = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(color, 8), mask)), toFloat);
+		const __m512 b0 = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_and_si512(color, mask)), toFloat);
+
+		const __m512i r1 = _mm512_slli_epi32(_mm512_and_si512(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_mul_ps(r0, r), fromFloat)), mask), 16);
+		const __m512i g1 = _mm512_slli_epi32(_mm512_and_si512(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_mul_ps(g0, g), fromFloat)), mask), 8);
+		const __m512i b1 = _mm512_and_si512(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_mul_ps(b0, b), fromFloat)), mask);
+		return _mm512_or_si512(alphaMask, _mm512_or_si512(r1, _mm512_or_si512(g1, b1)));
+	}
+};
+
+}
+
+namespace pfx2
+{
+
+extern const SParticleKernels gParticleKernelsAVX512 = CRY_PFX2_PARTICLE_KERNELS("AVX-512", SLanesAVX512);
+
+}
+
+	#if CRY_COMPILER_CLANG
+		#pragma clang attribute pop
+	#elif CRY_COMPILER_GCC
+		#pragma GCC pop_options
+	#endif
+
+#endif // CRY_PFX2_USE_AVX512
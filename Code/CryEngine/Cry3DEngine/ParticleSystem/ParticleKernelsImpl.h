@@ -0,0 +1,134 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Update kernels for any vector width. TLanes provides the
+//               vector types and operations. Each instruction set has its own
+//               translation unit which includes this file with its TLanes,
+//               after ParticleKernels.h and everything else is included.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef PARTICLEKERNELSIMPL_H
+#define PARTICLEKERNELSIMPL_H
+
+#pragma once
+
+#include "ParticleKernels.h"
+
+namespace pfx2
+{
+
+namespace detail
+{
+
+template<typename TLanes>
+ILINE typename TLanes::TFloat LoadOptional(const float* pStream, uint32 id, typename TLanes::TFloat defaultVal)
+{
+	return pStream ? TLanes::Load(pStream + id) : defaultVal;
+}
+
+template<typename TLanes>
+void LinearIntegralKernel(const SMotionKernelData& data, uint32 first, uint32 last)
+{
+	typedef typename TLanes::TFloat TFloat;
+	const TFloat deltaTime = TLanes::Set(data.m_deltaTime);
+
+	for (uint32 id = first; id < last; id += TLanes::Count)
+	{
+		const TFloat normAge = TLanes::Load(data.m_pNormAges + id);
+		const TFloat dT = TLanes::DeltaTime(normAge, deltaTime);
+		for (uint axis = 0; axis < 3; ++axis)
+		{
+			const TFloat p0 = TLanes::Load(data.m_pPositions[axis] + id);
+			const TFloat v0 = TLanes::Load(data.m_pVelocities[axis] + id);
+			TLanes::Store(data.m_pPositions[axis] + id, TLanes::MAdd(v0, dT, p0));
+		}
+	}
+}
+
+template<typename TLanes>
+void DragFastIntegralKernel(const SMotionKernelData& data, uint32 first, uint32 last)
+{
+	typedef typename TLanes::TFloat TFloat;
+	const TFloat zero = TLanes::Set(0.0f);
+	const TFloat deltaTime = TLanes::Set(data.m_deltaTime);
+	const TFloat dragReduction = TLanes::Set(data.m_dragReduction);
+	const TFloat physAccel[3] = { TLanes::Set(data.m_physAccel.x), TLanes::Set(data.m_physAccel.y), TLanes::Set(data.m_physAccel.z) };
+	const TFloat physWind[3] = { TLanes::Set(data.m_physWind.x), TLanes::Set(data.m_physWind.y), TLanes::Set(data.m_physWind.z) };
+	const TFloat uniformAccel[3] = { TLanes::Set(data.m_uniformAccel.x), TLanes::Set(data.m_uniformAccel.y), TLanes::Set(data.m_uniformAccel.z) };
+
+	for (uint32 id = first; id < last; id += TLanes::Count)
+	{
+		const TFloat normAge = TLanes::Load(data.m_pNormAges + id);
+		const TFloat dT = TLanes::DeltaTime(normAge, deltaTime);
+		const TFloat gravMult = LoadOptional<TLanes>(data.m_pGravities, id, zero);
+		const TFloat drag = TLanes::Mul(LoadOptional<TLanes>(data.m_pDrags, id, zero), dragReduction);
+
+		for (uint axis = 0; axis < 3; ++axis)
+		{
+			const TFloat partAccel = LoadOptional<TLanes>(data.m_pAccelerations[axis], id, zero);
+			const TFloat fieldVel = LoadOptional<TLanes>(data.m_pVelocityField[axis], id, zero);
+			const TFloat partVel = TLanes::Add(physWind[axis], fieldVel);
+			const TFloat p0 = TLanes::Load(data.m_pPositions[axis] + id);
+			const TFloat v0 = TLanes::Load(data.m_pVelocities[axis] + id);
+
+			const TFloat a = TLanes::Add(TLanes::MAdd(physAccel[axis], gravMult, partAccel), uniformAccel[axis]);
+			const TFloat accel = TLanes::MAdd(TLanes::Sub(partVel, v0), drag, a);  // (partVel-v0)*drag + a
+			const TFloat p1 = TLanes::MAdd(v0, dT, p0);                             // v0*dT + p0
+			const TFloat v1 = TLanes::MAdd(accel, dT, v0);                          // accel*dT + v0
+
+			TLanes::Store(data.m_pPositions[axis] + id, p1);
+			TLanes::Store(data.m_pVelocities[axis] + id, v1);
+		}
+	}
+}
+
+template<typename TLanes>
+void AgeUpdateKernel(const SAgeKernelData& data, uint32 first, uint32 last)
+{
+	typedef typename TLanes::TFloat TFloat;
+	const TFloat zero = TLanes::Set(0.0f);
+	const TFloat deltaTime = TLanes::Set(data.m_deltaTime);
+
+	for (uint32 id = first; id < last; id += TLanes::Count)
+	{
+		const TFloat invLifeTime = TLanes::Load(data.m_pInvLifeTimes + id);
+		const TFloat normAge0 = TLanes::Load(data.m_pNormAges + id);
+		const TFloat dT = TLanes::DeltaTime(normAge0, deltaTime);
+		const TFloat normAge1 = TLanes::MAdd(dT, invLifeTime, TLanes::Max(zero, normAge0));
+		TLanes::Store(data.m_pNormAges + id, normAge1);
+	}
+}
+
+template<typename TLanes>
+void ColorScaleKernel(const SColorKernelData& data, uint32 first, uint32 last)
+{
+	typedef typename TLanes::TFloat TFloat;
+	const TFloat r = TLanes::Set(data.m_scale.r);
+	const TFloat g = TLanes::Set(data.m_scale.g);
+	const TFloat b = TLanes::Set(data.m_scale.b);
+
+	for (uint32 id = first; id < last; id += TLanes::Count)
+	{
+		const typename TLanes::TColor color0 = TLanes::LoadColor(data.m_pColors + id);
+		TLanes::StoreColor(data.m_pColors + id, TLanes::ScaleColor(color0, r, g, b));
+	}
+}
+
+}
+
+}
+
+// The table is constant initialized, nothing of the instruction set runs before the CPU is checked.
+#define CRY_PFX2_PARTICLE_KERNELS(Name, TLanes)       \
+  {                                                   \
+    Name,                                             \
+    TLanes::Count,                                    \
+    &pfx2::detail::LinearIntegralKernel<TLanes>,      \
+    &pfx2::detail::DragFastIntegralKernel<TLanes>,    \
+    &pfx2::detail::AgeUpdateKernel<TLanes>,           \
+    &pfx2::detail::ColorScaleKernel<TLanes>           \
+  }
+
+#endif // PARTICLEKERNELSIMPL_H
@@ -11,6 +11,7 @@
 #include <CrySystem/CryUnitTest.h>
 #include "ParticleSystem.h"
 #include "ParticleContainer.h"
+#include "ParticleKernels.h"
 #include "../ParticleEffect.h"
 #include "ParticleEffect.h"
 #include <CryMath/SNoise.h>
@@ -399,6 +400,191 @@ CRY_UNIT_TEST_SUITE(CryParticleSystemTest)
 
 #endif
 
+	CRY_UNIT_TEST_FIXTURE(CParticleKernelsTests)
+	{
+	public:
+		// not a multiple of the widest kernels, the end is updated by the particle group kernels
+		enum { NUM_PARTICLES = 4096 + 12 };
+
+		virtual void Init() override
+		{
+			const EParticleDataType types[] =
+			{
+				EPDT_NormalAge, EPDT_InvLifeTime, EPDT_Gravity, EPDT_Drag, EPDT_Color,
+				EPDT_PositionX, EPDT_PositionY, EPDT_PositionZ, EPDT_VelocityX, EPDT_VelocityY, EPDT_VelocityZ,
+				EPDT_AccelerationX, EPDT_AccelerationY, EPDT_AccelerationZ
+			};
+			m_pContainer = std::unique_ptr<pfx2::CParticleContainer>(new pfx2::CParticleContainer());
+			for (size_t i = 0; i < arraysize(types); ++i)
+				m_pContainer->AddParticleData(types[i]);
+			m_pContainer->Resize(NUM_PARTICLES);
+
+			// the velocity field stays absent, the kernels read it as 0
+			SChaosKey chaos(0x5eedu);
+			for (uint type = 0; type < EPDT_Count; ++type)
+			{
+				if (!m_pContainer->HasData(EParticleDataType(type)))
+					continue;
+				std::vector<byte>& stream = m_initial[type];
+				stream.resize(NUM_PARTICLES * gParticleDataStrides[type]);
+				if (type == EPDT_Color)
+				{
+					for (uint i = 0; i < NUM_PARTICLES; ++i)
+						reinterpret_cast<uint32*>(&stream[0])[i] = chaos.Rand() | 0xff000000;
+				}
+				else
+				{
+					// negative normal ages are particles spawned during the frame
+					for (uint i = 0; i < NUM_PARTICLES; ++i)
+						reinterpret_cast<float*>(&stream[0])[i] = type == EPDT_InvLifeTime ? chaos.Rand(SChaosKey::Range(0.1f, 2.0f)) : chaos.RandSNorm() * 4.0f;
+				}
+			}
+		}
+
+		virtual void Done() override
+		{
+			m_pContainer.reset();
+		}
+
+		void Reset()
+		{
+			for (uint type = 0; type < EPDT_Count; ++type)
+			{
+				if (!m_initial[type].empty())
+					memcpy(m_pContainer->GetData(EParticleDataType(type)), &m_initial[type][0], m_initial[type].size());
+			}
+		}
+
+		void Snapshot(std::vector<byte>* pResult) const
+		{
+			for (uint type = 0; type < EPDT_Count; ++type)
+			{
+				if (m_initial[type].empty())
+					continue;
+				const byte* pData = reinterpret_cast<const byte*>(m_pContainer->GetData(EParticleDataType(type)));
+				pResult[type].assign(pData, pData + m_initial[type].size());
+			}
+		}
+
+		SMotionKernelData MotionData()
+		{
+			SMotionKernelData data;
+			ZeroStruct(data);
+			for (uint axis = 0; axis < 3; ++axis)
+			{
+				data.m_pPositions[axis] = reinterpret_cast<float*>(m_pContainer->GetData(EParticleDataType(EPDT_PositionX + axis)));
+				data.m_pVelocities[axis] = reinterpret_cast<float*>(m_pContainer->GetData(EParticleDataType(EPDT_VelocityX + axis)));
+				data.m_pAccelerations[axis] = reinterpret_cast<float*>(m_pContainer->GetData(EParticleDataType(EPDT_AccelerationX + axis)));
+			}
+			data.m_pGravities = reinterpret_cast<float*>(m_pContainer->GetData(EPDT_Gravity));
+			data.m_pDrags = reinterpret_cast<float*>(m_pContainer->GetData(EPDT_Drag));
+			data.m_pNormAges = reinterpret_cast<float*>(m_pContainer->GetData(EPDT_NormalAge));
+			data.m_physAccel = Vec3(0.0f, 0.0f, -9.8f);
+			data.m_physWind = Vec3(1.5f, -0.5f, 0.0f);
+			data.m_uniformAccel = Vec3(0.25f, 0.5f, 1.0f);
+			data.m_dragReduction = 0.75f;
+			data.m_deltaTime = 1.0f / 30.0f;
+			return data;
+		}
+
+		SAgeKernelData AgeData()
+		{
+			SAgeKernelData data;
+			data.m_pNormAges = reinterpret_cast<float*>(m_pContainer->GetData(EPDT_NormalAge));
+			data.m_pInvLifeTimes = reinterpret_cast<float*>(m_pContainer->GetData(EPDT_InvLifeTime));
+			data.m_deltaTime = 1.0f / 30.0f;
+			return data;
+		}
+
+		SColorKernelData ColorData()
+		{
+			SColorKernelData data;
+			data.m_pColors = reinterpret_cast<UCol*>(m_pContainer->GetData(EPDT_Color));
+			data.m_scale = ColorF(0.9f, 0.5f, 1.0f);
+			return data;
+		}
+
+		void Update(const SParticleKernels& kernels, const SUpdateRange& range)
+		{
+			kernels.DragFastIntegral(MotionData(), range);
+			kernels.LinearIntegral(MotionData(), range);
+			kernels.AgeUpdate(AgeData(), range);
+			kernels.ColorScale(ColorData(), range);
+		}
+
+		std::unique_ptr<pfx2::CParticleContainer> m_pContainer;
+		std::vector<byte>                         m_initial[EPDT_Count];
+	};
+
+	CRY_UNIT_TEST_WITH_FIXTURE(CParticleKernels_SameResultForAllWidths, CParticleKernelsTests)
+	{
+		// ranges starting and ending off the vector boundaries of the wide kernels
+		const SUpdateRange ranges[] = { SUpdateRange(0, NUM_PARTICLES), SUpdateRange(4, NUM_PARTICLES - 5), SUpdateRange(12, 40) };
+		const SParticleKernels* pGroupKernels = GetParticleKernels(CRY_PFX2_PARTICLESGROUP_STRIDE);
+		CRY_PFX2_UNIT_TEST_ASSERT(pGroupKernels != nullptr);
+
+		for (uint32 lanes = CRY_PFX2_PARTICLESGROUP_STRIDE * 2; lanes <= CRY_PFX2_MAX_LANES; lanes *= 2)
+		{
+			const SParticleKernels* pKernels = GetParticleKernels(lanes);
+			if (!pKernels)
+				continue;
+			for (size_t r = 0; r < arraysize(ranges); ++r)
+			{
+				std::vector<byte> expected[EPDT_Count];
+				std::vector<byte> result[EPDT_Count];
+				Reset();
+				Update(*pGroupKernels, ranges[r]);
+				Snapshot(expected);
+				Reset();
+				Update(*pKernels, ranges[r]);
+				Snapshot(result);
+				for (uint type = 0; type < EPDT_Count; ++type)
+				{
+					CRY_PFX2_UNIT_TEST_ASSERT(expected[type] == result[type]);
+				}
+			}
+		}
+	}
+
+	CRY_UNIT_TEST_WITH_FIXTURE(CParticleKernels_Benchmark, CParticleKernelsTests)
+	{
+		const uint numRepeats = 200;
+		const SUpdateRange range(0, NUM_PARTICLES);
+		ITimer* pTimer = gEnv->pTimer;
+
+		for (uint32 lanes = CRY_PFX2_PARTICLESGROUP_STRIDE; lanes <= CRY_PFX2_MAX_LANES; lanes *= 2)
+		{
+			const SParticleKernels* pKernels = GetParticleKernels(lanes);
+			if (!pKernels)
+				continue;
+
+			// particles per ms of each feature update
+			CTimeValue times[4];
+			for (uint repeat = 0; repeat < numRepeats; ++repeat)
+			{
+				Reset();
+				CTimeValue start = pTimer->GetAsyncTime();
+				pKernels->DragFastIntegral(MotionData(), range);
+				times[0] += pTimer->GetAsyncTime() - start;
+				start = pTimer->GetAsyncTime();
+				pKernels->LinearIntegral(MotionData(), range);
+				times[1] += pTimer->GetAsyncTime() - start;
+				start = pTimer->GetAsyncTime();
+				pKernels->AgeUpdate(AgeData(), range);
+				times[2] += pTimer->GetAsyncTime() - start;
+				start = pTimer->GetAsyncTime();
+				pKernels->ColorScale(ColorData(), range);
+				times[3] += pTimer->GetAsyncTime() - start;
+			}
+
+			const float numParticles = float(NUM_PARTICLES) * float(numRepeats);
+			CryLogAlways("Particle update kernels %s (%u lanes): motion drag %.0f, motion linear %.0f, life %.0f, color %.0f particles/ms",
+			             pKernels->m_name, pKernels->m_lanes,
+			             numParticles / max(times[0].GetMilliSeconds(), 0.001f), numParticles / max(times[1].GetMilliSeconds(), 0.001f),
+			             numParticles / max(times[2].GetMilliSeconds(), 0.001f), numParticles / max(times[3].GetMilliSeconds(), 0.001f));
+		}
+	}
+
 }
 
 CRY_UNIT_TEST_SUITE(CryVectorTest)
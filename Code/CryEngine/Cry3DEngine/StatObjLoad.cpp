@@ -20,6 +20,7 @@
 #include "CGF/CGFLoader.h"
 #include "CGF/CGFSaver.h"
 #include "CGF/ReadOnlyChunkFile.h"
+#include "LevelStatObjLoader.h"
 
 #include <CryMemory/CryMemoryManager.h>
 
@@ -610,8 +611,16 @@ bool CStatObj::LoadCGF_Int(const char* filename, bool bLod, unsigned long nLoadi
 	Listener listener;
 	CReadOnlyChunkFile chunkFile(false, bLod);  // Chunk file must exist until CGF is completely loaded, and if loading from file do not make a copy of it.
 
+	// parsed by a job during the level CGF preload
+	std::unique_ptr<CLevelStatObjLoader::SParsedCGF> pParsedCGF(nDataSize ? NULL : CLevelStatObjLoader::TakeParsedCGF(filename, bLod, nLoadingFlags));
+
 	bool bLoaded = false;
-	if (nDataSize)
+	if (pParsedCGF)
+	{
+		pCGF = pParsedCGF->pContent;
+		bLoaded = true;
+	}
+	else if (nDataSize)
 	{
 		if (chunkFile.ReadFromMemory(pData, nDataSize))
 			bLoaded = cgfLoader.LoadCGF(contentContainer.get(), filename, chunkFile, &listener, nLoadingFlags);
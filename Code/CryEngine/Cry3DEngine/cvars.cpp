@@ -525,6 +525,10 @@ void CVars::Init()
 	              "  6 - Reprojection and occlusion meshes");
 	REGISTER_CVAR(e_CoverageBufferRastPolyLimit, 60000, VF_NULL,
 	              "maximum amount of polys to rasterize cap, 0 means no limit\ndefault is 500000");
+	REGISTER_CVAR(e_CoverageBufferTiles, 1, VF_NULL,
+	              "Bins the occlusion mesh triangles into tiles of 8 lines which are rasterized in parallel jobs\n"
+	              "  0 - Rasterize the triangles on the occlusion thread\n"
+	              "  1 - Rasterize the tiles in jobs");
 	REGISTER_CVAR(e_CoverageBufferShowOccluder, 0, VF_NULL,
 	              "1 show only meshes used as occluder, 2 show only meshes not used as occluder");
 	REGISTER_CVAR(e_CoverageBufferOccludersViewDistRatio, 1.0f, VF_CHEAT,
@@ -934,6 +938,9 @@ void CVars::Init()
 
 	DefineConstIntCVar(e_StatObjPreload, 1, VF_NULL,
 	                   "Load level CGF's in efficient way");
+	REGISTER_CVAR(e_StatObjPreloadAhead, 16, VF_NULL,
+	              "Number of level CGF's (with their LODs) read and parsed by job workers ahead of the main thread during the preload\n"
+	              "0 = parse them on the main thread");
 
 	DefineConstIntCVar(e_PreloadMaterials, 1, VF_NULL,
 	                   "Preload level materials from level cache pak and resources list");
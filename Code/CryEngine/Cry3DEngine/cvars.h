@@ -167,6 +167,7 @@ struct CVars : public Cry3DEngineBase
 	DeclareConstIntCVar(e_ShadowsTessellateDLights, 0);
 	int e_CoverageBufferReproj;
 	int e_CoverageBufferRastPolyLimit;
+	int e_CoverageBufferTiles;
 	int e_CoverageBufferShowOccluder;
 	DeclareConstFloatCVar(e_ViewDistRatioPortals);
 	DeclareConstIntCVar(e_ParticlesLights, 1);
@@ -223,6 +224,7 @@ struct CVars : public Cry3DEngineBase
 	DeclareConstIntCVar(e_DebugLights, 0);
 	int e_StreamCgfPoolSize;
 	DeclareConstIntCVar(e_StatObjPreload, 1);
+	int e_StatObjPreloadAhead;
 	DeclareConstIntCVar(e_ShadowsDebug, 0);
 	DeclareConstIntCVar(e_ShadowsCascadesDebug, 0);
 	DeclareConstFloatCVar(e_StreamPredictionDistanceNear);
@@ -5,6 +5,7 @@
 #include "Communication/CommunicationManager.h"
 #include "Communication/CommunicationTestManager.h"
 #include "Navigation/NavigationSystem/NavigationSystem.h"
+#include "MNMPathfinder.h"
 #include "BehaviorTree/BehaviorTreeManager.h"
 
 void AIConsoleVars::Init()
@@ -415,6 +416,16 @@ void AIConsoleVars::Init()
 	                       " Fast machine [10]\n"
 	                       " Slow machine [4]\n"
 	                       " Smooth [1]\n");
+	DefineConstIntCVarName("ai_NavGenPipeline", NavGenPipeline, 0, VF_CHEAT | VF_CHEAT_NOCHECK,
+	                       "Runs voxelization, triangulation and BV tree construction of a tile as separate jobs.\n"
+	                       "The stages of one tile still run one after another, the jobs are only shorter.\n"
+	                       "Usage: ai_NavGenPipeline [0/1]\n"
+	                       "Default is 0 (off)\n");
+	DefineConstIntCVarName("ai_NavGenVoxelCacheSize", NavGenVoxelCacheSize, 128, VF_CHEAT | VF_CHEAT_NOCHECK,
+	                       "Number of voxelized tiles kept to be shared between the meshes of different agent types.\n"
+	                       "The queued tiles of all meshes are grouped by volume, so it only needs to hold the tiles being generated.\n"
+	                       "Usage: ai_NavGenVoxelCacheSize [0+]\n"
+	                       "Default is 128. 0 disables the cache.\n");
 	DefineConstIntCVarName("ai_DebugDrawNavigationWorldMonitor", DebugDrawNavigationWorldMonitor, 0, VF_CHEAT | VF_CHEAT_NOCHECK,
 	                       "Enables displaying bounding boxes for world changes.\n"
 	                       "Usage: ai_DebugDrawNavigationWorldMonitor [0/1]\n"
@@ -800,6 +811,13 @@ void AIConsoleVars::Init()
 	               "Set path finding frame time quota in seconds (Set to 0 for no limit)");
 	REGISTER_CVAR2("ai_MNMPathFinderDebug", &MNMPathFinderDebug, 0, VF_CHEAT | VF_CHEAT_NOCHECK,
 	               "[0-1] Enable/Disable debug draw statistics on pathfinder load");
+	REGISTER_CVAR2("ai_MNMPathfinderHierarchical", &MNMPathfinderHierarchical, 1, VF_CHEAT | VF_CHEAT_NOCHECK,
+	               "[0-1] Enable/Disable the tile graph for long path requests.\n"
+	               "The way is first searched between the tiles and the triangle search is then restricted to the found tile corridor.");
+	REGISTER_CVAR2("ai_MNMPathfinderHierarchicalMinDistance", &MNMPathfinderHierarchicalMinDistance, 64.0f, VF_CHEAT | VF_CHEAT_NOCHECK,
+	               "Minimum distance in meters between start and end of a path request to use the tile graph");
+	REGISTER_CVAR2("ai_MNMPathfinderHierarchicalCorridorWidth", &MNMPathfinderHierarchicalCorridorWidth, 1, VF_CHEAT | VF_CHEAT_NOCHECK,
+	               "Number of neighbour tile rings added around the tile corridor found in the tile graph");
 
 	REGISTER_CVAR2("ai_MNMProfileMemory", &MNMProfileMemory, 0, VF_CHEAT | VF_CHEAT_NOCHECK,
 	               "[0-1] Display navigation system memory statistics");
@@ -854,6 +872,14 @@ void AIConsoleVars::Init()
 
 	DefineConstIntCVarName("ai_VisionMapNumberOfPVSUpdatesPerFrame", VisionMapNumberOfPVSUpdatesPerFrame, 1, VF_CHEAT | VF_CHEAT_NOCHECK, "");
 	DefineConstIntCVarName("ai_VisionMapNumberOfVisibilityUpdatesPerFrame", VisionMapNumberOfVisibilityUpdatesPerFrame, 1, VF_CHEAT | VF_CHEAT_NOCHECK, "");
+	DefineConstIntCVarName("ai_VisionMapRayCache", VisionMapRayCache, 1, VF_CHEAT | VF_CHEAT_NOCHECK,
+	                       "Reuses the result of the last visibility check of an observer/observable pair while neither of them moved\n"
+	                       "and no physical entity changed in the world cells along the rays.\n"
+	                       "Usage: ai_VisionMapRayCache [0/1]");
+	DefineConstIntCVarName("ai_VisionMapAdaptiveRayPriority", VisionMapAdaptiveRayPriority, 1, VF_CHEAT | VF_CHEAT_NOCHECK,
+	                       "Raises the priority of the visibility rays towards close and hostile observables, and lowers it for observables\n"
+	                       "at the end of the sight range.\n"
+	                       "Usage: ai_VisionMapAdaptiveRayPriority [0/1]");
 
 	DefineConstIntCVarName("ai_DebugDrawVisionMap", DebugDrawVisionMap, 0, VF_CHEAT | VF_CHEAT_NOCHECK,
 	                       "Toggles the debug drawing of the AI VisionMap.");
@@ -963,6 +989,15 @@ void AIConsoleVars::Init()
 	REGISTER_COMMAND("ai_MNMComputeConnectedIslands", MNMComputeConnectedIslands, VF_DEV_ONLY,
 	                 "Computes connected islands on the mnm mesh.\n");
 
+	REGISTER_COMMAND("ai_MNMPathfinderRecordRequests", MNMPathfinderRecordRequests, VF_DEV_ONLY,
+	                 "Records the start and end locations of all path requests to a file, to be replayed by ai_MNMPathfinderBenchmark.\n"
+	                 "Usage: ai_MNMPathfinderRecordRequests [fileName]\n"
+	                 "Without a file name the recording is stopped.\n");
+
+	REGISTER_COMMAND("ai_MNMPathfinderBenchmark", MNMPathfinderBenchmark, VF_DEV_ONLY,
+	                 "Replays recorded path requests with and without the tile graph and logs the query latencies.\n"
+	                 "Usage: ai_MNMPathfinderBenchmark <fileName>\n");
+
 	REGISTER_COMMAND("ai_DebugAgent", DebugAgent, VF_NULL,
 	                 "Start debugging an agent more in-depth. Pick by name, closest or in center of view.\n"
 	                 "Example: ai_DebugAgent closest\n"
@@ -1138,6 +1173,29 @@ void AIConsoleVars::MNMComputeConnectedIslands(IConsoleCmdArgs* args)
 	gAIEnv.pNavigationSystem->ComputeIslands();
 }
 
+void AIConsoleVars::MNMPathfinderRecordRequests(IConsoleCmdArgs* args)
+{
+	if (!gAIEnv.pMNMPathfinder)
+		return;
+
+	if (args->GetArgCount() >= 2)
+		gAIEnv.pMNMPathfinder->StartRecordingRequests(args->GetArg(1));
+	else
+		gAIEnv.pMNMPathfinder->StopRecordingRequests();
+}
+
+void AIConsoleVars::MNMPathfinderBenchmark(IConsoleCmdArgs* args)
+{
+	if (args->GetArgCount() < 2)
+	{
+		AIWarning("Usage: ai_MNMPathfinderBenchmark <fileName>");
+		return;
+	}
+
+	if (gAIEnv.pMNMPathfinder)
+		gAIEnv.pMNMPathfinder->RunBenchmark(args->GetArg(1));
+}
+
 void AIConsoleVars::DebugAgent(IConsoleCmdArgs* args)
 {
 	EntityId debugTargetEntity = 0;
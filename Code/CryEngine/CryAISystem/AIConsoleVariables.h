@@ -21,6 +21,8 @@ struct AIConsoleVars
 	DeclareConstIntCVar(DebugDrawNavigationWorldMonitor, 0);
 	DeclareConstIntCVar(NavigationSystemMT, 1);
 	DeclareConstIntCVar(NavGenThreadJobs, 1);
+	DeclareConstIntCVar(NavGenPipeline, 0);
+	DeclareConstIntCVar(NavGenVoxelCacheSize, 128);
 	DeclareConstIntCVar(DebugDrawCoverPlanes, 0);
 	DeclareConstIntCVar(DebugDrawCoverLocations, 0);
 	DeclareConstIntCVar(DebugDrawCoverSampler, 0);
@@ -162,6 +164,8 @@ struct AIConsoleVars
 
 	DeclareConstIntCVar(VisionMapNumberOfPVSUpdatesPerFrame, 1);
 	DeclareConstIntCVar(VisionMapNumberOfVisibilityUpdatesPerFrame, 1);
+	DeclareConstIntCVar(VisionMapRayCache, 1);
+	DeclareConstIntCVar(VisionMapAdaptiveRayPriority, 1);
 
 	DeclareConstIntCVar(DebugDrawVisionMap, 0);
 	DeclareConstIntCVar(DebugDrawVisionMapStats, 1);
@@ -328,6 +332,9 @@ struct AIConsoleVars
 
 	float MNMPathFinderQuota;
 	int   MNMPathFinderDebug;
+	int   MNMPathfinderHierarchical;
+	float MNMPathfinderHierarchicalMinDistance;
+	int   MNMPathfinderHierarchicalCorridorWidth;
 
 	int   MNMProfileMemory;
 
@@ -376,6 +383,8 @@ struct AIConsoleVars
 	static void DebugMNMAgentType(IConsoleCmdArgs* args);
 	static void MNMCalculateAccessibility(IConsoleCmdArgs* args); // TODO: Remove when the seeds work
 	static void MNMComputeConnectedIslands(IConsoleCmdArgs* args);
+	static void MNMPathfinderRecordRequests(IConsoleCmdArgs* args);
+	static void MNMPathfinderBenchmark(IConsoleCmdArgs* args);
 	static void DebugAgent(IConsoleCmdArgs* args);
 };
 
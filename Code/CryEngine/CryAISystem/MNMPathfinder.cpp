@@ -17,6 +17,40 @@ inline Vec3 TriangleCenter(const Vec3& a, const Vec3& b, const Vec3& c)
 	return (a + b + c) / 3.f;
 }
 
+// Starts the search of the tile corridor, when the tile graph is used and the request is long enough.
+// Otherwise the corridor of the working set is left empty.
+static bool StartTileCorridorSearch(const MNM::MeshGrid& grid, const MNM::TriangleID fromTriangleID, const MNM::TriangleID toTriangleID,
+                                    const MNM::vector3_t& endLocation, const MNM::real_t startToEndDist, const bool useTileGraph,
+                                    MNM::MeshGrid::WayQueryWorkingSet& workingSet)
+{
+	workingSet.tileCorridor.clear();
+
+	if (useTileGraph && startToEndDist >= MNM::real_t(gAIEnv.CVars.MNMPathfinderHierarchicalMinDistance))
+	{
+		// ways between different islands need off-mesh links, which are not part of the tile graph
+		MNM::Tile::Triangle fromTriangle, toTriangle;
+		if (grid.GetTriangle(fromTriangleID, fromTriangle) && grid.GetTriangle(toTriangleID, toTriangle) && fromTriangle.islandID == toTriangle.islandID)
+			return grid.StartTileCorridorSearch(fromTriangleID, toTriangleID, endLocation, workingSet);
+	}
+
+	return false;
+}
+
+// Continues the search of the tile corridor within the frame quota of the working set.
+// Once it's done, sets up the search over the triangles of the corridor, or of the whole mesh when no corridor was found.
+static bool ContinueTileCorridorSearch(const MNM::MeshGrid& grid, const MNM::TriangleID fromTriangleID, const MNM::vector3_t& startLocation,
+                                       const MNM::real_t startToEndDist, MNM::MeshGrid::WayQueryWorkingSet& workingSet)
+{
+	const size_t corridorWidth = (size_t)max(gAIEnv.CVars.MNMPathfinderHierarchicalCorridorWidth, 0);
+	size_t corridorTriangleCount = 0;
+	if (grid.ContinueTileCorridorSearch(corridorWidth, workingSet, corridorTriangleCount) == MNM::MeshGrid::eWQR_Continuing)
+		return false;
+
+	const size_t searchTriangleCount = workingSet.tileCorridor.empty() ? grid.GetTriangleCount() : corridorTriangleCount;
+	workingSet.aStarOpenList.SetUpForPathSolving(searchTriangleCount, fromTriangleID, startLocation, startToEndDist);
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 void MNM::PathfinderUtils::QueuedRequest::SetupDangerousLocationsData()
@@ -163,6 +197,7 @@ void ConstructPathIfWayWasFoundJob(MNM::PathfinderUtils::ProcessingContext* pPro
 DECLARE_JOB("PathConstruction", PathConstructionJob, ConstructPathIfWayWasFoundJob);
 
 CMNMPathfinder::CMNMPathfinder()
+	: m_pRequestsRecordFile(NULL)
 {
 	m_pathfindingFailedEventsToDispatch.reserve(gAIEnv.CVars.MNMPathfinderConcurrentRequests);
 	m_pathfindingCompletedEventsToDispatch.reserve(gAIEnv.CVars.MNMPathfinderConcurrentRequests);
@@ -170,6 +205,7 @@ CMNMPathfinder::CMNMPathfinder()
 
 CMNMPathfinder::~CMNMPathfinder()
 {
+	StopRecordingRequests();
 }
 
 void CMNMPathfinder::Reset()
@@ -231,6 +267,13 @@ MNM::QueuedPathID CMNMPathfinder::RequestPathTo(const IAIPathAgent* pRequester,
 		return 0;
 	}
 
+	if (m_pRequestsRecordFile)
+	{
+		gEnv->pCryPak->FPrintf(m_pRequestsRecordFile, "%s %f %f %f %f %f %f\n", gAIEnv.pNavigationSystem->GetAgentTypeName(request.agentTypeID),
+		                       request.startLocation.x, request.startLocation.y, request.startLocation.z,
+		                       request.endLocation.x, request.endLocation.y, request.endLocation.z);
+	}
+
 	return m_requestedPathsQueue.push_back(MNM::PathfinderUtils::QueuedRequest(pRequester, request.agentTypeID, request));
 }
 
@@ -478,6 +521,152 @@ void CMNMPathfinder::OnNavigationMeshChanged(const NavigationMeshID meshId, cons
 	}
 }
 
+void CMNMPathfinder::StartRecordingRequests(const char* fileName)
+{
+	StopRecordingRequests();
+
+	m_pRequestsRecordFile = gEnv->pCryPak->FOpen(fileName, "wt");
+	if (m_pRequestsRecordFile)
+		CryLogAlways("[CMNMPathfinder] Recording path requests to '%s'", fileName);
+	else
+		AIWarning("[CMNMPathfinder::StartRecordingRequests] Unable to open '%s' for writing", fileName);
+}
+
+void CMNMPathfinder::StopRecordingRequests()
+{
+	if (m_pRequestsRecordFile)
+	{
+		gEnv->pCryPak->FClose(m_pRequestsRecordFile);
+		m_pRequestsRecordFile = NULL;
+	}
+}
+
+void CMNMPathfinder::RunBenchmark(const char* fileName) const
+{
+	FILE* pFile = gEnv->pCryPak->FOpen(fileName, "rt");
+	if (!pFile)
+	{
+		AIWarning("[CMNMPathfinder::RunBenchmark] Unable to open '%s'", fileName);
+		return;
+	}
+
+	struct BenchmarkResults
+	{
+		BenchmarkResults() : foundCount(0), corridorCount(0), fallbackCount(0), totalMS(0.0f) {}
+
+		std::vector<float> latenciesMS;
+		size_t             foundCount;
+		size_t             corridorCount;
+		size_t             fallbackCount;
+		float              totalMS;
+	};
+
+	BenchmarkResults results[2];   // whole mesh, tile graph
+	MNM::MeshGrid::WayQueryWorkingSet workingSet;
+	MNM::MeshGrid::WayQueryResult queryResult;
+	const MNM::DangerousAreasList noDangerousAreas;
+	const OffMeshNavigationManager* pOffMeshNavigationManager = gAIEnv.pNavigationSystem->GetOffMeshNavigationManager();
+	size_t skippedCount = 0;
+
+	char line[512];
+	while (gEnv->pCryPak->FGets(line, sizeof(line), pFile))
+	{
+		char agentTypeName[128];
+		Vec3 startLocation, endLocation;
+		if (sscanf(line, "%127s %f %f %f %f %f %f", agentTypeName, &startLocation.x, &startLocation.y, &startLocation.z,
+		           &endLocation.x, &endLocation.y, &endLocation.z) != 7)
+			continue;
+
+		const NavigationAgentTypeID agentTypeID = gAIEnv.pNavigationSystem->GetAgentTypeID(agentTypeName);
+		const NavigationMeshID meshID = agentTypeID ? gAIEnv.pNavigationSystem->GetEnclosingMeshID(agentTypeID, startLocation) : NavigationMeshID();
+		if (!meshID)
+		{
+			++skippedCount;
+			continue;
+		}
+
+		const NavigationMesh& mesh = gAIEnv.pNavigationSystem->GetMesh(meshID);
+		const MNM::MeshGrid& grid = mesh.grid;
+		const MNM::MeshGrid::Params& gridParams = grid.GetParams();
+		const MNM::real_t horizontalRange = MNMUtils::CalculateMinHorizontalRange(gAIEnv.pNavigationSystem->GetAgentRadiusInVoxelUnits(agentTypeID), gridParams.voxelSize.x);
+		const MNM::real_t verticalRange = MNMUtils::CalculateMinVerticalRange(gAIEnv.pNavigationSystem->GetAgentHeightInVoxelUnits(agentTypeID), gridParams.voxelSize.z);
+
+		const MNM::vector3_t start(startLocation);
+		const MNM::vector3_t end(endLocation);
+		const MNM::vector3_t localStart(startLocation - gridParams.origin);
+		const MNM::vector3_t localEnd(endLocation - gridParams.origin);
+		const MNM::TriangleID fromTriangleID = grid.GetClosestTriangle(localStart, verticalRange, horizontalRange);
+		const MNM::TriangleID toTriangleID = grid.GetClosestTriangle(localEnd, verticalRange, horizontalRange);
+		if (!fromTriangleID || !toTriangleID)
+		{
+			++skippedCount;
+			continue;
+		}
+
+		const MNM::real_t startToEndDist = (end - start).lenNoOverflow();
+		MNM::MeshGrid::WayQueryRequest request(NULL, fromTriangleID, localStart, toTriangleID, localEnd,
+		                                       pOffMeshNavigationManager->GetOffMeshNavigationForMesh(meshID), *pOffMeshNavigationManager, noDangerousAreas);
+
+		for (size_t mode = 0; mode < CRY_ARRAY_COUNT(results); ++mode)
+		{
+			BenchmarkResults& result = results[mode];
+			const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+
+			workingSet.Reset();
+			workingSet.aStarOpenList.SetFrameTimeQuota(0.0f);
+			if (StartTileCorridorSearch(grid, fromTriangleID, toTriangleID, end, startToEndDist, mode == 1, workingSet))
+			{
+				while (!ContinueTileCorridorSearch(grid, fromTriangleID, start, startToEndDist, workingSet))
+					;
+			}
+			else
+			{
+				workingSet.aStarOpenList.SetUpForPathSolving(grid.GetTriangleCount(), fromTriangleID, start, startToEndDist);
+			}
+			if (!workingSet.tileCorridor.empty())
+				++result.corridorCount;
+
+			while (grid.FindWay(request, workingSet, queryResult) == MNM::MeshGrid::eWQR_Continuing)
+				;
+
+			if (queryResult.GetWaySize() == 0 && !workingSet.tileCorridor.empty())
+			{
+				++result.fallbackCount;
+				workingSet.tileCorridor.clear();
+				workingSet.aStarOpenList.PathSolvingDone();
+				workingSet.aStarOpenList.SetUpForPathSolving(grid.GetTriangleCount(), fromTriangleID, start, startToEndDist);
+				while (grid.FindWay(request, workingSet, queryResult) == MNM::MeshGrid::eWQR_Continuing)
+					;
+			}
+			workingSet.aStarOpenList.PathSolvingDone();
+
+			const float latencyMS = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+			result.latenciesMS.push_back(latencyMS);
+			result.totalMS += latencyMS;
+			if (queryResult.GetWaySize())
+				++result.foundCount;
+		}
+	}
+
+	gEnv->pCryPak->FClose(pFile);
+
+	CryLogAlways("[CMNMPathfinder] Benchmark of '%s': %" PRISIZE_T " requests, %" PRISIZE_T " skipped", fileName, results[0].latenciesMS.size(), skippedCount);
+
+	static const char* const modeNames[] = { "whole mesh", "tile graph" };
+	for (size_t mode = 0; mode < CRY_ARRAY_COUNT(results); ++mode)
+	{
+		BenchmarkResults& result = results[mode];
+		const size_t count = result.latenciesMS.size();
+		if (!count)
+			continue;
+
+		std::sort(result.latenciesMS.begin(), result.latenciesMS.end());
+		CryLogAlways("  %s: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms, total %.1f ms, found %" PRISIZE_T ", corridors %" PRISIZE_T ", fallbacks %" PRISIZE_T,
+		             modeNames[mode], result.latenciesMS[count / 2], result.latenciesMS[min(count * 9 / 10, count - 1)], result.latenciesMS[min(count * 99 / 100, count - 1)],
+		             result.latenciesMS[count - 1], result.totalMS, result.foundCount, result.corridorCount, result.fallbackCount);
+	}
+}
+
 bool CMNMPathfinder::SetupForNextPathRequest(MNM::QueuedPathID requestID, MNM::PathfinderUtils::QueuedRequest& request, MNM::PathfinderUtils::ProcessingContext& processingContext)
 {
 	MNM::PathfinderUtils::ProcessingRequest& processingRequest = processingContext.processingRequest;
@@ -561,8 +750,13 @@ bool CMNMPathfinder::SetupForNextPathRequest(MNM::QueuedPathID requestID, MNM::P
 	processingRequest.data.requestParams.startLocation = safeStartLocation;
 	processingRequest.data.requestParams.endLocation = safeEndLocation;
 
+	// with a tile corridor, the search over the triangles is set up once the corridor is known (see ProcessPathRequest)
 	const MNM::real_t startToEndDist = (endLocation - startLocation).lenNoOverflow();
-	processingContext.workingSet.aStarOpenList.SetUpForPathSolving(mesh.grid.GetTriangleCount(), triangleStartID, startLocation, startToEndDist);
+	if (!StartTileCorridorSearch(grid, triangleStartID, triangleEndID, endLocation, startToEndDist, gAIEnv.CVars.MNMPathfinderHierarchical != 0,
+	                             processingContext.workingSet))
+	{
+		processingContext.workingSet.aStarOpenList.SetUpForPathSolving(grid.GetTriangleCount(), triangleStartID, startLocation, startToEndDist);
+	}
 
 	return true;
 }
@@ -589,9 +783,33 @@ void CMNMPathfinder::ProcessPathRequest(MNM::PathfinderUtils::ProcessingContext&
 	                                           processingRequest.data.requestParams.endLocation - gridParams.origin, meshOffMeshNav, *offMeshNavigationManager,
 	                                           processingRequest.data.GetDangersInfos());
 
+	if (processingContext.workingSet.tileCorridorSearch.IsRunning())
+	{
+		const MNM::vector3_t startLocation(processingRequest.data.requestParams.startLocation);
+		const MNM::vector3_t endLocation(processingRequest.data.requestParams.endLocation);
+
+		if (!ContinueTileCorridorSearch(grid, processingRequest.fromTriangleID, startLocation, (endLocation - startLocation).lenNoOverflow(),
+		                                processingContext.workingSet))
+			return;
+	}
+
 	if (grid.FindWay(inputParams, processingContext.workingSet, processingContext.queryResult) == MNM::MeshGrid::eWQR_Continuing)
 		return;
 
+	if (processingContext.queryResult.GetWaySize() == 0 && !processingContext.workingSet.tileCorridor.empty())
+	{
+		// the tile graph doesn't know about off-mesh links and agent specific restrictions,
+		// search the whole mesh before failing the request
+		const MNM::vector3_t startLocation(processingRequest.data.requestParams.startLocation);
+		const MNM::vector3_t endLocation(processingRequest.data.requestParams.endLocation);
+
+		processingContext.workingSet.tileCorridor.clear();
+		processingContext.workingSet.aStarOpenList.PathSolvingDone();
+		processingContext.workingSet.aStarOpenList.SetUpForPathSolving(grid.GetTriangleCount(), processingRequest.fromTriangleID, startLocation,
+		                                                               (endLocation - startLocation).lenNoOverflow());
+		return;
+	}
+
 	processingContext.status = MNM::PathfinderUtils::ProcessingContext::FindWayCompleted;
 	return;
 }
@@ -356,6 +356,12 @@ public:
 
 	void                      OnNavigationMeshChanged(NavigationMeshID meshId, MNM::TileID tileId);
 
+	// Recorded requests are replayed by RunBenchmark, which runs every request to completion once with the
+	// triangle search over the whole mesh and once restricted to the tile corridor, and logs the latencies.
+	void                      StartRecordingRequests(const char* fileName);
+	void                      StopRecordingRequests();
+	void                      RunBenchmark(const char* fileName) const;
+
 private:
 
 	MNM::QueuedPathID QueuePathRequest(IAIPathAgent* pRequester, const MNMPathRequest& request);
@@ -386,6 +392,8 @@ private:
 	MNM::PathfinderUtils::ProcessingContextsPool        m_processingContextsPool;
 	MNM::PathfinderUtils::PathfinderFailedEventQueue    m_pathfindingFailedEventsToDispatch;
 	MNM::PathfinderUtils::PathfinderCompletedEventQueue m_pathfindingCompletedEventsToDispatch;
+
+	FILE* m_pRequestsRecordFile;
 };
 
 #endif // _MNMPATHFINDER_H_
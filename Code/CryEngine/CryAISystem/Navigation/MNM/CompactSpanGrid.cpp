@@ -93,4 +93,48 @@ void CompactSpanGrid::CompactExcluding(const CompactSpanGrid& spanGrid, size_t f
 		}
 	}
 }
+
+void CompactSpanGrid::CropFrom(const CompactSpanGrid& spanGrid, size_t x, size_t y, size_t z, size_t width, size_t height, size_t top)
+{
+	assert((x + width <= spanGrid.GetWidth()) && (y + height <= spanGrid.GetHeight()));
+
+	m_width = width;
+	m_height = height;
+
+	m_cells.assign(width * height, Cell());
+	m_spans.clear();
+	m_spans.reserve(spanGrid.GetSpanCount());
+
+	for (size_t cy = 0; cy < height; ++cy)
+	{
+		for (size_t cx = 0; cx < width; ++cx)
+		{
+			if (const Cell cell = spanGrid.GetCell(x + cx, y + cy))
+			{
+				const size_t nindex = m_spans.size();
+
+				for (size_t s = 0; s < cell.count; ++s)
+				{
+					const Span& span = spanGrid.GetSpan(cell.index + s);
+
+					const size_t spanBottom = span.bottom;
+					const size_t spanTop = spanBottom + span.height;
+					if ((spanTop <= z) || (spanBottom >= z + top))
+						continue;
+
+					const size_t bottom = std::max(spanBottom, z) - z;
+					const size_t clippedTop = std::min(spanTop, z + top) - z;
+
+					Span cropped(span);
+					cropped.bottom = bottom;
+					cropped.height = clippedTop - bottom;
+					m_spans.push_back(cropped);
+				}
+
+				const size_t ncount = m_spans.size() - nindex;
+				m_cells[cy * width + cx] = Cell(ncount ? nindex : 0, ncount);
+			}
+		}
+	}
+}
 }
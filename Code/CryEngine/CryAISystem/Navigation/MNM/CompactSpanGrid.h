@@ -182,6 +182,9 @@ public:
 	void Swap(CompactSpanGrid& other);
 	void BuildFrom(const DynamicSpanGrid& dynGrid);
 	void CompactExcluding(const CompactSpanGrid& spanGrid, size_t flags, size_t newSpanCount);
+	// Copies the width x height cells starting at cell (x, y) of spanGrid, moving the spans down by z voxels
+	// and clipping them to [0, top).
+	void CropFrom(const CompactSpanGrid& spanGrid, size_t x, size_t y, size_t z, size_t width, size_t height, size_t top);
 	void Clear();
 
 private:
@@ -134,6 +134,11 @@ struct AStarContention
 		m_consumedFrameTime.SetValue(0);
 	}
 
+	// Searches which run on behalf of the same request (e.g. the tile corridor search) share the frame quota.
+	inline bool CanDoExternalStep() const { return !FrameQuotaReached(); }
+	inline void StartExternalStep()       { StartStep(); }
+	inline void ExternalStepDone()        { EndStep(); }
+
 protected:
 	AStarContention(float frameTimeQuota = 0.001f)
 	{
@@ -988,6 +988,10 @@ MeshGrid::EWayQueryResult MeshGrid::FindWay(WayQueryRequest& inputRequest, WayQu
 					if (nextTri == bestNode->prevTriangle)
 						continue;
 
+					if (!workingSet.tileCorridor.empty() &&
+					    !std::binary_search(workingSet.tileCorridor.begin(), workingSet.tileCorridor.end(), ComputeTileID(nextTri.triangleID)))
+						continue;
+
 					AStarOpenList::Node* nextNode = NULL;
 					const bool inserted = workingSet.aStarOpenList.InsertNode(nextTri, &nextNode);
 
@@ -1914,6 +1918,8 @@ TileID MeshGrid::SetTile(size_t x, size_t y, size_t z, Tile& tile)
 	container.tile.Swap(tile);
 	tile.Destroy();
 
+	m_tileGraph.OnTileSet(*this, tileID);
+
 	return tileID;
 }
 
@@ -1964,6 +1970,8 @@ void MeshGrid::ClearTile(TileID tileID, bool clearNetwork)
 			}
 		}
 
+		m_tileGraph.OnTileCleared(*this, tileID, container.x, container.y, container.z);
+
 		m_profiler.FreeMemory(GridMemory, m_profiler[GridMemory].used);
 		m_profiler.AddMemory(GridMemory, m_tileMap.size() * sizeof(TileMap::value_type));
 		m_tiles.UpdateProfiler(m_profiler);
@@ -1987,6 +1995,12 @@ void MeshGrid::CreateNetwork()
 
 		ComputeAdjacency(container.x, container.y, container.z, toleranceSq, container.tile);
 	}
+
+	m_tileGraph.Clear();
+	for (it = m_tileMap.begin(); it != end; ++it)
+		m_tileGraph.ComputeRegions(*this, it->second);
+	for (it = m_tileMap.begin(); it != end; ++it)
+		m_tileGraph.ComputeEdges(*this, it->second);
 }
 
 void MeshGrid::ConnectToNetwork(TileID tileID)
@@ -2012,6 +2026,8 @@ void MeshGrid::ConnectToNetwork(TileID tileID)
 				                   OppositeSide(side), container.x, container.y, container.z, tileID);
 			}
 		}
+
+		m_tileGraph.OnTileConnected(*this, tileID);
 	}
 }
 
@@ -2051,6 +2067,8 @@ void MeshGrid::Swap(MeshGrid& other)
 
 	m_tileMap.swap(other.m_tileMap);
 
+	m_tileGraph.Swap(other.m_tileGraph);
+
 	std::swap(m_params, other.m_params);
 	std::swap(m_profiler, other.m_profiler);
 }
@@ -2193,6 +2211,24 @@ TileID MeshGrid::GetNeighbourTileID(size_t x, size_t y, size_t z, size_t side) c
 	return GetTileID(nx, ny, nz);
 }
 
+bool MeshGrid::StartTileCorridorSearch(const TriangleID fromTriangleID, const TriangleID toTriangleID, const vector3_t& toLocation,
+                                       WayQueryWorkingSet& workingSet) const
+{
+	workingSet.tileCorridor.clear();
+
+	return m_tileGraph.StartCorridorSearch(*this, fromTriangleID, toTriangleID, toLocation, workingSet.tileCorridorSearch);
+}
+
+MeshGrid::EWayQueryResult MeshGrid::ContinueTileCorridorSearch(const size_t corridorWidth, WayQueryWorkingSet& workingSet, size_t& corridorTriangleCount) const
+{
+	FUNCTION_PROFILER(gEnv->pSystem, PROFILE_AI);
+
+	const TileGraph::ECorridorSearchResult result = m_tileGraph.ContinueCorridorSearch(*this, corridorWidth, workingSet.tileCorridorSearch, workingSet.aStarOpenList,
+	                                                                                   workingSet.tileCorridor, corridorTriangleCount);
+
+	return (result == TileGraph::eCSR_Continuing) ? eWQR_Continuing : eWQR_Done;
+}
+
 static const size_t MaxTriangleCount = 1024;
 
 struct SideTileInfo
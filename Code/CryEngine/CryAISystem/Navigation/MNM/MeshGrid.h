@@ -8,6 +8,7 @@
 #include "MNM.h"
 #include "Tile.h"
 #include "MNMProfiler.h"
+#include "TileGraph.h"
 
 #include <CryMath/SimpleHashLookUp.h>
 #include <CryCore/Containers/VectorMap.h>
@@ -213,10 +214,14 @@ struct MeshGrid
 			aStarOpenList.Reset();
 			nextLinkedTriangles.clear();
 			nextLinkedTriangles.reserve(32);
+			tileCorridor.clear();
+			tileCorridorSearch.Reset();
 		}
 
-		TNextLinkedTriangles nextLinkedTriangles;
-		AStarOpenList        aStarOpenList;
+		TNextLinkedTriangles       nextLinkedTriangles;
+		AStarOpenList              aStarOpenList;
+		TileGraph::TileCorridor    tileCorridor;         // when not empty, the search doesn't leave these tiles (see StartTileCorridorSearch)
+		TileGraph::CorridorSearch  tileCorridorSearch;
 	};
 
 	struct WayQueryResult
@@ -468,6 +473,14 @@ struct MeshGrid
 
 	TileID GetNeighbourTileID(size_t x, size_t y, size_t z, size_t side) const;
 
+	// Finds the tiles a way between the two triangles passes through, using the tile graph instead of the triangles.
+	// The search is continued until done, within the frame quota of the working set's open list. When a corridor is found,
+	// it's set on the working set to restrict FindWay to those tiles, otherwise the corridor of the working set is empty.
+	bool             StartTileCorridorSearch(const TriangleID fromTriangleID, const TriangleID toTriangleID, const vector3_t& toLocation,
+	                                         WayQueryWorkingSet& workingSet) const;
+	EWayQueryResult  ContinueTileCorridorSearch(const size_t corridorWidth, WayQueryWorkingSet& workingSet, size_t& corridorTriangleCount) const;
+	const TileGraph& GetTileGraph() const { return m_tileGraph; }
+
 private:
 
 	struct Island
@@ -583,6 +596,8 @@ protected:
 	typedef std::map<uint32, uint32> TileMap;
 	TileMap             m_tileMap;
 
+	TileGraph           m_tileGraph;
+
 	std::vector<Island> m_islands;
 
 	struct IslandConnectionRequest
@@ -4,6 +4,7 @@
 #include "TileGenerator.h"
 #include "Voxelizer.h"
 #include "HashComputer.h"
+#include "TileVoxelCache.h"
 
 //#pragma optimize("", off)
 //#pragma inline_depth(0)
@@ -96,6 +97,11 @@ void TileGenerator::Clear()
 }
 
 bool TileGenerator::Generate(const Params& params, Tile& tile, uint32* tileHash)
+{
+	return GenerateVoxels(params, tileHash) && GenerateTriangles() && GenerateTile(tile);
+}
+
+bool TileGenerator::GenerateVoxels(const Params& params, uint32* tileHash)
 {
 	if ((params.sizeX > MaxTileSizeX) || (params.sizeY > MaxTileSizeY) || (params.sizeZ > MaxTileSizeZ))
 		return false;
@@ -202,13 +208,16 @@ bool TileGenerator::Generate(const Params& params, Tile& tile, uint32* tileHash)
 	if (!triCount)
 		return false;
 
-	tile.hashValue = hashValue;
+	m_hashValue = hashValue;
+	m_volume = aabb;
 
 	FilterWalkable(aabb, fullyContained);
 
-	if (!m_spanGrid.GetSpanCount())
-		return false;
+	return m_spanGrid.GetSpanCount() != 0;
+}
 
+bool TileGenerator::GenerateTriangles()
+{
 	ComputeDistanceTransform();
 	//BlurDistanceTransform();
 
@@ -219,19 +228,24 @@ bool TileGenerator::Generate(const Params& params, Tile& tile, uint32* tileHash)
 	SimplifyContours();
 	Triangulate();
 
+	return !m_vertices.empty();
+}
+
+bool TileGenerator::GenerateTile(Tile& tile)
+{
 	if (m_params.flags & Params::BuildBVTree)
 		BuildBVTree();
 
-	if (m_vertices.empty())
-		return false;
-
 	static const size_t MaxTriangleCount = 1024;
 
 	if (m_triangles.size() > MaxTriangleCount)
 	{
-		AIWarning("[MNM] Too many triangles in one tile. Coords: [%.2f,%.2f,%.2f]", aabb.GetCenter().x, aabb.GetCenter().y, aabb.GetCenter().z);
+		const Vec3 center = m_volume.GetCenter();
+		AIWarning("[MNM] Too many triangles in one tile. Coords: [%.2f,%.2f,%.2f]", center.x, center.y, center.z);
 	}
 
+	tile.hashValue = m_hashValue;
+
 	tile.CopyTriangles(&m_triangles.front(), static_cast<uint16>(min(MaxTriangleCount, m_triangles.size())));
 	tile.CopyVertices(&m_vertices.front(), static_cast<uint16>(m_vertices.size()));
 
@@ -250,27 +264,104 @@ size_t TileGenerator::VoxelizeVolume(const AABB& volume, uint32 hashValueSeed, u
 {
 	m_profiler.StartTimer(Voxelization);
 
-	WorldVoxelizer voxelizer;
+	size_t triCount = 0;
+	if (!VoxelizeVolumeCached(volume, hashValueSeed, hashValue, triCount))
+	{
+		WorldVoxelizer voxelizer;
 
-	voxelizer.Start(volume, m_params.voxelSize);
-	size_t triCount = voxelizer.ProcessGeometry(hashValueSeed,
-	                                            m_params.flags & Params::NoHashTest ? 0 : m_params.hashValue, hashValue, m_params.agent.callback);
-	voxelizer.CalculateWaterDepth();
+		voxelizer.Start(volume, m_params.voxelSize);
+		triCount = voxelizer.ProcessGeometry(hashValueSeed,
+		                                     m_params.flags & Params::NoHashTest ? 0 : m_params.hashValue, hashValue, m_params.agent.callback);
+		voxelizer.CalculateWaterDepth();
 
-	m_profiler.AddMemory(DynamicSpanGridMemory, voxelizer.GetSpanGrid().GetMemoryUsage());
+		m_profiler.AddMemory(DynamicSpanGridMemory, voxelizer.GetSpanGrid().GetMemoryUsage());
 
-	m_spanGrid.BuildFrom(voxelizer.GetSpanGrid());
+		m_spanGrid.BuildFrom(voxelizer.GetSpanGrid());
+
+		m_profiler.FreeMemory(DynamicSpanGridMemory, voxelizer.GetSpanGrid().GetMemoryUsage());
+	}
 
 	m_profiler.StopTimer(Voxelization);
 
 	m_profiler.AddMemory(CompactSpanGridMemory, m_spanGrid.GetMemoryUsage());
-	m_profiler.FreeMemory(DynamicSpanGridMemory, voxelizer.GetSpanGrid().GetMemoryUsage());
 
 	m_profiler.AddStat(VoxelizationTriCount, triCount);
 
 	return triCount;
 }
 
+bool TileGenerator::VoxelizeVolumeCached(const AABB& volume, uint32 hashValueSeed, uint32* hashValue, size_t& triCount)
+{
+	TileVoxelCache* pCache = m_params.voxelCache;
+	if (!pCache || (m_params.flags & Params::NoBorder))
+		return false;
+
+	const TileVoxelCache::AgentSize maxAgentSize = pCache->GetMaxAgentSize();
+	if ((m_params.agent.radius > maxAgentSize.radius) || (m_params.agent.height > maxAgentSize.height))
+		return false;
+
+	// the cached volume has the border and height of the largest agent, in whole voxels around the requested one
+	const size_t offsetH = ((maxAgentSize.radius & ~1) + 2) - BorderSizeH();
+	const size_t offsetV = ((maxAgentSize.radius & ~1) + 2) - BorderSizeV();
+	const size_t offsetTop = offsetV + maxAgentSize.height - m_params.agent.height;
+	const Vec3& voxelSize = m_params.voxelSize;
+
+	TileVoxelCache::Key key;
+	key.volume = AABB(volume.min - Vec3(offsetH * voxelSize.x, offsetH * voxelSize.y, offsetV * voxelSize.z),
+	                  volume.max + Vec3(offsetH * voxelSize.x, offsetH * voxelSize.y, offsetTop * voxelSize.z));
+	key.voxelSize = voxelSize;
+	key.hashSeed = hashValueSeed;
+	key.callback = m_params.agent.callback;
+
+	const bool testHash = (m_params.flags & Params::NoHashTest) == 0;
+	const uint32 hashTest = testHash ? m_params.hashValue : 0;
+
+	TileVoxelCache::VoxelsPtr pVoxels = pCache->Find(key);
+	if (!pVoxels)
+	{
+		const uint32 epoch = pCache->GetEpoch();
+
+		std::shared_ptr<TileVoxelCache::Voxels> pNewVoxels(new TileVoxelCache::Voxels());
+		WorldVoxelizer voxelizer;
+
+		// the voxelizer hashes the geometry first and only voxelizes it if the hash changed, an unchanged tile
+		// isn't voxelized for the other meshes either, their tiles didn't change
+		voxelizer.Start(key.volume, voxelSize);
+		pNewVoxels->triCount = voxelizer.ProcessGeometry(hashValueSeed, hashTest, &pNewVoxels->hashValue, m_params.agent.callback);
+		if (testHash && (pNewVoxels->hashValue == hashTest))
+		{
+			if (hashValue)
+				*hashValue = pNewVoxels->hashValue;
+			triCount = 0;
+			return true;
+		}
+		voxelizer.CalculateWaterDepth();
+
+		m_profiler.AddMemory(DynamicSpanGridMemory, voxelizer.GetSpanGrid().GetMemoryUsage());
+		pNewVoxels->spanGrid.BuildFrom(voxelizer.GetSpanGrid());
+		m_profiler.FreeMemory(DynamicSpanGridMemory, voxelizer.GetSpanGrid().GetMemoryUsage());
+
+		pCache->Insert(key, epoch, pNewVoxels);
+		pVoxels = pNewVoxels;
+	}
+
+	if (hashValue)
+		*hashValue = pVoxels->hashValue;
+
+	// same as the hash test of the voxelizer, the tile doesn't need to be generated again
+	const bool unchanged = testHash && (pVoxels->hashValue == hashTest);
+	triCount = unchanged ? 0 : pVoxels->triCount;
+
+	const CompactSpanGrid& cachedGrid = pVoxels->spanGrid;
+	if (triCount && (cachedGrid.GetWidth() >= 2 * offsetH) && (cachedGrid.GetHeight() >= 2 * offsetH))
+	{
+		const size_t top = (size_t)((volume.max.z - volume.min.z) / voxelSize.z + 0.5f);
+		m_spanGrid.CropFrom(cachedGrid, offsetH, offsetH, offsetV, cachedGrid.GetWidth() - 2 * offsetH, cachedGrid.GetHeight() - 2 * offsetH, top);
+	}
+
+	return true;
+}
+
 void TileGenerator::FilterWalkable(const AABB& aabb, bool fullyContained)
 {
 	m_profiler.StartTimer(Filter);
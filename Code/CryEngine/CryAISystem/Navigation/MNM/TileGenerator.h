@@ -15,6 +15,8 @@
 
 namespace MNM
 {
+class TileVoxelCache;
+
 class TileGenerator
 {
 public:
@@ -42,6 +44,7 @@ public:
 			, exclusions(0)
 			, exclusionCount(0)
 			, hashValue(0)
+			, voxelCache(0)
 		{
 		}
 
@@ -89,6 +92,8 @@ public:
 		const BoundingVolume* boundary;
 		const BoundingVolume* exclusions;
 		uint32                hashValue;
+
+		TileVoxelCache*       voxelCache; // optional, shares the voxelization of the tile with other meshes
 	};
 
 	enum ProfilerTimers
@@ -144,6 +149,13 @@ public:
 	};
 
 	bool Generate(const Params& params, Tile& tile, uint32* hashValue);
+
+	// The stages of Generate(), to be run one after the other on the same generator, e.g. as separate jobs.
+	// Generation ends without a tile as soon as a stage returns false.
+	bool GenerateVoxels(const Params& params, uint32* hashValue);
+	bool GenerateTriangles();
+	bool GenerateTile(Tile& tile);
+
 	void Draw(DrawMode mode) const;
 
 	typedef MNMProfiler<ProfilerMemoryUsers, ProfilerTimers, ProfilerStats> ProfilerType;
@@ -372,6 +384,7 @@ protected:
 	}
 
 	size_t VoxelizeVolume(const AABB& volume, uint32 hashValueSeed = 0, uint32* hashValue = 0);
+	bool   VoxelizeVolumeCached(const AABB& volume, uint32 hashValueSeed, uint32* hashValue, size_t& triCount);
 	void   FilterWalkable(const AABB& aabb, bool fullyContained = true);
 	void   ComputeDistanceTransform();
 	void   BlurDistanceTransform();
@@ -533,6 +546,8 @@ protected:
 	Params       m_params;
 	ProfilerType m_profiler;
 	size_t       m_top;
+	AABB         m_volume;     // voxelized volume
+	uint32       m_hashValue;
 
 	typedef std::vector<Tile::Triangle> Triangles;
 	Triangles m_triangles;
@@ -0,0 +1,381 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "TileGraph.h"
+#include "MeshGrid.h"
+#include "Tile.h"
+
+namespace MNM
+{
+void TileGraph::Clear()
+{
+	stl::free_container(m_tileNodes);
+}
+
+void TileGraph::Swap(TileGraph& other)
+{
+	m_tileNodes.swap(other.m_tileNodes);
+}
+
+void TileGraph::OnTileSet(const MeshGrid& grid, const TileID tileID)
+{
+	ComputeRegions(grid, tileID);
+	OnTileConnected(grid, tileID);
+}
+
+void TileGraph::OnTileConnected(const MeshGrid& grid, const TileID tileID)
+{
+	ComputeEdges(grid, tileID);
+
+	const vector3_t coords = grid.GetTileContainerCoordinates(tileID);
+	ComputeNeighbourEdges(grid, coords.x.as_int(), coords.y.as_int(), coords.z.as_int());
+}
+
+void TileGraph::OnTileCleared(const MeshGrid& grid, const TileID tileID, size_t x, size_t y, size_t z)
+{
+	if (tileID <= m_tileNodes.size())
+	{
+		TileNode& node = m_tileNodes[tileID - 1];
+		stl::free_container(node.triangleRegions);
+		stl::free_container(node.regions);
+	}
+
+	ComputeNeighbourEdges(grid, x, y, z);
+}
+
+const TileGraph::TileNode* TileGraph::GetTileNode(const TileID tileID) const
+{
+	if (tileID && tileID <= m_tileNodes.size())
+		return &m_tileNodes[tileID - 1];
+	return NULL;
+}
+
+bool TileGraph::GetTriangleRegion(const TriangleID triangleID, uint16& region) const
+{
+	if (const TileNode* pNode = GetTileNode(ComputeTileID(triangleID)))
+	{
+		const uint16 triangleIdx = ComputeTriangleIndex(triangleID);
+		if (triangleIdx < pNode->triangleRegions.size())
+		{
+			region = pNode->triangleRegions[triangleIdx];
+			return true;
+		}
+	}
+	return false;
+}
+
+const TileGraph::Region* TileGraph::GetRegion(const uint64 key) const
+{
+	if (const TileNode* pNode = GetTileNode(GetNodeTileID(key)))
+	{
+		const uint16 region = GetNodeRegion(key);
+		if (region < pNode->regions.size())
+			return &pNode->regions[region];
+	}
+	return NULL;
+}
+
+void TileGraph::ComputeRegions(const MeshGrid& grid, const TileID tileID)
+{
+	if (m_tileNodes.size() < tileID)
+		m_tileNodes.resize(tileID);
+
+	TileNode& node = m_tileNodes[tileID - 1];
+	const Tile& tile = grid.GetTile(tileID);
+
+	const uint16 unassigned = 0xffff;
+	node.triangleRegions.assign(tile.triangleCount, unassigned);
+	node.regions.clear();
+
+	std::vector<uint16> stack;
+	stack.reserve(tile.triangleCount);
+
+	for (uint16 seed = 0; seed < tile.triangleCount; ++seed)
+	{
+		if (node.triangleRegions[seed] != unassigned)
+			continue;
+
+		const uint16 regionIdx = (uint16)node.regions.size();
+		node.regions.resize(regionIdx + 1);
+
+		Vec3 centerSum(ZERO);
+		size_t regionTriangleCount = 0;
+
+		node.triangleRegions[seed] = regionIdx;
+		stack.push_back(seed);
+
+		while (!stack.empty())
+		{
+			const uint16 triangleIdx = stack.back();
+			stack.pop_back();
+
+			vector3_t v0, v1, v2;
+			grid.GetVertices(ComputeTriangleID(tileID, triangleIdx), v0, v1, v2);
+			centerSum += (v0.GetVec3() + v1.GetVec3() + v2.GetVec3()) * (1.0f / 3.0f);
+			++regionTriangleCount;
+
+			const Tile::Triangle& triangle = tile.triangles[triangleIdx];
+			for (size_t l = 0; l < triangle.linkCount; ++l)
+			{
+				const Tile::Link& link = tile.links[triangle.firstLink + l];
+				if (link.side == Tile::Link::Internal && node.triangleRegions[link.triangle] == unassigned)
+				{
+					node.triangleRegions[link.triangle] = regionIdx;
+					stack.push_back(link.triangle);
+				}
+			}
+		}
+
+		node.regions[regionIdx].center = centerSum / (float)regionTriangleCount;
+	}
+}
+
+void TileGraph::ComputeEdges(const MeshGrid& grid, const TileID tileID)
+{
+	if (tileID > m_tileNodes.size())
+		return;
+
+	TileNode& node = m_tileNodes[tileID - 1];
+	const Tile& tile = grid.GetTile(tileID);
+	if (node.triangleRegions.size() != tile.triangleCount)
+		return;
+
+	for (size_t r = 0; r < node.regions.size(); ++r)
+		node.regions[r].edges.clear();
+
+	const vector3_t coords = grid.GetTileContainerCoordinates(tileID);
+	const size_t x = coords.x.as_int();
+	const size_t y = coords.y.as_int();
+	const size_t z = coords.z.as_int();
+
+	for (uint16 triangleIdx = 0; triangleIdx < tile.triangleCount; ++triangleIdx)
+	{
+		const Tile::Triangle& triangle = tile.triangles[triangleIdx];
+		Region& region = node.regions[node.triangleRegions[triangleIdx]];
+
+		for (size_t l = 0; l < triangle.linkCount; ++l)
+		{
+			const Tile::Link& link = tile.links[triangle.firstLink + l];
+			if (link.side >= MeshGrid::SideCount)
+				continue;
+
+			const TileID neighbourTileID = grid.GetNeighbourTileID(x, y, z, link.side);
+			uint16 neighbourRegion;
+			if (neighbourTileID && GetTriangleRegion(ComputeTriangleID(neighbourTileID, link.triangle), neighbourRegion))
+			{
+				const Edge edge(neighbourTileID, neighbourRegion);
+				stl::push_back_unique(region.edges, edge);
+			}
+		}
+	}
+}
+
+void TileGraph::ComputeNeighbourEdges(const MeshGrid& grid, size_t x, size_t y, size_t z)
+{
+	for (size_t side = 0; side < MeshGrid::SideCount; ++side)
+	{
+		if (const TileID neighbourTileID = grid.GetNeighbourTileID(x, y, z, side))
+			ComputeEdges(grid, neighbourTileID);
+	}
+}
+
+void TileGraph::CorridorSearch::Reset()
+{
+	for (size_t i = 0; i < m_touchedTiles.size(); ++i)
+		m_visitedTiles[m_touchedTiles[i] - 1] = VisitedTile();
+
+	m_touchedTiles.clear();
+	m_visitedNodes.clear();
+	m_openList.clear();
+	m_ring.clear();
+	m_running = false;
+}
+
+size_t TileGraph::CorridorSearch::GetMemoryUsage() const
+{
+	return m_openList.capacity() * sizeof(OpenElement)
+	       + m_visitedTiles.capacity() * sizeof(VisitedTile)
+	       + m_visitedNodes.capacity() * sizeof(VisitedNode)
+	       + m_touchedTiles.capacity() * sizeof(TileID)
+	       + m_ring.capacity() * sizeof(TileID);
+}
+
+TileGraph::CorridorSearch::VisitedNode* TileGraph::CorridorSearch::GetVisitedNode(const TileGraph& graph, const uint64 key)
+{
+	const TileID tileID = GetNodeTileID(key);
+	const TileNode* pNode = graph.GetTileNode(tileID);
+	if (!pNode)
+		return NULL;
+
+	if (m_visitedTiles.size() < tileID)
+		m_visitedTiles.resize(tileID);
+
+	VisitedTile& tile = m_visitedTiles[tileID - 1];
+	if (!tile.nodeCount)
+	{
+		if (pNode->regions.empty())
+			return NULL;
+
+		const VisitedNode unvisitedNode = { FLT_MAX, 0, false };
+		tile.firstNode = (uint32)m_visitedNodes.size();
+		tile.nodeCount = (uint16)pNode->regions.size();
+		m_visitedNodes.resize(m_visitedNodes.size() + tile.nodeCount, unvisitedNode);
+		m_touchedTiles.push_back(tileID);
+	}
+
+	// the regions of a tile can change while the search is spread over several frames
+	const uint16 region = GetNodeRegion(key);
+	return (region < tile.nodeCount) ? &m_visitedNodes[tile.firstNode + region] : NULL;
+}
+
+bool TileGraph::StartCorridorSearch(const MeshGrid& grid, const TriangleID fromTriangleID, const TriangleID toTriangleID, const vector3_t& toLocation,
+                                    CorridorSearch& search) const
+{
+	search.Reset();
+
+	uint16 fromRegion, toRegion;
+	if (!GetTriangleRegion(fromTriangleID, fromRegion) || !GetTriangleRegion(toTriangleID, toRegion))
+		return false;
+
+	search.m_fromKey = MakeNodeKey(ComputeTileID(fromTriangleID), fromRegion);
+	search.m_toKey = MakeNodeKey(ComputeTileID(toTriangleID), toRegion);
+	search.m_goal = (toLocation - vector3_t(grid.GetParams().origin)).GetVec3();
+
+	CorridorSearch::VisitedNode* pStartNode = search.GetVisitedNode(*this, search.m_fromKey);
+	if (!pStartNode)
+		return false;
+
+	pStartNode->cost = 0.0f;
+	pStartNode->parentKey = search.m_fromKey;
+	search.m_openList.push_back(CorridorSearch::OpenElement(0.0f, search.m_fromKey));
+	search.m_running = true;
+
+	return true;
+}
+
+TileGraph::ECorridorSearchResult TileGraph::ContinueCorridorSearch(const MeshGrid& grid, const size_t corridorWidth, CorridorSearch& search,
+                                                                   AStarContention& contention, TileCorridor& corridor, size_t& corridorTriangleCount) const
+{
+	corridor.clear();
+	corridorTriangleCount = 0;
+
+	if (!search.m_running)
+		return eCSR_NotFound;
+
+	std::vector<CorridorSearch::OpenElement>& openList = search.m_openList;
+
+	bool found = false;
+	while (!found && !openList.empty() && contention.CanDoExternalStep())
+	{
+		contention.StartExternalStep();
+
+		std::pop_heap(openList.begin(), openList.end());
+		const uint64 key = openList.back().key;
+		openList.pop_back();
+
+		CorridorSearch::VisitedNode* pCurrent = search.GetVisitedNode(*this, key);
+		const Region* pRegion = GetRegion(key);
+		if (pCurrent && pRegion && !pCurrent->closed)
+		{
+			pCurrent->closed = true;
+			found = (key == search.m_toKey);
+
+			const float currentCost = pCurrent->cost;
+			for (size_t e = 0; !found && e < pRegion->edges.size(); ++e)
+			{
+				const Edge& edge = pRegion->edges[e];
+				const uint64 nextKey = MakeNodeKey(edge.toTileID, edge.toRegion);
+				const Region* pNextRegion = GetRegion(nextKey);
+				CorridorSearch::VisitedNode* pNext = pNextRegion ? search.GetVisitedNode(*this, nextKey) : NULL;
+				if (!pNext)
+					continue;
+
+				const float cost = currentCost + pRegion->center.GetDistance(pNextRegion->center);
+				if (pNext->closed || pNext->cost <= cost)
+					continue;
+
+				pNext->cost = cost;
+				pNext->parentKey = key;
+
+				openList.push_back(CorridorSearch::OpenElement(cost + pNextRegion->center.GetDistance(search.m_goal), nextKey));
+				std::push_heap(openList.begin(), openList.end());
+			}
+		}
+
+		contention.ExternalStepDone();
+	}
+
+	if (!found && !openList.empty())
+		return eCSR_Continuing;
+
+	search.m_running = false;
+
+	if (!found)
+		return eCSR_NotFound;
+
+	// the parent of a node is always closed before it, so the chain ends at the start node
+	for (uint64 key = search.m_toKey; ; )
+	{
+		corridor.push_back(GetNodeTileID(key));
+		if (key == search.m_fromKey)
+			break;
+
+		const CorridorSearch::VisitedNode* pNode = search.GetVisitedNode(*this, key);
+		if (!pNode || pNode->parentKey == key)
+		{
+			corridor.clear();
+			return eCSR_NotFound;
+		}
+		key = pNode->parentKey;
+	}
+
+	std::sort(corridor.begin(), corridor.end());
+	corridor.erase(std::unique(corridor.begin(), corridor.end()), corridor.end());
+
+	// widen the corridor so the refinement has room to cut corners between the regions
+	TileCorridor& ring = search.m_ring;
+	for (size_t w = 0; w < corridorWidth; ++w)
+	{
+		ring.clear();
+		for (size_t i = 0; i < corridor.size(); ++i)
+		{
+			const vector3_t coords = grid.GetTileContainerCoordinates(corridor[i]);
+			for (size_t side = 0; side < MeshGrid::SideCount; ++side)
+			{
+				if (const TileID neighbourTileID = grid.GetNeighbourTileID(coords.x.as_int(), coords.y.as_int(), coords.z.as_int(), side))
+					ring.push_back(neighbourTileID);
+			}
+		}
+		corridor.insert(corridor.end(), ring.begin(), ring.end());
+		std::sort(corridor.begin(), corridor.end());
+		corridor.erase(std::unique(corridor.begin(), corridor.end()), corridor.end());
+	}
+
+	for (size_t i = 0; i < corridor.size(); ++i)
+		corridorTriangleCount += grid.GetTile(corridor[i]).triangleCount;
+
+	return eCSR_Found;
+}
+
+size_t TileGraph::GetRegionCount() const
+{
+	size_t count = 0;
+	for (size_t i = 0; i < m_tileNodes.size(); ++i)
+		count += m_tileNodes[i].regions.size();
+	return count;
+}
+
+size_t TileGraph::GetMemoryUsage() const
+{
+	size_t memoryUsage = m_tileNodes.capacity() * sizeof(TileNode);
+	for (size_t i = 0; i < m_tileNodes.size(); ++i)
+	{
+		const TileNode& node = m_tileNodes[i];
+		memoryUsage += node.triangleRegions.capacity() * sizeof(uint16);
+		memoryUsage += node.regions.capacity() * sizeof(Region);
+		for (size_t r = 0; r < node.regions.size(); ++r)
+			memoryUsage += node.regions[r].edges.capacity() * sizeof(Edge);
+	}
+	return memoryUsage;
+}
+}
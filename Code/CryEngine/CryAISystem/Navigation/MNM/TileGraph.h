@@ -0,0 +1,162 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#ifndef __MNM_TILE_GRAPH_H
+#define __MNM_TILE_GRAPH_H
+
+#pragma once
+
+#include "MNM.h"
+
+namespace MNM
+{
+struct MeshGrid;
+
+///////////////////////////////////////////////////////////////////////
+
+// Abstraction of a MeshGrid used to speed up long way queries.
+// Every tile is split into regions, the sets of its triangles which are connected through internal links.
+// Regions are the nodes of the graph, two regions are connected when a triangle link crosses the tile
+// border between them. Off-mesh links are not part of the graph.
+// The MeshGrid keeps the graph up to date whenever a tile is set, connected to the network or cleared,
+// only the changed tile and its direct neighbours are recomputed.
+class TileGraph
+{
+public:
+	typedef std::vector<TileID> TileCorridor;   // sorted
+
+	// State of a corridor search. It's kept by the caller, so a search can be spread over several frames
+	// and its storage is reused by the following searches.
+	class CorridorSearch
+	{
+	public:
+		CorridorSearch()
+			: m_fromKey(0)
+			, m_toKey(0)
+			, m_goal(ZERO)
+			, m_running(false)
+		{}
+
+		void   Reset();   // keeps the storage
+		bool   IsRunning() const { return m_running; }
+		size_t GetMemoryUsage() const;
+
+	private:
+		friend class TileGraph;
+
+		struct OpenElement
+		{
+			OpenElement(float _estimatedCost, uint64 _key)
+				: estimatedCost(_estimatedCost)
+				, key(_key)
+			{}
+
+			bool operator<(const OpenElement& other) const { return estimatedCost > other.estimatedCost; }
+
+			float  estimatedCost;
+			uint64 key;
+		};
+
+		struct VisitedNode
+		{
+			float  cost;
+			uint64 parentKey;
+			bool   closed;
+		};
+
+		struct VisitedTile
+		{
+			VisitedTile()
+				: firstNode(0)
+				, nodeCount(0)
+			{}
+
+			uint32 firstNode;
+			uint16 nodeCount;
+		};
+
+		// The pointer is valid until the next call, nodes of a tile are added on its first visit.
+		VisitedNode* GetVisitedNode(const TileGraph& graph, const uint64 key);
+
+		std::vector<OpenElement> m_openList;
+		std::vector<VisitedTile> m_visitedTiles;   // indexed by TileID - 1
+		std::vector<VisitedNode> m_visitedNodes;   // one per region of the visited tiles
+		std::vector<TileID>      m_touchedTiles;
+		TileCorridor             m_ring;
+
+		uint64                   m_fromKey;
+		uint64                   m_toKey;
+		Vec3                     m_goal;
+		bool                     m_running;
+	};
+
+	enum ECorridorSearchResult
+	{
+		eCSR_Continuing = 0,
+		eCSR_Found,
+		eCSR_NotFound,
+	};
+
+	void   Clear();
+	void   Swap(TileGraph& other);
+
+	void   OnTileSet(const MeshGrid& grid, const TileID tileID);
+	void   OnTileConnected(const MeshGrid& grid, const TileID tileID);
+	void   OnTileCleared(const MeshGrid& grid, const TileID tileID, size_t x, size_t y, size_t z);
+
+	// Rebuilding the whole graph computes the regions of all tiles first, then their edges.
+	void   ComputeRegions(const MeshGrid& grid, const TileID tileID);
+	void   ComputeEdges(const MeshGrid& grid, const TileID tileID);
+
+	// Runs A* over the regions, from the region of fromTriangleID to the region of toTriangleID.
+	// StartCorridorSearch fails when either triangle isn't part of the graph. ContinueCorridorSearch expands regions
+	// until the frame quota of contention is reached. Once found, corridor holds the tiles along the way, widened by
+	// corridorWidth rings of neighbour tiles, and corridorTriangleCount the number of triangles in those tiles.
+	bool                  StartCorridorSearch(const MeshGrid& grid, const TriangleID fromTriangleID, const TriangleID toTriangleID,
+	                                          const vector3_t& toLocation, CorridorSearch& search) const;
+	ECorridorSearchResult ContinueCorridorSearch(const MeshGrid& grid, const size_t corridorWidth, CorridorSearch& search, AStarContention& contention,
+	                                             TileCorridor& corridor, size_t& corridorTriangleCount) const;
+
+	size_t GetRegionCount() const;
+	size_t GetMemoryUsage() const;
+
+private:
+	struct Edge
+	{
+		Edge(const TileID _toTileID, const uint16 _toRegion)
+			: toTileID(_toTileID)
+			, toRegion(_toRegion)
+		{}
+
+		bool operator==(const Edge& other) const { return toTileID == other.toTileID && toRegion == other.toRegion; }
+
+		TileID toTileID;
+		uint16 toRegion;
+	};
+
+	struct Region
+	{
+		Vec3              center;   // average of the triangle centers, relative to the mesh origin
+		std::vector<Edge> edges;
+	};
+
+	struct TileNode
+	{
+		std::vector<uint16> triangleRegions;    // region of every triangle of the tile
+		std::vector<Region> regions;
+	};
+
+	static inline uint64 MakeNodeKey(const TileID tileID, const uint16 region) { return ((uint64)tileID << 16) | region; }
+	static inline TileID GetNodeTileID(const uint64 key)                       { return (TileID)(key >> 16); }
+	static inline uint16 GetNodeRegion(const uint64 key)                       { return (uint16)(key & 0xffff); }
+
+	const TileNode* GetTileNode(const TileID tileID) const;
+	bool            GetTriangleRegion(const TriangleID triangleID, uint16& region) const;
+	const Region*   GetRegion(const uint64 key) const;
+
+	void            ComputeNeighbourEdges(const MeshGrid& grid, size_t x, size_t y, size_t z);
+
+	std::vector<TileNode> m_tileNodes;   // indexed by TileID - 1
+};
+}
+
+#endif  // #ifndef __MNM_TILE_GRAPH_H
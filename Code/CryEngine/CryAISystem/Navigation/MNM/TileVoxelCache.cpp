@@ -0,0 +1,148 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "TileVoxelCache.h"
+
+namespace MNM
+{
+TileVoxelCache::TileVoxelCache()
+	: m_capacity(0)
+	, m_epoch(0)
+	, m_useCounter(0)
+	, m_hitCount(0)
+	, m_missCount(0)
+{
+}
+
+size_t TileVoxelCache::KeyHash::operator()(const Key& key) const
+{
+	const float values[] = {
+		key.volume.min.x, key.volume.min.y, key.volume.min.z, key.volume.max.x, key.volume.max.y, key.volume.max.z,
+		key.voxelSize.x,  key.voxelSize.y,  key.voxelSize.z
+	};
+
+	uint32 hash = key.hashSeed;
+	for (size_t i = 0; i < CRY_ARRAY_COUNT(values); ++i)
+	{
+		uint32 bits;
+		memcpy(&bits, &values[i], sizeof(bits));
+		hash = (hash ^ bits) * 0x01000193;
+	}
+	return hash;
+}
+
+void TileVoxelCache::Setup(const AgentSize& maxAgentSize, size_t capacity)
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	if ((maxAgentSize.radius != m_maxAgentSize.radius) || (maxAgentSize.height != m_maxAgentSize.height))
+	{
+		m_maxAgentSize = maxAgentSize;
+		m_entries.clear();
+		++m_epoch;
+	}
+
+	m_capacity = capacity;
+	while (m_entries.size() > m_capacity)
+		EvictLeastRecentlyUsed();
+}
+
+TileVoxelCache::AgentSize TileVoxelCache::GetMaxAgentSize() const
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+	return m_maxAgentSize;
+}
+
+uint32 TileVoxelCache::GetEpoch() const
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+	return m_epoch;
+}
+
+TileVoxelCache::VoxelsPtr TileVoxelCache::Find(const Key& key)
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	Entries::iterator it = m_entries.find(key);
+	if (it != m_entries.end())
+	{
+		it->second.lastUse = ++m_useCounter;
+		++m_hitCount;
+		return it->second.voxels;
+	}
+
+	++m_missCount;
+	return VoxelsPtr();
+}
+
+void TileVoxelCache::Insert(const Key& key, uint32 epoch, const VoxelsPtr& voxels)
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	if ((epoch != m_epoch) || !m_capacity)
+		return;
+
+	if ((m_entries.size() >= m_capacity) && (m_entries.find(key) == m_entries.end()))
+		EvictLeastRecentlyUsed();
+
+	Entry& entry = m_entries[key];
+	entry.voxels = voxels;
+	entry.lastUse = ++m_useCounter;
+}
+
+void TileVoxelCache::EvictLeastRecentlyUsed()
+{
+	// only when a tile is inserted into a full cache, which holds about as many entries as tiles are generated at once
+	Entries::iterator oldest = m_entries.begin();
+	for (Entries::iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it)
+	{
+		if (it->second.lastUse < oldest->second.lastUse)
+			oldest = it;
+	}
+	if (oldest != m_entries.end())
+		m_entries.erase(oldest);
+}
+
+void TileVoxelCache::Invalidate(const AABB& aabb)
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	++m_epoch;
+
+	for (Entries::iterator it = m_entries.begin(); it != m_entries.end(); )
+	{
+		if (Overlap::AABB_AABB(it->first.volume, aabb))
+			it = m_entries.erase(it);
+		else
+			++it;
+	}
+}
+
+void TileVoxelCache::Clear()
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	++m_epoch;
+	stl::free_container(m_entries);
+}
+
+void TileVoxelCache::GetStats(Stats& stats) const
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	stats.entryCount = m_entries.size();
+	stats.memoryUsage = m_entries.bucket_count() * sizeof(void*) + m_entries.size() * (sizeof(Entries::value_type) + sizeof(void*));
+	for (Entries::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it)
+		stats.memoryUsage += it->second.voxels->spanGrid.GetMemoryUsage();
+	stats.hitCount = m_hitCount;
+	stats.missCount = m_missCount;
+}
+
+void TileVoxelCache::ResetStats()
+{
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+}
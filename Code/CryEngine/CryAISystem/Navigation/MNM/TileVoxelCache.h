@@ -0,0 +1,123 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#ifndef __MNM_TILE_VOXEL_CACHE_H
+#define __MNM_TILE_VOXEL_CACHE_H
+
+#pragma once
+
+#include "CompactSpanGrid.h"
+#include <CryAISystem/INavigationSystem.h>
+
+namespace MNM
+{
+// Keeps the voxelized world geometry of recently generated tiles.
+// Every navigation mesh (one per agent type) generates its own copy of a tile, and all of them used to voxelize
+// the same geometry again. Tiles are now voxelized once with the border and height of the largest agent type,
+// the TileGenerator of each mesh crops the span columns it needs out of the cached grid. The navigation system
+// groups its tile queue by volume, so the meshes ask for the same tile one after the other.
+// Tiles which didn't change since they were generated fail the hash test before they're voxelized and aren't cached.
+// The hash covers the geometry of the enlarged volume, so it differs from the hash of a tile generated without the
+// cache: every tile of a mesh saved or generated without it is regenerated once.
+// Entries are dropped when the world changes inside their volume and, least recently used first, when the cache is full.
+// The cache is used from the generation jobs, all accesses are locked.
+class TileVoxelCache
+{
+public:
+	struct Key
+	{
+		bool operator==(const Key& other) const
+		{
+			return volume.min == other.volume.min && volume.max == other.volume.max && voxelSize == other.voxelSize &&
+			       hashSeed == other.hashSeed && callback == other.callback;
+		}
+
+		AABB                         volume;
+		Vec3                         voxelSize;
+		uint32                       hashSeed;
+		NavigationMeshEntityCallback callback;
+	};
+
+	// the callback isn't hashed, keys differing only in it are rare
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	struct Voxels
+	{
+		Voxels()
+			: hashValue(0)
+			, triCount(0)
+		{
+		}
+
+		CompactSpanGrid spanGrid;
+		uint32          hashValue;
+		size_t          triCount;
+	};
+
+	typedef std::shared_ptr<const Voxels> VoxelsPtr;
+
+	struct AgentSize
+	{
+		AgentSize()
+			: radius(0)
+			, height(0)
+		{
+		}
+
+		size_t radius;   // in voxels
+		size_t height;   // in voxels
+	};
+
+	struct Stats
+	{
+		size_t entryCount;
+		size_t memoryUsage;
+		size_t hitCount;
+		size_t missCount;
+	};
+
+	TileVoxelCache();
+
+	// Sets the size of the largest agent type and the maximum number of entries.
+	// The cache is cleared when the agent size changes, as the volumes of all entries would change with it.
+	void      Setup(const AgentSize& maxAgentSize, size_t capacity);
+	AgentSize GetMaxAgentSize() const;
+
+	// The epoch is advanced by every invalidation. Voxels are only inserted if no invalidation happened since the
+	// epoch was read before voxelizing, so geometry which changed during the voxelization isn't cached.
+	uint32    GetEpoch() const;
+	VoxelsPtr Find(const Key& key);
+	void      Insert(const Key& key, uint32 epoch, const VoxelsPtr& voxels);
+
+	void      Invalidate(const AABB& aabb);
+	void      Clear();
+
+	void      GetStats(Stats& stats) const;
+	void      ResetStats();
+
+private:
+	struct Entry
+	{
+		VoxelsPtr voxels;
+		uint32    lastUse;
+	};
+
+	typedef std::unordered_map<Key, Entry, KeyHash> Entries;
+
+	void EvictLeastRecentlyUsed();
+
+	Entries                                m_entries;
+	size_t                                 m_capacity;
+	AgentSize                              m_maxAgentSize;
+	uint32                                 m_epoch;
+	uint32                                 m_useCounter;
+	size_t                                 m_hitCount;
+	size_t                                 m_missCount;
+
+	mutable CryCriticalSectionNonRecursive m_lock;
+};
+}
+
+#endif  // #ifndef __MNM_TILE_VOXEL_CACHE_H
@@ -68,6 +68,57 @@ void GenerateTileJob(MNM::TileGenerator::Params params, volatile uint16* state,
 }
 
 DECLARE_JOB("NavigationGeneration", NavigationGenerationJob, GenerateTileJob);
+
+enum ETileGenerationStage
+{
+	eTileGenerationStage_Voxelization = 0,
+	eTileGenerationStage_Triangulation,
+	eTileGenerationStage_Tile,
+	eTileGenerationStage_Count,
+};
+
+// Runs one stage of a tile generation and queues the next one as a new job on the same job state.
+// Waiting for the job state of the result waits for all the stages.
+// The stages of a tile run one after another, the tiles in flight just get interleaved with each other.
+void GenerateTileStageJob(NavigationSystem::TileTaskResult* pResult, const MNM::TileGenerator::Params& params, int stage)
+{
+	// cancelled by DestroyMesh or StopAllTasks, the remaining stages are dropped
+	if (pResult->state == NavigationSystem::TileTaskResult::Failed)
+		return;
+
+	MNM::TileGenerator& generator = *pResult->pGenerator;
+
+	bool result = false;
+	switch (stage)
+	{
+	case eTileGenerationStage_Voxelization:
+		result = generator.GenerateVoxels(params, &pResult->hashValue);
+		break;
+	case eTileGenerationStage_Triangulation:
+		result = generator.GenerateTriangles();
+		break;
+	case eTileGenerationStage_Tile:
+		result = generator.GenerateTile(pResult->tile);
+		break;
+	}
+
+	if (!result)
+	{
+		if (((params.flags & MNM::TileGenerator::Params::NoHashTest) == 0) && (pResult->hashValue == params.hashValue))
+			pResult->state = NavigationSystem::TileTaskResult::NoChanges;
+		else
+			pResult->state = NavigationSystem::TileTaskResult::Failed;
+	}
+	else if (stage + 1 < eTileGenerationStage_Count)
+	{
+		gEnv->GetJobManager()->AddLambdaJob("NavigationGenerationStage", [pResult, params, stage]() { GenerateTileStageJob(pResult, params, stage + 1); },
+		                                    JobManager::eStreamPriority, &pResult->jobState);
+	}
+	else
+	{
+		pResult->state = NavigationSystem::TileTaskResult::Completed;
+	}
+}
 #endif
 
 uint32 NameHash(const char* name)
@@ -128,8 +179,11 @@ bool ShouldBeConsideredByVoxelizer(IPhysicalEntity& physicalEntity, uint32& flag
 
 NavigationSystem::NavigationSystem(const char* configName)
 	: m_configName(configName)
+	, m_tileQueueGrouped(true)
 	, m_throughput(0.0f)
 	, m_cacheHitRate(0.0f)
+	, m_generatedTileCount(0)
+	, m_generationThroughput(0.0f)
 	, m_free(0)
 	, m_state(Idle)
 	, m_meshes(256)                 //Same size of meshes, off-mesh and islandConnections elements
@@ -898,6 +952,7 @@ void NavigationSystem::UpdateMeshes(const float frameTime, const bool blocking,
 			// We just finished the processing of the tiles, so before being in Idle
 			// we need to recompute the Islands detection
 			ComputeIslands();
+			LogTileGenerationThroughput();
 		}
 		m_state = Idle;
 		return;
@@ -935,7 +990,10 @@ void NavigationSystem::UpdateMeshes(const float frameTime, const bool blocking,
 					gEnv->GetJobManager()->WaitForJob(result.jobState);
 				}
 
+				SAFE_DELETE(result.pGenerator);
+
 				++completed;
+				++m_generatedTileCount;
 				cacheHit += result.state == TileTaskResult::NoChanges;
 
 				MNM::Tile().Swap(result.tile);
@@ -963,6 +1021,9 @@ void NavigationSystem::UpdateMeshes(const float frameTime, const bool blocking,
 		m_throughput = completed / frameTime;
 		m_cacheHitRate = cacheHit / frameTime;
 
+		const float generationTime = (gEnv->pTimer->GetAsyncTime() - m_generationStartTime).GetSeconds();
+		m_generationThroughput = (generationTime > 0.0f) ? m_generatedTileCount / generationTime : 0.0f;
+
 		if (m_tileQueue.empty() && m_runningTasks.empty())
 		{
 			if (m_state != Idle)
@@ -970,6 +1031,7 @@ void NavigationSystem::UpdateMeshes(const float frameTime, const bool blocking,
 				// We just finished the processing of the tiles, so before being in Idle
 				// we need to recompute the Islands detection
 				ComputeIslands();
+				LogTileGenerationThroughput();
 			}
 
 			m_state = Idle;
@@ -979,9 +1041,21 @@ void NavigationSystem::UpdateMeshes(const float frameTime, const bool blocking,
 
 		if (!m_tileQueue.empty())
 		{
+			if (m_state == Idle)
+			{
+				m_generationStartTime = gEnv->pTimer->GetAsyncTime();
+				m_generatedTileCount = 0;
+				m_voxelCache.ResetStats();
+			}
+
 			m_state = Working;
 
 			FRAME_PROFILER("Navigation System::UpdateMeshes() - Job Spawning", gEnv->pSystem, PROFILE_AI);
+
+			SetupVoxelCache();
+			if (!m_tileQueueGrouped)
+				GroupQueuedTilesByVolume();
+
 			const size_t idealMinimumTaskCount = 2;
 			const size_t MaxRunningTaskCount = multiThreaded ? m_maxRunningTaskCount : std::min(m_maxRunningTaskCount, idealMinimumTaskCount);
 
@@ -1084,6 +1158,109 @@ void NavigationSystem::SetupGenerator(NavigationMeshID meshID, const MNM::MeshGr
 		params.hashValue = mesh.grid.GetTile(tileID).hashValue;
 	else
 		params.flags |= MNM::TileGenerator::Params::NoHashTest;
+
+	if (gAIEnv.CVars.NavGenVoxelCacheSize > 0)
+		params.voxelCache = &m_voxelCache;
+}
+
+void NavigationSystem::SetupVoxelCache()
+{
+	MNM::TileVoxelCache::AgentSize maxAgentSize;
+
+	for (AgentTypes::const_iterator it = m_agentTypes.begin(), end = m_agentTypes.end(); it != end; ++it)
+	{
+		maxAgentSize.radius = std::max<size_t>(maxAgentSize.radius, it->settings.radiusVoxelCount);
+		maxAgentSize.height = std::max<size_t>(maxAgentSize.height, it->settings.heightVoxelCount);
+	}
+
+	m_voxelCache.Setup(maxAgentSize, (size_t)std::max(gAIEnv.CVars.NavGenVoxelCacheSize, 0));
+}
+
+void NavigationSystem::GroupQueuedTilesByVolume()
+{
+	// The meshes of the agent types queue their tiles one mesh after the other. The voxel cache would have to keep all
+	// tiles of a mesh until the next mesh gets to them, so the tasks of the same tile volume are moved right behind the
+	// first one of them. The volumes keep the order of their first task.
+	m_tileQueueGrouped = true;
+	if (!gAIEnv.CVars.NavGenVoxelCacheSize || (m_tileQueue.size() < 2))
+		return;
+
+	FUNCTION_PROFILER(gEnv->pSystem, PROFILE_AI);
+
+	struct TaskVolume
+	{
+		Vec3   origin;
+		Vec3   voxelSize;
+		size_t index;
+		size_t group;   // index of the first task of the same volume
+
+		bool   SameVolume(const TaskVolume& other) const
+		{
+			return (origin == other.origin) && (voxelSize == other.voxelSize);
+		}
+
+		bool   operator<(const TaskVolume& other) const
+		{
+			if (origin.x != other.origin.x)
+				return origin.x < other.origin.x;
+			if (origin.y != other.origin.y)
+				return origin.y < other.origin.y;
+			if (origin.z != other.origin.z)
+				return origin.z < other.origin.z;
+			if (voxelSize.x != other.voxelSize.x)
+				return voxelSize.x < other.voxelSize.x;
+			if (voxelSize.y != other.voxelSize.y)
+				return voxelSize.y < other.voxelSize.y;
+			if (voxelSize.z != other.voxelSize.z)
+				return voxelSize.z < other.voxelSize.z;
+			return index < other.index;
+		}
+	};
+
+	const size_t taskCount = m_tileQueue.size();
+	std::vector<TaskVolume> volumes(taskCount);
+	for (size_t i = 0; i < taskCount; ++i)
+	{
+		const TileTask& task = m_tileQueue[i];
+		TaskVolume& volume = volumes[i];
+		volume.index = i;
+		if (m_meshes.validate(task.meshID))
+		{
+			const MNM::MeshGrid::Params& paramsGrid = m_meshes[task.meshID].grid.GetParams();
+			volume.origin = paramsGrid.origin + Vec3i(task.x * paramsGrid.tileSize.x, task.y * paramsGrid.tileSize.y, task.z * paramsGrid.tileSize.z);
+			volume.voxelSize = paramsGrid.voxelSize;
+		}
+		else
+		{
+			volume.origin = Vec3((float)i, 0.0f, 0.0f);
+			volume.voxelSize = Vec3(-1.0f);
+		}
+	}
+
+	std::sort(volumes.begin(), volumes.end());
+	for (size_t i = 0; i < taskCount; ++i)
+		volumes[i].group = (i && volumes[i].SameVolume(volumes[i - 1])) ? volumes[i - 1].group : volumes[i].index;
+
+	std::sort(volumes.begin(), volumes.end(), [](const TaskVolume& lhs, const TaskVolume& rhs)
+	{
+		return (lhs.group != rhs.group) ? (lhs.group < rhs.group) : (lhs.index < rhs.index);
+	});
+
+	TileTaskQueue groupedQueue;
+	for (size_t i = 0; i < taskCount; ++i)
+		groupedQueue.push_back(m_tileQueue[volumes[i].index]);
+	m_tileQueue.swap(groupedQueue);
+}
+
+void NavigationSystem::LogTileGenerationThroughput()
+{
+	const float generationTime = (gEnv->pTimer->GetAsyncTime() - m_generationStartTime).GetSeconds();
+
+	MNM::TileVoxelCache::Stats stats;
+	m_voxelCache.GetStats(stats);
+
+	AILogComment("NavigationSystem: generated %" PRISIZE_T " tiles in %.2fs (%.1f tiles/s), voxel cache hits: %" PRISIZE_T " misses: %" PRISIZE_T,
+	             m_generatedTileCount, generationTime, m_generationThroughput, stats.hitCount, stats.missCount);
 }
 
 bool NavigationSystem::SpawnJob(TileTaskResult& result, NavigationMeshID meshID, const MNM::MeshGrid::Params& paramsGrid,
@@ -1160,7 +1337,16 @@ bool NavigationSystem::SpawnJob(TileTaskResult& result, NavigationMeshID meshID,
 	SetupGenerator(meshID, paramsGrid, x, y, z, params, &def->boundary,
 	               def->exclusions.empty() ? 0 : &def->exclusions[0], def->exclusions.size());
 
-	if (mt)
+	if (mt && gAIEnv.CVars.NavGenPipeline)
+	{
+		assert(!result.pGenerator);
+		result.pGenerator = new MNM::TileGenerator();
+
+		TileTaskResult* pResult = &result;
+		gEnv->GetJobManager()->AddLambdaJob("NavigationGenerationStage", [pResult, params]() { GenerateTileStageJob(pResult, params, eTileGenerationStage_Voxelization); },
+		                                    JobManager::eStreamPriority, &result.jobState);
+	}
+	else if (mt)
 	{
 		NavigationGenerationJob job(params, &result.state, &result.tile, &result.hashValue);
 		job.RegisterJobState(&result.jobState);
@@ -1328,6 +1514,7 @@ size_t NavigationSystem::QueueMeshUpdate(NavigationMeshID meshID, const AABB& aa
 					task.z = (uint16)z;
 
 					m_tileQueue.push_back(task);
+					m_tileQueueGrouped = false;
 
 					++affectedCount;
 				}
@@ -1433,6 +1620,7 @@ void NavigationSystem::QueueDifferenceUpdate(NavigationMeshID meshID, const Navi
 					task.z = (uint16)z;
 
 					m_tileQueue.push_back(task);
+					m_tileQueueGrouped = false;
 				}
 			}
 		}
@@ -1445,6 +1633,8 @@ void NavigationSystem::WorldChanged(const AABB& aabb)
 #if NAVIGATION_SYSTEM_PC_ONLY
 	if (!aabb.IsEmpty() && Overlap::AABB_AABB(m_worldAABB, aabb))
 	{
+		m_voxelCache.Invalidate(aabb);
+
 		AgentTypes::const_iterator it = m_agentTypes.begin();
 		AgentTypes::const_iterator end = m_agentTypes.end();
 
@@ -1477,7 +1667,10 @@ void NavigationSystem::StopAllTasks()
 		gEnv->pJobManager->WaitForJob(m_results[m_runningTasks[t]].jobState);
 
 	for (size_t t = 0; t < m_runningTasks.size(); ++t)
+	{
 		m_results[m_runningTasks[t]].tile.Destroy();
+		SAFE_DELETE(m_results[m_runningTasks[t]].pGenerator);
+	}
 
 	m_runningTasks.clear();
 }
@@ -1940,6 +2133,7 @@ void NavigationSystem::Clear()
 
 	m_offMeshNavigationManager.Clear();
 	m_islandConnectionsManager.Reset();
+	m_voxelCache.Clear();
 
 	ResetAllNavigationSystemUsers();
 }
@@ -4056,9 +4250,17 @@ void NavigationSystemDebugDraw::DebugDrawNavigationSystemState(NavigationSystem&
 		{
 		case NavigationSystem::Working:
 			dc->Draw2dLabel(10.0f, 300.0f, 1.6f, Col_Yellow, false, "Navigation System Working");
-			dc->Draw2dLabel(10.0f, 322.0f, 1.2f, Col_White, false, "Processing: %d\nRemaining: %d\nThroughput: %.2f/s\n"
-			                                                       "Cache Hits: %.2f/s",
-			                navigationSystem.m_runningTasks.size(), navigationSystem.m_tileQueue.size(), navigationSystem.m_throughput, navigationSystem.m_cacheHitRate);
+			{
+				MNM::TileVoxelCache::Stats voxelCacheStats;
+				navigationSystem.m_voxelCache.GetStats(voxelCacheStats);
+
+				dc->Draw2dLabel(10.0f, 322.0f, 1.2f, Col_White, false, "Processing: %d\nRemaining: %d\nThroughput: %.2f/s\n"
+				                                                       "Cache Hits: %.2f/s\nAverage Throughput: %.2f tiles/s\n"
+				                                                       "Voxel Cache: %d hits, %d misses, %d tiles (%.1f MB)",
+				                navigationSystem.m_runningTasks.size(), navigationSystem.m_tileQueue.size(), navigationSystem.m_throughput, navigationSystem.m_cacheHitRate,
+				                navigationSystem.m_generationThroughput, (int)voxelCacheStats.hitCount, (int)voxelCacheStats.missCount, (int)voxelCacheStats.entryCount,
+				                voxelCacheStats.memoryUsage / (1024.0f * 1024.0f));
+			}
 			break;
 		case NavigationSystem::Idle:
 			dc->Draw2dLabel(10.0f, 300.0f, 1.6f, Col_ForestGreen, false, "Navigation System Idle");
@@ -4280,6 +4482,7 @@ NavigationMesh::ProfileMemoryStats NavigationMesh::GetMemoryStats(ICrySizer* pSi
 	{
 		pSizer->AddObjectSize(this);
 		pSizer->AddObject(&grid, memoryStats.gridProfiler.GetMemoryUsage());
+		pSizer->AddObject(&grid.GetTileGraph(), grid.GetTileGraph().GetMemoryUsage());
 		pSizer->AddContainer(exclusions);
 		pSizer->AddString(name);
 
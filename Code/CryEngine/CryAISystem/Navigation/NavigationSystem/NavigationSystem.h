@@ -11,6 +11,7 @@
 #include "../MNM/Tile.h"
 #include "../MNM/MeshGrid.h"
 #include "../MNM/TileGenerator.h"
+#include "../MNM/TileVoxelCache.h"
 
 #include "WorldMonitor.h"
 #include "OffMeshNavigationManager.h"
@@ -610,6 +611,7 @@ public:
 		TileTaskResult()
 			: state(Running)
 			, hashValue(0)
+			, pGenerator(0)
 		{
 		};
 
@@ -634,6 +636,8 @@ public:
 
 		volatile uint16       state; // communicated over thread boundaries
 		uint16                next;  // next free
+
+		MNM::TileGenerator*   pGenerator; // kept between the stage jobs of a pipelined generation
 	};
 
 private:
@@ -647,6 +651,9 @@ private:
 	bool SpawnJob(TileTaskResult& result, NavigationMeshID meshID, const MNM::MeshGrid::Params& paramsGrid,
 	              uint16 x, uint16 y, uint16 z, bool mt);
 	void CommitTile(TileTaskResult& result);
+	void SetupVoxelCache();
+	void GroupQueuedTilesByVolume();
+	void LogTileGenerationThroughput();
 #endif
 
 	void ResetAllNavigationSystemUsers();
@@ -670,6 +677,7 @@ private:
 
 	typedef std::deque<TileTask> TileTaskQueue;
 	TileTaskQueue m_tileQueue;
+	bool          m_tileQueueGrouped; // the tasks of the same tile volume in different meshes follow each other
 
 	typedef std::vector<uint16> RunningTasks;
 	RunningTasks m_runningTasks;
@@ -677,6 +685,13 @@ private:
 	float        m_cacheHitRate;
 	float        m_throughput;
 
+	// tiles generated since the navigation system went from idle to working
+	CTimeValue          m_generationStartTime;
+	size_t              m_generatedTileCount;
+	float               m_generationThroughput;
+
+	MNM::TileVoxelCache m_voxelCache;
+
 	typedef stl::aligned_vector<TileTaskResult, alignof(TileTaskResult)> TileTaskResults;
 	TileTaskResults m_results;
 	uint16          m_free;
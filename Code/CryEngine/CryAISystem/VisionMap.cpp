@@ -14,22 +14,68 @@
 #include "VisionMap.h"
 
 #include "DebugDrawContext.h"
+#include "Factions/FactionMap.h"
 #include <CryAISystem/VisionMapTypes.h>
 
 namespace
 {
 static const float positionEpsilon = 0.05f;
 static const float orientationEpsilon = 0.05f;
+
+// size of the world cells which track physical changes for the cached visibility results
+static const float worldCellSize = 4.0f;
+static const int maxMarkedWorldCells = 4096;
+static const size_t maxWorldCellStamps = 16384;
+
+inline uint32 GetWorldCellKey(int x, int y)
+{
+	return ((uint32)(x & 0xffff) << 16) | (uint32)(y & 0xffff);
+}
+
+inline bool IsVisionBlockingSimClass(int simClass)
+{
+	return (simClass == SC_STATIC) || (simClass == SC_SLEEPING_RIGID) || (simClass == SC_ACTIVE_RIGID);
+}
 }
 
 CVisionMap::CVisionMap()
-	: m_visionIdCounter(0)
+	: m_worldStamp(0)
+	, m_worldClearStamp(0)
+	, m_visionIdCounter(0)
 {
 	Reset();
+
+	if (gEnv->pPhysicalWorld)
+	{
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysStateChange::id, OnPhysicsStateChange, 1);
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysEntityDeleted::id, OnPhysicsEntityDeleted, 1);
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysUpdateMesh::id, OnPhysicsGeometryChanged, 1);
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysCreateEntityPart::id, OnPhysicsGeometryChanged, 1);
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysRemoveEntityParts::id, OnPhysicsGeometryChanged, 1);
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysRevealEntityPart::id, OnPhysicsGeometryChanged, 1);
+	}
+
+	// the physics of an entity is created before the state change events are enabled on it, new static geometry
+	// is only seen through the entity event
+	if (gEnv->pEntitySystem)
+		gEnv->pEntitySystem->AddSink(this, IEntitySystem::OnEvent, BIT64(ENTITY_EVENT_ENABLE_PHYSICS));
 }
 
 CVisionMap::~CVisionMap()
 {
+	if (gEnv->pEntitySystem)
+		gEnv->pEntitySystem->RemoveSink(this);
+
+	if (gEnv->pPhysicalWorld)
+	{
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysStateChange::id, OnPhysicsStateChange, 1);
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysEntityDeleted::id, OnPhysicsEntityDeleted, 1);
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysUpdateMesh::id, OnPhysicsGeometryChanged, 1);
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysCreateEntityPart::id, OnPhysicsGeometryChanged, 1);
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysRemoveEntityParts::id, OnPhysicsGeometryChanged, 1);
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysRevealEntityPart::id, OnPhysicsGeometryChanged, 1);
+	}
+
 	Reset();
 }
 
@@ -57,6 +103,8 @@ void CVisionMap::Reset()
 	m_numberOfPVSUpdatesThisFrame = 0;
 	m_numberOfVisibilityUpdatesThisFrame = 0;
 	m_numberOfRayCastsSubmittedThisFrame = 0;
+	m_numberOfRaysQueuedThisFrame = 0;
+	m_numberOfRaysSavedThisFrame = 0;
 	m_debugObserverVisionID = VisionID();
 	m_debugObservableVisionID = VisionID();
 	memset(m_latencyInfo, 0, sizeof(m_latencyInfo));
@@ -73,6 +121,15 @@ void CVisionMap::Reset()
 
 	m_observerPVSUpdateQueue.clear();
 	m_observerVisibilityUpdateQueue.clear();
+
+	for (MovingEntities::iterator it = m_movingEntities.begin(), end = m_movingEntities.end(); it != end; ++it)
+		it->pEntity->Release();
+
+	stl::free_container(m_movingEntities);
+	stl::free_container(m_worldCellStamps);
+	stl::free_container(m_rayBatch);
+	m_worldStamp = 0;
+	m_worldClearStamp = 0;
 }
 
 VisionID CVisionMap::CreateVisionID(const char* name)
@@ -252,6 +309,8 @@ void CVisionMap::ObserverChanged(const ObserverID& observerID, const ObserverPar
 		for (int i = 0; i < currentObserverParams.skipListSize; ++i)
 			currentObserverParams.skipList[i] = newObserverParams.skipList[i];
 
+		InvalidateCachedResults(observerInfo.pvs);
+
 #ifdef _DEBUG
 		std::sort(&currentObserverParams.skipList[0], &currentObserverParams.skipList[currentObserverParams.skipListSize]);
 
@@ -281,6 +340,7 @@ void CVisionMap::ObserverChanged(const ObserverID& observerID, const ObserverPar
 	if (hint & eChangedRaycastFlags)
 	{
 		currentObserverParams.raycastFlags = newObserverParams.raycastFlags;
+		InvalidateCachedResults(observerInfo.pvs);
 		needsUpdate = true;
 	}
 
@@ -361,6 +421,8 @@ void CVisionMap::ObservableChanged(const ObservableID& observableID, const Obser
 		for (int i = 0; i < currentObservableParams.skipListSize; ++i)
 			currentObservableParams.skipList[i] = newObservableParams.skipList[i];
 
+		InvalidateCachedResults(observableID);
+
 #ifdef _DEBUG
 		std::sort(&currentObservableParams.skipList[0], &currentObservableParams.skipList[currentObservableParams.skipListSize]);
 
@@ -485,10 +547,14 @@ void CVisionMap::Update(float frameTime)
 	m_numberOfPVSUpdatesThisFrame = 0;
 	m_numberOfVisibilityUpdatesThisFrame = 0;
 	m_numberOfRayCastsSubmittedThisFrame = 0;
+	m_numberOfRaysQueuedThisFrame = 0;
+	m_numberOfRaysSavedThisFrame = 0;
 	m_debugTimer += frameTime;
 #endif
 
+	UpdateMovingEntities();
 	UpdateObservers();
+	PruneWorldCellStamps();
 }
 
 bool CVisionMap::IsInSightRange(const ObserverInfo& observerInfo, const ObservableInfo& observableInfo) const
@@ -587,6 +653,34 @@ RayCastRequest::Priority CVisionMap::GetRayCastRequestPriority(const ObserverPar
 	return priority;
 }
 
+RayCastRequest::Priority CVisionMap::GetAdaptiveRayCastPriority(const ObserverInfo& observerInfo, const PVSEntry& pvsEntry) const
+{
+	if (!gAIEnv.CVars.VisionMapAdaptiveRayPriority)
+		return pvsEntry.basePriority;
+
+	const ObserverParams& observerParams = observerInfo.observerParams;
+	const ObservableParams& observableParams = pvsEntry.observableInfo.observableParams;
+
+	int priority = pvsEntry.basePriority;
+
+	if ((observerParams.faction != IFactionMap::InvalidFactionID) && (observableParams.faction != IFactionMap::InvalidFactionID) &&
+	    (gAIEnv.pFactionMap->GetReaction(observerParams.faction, observableParams.faction) == IFactionMap::Hostile))
+	{
+		++priority;
+	}
+
+	if (observerParams.sightRange > 0.0f)
+	{
+		const float distance = (observableParams.observablePositions[0] - observerParams.eyePosition).len();
+		if (distance < observerParams.sightRange * 0.25f)
+			++priority;
+		else if (distance > observerParams.sightRange * 0.75f)
+			--priority;
+	}
+
+	return static_cast<RayCastRequest::Priority>(clamp_tpl<int>(priority, RayCastRequest::LowPriority, RayCastRequest::HighestPriority));
+}
+
 void CVisionMap::AddToObserverPVS(ObserverInfo& observerInfo, const ObservableInfo& observableInfo)
 {
 	observerInfo.needsVisibilityUpdate = true;
@@ -710,6 +804,53 @@ void CVisionMap::QueueRay(const ObserverInfo& observerInfo, PVSEntry& pvsEntry)
 #endif
 
 	pvsEntry.pendingRayID = queuedRayID;
+
+#if VISIONMAP_DEBUG
+	++m_numberOfRaysQueuedThisFrame;
+#endif
+}
+
+void CVisionMap::BatchRay(const ObserverInfo& observerInfo, PVSEntry& pvsEntry)
+{
+	BatchedRay ray;
+	ray.observerID = observerInfo.observerID;
+	ray.observableID = pvsEntry.observableInfo.observableID;
+	ray.priority = GetAdaptiveRayCastPriority(observerInfo, pvsEntry);
+	ray.distanceSq = (pvsEntry.observableInfo.observableParams.observablePositions[0] - observerInfo.observerParams.eyePosition).len2();
+
+	m_rayBatch.push_back(ray);
+}
+
+void CVisionMap::FlushRayBatch()
+{
+	if (m_rayBatch.empty())
+		return;
+
+	FUNCTION_PROFILER(GetISystem(), PROFILE_AI);
+
+	// queue the rays of all the observers updated this frame in one go, most important and closest first
+	std::sort(m_rayBatch.begin(), m_rayBatch.end());
+
+	for (RayBatch::const_iterator it = m_rayBatch.begin(), end = m_rayBatch.end(); it != end; ++it)
+	{
+		Observers::iterator observerIt = m_observers.find(it->observerID);
+		if (observerIt == m_observers.end())
+			continue;
+
+		ObserverInfo& observerInfo = observerIt->second;
+		PVS::iterator pvsIt = observerInfo.pvs.find(it->observableID);
+		if (pvsIt == observerInfo.pvs.end())
+			continue;
+
+		PVSEntry& pvsEntry = pvsIt->second;
+		if (pvsEntry.pendingRayID)
+			continue;
+
+		pvsEntry.priority = it->priority;
+		QueueRay(observerInfo, pvsEntry);
+	}
+
+	m_rayBatch.clear();
 }
 
 void CVisionMap::DeletePendingRay(PVSEntry& pvsEntry)
@@ -762,6 +903,15 @@ bool CVisionMap::RayCastSubmit(const QueuedRayID& queuedRayID, RayCastRequest& r
 	pendingRayInfo.observablePosition = observablePosition;
 #endif
 
+	if (pendingRayInfo.pvsEntry.currentTestPositionIndex == 0)
+	{
+		PVSEntry& pvsEntry = pendingRayInfo.pvsEntry;
+		pvsEntry.cachedResultValid = false;
+		pvsEntry.cachedWorldStamp = m_worldStamp;
+		pvsEntry.cachedObserverPosition = observerPosition;
+		pvsEntry.cachedObservablePosition = observableParams.observablePositions[0];
+	}
+
 	rayCastRequest.pos = observerPosition;
 	rayCastRequest.dir = observablePosition - observerPosition;
 	rayCastRequest.objTypes = COVER_OBJECT_TYPES;
@@ -839,6 +989,8 @@ void CVisionMap::RayCastComplete(const QueuedRayID& queuedRayID, const RayCastRe
 	}
 
 	pvsEntry.currentTestPositionIndex = 0;
+	pvsEntry.cachedResultValid = true;
+
 	if (pvsEntry.visible != visible)
 	{
 		pvsEntry.visible = visible;
@@ -896,13 +1048,334 @@ void CVisionMap::UpdateVisibilityStatus(ObserverInfo& observerInfo)
 			if (pvsEntry.pendingRayID != 0)
 				DeletePendingRay(pvsEntry);
 
-			QueueRay(observerInfo, pvsEntry);
+			if (gAIEnv.CVars.VisionMapRayCache && IsCachedResultValid(observerInfo, pvsEntry))
+			{
+				pvsEntry.currentTestPositionIndex = 0;
+
+#if VISIONMAP_DEBUG
+				++m_numberOfRaysSavedThisFrame;
+#endif
+				continue;
+			}
+
+			BatchRay(observerInfo, pvsEntry);
 		}
 	}
 
 	observerInfo.updateAllVisibilityStatus = false;
 }
 
+bool CVisionMap::IsCachedResultValid(const ObserverInfo& observerInfo, const PVSEntry& pvsEntry) const
+{
+	if (!pvsEntry.cachedResultValid)
+		return false;
+
+	const Vec3& observerPosition = observerInfo.observerParams.eyePosition;
+	const ObservableParams& observableParams = pvsEntry.observableInfo.observableParams;
+
+	if (!IsEquivalent(observerPosition, pvsEntry.cachedObserverPosition, positionEpsilon) ||
+	    !IsEquivalent(observableParams.observablePositions[0], pvsEntry.cachedObservablePosition, positionEpsilon))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < observableParams.observablePositionsCount; ++i)
+	{
+		if (HasWorldChangedAlongRay(observerPosition, observableParams.observablePositions[i], pvsEntry.cachedWorldStamp))
+			return false;
+	}
+
+	return true;
+}
+
+void CVisionMap::InvalidateCachedResults(PVS& pvs)
+{
+	for (PVS::iterator pvsIt = pvs.begin(), end = pvs.end(); pvsIt != end; ++pvsIt)
+		pvsIt->second.cachedResultValid = false;
+}
+
+void CVisionMap::InvalidateCachedResults(const ObservableID& observableID)
+{
+	for (Observers::iterator observerIt = m_observers.begin(), end = m_observers.end(); observerIt != end; ++observerIt)
+	{
+		PVS& pvs = observerIt->second.pvs;
+
+		PVS::iterator pvsIt = pvs.find(observableID);
+		if (pvsIt != pvs.end())
+			pvsIt->second.cachedResultValid = false;
+	}
+}
+
+void CVisionMap::MarkWorldChanged(const AABB& aabb)
+{
+	if (aabb.IsReset())
+		return;
+
+	++m_worldStamp;
+
+	const int minX = (int)floor_tpl(aabb.min.x / worldCellSize);
+	const int minY = (int)floor_tpl(aabb.min.y / worldCellSize);
+	const int maxX = (int)floor_tpl(aabb.max.x / worldCellSize);
+	const int maxY = (int)floor_tpl(aabb.max.y / worldCellSize);
+
+	const int countX = maxX - minX + 1;
+	const int countY = maxY - minY + 1;
+	if ((countX > maxMarkedWorldCells) || (countY > maxMarkedWorldCells) || (countX * countY > maxMarkedWorldCells))
+	{
+		// too large to be worth tracking per cell, drop all the cached results
+		m_worldClearStamp = m_worldStamp;
+		return;
+	}
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+			m_worldCellStamps[GetWorldCellKey(x, y)] = m_worldStamp;
+	}
+}
+
+void CVisionMap::MarkWorldChanged(IPhysicalEntity* pEntity)
+{
+	// by type, disabled entities are moved out of the vision blocking simulation classes
+	const pe_type type = pEntity->GetType();
+	if ((type != PE_STATIC) && (type != PE_RIGID))
+		return;
+
+	pe_status_pos status;
+	if (pEntity->GetStatus(&status))
+		MarkWorldChanged(AABB(status.pos + status.BBox[0], status.pos + status.BBox[1]));
+}
+
+void CVisionMap::PruneWorldCellStamps()
+{
+	if (m_worldCellStamps.size() <= maxWorldCellStamps)
+		return;
+
+	FUNCTION_PROFILER(GetISystem(), PROFILE_AI);
+
+	// cells stamped before every cached result, including the ones still being raycast, can't invalidate anything
+	uint32 oldestWorldStamp = m_worldStamp;
+	for (Observers::const_iterator observerIt = m_observers.begin(), observerEnd = m_observers.end(); observerIt != observerEnd; ++observerIt)
+	{
+		const PVS& pvs = observerIt->second.pvs;
+		for (PVS::const_iterator pvsIt = pvs.begin(), pvsEnd = pvs.end(); pvsIt != pvsEnd; ++pvsIt)
+		{
+			const PVSEntry& pvsEntry = pvsIt->second;
+			if ((pvsEntry.cachedResultValid || pvsEntry.pendingRayID) && (pvsEntry.cachedWorldStamp >= m_worldClearStamp))
+				oldestWorldStamp = min(oldestWorldStamp, pvsEntry.cachedWorldStamp);
+		}
+	}
+
+	for (WorldCellStamps::iterator it = m_worldCellStamps.begin(); it != m_worldCellStamps.end(); )
+	{
+		if (it->second <= oldestWorldStamp)
+			it = m_worldCellStamps.erase(it);
+		else
+			++it;
+	}
+
+	if (m_worldCellStamps.size() > maxWorldCellStamps / 2)
+	{
+		// a cached result which stays valid for long keeps many cells alive, drop all of them instead of pruning
+		// again every frame
+		m_worldClearStamp = m_worldStamp;
+		stl::free_container(m_worldCellStamps);
+	}
+}
+
+bool CVisionMap::HasWorldChangedAlongRay(const Vec3& from, const Vec3& to, uint32 worldStamp) const
+{
+	if (worldStamp < m_worldClearStamp)
+		return true;
+
+	if (m_worldCellStamps.empty())
+		return false;
+
+	// walk the cells the ray crosses on the xy plane
+	const float fromX = from.x / worldCellSize;
+	const float fromY = from.y / worldCellSize;
+	const float toX = to.x / worldCellSize;
+	const float toY = to.y / worldCellSize;
+
+	int x = (int)floor_tpl(fromX);
+	int y = (int)floor_tpl(fromY);
+	const int endX = (int)floor_tpl(toX);
+	const int endY = (int)floor_tpl(toY);
+
+	const float dx = toX - fromX;
+	const float dy = toY - fromY;
+	const int stepX = (dx > 0.0f) ? 1 : -1;
+	const int stepY = (dy > 0.0f) ? 1 : -1;
+	const float deltaX = (dx != 0.0f) ? fabs_tpl(1.0f / dx) : FLT_MAX;
+	const float deltaY = (dy != 0.0f) ? fabs_tpl(1.0f / dy) : FLT_MAX;
+	float nextX = (dx > 0.0f) ? (x + 1 - fromX) * deltaX : (dx < 0.0f) ? (fromX - x) * deltaX : FLT_MAX;
+	float nextY = (dy > 0.0f) ? (y + 1 - fromY) * deltaY : (dy < 0.0f) ? (fromY - y) * deltaY : FLT_MAX;
+
+	const int cellCount = abs(endX - x) + abs(endY - y) + 1;
+	for (int i = 0; i < cellCount; ++i)
+	{
+		WorldCellStamps::const_iterator it = m_worldCellStamps.find(GetWorldCellKey(x, y));
+		if ((it != m_worldCellStamps.end()) && (it->second > worldStamp))
+			return true;
+
+		if (nextX < nextY)
+		{
+			nextX += deltaX;
+			x += stepX;
+		}
+		else
+		{
+			nextY += deltaY;
+			y += stepY;
+		}
+	}
+
+	return false;
+}
+
+void CVisionMap::UpdateMovingEntities()
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_AI);
+
+	pe_status_pos status;
+
+	for (MovingEntities::iterator it = m_movingEntities.begin(), end = m_movingEntities.end(); it != end; ++it)
+	{
+		MovingEntity& movingEntity = *it;
+		if (!movingEntity.pEntity->GetStatus(&status))
+			continue;
+
+		const AABB aabb(status.pos + status.BBox[0], status.pos + status.BBox[1]);
+		if (IsEquivalent(aabb.min, movingEntity.aabb.min, positionEpsilon) && IsEquivalent(aabb.max, movingEntity.aabb.max, positionEpsilon))
+			continue;
+
+		// the cells it left might have become visible, the ones it entered might have become blocked
+		AABB changed(aabb);
+		changed.Add(movingEntity.aabb);
+		MarkWorldChanged(changed);
+
+		movingEntity.aabb = aabb;
+	}
+}
+
+void CVisionMap::AddMovingEntity(IPhysicalEntity* pEntity)
+{
+	for (MovingEntities::iterator it = m_movingEntities.begin(), end = m_movingEntities.end(); it != end; ++it)
+	{
+		if (it->pEntity == pEntity)
+			return;
+	}
+
+	pe_status_pos status;
+	if (!pEntity->GetStatus(&status))
+		return;
+
+	pEntity->AddRef();
+
+	MovingEntity movingEntity;
+	movingEntity.pEntity = pEntity;
+	movingEntity.aabb = AABB(status.pos + status.BBox[0], status.pos + status.BBox[1]);
+	m_movingEntities.push_back(movingEntity);
+}
+
+void CVisionMap::RemoveMovingEntity(IPhysicalEntity* pEntity)
+{
+	for (size_t i = 0; i < m_movingEntities.size(); ++i)
+	{
+		if (m_movingEntities[i].pEntity == pEntity)
+		{
+			MarkWorldChanged(m_movingEntities[i].aabb);
+			pEntity->Release();
+
+			m_movingEntities[i] = m_movingEntities.back();
+			m_movingEntities.pop_back();
+			return;
+		}
+	}
+}
+
+int CVisionMap::OnPhysicsStateChange(const EventPhys* pPhysEvent)
+{
+	CVisionMap* pVisionMap = gAIEnv.pVisionMap;
+	if (!pVisionMap)
+		return 1;
+
+	const EventPhysStateChange* pEvent = static_cast<const EventPhysStateChange*>(pPhysEvent);
+	if (!IsVisionBlockingSimClass(pEvent->iSimClass[0]) && !IsVisionBlockingSimClass(pEvent->iSimClass[1]))
+		return 1;
+
+	// entity physics logs its state changes, this also sees static and sleeping entities moved with pe_params_pos,
+	// like doors
+	const AABB aabbOld(pEvent->BBoxOld[0], pEvent->BBoxOld[1]);
+	const AABB aabbNew(pEvent->BBoxNew[0], pEvent->BBoxNew[1]);
+	if (((aabbOld.min - aabbNew.min).len2() + (aabbOld.max - aabbNew.max).len2()) > 0.0f)
+	{
+		pVisionMap->MarkWorldChanged(aabbOld);
+		pVisionMap->MarkWorldChanged(aabbNew);
+	}
+
+	// awake rigid bodies don't send events while they move, they are tracked until they go to sleep
+	if (pEvent->iSimClass[1] == SC_ACTIVE_RIGID)
+		pVisionMap->AddMovingEntity(pEvent->pEntity);
+	else
+		pVisionMap->RemoveMovingEntity(pEvent->pEntity);
+
+	return 1;
+}
+
+int CVisionMap::OnPhysicsEntityDeleted(const EventPhys* pPhysEvent)
+{
+	CVisionMap* pVisionMap = gAIEnv.pVisionMap;
+	if (!pVisionMap)
+		return 1;
+
+	const EventPhysEntityDeleted* pEvent = static_cast<const EventPhysEntityDeleted*>(pPhysEvent);
+	IPhysicalEntity* pEntity = pEvent->pEntity;
+
+	pVisionMap->MarkWorldChanged(pEntity);
+	pVisionMap->RemoveMovingEntity(pEntity);
+
+	return 1;
+}
+
+int CVisionMap::OnPhysicsGeometryChanged(const EventPhys* pPhysEvent)
+{
+	CVisionMap* pVisionMap = gAIEnv.pVisionMap;
+	if (!pVisionMap)
+		return 1;
+
+	// broken, deformed or removed parts change the shape without changing the simulation class, and usually not the
+	// bounding box either
+	const EventPhysMono* pEvent = static_cast<const EventPhysMono*>(pPhysEvent);
+	pVisionMap->MarkWorldChanged(pEvent->pEntity);
+
+	if (pPhysEvent->idval == EventPhysCreateEntityPart::id)
+	{
+		IPhysicalEntity* pEntNew = static_cast<const EventPhysCreateEntityPart*>(pPhysEvent)->pEntNew;
+		if (pEntNew && (pEntNew != pEvent->pEntity))
+		{
+			pVisionMap->MarkWorldChanged(pEntNew);
+
+			// the piece which broke off flies away without a state change event
+			pe_status_pos status;
+			if (pEntNew->GetStatus(&status) && (status.iSimClass == SC_ACTIVE_RIGID))
+				pVisionMap->AddMovingEntity(pEntNew);
+		}
+	}
+
+	return 1;
+}
+
+void CVisionMap::OnEvent(IEntity* pEntity, SEntityEvent& event)
+{
+	// physicalized, or physics enabled or disabled
+	if (event.event == ENTITY_EVENT_ENABLE_PHYSICS)
+	{
+		if (IPhysicalEntity* pPhysics = pEntity->GetPhysics())
+			MarkWorldChanged(pPhysics);
+	}
+}
+
 void CVisionMap::UpdateObservers()
 {
 	CTimeValue now = gEnv->pTimer->GetFrameStartTime();
@@ -980,6 +1453,8 @@ void CVisionMap::UpdateObservers()
 		m_visibilityUpdateQueueLatency = now - observerInfo.queuedForVisibilityUpdateTime;
 #endif
 	}
+
+	FlushRayBatch();
 }
 
 void CVisionMap::TriggerObserverCallback(const ObserverInfo& observerInfo, const ObservableInfo& observableInfo, bool visible)
@@ -1085,6 +1560,8 @@ void CVisionMap::DebugDrawVisionMapStats()
 	                                  "# Visibility queue size: %" PRISIZE_T "\n"
 	                                                                         "# Visibility queue latency : %.2f\n\n"
 	                                                                         "# Raycast submits: %u\n"
+	                                                                         "# Raycasts queued: %u\n"
+	                                                                         "# Raycasts saved by cache: %u\n"
 	                                                                         "# Pending raycast: %d\n\n"
 	                                                                         "Raycast latency:\n"
 	                                                                         "Priority  | avg  | min  | max  | # pending\n"
@@ -1101,6 +1578,8 @@ void CVisionMap::DebugDrawVisionMapStats()
 	  m_observerVisibilityUpdateQueue.size(),
 	  m_visibilityUpdateQueueLatency.GetSeconds(),
 	  m_numberOfRayCastsSubmittedThisFrame,
+	  m_numberOfRaysQueuedThisFrame,
+	  m_numberOfRaysSavedThisFrame,
 	  totalPending,
 	  displayInfoArray[RayCastRequest::LowPriority].avg,
 	  displayInfoArray[RayCastRequest::LowPriority].min,
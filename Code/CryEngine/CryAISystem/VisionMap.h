@@ -24,7 +24,7 @@
 	#define VISIONMAP_DEBUG 1
 #endif
 
-class CVisionMap : public IVisionMap
+class CVisionMap : public IVisionMap, public IEntitySystemSink
 {
 public:
 	CVisionMap();
@@ -53,6 +53,14 @@ public:
 
 	virtual void                    Update(float frameTime);
 
+	// IEntitySystemSink
+	virtual bool OnBeforeSpawn(SEntitySpawnParams& params)              { return true; }
+	virtual void OnSpawn(IEntity* pEntity, SEntitySpawnParams& params)  {}
+	virtual bool OnRemove(IEntity* pEntity)                             { return true; }
+	virtual void OnReused(IEntity* pEntity, SEntitySpawnParams& params) {}
+	virtual void OnEvent(IEntity* pEntity, SEntityEvent& event);
+	// ~IEntitySystemSink
+
 #if VISIONMAP_DEBUG
 	void DebugDraw();
 #endif
@@ -87,7 +95,12 @@ private:
 			, visible(false)
 			, currentTestPositionIndex(0)
 			, priority(_priority)
+			, basePriority(_priority)
 			, needsUpdate(true)
+			, cachedResultValid(false)
+			, cachedWorldStamp(0)
+			, cachedObserverPosition(ZERO)
+			, cachedObservablePosition(ZERO)
 #if VISIONMAP_DEBUG
 			, obstructionPosition(ZERO)
 			, lastObserverPositionChecked(ZERO)
@@ -97,7 +110,8 @@ private:
 		{};
 
 		QueuedRayID              pendingRayID;
-		RayCastRequest::Priority priority;
+		RayCastRequest::Priority priority;       // priority of the pending ray
+		RayCastRequest::Priority basePriority;   // priority from the priority map
 		const ObservableInfo&    observableInfo;
 
 		bool                     visible;
@@ -105,6 +119,13 @@ private:
 		int8                     currentTestPositionIndex;
 		int8                     firstVisPos;
 
+		// the visibility of the last completed check is reused as long as both ends of the rays are
+		// at the same place and nothing changed in the world cells the rays go through
+		bool   cachedResultValid;
+		uint32 cachedWorldStamp;
+		Vec3   cachedObserverPosition;
+		Vec3   cachedObservablePosition;
+
 #if VISIONMAP_DEBUG
 		Vec3  obstructionPosition;
 		Vec3  lastObserverPositionChecked;
@@ -169,6 +190,34 @@ private:
 #endif
 	};
 
+	// rays requested by the visibility updates of a frame, they are queued together once all observers were updated
+	struct BatchedRay
+	{
+		ObserverID               observerID;
+		ObservableID             observableID;
+		RayCastRequest::Priority priority;
+		float                    distanceSq;
+
+		bool operator<(const BatchedRay& other) const
+		{
+			if (priority != other.priority)
+				return priority > other.priority;
+			return distanceSq < other.distanceSq;
+		}
+	};
+
+	typedef std::vector<BatchedRay> RayBatch;
+
+	// rigid bodies which are awake, their bounding boxes are checked every frame to update the world cells
+	struct MovingEntity
+	{
+		IPhysicalEntity* pEntity;
+		AABB             aabb;
+	};
+
+	typedef std::vector<MovingEntity>                            MovingEntities;
+	typedef std::unordered_map<uint32, uint32, stl::hash_uint32> WorldCellStamps;
+
 	std::vector<PriorityMapEntry> m_priorityMap;
 
 	void AcquireSkipList(IPhysicalEntity** skipList, uint32 skipListSize);
@@ -195,9 +244,28 @@ private:
 	bool                     IsInFoV(const ObserverInfo& observerInfo, const ObservableInfo& observableInfo) const;
 
 	void                     QueueRay(const ObserverInfo& observerInfo, PVSEntry& pvsEntry);
+	void                     BatchRay(const ObserverInfo& observerInfo, PVSEntry& pvsEntry);
+	void                     FlushRayBatch();
 	bool                     RayCastSubmit(const QueuedRayID& queuedRayID, RayCastRequest& request);
 	void                     RayCastComplete(const QueuedRayID& queuedRayID, const RayCastResult& rayCastResult);
 	RayCastRequest::Priority GetRayCastRequestPriority(const ObserverParams& observerParams, const ObservableParams& observable);
+	RayCastRequest::Priority GetAdaptiveRayCastPriority(const ObserverInfo& observerInfo, const PVSEntry& pvsEntry) const;
+
+	bool                     IsCachedResultValid(const ObserverInfo& observerInfo, const PVSEntry& pvsEntry) const;
+	void                     InvalidateCachedResults(PVS& pvs);
+	void                     InvalidateCachedResults(const ObservableID& observableID);
+
+	void                     MarkWorldChanged(const AABB& aabb);
+	void                     MarkWorldChanged(IPhysicalEntity* pEntity);
+	void                     PruneWorldCellStamps();
+	bool                     HasWorldChangedAlongRay(const Vec3& from, const Vec3& to, uint32 worldStamp) const;
+	void                     UpdateMovingEntities();
+	void                     AddMovingEntity(IPhysicalEntity* pEntity);
+	void                     RemoveMovingEntity(IPhysicalEntity* pEntity);
+
+	static int               OnPhysicsStateChange(const EventPhys* pPhysEvent);
+	static int               OnPhysicsEntityDeleted(const EventPhys* pPhysEvent);
+	static int               OnPhysicsGeometryChanged(const EventPhys* pPhysEvent);
 
 	void                     DeletePendingRay(PVSEntry& pvsEntry);
 	void                     DeletePendingRays(PVS& pvs);
@@ -217,13 +285,22 @@ private:
 	QueryObservables m_queryObservables;
 
 	typedef std::map<QueuedRayID, PendingRayInfo> PendingRays;
-	PendingRays m_pendingRays;
+	PendingRays     m_pendingRays;
+
+	RayBatch        m_rayBatch;
+
+	WorldCellStamps m_worldCellStamps;
+	uint32          m_worldStamp;
+	uint32          m_worldClearStamp;   // cached results older than this are invalid everywhere
+	MovingEntities  m_movingEntities;
 
 #if VISIONMAP_DEBUG
 	float      m_debugTimer;
 	uint32     m_numberOfPVSUpdatesThisFrame;
 	uint32     m_numberOfVisibilityUpdatesThisFrame;
 	uint32     m_numberOfRayCastsSubmittedThisFrame;
+	uint32     m_numberOfRaysQueuedThisFrame;
+	uint32     m_numberOfRaysSavedThisFrame;
 
 	VisionID   m_debugObserverVisionID;
 	VisionID   m_debugObservableVisionID;
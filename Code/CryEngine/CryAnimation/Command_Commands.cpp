@@ -5,6 +5,7 @@
 
 #include "Helper.h"
 #include "ControllerOpt.h"
+#include "ControllerBatchSampler.h"
 #include "CharacterInstance.h"
 #include "SkeletonAnim.h"
 #include "SkeletonPose.h"
@@ -190,16 +191,49 @@ void SampleAddAnimFull::Execute(const CState& state, CEvaluationContext& context
 		outputRelScale[0] = 1.0;
 	}
 
+	// sample all joints up front, joints without controller or track keep the default pose
+	PREFAST_SUPPRESS_WARNING(6255);
+	const auto parrSampledPose = static_cast<QuatT*>(alloca(state.m_jointCount * sizeof(QuatT)));
+	PREFAST_SUPPRESS_WARNING(6255);
+	const auto parrSampledScale = static_cast<float*>(alloca(state.m_jointCount * sizeof(float)));
+	PREFAST_SUPPRESS_WARNING(6255);
+	const auto parrSampledState = static_cast<JointState*>(alloca(state.m_jointCount * sizeof(JointState)));
+	for (uint32 j = startingJointIndex; j < state.m_jointCount; ++j)
+	{
+		parrSampledPose[j] = defaultPose[j];
+		parrSampledScale[j] = defaultScale ? defaultScale[j] : 1.0f;
+	}
+
+	if (Console::GetInst().ca_SampleBatched)
+	{
+		const uint32 numJoints = state.m_jointCount - startingJointIndex;
+		CControllerBatchSampler::Sample(parrJointControllers + startingJointIndex, numJoints, keyTimeNew,
+		                                parrSampledPose + startingJointIndex, parrSampledScale + startingJointIndex, parrSampledState + startingJointIndex);
+	}
+	else
+	{
+		for (uint32 j = startingJointIndex; j < state.m_jointCount; ++j)
+		{
+			parrSampledState[j] = 0;
+			if (parrJointControllers[j])
+			{
+				Diag33 tempScale = Diag33(parrSampledScale[j]);
+				parrSampledState[j] = parrJointControllers[j]->GetOPS(keyTimeNew, parrSampledPose[j].q, parrSampledPose[j].t, tempScale);
+				parrSampledScale[j] = tempScale.x;
+			}
+		}
+	}
+
 	if (rCAF.IsAssetAdditive())
 	{
 		for (uint32 j = startingJointIndex; j < state.m_jointCount; ++j)
 		{
-			QuatT tempPose(defaultPose[j].q, defaultPose[j].t);
-			Diag33 tempScale = Diag33(defaultScale ? defaultScale[j] : 1.0f);
+			QuatT tempPose = parrSampledPose[j];
+			float tempScale = parrSampledScale[j];
 
 			if (parrJointControllers[j])
 			{
-				const JointState ops = parrJointControllers[j]->GetOPS(keyTimeNew, tempPose.q, tempPose.t, tempScale);
+				const JointState ops = parrSampledState[j];
 				if (ops & eJS_Orientation)
 				{
 					tempPose.q *= defaultPose[j].q;
@@ -210,7 +244,7 @@ void SampleAddAnimFull::Execute(const CState& state, CEvaluationContext& context
 				}
 				if (ops & eJS_Scale)
 				{
-					tempScale *= Diag33(defaultScale ? defaultScale[j] : 1.0f);
+					tempScale *= defaultScale ? defaultScale[j] : 1.0f;
 					context.m_isScalingPresent = true;
 				}
 
@@ -220,7 +254,7 @@ void SampleAddAnimFull::Execute(const CState& state, CEvaluationContext& context
 
 			outputRelPose[j].q += (tempPose.q * m_fWeight);
 			outputRelPose[j].t += (tempPose.t * m_fWeight);
-			outputRelScale[j] += (tempScale.x * m_fWeight);
+			outputRelScale[j] += (tempScale * m_fWeight);
 		}
 	}
 	else
@@ -228,14 +262,12 @@ void SampleAddAnimFull::Execute(const CState& state, CEvaluationContext& context
 		const QuatT* parrHemispherePose = Console::GetInst().ca_SampleQuatHemisphereFromCurrentPose ? outputRelPose : defaultPose; // joints to compare with in quaternion dot product
 		for (uint32 j = startingJointIndex; j < state.m_jointCount; ++j)
 		{
-			QuatT tempPose(defaultPose[j].q, defaultPose[j].t);
-			Diag33 tempScale = Diag33(defaultScale ? defaultScale[j] : 1.0f);
+			QuatT tempPose = parrSampledPose[j];
+			const float tempScale = parrSampledScale[j];
 
 			if (parrJointControllers[j])
 			{
-				const JointState ops = parrJointControllers[j]->GetOPS(keyTimeNew, tempPose.q, tempPose.t, tempScale);
-
-				if (ops & eJS_Scale)
+				if (parrSampledState[j] & eJS_Scale)
 				{
 					context.m_isScalingPresent = true;
 				}
@@ -247,7 +279,7 @@ void SampleAddAnimFull::Execute(const CState& state, CEvaluationContext& context
 
 			outputRelPose[j].q += (tempPose.q * m_fWeight);
 			outputRelPose[j].t += (tempPose.t * m_fWeight);
-			outputRelScale[j] += (tempScale.x * m_fWeight);
+			outputRelScale[j] += (tempScale * m_fWeight);
 		}
 	}
 
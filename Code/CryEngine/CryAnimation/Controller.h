@@ -14,6 +14,17 @@ enum EJointState
 
 typedef uint8 JointState;
 
+// Raw description of a single track, used by CControllerBatchSampler to sample controllers without going
+// through the virtual interface for every key.
+struct SControllerTrack
+{
+	const void* pKeyTimes;      // key times, layout depends on keyTimesFormat
+	const void* pKeys;          // key values, layout depends on compression
+	uint32      numKeys;
+	uint8       keyTimesFormat; // EKeyTimesFormat, eNoFormat if the controller has no such track
+	uint8       compression;    // ECompressionInformation
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // interface IController
 // Describes the position and orientation of an object, changing in time.
@@ -49,6 +60,10 @@ public:
 
 	virtual size_t     SizeOfController() const = 0;
 	virtual size_t     ApproximateSizeOfThis() const = 0;
+
+	// returns the raw rotation, position and scale tracks for the batched sampler
+	// or false if the controller can only be sampled through GetOPS()
+	virtual bool GetTracks(SControllerTrack& rotation, SControllerTrack& position, SControllerTrack& scale) const { return false; }
 };
 
 TYPEDEF_AUTOPTR(IController);
@@ -0,0 +1,442 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "stdafx.h"
+#include "ControllerBatchSampler.h"
+
+#include "ControllerPQ.h"
+#include "ControllerOpt.h"
+
+struct CControllerBatchSampler::STrackSet
+{
+	SControllerTrack  tracks[kChunkSize];
+	uint32            joints[kChunkSize];
+	uint32            key0[kChunkSize];
+	uint32            key1[kChunkSize];
+	CRY_ALIGN(16) f32 blend[kChunkSize];
+	uint32            count;
+
+	void Add(const SControllerTrack& track, uint32 joint)
+	{
+		tracks[count] = track;
+		joints[count] = joint;
+		++count;
+	}
+};
+
+struct CControllerBatchSampler::SChunk
+{
+	STrackSet rotation;
+	STrackSet position;
+	STrackSet scale;
+
+	// decoded rotation keys, [0, kChunkSize) holds the first and [kChunkSize, 2 * kChunkSize) the second key of each track
+	CRY_ALIGN(16) f32 qx[2 * kChunkSize];
+	CRY_ALIGN(16) f32 qy[2 * kChunkSize];
+	CRY_ALIGN(16) f32 qz[2 * kChunkSize];
+	CRY_ALIGN(16) f32 qw[2 * kChunkSize];
+
+	void SetKey(uint32 slot, const Quat& q)
+	{
+		qx[slot] = q.v.x;
+		qy[slot] = q.v.y;
+		qz[slot] = q.v.z;
+		qw[slot] = q.w;
+	}
+};
+
+namespace
+{
+
+// decodes a single key of any rotation format
+void DecodeRotationKey(uint32 compression, const void* pKeys, uint32 key, Quat& q)
+{
+	switch (compression)
+	{
+	case eSmallTree48BitQuat:
+		static_cast<const SmallTree48BitQuat*>(pKeys)[key].ToExternalType(q);
+		break;
+	case eSmallTree64BitExtQuat:
+		static_cast<const SmallTree64BitExtQuat*>(pKeys)[key].ToExternalType(q);
+		break;
+	case eSmallTree64BitQuat:
+		static_cast<const SmallTree64BitQuat*>(pKeys)[key].ToExternalType(q);
+		break;
+	case eNoCompress:
+	case eNoCompressQuat:
+		static_cast<const NoCompressQuat*>(pKeys)[key].ToExternalType(q);
+		break;
+	default:
+		CryFatalError("Unknown Rotation Compression format %i\n", compression);
+		break;
+	}
+}
+
+#if CRY_PLATFORM_SSE2
+
+ILINE __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// The small-tree formats drop the largest component (at index) and store the other three in ascending component order,
+// so the quaternion is rebuilt with selects instead of per lane shuffles.
+ILINE void ExpandSmallTree(__m128i index, __m128 s0, __m128 s1, __m128 s2, __m128& x, __m128& y, __m128& z, __m128& w)
+{
+	const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(s0, s0), _mm_mul_ps(s1, s1)), _mm_mul_ps(s2, s2));
+	const __m128 largest = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), sum), _mm_setzero_ps()));
+
+	const __m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(0)));
+	const __m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(1)));
+	const __m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(2)));
+	const __m128 is3 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(3)));
+
+	x = Select(is0, largest, s0);
+	y = Select(is0, s0, Select(is1, largest, s1));
+	z = Select(is3, s2, Select(is2, largest, s1));
+	w = Select(is3, largest, s2);
+}
+
+// decodes four keys given by pointers into the key arrays
+ILINE void DecodeSmallTree48BitQuat4(const void* const* pKeys, __m128& x, __m128& y, __m128& z, __m128& w)
+{
+	const SmallTree48BitQuat* p0 = static_cast<const SmallTree48BitQuat*>(pKeys[0]);
+	const SmallTree48BitQuat* p1 = static_cast<const SmallTree48BitQuat*>(pKeys[1]);
+	const SmallTree48BitQuat* p2 = static_cast<const SmallTree48BitQuat*>(pKeys[2]);
+	const SmallTree48BitQuat* p3 = static_cast<const SmallTree48BitQuat*>(pKeys[3]);
+
+	const __m128i m1 = _mm_set_epi32(p3->m_1, p2->m_1, p1->m_1, p0->m_1);
+	const __m128i m2 = _mm_set_epi32(p3->m_2, p2->m_2, p1->m_2, p0->m_2);
+	const __m128i m3 = _mm_set_epi32(p3->m_3, p2->m_3, p1->m_3, p0->m_3);
+
+	const __m128i mask = _mm_set1_epi32(0x7FFF);
+	const __m128i a = _mm_and_si128(m1, mask);
+	const __m128i b = _mm_and_si128(_mm_add_epi32(_mm_srli_epi32(m1, 15), _mm_slli_epi32(m2, 1)), mask);
+	const __m128i c = _mm_and_si128(_mm_add_epi32(_mm_srli_epi32(m2, 14), _mm_slli_epi32(m3, 2)), mask);
+	const __m128i index = _mm_srli_epi32(m3, 14);
+
+	const __m128 scale = _mm_set1_ps(1.0f / MAX_15BITf);
+	const __m128 range = _mm_set1_ps(RANGE_15BIT);
+	const __m128 s0 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), scale), range);
+	const __m128 s1 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(b), scale), range);
+	const __m128 s2 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), scale), range);
+
+	ExpandSmallTree(index, s0, s1, s2, x, y, z, w);
+}
+
+ILINE void DecodeSmallTree64BitExtQuat4(const void* const* pKeys, __m128& x, __m128& y, __m128& z, __m128& w)
+{
+	const SmallTree64BitExtQuat* p0 = static_cast<const SmallTree64BitExtQuat*>(pKeys[0]);
+	const SmallTree64BitExtQuat* p1 = static_cast<const SmallTree64BitExtQuat*>(pKeys[1]);
+	const SmallTree64BitExtQuat* p2 = static_cast<const SmallTree64BitExtQuat*>(pKeys[2]);
+	const SmallTree64BitExtQuat* p3 = static_cast<const SmallTree64BitExtQuat*>(pKeys[3]);
+
+	const __m128i m1 = _mm_set_epi32((int)p3->m_1, (int)p2->m_1, (int)p1->m_1, (int)p0->m_1);
+	const __m128i m2 = _mm_set_epi32((int)p3->m_2, (int)p2->m_2, (int)p1->m_2, (int)p0->m_2);
+
+	const __m128i mask21 = _mm_set1_epi32(0x1FFFFF);
+	const __m128i a = _mm_and_si128(m1, mask21);
+	const __m128i b = _mm_and_si128(_mm_add_epi32(_mm_srli_epi32(m1, 21), _mm_slli_epi32(m2, 11)), mask21);
+	const __m128i c = _mm_and_si128(_mm_srli_epi32(m2, 10), _mm_set1_epi32(0xFFFFF));
+	const __m128i index = _mm_srli_epi32(m2, 30);
+
+	const __m128 scale21 = _mm_set1_ps(1.0f / MAX_21BITf);
+	const __m128 range21 = _mm_set1_ps(RANGE_21BIT);
+	const __m128 s0 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), scale21), range21);
+	const __m128 s1 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(b), scale21), range21);
+	const __m128 s2 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), _mm_set1_ps(1.0f / MAX_20BITf)), _mm_set1_ps(RANGE_20BIT));
+
+	ExpandSmallTree(index, s0, s1, s2, x, y, z, w);
+}
+
+#endif // CRY_PLATFORM_SSE2
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CControllerBatchSampler::Sample(const IController* const* pControllers, uint32 numControllers, f32 keyTime, QuatT* pPoses, float* pScales, JointState* pStates)
+{
+	for (uint32 first = 0; first < numControllers; first += kChunkSize)
+	{
+		const uint32 count = min<uint32>(numControllers - first, kChunkSize);
+		SampleChunk(pControllers + first, count, keyTime, pPoses + first, pScales + first, pStates + first);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CControllerBatchSampler::SampleChunk(const IController* const* pControllers, uint32 numControllers, f32 keyTime, QuatT* pPoses, float* pScales, JointState* pStates)
+{
+	SChunk chunk;
+	chunk.rotation.count = 0;
+	chunk.position.count = 0;
+	chunk.scale.count = 0;
+
+	// gather the tracks, this is the only virtual call per controller
+	for (uint32 i = 0; i < numControllers; ++i)
+	{
+		pStates[i] = 0;
+
+		const IController* pController = pControllers[i];
+		if (!pController)
+			continue;
+
+		SControllerTrack rotation, position, scale;
+		if (!pController->GetTracks(rotation, position, scale))
+		{
+			Diag33 tempScale(pScales[i]);
+			pStates[i] = pController->GetOPS(keyTime, pPoses[i].q, pPoses[i].t, tempScale);
+			pScales[i] = tempScale.x;
+			continue;
+		}
+
+		if (rotation.keyTimesFormat != eNoFormat)
+		{
+			chunk.rotation.Add(rotation, i);
+			pStates[i] |= eJS_Orientation;
+		}
+		if (position.keyTimesFormat != eNoFormat)
+		{
+			chunk.position.Add(position, i);
+			pStates[i] |= eJS_Position;
+		}
+		if (scale.keyTimesFormat != eNoFormat)
+		{
+			chunk.scale.Add(scale, i);
+			pStates[i] |= eJS_Scale;
+		}
+	}
+
+	FindKeys(chunk.rotation, keyTime);
+	FindKeys(chunk.position, keyTime);
+	FindKeys(chunk.scale, keyTime);
+
+	SampleRotations(chunk, pPoses);
+
+	CRY_ALIGN(16) Vec3 values[kChunkSize];
+	SampleVectors(chunk.position, values);
+	for (uint32 i = 0; i < chunk.position.count; ++i)
+	{
+		pPoses[chunk.position.joints[i]].t = values[i];
+	}
+
+	SampleVectors(chunk.scale, values);
+	for (uint32 i = 0; i < chunk.scale.count; ++i)
+	{
+		pScales[chunk.scale.joints[i]] = values[i].x;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CControllerBatchSampler::FindKeys(STrackSet& tracks, f32 keyTime)
+{
+	for (uint32 i = 0; i < tracks.count; ++i)
+	{
+		const SControllerTrack& track = tracks.tracks[i];
+
+		f32 t = 0.0f;
+		uint32 key;
+		switch (track.keyTimesFormat)
+		{
+		case eByte:
+			key = ControllerHelper::GetKeyFromTimes(static_cast<const uint8*>(track.pKeyTimes), track.numKeys, keyTime, t);
+			break;
+		case eUINT16:
+			key = ControllerHelper::GetKeyFromTimes(static_cast<const uint16*>(track.pKeyTimes), track.numKeys, keyTime, t);
+			break;
+		case eF32:
+			key = ControllerHelper::GetKeyFromTimes(static_cast<const f32*>(track.pKeyTimes), track.numKeys, keyTime, t);
+			break;
+		default:
+			key = ControllerHelper::GetKeyFromBitset(static_cast<const uint16*>(track.pKeyTimes), keyTime, t);
+			break;
+		}
+
+		// same key selection as GetOPS(): clamp to the first and last key outside of the track
+		if (key == 0)
+		{
+			tracks.key0[i] = tracks.key1[i] = 0;
+			t = 0.0f;
+		}
+		else if (key >= track.numKeys)
+		{
+			tracks.key0[i] = tracks.key1[i] = track.numKeys - 1;
+			t = 0.0f;
+		}
+		else
+		{
+			tracks.key0[i] = key - 1;
+			tracks.key1[i] = key;
+		}
+		tracks.blend[i] = t;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CControllerBatchSampler::SampleRotations(SChunk& chunk, QuatT* pPoses)
+{
+	STrackSet& rotation = chunk.rotation;
+	if (rotation.count == 0)
+		return;
+
+#if CRY_PLATFORM_SSE2
+	// keys of one rotation format, collected to be decoded four at a time
+	struct SKeyBatch
+	{
+		const void* pKeys[2 * kChunkSize];
+		uint32      slots[2 * kChunkSize];
+		uint32      count;
+	};
+	SKeyBatch batch48, batch64Ext;
+	batch48.count = 0;
+	batch64Ext.count = 0;
+#endif
+
+	// decode both keys of each track
+	for (uint32 i = 0; i < rotation.count; ++i)
+	{
+		const SControllerTrack& track = rotation.tracks[i];
+		const uint32 keys[2] = { rotation.key0[i], rotation.key1[i] };
+		for (uint32 k = 0; k < 2; ++k)
+		{
+			const uint32 slot = i + k * kChunkSize;
+#if CRY_PLATFORM_SSE2
+			if (track.compression == eSmallTree48BitQuat)
+			{
+				batch48.pKeys[batch48.count] = static_cast<const SmallTree48BitQuat*>(track.pKeys) + keys[k];
+				batch48.slots[batch48.count++] = slot;
+				continue;
+			}
+			if (track.compression == eSmallTree64BitExtQuat)
+			{
+				batch64Ext.pKeys[batch64Ext.count] = static_cast<const SmallTree64BitExtQuat*>(track.pKeys) + keys[k];
+				batch64Ext.slots[batch64Ext.count++] = slot;
+				continue;
+			}
+#endif
+			Quat q;
+			DecodeRotationKey(track.compression, track.pKeys, keys[k], q);
+			chunk.SetKey(slot, q);
+		}
+	}
+
+#if CRY_PLATFORM_SSE2
+	SKeyBatch* batches[2] = { &batch48, &batch64Ext };
+	for (uint32 b = 0; b < 2; ++b)
+	{
+		SKeyBatch& batch = *batches[b];
+		if (batch.count == 0)
+			continue;
+
+		// pad the last group by repeating the last key, the padded lanes aren't written back
+		const uint32 numPadded = (batch.count + 3) & ~3;
+		for (uint32 i = batch.count; i < numPadded; ++i)
+			batch.pKeys[i] = batch.pKeys[batch.count - 1];
+
+		for (uint32 i = 0; i < numPadded; i += 4)
+		{
+			CRY_ALIGN(16) f32 x[4], y[4], z[4], w[4];
+			__m128 vx, vy, vz, vw;
+			if (b == 0)
+				DecodeSmallTree48BitQuat4(&batch.pKeys[i], vx, vy, vz, vw);
+			else
+				DecodeSmallTree64BitExtQuat4(&batch.pKeys[i], vx, vy, vz, vw);
+			_mm_store_ps(x, vx);
+			_mm_store_ps(y, vy);
+			_mm_store_ps(z, vz);
+			_mm_store_ps(w, vw);
+
+			const uint32 numLanes = min<uint32>(batch.count - i, 4);
+			for (uint32 l = 0; l < numLanes; ++l)
+			{
+				const uint32 slot = batch.slots[i + l];
+				chunk.qx[slot] = x[l];
+				chunk.qy[slot] = y[l];
+				chunk.qz[slot] = z[l];
+				chunk.qw[slot] = w[l];
+			}
+		}
+	}
+
+	// nlerp four tracks at a time, padding lanes get identity keys
+	const uint32 numPadded = (rotation.count + 3) & ~3;
+	for (uint32 i = rotation.count; i < numPadded; ++i)
+	{
+		chunk.SetKey(i, Quat(IDENTITY));
+		chunk.SetKey(i + kChunkSize, Quat(IDENTITY));
+		rotation.blend[i] = 0.0f;
+	}
+
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	for (uint32 i = 0; i < numPadded; i += 4)
+	{
+		const __m128 x0 = _mm_load_ps(&chunk.qx[i]);
+		const __m128 y0 = _mm_load_ps(&chunk.qy[i]);
+		const __m128 z0 = _mm_load_ps(&chunk.qz[i]);
+		const __m128 w0 = _mm_load_ps(&chunk.qw[i]);
+		__m128 x1 = _mm_load_ps(&chunk.qx[i + kChunkSize]);
+		__m128 y1 = _mm_load_ps(&chunk.qy[i + kChunkSize]);
+		__m128 z1 = _mm_load_ps(&chunk.qz[i + kChunkSize]);
+		__m128 w1 = _mm_load_ps(&chunk.qw[i + kChunkSize]);
+		const __m128 t = _mm_load_ps(&rotation.blend[i]);
+
+		// take the shortest path, as Quat::SetNlerp() does
+		const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_add_ps(_mm_mul_ps(z0, z1), _mm_mul_ps(w0, w1)));
+		const __m128 sign = _mm_and_ps(dot, signMask);
+		x1 = _mm_xor_ps(x1, sign);
+		y1 = _mm_xor_ps(y1, sign);
+		z1 = _mm_xor_ps(z1, sign);
+		w1 = _mm_xor_ps(w1, sign);
+
+		const __m128 s = _mm_sub_ps(one, t);
+		const __m128 x = _mm_add_ps(_mm_mul_ps(x0, s), _mm_mul_ps(x1, t));
+		const __m128 y = _mm_add_ps(_mm_mul_ps(y0, s), _mm_mul_ps(y1, t));
+		const __m128 z = _mm_add_ps(_mm_mul_ps(z0, s), _mm_mul_ps(z1, t));
+		const __m128 w = _mm_add_ps(_mm_mul_ps(w0, s), _mm_mul_ps(w1, t));
+
+		const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+		const __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+
+		_mm_store_ps(&chunk.qx[i], _mm_mul_ps(x, invLength));
+		_mm_store_ps(&chunk.qy[i], _mm_mul_ps(y, invLength));
+		_mm_store_ps(&chunk.qz[i], _mm_mul_ps(z, invLength));
+		_mm_store_ps(&chunk.qw[i], _mm_mul_ps(w, invLength));
+	}
+#else
+	for (uint32 i = 0; i < rotation.count; ++i)
+	{
+		const Quat q0(chunk.qw[i], chunk.qx[i], chunk.qy[i], chunk.qz[i]);
+		const uint32 j = i + kChunkSize;
+		const Quat q1(chunk.qw[j], chunk.qx[j], chunk.qy[j], chunk.qz[j]);
+		Quat q;
+		q.SetNlerp(q0, q1, rotation.blend[i]);
+		chunk.SetKey(i, q);
+	}
+#endif
+
+	for (uint32 i = 0; i < rotation.count; ++i)
+	{
+		pPoses[rotation.joints[i]].q = Quat(chunk.qw[i], chunk.qx[i], chunk.qy[i], chunk.qz[i]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CControllerBatchSampler::SampleVectors(const STrackSet& tracks, Vec3* pResult)
+{
+	for (uint32 i = 0; i < tracks.count; ++i)
+	{
+		const SControllerTrack& track = tracks.tracks[i];
+
+		// uncompressed keys are the only position format, other ones are sampled as zero like in GetOPS()
+		if (track.compression != eNoCompressVec3 && track.compression != eNoCompress)
+		{
+			pResult[i] = Vec3(ZERO);
+			continue;
+		}
+
+		const NoCompressVec3* pKeys = static_cast<const NoCompressVec3*>(track.pKeys);
+		Vec3 p0, p1;
+		pKeys[tracks.key0[i]].ToExternalType(p0);
+		pKeys[tracks.key1[i]].ToExternalType(p1);
+		pResult[i].SetLerp(p0, p1, tracks.blend[i]);
+	}
+}
@@ -0,0 +1,33 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#pragma once
+
+#include "Controller.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Samples the controllers of all joints of an animation at the same key time.
+// Instead of the virtual GetOPS() call chain per joint, every controller is asked once for
+// its raw tracks (IController::GetTracks). Key lookup, dequantization and interpolation then
+// run over structure-of-arrays buffers, with the small-tree quaternion formats decoded four
+// keys at a time on SSE2 platforms.
+// The results match GetOPS(): the same key selection is used and rotations are nlerp'ed.
+//////////////////////////////////////////////////////////////////////////////////////////
+class CControllerBatchSampler
+{
+public:
+	// Samples all non-null controllers at keyTime.
+	// pPoses and pScales have to be initialized by the caller, tracks which don't exist leave them untouched.
+	// pStates receives the joint state per controller (0 for null controllers).
+	static void Sample(const IController* const* pControllers, uint32 numControllers, f32 keyTime, QuatT* pPoses, float* pScales, JointState* pStates);
+
+private:
+	enum { kChunkSize = 64 };
+
+	struct STrackSet;
+	struct SChunk;
+
+	static void SampleChunk(const IController* const* pControllers, uint32 numControllers, f32 keyTime, QuatT* pPoses, float* pScales, JointState* pStates);
+	static void FindKeys(STrackSet& tracks, f32 keyTime);
+	static void SampleRotations(SChunk& chunk, QuatT* pPoses);
+	static void SampleVectors(const STrackSet& tracks, Vec3* pResult);
+};
@@ -173,6 +173,142 @@ public:
 
 };
 
+namespace ControllerHelper
+{
+// key lookup shared by ControllerData and CControllerBatchSampler
+template<typename Type>
+inline uint32 GetKeyFromTimes(const Type* data, uint32 numKey, f32 normalized_time, f32& difference_time)
+{
+	f32 realtimef = normalized_time;
+	Type realtime = (Type)realtimef;
+
+	Type keytime_start = data[0];
+	Type keytime_end = data[numKey - 1];
+
+	if (realtime < keytime_start)
+	{
+		return 0;
+	}
+
+	if (realtime >= keytime_end)
+	{
+		return numKey;
+	}
+
+	//-------------
+	int nPos = numKey >> 1;
+	int nStep = numKey >> 2;
+
+	// use binary search
+	//TODO: Need check efficiency of []operator. Maybe wise use pointer
+	while (nStep)
+	{
+		if (realtime < data[nPos])
+			nPos = nPos - nStep;
+		else if (realtime > data[nPos])
+			nPos = nPos + nStep;
+		else
+			break;
+
+		nStep = nStep >> 1;
+	}
+
+	// fine-tuning needed since time is not linear
+	while (realtime >= data[nPos])
+		nPos++;
+
+	while (realtime < data[nPos - 1])
+		nPos--;
+
+	// possible error if encoder uses nonlinear methods!!!
+	if (data[nPos] == data[nPos - 1])
+	{
+		difference_time = 0.0f;
+	}
+	else
+	{
+		f32 prevtime = (f32)data[nPos - 1];
+		f32 time = (f32)data[nPos];
+		difference_time = (realtimef - prevtime) / (time - prevtime);
+	}
+
+	assert(difference_time >= 0.0f && difference_time <= 1.0f);
+	return nPos;
+}
+
+// pData points to the bitset header (start, end, size) followed by the bits
+inline uint32 GetKeyFromBitset(const uint16* pData, f32 normalized_time, f32& difference_time)
+{
+	f32 realtime = normalized_time;
+
+	uint32 numKey = (uint32)pData[2];
+
+	f32 keytime_start = (float)pData[0];
+	f32 keytime_end = (float)pData[1];
+
+	if (realtime < keytime_start)
+	{
+		difference_time = 0;
+		return 0;
+	}
+
+	if (realtime >= keytime_end)
+	{
+		difference_time = 0;
+		return numKey;
+	}
+
+	const uint16* pBits = pData + 3;
+
+	f32 internalTime = realtime - keytime_start;
+	uint16 uTime = (uint16)internalTime;
+	uint16 piece = (uTime / sizeof(uint16)) >> 3;
+	uint16 bit = /*15 - */ (uTime % 16);
+	uint16 data = pBits[piece];
+
+	//left
+	uint16 left = data & (0xFFFF >> (15 - bit));
+	uint16 leftPiece(piece);
+	uint16 nearestLeft = 0;
+	uint16 wBit;
+
+	while ((wBit = GetFirstHighBit(left)) == 16)
+	{
+		--leftPiece;
+		left = pBits[leftPiece];
+	}
+	nearestLeft = leftPiece * 16 + wBit;
+
+	//right
+	uint16 right = ((data >> (bit + 1)) & 0xFFFF) << (bit + 1);
+	uint16 rigthPiece(piece);
+	uint16 nearestRight = 0;
+
+	while ((wBit = GetFirstLowBit(right)) == 16)
+	{
+		++rigthPiece;
+		right = pBits[rigthPiece];
+	}
+
+	nearestRight = ((rigthPiece * sizeof(uint16)) << 3) + wBit;
+	difference_time = (f32)(internalTime - (f32)nearestLeft) / ((f32)nearestRight - (f32)nearestLeft);
+
+	// count nPos
+	uint32 nPos(0);
+	for (uint16 i = 0; i < rigthPiece; ++i)
+	{
+		uint16 data2 = pBits[i];
+		nPos += ControllerHelper::m_byteTable[data2 & 255] + ControllerHelper::m_byteTable[data2 >> 8];
+	}
+
+	data = pBits[rigthPiece];
+	data = ((data << (15 - wBit)) & 0xFFFF) >> (15 - wBit);
+	nPos += ControllerHelper::m_byteTable[data & 255] + ControllerHelper::m_byteTable[data >> 8];
+
+	return nPos - 1;
+}
+}
+
 // forward declarations
 struct ControllerData;
 static uint32 GetKeySelector(f32 normalized_time, f32& difference_time, const ControllerData& rConData);
@@ -208,138 +344,12 @@ struct ControllerData
 	template<typename Type>
 	uint32 GetKeyByteData(f32 normalized_time, f32& difference_time, const void* p_data) const
 	{
-		const Type* data = reinterpret_cast<const Type*>(p_data);
-
-		f32 realtimef = normalized_time;
-		Type realtime = (Type)realtimef;
-
-		uint32 numKey = GetNumCount();
-
-		Type keytime_start = data[0];
-		Type keytime_end = data[numKey - 1];
-
-		if (realtime < keytime_start)
-		{
-			return 0;
-		}
-
-		if (realtime >= keytime_end)
-		{
-			return numKey;
-		}
-
-		//-------------
-		int nPos = numKey >> 1;
-		int nStep = numKey >> 2;
-
-		// use binary search
-		//TODO: Need check efficiency of []operator. Maybe wise use pointer
-		while (nStep)
-		{
-			if (realtime < data[nPos])
-				nPos = nPos - nStep;
-			else if (realtime > data[nPos])
-				nPos = nPos + nStep;
-			else
-				break;
-
-			nStep = nStep >> 1;
-		}
-
-		// fine-tuning needed since time is not linear
-		while (realtime >= data[nPos])
-			nPos++;
-
-		while (realtime < data[nPos - 1])
-			nPos--;
-
-		// possible error if encoder uses nonlinear methods!!!
-		if (data[nPos] == data[nPos - 1])
-		{
-			difference_time = 0.0f;
-		}
-		else
-		{
-			f32 prevtime = (f32)data[nPos - 1];
-			f32 time = (f32)data[nPos];
-			difference_time = (realtimef - prevtime) / (time - prevtime);
-		}
-
-		assert(difference_time >= 0.0f && difference_time <= 1.0f);
-		return nPos;
+		return ControllerHelper::GetKeyFromTimes(reinterpret_cast<const Type*>(p_data), GetNumCount(), normalized_time, difference_time);
 	}
 
 	uint32 GetKeyBitData(f32 normalized_time, f32& difference_time) const
 	{
-		f32 realtime = normalized_time;
-
-		uint32 numKey = (uint32)GetHeader()->m_Size;//m_arrKeys.size();
-
-		f32 keytime_start = (float)GetHeader()->m_Start;
-		f32 keytime_end = (float)GetHeader()->m_End;
-		f32 test_end = keytime_end;
-
-		if (realtime < keytime_start)
-			test_end += realtime;
-
-		if (realtime < keytime_start)
-		{
-			difference_time = 0;
-			return 0;
-		}
-
-		if (realtime >= keytime_end)
-		{
-			difference_time = 0;
-			return numKey;
-		}
-
-		f32 internalTime = realtime - keytime_start;
-		uint16 uTime = (uint16)internalTime;
-		uint16 piece = (uTime / sizeof(uint16)) >> 3;
-		uint16 bit = /*15 - */ (uTime % 16);
-		uint16 data = GetKeyData(piece);
-
-		//left
-		uint16 left = data & (0xFFFF >> (15 - bit));
-		uint16 leftPiece(piece);
-		uint16 nearestLeft = 0;
-		uint16 wBit;
-
-		while ((wBit = GetFirstHighBit(left)) == 16)
-		{
-			--leftPiece;
-			left = GetKeyData(leftPiece);
-		}
-		nearestLeft = leftPiece * 16 + wBit;
-
-		//right
-		uint16 right = ((data >> (bit + 1)) & 0xFFFF) << (bit + 1);
-		uint16 rigthPiece(piece);
-		uint16 nearestRight = 0;
-
-		while ((wBit = GetFirstLowBit(right)) == 16)
-		{
-			++rigthPiece;
-			right = GetKeyData(rigthPiece);
-		}
-
-		nearestRight = ((rigthPiece * sizeof(uint16)) << 3) + wBit;
-		difference_time = (f32)(internalTime - (f32)nearestLeft) / ((f32)nearestRight - (f32)nearestLeft);
-
-		// count nPos
-		uint32 nPos(0);
-		for (uint16 i = 0; i < rigthPiece; ++i)
-		{
-			uint16 data2 = GetKeyData(i);
-			nPos += ControllerHelper::m_byteTable[data2 & 255] + ControllerHelper::m_byteTable[data2 >> 8];
-		}
-
-		data = GetKeyData(rigthPiece);
-		data = ((data << (15 - wBit)) & 0xFFFF) >> (15 - wBit);
-		nPos += ControllerHelper::m_byteTable[data & 255] + ControllerHelper::m_byteTable[data >> 8];
-
-		return nPos - 1;
+		return ControllerHelper::GetKeyFromBitset(reinterpret_cast<const uint16*>(GetData()), normalized_time, difference_time);
 	}
 
 	// util functions for bitset encoding
@@ -377,6 +387,22 @@ struct ControllerData
 		pSizer->AddObject(this, sizeof(*this));
 	}
 
+	void GetTrack(SControllerTrack& track) const
+	{
+		track.keyTimesFormat = m_eTimeFormat;
+		track.compression = m_eCompressionType;
+		if (getTimeFormat() == eNoFormat)
+		{
+			track.pKeyTimes = nullptr;
+			track.pKeys = nullptr;
+			track.numKeys = 0;
+			return;
+		}
+		track.pKeyTimes = GetData();
+		track.pKeys = GetKeys();
+		track.numKeys = (uint32)GetNumCount();
+	}
+
 	// Data will be within same allocation as controllers, so offsets ought to be less than 2gb away
 	int32  m_nDataOffs;
 	int32  m_nKeysOffs;
@@ -628,7 +654,15 @@ public:
 	virtual size_t GetPositionKeysNum() const override     { return m_position.GetNumCount(); }
 	virtual size_t GetScaleKeysNum() const override        { return 0; }
 
-	virtual void   GetMemoryUsage(ICrySizer* pSizer) const {}
+	virtual bool   GetTracks(SControllerTrack& rotation, SControllerTrack& position, SControllerTrack& scale) const override
+	{
+		m_rotation.GetTrack(rotation);
+		m_position.GetTrack(position);
+		scale.keyTimesFormat = eNoFormat;
+		return true;
+	}
+
+	virtual void GetMemoryUsage(ICrySizer* pSizer) const {}
 
 private:
 	ControllerData m_rotation;
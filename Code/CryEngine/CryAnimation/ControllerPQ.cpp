@@ -421,6 +421,36 @@ size_t CController::ApproximateSizeOfThis() const
 	return SizeOfController();
 }
 
+static bool GetTrackInformation(ITrackInformation* pTrack, uint32 compression, SControllerTrack& track)
+{
+	if (!pTrack)
+	{
+		track.keyTimesFormat = eNoFormat;
+		return true;
+	}
+
+	// start/stop key times are computed rather than stored, the batched sampler doesn't handle them
+	IKeyTimesInformation* pKeyTimes = pTrack->GetKeyTimesInformation();
+	const uint32 keyTimesFormat = pKeyTimes->GetFormat();
+	if (keyTimesFormat != eF32 && keyTimesFormat != eUINT16 && keyTimesFormat != eByte && keyTimesFormat != eBitset)
+		return false;
+
+	track.pKeyTimes = pKeyTimes->GetData();
+	track.pKeys = pTrack->GetData();
+	track.numKeys = pKeyTimes->GetNumKeys();
+	track.keyTimesFormat = (uint8)keyTimesFormat;
+	track.compression = (uint8)compression;
+	return track.numKeys != 0;
+}
+
+bool CController::GetTracks(SControllerTrack& rotation, SControllerTrack& position, SControllerTrack& scale) const
+{
+	return
+	  GetTrackInformation(m_pRotationController, m_pRotationController ? m_pRotationController->GetFormat() : eNoCompress, rotation) &&
+	  GetTrackInformation(m_pPositionController, m_pPositionController ? m_pPositionController->GetFormat() : eNoCompress, position) &&
+	  GetTrackInformation(m_pScaleController, m_pScaleController ? m_pScaleController->GetFormat() : eNoCompress, scale);
+}
+
 #if CRY_PLATFORM_SSE2 && !defined(_DEBUG)
 __m128 SmallTree48BitQuat::div;
 __m128 SmallTree48BitQuat::ran;
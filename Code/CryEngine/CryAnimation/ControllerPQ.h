@@ -1210,6 +1210,7 @@ public:
 	virtual size_t     GetScaleKeysNum() const override;
 	virtual size_t     SizeOfController() const override;
 	virtual size_t     ApproximateSizeOfThis() const override;
+	virtual bool       GetTracks(SControllerTrack& rotation, SControllerTrack& position, SControllerTrack& scale) const override;
 	//////////////////////////////////////////////////////////////////////////
 
 	// TODO: Would be nice to introduce some ownership semantics on the Set*Controller methods instead of using a raw pointer (all of these are a raw pointer typedef at the time of writing).
@@ -220,6 +220,7 @@ void Console::Init()
 
 	//sampling
 	DefineConstIntCVar(ca_SampleQuatHemisphereFromCurrentPose, 0, VF_NULL, "For override animation sampling, use current pose for quat hemisphere sign");
+	DefineConstIntCVar(ca_SampleBatched, 1, VF_NULL, "Sample all joints of an animation in one batch instead of calling each controller separately");
 
 	DefineConstIntCVar(ca_DrawCloth, 1, VF_CHEAT, "bitfield: 2 shows particles, 4 shows proxies, 6 shows both");
 	DefineConstIntCVar(ca_ClothBlending, 1, VF_CHEAT, "if this is 0 blending with animation is disabled");
@@ -124,6 +124,7 @@ struct CRY_ALIGN(128) Console
 	DeclareConstIntCVar(ca_DisableAnimationUnloading, 0);
 	DeclareConstIntCVar(ca_PreloadAllCAFs, 0);
 	DeclareConstIntCVar(ca_SampleQuatHemisphereFromCurrentPose, 0);
+	DeclareConstIntCVar(ca_SampleBatched, 1);
 
 #if USE_FACIAL_ANIMATION_FRAMERATE_LIMITING
 	DeclareConstIntCVar(ca_FacialAnimationFramerate, 20);
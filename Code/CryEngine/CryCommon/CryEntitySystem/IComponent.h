@@ -48,6 +48,7 @@ public:
 		EComponentFlags_Enable           = BIT(1),
 		EComponentFlags_Disable          = BIT(2),
 		EComponentFlags_LazyRegistration = BIT(3),
+		EComponentFlags_ThreadSafeUpdate = BIT(4), //!< Update only touches the own entity and may run on a job, see es_UpdateEntitiesInParallel.
 	};
 	typedef int             ComponentEventPriority;
 	typedef CCryFlags<uint> ComponentFlags;
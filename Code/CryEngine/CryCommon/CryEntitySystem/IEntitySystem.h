@@ -476,6 +476,13 @@ struct IEntitySystem
 	//! \param event Event to send.
 	virtual void SendEventViaEntityEvent(IEntity* piEntity, SEntityEvent& event) = 0;
 
+	//! Sends an event to another entity from within a thread safe entity update.
+	//! During the parallel entity update the event is queued and sent on the main thread once all entities were updated,
+	//! otherwise it is sent immediately.
+	//! \param entityId Id of the entity to receive the event.
+	//! \param event    Event to send, pointers in its parameters have to stay valid until the end of the entity update.
+	virtual void QueueEntityEvent(EntityId entityId, const SEntityEvent& event) = 0;
+
 	//! Get all entities within proximity of the specified bounding box.
 	//! \note Query is not exact, entities reported can be a few meters away from the bounding box.
 	virtual int QueryProximity(SEntityProximityQuery& query) = 0;
@@ -15,6 +15,7 @@
 		#define BUCKET_ALLOCATOR_FILL_ALLOCS
 		#define BUCKET_ALLOCATOR_CHECK_DEALLOCATE_ADDRESS
 		#define BUCKET_ALLOCATOR_TRACK_CONSUMED
+		#define BUCKET_ALLOCATOR_TRACK_BUCKET_STATS
 		#define BUCKET_ALLOCATOR_TRAP_BAD_SIZE_ALLOCS
 	#endif
 
@@ -216,6 +217,10 @@ public:
 			CryInterlockedAdd(&m_consumed, -(int)sz);
 	#endif
 
+	#ifdef BUCKET_ALLOCATOR_TRACK_BUCKET_STATS
+			CryInterlockedDecrement(&m_bucketLiveCount[bucket]);
+	#endif
+
 			this->PushOnto(m_freeLists[bucket * NumGenerations + generation], reinterpret_cast<AllocHeader*>(ptr));
 			m_bucketTouched[bucket] = 1;
 		}
@@ -288,6 +293,18 @@ public:
 	size_t GetBucketStoragePages();
 	size_t GetBucketConsumedSize();
 
+	struct BucketStats
+	{
+		size_t itemSize;
+		uint32 liveCount;  //!< Items currently allocated.
+		uint32 allocCount; //!< Allocations since start, wraps around.
+	};
+
+	//! Fills one entry per size class (bucket) and returns the number of entries written.
+	//! The counts are only tracked with BUCKET_ALLOCATOR_TRACK_BUCKET_STATS, they are zero otherwise.
+	size_t GetBucketStats(BucketStats* pStats, size_t maxCount);
+	static size_t GetNumBuckets() { return NumBuckets; }
+
 	void   cleanup();
 
 	void   EnableExpandCleanups(bool enable)
@@ -515,6 +532,14 @@ private:
 		CryInterlockedAdd(&m_consumed, TraitsT::GetSizeForBucket(TraitsT::GetBucketForSize(sz)));
 	#endif // BUCKET_ALLOCATOR_TRACK_CONSUMED
 
+	#ifdef BUCKET_ALLOCATOR_TRACK_BUCKET_STATS
+		if (ptr)
+		{
+			CryInterlockedIncrement(&m_bucketLiveCount[bucket]);
+			CryInterlockedIncrement(&m_bucketAllocCount[bucket]);
+		}
+	#endif // BUCKET_ALLOCATOR_TRACK_BUCKET_STATS
+
 		return ptr;
 	}
 
@@ -636,6 +661,11 @@ private:
 	volatile int m_consumed;
 	#endif
 
+	#ifdef BUCKET_ALLOCATOR_TRACK_BUCKET_STATS
+	volatile int m_bucketLiveCount[NumBuckets];
+	volatile int m_bucketAllocCount[NumBuckets];
+	#endif
+
 	int m_disableExpandCleanups;
 	int m_cleanupOnDestruction;
 };
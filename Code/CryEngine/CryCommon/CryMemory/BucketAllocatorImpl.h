@@ -1030,6 +1030,24 @@ size_t BucketAllocator<TraitsT >::GetBucketConsumedSize()
 	#endif
 }
 
+template<typename TraitsT>
+size_t BucketAllocator<TraitsT >::GetBucketStats(BucketStats* pStats, size_t maxCount)
+{
+	size_t count = min((size_t)NumBuckets, maxCount);
+	for (size_t i = 0; i < count; ++i)
+	{
+		pStats[i].itemSize = TraitsT::GetSizeForBucket((uint8)i);
+	#ifdef BUCKET_ALLOCATOR_TRACK_BUCKET_STATS
+		pStats[i].liveCount = (uint32)m_bucketLiveCount[i];
+		pStats[i].allocCount = (uint32)m_bucketAllocCount[i];
+	#else
+		pStats[i].liveCount = 0;
+		pStats[i].allocCount = 0;
+	#endif
+	}
+	return count;
+}
+
 	#if CRY_PLATFORM_WINAPI
 
 inline UINT_PTR BucketAllocatorDetail::SystemAllocator::ReserveAddressSpace(size_t numPages, size_t pageLen)
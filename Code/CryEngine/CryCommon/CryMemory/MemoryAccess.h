@@ -44,6 +44,9 @@ extern int g_CpuFlags;
 #define CPUF_3DNOW 0x04
 #define CPUF_MMX   0x08
 #define CPUF_SSE3  0x10
+#define CPUF_AVX   0x20 // AVX with the OS saving the ymm registers
+#define CPUF_AVX2  0x40
+#define CPUF_AVX512 0x80 // AVX-512F with the OS saving the zmm registers
 
 #if CRY_PLATFORM_SSE2
 	#if CRY_PLATFORM_X86 || CRY_PLATFORM_X64
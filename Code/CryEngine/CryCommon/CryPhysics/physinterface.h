@@ -2800,6 +2800,9 @@ struct PhysicsVars : SolverSettings
 	int   numThreads;
 	int   physCPU;
 	int   physWorkerCPU;
+	int   bJobSystemStep;
+	int   jobSystemStepMinCost;
+	int   bRwiBatchPackets;
 	Vec3  helperOffset;
 	int64 ticksPerSecond;
 	// net-synchronization related
@@ -3296,6 +3299,11 @@ struct IPhysicalWorld
 	virtual int GetEntitiesInBox(Vec3 ptmin, Vec3 ptmax, IPhysicalEntity**& pList, int objtypes, int szListPrealloc = 0) = 0;
 
 	virtual int RayWorldIntersection(const SRWIParams& rp, const char* pNameTag = RWI_NAME_TAG, int iCaller = MAX_PHYS_THREADS) = 0;
+	//! Traces a batch of rays synchronously (rwi_queue is ignored), in an order that keeps consecutive rays in the same entity grid cells
+	//! with PhysicsVars::bRwiBatchPackets, neighbouring rays (without phitLast) walk the entity grid together as packets
+	//! hits of ray i are written to pHits after the nMaxHits slots of rays 0..i-1 (SRWIParams::hits is ignored), pNumHits[i] receives its hit count
+	//! returns the total number of hits
+	virtual int RayWorldIntersectionBatch(const SRWIParams* pRays, int nRays, ray_hit* pHits, int* pNumHits, const char* pNameTag = RWI_NAME_TAG, int iCaller = MAX_PHYS_THREADS) = 0;
 	//! Traces ray requests (rwi calls with rwi_queue set); logs and calls EventPhysRWIResult for each
 	//! returns the number of rays traced
 	virtual int  TracePendingRays(int bDoActualTracing = 1) = 0;
@@ -353,6 +353,9 @@ struct IScriptSystem
 	//! \note In the current status of the engine the automatic GC is disabled so this function must be called explicitly.
 	virtual void ForceGarbageCollection() = 0;
 
+	//! Runs incremental garbage collection for up to timeMs, for time the frame would otherwise wait.
+	virtual void CollectGarbageIdle(float timeMs) = 0;
+
 	//! Gets number of "garbaged" object.
 	virtual int GetCGCount() = 0;
 
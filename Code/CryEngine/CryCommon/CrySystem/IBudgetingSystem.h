@@ -3,6 +3,19 @@
 #ifndef _I_BUDGETING_SYSTEM_
 #define _I_BUDGETING_SYSTEM_
 
+//! Stages of a dedicated server frame, in the order they are first executed.
+//! Game rules and entity time is also spent again after AI, it adds to the same stages.
+enum EServerFrameStage
+{
+	eSFS_NetworkReceive,
+	eSFS_GameRules,
+	eSFS_Entity,
+	eSFS_Physics,
+	eSFS_AI,
+	eSFS_NetworkSend,
+	eSFS_Count
+};
+
 struct IBudgetingSystem
 {
 	// <interfuscator:shuffle>
@@ -16,6 +29,7 @@ struct IBudgetingSystem
 	virtual void SetNumDrawCallsLimit(int numDrawCallsLimit) = 0;
 	virtual void SetStreamingThroughputLimit(float streamingThroughputLimit) = 0;
 	virtual void SetBudget(int sysMemLimitInMB, int videoMemLimitInMB, float frameTimeLimitInMS, int soundChannelsPlayingLimit, int SoundMemLimitInMB, int SoundCPULimit, int numDrawCallsLimit) = 0;
+	virtual void SetServerFrameStageLimit(EServerFrameStage stage, float stageTimeLimitInMS) = 0;
 
 	// get budget
 	virtual int   GetSysMemLimit() const = 0;
@@ -27,6 +41,7 @@ struct IBudgetingSystem
 	virtual int   GetNumDrawCallsLimit() const = 0;
 	virtual float GetStreamingThroughputLimit() const = 0;
 	virtual void  GetBudget(int& sysMemLimitInMB, int& videoMemLimitInMB, float& frameTimeLimitInMS, int& soundChannelsPlayingLimit, int& SoundMemLimitInMB, int& SoundCPULimitInPercent, int& numDrawCallsLimit) const = 0;
+	virtual float GetServerFrameStageLimit(EServerFrameStage stage) const = 0;
 
 	// monitoring
 	virtual void MonitorBudget() = 0;
@@ -288,6 +288,13 @@ struct IConsole
 	//! \see ICVar.
 	virtual ICVar* GetCVar(const char* name) = 0;
 
+	//! Retrieve the slot of a console variable name - not case sensitive.
+	//! The slot holds the variable registered with the name, or NULL while there is none, and stays valid as long as the console.
+	//! Code looking up a variable often should keep the slot instead of calling GetCVar.
+	//! Can be called from any thread, the slot is created under a lock if the name was never seen before.
+	//! \see CCVarHandle.
+	virtual ICVar* const* GetCVarSlot(const char* name) = 0;
+
 	//! Read a value from a configuration file (.ini) and return the value.
 	//! \param szVarName Variable name.
 	//! \param szFileName Source configuration file.
@@ -591,6 +598,35 @@ struct ICVar
 #endif
 };
 
+//! Cached lookup of a console variable, stays valid when the variable is unregistered and registered again.
+//! Example: static CCVarHandle<float> s_timeScale(gEnv->pConsole, "t_Scale"); float scale = s_timeScale.Get(1.0f);
+//! \note T is int, int64, float or const char*.
+template<typename T>
+class CCVarHandle
+{
+public:
+	CCVarHandle() : m_ppCVar(NULL) {}
+	CCVarHandle(IConsole* pConsole, const char* szName) : m_ppCVar(pConsole->GetCVarSlot(szName)) {}
+
+	//! \return The variable, NULL if it isn't registered right now.
+	ICVar* GetCVar() const { return m_ppCVar ? *m_ppCVar : NULL; }
+
+	//! \return The value of the variable, defaultValue if it isn't registered right now.
+	T Get(T defaultValue = T()) const
+	{
+		const ICVar* pCVar = GetCVar();
+		return pCVar ? GetValue(pCVar, (T*)NULL) : defaultValue;
+	}
+
+private:
+	static int         GetValue(const ICVar* pCVar, int*)         { return pCVar->GetIVal(); }
+	static int64       GetValue(const ICVar* pCVar, int64*)       { return pCVar->GetI64Val(); }
+	static float       GetValue(const ICVar* pCVar, float*)       { return pCVar->GetFVal(); }
+	static const char* GetValue(const ICVar* pCVar, const char**) { return pCVar->GetString(); }
+
+	ICVar* const* m_ppCVar;
+};
+
 struct ScopedConsoleLoadConfigType
 {
 	ScopedConsoleLoadConfigType(IConsole* pConsole, ELoadConfigurationType configType)
@@ -456,6 +456,20 @@ struct CRY_ALIGN(16) SJobFrameStatsSummary
 	unsigned int nNumIndividualJobsExecuted;      //!< Total Number of individual jobs.
 };
 
+//! Per frame execution record of a job graph node, used to reconstruct the frame's job graph.
+struct SJobGraphNodeFrameStats
+{
+	const char* cpGraphName;          //!< Name of the graph the node belongs to.
+	const char* cpNodeName;           //!< Node name.
+	uint32      nGraphRunId;          //!< Run of the graph, to distinguish several runs of the same graph within a frame.
+	uint32      nStartTime;           //!< Start time sample in microseconds.
+	uint32      nEndTime;             //!< End time sample in microseconds.
+	uint16      nNodeIndex;           //!< Index of the node within its graph.
+	uint16      nReleasedByNodeIndex; //!< Predecessor which released the node (the last one to finish), 0xFFFF for root nodes.
+	uint8       nWorkerId;            //!< Worker which executed the node, 0xFF if it wasn't executed by a regular worker.
+	uint8       bContinuation;        //!< 1 if the node was run inline by the worker which released it.
+};
+
 SJobFrameStats::SJobFrameStats(const char* cpJobName) : usec(0), count(0), cpName(cpJobName), usecLast(0)
 {}
 
@@ -1005,6 +1019,9 @@ struct IJobManager
 
 	virtual void                           DumpJobList() = 0;
 
+	//! Print the job graphs executed during the last frame as graphviz dot to the log.
+	virtual void                           DumpJobGraph() = 0;
+
 	virtual void                           SetFrameStartTime(const CTimeValue& rFrameStartTime) = 0;
 };
 
@@ -1178,7 +1195,8 @@ public:
 	};
 
 public:
-	typedef DynArray<JobManager::SJobFrameStats> TJobFrameStatsContainer;
+	typedef DynArray<JobManager::SJobFrameStats>          TJobFrameStatsContainer;
+	typedef DynArray<JobManager::SJobGraphNodeFrameStats> TJobGraphFrameStatsContainer;
 
 public:
 	virtual ~IWorkerBackEndProfiler(){; }
@@ -1195,6 +1213,9 @@ public:
 	//! Record execution information for a registered job.
 	virtual void RecordJob(const uint16 profileIndex, const uint8 workerId, const uint32 jobId, const uint32 runTimeMicroSec) = 0;
 
+	//! Record the execution of a job graph node.
+	virtual void RecordGraphNode(const uint16 profileIndex, const SJobGraphNodeFrameStats& rNodeStats) = 0;
+
 	//! Get worker frame stats.
 	virtual void GetFrameStats(JobManager::CWorkerFrameStats& rStats) const = 0;
 	virtual void GetFrameStats(TJobFrameStatsContainer& rJobStats, EJobSortOrder jobSortOrder) const = 0;
@@ -1204,6 +1225,9 @@ public:
 	virtual void GetFrameStatsSummary(SWorkerFrameStatsSummary& rStats) const = 0;
 	virtual void GetFrameStatsSummary(SJobFrameStatsSummary& rStats) const = 0;
 
+	//! Get the job graph nodes executed during the frame, in order of completion.
+	virtual void GetFrameGraphStats(TJobGraphFrameStatsContainer& rNodeStats) const = 0;
+
 	//! Returns the index of the active multi-buffered profile data.
 	virtual uint16 GetProfileIndex() const = 0;
 
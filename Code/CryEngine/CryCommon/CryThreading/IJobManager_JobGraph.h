@@ -0,0 +1,275 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  File name:   IJobManager_JobGraph.h
+//  Version:     v1.00
+//  Compilers:   Visual Studio.NET
+//  Description: Job graph to express dependencies between jobs without blocking waits
+// -------------------------------------------------------------------------
+//  History:
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef IJOBMANAGER_JOBGRAPH_H_
+#define IJOBMANAGER_JOBGRAPH_H_
+
+#include <CryThreading/IJobManager.h>
+
+namespace JobManager
+{
+//! Directed acyclic graph of jobs.
+//! Each node keeps an atomic counter of unfinished predecessors, the predecessor which brings it to zero releases
+//! the node into the job queue, thus no worker ever blocks waiting for another job.
+//! If a finishing node releases several successors, one with the same priority is run inline on the same worker
+//! as continuation, the others are added as separate jobs.
+//! The graph is built once and can be run repeatedly, but only one run can be in flight at a time.
+//! Example:
+//!   CJobGraph graph("ParticleUpdate");
+//!   CJobGraph::TNodeId cull = graph.AddNode("Particles_Cull", [] { ... });
+//!   CJobGraph::TNodeId update = graph.AddNode("Particles_Update", [] { ... });
+//!   graph.AddDependency(cull, update);
+//!   graph.Run(&jobState);
+class CJobGraph
+{
+public:
+	typedef uint16 TNodeId;
+	enum { eInvalidNodeId = 0xFFFF };
+
+	explicit CJobGraph(const char* szName);
+	~CJobGraph();
+
+	//! Add a node, the name has to be a string literal as it is used for job registration and profiling.
+	TNodeId AddNode(const char* szNodeName, const std::function<void()>& callback, TPriorityLevel priority = JobManager::eRegularPriority);
+
+	//! Successor won't be started before predecessor finished.
+	void AddDependency(TNodeId predecessor, TNodeId successor);
+
+	//! Remove all nodes, the graph must not be running.
+	void Clear();
+
+	//! Start all nodes without predecessors.
+	//! If a job state is passed, it is set to running until the last node of the graph finished.
+	void Run(SJobState* pJobState = nullptr);
+
+	bool        IsRunning() const  { return m_nPendingNodes != 0; }
+	const char* GetName() const    { return m_szName; }
+	uint32      GetNumNodes() const { return (uint32)m_nodes.size(); }
+
+private:
+	struct SNode
+	{
+		std::function<void()> callback;
+		std::vector<TNodeId>  successors;
+		const char*           szName;
+		TPriorityLevel        priority;
+		uint16                nNumPredecessors;
+		volatile LONG         nPendingPredecessors;     // predecessors which didn't finish yet in the current run
+	};
+
+	void SubmitNode(TNodeId nodeId, TNodeId releasedById);
+	void ExecuteNodes(TNodeId nodeId, TNodeId releasedById);
+	bool IsAcyclic() const;
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	void RecordNode(TNodeId nodeId, TNodeId releasedById, bool bContinuation, uint32 nStartTime) const;
+#endif
+
+	std::vector<SNode> m_nodes;
+	const char*        m_szName;
+	SJobState*         m_pJobState;                     // job state of the current run, may be null
+	volatile LONG      m_nPendingNodes;                 // nodes of the current run which didn't finish yet
+	uint32             m_nRunId;                        // id of the current run, to group the nodes in the profiler
+};
+
+///////////////////////////////////////////////////////////////////////////////
+inline CJobGraph::CJobGraph(const char* szName)
+	: m_szName(szName)
+	, m_pJobState(nullptr)
+	, m_nPendingNodes(0)
+	, m_nRunId(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline CJobGraph::~CJobGraph()
+{
+	CRY_ASSERT_MESSAGE(!IsRunning(), "CJobGraph: graph destroyed while still running");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline CJobGraph::TNodeId CJobGraph::AddNode(const char* szNodeName, const std::function<void()>& callback, TPriorityLevel priority)
+{
+	CRY_ASSERT_MESSAGE(!IsRunning(), "CJobGraph: nodes can't be added while the graph is running");
+	CRY_ASSERT_MESSAGE(m_nodes.size() < eInvalidNodeId, "CJobGraph: too many nodes");
+
+	m_nodes.resize(m_nodes.size() + 1);
+	SNode& rNode = m_nodes.back();
+	rNode.callback = callback;
+	rNode.szName = szNodeName;
+	rNode.priority = priority;
+	rNode.nNumPredecessors = 0;
+	rNode.nPendingPredecessors = 0;
+	return (TNodeId)(m_nodes.size() - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline void CJobGraph::AddDependency(TNodeId predecessor, TNodeId successor)
+{
+	CRY_ASSERT_MESSAGE(!IsRunning(), "CJobGraph: dependencies can't be added while the graph is running");
+	CRY_ASSERT_MESSAGE(predecessor < m_nodes.size() && successor < m_nodes.size() && predecessor != successor, "CJobGraph: invalid dependency");
+
+	m_nodes[predecessor].successors.push_back(successor);
+	m_nodes[successor].nNumPredecessors++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline void CJobGraph::Clear()
+{
+	CRY_ASSERT_MESSAGE(!IsRunning(), "CJobGraph: graph can't be cleared while running");
+	m_nodes.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline void CJobGraph::Run(SJobState* pJobState)
+{
+	CRY_ASSERT_MESSAGE(!IsRunning(), "CJobGraph: only one run of a graph can be in flight");
+	CRY_ASSERT_MESSAGE(IsAcyclic(), string().Format("CJobGraph: graph %s contains a cycle and would never finish", m_szName));
+
+	if (m_nodes.empty())
+		return;
+
+	static volatile LONG s_nRunIdCounter = 0;
+	m_nRunId = (uint32)CryInterlockedIncrement(&s_nRunIdCounter);
+
+	// reset the counters before releasing the first node, each node finishing decrements m_nPendingNodes once
+	for (SNode& rNode : m_nodes)
+		rNode.nPendingPredecessors = rNode.nNumPredecessors;
+	m_pJobState = pJobState;
+	m_nPendingNodes = (LONG)m_nodes.size();
+	MemoryBarrier();
+
+	if (pJobState)
+		pJobState->SetRunning();
+
+	// collect the root nodes first, as a fast graph could finish while we're still iterating it
+	TNodeId* pRootNodes = (TNodeId*)alloca(m_nodes.size() * sizeof(TNodeId));
+	uint32 nNumRootNodes = 0;
+	for (uint32 i = 0; i < m_nodes.size(); ++i)
+	{
+		if (m_nodes[i].nNumPredecessors == 0)
+			pRootNodes[nNumRootNodes++] = (TNodeId)i;
+	}
+
+	for (uint32 i = 0; i < nNumRootNodes; ++i)
+		SubmitNode(pRootNodes[i], eInvalidNodeId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline void CJobGraph::SubmitNode(TNodeId nodeId, TNodeId releasedById)
+{
+	const SNode& rNode = m_nodes[nodeId];
+	gEnv->GetJobManager()->AddLambdaJob(rNode.szName, [this, nodeId, releasedById]() { ExecuteNodes(nodeId, releasedById); }, rNode.priority);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline void CJobGraph::ExecuteNodes(TNodeId nodeId, TNodeId releasedById)
+{
+	bool bContinuation = false;
+	while (nodeId != eInvalidNodeId)
+	{
+		const SNode& rNode = m_nodes[nodeId];
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+		const uint32 nStartTime = IWorkerBackEndProfiler::GetTimeSample();
+#endif
+
+		rNode.callback();
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+		RecordNode(nodeId, releasedById, bContinuation, nStartTime);
+#endif
+
+		// release successors, keep the first one with the same priority to run it as continuation
+		TNodeId continuationId = eInvalidNodeId;
+		for (TNodeId successorId : rNode.successors)
+		{
+			SNode& rSuccessor = m_nodes[successorId];
+			if (CryInterlockedDecrement(&rSuccessor.nPendingPredecessors) == 0)
+			{
+				if (continuationId == eInvalidNodeId && rSuccessor.priority == rNode.priority)
+					continuationId = successorId;
+				else
+					SubmitNode(successorId, nodeId);
+			}
+		}
+
+		// the owner may destroy the graph as soon as the last node finished, so don't touch any member afterwards
+		SJobState* pJobState = m_pJobState;
+		if (CryInterlockedDecrement(&m_nPendingNodes) == 0)
+		{
+			if (pJobState)
+				pJobState->SetStopped();
+			return;
+		}
+
+		releasedById = nodeId;
+		nodeId = continuationId;
+		bContinuation = true;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline bool CJobGraph::IsAcyclic() const
+{
+	// Kahn's algorithm, all nodes can be visited in topological order if there is no cycle
+	std::vector<uint16> pendingPredecessors(m_nodes.size());
+	std::vector<TNodeId> readyNodes;
+	for (uint32 i = 0; i < m_nodes.size(); ++i)
+	{
+		pendingPredecessors[i] = m_nodes[i].nNumPredecessors;
+		if (pendingPredecessors[i] == 0)
+			readyNodes.push_back((TNodeId)i);
+	}
+
+	uint32 nNumVisited = 0;
+	while (!readyNodes.empty())
+	{
+		const TNodeId nodeId = readyNodes.back();
+		readyNodes.pop_back();
+		++nNumVisited;
+		for (TNodeId successorId : m_nodes[nodeId].successors)
+		{
+			if (--pendingPredecessors[successorId] == 0)
+				readyNodes.push_back(successorId);
+		}
+	}
+	return nNumVisited == m_nodes.size();
+}
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+///////////////////////////////////////////////////////////////////////////////
+inline void CJobGraph::RecordNode(TNodeId nodeId, TNodeId releasedById, bool bContinuation, uint32 nStartTime) const
+{
+	// lambda jobs are executed by the thread backend, so its profiler holds the graph records
+	IBackend* pBackEnd = gEnv->GetJobManager()->GetBackEnd(eBET_Thread);
+	IWorkerBackEndProfiler* pWorkerProfiler = pBackEnd ? pBackEnd->GetBackEndWorkerProfiler() : nullptr;
+	if (!pWorkerProfiler)
+		return;
+
+	const uint32 nWorkerId = gEnv->GetJobManager()->GetWorkerThreadId();
+
+	SJobGraphNodeFrameStats nodeStats;
+	nodeStats.cpGraphName = m_szName;
+	nodeStats.cpNodeName = m_nodes[nodeId].szName;
+	nodeStats.nGraphRunId = m_nRunId;
+	nodeStats.nStartTime = nStartTime;
+	nodeStats.nEndTime = IWorkerBackEndProfiler::GetTimeSample();
+	nodeStats.nNodeIndex = nodeId;
+	nodeStats.nReleasedByNodeIndex = releasedById;
+	nodeStats.nWorkerId = (nWorkerId < 0xFF) ? (uint8)nWorkerId : 0xFF; // blocking workers carry a flag bit and end up as 0xFF too
+	nodeStats.bContinuation = bContinuation ? 1 : 0;
+	pWorkerProfiler->RecordGraphNode(pWorkerProfiler->GetProfileIndex(), nodeStats);
+}
+#endif
+
+} // namespace JobManager
+
+#endif // IJOBMANAGER_JOBGRAPH_H_
@@ -27,6 +27,7 @@ CAreaProxy::CAreaProxy()
 	, m_bIsEnableInternal(false)
 	, m_lastFrameTime(0.0f)
 {
+	IComponent::GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
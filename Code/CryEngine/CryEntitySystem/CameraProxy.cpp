@@ -19,6 +19,7 @@
 CCameraProxy::CCameraProxy()
 	: m_pEntity(NULL)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
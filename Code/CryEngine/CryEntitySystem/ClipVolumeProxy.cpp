@@ -12,6 +12,7 @@ CClipVolumeProxy::CClipVolumeProxy()
 	, m_pBspTree(NULL)
 	, m_nFlags(IClipVolume::eClipVolumeAffectedBySun)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 void CClipVolumeProxy::ProcessEvent(SEntityEvent& event)
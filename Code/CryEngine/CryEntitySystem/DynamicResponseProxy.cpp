@@ -9,6 +9,7 @@
 CDynamicResponseProxy::CDynamicResponseProxy()
 	: m_pResponseActor(nullptr)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -718,11 +718,20 @@ bool CEntity::Init(SEntitySpawnParams& params)
 
 //////////////////////////////////////////////////////////////////////////
 void CEntity::Update(SEntityUpdateContext& ctx)
+{
+	if (UpdateProxies(ctx))
+	{
+		SetUpdateStatus();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CEntity::UpdateProxies(SEntityUpdateContext& ctx)
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
 
 	if (m_bHidden && !CheckFlags(ENTITY_FLAG_UPDATE_HIDDEN))
-		return;
+		return false;
 
 	// Broadcast event to proxies.
 	// Start after render proxy.
@@ -736,11 +745,24 @@ void CEntity::Update(SEntityUpdateContext& ctx)
 
 	if (m_nUpdateCounter != 0)
 	{
-		if (--m_nUpdateCounter == 0)
-		{
-			SetUpdateStatus();
-		}
+		return --m_nUpdateCounter == 0;
 	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CEntity::CanUpdateInParallel() const
+{
+	for (TProxyContainer::const_iterator it = m_proxy.begin(); it != m_proxy.end(); ++it)
+	{
+		// the render proxy skips its update unless one of its slots needs it
+		if (it->first == ENTITY_PROXY_RENDER && !static_cast<const CRenderProxy*>(it->second.get())->CheckFlags(CRenderProxy::FLAG_UPDATE))
+			continue;
+
+		if (!it->second->GetFlags().AreAllFlagsActive(IComponent::EComponentFlags_ThreadSafeUpdate))
+			return false;
+	}
+	return true;
 }
 
 void CEntity::PrePhysicsUpdate(float fFrameTime)
@@ -87,6 +87,11 @@ public:
 	void PrePhysicsUpdate(float fFrameTime);
 	// Called by EntitySystem every frame for each active entity.
 	void Update(SEntityUpdateContext& ctx);
+	// Update of the proxies only, without changing the update status of the entity.
+	// Returns true if the entity was activated for a number of updates which ran out, SetUpdateStatus has to be called then.
+	bool UpdateProxies(SEntityUpdateContext& ctx);
+	// True if all proxies which need an update declared it as thread safe, the entity can be updated on a job then.
+	bool CanUpdateInParallel() const;
 	// Called by EntitySystem before entity is destroyed.
 	void ShutDown(bool bRemoveAI = true, bool bRemoveProxies = true);
 
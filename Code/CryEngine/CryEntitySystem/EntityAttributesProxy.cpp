@@ -13,6 +13,7 @@ void CEntityAttributesProxy::ProcessEvent(SEntityEvent& event) {}
 //////////////////////////////////////////////////////////////////////////
 void CEntityAttributesProxy::Initialize(SComponentInitializer const& inititializer)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 	if (m_attributes.empty())
 	{
 		if (IEntityArchetype* pArchetype = inititializer.m_pEntity->GetArchetype())
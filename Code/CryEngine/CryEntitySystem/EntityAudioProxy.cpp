@@ -18,6 +18,7 @@ CEntityAudioProxy::CEntityAudioProxy()
 	, m_fadeDistance(0.0f)
 	, m_environmentFadeDistance(0.0f)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 #include "EntitySystem.h"
 #include "AreaManager.h"
 #include "EntityPoolManager.h"
+#include "ProximityBroadphase.h"
 #include <CryAnimation/ICryAnimation.h>
 #include <CryEntitySystem/IComponent.h>
 #include "ComponentEventDistributer.h"
@@ -71,6 +72,9 @@ float CVar::es_MaxPhysDistCloth;
 float CVar::es_FarPhysTimeout;
 int CVar::es_DebugEvents = 0;
 int CVar::es_SortUpdatesByClass = 0;
+int CVar::es_UpdateEntitiesInParallel = 0;
+int CVar::es_ParallelUpdateBatchSize = 32;
+int CVar::es_ProximityTriggerBatchSize = 256;
 int CVar::es_debugEntityLifetime = 0;
 int CVar::es_DisableTriggers = 0;
 int CVar::es_DrawProximityTriggers = 0;
@@ -124,8 +128,20 @@ void CVar::Init(struct IConsole* pConsole)
 	REGISTER_COMMAND("es_AudioListenerOffset", (ConsoleCommandFunc)SetAudioListenerOffsets, 0,
 	                 "Sets by how much the audio listener offsets its position and rotation in regards to its entity.\n"
 	                 "Usage: es_AudioListenerOffset PosX PosY PosZ RotX RotY RotZ\n");
+	REGISTER_COMMAND("es_ProximityTriggerBenchmark", (ConsoleCommandFunc)ProximityTriggerBenchmark, 0,
+	                 "Times the proximity trigger broadphase on random triggers and moving entities, no events are sent.\n"
+	                 "Usage: es_ProximityTriggerBenchmark [triggers=10000] [entities=1000] [frames=100]");
 
 	REGISTER_CVAR(es_SortUpdatesByClass, 0, 0, "Sort entity updates by class (possible optimization)");
+	REGISTER_CVAR(es_UpdateEntitiesInParallel, 0, 0,
+	              "Update entities whose proxies all declared a thread safe update in batches on the job system.\n"
+	              "The other entities are updated on the main thread first, events between entities are queued until all entities were updated.\n"
+	              "Usage: es_UpdateEntitiesInParallel [0/1]");
+	REGISTER_CVAR(es_ParallelUpdateBatchSize, 32, 0, "Number of entities updated per job batch if es_UpdateEntitiesInParallel is enabled");
+	REGISTER_CVAR(es_ProximityTriggerBatchSize, 256, 0,
+	              "Number of moved entities or triggers checked per job batch when looking for the proximity triggers entities entered or left.\n"
+	              "Usage: es_ProximityTriggerBatchSize [0..]\n"
+	              "Default is 256, 0 checks them all on the main thread");
 	pDebug = REGISTER_INT("es_debug", 0, VF_CHEAT,
 	                      "Enable entity debugging info\n"
 	                      "Usage: es_debug [0/1]\n"
@@ -442,3 +458,11 @@ void CVar::SetAudioListenerOffsets(IConsoleCmdArgs* pArgs)
 	  Quat::CreateRotationXYZ(Ang3(fRotationOffsetX, fRotationOffsetY, fRotationOffsetZ)),
 	  Vec3(fPositionOffsetX, fPositionOffsetY, fPositionOffsetZ));
 }
+
+void CVar::ProximityTriggerBenchmark(IConsoleCmdArgs* pArgs)
+{
+	const int numTriggers = pArgs->GetArgCount() > 1 ? atoi(pArgs->GetArg(1)) : 10000;
+	const int numEntities = pArgs->GetArgCount() > 2 ? atoi(pArgs->GetArg(2)) : 1000;
+	const int numFrames = pArgs->GetArgCount() > 3 ? atoi(pArgs->GetArg(3)) : 100;
+	CProximityBroadphase::RunBenchmark(numTriggers, numEntities, numFrames);
+}
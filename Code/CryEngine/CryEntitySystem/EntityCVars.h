@@ -66,6 +66,9 @@ struct CVar
 	static float    es_MaxPhysDistCloth;
 	static float    es_FarPhysTimeout;
 	static int      es_SortUpdatesByClass;
+	static int      es_UpdateEntitiesInParallel;
+	static int      es_ParallelUpdateBatchSize;
+	static int      es_ProximityTriggerBatchSize;
 
 	// debug only
 	static ICVar*      pEnableFullScriptSave;
@@ -115,6 +118,8 @@ struct CVar
 	static void EnableDebugAnimText(IConsoleCmdArgs* args);
 
 	static void SetAudioListenerOffsets(IConsoleCmdArgs* pArgs);
+
+	static void ProximityTriggerBenchmark(IConsoleCmdArgs* pArgs);
 };
 
 #endif // __EntityCVars_h__
@@ -20,6 +20,7 @@
 void CEntityNodeProxy::Initialize(const SComponentInitializer& init)
 {
 	m_pEntity = init.m_pEntity;
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 void CEntityNodeProxy::ProcessEvent(SEntityEvent& event)
@@ -290,6 +290,9 @@ CEntitySystem::CEntitySystem(ISystem* pSystem)
 
 	m_idForced = 0;
 
+	m_nNextParallelUpdateBatch = 0;
+	m_bInParallelUpdate = false;
+
 	m_bReseting = false;
 
 #ifdef SW_ENTITY_ID_USE_GUID
@@ -420,6 +423,9 @@ void CEntitySystem::Unload()
 
 	stl::free_container(m_tempActiveEntities);
 	stl::free_container(m_deferredUsedEntities);
+	stl::free_container(m_parallelUpdateEntities);
+	stl::free_container(m_deferredEntityEvents);
+	stl::free_container(m_deferredUpdateStatus);
 }
 
 void CEntitySystem::PurgeHeaps()
@@ -1715,6 +1721,95 @@ void CEntitySystem::UpdateTempActiveEntities()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CEntitySystem::DoUpdateLoopParallel(SEntityUpdateContext& ctx)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
+
+	// Entities with a component which isn't thread safe are updated first in the usual order, the rest is collected
+	// and updated in batches on the job system. Their SetUpdateStatus calls and events to other entities are deferred
+	// until all batches are done, as they touch shared entity system state.
+	m_parallelUpdateEntities.clear();
+	int numActive = m_tempActiveEntities.size();
+	for (int i = 0; i < numActive; i++)
+	{
+		CEntity* pEntity = GetEntityFromID(m_tempActiveEntities[i]);
+		if (!pEntity)
+			continue;
+
+		if (pEntity->CanUpdateInParallel())
+		{
+			m_parallelUpdateEntities.push_back(m_tempActiveEntities[i]);
+		}
+		else
+		{
+#ifdef _DEBUG
+			INDENT_LOG_DURING_SCOPE(true, "While updating %s...", pEntity->GetEntityTextDescription());
+#endif
+			pEntity->Update(ctx);
+		}
+	}
+
+	if (m_parallelUpdateEntities.empty())
+		return;
+
+	const int nBatchSize = max(CVar::es_ParallelUpdateBatchSize, 1);
+	const int nNumBatches = ((int)m_parallelUpdateEntities.size() + nBatchSize - 1) / nBatchSize;
+
+	m_nNextParallelUpdateBatch = 0;
+	m_bInParallelUpdate = true;
+	MemoryBarrier();
+
+	// the main thread works on the batches as well, so only spawn jobs if there is more than one batch
+	JobManager::SJobState jobState;
+	const int nNumJobs = min(nNumBatches - 1, (int)gEnv->GetJobManager()->GetNumWorkerThreads());
+	for (int i = 0; i < nNumJobs; ++i)
+	{
+		gEnv->GetJobManager()->AddLambdaJob("EntitySystem_UpdateEntities", [this, &ctx, nBatchSize]() { UpdateEntityBatches(ctx, nBatchSize); }, JobManager::eRegularPriority, &jobState);
+	}
+	UpdateEntityBatches(ctx, nBatchSize);
+	gEnv->GetJobManager()->WaitForJob(jobState);
+
+	m_bInParallelUpdate = false;
+	MemoryBarrier();
+
+	for (size_t i = 0; i < m_deferredUpdateStatus.size(); ++i)
+	{
+		if (CEntity* pEntity = GetEntityFromID(m_deferredUpdateStatus[i]))
+			pEntity->SetUpdateStatus();
+	}
+	m_deferredUpdateStatus.clear();
+
+	FlushDeferredEntityEvents();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CEntitySystem::UpdateEntityBatches(const SEntityUpdateContext& ctx, int nBatchSize)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
+
+	// each caller works on its own copy of the context, as proxies are allowed to write to it
+	SEntityUpdateContext localCtx = ctx;
+	const int numEntities = (int)m_parallelUpdateEntities.size();
+	for (;; )
+	{
+		const int nFirst = (CryInterlockedIncrement(&m_nNextParallelUpdateBatch) - 1) * nBatchSize;
+		if (nFirst >= numEntities)
+			break;
+
+		const int nEnd = min(nFirst + nBatchSize, numEntities);
+		for (int i = nFirst; i < nEnd; ++i)
+		{
+			CEntity* pEntity = GetEntityFromID(m_parallelUpdateEntities[i]);
+			if (pEntity && pEntity->UpdateProxies(localCtx))
+			{
+				AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_deferredLock);
+				m_deferredUpdateStatus.push_back(m_parallelUpdateEntities[i]);
+			}
+		}
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 void CEntitySystem::DoUpdateLoop(float fFrameTime)
 {
@@ -1757,16 +1852,23 @@ void CEntitySystem::DoUpdateLoop(float fFrameTime)
 	{
 		// Copy active entity ids into temporary buffer, this is needed because some entity can be added or deleted during Update call.
 		UpdateTempActiveEntities();
-		int numActive = m_tempActiveEntities.size();
-		for (int i = 0; i < numActive; i++)
+		if (CVar::es_UpdateEntitiesInParallel)
 		{
-			CEntity* pEntity = GetEntityFromID(m_tempActiveEntities[i]);
-			if (pEntity)
+			DoUpdateLoopParallel(ctx);
+		}
+		else
+		{
+			int numActive = m_tempActiveEntities.size();
+			for (int i = 0; i < numActive; i++)
 			{
+				CEntity* pEntity = GetEntityFromID(m_tempActiveEntities[i]);
+				if (pEntity)
+				{
 #ifdef _DEBUG
-				INDENT_LOG_DURING_SCOPE(true, "While updating %s...", pEntity->GetEntityTextDescription());
+					INDENT_LOG_DURING_SCOPE(true, "While updating %s...", pEntity->GetEntityTextDescription());
 #endif
-				pEntity->Update(ctx);
+					pEntity->Update(ctx);
+				}
 			}
 		}
 	}
@@ -1971,6 +2073,39 @@ void CEntitySystem::SendEventViaEntityEvent(IEntity* piEntity, SEntityEvent& eve
 	m_pEventDistributer->SendEvent(event);
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CEntitySystem::QueueEntityEvent(EntityId entityId, const SEntityEvent& event)
+{
+	if (m_bInParallelUpdate)
+	{
+		AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_deferredLock);
+		m_deferredEntityEvents.push_back(std::make_pair(entityId, event));
+		return;
+	}
+
+	if (CEntity* pEntity = GetEntityFromID(entityId))
+	{
+		SEntityEvent entityEvent = event;
+		pEntity->SendEvent(entityEvent);
+		SendEventViaEntityEvent(pEntity, entityEvent);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CEntitySystem::FlushDeferredEntityEvents()
+{
+	// sending an event can queue new ones, those are sent immediately as the parallel update is over
+	DeferredEntityEvents events;
+	events.swap(m_deferredEntityEvents);
+	for (DeferredEntityEvents::iterator it = events.begin(); it != events.end(); ++it)
+	{
+		QueueEntityEvent(it->first, it->second);
+	}
+	events.clear();
+	if (m_deferredEntityEvents.empty())
+		m_deferredEntityEvents.swap(events); // keep the capacity for the next frame
+}
+
 //////////////////////////////////////////////////////////////////////////
 void CEntitySystem::SendEventToAll(SEntityEvent& event)
 {
@@ -135,6 +135,7 @@ public:
 	virtual uint32                GetNumEntities() const override;
 	virtual IEntityIt*            GetEntityIterator() override;
 	virtual void                  SendEventViaEntityEvent(IEntity* piEntity, SEntityEvent& event) override;
+	virtual void                  QueueEntityEvent(EntityId entityId, const SEntityEvent& event) override;
 	virtual void                  SendEventToAll(SEntityEvent& event) override;
 	virtual int                   QueryProximity(SEntityProximityQuery& query) override;
 	virtual void                  ResizeProximityGrid(int nWidth, int nHeight) override;
@@ -297,6 +298,9 @@ private: // -----------------------------------------------------------------
 	void DoPrePhysicsUpdate();
 	void DoPrePhysicsUpdateFast();
 	void DoUpdateLoop(float fFrameTime);
+	void DoUpdateLoopParallel(SEntityUpdateContext& ctx);
+	void UpdateEntityBatches(const SEntityUpdateContext& ctx, int nBatchSize);
+	void FlushDeferredEntityEvents();
 
 	void DeleteEntity(CEntity* pEntity);
 	void UpdateDeletedEntities();
@@ -359,6 +363,15 @@ private: // -----------------------------------------------------------------
 	CSaltBufferArray<>          m_EntitySaltBuffer;         // used to create new entity ids (with uniqueid=salt)
 	std::vector<EntityId>       m_tempActiveEntities;       // Temporary array of active entities.
 
+	// Parallel entity update (es_UpdateEntitiesInParallel).
+	typedef std::vector<std::pair<EntityId, SEntityEvent>> DeferredEntityEvents;
+	std::vector<EntityId>          m_parallelUpdateEntities;   // entities of the current frame which are updated on jobs
+	volatile int                   m_nNextParallelUpdateBatch; // next batch of m_parallelUpdateEntities to be claimed by a job
+	volatile bool                  m_bInParallelUpdate;        // QueueEntityEvent defers events while set
+	CryCriticalSectionNonRecursive m_deferredLock;             // protects the two containers below
+	DeferredEntityEvents           m_deferredEntityEvents;     // events queued during the parallel update, sent in queue order
+	std::vector<EntityId>          m_deferredUpdateStatus;     // entities whose update counter ran out during the parallel update
+
 	CComponentEventDistributer* m_pEventDistributer;
 	//////////////////////////////////////////////////////////////////////////
 
@@ -22,6 +22,7 @@ CFlowGraphProxy::CFlowGraphProxy()
 {
 	m_pEntity = NULL;
 	m_pFlowGraph = 0;
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,535 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "stdafx.h"
+#include "ProximityBroadphase.h"
+#include "ProximityTriggerSystem.h"
+#include "EntityCVars.h"
+
+#include "RadixSort.h"
+
+// Insertion sort of the moved triggers is cheaper until about this fraction of the triggers moved
+#define SORT_ALL_TRIGGERS_RATIO (8)
+
+namespace
+{
+inline bool IsIntersectInRange(float minA, float maxA, float minB, float maxB)
+{
+	return !(maxA < minB || maxB < minA);
+}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::SBounds::Resize(size_t size)
+{
+	minX.resize(size);
+	maxX.resize(size);
+	minY.resize(size);
+	maxY.resize(size);
+	minZ.resize(size);
+	maxZ.resize(size);
+}
+
+void CProximityBroadphase::SBounds::Set(size_t index, const AABB& aabb)
+{
+	minX[index] = aabb.min.x;
+	maxX[index] = aabb.max.x;
+	minY[index] = aabb.min.y;
+	maxY[index] = aabb.max.y;
+	minZ[index] = aabb.min.z;
+	maxZ[index] = aabb.max.z;
+}
+
+AABB CProximityBroadphase::SBounds::Get(size_t index) const
+{
+	return AABB(Vec3(minX[index], minY[index], minZ[index]), Vec3(maxX[index], maxY[index], maxZ[index]));
+}
+
+void CProximityBroadphase::SBounds::Swap(size_t a, size_t b)
+{
+	std::swap(minX[a], minX[b]);
+	std::swap(maxX[a], maxX[b]);
+	std::swap(minY[a], minY[b]);
+	std::swap(maxY[a], maxY[b]);
+	std::swap(minZ[a], minZ[b]);
+	std::swap(maxZ[a], maxZ[b]);
+}
+
+void CProximityBroadphase::SBounds::Move(size_t from, size_t to)
+{
+	minX[to] = minX[from];
+	maxX[to] = maxX[from];
+	minY[to] = minY[from];
+	maxY[to] = maxY[from];
+	minZ[to] = minZ[from];
+	maxZ[to] = maxZ[from];
+}
+
+void CProximityBroadphase::SBounds::Permute(const uint32* pRanks, std::vector<float>& scratch)
+{
+	std::vector<float>* arrays[] = { &minX, &maxX, &minY, &maxY, &minZ, &maxZ };
+	const size_t size = minX.size();
+	for (size_t i = 0; i < CRY_ARRAY_COUNT(arrays); ++i)
+	{
+		std::vector<float>& values = *arrays[i];
+		scratch.resize(size);
+		for (size_t j = 0; j < size; ++j)
+			scratch[j] = values[pRanks[j]];
+		values.swap(scratch);
+	}
+}
+
+void CProximityBroadphase::SBounds::Clear()
+{
+	stl::free_container(minX);
+	stl::free_container(maxX);
+	stl::free_container(minY);
+	stl::free_container(maxY);
+	stl::free_container(minZ);
+	stl::free_container(maxZ);
+}
+
+void CProximityBroadphase::SBounds::GetMemoryUsage(ICrySizer* pSizer) const
+{
+	pSizer->AddContainer(minX);
+	pSizer->AddContainer(maxX);
+	pSizer->AddContainer(minY);
+	pSizer->AddContainer(maxY);
+	pSizer->AddContainer(minZ);
+	pSizer->AddContainer(maxZ);
+}
+
+//////////////////////////////////////////////////////////////////////////
+CProximityBroadphase::CProximityBroadphase()
+	: m_pTriggerSorter(new RadixSort)
+	, m_bSortAll(false)
+	, m_pEntitySorter(new RadixSort)
+	, m_numEntityBatches(0)
+	, m_numSweptTriggers(0)
+	, m_nNextBatch(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+CProximityBroadphase::~CProximityBroadphase()
+{
+	delete m_pTriggerSorter;
+	delete m_pEntitySorter;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::AddTrigger(SProximityElement* pTrigger)
+{
+	pTrigger->axisIndex = (uint32)m_triggers.size();
+	m_triggers.push_back(pTrigger);
+	m_triggerBounds.Resize(m_triggers.size());
+	m_triggerBounds.Set(pTrigger->axisIndex, pTrigger->aabb);
+	m_bSortAll = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::RemoveTriggers(const Elements& triggers)
+{
+	for (size_t i = 0; i < triggers.size(); ++i)
+	{
+		SProximityElement* pTrigger = triggers[i];
+		if (pTrigger->axisIndex < m_triggers.size() && m_triggers[pTrigger->axisIndex] == pTrigger)
+			m_triggers[pTrigger->axisIndex] = NULL;
+	}
+
+	// Compact the axis, which keeps the order.
+	uint32 numKept = 0;
+	const uint32 num = (uint32)m_triggers.size();
+	for (uint32 i = 0; i < num; ++i)
+	{
+		if (SProximityElement* pTrigger = m_triggers[i])
+		{
+			if (i != numKept)
+			{
+				m_triggers[numKept] = pTrigger;
+				pTrigger->axisIndex = numKept;
+				m_triggerBounds.Move(i, numKept);
+			}
+			numKept++;
+		}
+	}
+	m_triggers.resize(numKept);
+	m_triggerBounds.Resize(numKept);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::UpdateTriggers(const Elements& triggers)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
+
+	if (m_bSortAll || triggers.size() * SORT_ALL_TRIGGERS_RATIO > m_triggers.size())
+	{
+		for (size_t i = 0; i < triggers.size(); ++i)
+			m_triggerBounds.Set(triggers[i]->axisIndex, triggers[i]->aabb);
+		SortAllTriggers();
+	}
+	else
+	{
+		// Only the trigger being moved is out of place, so each one is moved by insertion sort.
+		for (size_t i = 0; i < triggers.size(); ++i)
+		{
+			m_triggerBounds.Set(triggers[i]->axisIndex, triggers[i]->aabb);
+			SiftTrigger(triggers[i]->axisIndex);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+AABB CProximityBroadphase::GetTriggerBounds(const SProximityElement* pTrigger) const
+{
+	return m_triggerBounds.Get(pTrigger->axisIndex);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::SwapTriggers(uint32 a, uint32 b)
+{
+	std::swap(m_triggers[a], m_triggers[b]);
+	m_triggers[a]->axisIndex = a;
+	m_triggers[b]->axisIndex = b;
+	m_triggerBounds.Swap(a, b);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::SiftTrigger(uint32 index)
+{
+	const std::vector<float>& minX = m_triggerBounds.minX;
+	const float key = minX[index];
+	while (index > 0 && minX[index - 1] > key)
+	{
+		SwapTriggers(index - 1, index);
+		index--;
+	}
+	const uint32 last = (uint32)m_triggers.size() - 1;
+	while (index < last && minX[index + 1] < key)
+	{
+		SwapTriggers(index, index + 1);
+		index++;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::SortAllTriggers()
+{
+	m_bSortAll = false;
+
+	const uint32 num = (uint32)m_triggers.size();
+	if (!num)
+		return;
+
+	const uint32* pRanks = m_pTriggerSorter->Sort(&m_triggerBounds.minX[0], num).GetRanks();
+
+	Elements sorted(num);
+	for (uint32 i = 0; i < num; ++i)
+	{
+		sorted[i] = m_triggers[pRanks[i]];
+		sorted[i]->axisIndex = i;
+	}
+	m_triggers.swap(sorted);
+	m_triggerBounds.Permute(pRanks, m_scratch);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::SortEntities(const Elements& entities)
+{
+	const uint32 num = (uint32)entities.size();
+	m_scratch.resize(num);
+	for (uint32 i = 0; i < num; ++i)
+		m_scratch[i] = entities[i]->aabb.min.x;
+
+	const uint32* pRanks = m_pEntitySorter->Sort(&m_scratch[0], num).GetRanks();
+
+	m_entities.resize(num);
+	m_entityBounds.Resize(num);
+	for (uint32 i = 0; i < num; ++i)
+	{
+		SProximityElement* pEntity = entities[pRanks[i]];
+		m_entities[i] = pEntity;
+		m_entityBounds.Set(i, pEntity->aabb);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::FindPairChanges(const Elements& entities, Pairs& leaving, Pairs& entering)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
+
+	assert(!m_bSortAll);
+	if (entities.empty())
+		return;
+
+	SortEntities(entities);
+
+	// The entity batches find the triggers whose min x is within the x range of an entity, the trigger
+	// batches the entities whose min x is within the x range of a trigger, but not at its min x.
+	// Only the triggers starting before the last entity can have entities of the second kind.
+	const int numEntities = (int)m_entities.size();
+	const std::vector<float>& triggerMinX = m_triggerBounds.minX;
+	m_numSweptTriggers = (int)(std::lower_bound(triggerMinX.begin(), triggerMinX.end(), m_entityBounds.minX.back()) - triggerMinX.begin());
+
+	const bool bUseJobs = CVar::es_ProximityTriggerBatchSize > 0;
+	const int batchSize = bUseJobs ? CVar::es_ProximityTriggerBatchSize : max(numEntities, m_numSweptTriggers);
+	m_numEntityBatches = (numEntities + batchSize - 1) / batchSize;
+	const int numBatches = m_numEntityBatches + (m_numSweptTriggers + batchSize - 1) / batchSize;
+
+	if ((int)m_batches.size() < numBatches)
+		m_batches.resize(numBatches);
+	for (int i = 0; i < numBatches; ++i)
+	{
+		m_batches[i].leaving.resize(0);
+		m_batches[i].entering.resize(0);
+	}
+
+	m_nNextBatch = 0;
+	MemoryBarrier();
+
+	// the main thread works on the batches as well, so only spawn jobs if there is more than one batch
+	JobManager::SJobState jobState;
+	const int numJobs = bUseJobs ? min(numBatches - 1, (int)gEnv->GetJobManager()->GetNumWorkerThreads()) : 0;
+	for (int i = 0; i < numJobs; ++i)
+	{
+		gEnv->GetJobManager()->AddLambdaJob("ProximityTriggers_FindPairChanges", [this, batchSize, numBatches]() { ProcessBatches(batchSize, numBatches); }, JobManager::eRegularPriority, &jobState);
+	}
+	ProcessBatches(batchSize, numBatches);
+	gEnv->GetJobManager()->WaitForJob(jobState);
+
+	// In batch order, so the pairs don't depend on the jobs
+	for (int i = 0; i < numBatches; ++i)
+	{
+		const SBatch& batch = m_batches[i];
+		leaving.insert(leaving.end(), batch.leaving.begin(), batch.leaving.end());
+		entering.insert(entering.end(), batch.entering.begin(), batch.entering.end());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::ProcessBatches(int batchSize, int numBatches)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
+
+	for (;; )
+	{
+		const int batchIndex = CryInterlockedIncrement(&m_nNextBatch) - 1;
+		if (batchIndex >= numBatches)
+			break;
+
+		SBatch& batch = m_batches[batchIndex];
+		if (batchIndex < m_numEntityBatches)
+		{
+			const int first = batchIndex * batchSize;
+			FindEntityBatchChanges(first, min(first + batchSize, (int)m_entities.size()), batch);
+		}
+		else
+		{
+			const int first = (batchIndex - m_numEntityBatches) * batchSize;
+			FindTriggerBatchOverlaps(first, min(first + batchSize, m_numSweptTriggers), batch);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::FindEntityBatchChanges(int first, int end, SBatch& batch) const
+{
+	const SBounds& e = m_entityBounds;
+	const SBounds& t = m_triggerBounds;
+	const int numTriggers = (int)m_triggers.size();
+
+	// The entities are sorted, so the first trigger to test only moves forward.
+	int firstTrigger = (int)(std::lower_bound(t.minX.begin(), t.minX.end(), e.minX[first]) - t.minX.begin());
+
+	for (int i = first; i < end; ++i)
+	{
+		SProximityElement* pEntity = m_entities[i];
+
+		// Check if the entity left any of its triggers.
+		for (size_t j = 0; j < pEntity->inside.size(); ++j)
+		{
+			SProximityElement* pTrigger = pEntity->inside[j];
+			if (!pTrigger->aabb.IsIntersectBox(pEntity->aabb))
+			{
+				SPair pair = { pEntity, pTrigger };
+				batch.leaving.push_back(pair);
+			}
+		}
+
+		while (firstTrigger < numTriggers && t.minX[firstTrigger] < e.minX[i])
+			firstTrigger++;
+
+		for (int j = firstTrigger; j < numTriggers && t.minX[j] <= e.maxX[i]; ++j)
+		{
+			if (IsIntersectInRange(e.minY[i], e.maxY[i], t.minY[j], t.maxY[j]) && IsIntersectInRange(e.minZ[i], e.maxZ[i], t.minZ[j], t.maxZ[j]))
+			{
+				if (!pEntity->IsInside(m_triggers[j]))
+				{
+					SPair pair = { pEntity, m_triggers[j] };
+					batch.entering.push_back(pair);
+				}
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::FindTriggerBatchOverlaps(int first, int end, SBatch& batch) const
+{
+	const SBounds& e = m_entityBounds;
+	const SBounds& t = m_triggerBounds;
+	const int numEntities = (int)m_entities.size();
+
+	// The triggers are sorted, so the first entity to test only moves forward.
+	int firstEntity = (int)(std::upper_bound(e.minX.begin(), e.minX.end(), t.minX[first]) - e.minX.begin());
+
+	for (int j = first; j < end; ++j)
+	{
+		while (firstEntity < numEntities && e.minX[firstEntity] <= t.minX[j])
+			firstEntity++;
+
+		for (int i = firstEntity; i < numEntities && e.minX[i] <= t.maxX[j]; ++i)
+		{
+			if (IsIntersectInRange(e.minY[i], e.maxY[i], t.minY[j], t.maxY[j]) && IsIntersectInRange(e.minZ[i], e.maxZ[i], t.minZ[j], t.maxZ[j]))
+			{
+				if (!m_entities[i]->IsInside(m_triggers[j]))
+				{
+					SPair pair = { m_entities[i], m_triggers[j] };
+					batch.entering.push_back(pair);
+				}
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::Reset()
+{
+	stl::free_container(m_triggers);
+	stl::free_container(m_entities);
+	stl::free_container(m_batches);
+	stl::free_container(m_scratch);
+	m_triggerBounds.Clear();
+	m_entityBounds.Clear();
+	stl::reconstruct(*m_pTriggerSorter);
+	stl::reconstruct(*m_pEntitySorter);
+	m_bSortAll = false;
+	m_numEntityBatches = 0;
+	m_numSweptTriggers = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::GetMemoryUsage(ICrySizer* pSizer) const
+{
+	pSizer->AddObject(m_pTriggerSorter);
+	pSizer->AddObject(m_pEntitySorter);
+	pSizer->AddContainer(m_triggers);
+	pSizer->AddContainer(m_entities);
+	pSizer->AddContainer(m_scratch);
+	m_triggerBounds.GetMemoryUsage(pSizer);
+	m_entityBounds.GetMemoryUsage(pSizer);
+	for (size_t i = 0; i < m_batches.size(); ++i)
+	{
+		pSizer->AddContainer(m_batches[i].leaving);
+		pSizer->AddContainer(m_batches[i].entering);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityBroadphase::RunBenchmark(int numTriggers, int numEntities, int numFrames)
+{
+	numTriggers = max(numTriggers, 1);
+	numEntities = max(numEntities, 1);
+	numFrames = max(numFrames, 1);
+
+	// Triggers of 2 to 16 meters spread so every point is in about 3 of them, the entities walk
+	// around at up to 10 m/s at 30 fps and 1% of the triggers move every frame.
+	const float worldSize = max(sqrtf(numTriggers * 81.f / 3.f), 64.f);
+	const float entityStep = 10.f / 30.f;
+	const int numMovedTriggers = numTriggers / 100;
+
+	CRndGen rnd(0x1234);
+	CProximityBroadphase broadphase;
+
+	Elements triggers(numTriggers);
+	for (int i = 0; i < numTriggers; ++i)
+	{
+		const Vec3 center = rnd.GetRandomComponentwise(Vec3(0.f, 0.f, 0.f), Vec3(worldSize, worldSize, 8.f));
+		const Vec3 extent = rnd.GetRandomComponentwise(Vec3(1.f, 1.f, 1.f), Vec3(8.f, 8.f, 4.f));
+		triggers[i] = new SProximityElement;
+		triggers[i]->aabb = AABB(center - extent, center + extent);
+		broadphase.AddTrigger(triggers[i]);
+	}
+
+	Elements entities(numEntities);
+	std::vector<Vec3> positions(numEntities);
+	for (int i = 0; i < numEntities; ++i)
+	{
+		positions[i] = rnd.GetRandomComponentwise(Vec3(0.f, 0.f, 0.f), Vec3(worldSize, worldSize, 8.f));
+		entities[i] = new SProximityElement;
+	}
+
+	const double msPerTick = 1000.0 / gEnv->pTimer->GetTicksPerSecond();
+
+	int64 ticks = CryGetTicks();
+	broadphase.UpdateTriggers(triggers);
+	const double sortMs = (CryGetTicks() - ticks) * msPerTick;
+
+	Elements movedTriggers;
+	Pairs leaving, entering;
+	double updateMs = 0.0, findMs = 0.0;
+	int numLeaving = 0, numEntering = 0;
+
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		movedTriggers.resize(0);
+		for (int i = 0; i < numMovedTriggers; ++i)
+		{
+			SProximityElement* pTrigger = triggers[(frame * numMovedTriggers + i) % numTriggers];
+			const Vec3 offset(rnd.GetRandom(-1.f, 1.f), rnd.GetRandom(-1.f, 1.f), 0.f);
+			pTrigger->aabb = AABB(pTrigger->aabb.min + offset, pTrigger->aabb.max + offset);
+			movedTriggers.push_back(pTrigger);
+		}
+
+		for (int i = 0; i < numEntities; ++i)
+		{
+			Vec3& pos = positions[i];
+			pos.x = clamp_tpl(pos.x + rnd.GetRandom(-entityStep, entityStep), 0.f, worldSize);
+			pos.y = clamp_tpl(pos.y + rnd.GetRandom(-entityStep, entityStep), 0.f, worldSize);
+			// as CProximityTriggerSystem::MoveEntity
+			entities[i]->aabb = AABB(pos - Vec3(0.5f, 0.5f, 0.f), pos + Vec3(0.5f, 0.5f, 0.5f));
+		}
+
+		ticks = CryGetTicks();
+		broadphase.UpdateTriggers(movedTriggers);
+		const int64 updateEndTicks = CryGetTicks();
+		leaving.resize(0);
+		entering.resize(0);
+		broadphase.FindPairChanges(entities, leaving, entering);
+		updateMs += (updateEndTicks - ticks) * msPerTick;
+		findMs += (CryGetTicks() - updateEndTicks) * msPerTick;
+
+		for (size_t i = 0; i < leaving.size(); ++i)
+		{
+			leaving[i].pEntity->RemoveInside(leaving[i].pTrigger);
+			leaving[i].pTrigger->RemoveInside(leaving[i].pEntity);
+		}
+		for (size_t i = 0; i < entering.size(); ++i)
+		{
+			entering[i].pEntity->AddInside(entering[i].pTrigger);
+			entering[i].pTrigger->AddInside(entering[i].pEntity);
+		}
+		numLeaving += (int)leaving.size();
+		numEntering += (int)entering.size();
+	}
+
+	CryLogAlways("Proximity trigger benchmark: %d triggers, %d moving entities, %d frames in %.0f m", numTriggers, numEntities, numFrames, worldSize);
+	CryLogAlways("  Sorting all triggers: %.3f ms", sortMs);
+	CryLogAlways("  Updating %d moved triggers: %.3f ms per frame", numMovedTriggers, updateMs / numFrames);
+	CryLogAlways("  Finding pair changes: %.3f ms per frame (es_ProximityTriggerBatchSize %d, %d worker threads)", findMs / numFrames, CVar::es_ProximityTriggerBatchSize, (int)gEnv->GetJobManager()->GetNumWorkerThreads());
+	CryLogAlways("  %.1f enters, %.1f leaves per frame", (float)numEntering / numFrames, (float)numLeaving / numFrames);
+
+	for (int i = 0; i < numEntities; ++i)
+		delete entities[i];
+	for (int i = 0; i < numTriggers; ++i)
+		delete triggers[i];
+}
@@ -0,0 +1,104 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Sweep and prune broadphase of the proximity trigger system.
+//               The trigger bounds are kept sorted by their min x in
+//               structure of arrays form, moved triggers are put back in
+//               place by insertion sort. The pairs of moved entities and
+//               triggers which stopped or started overlapping are found in
+//               batches on the job system.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ProximityBroadphase_h__
+#define __ProximityBroadphase_h__
+#pragma once
+
+class RadixSort;
+struct SProximityElement;
+
+class CProximityBroadphase
+{
+public:
+	typedef std::vector<SProximityElement*> Elements;
+
+	struct SPair
+	{
+		SProximityElement* pEntity;
+		SProximityElement* pTrigger;
+		void               GetMemoryUsage(ICrySizer* pSizer) const {}
+	};
+	typedef std::vector<SPair> Pairs;
+
+	CProximityBroadphase();
+	~CProximityBroadphase();
+
+	// Appended with its current bounds, the next UpdateTriggers sorts it in
+	void AddTrigger(SProximityElement* pTrigger);
+	void RemoveTriggers(const Elements& triggers);
+	// Takes the current bounds of the triggers and moves them to their place on the axis
+	void UpdateTriggers(const Elements& triggers);
+	// The bounds of the trigger at the last UpdateTriggers
+	AABB GetTriggerBounds(const SProximityElement* pTrigger) const;
+
+	// Appends the pairs of the entities and the triggers they left or entered, according to the inside lists.
+	// The entities have to be unique and the triggers have to be up to date.
+	void FindPairChanges(const Elements& entities, Pairs& leaving, Pairs& entering);
+
+	int  GetNumTriggers() const { return (int)m_triggers.size(); }
+
+	void Reset();
+	void GetMemoryUsage(ICrySizer* pSizer) const;
+
+	// Times the broadphase on random triggers and entities moving around them, without sending events
+	static void RunBenchmark(int numTriggers, int numEntities, int numFrames);
+
+private:
+	// Bounds in structure of arrays form
+	struct SBounds
+	{
+		std::vector<float> minX, maxX, minY, maxY, minZ, maxZ;
+
+		void Resize(size_t size);
+		void Set(size_t index, const AABB& aabb);
+		AABB Get(size_t index) const;
+		void Swap(size_t a, size_t b);
+		void Move(size_t from, size_t to);
+		void Permute(const uint32* pRanks, std::vector<float>& scratch);
+		void Clear();
+		void GetMemoryUsage(ICrySizer* pSizer) const;
+	};
+
+	struct SBatch
+	{
+		Pairs leaving;
+		Pairs entering;
+	};
+
+	void SwapTriggers(uint32 a, uint32 b);
+	void SiftTrigger(uint32 index);
+	void SortAllTriggers();
+	void SortEntities(const Elements& entities);
+
+	void ProcessBatches(int batchSize, int numBatches);
+	void FindEntityBatchChanges(int first, int end, SBatch& batch) const;
+	void FindTriggerBatchOverlaps(int first, int end, SBatch& batch) const;
+
+	Elements            m_triggers;       // sorted by min x, a trigger knows its index
+	SBounds             m_triggerBounds;
+	RadixSort*          m_pTriggerSorter;
+	bool                m_bSortAll;       // set when triggers were appended
+
+	Elements            m_entities;       // of the current FindPairChanges, sorted by min x
+	SBounds             m_entityBounds;
+	RadixSort*          m_pEntitySorter;
+
+	std::vector<SBatch> m_batches;        // the entity batches followed by the trigger batches
+	int                 m_numEntityBatches;
+	int                 m_numSweptTriggers; // triggers with a min x below the min x of an entity
+	volatile int        m_nNextBatch;     // next batch to be claimed by a job
+	std::vector<float>  m_scratch;
+};
+
+#endif // __ProximityBroadphase_h__
@@ -15,12 +15,6 @@
 #include "ProximityTriggerSystem.h"
 #include "TriggerProxy.h"
 
-#include "RadixSort.h"
-
-#define AXIS_0        0
-#define AXIS_1        1
-#define AXIS_2        2
-
 #define ENTITY_RADIUS (0.5f)
 
 #define GET_ENTITY_NAME(eid) ((CEntity*)gEnv->pEntitySystem->GetEntity(eid))->GetName()
@@ -116,12 +110,7 @@ CProximityTriggerSystem::ProximityElement_PoolAlloc* CProximityTriggerSystem::g_
 
 //////////////////////////////////////////////////////////////////////////
 CProximityTriggerSystem::CProximityTriggerSystem()
-	: m_bTriggerMoved(false)
-	, m_bResetting(false)
-	, m_pTriggerSorter(new RadixSort)
-	, m_pEntitySorter(new RadixSort)
-	, m_Sorted0(nullptr)
-	, m_Sorted1(nullptr)
+	: m_bResetting(false)
 {
 	assert(!g_pProximityElement_PoolAlloc);
 	g_pProximityElement_PoolAlloc = new ProximityElement_PoolAlloc;
@@ -130,8 +119,6 @@ CProximityTriggerSystem::CProximityTriggerSystem()
 //////////////////////////////////////////////////////////////////////////
 CProximityTriggerSystem::~CProximityTriggerSystem()
 {
-	delete m_pTriggerSorter;
-	delete m_pEntitySorter;
 	delete g_pProximityElement_PoolAlloc;
 }
 
@@ -140,8 +127,8 @@ SProximityElement* CProximityTriggerSystem::CreateTrigger()
 {
 	// Should use pool allocator here.
 	SProximityElement* pTrigger = new SProximityElement;
-	m_triggers.push_back(pTrigger);
-	m_bTriggerMoved = true;
+	m_broadphase.AddTrigger(pTrigger);
+	QueueTriggerSort(pTrigger);
 	return pTrigger;
 }
 
@@ -156,7 +143,7 @@ void CProximityTriggerSystem::MoveTrigger(SProximityElement* pTrigger, const AAB
 {
 	pTrigger->aabb = aabb;
 	pTrigger->bActivated = true;
-	m_bTriggerMoved = true;
+	QueueTriggerSort(pTrigger);
 
 	if (invalidateCachedAABB)
 	{
@@ -168,15 +155,17 @@ void CProximityTriggerSystem::MoveTrigger(SProximityElement* pTrigger, const AAB
 		}
 
 		pTrigger->inside.clear();
-		// marcok: find the trigger (not ideal, but I don't have an index I can access here)
-		num = (uint32)m_triggers.size();
-		for (uint32 i = 0; i < num; ++i)
-		{
-			if (m_triggers[i] == pTrigger && m_triggersAABB.size() > i)
-			{
-				m_triggersAABB[i] = AABB(ZERO);
-			}
-		}
+		pTrigger->bInvalidated = true;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CProximityTriggerSystem::QueueTriggerSort(SProximityElement* pTrigger)
+{
+	if (!pTrigger->bSortQueued)
+	{
+		pTrigger->bSortQueued = true;
+		m_triggersToSort.push_back(pTrigger);
 	}
 }
 
@@ -185,93 +174,85 @@ void CProximityTriggerSystem::SortTriggers()
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
 
-	if (m_bTriggerMoved)
+	uint32 num = (uint32)m_triggersToSort.size();
+	for (uint32 i = 0; i < num; ++i)
 	{
-		m_bTriggerMoved = false;
-		m_minPosList1.resize(m_triggers.size());
-		m_triggersAABB.resize(m_triggers.size(), AABB(ZERO));
-		if (!m_triggers.empty())
+		SProximityElement* pTrigger = m_triggersToSort[i];
+		pTrigger->bSortQueued = false;
+		if (pTrigger->bActivated)
 		{
-			uint32 num = (uint32)m_triggers.size();
-			for (uint32 i = 0; i < num; ++i)
+			pTrigger->bActivated = false;
+			// Check if any entity inside this trigger is leaving.
+			for (int j = 0; j < (int)pTrigger->inside.size(); )
 			{
-				SProximityElement* pTrigger = m_triggers[i];
-				if (pTrigger->bActivated)
+				SProximityElement* pEntity = pTrigger->inside[j];
+				if (!pTrigger->aabb.IsIntersectBox(pEntity->aabb))
 				{
-					pTrigger->bActivated = false;
-					// Check if any entity inside this trigger is leaving.
-					for (int j = 0; j < (int)pTrigger->inside.size(); )
+					// Entity Leaving this trigger.
+					pTrigger->inside.erase(pTrigger->inside.begin() + j);
+					if (pEntity->RemoveInside(pTrigger))
 					{
-						SProximityElement* pEntity = pTrigger->inside[j];
-						if (!pTrigger->aabb.IsIntersectBox(pEntity->aabb))
-						{
-							// Entity Leaving this trigger.
-							pTrigger->inside.erase(pTrigger->inside.begin() + j);
-							if (pEntity->RemoveInside(pTrigger))
-							{
-								// Add leave event.
-								SProximityEvent event;
-								event.bEnter = false;
-								event.entity = pEntity->id;
-								event.pTrigger = pTrigger;
-								m_events.push_back(event);
-							}
-							else
-								assert(0); // Should never happen.
-						}
-						else
-							j++;
+						// Add leave event.
+						SProximityEvent event;
+						event.bEnter = false;
+						event.entity = pEntity->id;
+						event.pTrigger = pTrigger;
+						m_events.push_back(event);
 					}
-					// check if anything new needs to be included
-					AABB differences[MAX_AABB_DIFFERENCES];
-					int ndifferences;
-					AABBDifference(m_triggersAABB[i], m_triggers[i]->aabb, differences, &ndifferences);
-					for (int j = 0; j < ndifferences; j++)
+					else
+						assert(0); // Should never happen.
+				}
+				else
+					j++;
+			}
+			// check if anything new needs to be included, the broadphase still has the bounds of the last update
+			const AABB lastAABB = pTrigger->bInvalidated ? AABB(ZERO) : m_broadphase.GetTriggerBounds(pTrigger);
+			pTrigger->bInvalidated = false;
+			AABB differences[MAX_AABB_DIFFERENCES];
+			int ndifferences;
+			AABBDifference(lastAABB, pTrigger->aabb, differences, &ndifferences);
+			for (int j = 0; j < ndifferences; j++)
+			{
+				SEntityProximityQuery q;
+				q.box = differences[j];
+				gEnv->pEntitySystem->QueryProximity(q);
+				for (int k = 0; k < q.nCount; k++)
+				{
+					CEntity* pEnt = (CEntity*) q.pEntities[k];
+					if (pEnt)
 					{
-						SEntityProximityQuery q;
-						q.box = differences[j];
-						gEnv->pEntitySystem->QueryProximity(q);
-						for (int k = 0; k < q.nCount; k++)
+						if (SProximityElement* pProxElem = pEnt->GetProximityElement())
 						{
-							CEntity* pEnt = (CEntity*) q.pEntities[k];
-							if (pEnt)
-							{
-								if (SProximityElement* pProxElem = pEnt->GetProximityElement())
-								{
-									Vec3 pos = pEnt->GetWorldPos();
-									MoveEntity(pProxElem, pos);
-								}
-							}
+							Vec3 pos = pEnt->GetWorldPos();
+							MoveEntity(pProxElem, pos);
 						}
 					}
-					/*
-					   #define LOG_AABB(idx,xx) CryLogAlways("diff[%d]: (%.1f,%.1f,%.1f)->(%.1f,%.1f,%.1f)", idx, xx.min.x, xx.min.y, xx.min.z, xx.max.x, xx.max.y, xx.max.z)
-					          if (ndifferences)
-					          {
-					            LOG_AABB(-200, m_triggersAABB[i]);
-					            LOG_AABB(-100, m_triggers[i]->aabb);
-					            for (int j=0; j<ndifferences; j++)
-					            {
-					              LOG_AABB(j, differences[j]);
-					            }
-					          }
-					   #undef LOG_AABB
-					 */
 				}
-				m_triggersAABB[i] = m_triggers[i]->aabb;
-				m_minPosList1[i] = m_triggers[i]->aabb.min[AXIS_0];
 			}
-			m_Sorted1 = m_pTriggerSorter->Sort(&m_minPosList1[0], m_minPosList1.size()).GetRanks();
 		}
 	}
+
+	m_broadphase.UpdateTriggers(m_triggersToSort);
+	m_triggersToSort.resize(0);
 }
 
 //////////////////////////////////////////////////////////////////////////
-inline bool IsIntersectInAxis(const AABB& a, const AABB& b, uint32 axis)
+void CProximityTriggerSystem::ProcessLeave(SProximityElement* pEntity, SProximityElement* pTrigger)
 {
-	if (a.max[axis] < b.min[axis] || b.max[axis] < a.min[axis])
-		return false;
-	return true;
+	if (pEntity->RemoveInside(pTrigger))
+	{
+		if (pTrigger->RemoveInside(pEntity))
+		{
+			// Add leave event.
+			SProximityEvent event;
+			event.bEnter = false;
+			event.entity = pEntity->id;
+			event.pTrigger = pTrigger;
+			m_events.push_back(event);
+		}
+		else
+			assert(0); // Should not happen that we wasn't inside trigger.
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -297,82 +278,27 @@ void CProximityTriggerSystem::Update()
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
 
-	if (m_bTriggerMoved)
+	if (!m_triggersToSort.empty())
 		SortTriggers();
 
 	if (!m_entities.empty())
 	{
 		uint32 num = (uint32)m_entities.size();
-		m_minPosList0.resize(num);
 		for (uint32 i = 0; i < num; ++i)
-		{
 			m_entities[i]->bActivated = false;
-			CheckIfLeavingTrigger(m_entities[i]);
-			m_minPosList0[i] = m_entities[i]->aabb.min[AXIS_0];
-		}
-		m_Sorted0 = m_pEntitySorter->Sort(&m_minPosList0[0], m_minPosList0.size()).GetRanks();
-		if (!m_minPosList0.empty() && !m_minPosList1.empty())
-		{
-			// Prune triggers.
-			uint32 Index0, Index1;
-
-			float* MinPosList0 = &m_minPosList0[0];
-			float* MinPosList1 = &m_minPosList1[0];
-
-			AABB* array1 = &m_triggersAABB[0];
-
-			const uint32* Sorted0 = &m_Sorted0[0];
-			const uint32* Sorted1 = &m_Sorted1[0];
-			const uint32* const LastSorted0 = &Sorted0[m_minPosList0.size()];
-			const uint32* const LastSorted1 = &Sorted1[m_minPosList1.size()];
-			const uint32* RunningAddress0 = Sorted0;
-			const uint32* RunningAddress1 = Sorted1;
-
-			while (RunningAddress1 < LastSorted1 && Sorted0 < LastSorted0)
-			{
-				Index0 = *Sorted0++;
-
-				while (RunningAddress1 < LastSorted1 && MinPosList1[*RunningAddress1] < MinPosList0[Index0])
-					RunningAddress1++;
-
-				const uint32* RunningAddress2_1 = RunningAddress1;
-
-				while (RunningAddress2_1 < LastSorted1 && MinPosList1[Index1 = *RunningAddress2_1++] <= m_entities[Index0]->aabb.max[AXIS_0])
-				{
-					if (IsIntersectInAxis(m_entities[Index0]->aabb, array1[Index1], AXIS_1))
-					{
-						if (IsIntersectInAxis(m_entities[Index0]->aabb, array1[Index1], AXIS_2))
-						{
-							ProcessOverlap(m_entities[Index0], m_triggers[Index1]);
-							//pairs.AddPair(Index0, Index1);
-						}
-					}
-				}
-			}
 
-			////
-			while (RunningAddress0 < LastSorted0 && Sorted1 < LastSorted1)
-			{
-				Index0 = *Sorted1++;
+		m_leavingPairs.resize(0);
+		m_enteringPairs.resize(0);
+		m_broadphase.FindPairChanges(m_entities, m_leavingPairs, m_enteringPairs);
 
-				while (RunningAddress0 < LastSorted0 && MinPosList0[*RunningAddress0] <= MinPosList1[Index0])
-					RunningAddress0++;
+		num = (uint32)m_leavingPairs.size();
+		for (uint32 i = 0; i < num; ++i)
+			ProcessLeave(m_leavingPairs[i].pEntity, m_leavingPairs[i].pTrigger);
 
-				const uint32* RunningAddress2_0 = RunningAddress0;
+		num = (uint32)m_enteringPairs.size();
+		for (uint32 i = 0; i < num; ++i)
+			ProcessOverlap(m_enteringPairs[i].pEntity, m_enteringPairs[i].pTrigger);
 
-				while (RunningAddress2_0 < LastSorted0 && MinPosList0[Index1 = *RunningAddress2_0++] <= array1[Index0].max[AXIS_0])
-				{
-					if (IsIntersectInAxis(m_entities[Index1]->aabb, array1[Index0], AXIS_1))
-					{
-						if (IsIntersectInAxis(m_entities[Index1]->aabb, array1[Index0], AXIS_2))
-						{
-							ProcessOverlap(m_entities[Index1], m_triggers[Index0]);
-							//pairs.AddPair(Index1, Index0);
-						}
-					}
-				}
-			}
-		}
 		m_entities.resize(0);
 	}
 
@@ -433,10 +359,13 @@ void CProximityTriggerSystem::PurgeRemovedTriggers()
 			SProximityElement* pEntity = pTrigger->inside[j];
 			pEntity->RemoveInside(pTrigger);
 		}
+	}
 
-		stl::find_and_erase(m_triggers, pTrigger);
-		delete pTrigger;
-		m_bTriggerMoved = true;
+	m_broadphase.RemoveTriggers(m_triggersToRemove);
+
+	for (int i = 0; i < (int)m_triggersToRemove.size(); i++)
+	{
+		delete m_triggersToRemove[i];
 	}
 	m_triggersToRemove.resize(0);
 }
@@ -512,34 +441,6 @@ void CProximityTriggerSystem::RemoveFromTriggers(SProximityElement* pEntity, boo
 	}
 }
 
-//////////////////////////////////////////////////////////////////////////
-void CProximityTriggerSystem::CheckIfLeavingTrigger(SProximityElement* pEntity)
-{
-	// Check if we are still inside stored triggers.
-	for (int i = 0; i < (int)pEntity->inside.size(); )
-	{
-		SProximityElement* pTrigger = pEntity->inside[i];
-		if (!pTrigger->aabb.IsIntersectBox(pEntity->aabb))
-		{
-			// Leaving this trigger.
-			pEntity->inside.erase(pEntity->inside.begin() + i);
-			if (pTrigger->RemoveInside(pEntity))
-			{
-				// Add leave event.
-				SProximityEvent event;
-				event.bEnter = false;
-				event.entity = pEntity->id;
-				event.pTrigger = pTrigger;
-				m_events.push_back(event);
-			}
-			else
-				assert(0); // Should not happen that we wasn't inside trigger.
-		}
-		else
-			i++;
-	}
-}
-
 //////////////////////////////////////////////////////////////////////////
 void CProximityTriggerSystem::Reset()
 {
@@ -555,25 +456,22 @@ void CProximityTriggerSystem::Reset()
 	}
 
 	m_entities.clear();
-	m_triggersAABB.clear();
 	m_events.clear();
-	m_minPosList0.clear();
-	m_minPosList1.clear();
-	m_triggers.clear();
 	m_triggersToRemove.clear();
 	m_entitiesToRemove.clear();
+	m_triggersToSort.clear();
+	m_leavingPairs.clear();
+	m_enteringPairs.clear();
 
 	// use swap trick to deallocate memory in vector
 	std::vector<SProximityElement*>(m_entities).swap(m_entities);
-	std::vector<AABB>(m_triggersAABB).swap(m_triggersAABB);
 	std::vector<SProximityEvent>(m_events).swap(m_events);
-	std::vector<float>(m_minPosList0).swap(m_minPosList0);
-	std::vector<float>(m_minPosList1).swap(m_minPosList1);
-	Elements(m_triggers).swap(m_triggers);
 	Elements(m_triggersToRemove).swap(m_triggersToRemove);
 	Elements(m_entitiesToRemove).swap(m_entitiesToRemove);
-	stl::reconstruct(*m_pEntitySorter);
-	stl::reconstruct(*m_pTriggerSorter);
+	Elements(m_triggersToSort).swap(m_triggersToSort);
+	CProximityBroadphase::Pairs(m_leavingPairs).swap(m_leavingPairs);
+	CProximityBroadphase::Pairs(m_enteringPairs).swap(m_enteringPairs);
+	m_broadphase.Reset();
 
 	g_pProximityElement_PoolAlloc->FreeMemory();
 
@@ -589,14 +487,12 @@ void CProximityTriggerSystem::BeginReset()
 void CProximityTriggerSystem::GetMemoryUsage(ICrySizer* pSizer) const
 {
 	pSizer->AddObject(this, sizeof(*this));
-	pSizer->AddObject(m_pTriggerSorter);
-	pSizer->AddObject(m_pEntitySorter);
 	pSizer->AddObject(g_pProximityElement_PoolAlloc);
-	pSizer->AddContainer(m_triggers);
 	pSizer->AddContainer(m_triggersToRemove);
+	pSizer->AddContainer(m_triggersToSort);
 	pSizer->AddContainer(m_entities);
-	pSizer->AddContainer(m_triggersAABB);
 	pSizer->AddContainer(m_events);
-	pSizer->AddContainer(m_minPosList0);
-	pSizer->AddContainer(m_minPosList1);
+	pSizer->AddContainer(m_leavingPairs);
+	pSizer->AddContainer(m_enteringPairs);
+	m_broadphase.GetMemoryUsage(pSizer);
 }
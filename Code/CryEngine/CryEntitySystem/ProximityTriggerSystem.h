@@ -15,8 +15,9 @@
 #define __ProximityTriggerSystem_h__
 #pragma once
 
+#include "ProximityBroadphase.h"
+
 class CTriggerProxy;
-class RadixSort;
 
 //////////////////////////////////////////////////////////////////////////
 struct SProximityElement
@@ -24,13 +25,21 @@ struct SProximityElement
 	//////////////////////////////////////////////////////////////////////////
 	EntityId                        id;
 	AABB                            aabb;
-	uint32                          bActivated : 1;
+	uint32                          bActivated   : 1;
+	uint32                          bSortQueued  : 1; // trigger waiting to be sorted in by the broadphase
+	uint32                          bInvalidated : 1; // trigger whose cached bounds were dropped by MoveTrigger
+	uint32                          axisIndex;        // of a trigger in the broadphase
 	std::vector<SProximityElement*> inside;
 
 	SProximityElement()
 	{
 		id = 0;
+		// the broadphase takes the bounds of a new trigger as its last bounds, the first move then covers the whole box
+		aabb = AABB(ZERO);
 		bActivated = 0;
+		bSortQueued = 0;
+		bInvalidated = 0;
+		axisIndex = 0;
 	}
 	~SProximityElement()
 	{
@@ -90,7 +99,8 @@ public:
 	void               GetMemoryUsage(ICrySizer* pSizer) const;
 
 private:
-	void CheckIfLeavingTrigger(SProximityElement* pEntity);
+	void QueueTriggerSort(SProximityElement* pTrigger);
+	void ProcessLeave(SProximityElement* pEntity, SProximityElement* pTrigger);
 	void ProcessOverlap(SProximityElement* pEntity, SProximityElement* pTrigger);
 	void RemoveFromTriggers(SProximityElement* pEntity, bool instantEvent = false);
 	void PurgeRemovedTriggers();
@@ -101,24 +111,18 @@ private:
 private:
 	typedef std::vector<SProximityElement*> Elements;
 
-	Elements                        m_triggers;
 	Elements                        m_triggersToRemove;
 	Elements                        m_entitiesToRemove;
-	bool                            m_bTriggerMoved;
+	Elements                        m_triggersToSort; // created or moved since the last update
 	bool                            m_bResetting;
 
 	std::vector<SProximityElement*> m_entities;
-	std::vector<AABB>               m_triggersAABB;
 
 	std::vector<SProximityEvent>    m_events;
 
-	RadixSort*                      m_pTriggerSorter;
-	RadixSort*                      m_pEntitySorter;
-
-	std::vector<float>              m_minPosList0;
-	std::vector<float>              m_minPosList1;
-	const uint32*                   m_Sorted0;
-	const uint32*                   m_Sorted1;
+	CProximityBroadphase            m_broadphase;
+	CProximityBroadphase::Pairs     m_leavingPairs;
+	CProximityBroadphase::Pairs     m_enteringPairs;
 
 public:
 	typedef stl::PoolAllocatorNoMT<sizeof(SProximityElement)> ProximityElement_PoolAlloc;
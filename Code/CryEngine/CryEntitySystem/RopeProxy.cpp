@@ -25,6 +25,7 @@ CRopeProxy::CRopeProxy()
 	, m_nSegmentsOrg(0)
 	, m_texTileVOrg(0.0f)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -22,7 +22,7 @@
 struct CSubstitutionProxy : IEntitySubstitutionProxy
 {
 public:
-	CSubstitutionProxy() { m_pSubstitute = 0; }
+	CSubstitutionProxy() { m_pSubstitute = 0; GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate); }
 	~CSubstitutionProxy() { if (m_pSubstitute) m_pSubstitute->ReleaseNode(); };
 
 	//////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,7 @@ CTriggerProxy::CTriggerProxy()
 	, m_pProximityTrigger(NULL)
 	, m_aabb(AABB::RESET)
 {
+	GetFlags().AddFlags(EComponentFlags_ThreadSafeUpdate);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -182,6 +182,9 @@
 // enable 'accurate' (sub-bit estimation) bandwidth profiling
 #define ENABLE_ACCURATE_BANDWIDTH_PROFILING 0
 
+// enable this to keep the symbols of the sent packets for net_streamCoderBenchmark (net_streamCoderCapture)
+#define ENABLE_STREAM_CODER_CAPTURE 0
+
 // enable this to start debugging that sequence numbers are not
 // being upset
 #define DEBUG_SEQUENCE_NUMBERS 0
@@ -365,6 +368,7 @@
 	#undef DEBUG_STREAM_INTEGRITY
 	#undef DEBUG_QUANTIZATION_CLAMPING
 	#undef ENABLE_ACCURATE_BANDWIDTH_PROFILING
+	#undef ENABLE_STREAM_CODER_CAPTURE
 	#undef DEBUG_SEQUENCE_NUMBERS
 	#undef DEBUG_TIME_COMPRESSION
 	#undef DETECT_DUPLICATE_ACKS
@@ -431,6 +435,7 @@
 	#define DEBUG_STREAM_INTEGRITY                     0
 	#define DEBUG_QUANTIZATION_CLAMPING                0
 	#define ENABLE_ACCURATE_BANDWIDTH_PROFILING        0
+	#define ENABLE_STREAM_CODER_CAPTURE                0
 	#define DEBUG_SEQUENCE_NUMBERS                     0
 	#define DEBUG_TIME_COMPRESSION                     0
 	#define DETECT_DUPLICATE_ACKS                      0
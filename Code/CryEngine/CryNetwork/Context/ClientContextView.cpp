@@ -41,6 +41,8 @@ CClientContextView::CClientContextView(CNetChannel* pNetChannel, CNetContext* pN
 #if ENABLE_DEBUG_KIT
 	m_pNetVis.reset(new CNetVis(this));
 #endif
+	m_snapshotChunkSend = 0;
+	m_snapshotChunkCount = 0;
 
 	SetMMM(pNetChannel->GetChannelMMM());
 	SContextViewConfiguration config = {
@@ -257,6 +259,7 @@ void CClientContextView::DefineProtocol(IProtocolBuilder* pBuilder)
 void CClientContextView::ChangeContext()
 {
 	CContextView::ChangeContext();
+	ResetSnapshots();
 }
 
 void CClientContextView::CompleteInitialization()
@@ -800,6 +803,147 @@ NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientContextView, VoiceData, eNRT_UnreliableUn
 }
 #endif
 
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientContextView, SnapshotChunk, eNRT_UnreliableUnordered, 0)
+{
+	uint32 sendID;
+	uint32 size;
+	uint32 chunk;
+	ser.Value("send", sendID, 'ui32');
+	ser.Value("size", size, 'ui32');
+	ser.Value("chunk", chunk, 'ui16');
+	if (size > CNetSnapshot::MAX_DELTA_SIZE)
+		return false;
+	const uint32 numChunks = max(1u, (size + CNetSnapshot::SEND_CHUNK_SIZE - 1) / CNetSnapshot::SEND_CHUNK_SIZE);
+	if (chunk >= numChunks)
+		return false;
+	const uint32 begin = chunk * CNetSnapshot::SEND_CHUNK_SIZE;
+	const uint32 length = min(size - begin, CNetSnapshot::SEND_CHUNK_SIZE);
+	uint8 buf[CNetSnapshot::SEND_CHUNK_SIZE];
+	for (uint32 i = 0; i < length; i++)
+		ser.Value("data", buf[i], 'ui8');
+
+	// chunks still in flight from the previous context
+	if (!ContextState() || !IsPastOrInState(eCVS_InGame))
+		return true;
+
+	if (numChunks == 1)
+		return ReceivedSnapshot(buf, length);
+
+	// the server sends a new delta every frame, chunks of an older one than the one being received are outdated
+	if (sendID != m_snapshotChunkSend)
+	{
+		if (sendID < m_snapshotChunkSend)
+			return true;
+		m_snapshotChunkSend = sendID;
+		m_snapshotChunkCount = 0;
+		m_snapshotChunkData.resize(size);
+		m_snapshotChunksReceived.assign(numChunks, 0);
+	}
+	if (m_snapshotChunkData.size() != size || m_snapshotChunksReceived.size() != numChunks)
+		return false;
+	if (m_snapshotChunksReceived[chunk])
+		return true;
+	m_snapshotChunksReceived[chunk] = 1;
+	memcpy(&m_snapshotChunkData[begin], buf, length);
+	if (++m_snapshotChunkCount < numChunks)
+		return true;
+
+	return ReceivedSnapshot(&m_snapshotChunkData[0], m_snapshotChunkData.size());
+}
+
+void CClientContextView::ResetSnapshots()
+{
+	m_snapshots.Reset();
+	m_snapshotChunkSend = 0;
+	m_snapshotChunkCount = 0;
+	stl::free_container(m_snapshotChunkData);
+	stl::free_container(m_snapshotChunksReceived);
+	m_snapshotDeferredKeys.resize(0);
+}
+
+bool CClientContextView::ReceivedSnapshot(const uint8* pData, size_t size)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_NETWORK);
+
+	uint32 seq, basisSeq;
+	if (!CNetSnapshot::PeekDeltaSeqs(pData, size, seq, basisSeq))
+		return false;
+
+	CNetSnapshotPtr pBasis;
+	if (basisSeq)
+	{
+		pBasis = m_snapshots.Get(basisSeq);
+		if (!pBasis)
+		{
+			NetWarning("Snapshot %u received without its basis %u", seq, basisSeq);
+			return true;
+		}
+	}
+
+	CNetSnapshotPtr pSnapshot = CNetSnapshot::ReadDelta(pBasis, pData, size, m_snapshotChangedKeys);
+	if (!pSnapshot)
+		return false;
+
+	// an older snapshot is kept as basis, but the newer one already brought its changes to the game.
+	// The same snapshot can arrive again, resent with the entries of newly bound objects.
+	CNetSnapshotPtr pLatest = m_snapshots.GetLatest();
+	m_snapshots.Insert(pSnapshot);
+	if (pLatest && pLatest->GetSeq() > seq)
+		return true;
+
+	if (!m_snapshotDeferredKeys.empty())
+	{
+		m_snapshotChangedKeys.insert(m_snapshotChangedKeys.end(), m_snapshotDeferredKeys.begin(), m_snapshotDeferredKeys.end());
+		std::sort(m_snapshotChangedKeys.begin(), m_snapshotChangedKeys.end());
+		m_snapshotChangedKeys.erase(std::unique(m_snapshotChangedKeys.begin(), m_snapshotChangedKeys.end()), m_snapshotChangedKeys.end());
+		m_snapshotDeferredKeys.resize(0);
+	}
+
+	for (CNetSnapshot::TKeys::const_iterator it = m_snapshotChangedKeys.begin(), end = m_snapshotChangedKeys.end(); it != end; ++it)
+	{
+		if (!ApplySnapshotEntry(pSnapshot, *it))
+			m_snapshotDeferredKeys.push_back(*it);
+	}
+	return true;
+}
+
+bool CClientContextView::ApplySnapshotEntry(const CNetSnapshot* pSnapshot, uint64 key)
+{
+	const SNetSnapshotEntry* pEntry = pSnapshot->Find(key);
+	if (!pEntry)
+		return true; // unbound or aspect disabled
+
+	const SNetObjectID objId = CNetSnapshot::GetKeyObjectID(key);
+	const NetworkAspectID aspectIdx = CNetSnapshot::GetKeyAspect(key);
+	SContextObjectRef obj = ContextState()->GetContextObject(objId);
+	if (!obj.main || !IsObjectBound(objId))
+		return false;
+	if (!(obj.xtra->nAspectsEnabled & BIT(aspectIdx)))
+		return true;
+	// we send the aspects we have authority over
+	if (GetSentAspects(objId, false, eGSAA_DefaultAuthority) & BIT(aspectIdx))
+		return true;
+	// the data would be read with the wrong profile, wait for the profile change to arrive
+	if (obj.main->vAspectProfiles[aspectIdx] != pEntry->profile)
+		return false;
+
+	CMementoMemoryManager& mmm = ContextState()->GetStateMMM();
+	TMemHdl& hdl = const_cast<TMemHdl&>(obj.xtra->vRemoteAspectData[aspectIdx]);
+	const uint8* pData = pSnapshot->GetData(*pEntry);
+	if (hdl != CMementoMemoryManager::InvalidHdl)
+	{
+		if (mmm.GetHdlSize(hdl) == pEntry->size && (!pEntry->size || 0 == memcmp(mmm.PinHdl(hdl), pData, pEntry->size)))
+			return true;
+		mmm.FreeHdl(hdl);
+	}
+	hdl = mmm.AllocHdl(pEntry->size);
+	if (pEntry->size)
+		memcpy(mmm.PinHdl(hdl), pData, pEntry->size);
+
+	ContextState()->NotifyGameOfAspectUpdate(objId, aspectIdx, Parent(), pSnapshot->GetTime());
+	return true;
+}
+
 NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientContextView, SetAspectProfile0, eNRT_UnreliableUnordered, 0)
 {
 	return SetAspectProfileMessage(0, ser);
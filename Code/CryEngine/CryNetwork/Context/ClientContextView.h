@@ -16,6 +16,7 @@
 
 #include "ContextView.h"
 #include "Authentication.h"
+#include "NetSnapshot.h"
 #include "DebugKit/NetVis.h"
 
 struct SDeclareBrokenProduct
@@ -62,7 +63,7 @@ struct SServerPublicAddress
 	#define CCV_NUM_EXTRA_MESSAGES (NUM_ASPECTS * 3)
 #endif
 
-#define CLIENTVIEW_MIN_NUM_MESSAGES 31
+#define CLIENTVIEW_MIN_NUM_MESSAGES 32
 
 // implements CContextView in a way that acts like a client
 class CClientContextView :
@@ -275,6 +276,8 @@ public:
 
 	NET_DECLARE_IMMEDIATE_MESSAGE(VoiceData);
 
+	NET_DECLARE_IMMEDIATE_MESSAGE(SnapshotChunk);
+
 	//NET_DECLARE_SIMPLE_IMMEDIATE_MESSAGE(InvalidatePredictedSpawn);
 
 	virtual bool        IsClient() const { return true; }
@@ -296,6 +299,11 @@ public:
 
 		pSizer->Add(*this);
 		pSizer->AddContainer(m_predictedSpawns);
+		m_snapshots.GetMemoryStatistics(pSizer);
+		pSizer->AddContainer(m_snapshotChunkData);
+		pSizer->AddContainer(m_snapshotChunksReceived);
+		pSizer->AddContainer(m_snapshotDeferredKeys);
+		pSizer->AddContainer(m_snapshotChangedKeys);
 		CContextView::GetMemoryStatistics(pSizer);
 
 #if !defined(OLD_VOICE_SYSTEM_DEPRECATED)
@@ -349,6 +357,21 @@ private:
 
 	std::set<EntityId> m_predictedSpawns;
 
+	// snapshot replication, see NetSnapshot.h
+	void                ResetSnapshots();
+	bool                ReceivedSnapshot(const uint8* pData, size_t size);
+	bool                ApplySnapshotEntry(const CNetSnapshot* pSnapshot, uint64 key);
+
+	CNetSnapshotHistory m_snapshots;
+	// chunks of the delta being received
+	uint32              m_snapshotChunkSend;
+	uint32              m_snapshotChunkCount;
+	std::vector<uint8>  m_snapshotChunkData;
+	std::vector<uint8>  m_snapshotChunksReceived;
+	// entries which couldn't be applied yet, because their object isn't bound or its profile differs
+	CNetSnapshot::TKeys m_snapshotDeferredKeys;
+	CNetSnapshot::TKeys m_snapshotChangedKeys;
+
 #if ENABLE_DEBUG_KIT
 	std::auto_ptr<CNetVis> m_pNetVis;
 	float                  m_startUpdate;
@@ -1204,13 +1204,24 @@ void CContextView::HandleAspectChanges(const std::pair<SNetObjectID, SNetObjectA
 		return;
 	}
 
+	// the snapshot aspects are sent with the next snapshot, only the remaining ones need an update message
+	const NetworkAspectType regularAspects = ~GetSnapshotAspects();
 	for (; pChanges->first; ++pChanges)
 	{
-		if (pChanges->second.aspectsChanged)
-			ChangedObject(pChanges->first, 0, pChanges->second.aspectsChanged);
+		const NetworkAspectType aspectsChanged = pChanges->second.aspectsChanged & regularAspects;
+		if (aspectsChanged)
+			ChangedObject(pChanges->first, 0, aspectsChanged);
 	}
 }
 
+NetworkAspectType CContextView::GetSnapshotAspects() const
+{
+	CNetContextState* pState = ContextState();
+	if (!IsServer() || IsLocal() || !pState || !pState->IsSnapshotReplicationEnabled())
+		return 0;
+	return pState->GetSnapshotAspects();
+}
+
 void CContextView::CompleteInitialization()
 {
 	if (gEnv->IsEditor() || (!gEnv->bMultiplayer))
@@ -1886,6 +1897,7 @@ void CContextView::SetSpawnState(SNetObjectID id, ESpawnState state)
 				for (int i = 0; i < NumAspects; i++)
 					PolluteObjectAspect(id, i);
 				ChangedObject(id, 0, NET_ASPECT_ALL);
+				OnObjectEnabled(id);
 			}
 			UpdateSchedulerState(id);
 		}
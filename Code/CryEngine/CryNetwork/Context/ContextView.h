@@ -261,6 +261,8 @@ public:
 	// is this a local view? (it communicates with another view that is
 	// in the same process and using the same CNetContext)
 	bool IsLocal() const { return m_bLocal; }
+	// aspects sent with the snapshots instead of the update messages (net_snapshotReplication), 0 if this view doesn't send snapshots
+	NetworkAspectType GetSnapshotAspects() const;
 	// set a password on this view
 	void SetPassword(const string& password);
 
@@ -322,7 +324,9 @@ protected:
 	static const char* GetWaitStateName(EContextViewState state);
 
 	// enable synchronization of an object
-	void SetSpawnState(SNetObjectID nID, ESpawnState state);
+	void         SetSpawnState(SNetObjectID nID, ESpawnState state);
+	// the remote view has bound the object, and it's ready to receive updates
+	virtual void OnObjectEnabled(SNetObjectID nID) {}
 
 	// what is our password?
 	const string& Password() const { return m_password; }
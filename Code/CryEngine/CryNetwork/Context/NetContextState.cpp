@@ -53,6 +53,7 @@ CNetContextState::CNetContextState(CNetContext* pContext, int token, CNetContext
 	m_pGameContext = pContext->GetGameContext();
 	m_token = token;
 	m_multiplayer = pContext->IsMultiplayer();
+	m_snapshotReplication = m_multiplayer && CNetCVars::Get().snapshotReplication != 0;
 	m_established = false;
 	m_bInCleanup = false;
 	m_bInGame = false;
@@ -553,6 +554,14 @@ void CNetContextState::FetchAndPropogateChangesFromGame(bool allowFetch)
 			}
 		}
 
+		if (allowFetch && gEnv->bServer)
+		{
+			// the server views send the new snapshot when they receive the change event
+			if (m_snapshotReplication)
+				CaptureSnapshot();
+			SNetSyncProfile::Get().EndFrame(m_snapshotReplication);
+		}
+
 		// add a terminator
 		changed.push_back(std::make_pair(SNetObjectID(), SNetObjectAspectChange()));
 
@@ -603,6 +612,44 @@ void CNetContextState::FetchAndPropogateChangesFromGame(bool allowFetch)
 	}
 }
 
+NetworkAspectType CNetContextState::GetSnapshotAspects() const
+{
+	// aspects only the controlling client receives differ per channel, they stay on the regular path
+	return m_pContext ? NetworkAspectType(~m_pContext->ServerControllerOnlyAspects()) : 0;
+}
+
+void CNetContextState::CaptureSnapshot()
+{
+	FUNCTION_PROFILER(gEnv->pSystem, PROFILE_NETWORK);
+	CNetSyncProfileSection profile(eNSPS_SnapshotCapture);
+
+	const NetworkAspectType snapshotAspects = GetSnapshotAspects();
+	CNetSnapshotPtr pSnapshot = new CNetSnapshot(m_snapshots.GetNextSeq(), m_localPhysicsTime);
+
+	// object ids are the index into m_vObjects, so the keys are added in increasing order
+	for (size_t i = 0; i < m_vObjects.size(); ++i)
+	{
+		const SContextObject& obj = m_vObjects[i];
+		if (!obj.bAllocated || !obj.userID)
+			continue;
+
+		const SContextObjectEx& objx = m_vObjectsEx[i];
+		const SNetObjectID netID(uint16(i), obj.salt);
+		NetworkAspectType aspects = objx.nAspectsEnabled & snapshotAspects;
+		for (NetworkAspectID aspectIdx = 0; aspects; ++aspectIdx, aspects >>= 1)
+		{
+			if (!(aspects & 1) || objx.vAspectData[aspectIdx] == CMementoMemoryManager::InvalidHdl)
+				continue;
+
+			const TMemHdl hdl = objx.vAspectData[aspectIdx];
+			pSnapshot->AddEntry(CNetSnapshot::MakeKey(netID, aspectIdx), objx.vAspectDataVersion[aspectIdx], obj.vAspectProfiles[aspectIdx],
+			                    m_pMMM->PinHdl(hdl), uint32(m_pMMM->GetHdlSize(hdl)));
+		}
+	}
+
+	m_snapshots.Push(pSnapshot);
+}
+
 void CNetContextState::PropogateProfileChangesToGame()
 {
 	if (!m_changedProfiles.empty())
@@ -3122,6 +3169,11 @@ void CNetContextState::GetMemoryStatistics(ICrySizer* pSizer)
 	    m_pVoiceContext->GetMemoryStatistics(pSizer);
 	 */
 
+	{
+		SIZER_SUBCOMPONENT_NAME(pSizer, "CNetContext::m_snapshots");
+		m_snapshots.GetMemoryStatistics(pSizer);
+	}
+
 	{
 		SIZER_SUBCOMPONENT_NAME(pSizer, "CNetContext::m_allEstablishers");
 		pSizer->AddContainer(m_allEstablishers);
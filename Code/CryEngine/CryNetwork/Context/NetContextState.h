@@ -11,6 +11,7 @@
 #include "ContextEstablisher.h"
 #include "ChangeList.h"
 #include "STLMementoAllocator.h"
+#include "NetSnapshot.h"
 
 class CNetContext;
 typedef _smart_ptr<CNetContext> CNetContextPtr;
@@ -177,6 +178,10 @@ public:
 	// broadcast an event
 	void                   Broadcast(SNetObjectEvent* pEvent);
 	CMementoMemoryManager& GetStateMMM() { return *m_pMMM; }
+	// snapshot replication (net_snapshotReplication), see NetSnapshot.h
+	bool                       IsSnapshotReplicationEnabled() const { return m_snapshotReplication; }
+	const CNetSnapshotHistory& GetSnapshotHistory() const           { return m_snapshots; }
+	NetworkAspectType          GetSnapshotAspects() const;
 #if ENABLE_THIN_BINDS
 	void                   UpdateBindAspectMask(SNetObjectID& netID, NetworkAspectType dirtyAspects);
 	NetworkAspectType      GetBindAspectMask(SNetObjectID& netID);
@@ -229,6 +234,7 @@ public:
 	IGameContext* GetGameContext();
 
 	void          FetchAndPropogateChangesFromGame(bool allowFetch);
+	void          CaptureSnapshot();
 	void          PropogateChangesToGame();
 	void          PropogateProfileChangesToGame();
 	void          PerformRegularCleanup();
@@ -424,6 +430,7 @@ private:
 	CNetContextPtr m_pContext;
 	IGameContext*  m_pGameContext;
 	bool           m_multiplayer;
+	bool           m_snapshotReplication;
 	bool           m_established;
 	// in PerformRegularCleanup
 	bool           m_bInCleanup;
@@ -481,6 +488,8 @@ private:
 
 	CTimeValue               m_localPhysicsTime;
 
+	CNetSnapshotHistory      m_snapshots;
+
 	typedef VectorMap<INetContextListenerPtr, SContextEstablisher, std::less<INetContextListenerPtr>, stl::STLGlobalAllocator<std::pair<INetContextListenerPtr, SContextEstablisher>>> EstablishersMap;
 	EstablishersMap m_allEstablishers;
 	EstablishersMap m_currentEstablishers;
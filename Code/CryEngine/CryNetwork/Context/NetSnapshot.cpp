@@ -0,0 +1,899 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "NetSnapshot.h"
+#include "ContextView.h"
+#include "NetCVars.h"
+#include <CrySystem/ITimer.h>
+#include <CrySystem/IConsole.h>
+
+// every entry of a delta starts with one of these
+enum ENetSnapshotOp
+{
+	eNSO_Removed,
+	eNSO_Unchanged,
+	eNSO_Raw,
+	eNSO_Xor,
+};
+
+static const uint32 MAX_SNAPSHOT_ENTRY_SIZE = 64 * 1024;
+
+class CNetSnapshotWriter
+{
+public:
+	CNetSnapshotWriter(std::vector<uint8>& out) : m_out(out) {}
+
+	void PutByte(uint8 value) { m_out.push_back(value); }
+
+	void PutVarInt(uint64 value)
+	{
+		while (value >= 0x80)
+		{
+			m_out.push_back(uint8(value) | 0x80);
+			value >>= 7;
+		}
+		m_out.push_back(uint8(value));
+	}
+
+	void Put(const uint8* pData, size_t size)
+	{
+		m_out.insert(m_out.end(), pData, pData + size);
+	}
+
+	// a placeholder for a count that's known only after writing the data it counts
+	size_t PutUInt32Placeholder()
+	{
+		const size_t ofs = m_out.size();
+		m_out.resize(ofs + 4);
+		return ofs;
+	}
+
+	void PatchUInt32(size_t ofs, uint32 value)
+	{
+		for (int i = 0; i < 4; ++i)
+			m_out[ofs + i] = uint8(value >> (i * 8));
+	}
+
+private:
+	std::vector<uint8>& m_out;
+};
+
+class CNetSnapshotReader
+{
+public:
+	CNetSnapshotReader(const uint8* pData, size_t size) : m_pCur(pData), m_pEnd(pData + size), m_ok(true) {}
+
+	bool  Ok() const    { return m_ok; }
+	bool  AtEnd() const { return m_pCur == m_pEnd; }
+
+	uint8 GetByte()
+	{
+		if (m_pCur == m_pEnd)
+		{
+			m_ok = false;
+			return 0;
+		}
+		return *m_pCur++;
+	}
+
+	uint64 GetVarInt()
+	{
+		uint64 value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			const uint8 b = GetByte();
+			value |= uint64(b & 0x7f) << shift;
+			if (!(b & 0x80))
+				return value;
+		}
+		m_ok = false;
+		return 0;
+	}
+
+	uint32 GetUInt32()
+	{
+		uint32 value = 0;
+		for (int i = 0; i < 4; ++i)
+			value |= uint32(GetByte()) << (i * 8);
+		return value;
+	}
+
+	const uint8* Get(size_t size)
+	{
+		if (size_t(m_pEnd - m_pCur) < size)
+		{
+			m_ok = false;
+			return NULL;
+		}
+		const uint8* p = m_pCur;
+		m_pCur += size;
+		return p;
+	}
+
+private:
+	const uint8* m_pCur;
+	const uint8* m_pEnd;
+	bool         m_ok;
+};
+
+// Writes cur XOR basis as runs of zero bytes and literal bytes. A single equal byte between differing ones stays in
+// the literal, a new run would cost more than the byte.
+static void WriteXorRuns(CNetSnapshotWriter& writer, const uint8* pBasis, const uint8* pCur, uint32 size)
+{
+	uint32 i = 0;
+	while (i < size)
+	{
+		uint32 zeros = 0;
+		while (i + zeros < size && pBasis[i + zeros] == pCur[i + zeros])
+			++zeros;
+		i += zeros;
+
+		uint32 literal = 0;
+		while (i + literal < size && (pBasis[i + literal] != pCur[i + literal] || (i + literal + 1 < size && pBasis[i + literal + 1] != pCur[i + literal + 1])))
+			++literal;
+
+		writer.PutVarInt(zeros);
+		writer.PutVarInt(literal);
+		for (uint32 j = 0; j < literal; ++j)
+			writer.PutByte(pBasis[i + j] ^ pCur[i + j]);
+		i += literal;
+	}
+}
+
+// pData holds the basis bytes and receives the current ones
+static bool ReadXorRuns(CNetSnapshotReader& reader, uint8* pData, uint32 size)
+{
+	uint32 i = 0;
+	while (i < size)
+	{
+		const uint64 zeros = reader.GetVarInt();
+		const uint64 literal = reader.GetVarInt();
+		if (!reader.Ok() || (!zeros && !literal) || zeros + literal > size - i)
+			return false;
+		i += uint32(zeros);
+
+		const uint8* pLiteral = reader.Get(size_t(literal));
+		if (!pLiteral)
+			return false;
+		for (uint32 j = 0; j < literal; ++j)
+			pData[i + j] ^= pLiteral[j];
+		i += uint32(literal);
+	}
+	return true;
+}
+
+CNetSnapshot::CNetSnapshot(uint32 seq, CTimeValue time)
+	: m_seq(seq)
+	, m_time(time)
+{
+}
+
+const SNetSnapshotEntry* CNetSnapshot::Find(uint64 key) const
+{
+	TEntries::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), key, [](const SNetSnapshotEntry& entry, uint64 k) { return entry.key < k; });
+	return (it != m_entries.end() && it->key == key) ? &*it : NULL;
+}
+
+void CNetSnapshot::AddEntry(uint64 key, uint32 version, uint8 profile, const void* pData, uint32 size)
+{
+	NET_ASSERT(m_entries.empty() || m_entries.back().key < key);
+
+	SNetSnapshotEntry entry;
+	entry.key = key;
+	entry.version = version;
+	entry.offset = uint32(m_data.size());
+	entry.size = size;
+	entry.profile = profile;
+	m_entries.push_back(entry);
+
+	m_data.insert(m_data.end(), (const uint8*)pData, (const uint8*)pData + size);
+}
+
+void CNetSnapshot::WriteDelta(const CNetSnapshot* pBasis, const TKeys& keys, const TKeys& forcedKeys, const CContextView* pView, std::vector<uint8>& out) const
+{
+	out.clear();
+	CNetSnapshotWriter writer(out);
+	writer.PutVarInt(m_seq);
+	writer.PutVarInt(pBasis ? pBasis->m_seq : 0);
+	writer.PutVarInt(uint64(m_time.GetValue()));
+	const size_t countOfs = writer.PutUInt32Placeholder();
+
+	uint32 count = 0;
+	uint64 prevKey = 0;
+
+	if (!pBasis)
+	{
+		for (TEntries::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it)
+		{
+			if (pView && !pView->IsObjectEnabled(GetKeyObjectID(it->key)))
+				continue;
+			writer.PutVarInt(it->key - prevKey);
+			writer.PutByte(eNSO_Raw);
+			writer.PutByte(it->profile);
+			writer.PutVarInt(it->size);
+			writer.Put(GetData(*it), it->size);
+			prevKey = it->key;
+			++count;
+		}
+		writer.PatchUInt32(countOfs, count);
+		return;
+	}
+
+	std::vector<uint8> xorRuns;
+	TKeys::const_iterator itKey = keys.begin(), endKey = keys.end();
+	TKeys::const_iterator itForced = forcedKeys.begin(), endForced = forcedKeys.end();
+	while (itKey != endKey || itForced != endForced)
+	{
+		uint64 key;
+		bool forced = false;
+		if (itForced == endForced || (itKey != endKey && *itKey < *itForced))
+		{
+			key = *itKey++;
+		}
+		else
+		{
+			if (itKey != endKey && *itKey == *itForced)
+				++itKey;
+			key = *itForced++;
+			forced = true;
+		}
+
+		const SNetSnapshotEntry* pCur = Find(key);
+		const SNetSnapshotEntry* pOld = pBasis->Find(key);
+		if (!pCur && !pOld)
+			continue;   // added and removed again since the basis
+		// the client may not have the basis entry of an object which wasn't enabled on its view, the forced entries
+		// bring it once the object is enabled. Removals are sent anyway.
+		if (pCur && pView && !pView->IsObjectEnabled(GetKeyObjectID(key)))
+			continue;
+
+		uint8 op;
+		if (!pCur)
+		{
+			op = eNSO_Removed;
+		}
+		else if (forced || !pOld || pOld->size != pCur->size)
+		{
+			op = eNSO_Raw;
+		}
+		else if (pOld->profile == pCur->profile && !memcmp(pBasis->GetData(*pOld), GetData(*pCur), pCur->size))
+		{
+			continue;   // changed back to the basis value
+		}
+		else
+		{
+			xorRuns.clear();
+			CNetSnapshotWriter xorWriter(xorRuns);
+			WriteXorRuns(xorWriter, pBasis->GetData(*pOld), GetData(*pCur), pCur->size);
+			op = xorRuns.size() < pCur->size ? eNSO_Xor : eNSO_Raw;
+		}
+
+		writer.PutVarInt(key - prevKey);
+		writer.PutByte(op);
+		switch (op)
+		{
+		case eNSO_Raw:
+			writer.PutByte(pCur->profile);
+			writer.PutVarInt(pCur->size);
+			writer.Put(GetData(*pCur), pCur->size);
+			break;
+		case eNSO_Xor:
+			writer.PutByte(pCur->profile);
+			writer.Put(&xorRuns[0], xorRuns.size());
+			break;
+		}
+		prevKey = key;
+		++count;
+	}
+
+	writer.PatchUInt32(countOfs, count);
+}
+
+bool CNetSnapshot::PeekDeltaSeqs(const uint8* pData, size_t size, uint32& seq, uint32& basisSeq)
+{
+	CNetSnapshotReader reader(pData, size);
+	seq = uint32(reader.GetVarInt());
+	basisSeq = uint32(reader.GetVarInt());
+	return reader.Ok();
+}
+
+CNetSnapshotPtr CNetSnapshot::ReadDelta(const CNetSnapshot* pBasis, const uint8* pData, size_t size, TKeys& changedKeys)
+{
+	changedKeys.resize(0);
+
+	CNetSnapshotReader reader(pData, size);
+	const uint32 seq = uint32(reader.GetVarInt());
+	const uint32 basisSeq = uint32(reader.GetVarInt());
+	const int64 time = int64(reader.GetVarInt());
+	const uint32 count = reader.GetUInt32();
+	if (!reader.Ok())
+		return NULL;
+
+	if (!basisSeq)
+		pBasis = NULL;
+	else if (!pBasis || pBasis->m_seq != basisSeq)
+		return NULL;
+
+	CNetSnapshotPtr pSnapshot = new CNetSnapshot(seq, CTimeValue(time));
+	TEntries::const_iterator itBasis, endBasis;
+	if (pBasis)
+	{
+		pSnapshot->m_entries.reserve(pBasis->m_entries.size());
+		pSnapshot->m_data.reserve(pBasis->m_data.size());
+		itBasis = pBasis->m_entries.begin();
+		endBasis = pBasis->m_entries.end();
+	}
+
+	uint64 key = 0;
+	for (uint32 i = 0; i < count; ++i)
+	{
+		const uint64 keyDelta = reader.GetVarInt();
+		if (i && !keyDelta)
+			return NULL;
+		key += keyDelta;
+
+		const SNetSnapshotEntry* pOld = NULL;
+		if (pBasis)
+		{
+			for (; itBasis != endBasis && itBasis->key < key; ++itBasis)
+				pSnapshot->AddEntry(itBasis->key, 0, itBasis->profile, pBasis->GetData(*itBasis), itBasis->size);
+			if (itBasis != endBasis && itBasis->key == key)
+				pOld = &*itBasis++;
+		}
+
+		const uint8 op = reader.GetByte();
+		switch (op)
+		{
+		case eNSO_Removed:
+			// an entry of an object which wasn't enabled on the view, the client may never have received it
+			continue;
+		case eNSO_Unchanged:
+			if (!pOld)
+				return NULL;
+			pSnapshot->AddEntry(key, 0, pOld->profile, pBasis->GetData(*pOld), pOld->size);
+			break;
+		case eNSO_Raw:
+			{
+				const uint8 profile = reader.GetByte();
+				const uint64 entrySize = reader.GetVarInt();
+				if (!reader.Ok() || entrySize > MAX_SNAPSHOT_ENTRY_SIZE)
+					return NULL;
+				const uint8* pEntryData = reader.Get(size_t(entrySize));
+				if (!pEntryData)
+					return NULL;
+				pSnapshot->AddEntry(key, 0, profile, pEntryData, uint32(entrySize));
+			}
+			break;
+		case eNSO_Xor:
+			{
+				const uint8 profile = reader.GetByte();
+				if (!pOld || !reader.Ok())
+					return NULL;
+				pSnapshot->AddEntry(key, 0, profile, pBasis->GetData(*pOld), pOld->size);
+				if (pOld->size && !ReadXorRuns(reader, &pSnapshot->m_data[pSnapshot->m_entries.back().offset], pOld->size))
+					return NULL;
+			}
+			break;
+		default:
+			return NULL;
+		}
+
+		changedKeys.push_back(key);
+	}
+
+	if (pBasis)
+	{
+		for (; itBasis != endBasis; ++itBasis)
+			pSnapshot->AddEntry(itBasis->key, 0, itBasis->profile, pBasis->GetData(*itBasis), itBasis->size);
+	}
+
+	if (!reader.Ok() || !reader.AtEnd())
+		return NULL;
+
+	return pSnapshot;
+}
+
+void CNetSnapshot::GetMemoryStatistics(ICrySizer* pSizer) const
+{
+	pSizer->Add(*this);
+	pSizer->AddContainer(m_entries);
+	pSizer->AddContainer(m_data);
+	pSizer->AddContainer(m_changedKeys);
+}
+
+CNetSnapshotHistory::CNetSnapshotHistory()
+	: m_latestSeq(0)
+{
+}
+
+void CNetSnapshotHistory::Reset()
+{
+	for (uint32 i = 0; i < HISTORY_SIZE; ++i)
+		m_snapshots[i] = NULL;
+	m_latestSeq = 0;
+	m_deltaCache.clear();
+	m_deltaSizeCache.clear();
+}
+
+bool CNetSnapshotHistory::Push(const CNetSnapshotPtr& pSnapshot)
+{
+	NET_ASSERT(pSnapshot->GetSeq() == GetNextSeq());
+
+	CNetSnapshot::TKeys& changedKeys = pSnapshot->m_changedKeys;
+	changedKeys.resize(0);
+
+	const CNetSnapshot::TEntries& entries = pSnapshot->GetEntries();
+	if (CNetSnapshotPtr pPrev = GetLatest())
+	{
+		const CNetSnapshot::TEntries& prevEntries = pPrev->GetEntries();
+		CNetSnapshot::TEntries::const_iterator itPrev = prevEntries.begin(), endPrev = prevEntries.end();
+		CNetSnapshot::TEntries::const_iterator it = entries.begin(), end = entries.end();
+		while (itPrev != endPrev || it != end)
+		{
+			if (it == end || (itPrev != endPrev && itPrev->key < it->key))
+			{
+				changedKeys.push_back(itPrev->key);
+				++itPrev;
+			}
+			else if (itPrev == endPrev || it->key < itPrev->key)
+			{
+				changedKeys.push_back(it->key);
+				++it;
+			}
+			else
+			{
+				if (it->version != itPrev->version || it->profile != itPrev->profile || it->size != itPrev->size)
+					changedKeys.push_back(it->key);
+				++it;
+				++itPrev;
+			}
+		}
+
+		if (changedKeys.empty())
+			return false;
+	}
+	else
+	{
+		changedKeys.reserve(entries.size());
+		for (CNetSnapshot::TEntries::const_iterator it = entries.begin(), end = entries.end(); it != end; ++it)
+			changedKeys.push_back(it->key);
+	}
+
+	Insert(pSnapshot);
+	return true;
+}
+
+void CNetSnapshotHistory::Insert(const CNetSnapshotPtr& pSnapshot)
+{
+	m_snapshots[pSnapshot->GetSeq() % HISTORY_SIZE] = pSnapshot;
+	m_latestSeq = max(m_latestSeq, pSnapshot->GetSeq());
+	m_deltaCache.clear();
+	m_deltaSizeCache.clear();
+}
+
+CNetSnapshotPtr CNetSnapshotHistory::GetLatest() const
+{
+	return m_latestSeq ? Get(m_latestSeq) : CNetSnapshotPtr();
+}
+
+CNetSnapshotPtr CNetSnapshotHistory::Get(uint32 seq) const
+{
+	const CNetSnapshotPtr& pSnapshot = m_snapshots[seq % HISTORY_SIZE];
+	return (pSnapshot && pSnapshot->GetSeq() == seq) ? pSnapshot : CNetSnapshotPtr();
+}
+
+TNetSnapshotDeltaPtr CNetSnapshotHistory::GetDelta(uint32 basisSeq, const std::vector<SNetObjectID>& forcedObjects, const CContextView* pView, uint32 maxSize) const
+{
+	CNetSnapshotPtr pLatest = GetLatest();
+	if (!pLatest)
+		return NULL;
+
+	CNetSnapshotPtr pBasis = (basisSeq && basisSeq < m_latestSeq) ? Get(basisSeq) : CNetSnapshotPtr();
+	basisSeq = pBasis ? basisSeq : 0;
+
+	if (forcedObjects.empty())
+	{
+		for (std::vector<TNetSnapshotDeltaPtr>::const_iterator it = m_deltaCache.begin(), end = m_deltaCache.end(); it != end; ++it)
+		{
+			const SNetSnapshotDelta& delta = **it;
+			if (delta.basisSeq != basisSeq || delta.maxSize != maxSize)
+				continue;
+			const CNetSnapshotPtr pTarget = Get(delta.seq);
+			if (pTarget && IsEnabledOn(delta, *pTarget, pView))
+				return *it;
+		}
+	}
+
+	TNetSnapshotDeltaPtr pDelta;
+
+	// a client which fell behind catches up over several deltas of a bounded size instead of one ever growing delta,
+	// which would be lost again and again
+	if (pBasis && maxSize && m_latestSeq - basisSeq > 1 && GetDeltaSize(pBasis, m_latestSeq, forcedObjects, pView, pDelta) > maxSize)
+	{
+		uint32 fits = basisSeq + 1, tooLarge = m_latestSeq;
+		TNetSnapshotDeltaPtr pCandidate;
+		pDelta = NULL;
+		if (GetDeltaSize(pBasis, fits, forcedObjects, pView, pCandidate) <= maxSize)
+		{
+			pDelta = pCandidate;
+			while (tooLarge - fits > 1)
+			{
+				const uint32 seq = fits + (tooLarge - fits) / 2;
+				if (GetDeltaSize(pBasis, seq, forcedObjects, pView, pCandidate) <= maxSize)
+				{
+					pDelta = pCandidate;
+					fits = seq;
+				}
+				else
+				{
+					tooLarge = seq;
+				}
+			}
+		}
+		// the size of the delta which fits may have come from the cache
+		if (!pDelta || pDelta->seq != fits)
+			pDelta = MakeDelta(pBasis, Get(fits), forcedObjects, pView);
+	}
+	if (!pDelta)
+		pDelta = MakeDelta(pBasis, pLatest, forcedObjects, pView);
+	pDelta->maxSize = maxSize;
+
+	if (pDelta->shared)
+		m_deltaCache.push_back(pDelta);
+	return pDelta;
+}
+
+uint32 CNetSnapshotHistory::GetDeltaSize(const CNetSnapshot* pBasis, uint32 seq, const std::vector<SNetObjectID>& forcedObjects, const CContextView* pView, TNetSnapshotDeltaPtr& pDelta) const
+{
+	const uint32 basisSeq = pBasis->GetSeq();
+
+	// forced objects only make a delta larger, and left out ones smaller: the size of a shared delta is an upper bound
+	// for every client without forced objects
+	if (forcedObjects.empty())
+	{
+		for (std::vector<SDeltaSize>::const_iterator it = m_deltaSizeCache.begin(), end = m_deltaSizeCache.end(); it != end; ++it)
+		{
+			if (it->basisSeq == basisSeq && it->seq == seq)
+			{
+				pDelta = NULL;
+				return it->size;
+			}
+		}
+	}
+
+	pDelta = MakeDelta(pBasis, Get(seq), forcedObjects, pView);
+	const uint32 size = (uint32)pDelta->data.size();
+	if (pDelta->shared)
+	{
+		const SDeltaSize deltaSize = { basisSeq, seq, size };
+		m_deltaSizeCache.push_back(deltaSize);
+	}
+	return size;
+}
+
+TNetSnapshotDeltaPtr CNetSnapshotHistory::MakeDelta(const CNetSnapshot* pBasis, const CNetSnapshot* pTarget, const std::vector<SNetObjectID>& forcedObjects, const CContextView* pView) const
+{
+	const uint32 basisSeq = pBasis ? pBasis->GetSeq() : 0;
+	const uint32 targetSeq = pTarget->GetSeq();
+
+	TNetSnapshotDeltaPtr pDelta = new SNetSnapshotDelta;
+	pDelta->seq = targetSeq;
+	pDelta->basisSeq = basisSeq;
+	pDelta->maxSize = 0;
+	pDelta->shared = forcedObjects.empty();
+
+	m_tempKeys.resize(0);
+	m_tempForcedKeys.resize(0);
+	if (pBasis)
+	{
+		// every snapshot newer than the basis is still in the history, the basis would have been overwritten first
+		for (uint32 seq = basisSeq + 1; seq <= targetSeq; ++seq)
+		{
+			const CNetSnapshot::TKeys& changedKeys = Get(seq)->GetChangedKeys();
+			m_tempKeys.insert(m_tempKeys.end(), changedKeys.begin(), changedKeys.end());
+		}
+		if (targetSeq - basisSeq > 1)
+		{
+			std::sort(m_tempKeys.begin(), m_tempKeys.end());
+			m_tempKeys.erase(std::unique(m_tempKeys.begin(), m_tempKeys.end()), m_tempKeys.end());
+		}
+
+		const CNetSnapshot::TEntries& entries = pTarget->GetEntries();
+		for (std::vector<SNetObjectID>::const_iterator itObj = forcedObjects.begin(), endObj = forcedObjects.end(); itObj != endObj; ++itObj)
+		{
+			const uint64 firstKey = CNetSnapshot::MakeKey(*itObj, 0);
+			CNetSnapshot::TEntries::const_iterator it = std::lower_bound(entries.begin(), entries.end(), firstKey, [](const SNetSnapshotEntry& entry, uint64 k) { return entry.key < k; });
+			for (; it != entries.end() && it->key - firstKey < 256; ++it)
+				m_tempForcedKeys.push_back(it->key);
+		}
+		std::sort(m_tempForcedKeys.begin(), m_tempForcedKeys.end());
+		m_tempForcedKeys.erase(std::unique(m_tempForcedKeys.begin(), m_tempForcedKeys.end()), m_tempForcedKeys.end());
+
+		pDelta->keys.swap(m_tempKeys);
+	}
+
+	// entries of objects which aren't enabled on the view make the delta specific to it
+	if (pDelta->shared && pView && !IsEnabledOn(*pDelta, *pTarget, pView))
+		pDelta->shared = false;
+
+	pTarget->WriteDelta(pBasis, pDelta->keys, m_tempForcedKeys, pDelta->shared ? NULL : pView, pDelta->data);
+
+	if (!pDelta->shared)
+	{
+		m_tempKeys.swap(pDelta->keys);
+		m_tempKeys.resize(0);
+	}
+	return pDelta;
+}
+
+bool CNetSnapshotHistory::IsEnabledOn(const SNetSnapshotDelta& delta, const CNetSnapshot& target, const CContextView* pView)
+{
+	if (!pView)
+		return true;
+
+	if (delta.basisSeq)
+	{
+		for (CNetSnapshot::TKeys::const_iterator it = delta.keys.begin(), end = delta.keys.end(); it != end; ++it)
+		{
+			// removed entries are sent anyway
+			if (target.Find(*it) && !pView->IsObjectEnabled(CNetSnapshot::GetKeyObjectID(*it)))
+				return false;
+		}
+	}
+	else
+	{
+		const CNetSnapshot::TEntries& entries = target.GetEntries();
+		for (CNetSnapshot::TEntries::const_iterator it = entries.begin(), end = entries.end(); it != end; ++it)
+		{
+			if (!pView->IsObjectEnabled(CNetSnapshot::GetKeyObjectID(it->key)))
+				return false;
+		}
+	}
+	return true;
+}
+
+void CNetSnapshotHistory::GetMemoryStatistics(ICrySizer* pSizer) const
+{
+	for (uint32 i = 0; i < HISTORY_SIZE; ++i)
+	{
+		if (m_snapshots[i])
+			m_snapshots[i]->GetMemoryStatistics(pSizer);
+	}
+	for (std::vector<TNetSnapshotDeltaPtr>::const_iterator it = m_deltaCache.begin(), end = m_deltaCache.end(); it != end; ++it)
+	{
+		pSizer->AddContainer((*it)->data);
+		pSizer->AddContainer((*it)->keys);
+	}
+	pSizer->AddContainer(m_deltaCache);
+	pSizer->AddContainer(m_deltaSizeCache);
+	pSizer->AddContainer(m_tempKeys);
+	pSizer->AddContainer(m_tempForcedKeys);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// net_snapshotBenchmark
+
+SNetSyncProfile& SNetSyncProfile::Get()
+{
+	static SNetSyncProfile profile;
+	return profile;
+}
+
+void SNetSyncProfile::Start(uint32 numFrames)
+{
+	memset(sections, 0, sizeof(sections));
+	frames = 0;
+	framesLeft = numFrames;
+}
+
+void SNetSyncProfile::EndFrame(bool snapshotReplication)
+{
+	if (!framesLeft)
+		return;
+	snapshotMode = snapshotReplication;
+	++frames;
+	if (--framesLeft)
+		return;
+
+	static const char* const names[eNSPS_Num] = { "update messages", "snapshot capture", "snapshot deltas", "snapshot chunks" };
+	CryLogAlways("Aspect sync over %u frames, %s:", frames, snapshotMode ? "snapshot replication" : "per object updates");
+	CTimeValue totalTime;
+	uint64 totalBytes = 0;
+	for (int i = 0; i < eNSPS_Num; ++i)
+	{
+		const SSection& section = sections[i];
+		CryLogAlways("  %-16s %8.1f per frame, %8.1f us/frame, %9.0f bytes/frame", names[i],
+		             float(section.count) / frames, section.time.GetSeconds() * 1e6f / frames, float(section.bytes) / frames);
+		totalTime += section.time;
+		totalBytes += section.bytes;
+	}
+	CryLogAlways("  %-16s %8s           %8.1f us/frame, %9.0f bytes/frame", "total", "", totalTime.GetSeconds() * 1e6f / frames, float(totalBytes) / frames);
+}
+
+CNetSyncProfileSection::CNetSyncProfileSection(ENetSyncProfileSection section, INetSender* pSender)
+	: m_section(section)
+	, m_pSender(pSender)
+	, m_startSize(0)
+	, m_bytes(0)
+	, m_sampling(SNetSyncProfile::Get().IsSampling())
+{
+	if (m_sampling)
+	{
+		m_startSize = pSender ? pSender->GetStreamSize() : 0;
+		m_start = gEnv->pTimer->GetAsyncTime();
+	}
+}
+
+CNetSyncProfileSection::~CNetSyncProfileSection()
+{
+	if (!m_sampling)
+		return;
+	SNetSyncProfile::SSection& section = SNetSyncProfile::Get().sections[m_section];
+	section.time += gEnv->pTimer->GetAsyncTime() - m_start;
+	section.bytes += m_bytes + (m_pSender ? m_pSender->GetStreamSize() - m_startSize : 0);
+	++section.count;
+}
+
+void NetSnapshotBenchmark(IConsoleCmdArgs* pArgs)
+{
+	const uint32 numFrames = pArgs->GetArgCount() > 1 ? max(1, atoi(pArgs->GetArg(1))) : 300;
+	if (!gEnv->bServer)
+	{
+		CryLogAlways("net_snapshotBenchmark samples the server, it has to run in a server context");
+		return;
+	}
+
+	SCOPED_GLOBAL_LOCK;
+	SNetSyncProfile::Get().Start(numFrames);
+	CryLogAlways("Sampling the aspect sync for %u frames, compare with net_snapshotReplication %d after the next level load", numFrames, CNetCVars::Get().snapshotReplication ? 0 : 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// net_snapshotSimulate
+
+namespace NetSnapshotSimulateDetail
+{
+static const NetworkAspectID NUM_SIMULATED_ASPECTS = 4;
+static const uint32 ACK_DELAY_TICKS = 3;
+
+struct SAspect
+{
+	std::vector<uint8> data;
+	uint32             version;
+};
+
+struct SClient
+{
+	CNetSnapshotHistory received;
+	uint32              ackedSeq;
+	// acks in flight: snapshot sequence and the tick they arrive at the server
+	std::deque<std::pair<uint32, uint32>> pendingAcks;
+};
+
+static uint32 Random(uint32& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return state >> 8;
+}
+
+static bool IsEqual(const CNetSnapshot& a, const CNetSnapshot& b)
+{
+	const CNetSnapshot::TEntries& entriesA = a.GetEntries();
+	const CNetSnapshot::TEntries& entriesB = b.GetEntries();
+	bool equal = entriesA.size() == entriesB.size();
+	for (size_t i = 0; equal && i < entriesA.size(); ++i)
+	{
+		equal = entriesA[i].key == entriesB[i].key && entriesA[i].size == entriesB[i].size &&
+		        !memcmp(a.GetData(entriesA[i]), b.GetData(entriesB[i]), entriesA[i].size);
+	}
+	return equal;
+}
+}
+
+void NetSnapshotSimulate(IConsoleCmdArgs* pArgs)
+{
+	using namespace NetSnapshotSimulateDetail;
+
+	const uint32 numObjects = pArgs->GetArgCount() > 1 ? clamp_tpl(atoi(pArgs->GetArg(1)), 1, 60000) : 2000;
+	const uint32 numClients = pArgs->GetArgCount() > 2 ? max(1, atoi(pArgs->GetArg(2))) : 32;
+	const uint32 numTicks = pArgs->GetArgCount() > 3 ? max(1, atoi(pArgs->GetArg(3))) : 300;
+	const float changeRatio = pArgs->GetArgCount() > 4 ? clamp_tpl((float)atof(pArgs->GetArg(4)), 0.0f, 1.0f) : 0.05f;
+	const uint32 lossPercent = pArgs->GetArgCount() > 5 ? clamp_tpl(atoi(pArgs->GetArg(5)), 0, 100) : 5;
+	const uint32 maxDeltaSize = uint32(max(0, CNetCVars::Get().snapshotMaxDeltaSize));
+
+	const uint32 numAspects = numObjects * NUM_SIMULATED_ASPECTS;
+	uint32 randomState = 0x5eed;
+
+	std::vector<SAspect> world(numAspects);
+	for (uint32 i = 0; i < numAspects; ++i)
+	{
+		world[i].data.resize(16 + Random(randomState) % 80);
+		for (size_t j = 0; j < world[i].data.size(); ++j)
+			world[i].data[j] = uint8(Random(randomState));
+		world[i].version = 1;
+	}
+
+	std::vector<SClient> clients(numClients);
+	for (uint32 c = 0; c < numClients; ++c)
+		clients[c].ackedSeq = 0;
+
+	ITimer* pTimer = gEnv->pTimer;
+	CNetSnapshotHistory history;
+	const std::vector<SNetObjectID> noForcedObjects;
+	CNetSnapshot::TKeys changedKeys;
+
+	CTimeValue captureTime, encodeTime, decodeTime;
+	uint64 snapshotBytes = 0;
+	uint32 deltas = 0, cappedDeltas = 0, decodeFailures = 0, mismatches = 0;
+
+	for (uint32 tick = 1; tick <= numTicks; ++tick)
+	{
+		// the game changes a part of the world, a few bytes each as a moving object would
+		const uint32 numChanges = uint32(numAspects * changeRatio);
+		for (uint32 i = 0; i < numChanges; ++i)
+		{
+			SAspect& aspect = world[Random(randomState) % numAspects];
+			const uint32 numBytes = 1 + Random(randomState) % 4;
+			for (uint32 j = 0; j < numBytes; ++j)
+				aspect.data[Random(randomState) % aspect.data.size()] ^= uint8(1 + Random(randomState) % 255);
+			++aspect.version;
+		}
+
+		// one capture for everybody, one delta per client
+		CTimeValue start = pTimer->GetAsyncTime();
+		CNetSnapshotPtr pSnapshot = new CNetSnapshot(history.GetNextSeq(), CTimeValue(int64(tick)));
+		for (uint32 i = 0; i < numAspects; ++i)
+		{
+			const SNetObjectID objId(uint16(i / NUM_SIMULATED_ASPECTS), 1);
+			pSnapshot->AddEntry(CNetSnapshot::MakeKey(objId, NetworkAspectID(i % NUM_SIMULATED_ASPECTS)), world[i].version, 0, &world[i].data[0], uint32(world[i].data.size()));
+		}
+		history.Push(pSnapshot);
+		captureTime += pTimer->GetAsyncTime() - start;
+
+		for (uint32 c = 0; c < numClients; ++c)
+		{
+			SClient& client = clients[c];
+			while (!client.pendingAcks.empty() && client.pendingAcks.front().second <= tick)
+			{
+				client.ackedSeq = max(client.ackedSeq, client.pendingAcks.front().first);
+				client.pendingAcks.pop_front();
+			}
+			if (client.ackedSeq == history.GetNextSeq() - 1)
+				continue;
+
+			start = pTimer->GetAsyncTime();
+			TNetSnapshotDeltaPtr pDelta = history.GetDelta(client.ackedSeq, noForcedObjects, NULL, maxDeltaSize);
+			encodeTime += pTimer->GetAsyncTime() - start;
+			const std::vector<uint8>& delta = pDelta->data;
+			snapshotBytes += delta.size();
+			++deltas;
+			cappedDeltas += pDelta->seq != history.GetNextSeq() - 1 ? 1 : 0;
+
+			if (Random(randomState) % 100 < lossPercent)
+				continue;
+
+			start = pTimer->GetAsyncTime();
+			CNetSnapshotPtr pBasis = pDelta->basisSeq ? client.received.Get(pDelta->basisSeq) : CNetSnapshotPtr();
+			CNetSnapshotPtr pReceived = CNetSnapshot::ReadDelta(pBasis, &delta[0], delta.size(), changedKeys);
+			decodeTime += pTimer->GetAsyncTime() - start;
+			if (!pReceived)
+			{
+				++decodeFailures;
+				continue;
+			}
+			// the client has to hold exactly the snapshot the delta was written for
+			mismatches += IsEqual(*history.Get(pDelta->seq), *pReceived) ? 0 : 1;
+			client.received.Insert(pReceived);
+			if (Random(randomState) % 100 >= lossPercent)
+				client.pendingAcks.push_back(std::make_pair(pDelta->seq, tick + ACK_DELAY_TICKS));
+		}
+	}
+
+	const float clientTicks = float(numClients) * float(numTicks);
+	CryLogAlways("Snapshot simulation: %u objects, %u aspects, %u clients, %u ticks, %.1f%% changed per tick, %u%% loss, deltas up to %u bytes",
+	             numObjects, numAspects, numClients, numTicks, changeRatio * 100.0f, lossPercent, maxDeltaSize);
+	CryLogAlways("  capture %.1f us/tick, encode %.2f us/client/tick, decode %.2f us/client/tick, %.0f bytes/client/tick",
+	             captureTime.GetSeconds() * 1e6f / numTicks, encodeTime.GetSeconds() * 1e6f / clientTicks, decodeTime.GetSeconds() * 1e6f / clientTicks,
+	             float(snapshotBytes) / clientTicks);
+	CryLogAlways("  %u deltas, %u of them capped, %u decode failures, %u rebuilt snapshots differ from the server", deltas, cappedDeltas, decodeFailures, mismatches);
+}
@@ -0,0 +1,210 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#ifndef __NETSNAPSHOT_H__
+#define __NETSNAPSHOT_H__
+
+#pragma once
+
+#include <CryNetwork/ISerialize.h>
+#include <CrySystem/TimeValue.h>
+
+class CContextView;
+
+// Snapshot replication (net_snapshotReplication).
+// The regular aspect sync runs every changed object through the memento histories of every channel, so the server
+// cost grows with players * objects. In snapshot mode the server copies the aspect data of all bound objects once per
+// tick into a CNetSnapshot shared by all channels, and every client is sent the delta of the newest snapshot against
+// the last one it acknowledged: only the aspect buffers which changed in between, XOR-ed against the basis and zero run
+// length encoded. Every snapshot keeps the keys which changed against its predecessor, so building a delta only
+// touches the changed entries, never the whole world.
+// A client which fell behind by more than net_snapshotMaxDeltaSize bytes is sent the delta to the newest snapshot which
+// still fits instead, and catches up over several deltas.
+// Entries of objects which aren't enabled on the client's view are left out of its deltas, they are sent in full once
+// the object gets enabled.
+
+struct SNetSnapshotEntry
+{
+	uint64 key;       // object id, salt and aspect index, see CNetSnapshot::MakeKey
+	uint32 version;   // aspect data version at capture, server side only
+	uint32 offset;    // into the snapshot data
+	uint32 size;
+	uint8  profile;
+};
+
+class CNetSnapshot : public CMultiThreadRefCount
+{
+public:
+	typedef std::vector<SNetSnapshotEntry> TEntries;
+	typedef std::vector<uint64>            TKeys;
+
+	// deltas are sent to the clients in chunks of this size, see CServerContextView::SendSnapshot
+	static const uint32    SEND_CHUNK_SIZE = 768;
+	static const uint32    MAX_DELTA_SIZE = 16 << 20;
+
+	static uint64          MakeKey(SNetObjectID id, NetworkAspectID aspectIdx) { return (uint64(id.id) << 24) | (uint64(id.salt) << 8) | aspectIdx; }
+	static SNetObjectID    GetKeyObjectID(uint64 key)                          { return SNetObjectID(uint16(key >> 24), uint16(key >> 8)); }
+	static NetworkAspectID GetKeyAspect(uint64 key)                            { return NetworkAspectID(key & 0xff); }
+
+	CNetSnapshot(uint32 seq, CTimeValue time);
+
+	uint32                   GetSeq() const         { return m_seq; }
+	CTimeValue               GetTime() const        { return m_time; }
+	const TEntries&          GetEntries() const     { return m_entries; }
+	const TKeys&             GetChangedKeys() const { return m_changedKeys; }
+	size_t                   GetDataSize() const    { return m_data.size(); }
+
+	const SNetSnapshotEntry* Find(uint64 key) const;
+	const uint8*             GetData(const SNetSnapshotEntry& entry) const { return entry.size ? &m_data[entry.offset] : NULL; }
+
+	// entries have to be added in increasing key order
+	void                     AddEntry(uint64 key, uint32 version, uint8 profile, const void* pData, uint32 size);
+
+	// Writes the delta of this snapshot against pBasis, which has to be an older snapshot of the same history, or the full
+	// snapshot without a basis. keys are the entries which changed in between (sorted, see CNetSnapshotHistory),
+	// forcedKeys entries which are sent in full even if they didn't change. Entries of objects not enabled on pView are
+	// left out, unless they were removed.
+	void                     WriteDelta(const CNetSnapshot* pBasis, const TKeys& keys, const TKeys& forcedKeys, const CContextView* pView, std::vector<uint8>& out) const;
+
+	// Rebuilds the snapshot written by WriteDelta from its basis. changedKeys receives the keys of all entries
+	// present in the delta which weren't removed, in increasing order. Returns NULL if the data is corrupt or
+	// pBasis isn't the basis the delta was written against.
+	static _smart_ptr<CNetSnapshot> ReadDelta(const CNetSnapshot* pBasis, const uint8* pData, size_t size, TKeys& changedKeys);
+	// sequence number of the basis a delta was written against, 0 for a full snapshot
+	static bool                     PeekDeltaSeqs(const uint8* pData, size_t size, uint32& seq, uint32& basisSeq);
+
+	void                            GetMemoryStatistics(ICrySizer* pSizer) const;
+
+private:
+	friend class CNetSnapshotHistory;
+
+	uint32             m_seq;
+	CTimeValue         m_time;
+	TEntries           m_entries;
+	std::vector<uint8> m_data;
+	TKeys              m_changedKeys;   // added, changed or removed since the previous snapshot, sorted
+};
+typedef _smart_ptr<CNetSnapshot> CNetSnapshotPtr;
+
+struct SNetSnapshotDelta : public CMultiThreadRefCount
+{
+	uint32              seq;
+	uint32              basisSeq;   // 0 for a full snapshot
+	uint32              maxSize;
+	bool                shared;     // no forced or left out objects
+	std::vector<uint8>  data;
+	CNetSnapshot::TKeys keys;       // changed since the basis, kept for shared deltas only
+};
+typedef _smart_ptr<SNetSnapshotDelta> TNetSnapshotDeltaPtr;
+
+// The recent snapshots of the server, or the recently received ones of a client.
+class CNetSnapshotHistory
+{
+public:
+	enum { HISTORY_SIZE = 32 };
+
+	CNetSnapshotHistory();
+
+	void            Reset();
+
+	// Computes the change list of pSnapshot against the latest snapshot and makes it the latest one.
+	// Snapshots without any change are dropped, the latest snapshot (and sequence number) stays the same.
+	// Returns true if the snapshot was added.
+	bool            Push(const CNetSnapshotPtr& pSnapshot);
+	// Adds a snapshot received from the server, its change list isn't needed.
+	void            Insert(const CNetSnapshotPtr& pSnapshot);
+
+	CNetSnapshotPtr GetLatest() const;
+	CNetSnapshotPtr Get(uint32 seq) const;
+	uint32          GetNextSeq() const { return m_latestSeq + 1; }
+
+	// Returns the delta of the latest snapshot against basisSeq, or the full snapshot if basisSeq is 0 or isn't kept
+	// anymore. Only the change lists of the snapshots after the basis are visited. Entries of the objects in
+	// forcedObjects are always written, entries of objects not enabled on pView never. If the delta is larger than
+	// maxSize (0 for no limit), it's the delta to the newest snapshot which fits, or to the one right after the basis.
+	// Most clients acknowledged one of the last few snapshots, so deltas without forced or left out objects are cached
+	// per basis until the next snapshot and shared by all clients with the same basis.
+	TNetSnapshotDeltaPtr GetDelta(uint32 basisSeq, const std::vector<SNetObjectID>& forcedObjects, const CContextView* pView, uint32 maxSize) const;
+
+	void            GetMemoryStatistics(ICrySizer* pSizer) const;
+
+private:
+	TNetSnapshotDeltaPtr MakeDelta(const CNetSnapshot* pBasis, const CNetSnapshot* pTarget, const std::vector<SNetObjectID>& forcedObjects, const CContextView* pView) const;
+	// Size of the delta from pBasis to seq. pDelta receives the delta if it had to be written, NULL if the size was cached.
+	uint32               GetDeltaSize(const CNetSnapshot* pBasis, uint32 seq, const std::vector<SNetObjectID>& forcedObjects, const CContextView* pView, TNetSnapshotDeltaPtr& pDelta) const;
+	// whether all objects of a shared delta are enabled on pView
+	static bool          IsEnabledOn(const SNetSnapshotDelta& delta, const CNetSnapshot& target, const CContextView* pView);
+
+	CNetSnapshotPtr                           m_snapshots[HISTORY_SIZE];
+	uint32                                    m_latestSeq;
+
+	// sizes of the shared deltas written while looking for the largest delta below maxSize, until the next snapshot
+	struct SDeltaSize
+	{
+		uint32 basisSeq;
+		uint32 seq;
+		uint32 size;
+	};
+
+	mutable std::vector<TNetSnapshotDeltaPtr> m_deltaCache;
+	mutable std::vector<SDeltaSize>           m_deltaSizeCache;
+	mutable CNetSnapshot::TKeys               m_tempKeys;
+	mutable CNetSnapshot::TKeys               m_tempForcedKeys;
+};
+
+// The aspect sync cost of a running server, sampled over a number of frames by net_snapshotBenchmark: the update messages
+// going through the memento histories, and the snapshot capture, deltas and chunks. Only touched under the global lock.
+enum ENetSyncProfileSection
+{
+	eNSPS_UpdateMessage,
+	eNSPS_SnapshotCapture,
+	eNSPS_SnapshotDelta,
+	eNSPS_SnapshotChunk,
+	eNSPS_Num
+};
+
+struct SNetSyncProfile
+{
+	struct SSection
+	{
+		uint32     count;
+		uint64     bytes;
+		CTimeValue time;
+	};
+
+	uint32   framesLeft;   // 0 when not sampling
+	uint32   frames;
+	bool     snapshotMode;
+	SSection sections[eNSPS_Num];
+
+	static SNetSyncProfile& Get();
+	bool                    IsSampling() const { return framesLeft != 0; }
+	void                    Start(uint32 numFrames);
+	// called once per frame by the server context state, logs the results after the last frame
+	void                    EndFrame(bool snapshotReplication);
+};
+
+// adds the time of the scope, and what was written to pSender in it, to a section while sampling
+class CNetSyncProfileSection
+{
+public:
+	CNetSyncProfileSection(ENetSyncProfileSection section, INetSender* pSender = NULL);
+	~CNetSyncProfileSection();
+
+	void AddBytes(uint32 bytes) { m_bytes += bytes; }
+
+private:
+	ENetSyncProfileSection m_section;
+	INetSender*            m_pSender;
+	uint32                 m_startSize;
+	uint32                 m_bytes;
+	CTimeValue             m_start;
+	bool                   m_sampling;
+};
+
+// console command: samples the aspect sync cost of the running server
+void NetSnapshotBenchmark(IConsoleCmdArgs* pArgs);
+// console command: encode/decode cost and bandwidth of the snapshot deltas for a simulated world and clients with loss,
+// checking that every client rebuilds exactly what the server sent
+void NetSnapshotSimulate(IConsoleCmdArgs* pArgs);
+
+#endif
@@ -672,6 +672,12 @@ CServerContextView::CServerContextView(CNetChannel* pChannel, CNetContext* pCont
 		m_breakStreamHandles[i].id = i;
 	}
 
+	m_snapshotSendCount = 0;
+	m_snapshotSentSeq = 0;
+	m_snapshotAckedSeq = 0;
+	m_snapshotAckedSend = 0;
+	m_snapshotResend = false;
+
 #ifdef __WITH_PB__
 	m_clientHasPunkBuster = false;
 #endif
@@ -844,6 +850,14 @@ void CServerContextView::OnObjectEvent(CNetContextState* pState, SNetObjectEvent
 		case eNOE_SyncWithGame_Start:
 			if (m_lockLocalMapLoaded.IsLocking() && ContextState()->IsContextEstablished())
 				m_lockLocalMapLoaded = CChangeStateLock();
+			// resend lost deltas even if nothing changed since
+			if (GetSnapshotAspects() && IsPastOrInState(eCVS_InGame))
+				SendSnapshot();
+			break;
+		case eNOE_ObjectAspectChange:
+			// the context state captured a new snapshot right before
+			if (GetSnapshotAspects() && IsPastOrInState(eCVS_InGame))
+				SendSnapshot();
 			break;
 		}
 	}
@@ -857,6 +871,234 @@ void CServerContextView::ClearAllState()
 	CContextView::ClearAllState();
 	m_pValidatedPredictions->clear();
 	m_pPendingUnbinds->clear();
+	ResetSnapshots();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// snapshot replication
+
+struct CServerContextView::SSnapshotSend : public CMultiThreadRefCount
+{
+	enum EChunkState
+	{
+		eCS_Queued,
+		eCS_Sent,
+		eCS_Acked,
+	};
+
+	bool IsFull() const { return pDelta->basisSeq == 0; }
+
+	TNetSnapshotDeltaPtr         pDelta;
+	uint32                       sendID;
+	uint32                       numChunks;
+	uint32                       numAcked;
+	std::vector<uint8>           chunkStates;
+	std::vector<SSendableHandle> handles;
+};
+
+class CServerContextView::CSnapshotChunkMessage : public INetMessage
+{
+public:
+	CSnapshotChunkMessage(CServerContextView* pView, const TSnapshotSendPtr& pSend, uint32 chunk)
+		: INetMessage(CClientContextView::SnapshotChunk)
+		, m_pView(pView)
+		, m_pSend(pSend)
+		, m_chunk(chunk)
+	{
+	}
+
+	EMessageSendResult WritePayload(TSerialize ser, uint32, uint32)
+	{
+		CNetSyncProfileSection profile(eNSPS_SnapshotChunk);
+		const std::vector<uint8>& data = m_pSend->pDelta->data;
+		uint32 sendID = m_pSend->sendID;
+		uint32 size = uint32(data.size());
+		uint32 chunk = m_chunk;
+		ser.Value("send", sendID, 'ui32');
+		ser.Value("size", size, 'ui32');
+		ser.Value("chunk", chunk, 'ui16');
+		const uint32 begin = m_chunk * CNetSnapshot::SEND_CHUNK_SIZE;
+		const uint32 end = min(size, begin + CNetSnapshot::SEND_CHUNK_SIZE);
+		for (uint32 i = begin; i < end; i++)
+			ser.Value("data", const_cast<uint8&>(data[i]), 'ui8');
+		profile.AddBytes(end - begin);
+		m_pView->OnSnapshotChunkSent(m_pSend, m_chunk);
+		return eMSR_SentOk;
+	}
+
+	void UpdateState(uint32 nFromSeq, ENetSendableStateUpdate update)
+	{
+		m_pView->OnSnapshotChunkState(m_pSend, m_chunk, update);
+	}
+
+	size_t GetSize() { return sizeof(*this); }
+
+private:
+	CServerContextView* m_pView;
+	TSnapshotSendPtr    m_pSend;
+	uint32              m_chunk;
+};
+
+void CServerContextView::OnObjectEnabled(SNetObjectID nID)
+{
+	// the bind carried the state of the object, but the client skipped the object in all snapshots it received before,
+	// so its entries are added to the deltas until the client acknowledges one of them
+	if (GetSnapshotAspects())
+	{
+		m_snapshotForcedObjects.push_back(std::make_pair(nID, 0u));
+		m_snapshotResend = true;
+	}
+}
+
+void CServerContextView::SendSnapshot()
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_NETWORK);
+
+	const CNetSnapshotHistory& history = ContextState()->GetSnapshotHistory();
+	CNetSnapshotPtr pLatest = history.GetLatest();
+	if (!pLatest)
+		return;
+
+	const uint32 latestSeq = pLatest->GetSeq();
+	if (latestSeq == m_snapshotSentSeq && !m_snapshotResend)
+		return;
+	if (latestSeq == m_snapshotAckedSeq && m_snapshotForcedObjects.empty())
+		return;
+
+	// There is no basis for deltas before the client acknowledged a full snapshot, its lost chunks are resent instead.
+	// A delta which isn't sent completely yet is kept until it is: superseding it would queue a larger delta against the
+	// same basis every frame, and a channel short of bandwidth would never get one through.
+	for (TSnapshotSends::const_iterator it = m_snapshotSends.begin(), end = m_snapshotSends.end(); it != end; ++it)
+	{
+		const std::vector<uint8>& chunkStates = (*it)->chunkStates;
+		if ((*it)->IsFull() || std::find(chunkStates.begin(), chunkStates.end(), uint8(SSnapshotSend::eCS_Queued)) != chunkStates.end())
+			return;
+	}
+
+	m_snapshotForcedTemp.resize(0);
+	for (std::vector<std::pair<SNetObjectID, uint32>>::iterator it = m_snapshotForcedObjects.begin(), end = m_snapshotForcedObjects.end(); it != end; ++it)
+	{
+		m_snapshotForcedTemp.push_back(it->first);
+		if (!it->second)
+			it->second = m_snapshotSendCount + 1;
+	}
+
+	CNetSyncProfileSection profile(eNSPS_SnapshotDelta);
+	TNetSnapshotDeltaPtr pDelta = history.GetDelta(m_snapshotAckedSeq, m_snapshotForcedTemp, this, uint32(max(0, CNetCVars::Get().snapshotMaxDeltaSize)));
+	if (!pDelta || pDelta->data.size() > CNetSnapshot::MAX_DELTA_SIZE)
+	{
+		NetWarning("Snapshot %u can't be sent to %s", latestSeq, Parent()->GetName());
+		return;
+	}
+
+	TSnapshotSendPtr pSend = new SSnapshotSend;
+	pSend->pDelta = pDelta;
+	pSend->sendID = ++m_snapshotSendCount;
+	pSend->numChunks = max(1u, uint32((pDelta->data.size() + CNetSnapshot::SEND_CHUNK_SIZE - 1) / CNetSnapshot::SEND_CHUNK_SIZE));
+	pSend->numAcked = 0;
+	pSend->chunkStates.resize(pSend->numChunks, SSnapshotSend::eCS_Queued);
+	pSend->handles.resize(pSend->numChunks);
+	m_snapshotSends.push_back(pSend);
+
+	for (uint32 chunk = 0; chunk < pSend->numChunks; chunk++)
+		SendSnapshotChunk(pSend, chunk);
+
+	// a delta to an older snapshot than the latest one, the rest follows once it's sent
+	m_snapshotSentSeq = pDelta->seq;
+	m_snapshotResend = false;
+}
+
+void CServerContextView::SendSnapshotChunk(const TSnapshotSendPtr& pSend, uint32 chunk)
+{
+	pSend->chunkStates[chunk] = SSnapshotSend::eCS_Queued;
+	Parent()->NetAddSendable(new CSnapshotChunkMessage(this, pSend, chunk), 0, NULL, &pSend->handles[chunk]);
+}
+
+void CServerContextView::OnSnapshotChunkSent(SSnapshotSend* pSend, uint32 chunk)
+{
+	if (pSend->chunkStates[chunk] == SSnapshotSend::eCS_Queued)
+		pSend->chunkStates[chunk] = SSnapshotSend::eCS_Sent;
+}
+
+void CServerContextView::OnSnapshotChunkState(SSnapshotSend* pSend, uint32 chunk, ENetSendableStateUpdate update)
+{
+	TSnapshotSends::iterator it = std::find(m_snapshotSends.begin(), m_snapshotSends.end(), pSend);
+	if (it == m_snapshotSends.end())
+		return; // superseded, or sent in a previous context
+
+	switch (update)
+	{
+	case eNSSU_Ack:
+		if (pSend->chunkStates[chunk] != SSnapshotSend::eCS_Acked)
+		{
+			pSend->chunkStates[chunk] = SSnapshotSend::eCS_Acked;
+			if (++pSend->numAcked == pSend->numChunks)
+			{
+				m_snapshotAckedSeq = max(m_snapshotAckedSeq, pSend->pDelta->seq);
+				m_snapshotAckedSend = max(m_snapshotAckedSend, pSend->sendID);
+
+				for (uint32 i = 0; i < m_snapshotForcedObjects.size(); )
+				{
+					const uint32 firstSend = m_snapshotForcedObjects[i].second;
+					if (firstSend && firstSend <= m_snapshotAckedSend)
+					{
+						m_snapshotForcedObjects[i] = m_snapshotForcedObjects.back();
+						m_snapshotForcedObjects.pop_back();
+					}
+					else
+						++i;
+				}
+
+				// older deltas are of no use anymore
+				for (uint32 i = 0; i < m_snapshotSends.size(); )
+				{
+					if (m_snapshotSends[i]->pDelta->seq <= m_snapshotAckedSeq)
+						RemoveSnapshotSend(m_snapshotSends.begin() + i);
+					else
+						++i;
+				}
+			}
+		}
+		break;
+	case eNSSU_Requeue:
+		pSend->chunkStates[chunk] = SSnapshotSend::eCS_Queued;
+		break;
+	case eNSSU_Nack:
+		if (pSend->IsFull())
+		{
+			SendSnapshotChunk(pSend, chunk);
+			break;
+		}
+	// fall through
+	case eNSSU_Rejected:
+		// the client can't rebuild the snapshot without this chunk
+		if (pSend->pDelta->seq == m_snapshotSentSeq)
+			m_snapshotResend = true;
+		RemoveSnapshotSend(it);
+		break;
+	}
+}
+
+void CServerContextView::RemoveSnapshotSend(TSnapshotSends::iterator it)
+{
+	TSnapshotSendPtr pSend = *it;
+	m_snapshotSends.erase(it);
+	for (uint32 chunk = 0; Parent() && chunk < pSend->numChunks; chunk++)
+	{
+		if (pSend->chunkStates[chunk] == SSnapshotSend::eCS_Queued)
+			Parent()->NetRemoveSendable(pSend->handles[chunk]);
+	}
+}
+
+void CServerContextView::ResetSnapshots()
+{
+	while (!m_snapshotSends.empty())
+		RemoveSnapshotSend(m_snapshotSends.end() - 1);
+	m_snapshotSentSeq = 0;
+	m_snapshotAckedSeq = 0;
+	m_snapshotAckedSend = 0;
+	m_snapshotResend = false;
+	m_snapshotForcedObjects.clear();
 }
 
 void CServerContextView::InitSessionIDs()
@@ -1742,6 +1984,9 @@ void CServerContextView::GetMemoryStatistics(ICrySizer* pSizer)
 		pSizer->AddObject(m_tempPackets[i].second.get(), sizeof(CVoicePacket));
 	pSizer->AddContainer(m_pVoiceListeners);
 #endif
+	pSizer->AddContainer(m_snapshotSends);
+	pSizer->AddContainer(m_snapshotForcedObjects);
+	pSizer->AddContainer(m_snapshotForcedTemp);
 }
 
 void CServerContextView::SendUnbindMessage(SNetObjectID netID, bool bFromBind, CNetObjectBindLock lk)
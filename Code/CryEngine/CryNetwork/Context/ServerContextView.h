@@ -249,6 +249,7 @@ private:
 	class CUnbindObjectMessage;
 	class CBeginBreakStream;
 	class CPerformBreak;
+	class CSnapshotChunkMessage;
 
 	class CCET_SyncFiles;
 
@@ -262,6 +263,19 @@ private:
 
 	virtual void OnWitnessDeclared();
 
+	// snapshot replication, see NetSnapshot.h
+	struct SSnapshotSend;
+	typedef _smart_ptr<SSnapshotSend>   TSnapshotSendPtr;
+	typedef std::vector<TSnapshotSendPtr> TSnapshotSends;
+
+	virtual void OnObjectEnabled(SNetObjectID nID);
+	void         SendSnapshot();
+	void         SendSnapshotChunk(const TSnapshotSendPtr& pSend, uint32 chunk);
+	void         OnSnapshotChunkSent(SSnapshotSend* pSend, uint32 chunk);
+	void         OnSnapshotChunkState(SSnapshotSend* pSend, uint32 chunk, ENetSendableStateUpdate update);
+	void         RemoveSnapshotSend(TSnapshotSends::iterator it);
+	void         ResetSnapshots();
+
 	struct SBreakStreamHandle
 	{
 		SSendableHandle hdl;
@@ -314,6 +328,17 @@ private:
 #endif
 	std::vector<SSendableHandle>                          m_dependencyStaging;
 
+	// deltas in flight, oldest first
+	TSnapshotSends                                        m_snapshotSends;
+	uint32                                                m_snapshotSendCount;
+	uint32                                                m_snapshotSentSeq;
+	uint32                                                m_snapshotAckedSeq;
+	uint32                                                m_snapshotAckedSend;
+	bool                                                  m_snapshotResend;
+	// objects enabled since the last acknowledged snapshot, and the first send including them (0 if not sent yet)
+	std::vector<std::pair<SNetObjectID, uint32>>          m_snapshotForcedObjects;
+	std::vector<SNetObjectID>                             m_snapshotForcedTemp;
+
 #ifdef __WITH_PB__
 	bool m_clientHasPunkBuster;
 #endif
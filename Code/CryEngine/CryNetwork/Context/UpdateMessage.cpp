@@ -81,6 +81,8 @@ NetworkAspectType CUpdateMessage::ComputeSendAspectMask(INetSender* pSender, SHi
 		partialUpdateForces |= BitIf(aspectIdx, (g_time - pViewObjEx->partialUpdateReceived[aspectIdx]) < oneSecond || pViewObjEx->partialUpdatesRemaining[aspectIdx] > 0);
 	}
 	maySend &= pViewObjEx->dirtyAspects;
+	if (!(m_syncFlags & eSCF_AssumeEnabled))
+		maySend &= ~m_pView->GetSnapshotAspects();
 
 	maySend |= partialUpdateForces;
 
@@ -186,6 +188,7 @@ SMessageTag CUpdateMessage::GetMessageTag(INetSender* pSender, IMessageMapper* m
 EMessageSendResult CUpdateMessage::Send(INetSender* pSender)
 {
 	NET_ASSERT(!(!m_handle));
+	CNetSyncProfileSection profile(eNSPS_UpdateMessage, pSender);
 
 	m_anythingSent = false;
 	m_immediateResendAspects = 0;
@@ -328,6 +331,9 @@ EMessageSendResult CUpdateMessage::InitialChecks(SHistorySyncContext& hsc, INetS
 			partialUpdateForces |= BitIf(aspectIdx, (g_time - pViewObjEx->partialUpdateReceived[aspectIdx]) < oneSecond || pViewObjEx->partialUpdatesRemaining[aspectIdx] > 0);
 		}
 		m_maybeSendHistories[eH_AspectData] &= pViewObjEx->dirtyAspects;
+		// binds carry the full state, afterwards the snapshots keep these aspects up to date
+		if (!(m_syncFlags & eSCF_AssumeEnabled))
+			m_maybeSendHistories[eH_AspectData] &= ~m_pView->GetSnapshotAspects();
 	}
 	m_maybeSendHistories[eH_AspectData] |= partialUpdateForces;
 	m_immediateResendAspects = partialUpdateForces;
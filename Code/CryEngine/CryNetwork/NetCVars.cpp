@@ -3,6 +3,9 @@
 #include "StdAfx.h"
 #include "NetCVars.h"
 #include "NetDebugInfo.h"
+#include "Socket/ISocketIOManager.h"
+#include "Context/NetSnapshot.h"
+#include "Streams/StreamCoderBenchmark.h"
 #if NEW_BANDWIDTH_MANAGEMENT
 	#include <CryGame/IGame.h>
 	#include <CryGame/IGameFramework.h>
@@ -124,6 +127,32 @@ CNetCVars::CNetCVars()
 	REGISTER_CVAR2_DEDI_ONLY("net_socketMaxTimeout", &socketMaxTimeout, 33, VF_DUMPTODISK, "Maximum timeout (milliseconds) that a socket should wait for received data");
 	REGISTER_CVAR2_DEDI_ONLY("net_socketBoostTimeout", &socketBoostTimeout, 1, VF_DUMPTODISK, "Single Player Only, acts as throttle during context establishment, the higher the value the longer it takes to load");
 	REGISTER_CVAR2_DEDI_ONLY("net_socketMaxTimeoutMultiplayer", &socketMaxTimeoutMultiplayer, 4, VF_DUMPTODISK, "Maximum timeout (milliseconds) that a socket should wait for received data in multiplayer");
+	REGISTER_CVAR2_DEDI_ONLY("net_socketIOManagerEpoll", &socketIOManagerEpoll, 0, VF_REQUIRE_APP_RESTART,
+	                         "Linux only: use the epoll socket IO manager with batched recvmmsg/sendmmsg instead of select (set on the command line or in the config)");
+	REGISTER_COMMAND_DEDI_ONLY("net_socketIOBenchmark", SocketIOManagerBenchmark, VF_NULL,
+	                           "Sends datagrams over loopback through each available socket IO manager and logs packets/sec and CPU time per packet\n"
+	                           "Usage: net_socketIOBenchmark [numPackets] [packetSize]");
+	REGISTER_CVAR2_DEDI_ONLY("net_snapshotReplication", &snapshotReplication, 0, VF_NULL,
+	                         "Server sends the aspect data as deltas of one world snapshot per frame shared by all channels, instead of per object updates (takes effect on the next context change)");
+	REGISTER_CVAR2_DEDI_ONLY("net_snapshotMaxDeltaSize", &snapshotMaxDeltaSize, 8192, VF_NULL,
+	                         "Largest snapshot delta in bytes sent to a client, a client which fell further behind catches up over several deltas (0 for no limit)");
+	REGISTER_COMMAND_DEDI_ONLY("net_snapshotBenchmark", NetSnapshotBenchmark, VF_NULL,
+	                           "Samples the time and bytes per frame the server spends on the aspect sync in the current mode: the update messages through the memento histories, "
+	                           "and the snapshot capture, deltas and chunks. Run it once per net_snapshotReplication mode to compare them\n"
+	                           "Usage: net_snapshotBenchmark [numFrames]");
+	REGISTER_COMMAND_DEDI_ONLY("net_snapshotSimulate", NetSnapshotSimulate, VF_NULL,
+	                           "Simulates a world and clients in process and logs the encode/decode time and bandwidth of the snapshot deltas, and checks the snapshots the clients rebuild\n"
+	                           "Usage: net_snapshotSimulate [numObjects=2000] [numClients=32] [numTicks=300] [changeRatio=0.05] [lossPercent=5]");
+#if USE_ARITHSTREAM
+	#if ENABLE_STREAM_CODER_CAPTURE
+	REGISTER_CVAR2("net_streamCoderCapture", &streamCoderCapture, 0, VF_NULL,
+	               "Keeps the symbols of the last sent packets for net_streamCoderBenchmark");
+	#endif
+	REGISTER_COMMAND("net_streamCoderBenchmark", StreamCoderBenchmark, VF_NULL,
+	                 "Encodes and decodes the packets captured with net_streamCoderCapture (or synthetic ones) with the range coder and with rANS, "
+	                 "and logs time and size\n"
+	                 "Usage: net_streamCoderBenchmark [repeats]");
+#endif
 
 #if NET_ASSERT_LOGGING
 	REGISTER_CVAR2_DEV_ONLY("net_assertlogging", &AssertLogging, 0, VF_DUMPTODISK, "Log network assertations");
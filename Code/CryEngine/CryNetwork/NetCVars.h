@@ -38,6 +38,10 @@ public:
 	int   socketMaxTimeout;
 	int   socketBoostTimeout;
 	int   socketMaxTimeoutMultiplayer;
+	int   socketIOManagerEpoll;
+	int   snapshotReplication;
+	int   snapshotMaxDeltaSize;
+	int   streamCoderCapture;
 
 #if NEW_BANDWIDTH_MANAGEMENT
 	float net_availableBandwidthServer;
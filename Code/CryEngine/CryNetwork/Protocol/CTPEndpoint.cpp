@@ -18,6 +18,7 @@
 #include "Network.h"
 #include <CrySystem/ITimer.h>
 #include "DebugKit/DebugKit.h"
+#include "Streams/StreamCoderBenchmark.h"
 #if USE_HIGH_PRIORITY_ASPECT_HACK
 	#include <CrySystem/ISystem.h>
 	#include <CryEntitySystem/IEntitySystem.h>
@@ -2442,6 +2443,10 @@ uint32 CCTPEndpoint::SendPacket(CTimeValue nTime, const SSendPacketParams& param
 
 	debugPacketDataSizeStartData(eDPDST_Padding, m_outputStreamImpl.GetBitSize());
 	nSent = uint32(m_outputStreamImpl.GetOutput().Flush());
+#if USE_ARITHSTREAM && ENABLE_STREAM_CODER_CAPTURE
+	if (CVARS.streamCoderCapture)
+		CaptureStreamCoderPacket(m_outputStreamImpl.GetOutput().GetSymbols());
+#endif
 
 	if (m_bWritingPacketNeedsInSyncProcessing)
 	{
@@ -5,6 +5,7 @@
 #include "SocketIOManagerIOCP.h"
 #include "SocketIOManagerNull.h"
 #include "SocketIOManagerSelect.h"
+#include "SocketIOManagerEpoll.h"
 #include "SocketIOManagerLobbyIDAddr.h"
 #if CRY_PLATFORM_DURANGO
 	#include "SocketIOManagerDurango.h"
@@ -153,6 +154,23 @@ bool CreateSocketIOManager(int ncpus, ISocketIOManager** ppExternal, ISocketIOMa
 		}
 	}
 #endif // defined(HAS_SOCKETIOMANAGER_DURANGO)
+#if defined(HAS_SOCKETIOMANAGER_EPOLL)
+	if (!created && CNetCVars::Get().socketIOManagerEpoll)
+	{
+		CSocketIOManagerEpoll* pMgrEpoll = new CSocketIOManagerEpoll();
+		if ((pMgrEpoll != NULL) && (pMgrEpoll->Init() == true))
+		{
+			*ppInternal = pMgrEpoll;
+			created = true;
+		}
+		else
+		{
+			// fall back to select
+			delete pMgrEpoll;
+			created = false;
+		}
+	}
+#endif // defined(HAS_SOCKETIOMANAGER_EPOLL)
 #if defined(HAS_SOCKETIOMANAGER_SELECT)
 	if (!created)
 	{
@@ -214,3 +232,187 @@ bool CreateSocketIOManager(int ncpus, ISocketIOManager** ppExternal, ISocketIOMa
 
 	return created;
 }
+
+namespace
+{
+class CSocketIOBenchmarkTarget : public IRecvFromTarget, public ISendToTarget
+{
+public:
+	CSocketIOBenchmarkTarget(ISocketIOManager* pMgr, uint32 packetSize)
+		: m_pMgr(pMgr)
+		, m_packetSize(packetSize)
+		, m_numReceived(0)
+		, m_numErrors(0)
+	{
+	}
+
+	virtual void OnRecvFromComplete(const TNetAddress& from, const uint8* pData, uint32 len)
+	{
+		m_numReceived++;
+		if (len != m_packetSize)
+			m_numErrors++;
+		m_pMgr->RequestRecvFrom(m_recvSockId);
+	}
+
+	virtual void OnRecvFromException(const TNetAddress& from, ESocketError err)
+	{
+		m_numErrors++;
+		m_pMgr->RequestRecvFrom(m_recvSockId);
+	}
+
+	virtual void OnSendToException(const TNetAddress& to, ESocketError err)
+	{
+		m_numErrors++;
+	}
+
+	ISocketIOManager* m_pMgr;
+	SSocketID         m_recvSockId;
+	uint32            m_packetSize;
+	uint32            m_numReceived;
+	uint32            m_numErrors;
+};
+
+int64 GetThreadCPUTimeMicroseconds()
+{
+#if CRY_PLATFORM_LINUX || CRY_PLATFORM_ANDROID
+	timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (int64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#elif CRY_PLATFORM_WINDOWS
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+		return -1;
+	const uint64 kernel = ((uint64)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+	const uint64 user = ((uint64)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+	return (int64)((kernel + user) / 10);
+#else
+	return -1;
+#endif
+}
+
+CRYSOCKET OpenBenchmarkSocket(uint16& port)
+{
+	CRYSOCKET sock = CrySock::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock == CRY_INVALID_SOCKET)
+		return CRY_INVALID_SOCKET;
+
+	CRYSOCKADDR_IN saddr;
+	memset(&saddr, 0, sizeof(saddr));
+	saddr.sin_family = AF_INET;
+	saddr.sin_port = 0;
+	saddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	CRYSOCKLEN_T addrlen = sizeof(saddr);
+	const int bufferSize = 4 * 1024 * 1024;
+	if (CrySock::bind(sock, (const CRYSOCKADDR*)&saddr, sizeof(saddr)) == CRY_SOCKET_ERROR ||
+	    CrySock::getsockname(sock, (CRYSOCKADDR*)&saddr, &addrlen) == CRY_SOCKET_ERROR ||
+	    !CrySock::MakeSocketNonBlocking(sock))
+	{
+		CrySock::closesocket(sock);
+		return CRY_INVALID_SOCKET;
+	}
+	CrySock::setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char*)&bufferSize, sizeof(bufferSize));
+	CrySock::setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char*)&bufferSize, sizeof(bufferSize));
+
+	port = ntohs(saddr.sin_port);
+	return sock;
+}
+
+void RunSocketIOManagerBenchmark(ISocketIOManager* pMgr, uint32 numPackets, uint32 packetSize)
+{
+	// sent in bursts, so the receive buffer of the loopback socket doesn't overflow and each burst can be batched
+	const uint32 burstSize = 64;
+
+	uint16 recvPort = 0, sendPort = 0;
+	CRYSOCKET recvSock = OpenBenchmarkSocket(recvPort);
+	CRYSOCKET sendSock = OpenBenchmarkSocket(sendPort);
+	if (recvSock == CRY_INVALID_SOCKET || sendSock == CRY_INVALID_SOCKET)
+	{
+		NetWarning("[net] socket IO benchmark: can't open loopback sockets");
+		if (recvSock != CRY_INVALID_SOCKET)
+			CrySock::closesocket(recvSock);
+		if (sendSock != CRY_INVALID_SOCKET)
+			CrySock::closesocket(sendSock);
+		return;
+	}
+
+	CSocketIOBenchmarkTarget target(pMgr, packetSize);
+	target.m_recvSockId = pMgr->RegisterSocket(recvSock, IPPROTO_UDP);
+	const SSocketID sendSockId = pMgr->RegisterSocket(sendSock, IPPROTO_UDP);
+	pMgr->SetRecvFromTarget(target.m_recvSockId, &target);
+	pMgr->SetSendToTarget(sendSockId, &target);
+	for (uint32 i = 0; i < 2 * burstSize; i++)
+		pMgr->RequestRecvFrom(target.m_recvSockId);
+
+	std::vector<uint8> packet(packetSize);
+	for (uint32 i = 0; i < packetSize; i++)
+		packet[i] = (uint8)(i * 7);
+	const TNetAddress to = TNetAddress(SIPv4Addr(INADDR_LOOPBACK, recvPort));
+
+	const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+	const int64 startCPUTime = GetThreadCPUTimeMicroseconds();
+
+	uint32 numSent = 0;
+	while (numSent < numPackets)
+	{
+		const uint32 numBurst = std::min(burstSize, numPackets - numSent);
+		for (uint32 i = 0; i < numBurst; i++)
+			pMgr->RequestSendTo(sendSockId, to, &packet[0], packetSize);
+		numSent += numBurst;
+
+		// wait until the burst arrived, if nothing comes in for a while the rest was dropped
+		while (target.m_numReceived + target.m_numErrors < numSent)
+		{
+			if (!pMgr->PollWait(100))
+				break;
+			bool performedWork = false;
+			pMgr->PollWork(performedWork);
+		}
+	}
+
+	const float seconds = max((gEnv->pTimer->GetAsyncTime() - startTime).GetSeconds(), FLT_EPSILON);
+	const int64 cpuTime = GetThreadCPUTimeMicroseconds() - startCPUTime;
+
+	pMgr->UnregisterSocket(sendSockId);
+	pMgr->UnregisterSocket(target.m_recvSockId);
+	CrySock::closesocket(sendSock);
+	CrySock::closesocket(recvSock);
+
+	const uint32 numReceived = max(target.m_numReceived, 1u);
+	if (startCPUTime >= 0)
+	{
+		CryLogAlways("  %-8s %10.0f packets/s, %7.3f us CPU/packet, %u lost, %u errors", pMgr->GetName(), target.m_numReceived / seconds,
+		             (float)cpuTime / numReceived, numPackets - std::min(target.m_numReceived, numPackets), target.m_numErrors);
+	}
+	else
+	{
+		CryLogAlways("  %-8s %10.0f packets/s, %u lost, %u errors", pMgr->GetName(), target.m_numReceived / seconds,
+		             numPackets - std::min(target.m_numReceived, numPackets), target.m_numErrors);
+	}
+}
+}
+
+void SocketIOManagerBenchmark(IConsoleCmdArgs* pArgs)
+{
+	const uint32 numPackets = pArgs->GetArgCount() > 1 ? (uint32)max(atoi(pArgs->GetArg(1)), 1) : 200000;
+	const uint32 packetSize = pArgs->GetArgCount() > 2 ? (uint32)clamp_tpl(atoi(pArgs->GetArg(2)), 1, MAX_UDP_PACKET_SIZE) : 200;
+
+	// standalone managers, so the sockets of the running game aren't disturbed
+	CryLogAlways("[net] socket IO benchmark: %u packets of %u bytes over loopback, sender and receiver polled on this thread", numPackets, packetSize);
+#if defined(HAS_SOCKETIOMANAGER_SELECT)
+	{
+		CSocketIOManagerSelect* pMgrSelect = new CSocketIOManagerSelect();
+		if (pMgrSelect->Init())
+			RunSocketIOManagerBenchmark(pMgrSelect, numPackets, packetSize);
+		delete pMgrSelect;
+	}
+#endif // defined(HAS_SOCKETIOMANAGER_SELECT)
+#if defined(HAS_SOCKETIOMANAGER_EPOLL)
+	{
+		CSocketIOManagerEpoll* pMgrEpoll = new CSocketIOManagerEpoll();
+		if (pMgrEpoll->Init())
+			RunSocketIOManagerBenchmark(pMgrEpoll, numPackets, packetSize);
+		delete pMgrEpoll;
+	}
+#endif // defined(HAS_SOCKETIOMANAGER_EPOLL)
+}
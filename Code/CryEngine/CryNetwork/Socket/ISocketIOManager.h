@@ -241,4 +241,7 @@ private:
 
 bool CreateSocketIOManager(int ncpus, ISocketIOManager** ppExternal, ISocketIOManager** ppInternal);
 
+// console command: loopback throughput of the select and epoll socket IO managers
+void SocketIOManagerBenchmark(IConsoleCmdArgs* pArgs);
+
 #endif
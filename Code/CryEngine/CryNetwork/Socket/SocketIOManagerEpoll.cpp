@@ -0,0 +1,852 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "SocketIOManagerEpoll.h"
+#include "Network.h"
+#include "UDPDatagramSocket.h"
+
+#if defined(HAS_SOCKETIOMANAGER_EPOLL)
+
+CSocketIOManagerEpoll::CSocketIOManagerEpoll() : CSocketIOManager(eSIOMC_SupportsBackoff)
+	#if LOCK_NETWORK_FREQUENCY
+	, m_userMessageFrameID(0)
+	#endif // LOCK_NETWORK_FREQUENCY
+	, m_epollFd(-1)
+	, m_numEvents(0)
+	, m_bWaiting(false)
+	, m_numPendingSends(0)
+{
+	if (CNetCVars::Get().enableWatchdogTimer)
+	{
+		m_pWatchdog = new CWatchdogTimer;
+	}
+	else
+	{
+		m_pWatchdog = NULL;
+	}
+
+	m_wakeupSocket = CRY_INVALID_SOCKET;
+	m_wakeupSender = CRY_INVALID_SOCKET;
+
+	// the receive buffers never move, so the message headers only have to be set up once
+	memset(m_recvMessages, 0, sizeof(m_recvMessages));
+	for (uint32 i = 0; i < RECV_BATCH_SIZE; i++)
+	{
+		m_recvIOVecs[i].iov_base = m_recvBuffers[i];
+		m_recvIOVecs[i].iov_len = MAX_UDP_PACKET_SIZE;
+		m_recvMessages[i].msg_hdr.msg_iov = &m_recvIOVecs[i];
+		m_recvMessages[i].msg_hdr.msg_iovlen = 1;
+		m_recvMessages[i].msg_hdr.msg_name = &m_recvAddresses[i];
+	}
+
+	memset(m_sendMessages, 0, sizeof(m_sendMessages));
+	for (uint32 i = 0; i < SEND_BATCH_SIZE; i++)
+	{
+		m_sendIOVecs[i].iov_base = m_pendingSends[i].data;
+		m_sendMessages[i].msg_hdr.msg_iov = &m_sendIOVecs[i];
+		m_sendMessages[i].msg_hdr.msg_iovlen = 1;
+		m_sendMessages[i].msg_hdr.msg_name = &m_pendingSends[i].address;
+	}
+}
+
+CSocketIOManagerEpoll::~CSocketIOManagerEpoll()
+{
+	if (m_epollFd >= 0)
+	{
+		close(m_epollFd);
+	}
+	if (m_wakeupSocket != CRY_INVALID_SOCKET)
+	{
+		CrySock::closesocket(m_wakeupSocket);
+	}
+	if (m_wakeupSender != CRY_INVALID_SOCKET)
+	{
+		CrySock::closesocket(m_wakeupSender);
+	}
+
+	for (size_t i = 0; i < m_socketInfo.size(); i++)
+		delete m_socketInfo[i];
+
+	if (m_pWatchdog)
+	{
+		delete m_pWatchdog;
+	}
+}
+
+bool CSocketIOManagerEpoll::Init()
+{
+	m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (m_epollFd < 0)
+	{
+		NetWarning("[net] epoll_create1 failed: %s", strerror(errno));
+		return false;
+	}
+
+	class CAutoCloseSocket
+	{
+	public:
+		CAutoCloseSocket(CRYSOCKET sock) : m_sock(sock) {}
+
+		~CAutoCloseSocket()
+		{
+			if (m_sock != CRY_INVALID_SOCKET)
+				CrySock::closesocket(m_sock);
+		}
+
+		void Release()
+		{
+			m_sock = CRY_INVALID_SOCKET;
+		}
+
+	private:
+		CRYSOCKET m_sock;
+	};
+
+	int i;
+	for (i = 1025; i < 65536; i++)
+	{
+		if (i == 0xed17 || i == 0xfa57)
+			continue;
+		m_wakeupSocket = CrySock::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (m_wakeupSocket == CRY_INVALID_SOCKET)
+			return false;
+
+		CAutoCloseSocket closer(m_wakeupSocket);
+		memset(&m_wakeupAddr, 0, sizeof(m_wakeupAddr));
+
+		m_wakeupAddr.sin_family = AF_INET;
+		m_wakeupAddr.sin_port = htons(i);
+		m_wakeupAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (CrySock::bind(m_wakeupSocket, (const CRYSOCKADDR*)&m_wakeupAddr, sizeof(CRYSOCKADDR_IN)) != CRY_SOCKET_ERROR)
+		{
+			closer.Release();
+			break;
+		}
+		else
+		{
+			const char* msg = CNetwork::Get()->EnumerateError(MAKE_NRESULT(NET_FAIL, NET_FACILITY_SOCKET, GetLastError()));
+			NetWarning("[net] socket error: %s", msg);
+		}
+	}
+
+	if (i == 65536)
+	{
+		m_wakeupSocket = CRY_INVALID_SOCKET;
+		return false;
+	}
+
+	m_wakeupSender = CrySock::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (m_wakeupSender == CRY_INVALID_SOCKET)
+		return false;
+
+	CRYSOCKADDR_IN saddr;
+	saddr.sin_family = AF_INET;
+	saddr.sin_port = 0;
+	saddr.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (CrySock::bind(m_wakeupSender, (const CRYSOCKADDR*)&saddr, sizeof(CRYSOCKADDR_IN)) == CRY_SOCKET_ERROR)
+	{
+		const char* msg = CNetwork::Get()->EnumerateError(MAKE_NRESULT(NET_FAIL, NET_FACILITY_SOCKET, GetLastError()));
+		NetWarning("[net] socket error: %s", msg);
+
+		return false;
+	}
+
+	if (!MakeSocketNonBlocking(m_wakeupSender))
+		return false;
+	if (!MakeSocketNonBlocking(m_wakeupSocket))
+		return false;
+
+	epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.u64 = WAKEUP_EVENT_DATA;
+	if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeupSocket, &ev) != 0)
+	{
+		NetWarning("[net] epoll_ctl failed for wakeup socket: %s", strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+void CSocketIOManagerEpoll::UpdateEpollEvents(SSocketID sockid, SSocketInfo& si)
+{
+	// level triggered, so a socket may only be in the set for reading while somebody waits for the data,
+	// otherwise epoll_wait would return immediately until it was read
+	const uint32 events = (si.NeedRead() ? EPOLLIN : 0) | (si.NeedWrite() ? EPOLLOUT : 0);
+	if (events == si.epollEvents)
+		return;
+
+	epoll_event ev;
+	ev.events = events;
+	ev.data.u64 = sockid.AsInt();
+	const int op = !events ? EPOLL_CTL_DEL : (si.epollEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD);
+	if (epoll_ctl(m_epollFd, op, si.sock, &ev) == 0 || op == EPOLL_CTL_DEL)
+	{
+		si.epollEvents = events;
+	}
+	else if (errno == ENOENT || errno == EEXIST)
+	{
+		// out of sync with the kernel, e.g. the socket was closed and its descriptor reused before it was unregistered
+		if (epoll_ctl(m_epollFd, errno == ENOENT ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, si.sock, &ev) == 0)
+			si.epollEvents = events;
+	}
+	else
+	{
+		NetWarning("[net] epoll_ctl failed for socket %d: %s", si.sock, strerror(errno));
+	}
+}
+
+bool CSocketIOManagerEpoll::PollWait(uint32 waitTime)
+{
+	if (m_pWatchdog)
+	{
+		m_pWatchdog->ClearStalls();
+	}
+
+	// everything queued during the tick goes out before we go to sleep
+	FlushPendingSends();
+
+	for (size_t i = 0; i < m_socketInfo.size(); i++)
+	{
+		SSocketInfo& si = *m_socketInfo[i];
+		if (!si.isActive)
+			continue;
+		UpdateEpollEvents(SSocketID((uint16)i, si.salt), si);
+	}
+
+	m_bWaiting = true;
+	MemoryBarrier();
+	if (m_numPendingSends)
+	{
+		// something was queued from another thread after the flush above
+		waitTime = 0;
+	}
+	m_numEvents = epoll_wait(m_epollFd, m_events, MAX_EPOLL_EVENTS, (int)waitTime);
+	m_bWaiting = false;
+
+	if (m_numEvents < 0)
+	{
+		if (errno != EINTR)
+		{
+			NetWarning("[net] epoll_wait failed: %s", strerror(errno));
+		}
+		m_numEvents = 0;
+	}
+
+	return m_numEvents > 0 || m_numPendingSends != 0;
+}
+
+int CSocketIOManagerEpoll::PollWork(bool& performedWork)
+{
+	int r = 0;
+	int ret = eSM_COMPLETEDIO;
+	performedWork = false;
+	char buffer[MAX_UDP_PACKET_SIZE];
+	char address[_SS_MAXSIZE];
+	CRYSOCKLEN_T addrlen = _SS_MAXSIZE;
+
+	for (int e = 0; e < m_numEvents; e++)
+	{
+		const epoll_event& ev = m_events[e];
+		if (ev.data.u64 == WAKEUP_EVENT_DATA)
+		{
+			addrlen = _SS_MAXSIZE;
+			if (CrySock::recvfrom(m_wakeupSocket, buffer, MAX_UDP_PACKET_SIZE, 0, (CRYSOCKADDR*)address, &addrlen) > 0)
+			{
+				SUserMessage* pMessage = reinterpret_cast<SUserMessage*>(&buffer);
+	#if LOCK_NETWORK_FREQUENCY
+				if (pMessage->m_frameID == m_userMessageFrameID)
+	#endif // LOCK_NETWORK_FREQUENCY
+				{
+					ret = pMessage->m_message;
+				}
+			}
+			continue;
+		}
+
+		// targets may unregister sockets from within their callbacks, so the socket is looked up again after each of them
+		const SSocketID sockid = SSocketID::FromInt((uint32)ev.data.u64);
+		SSocketInfo* pSI = GetSocketInfo(sockid);
+		if (!pSI)
+			continue;
+
+		if (ev.events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+		{
+			if (pSI->NeedRead())
+			{
+				if (pSI->nRecvFrom)
+				{
+					RecvFromBatch(sockid);
+				}
+				pSI = GetSocketInfo(sockid);
+				if (pSI && pSI->nRecv)
+				{
+					r = recv(pSI->sock, buffer, MAX_UDP_PACKET_SIZE, 0);
+					switch (r)
+					{
+					case 0:
+						pSI->pRecvTarget->OnRecvException(eSE_ZeroLengthPacket);
+						pSI->nRecv--;
+						break;
+					case CRY_SOCKET_ERROR:
+						{
+							CrySock::eCrySockError sockErr = CrySock::TranslateLastSocketError();
+							if (sockErr != CrySock::eCSE_EWOULDBLOCK)
+							{
+								pSI->pRecvTarget->OnRecvException(OSErrorToSocketError(CrySock::TranslateToSocketError(sockErr)));
+								pSI->nRecv--;
+							}
+						}
+						break;
+					default:
+						CNetwork::Get()->ReportGotPacket();
+						pSI->pRecvTarget->OnRecvComplete((uint8*)buffer, r);
+						pSI->nRecv--;
+						break;
+					}
+				}
+				pSI = GetSocketInfo(sockid);
+				if (pSI && pSI->nListen)
+				{
+					addrlen = _SS_MAXSIZE;
+					CRYSOCKET sock = CrySock::accept(pSI->sock, (CRYSOCKADDR*)address, &addrlen);
+					if (sock != CRY_INVALID_SOCKET)
+					{
+						pSI->pAcceptTarget->OnAccept(ConvertAddr((CRYSOCKADDR*)address, addrlen), sock);
+						pSI->nListen--;
+					}
+					else
+					{
+						CrySock::eCrySockError sockErr = CrySock::TranslateLastSocketError();
+						if (sockErr != CrySock::eCSE_EWOULDBLOCK)
+						{
+							pSI->pAcceptTarget->OnAcceptException(OSErrorToSocketError(CrySock::TranslateToSocketError(sockErr)));
+							pSI->nListen--;
+						}
+					}
+				}
+			}
+			else if (ev.events & EPOLLERR)
+			{
+				// nobody reads from the socket, but a pending error (e.g. ICMP port unreachable) would wake us up over and over
+				int err = 0;
+				CRYSOCKLEN_T errlen = sizeof(err);
+				getsockopt(pSI->sock, SOL_SOCKET, SO_ERROR, &err, &errlen);
+			}
+			pSI = GetSocketInfo(sockid);
+			if (!pSI)
+				continue;
+		}
+
+		if ((ev.events & EPOLLOUT) && pSI->NeedWrite())
+		{
+			bool done = false;
+			while (!done && !pSI->outgoing.empty())
+			{
+				r = CrySock::send(pSI->sock, (char*)pSI->outgoing.front().data, pSI->outgoing.front().nLength, 0);
+				switch (r)
+				{
+				case 0:
+					pSI->pSendTarget->OnSendException(eSE_ZeroLengthPacket);
+					break;
+				case CRY_SOCKET_ERROR:
+					{
+						CrySock::eCrySockError sockErr = CrySock::TranslateLastSocketError();
+						if (sockErr != CrySock::eCSE_EWOULDBLOCK)
+						{
+							pSI->pSendTarget->OnSendException(OSErrorToSocketError(CrySock::TranslateToSocketError(sockErr)));
+						}
+						else
+						{
+							done = true;
+						}
+						break;
+					}
+				}
+				if (!done)
+					pSI->outgoing.pop_front();
+			}
+			done = false;
+			while (!done && !pSI->outgoingAddressed.empty())
+			{
+				int _addrlen = _SS_MAXSIZE;
+				if (ConvertAddr(pSI->outgoingAddressed.front().addr, (CRYSOCKADDR*)address, &_addrlen))
+				{
+					r = CrySock::sendto(pSI->sock, (char*)pSI->outgoingAddressed.front().data, pSI->outgoingAddressed.front().nLength, 0, (CRYSOCKADDR*)address, _addrlen);
+					switch (r)
+					{
+					case 0:
+						pSI->pSendToTarget->OnSendToException(pSI->outgoingAddressed.front().addr, eSE_ZeroLengthPacket);
+						break;
+					case CRY_SOCKET_ERROR:
+						{
+							CrySock::eCrySockError sockErr = CrySock::TranslateLastSocketError();
+							if (sockErr != CrySock::eCSE_EWOULDBLOCK)
+							{
+								pSI->pSendToTarget->OnSendToException(pSI->outgoingAddressed.front().addr, OSErrorToSocketError(CrySock::TranslateToSocketError(sockErr)));
+							}
+							else
+							{
+								done = true;
+							}
+							break;
+						}
+					}
+				}
+				if (!done)
+					pSI->outgoingAddressed.pop_front();
+			}
+		}
+	}
+	m_numEvents = 0;
+
+	// replies the targets queued while handling the received data
+	FlushPendingSends();
+
+	return ret;
+}
+
+void CSocketIOManagerEpoll::RecvFromBatch(SSocketID sockid)
+{
+	for (uint32 batch = 0; batch < MAX_RECV_BATCHES_PER_POLL; batch++)
+	{
+		SSocketInfo* pSI = GetSocketInfo(sockid);
+		if (!pSI || !pSI->nRecvFrom)
+			return;
+
+		const uint32 numWanted = std::min<uint32>(pSI->nRecvFrom, RECV_BATCH_SIZE);
+		for (uint32 i = 0; i < numWanted; i++)
+		{
+			m_recvMessages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+		}
+
+		int r = recvmmsg(pSI->sock, m_recvMessages, numWanted, MSG_DONTWAIT, NULL);
+		if (r < 0)
+		{
+			CrySock::eCrySockError sockErr = CrySock::TranslateLastSocketError();
+			if (sockErr != CrySock::eCSE_EWOULDBLOCK)
+			{
+				// recvmmsg doesn't fill in any address when it fails, the sender of the error is unknown
+				pSI->pRecvFromTarget->OnRecvFromException(TNetAddress(SNullAddr()), OSErrorToSocketError(CrySock::TranslateToSocketError(sockErr)));
+				pSI->nRecvFrom--;
+			}
+			return;
+		}
+
+		for (int i = 0; i < r; i++)
+		{
+			pSI = GetSocketInfo(sockid);
+			if (!pSI || !pSI->pRecvFromTarget)
+				return;
+
+			const TNetAddress from = ConvertAddr((CRYSOCKADDR*)&m_recvAddresses[i], m_recvMessages[i].msg_hdr.msg_namelen);
+			if (m_recvMessages[i].msg_len == 0)
+			{
+				pSI->pRecvFromTarget->OnRecvFromException(from, eSE_ZeroLengthPacket);
+			}
+			else
+			{
+				CNetwork::Get()->ReportGotPacket();
+				pSI->pRecvFromTarget->OnRecvFromComplete(from, m_recvBuffers[i], m_recvMessages[i].msg_len);
+			}
+			pSI->nRecvFrom--;
+		}
+
+		if ((uint32)r < numWanted)
+			return; // drained
+	}
+}
+
+void CSocketIOManagerEpoll::FlushPendingSends()
+{
+	TSendErrors errors;
+	{
+		AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_pendingSendsLock);
+		FlushPendingSendsLocked(errors);
+	}
+	ReportSendErrors(errors);
+}
+
+void CSocketIOManagerEpoll::FlushPendingSendsLocked(TSendErrors& errors)
+{
+	uint32 first = 0;
+	while (first < m_numPendingSends)
+	{
+		// a server normally sends everything through one socket, so this is a single batch
+		uint32 last = first + 1;
+		while (last < m_numPendingSends && m_pendingSends[last].sockid == m_pendingSends[first].sockid)
+			last++;
+
+		if (SSocketInfo* pSI = GetSocketInfo(m_pendingSends[first].sockid))
+		{
+			if (pSI->pSendToTarget)
+			{
+				SendBatch(*pSI, first, last - first, errors);
+			}
+		}
+		first = last;
+	}
+	m_numPendingSends = 0;
+}
+
+void CSocketIOManagerEpoll::SendBatch(SSocketInfo& si, uint32 first, uint32 count, TSendErrors& errors)
+{
+	for (uint32 i = first; i < first + count; i++)
+	{
+		m_sendIOVecs[i].iov_len = m_pendingSends[i].nLength;
+		m_sendMessages[i].msg_hdr.msg_namelen = m_pendingSends[i].nAddrLength;
+	}
+
+	uint32 sent = 0;
+	while (sent < count)
+	{
+		int r = sendmmsg(si.sock, &m_sendMessages[first + sent], count - sent, 0);
+		if (r > 0)
+		{
+			sent += r;
+			continue;
+		}
+
+		CrySock::eCrySockError sockErr = CrySock::TranslateLastSocketError();
+		if (r == 0 || sockErr == CrySock::eCSE_EWOULDBLOCK)
+		{
+			// socket buffer is full, the rest goes out once the socket is writable again
+			for (uint32 i = first + sent; i < first + count; i++)
+			{
+				si.outgoingAddressed.push_back(SOutgoingAddressedData());
+				si.outgoingAddressed.back().nLength = m_pendingSends[i].nLength;
+				si.outgoingAddressed.back().addr = m_pendingSends[i].addr;
+				memcpy(si.outgoingAddressed.back().data, m_pendingSends[i].data, m_pendingSends[i].nLength);
+			}
+			return;
+		}
+
+		// the first datagram of the batch failed, report it and go on with the rest
+		SSendError error;
+		error.sockid = m_pendingSends[first + sent].sockid;
+		error.addr = m_pendingSends[first + sent].addr;
+		error.err = OSErrorToSocketError(CrySock::TranslateToSocketError(sockErr));
+		errors.push_back(error);
+		sent++;
+	}
+}
+
+void CSocketIOManagerEpoll::ReportSendErrors(const TSendErrors& errors)
+{
+	// reported outside of the lock, the targets may send again from within the callback.
+	// The sends were deferred, so this can be long after RequestSendTo returned (see the class comment)
+	for (size_t i = 0; i < errors.size(); i++)
+	{
+		if (SSocketInfo* pSI = GetSocketInfo(errors[i].sockid))
+		{
+			if (pSI->pSendToTarget)
+			{
+				pSI->pSendToTarget->OnSendToException(errors[i].addr, errors[i].err);
+			}
+		}
+	}
+}
+
+void CSocketIOManagerEpoll::PushUserMessage(int msg)
+{
+	if (msg < eUM_LAST || msg > eUM_FIRST)
+	{
+		// N.B. range check above relies on user messages being -ve
+		CryFatalError("PushUserMessage(%d) invalid message", msg);
+	}
+
+	SUserMessage message;
+	message.m_message = msg;
+	#if LOCK_NETWORK_FREQUENCY
+	message.m_frameID = m_userMessageFrameID;
+	#endif // LOCK_NETWORK_FREQUENCY
+	CrySock::sendto(m_wakeupSocket, reinterpret_cast<char*>(&message), sizeof(message), 0, (CRYSOCKADDR*)&m_wakeupAddr, sizeof(m_wakeupAddr));
+}
+
+void CSocketIOManagerEpoll::WakeUp()
+{
+	char buf[1] = { 0 };
+	CrySock::sendto(m_wakeupSender, buf, 0, 0, (CRYSOCKADDR*)&m_wakeupAddr, sizeof(m_wakeupAddr));
+}
+
+SSocketID CSocketIOManagerEpoll::RegisterSocket(CRYSOCKET sock, int protocol)
+{
+	uint32 id;
+	for (id = 0; id < m_socketInfo.size(); id++)
+		if (!m_socketInfo[id]->isActive)
+			break;
+	if (id == m_socketInfo.size())
+		m_socketInfo.push_back(new SSocketInfo());
+
+	m_socketInfo[id]->isActive = true;
+	do
+		m_socketInfo[id]->salt++;
+	while (!m_socketInfo[id]->salt);
+	m_socketInfo[id]->sock = sock;
+	m_socketInfo[id]->protocol = protocol;
+
+	m_socketInfo[id]->nRecvFrom = m_socketInfo[id]->nRecv = m_socketInfo[id]->nListen = 0;
+	m_socketInfo[id]->epollEvents = 0;
+	m_socketInfo[id]->pRecvFromTarget = NULL;
+	m_socketInfo[id]->pSendToTarget = NULL;
+	m_socketInfo[id]->pConnectTarget = NULL;
+	m_socketInfo[id]->pAcceptTarget = NULL;
+	m_socketInfo[id]->pRecvTarget = NULL;
+	m_socketInfo[id]->pSendTarget = NULL;
+
+	return SSocketID((int)id, m_socketInfo[id]->salt);
+}
+
+void CSocketIOManagerEpoll::UnregisterSocket(SSocketID sockid)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->epollEvents)
+		{
+			// fails harmlessly if the socket was closed already, closing removes it from the set too
+			epoll_event ev;
+			epoll_ctl(m_epollFd, EPOLL_CTL_DEL, pSI->sock, &ev);
+		}
+
+		uint16 salt = pSI->salt;
+		*pSI = SSocketInfo();
+		pSI->salt = salt;
+		do
+			pSI->salt++;
+		while (!pSI->salt);
+	}
+}
+
+void CSocketIOManagerEpoll::RegisterBackoffAddressForSocket(TNetAddress addr, SSocketID sockid)
+{
+	if (m_pWatchdog)
+	{
+		if (SSocketInfo* pSI = GetSocketInfo(sockid))
+		{
+			m_pWatchdog->RegisterTarget(pSI->sock, addr);
+		}
+	}
+}
+
+void CSocketIOManagerEpoll::UnregisterBackoffAddressForSocket(TNetAddress addr, SSocketID sockid)
+{
+	if (m_pWatchdog)
+	{
+		if (SSocketInfo* pSI = GetSocketInfo(sockid))
+		{
+			m_pWatchdog->UnregisterTarget(pSI->sock, addr);
+		}
+	}
+}
+
+CSocketIOManagerEpoll::SSocketInfo* CSocketIOManagerEpoll::GetSocketInfo(SSocketID id)
+{
+	if (id.id >= m_socketInfo.size())
+		return 0;
+	if (m_socketInfo[id.id]->salt != id.salt)
+		return 0;
+	if (!m_socketInfo[id.id]->isActive)
+		return 0;
+	return m_socketInfo[id.id];
+}
+
+void CSocketIOManagerEpoll::SetRecvFromTarget(SSocketID sockid, IRecvFromTarget* pTarget)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		pSI->pRecvFromTarget = pTarget;
+		pSI->nRecvFrom *= (pTarget != NULL);
+	}
+}
+
+void CSocketIOManagerEpoll::SetConnectTarget(SSocketID sockid, IConnectTarget* pTarget)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		pSI->pConnectTarget = pTarget;
+	}
+}
+
+void CSocketIOManagerEpoll::SetSendToTarget(SSocketID sockid, ISendToTarget* pTarget)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		pSI->pSendToTarget = pTarget;
+		if (!pTarget)
+			pSI->outgoingAddressed.clear();
+	}
+}
+
+void CSocketIOManagerEpoll::SetAcceptTarget(SSocketID sockid, IAcceptTarget* pTarget)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		pSI->pAcceptTarget = pTarget;
+		pSI->nListen *= (pTarget != NULL);
+	}
+}
+
+void CSocketIOManagerEpoll::SetRecvTarget(SSocketID sockid, IRecvTarget* pTarget)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		pSI->pRecvTarget = pTarget;
+		pSI->nRecv *= (pTarget != NULL);
+	}
+}
+
+void CSocketIOManagerEpoll::SetSendTarget(SSocketID sockid, ISendTarget* pTarget)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		pSI->pSendTarget = pTarget;
+		if (!pTarget)
+			pSI->outgoing.clear();
+	}
+}
+
+bool CSocketIOManagerEpoll::RequestRecvFrom(SSocketID sockid)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->pRecvFromTarget)
+		{
+			pSI->nRecvFrom++;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CSocketIOManagerEpoll::RequestSendTo(SSocketID sockid, const TNetAddress& addr, const uint8* pData, size_t len)
+{
+	if (len > MAX_UDP_PACKET_SIZE)
+		return false;
+
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->pSendToTarget)
+		{
+	#if NET_MINI_PROFILE || NET_PROFILE_ENABLE
+			RecordPacketSendStatistics(pData, len);
+	#endif
+
+			if (!pSI->outgoingAddressed.empty())
+			{
+				// the socket buffer was full, keep the order until PollWork drained the backlog
+				pSI->outgoingAddressed.push_back(SOutgoingAddressedData());
+				pSI->outgoingAddressed.back().nLength = len;
+				pSI->outgoingAddressed.back().addr = addr;
+				memcpy(pSI->outgoingAddressed.back().data, pData, len);
+				WakeUp();
+				return true;
+			}
+
+			TSendErrors errors;
+			{
+				AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_pendingSendsLock);
+
+				SPendingSend& send = m_pendingSends[m_numPendingSends];
+				send.nAddrLength = sizeof(send.address);
+				if (!ConvertAddr(addr, (CRYSOCKADDR*)&send.address, &send.nAddrLength))
+					return true;
+
+				send.sockid = sockid;
+				send.addr = addr;
+				send.nLength = len;
+				memcpy(send.data, pData, len);
+
+				if (++m_numPendingSends == SEND_BATCH_SIZE)
+				{
+					FlushPendingSendsLocked(errors);
+				}
+				else if (m_numPendingSends == 1 && m_bWaiting)
+				{
+					// queued from outside of the network thread while it sleeps
+					WakeUp();
+				}
+			}
+			ReportSendErrors(errors);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CSocketIOManagerEpoll::RequestSendVoiceTo(SSocketID sockid, const TNetAddress& addr, const uint8* pData, size_t len)
+{
+	return RequestSendTo(sockid, addr, pData, len);
+}
+
+bool CSocketIOManagerEpoll::RequestConnect(SSocketID sockid, const TNetAddress& addr)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->pConnectTarget)
+		{
+			char address[_SS_MAXSIZE];
+			int addrlen = _SS_MAXSIZE;
+			if (ConvertAddr(addr, (CRYSOCKADDR*)address, &addrlen))
+			{
+				if (CrySock::connect(pSI->sock, (CRYSOCKADDR*)address, addrlen))
+				{
+					pSI->pConnectTarget->OnConnectException(OSErrorToSocketError(CrySock::GetLastSocketError()));
+				}
+				else
+					pSI->pConnectTarget->OnConnectComplete();
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CSocketIOManagerEpoll::RequestAccept(SSocketID sockid)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->pAcceptTarget)
+		{
+			pSI->nListen++;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CSocketIOManagerEpoll::RequestSend(SSocketID sockid, const uint8* pData, size_t len)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->pSendTarget)
+		{
+			while (len)
+			{
+				pSI->outgoing.push_back(SOutgoingData());
+				size_t ncp = std::min(len, size_t(MAX_UDP_PACKET_SIZE));
+				pSI->outgoing.back().nLength = ncp;
+				memcpy(pSI->outgoing.back().data, pData, ncp);
+				pData += ncp;
+				len -= ncp;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CSocketIOManagerEpoll::RequestRecv(SSocketID sockid)
+{
+	if (SSocketInfo* pSI = GetSocketInfo(sockid))
+	{
+		if (pSI->pRecvTarget)
+		{
+			pSI->nRecv++;
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif
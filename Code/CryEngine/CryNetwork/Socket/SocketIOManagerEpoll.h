@@ -0,0 +1,207 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#ifndef __SOCKETIOMANAGEREPOLL_H__
+#define __SOCKETIOMANAGEREPOLL_H__
+
+#pragma once
+
+#include "Config.h"
+
+#if CRY_PLATFORM_LINUX
+	#define HAS_SOCKETIOMANAGER_EPOLL
+#endif
+
+#if defined(HAS_SOCKETIOMANAGER_EPOLL)
+
+	#include "ISocketIOManager.h"
+	#include <CryMemory/STLPoolAllocator.h>
+	#include "WatchdogTimer.h"
+	#include <CryMemory/STLGlobalAllocator.h>
+	#include <CryNetwork/CrySocks.h>
+	#include <sys/epoll.h>
+	#include <sys/socket.h>
+
+// Same contract as CSocketIOManagerSelect, but sockets are watched with a level triggered epoll set and
+// datagrams are moved with recvmmsg/sendmmsg.
+// Datagrams passed to RequestSendTo are queued and sent as one batch per socket when the queue is full,
+// before PollWait blocks and after PollWork handled the received data.
+// Unlike the select manager, a failed send is therefore not reported from within RequestSendTo: OnSendToException
+// arrives later, from whichever of those calls sent the batch, with the destination address of the failed datagram.
+class CSocketIOManagerEpoll : public CSocketIOManager
+{
+public:
+	virtual const char* GetName() { return "Epoll"; }
+
+	bool                Init();
+	CSocketIOManagerEpoll();
+	~CSocketIOManagerEpoll();
+
+	virtual bool      PollWait(uint32 waitTime);
+	virtual int       PollWork(bool& performedWork);
+
+	virtual SSocketID RegisterSocket(CRYSOCKET sock, int protocol);
+	virtual void      SetRecvFromTarget(SSocketID sockid, IRecvFromTarget* pTarget);
+	virtual void      SetConnectTarget(SSocketID sockid, IConnectTarget* pTarget);
+	virtual void      SetSendToTarget(SSocketID sockid, ISendToTarget* pTarget);
+	virtual void      SetAcceptTarget(SSocketID sockid, IAcceptTarget* pTarget);
+	virtual void      SetRecvTarget(SSocketID sockid, IRecvTarget* pTarget);
+	virtual void      SetSendTarget(SSocketID sockid, ISendTarget* pTarget);
+	virtual void      RegisterBackoffAddressForSocket(TNetAddress addr, SSocketID sockid);
+	virtual void      UnregisterBackoffAddressForSocket(TNetAddress addr, SSocketID sockid);
+	virtual void      UnregisterSocket(SSocketID sockid);
+
+	virtual bool      RequestRecvFrom(SSocketID sockid);
+	virtual bool      RequestSendTo(SSocketID sockid, const TNetAddress& addr, const uint8* pData, size_t len);
+	virtual bool      RequestSendVoiceTo(SSocketID sockid, const TNetAddress& addr, const uint8* pData, size_t len);
+
+	virtual bool      RequestConnect(SSocketID sockid, const TNetAddress& addr);
+	virtual bool      RequestAccept(SSocketID sock);
+	virtual bool      RequestSend(SSocketID sockid, const uint8* pData, size_t len);
+	virtual bool      RequestRecv(SSocketID sockid);
+
+	virtual void      PushUserMessage(int msg);
+
+	virtual bool      HasPendingData() { return (m_pWatchdog && m_pWatchdog->HasStalled()); }
+
+	#if LOCK_NETWORK_FREQUENCY
+	virtual void ForceNetworkStart() { ++m_userMessageFrameID; }
+	virtual bool NetworkSleep()      { return true; }
+	#endif
+
+private:
+	enum
+	{
+		MAX_EPOLL_EVENTS          = 64,
+		RECV_BATCH_SIZE           = 32,
+		SEND_BATCH_SIZE           = 32,
+		MAX_RECV_BATCHES_PER_POLL = 4, // limits how long a flooded socket can hold up the others
+	};
+
+	static const uint64 WAKEUP_EVENT_DATA = ~uint64(0);
+
+	CWatchdogTimer* m_pWatchdog;
+
+	struct SOutgoingData
+	{
+		int   nLength;
+		uint8 data[MAX_UDP_PACKET_SIZE];
+	};
+	#if USE_SYSTEM_ALLOCATOR
+	typedef std::list<SOutgoingData>                                                                                        TOutgoingDataList;
+	#else
+	typedef std::list<SOutgoingData, stl::STLPoolAllocator<SOutgoingData, stl::PoolAllocatorSynchronizationSinglethreaded>> TOutgoingDataList;
+	#endif
+	struct SOutgoingAddressedData : public SOutgoingData
+	{
+		TNetAddress addr;
+	};
+	#if USE_SYSTEM_ALLOCATOR
+	typedef std::list<SOutgoingAddressedData>                                                                                                 TOutgoingAddressedDataList;
+	#else
+	typedef std::list<SOutgoingAddressedData, stl::STLPoolAllocator<SOutgoingAddressedData, stl::PoolAllocatorSynchronizationSinglethreaded>> TOutgoingAddressedDataList;
+	#endif
+
+	struct SSocketInfo
+	{
+		SSocketInfo()
+		{
+			salt = 1;
+			isActive = false;
+			sock = CRY_INVALID_SOCKET;
+			nRecvFrom = nRecv = nListen = 0;
+			epollEvents = 0;
+			pRecvFromTarget = NULL;
+			pSendToTarget = NULL;
+			pConnectTarget = NULL;
+			pAcceptTarget = NULL;
+			pRecvTarget = NULL;
+			pSendTarget = NULL;
+		}
+
+		uint16                     salt;
+		bool                       isActive;
+		CRYSOCKET                  sock;
+		int                        nRecvFrom;
+		int                        nRecv;
+		int                        nListen;
+		uint32                     epollEvents; // events the socket is currently registered for in the epoll set
+		TOutgoingDataList          outgoing;
+		TOutgoingAddressedDataList outgoingAddressed;
+
+		IRecvFromTarget*           pRecvFromTarget;
+		ISendToTarget*             pSendToTarget;
+		IConnectTarget*            pConnectTarget;
+		IAcceptTarget*             pAcceptTarget;
+		IRecvTarget*               pRecvTarget;
+		ISendTarget*               pSendTarget;
+
+		int32                      protocol;
+
+		bool NeedRead() const  { return nRecv || nRecvFrom || nListen; }
+		bool NeedWrite() const { return !outgoing.empty() || !outgoingAddressed.empty(); }
+	};
+	std::vector<SSocketInfo*, stl::STLGlobalAllocator<SSocketInfo*>> m_socketInfo;
+
+	// datagram queued by RequestSendTo until the next batch is sent
+	struct SPendingSend
+	{
+		SSocketID        sockid;
+		TNetAddress      addr;
+		sockaddr_storage address;
+		int              nAddrLength;
+		int              nLength;
+		uint8            data[MAX_UDP_PACKET_SIZE];
+	};
+
+	struct SSendError
+	{
+		SSocketID    sockid;
+		TNetAddress  addr;
+		ESocketError err;
+	};
+	typedef std::vector<SSendError> TSendErrors;
+
+	SSocketInfo* GetSocketInfo(SSocketID id);
+	void         WakeUp();
+	void         UpdateEpollEvents(SSocketID sockid, SSocketInfo& si);
+	void         RecvFromBatch(SSocketID sockid);
+	void         FlushPendingSends();
+	void         FlushPendingSendsLocked(TSendErrors& errors);
+	void         SendBatch(SSocketInfo& si, uint32 first, uint32 count, TSendErrors& errors);
+	void         ReportSendErrors(const TSendErrors& errors);
+
+	CRYSOCKADDR_IN m_wakeupAddr;
+	CRYSOCKET      m_wakeupSocket;
+	CRYSOCKET      m_wakeupSender;
+
+	#if LOCK_NETWORK_FREQUENCY
+	volatile uint32 m_userMessageFrameID;
+	#endif // LOCK_NETWORK_FREQUENCY
+	struct SUserMessage
+	{
+		int    m_message;
+	#if LOCK_NETWORK_FREQUENCY
+		uint32 m_frameID;
+	#endif // LOCK_NETWORK_FREQUENCY
+	};
+
+	int                             m_epollFd;
+	epoll_event                     m_events[MAX_EPOLL_EVENTS];
+	int                             m_numEvents;
+	volatile bool                   m_bWaiting; // set while PollWait blocks in epoll_wait, sends from other threads have to wake it up
+
+	uint8                           m_recvBuffers[RECV_BATCH_SIZE][MAX_UDP_PACKET_SIZE];
+	sockaddr_storage                m_recvAddresses[RECV_BATCH_SIZE];
+	iovec                           m_recvIOVecs[RECV_BATCH_SIZE];
+	mmsghdr                         m_recvMessages[RECV_BATCH_SIZE];
+
+	CryCriticalSectionNonRecursive  m_pendingSendsLock;
+	SPendingSend                    m_pendingSends[SEND_BATCH_SIZE];
+	iovec                           m_sendIOVecs[SEND_BATCH_SIZE];
+	mmsghdr                         m_sendMessages[SEND_BATCH_SIZE];
+	uint32                          m_numPendingSends;
+};
+
+#endif
+
+#endif
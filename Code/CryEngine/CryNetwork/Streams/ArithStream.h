@@ -57,6 +57,15 @@ protected:
 };
 #endif
 
+// a probability interval as passed to CCommOutputStream::Encode, see ENABLE_STREAM_CODER_CAPTURE
+struct SCommStreamSymbol
+{
+	uint64 tot;
+	uint32 low;
+	uint32 sym;
+};
+typedef std::vector<SCommStreamSymbol> TCommStreamSymbols;
+
 /*
  * CArithOutputStream: encoding
  */
@@ -108,8 +117,16 @@ public:
 		pSizer->Add(*this);
 		if (m_pSA)
 			pSizer->Add(m_vOutput, m_nAllocSize);
+#if ENABLE_STREAM_CODER_CAPTURE
+		pSizer->AddContainer(m_symbols);
+#endif
 	}
 
+#if ENABLE_STREAM_CODER_CAPTURE
+	// the symbols encoded since the last Reset
+	const TCommStreamSymbols& GetSymbols() const { return m_symbols; }
+#endif
+
 #if ENABLE_DEBUG_KIT
 	void EnableLog(bool flag = true) { m_bLog = flag; }
 #else
@@ -276,6 +293,9 @@ private:
 #if ENABLE_ACCURATE_BANDWIDTH_PROFILING
 	float m_accurateSize;
 #endif
+#if ENABLE_STREAM_CODER_CAPTURE
+	TCommStreamSymbols m_symbols;
+#endif
 };
 
 // useful for saving the state of compression and rewinding later
@@ -300,6 +320,9 @@ public:
 		m_help = m_pStream->m_help;
 		m_buffer = m_pStream->m_buffer;
 		m_nOutputSize = m_pStream->m_nOutputSize;
+#if ENABLE_STREAM_CODER_CAPTURE
+		m_numSymbols = m_pStream->m_symbols.size();
+#endif
 		//		m_size = m_pStream->m_accurateSize;
 	}
 
@@ -310,6 +333,9 @@ public:
 		m_pStream->m_help = m_help;
 		m_pStream->m_buffer = m_buffer;
 		m_pStream->m_nOutputSize = m_nOutputSize;
+#if ENABLE_STREAM_CODER_CAPTURE
+		m_pStream->m_symbols.resize(m_numSymbols);
+#endif
 		//		m_pStream->m_accurateSize = m_size;
 	}
 
@@ -320,6 +346,9 @@ private:
 	int                m_help;
 	uint8              m_buffer;
 	size_t             m_nOutputSize;
+#if ENABLE_STREAM_CODER_CAPTURE
+	size_t             m_numSymbols;
+#endif
 	//	float m_size;
 };
 
@@ -356,6 +385,9 @@ inline void CCommOutputStream::Reset(uint8 bonus)
 #if ENABLE_ACCURATE_BANDWIDTH_PROFILING
 	m_accurateSize = 0;
 #endif
+#if ENABLE_STREAM_CODER_CAPTURE
+	m_symbols.resize(0);
+#endif
 }
 
 inline void CCommOutputStream::Renormalize()
@@ -417,6 +449,10 @@ inline void CCommOutputStream::Encode(InternalStateType tot, ProbabilityType low
 	m_low += tmp;
 
 	AddEncToCRC(tot, low, sym);
+#if ENABLE_STREAM_CODER_CAPTURE
+	const SCommStreamSymbol symbol = { tot, low, sym };
+	m_symbols.push_back(symbol);
+#endif
 }
 
 inline void CCommOutputStream::EncodeShift(int bits, ProbabilityType low, ProbabilityType sym)
@@ -439,6 +475,10 @@ inline void CCommOutputStream::EncodeShift(int bits, ProbabilityType low, Probab
 	m_low += tmp;
 
 	AddEncToCRC(One << bits, low, sym);
+#if ENABLE_STREAM_CODER_CAPTURE
+	const SCommStreamSymbol symbol = { One << bits, low, sym };
+	m_symbols.push_back(symbol);
+#endif
 }
 
 inline size_t CCommOutputStream::Flush()
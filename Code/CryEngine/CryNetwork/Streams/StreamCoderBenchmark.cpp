@@ -0,0 +1,465 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "StreamCoderBenchmark.h"
+
+#if USE_ARITHSTREAM
+
+// Interleaved rANS with 64 bit states and 32 bit output words, the candidate to replace the range coder of the packet
+// streams. It's only run by the benchmark: it has to win on captured traffic before it goes on the wire.
+// rANS codes in reverse, so a packet is coded from its symbol list, last symbol first. Consecutive symbols go to
+// NumLanes independent states, so the decoder steps of neighbouring symbols don't depend on each other. Decoding takes
+// a mask and a multiply where the range coder divides twice: power of two totals are coded as they are, all others are
+// mapped onto a power of two with a reciprocal (CScale). Totals above MaxDirectTot only come from 32 bit fields and
+// are split into two symbols.
+namespace NRans
+{
+static const int    NumLanes = 2;
+static const uint64 LowerBound = 1ull << 31; // states are kept in [LowerBound, LowerBound << 32)
+static const uint64 MaxDirectTot = 1ull << 31;
+static const int    ExtraScaleBits = 8;      // precision added to totals which aren't a power of two
+
+// Maps [0,tot) onto [0,1<<scaleBits). Both ends compute the same mapping, value -> (value * rcp) >> 32, which is
+// strictly increasing, so every symbol keeps a non empty interval.
+class CScale
+{
+public:
+	CScale() : m_tot(0), m_rcp(0), m_scaleBits(0) {}
+
+	void Set(uint64 tot)
+	{
+		if (tot == m_tot)
+			return;
+		NET_ASSERT(tot && tot <= MaxDirectTot);
+		m_tot = tot;
+		if ((tot & (tot - 1)) == 0)
+		{
+			m_scaleBits = int(IntegerLog2(tot));
+			m_rcp = 0;
+		}
+		else
+		{
+			m_scaleBits = min(int(IntegerLog2(tot)) + 1 + ExtraScaleBits, 31);
+			m_rcp = ((1ull << (32 + m_scaleBits)) + tot - 1) / tot;
+		}
+	}
+
+	int    GetScaleBits() const     { return m_scaleBits; }
+	uint32 Map(uint64 value) const { return m_rcp ? uint32((value * m_rcp) >> 32) : uint32(value); }
+
+	// the value whose mapped interval contains slot
+	uint32 Unmap(uint32 slot) const
+	{
+		if (!m_rcp)
+			return slot;
+		// exact for the mapping without the rounding of rcp, which can put a value one slot higher
+		const uint32 value = uint32(((uint64(slot) + 1) * m_tot - 1) >> m_scaleBits);
+		return Map(value) > slot ? value - 1 : value;
+	}
+
+private:
+	uint64 m_tot;
+	uint64 m_rcp;
+	int    m_scaleBits;
+};
+
+// encoding step: the words are written in reverse order
+inline void Put(uint64& state, std::vector<uint32>& words, int scaleBits, uint32 start, uint32 freq)
+{
+	const uint64 maxState = ((LowerBound >> scaleBits) << 32) * freq;
+	if (state >= maxState)
+	{
+		words.push_back(uint32(state));
+		state >>= 32;
+	}
+	if (freq == 1)
+		state = (state << scaleBits) + start;
+	else
+		state = ((state / freq) << scaleBits) + (state % freq) + start;
+}
+
+// Output: the final states of the lanes and the words in the order the decoder reads them, everything little endian.
+class CEncoder
+{
+public:
+	size_t Encode(const TCommStreamSymbols& symbols, uint8* pOutput)
+	{
+		uint32 numSymbols = 0;
+		for (size_t i = 0; i < symbols.size(); ++i)
+			numSymbols += (symbols[i].tot > MaxDirectTot) ? 2 : 1;
+
+		uint64 states[NumLanes];
+		for (int i = 0; i < NumLanes; i++)
+			states[i] = LowerBound;
+
+		m_words.resize(0);
+		uint32 index = numSymbols;
+		for (size_t i = symbols.size(); i-- > 0; )
+		{
+			const SCommStreamSymbol& symbol = symbols[i];
+			if (symbol.tot > MaxDirectTot)
+			{
+				// the decoder reads the high half first
+				Put(states[--index % NumLanes], m_words, 16, symbol.low & 0xffff, 1);
+				m_scale.Set(((symbol.tot - 1) >> 16) + 1);
+				const uint32 start = m_scale.Map(symbol.low >> 16);
+				Put(states[--index % NumLanes], m_words, m_scale.GetScaleBits(), start, m_scale.Map((symbol.low >> 16) + 1) - start);
+			}
+			else if ((symbol.tot & (symbol.tot - 1)) == 0)
+			{
+				Put(states[--index % NumLanes], m_words, int(IntegerLog2(symbol.tot)), symbol.low, symbol.sym);
+			}
+			else
+			{
+				m_scale.Set(symbol.tot);
+				const uint32 start = m_scale.Map(symbol.low);
+				Put(states[--index % NumLanes], m_words, m_scale.GetScaleBits(), start, m_scale.Map(uint64(symbol.low) + symbol.sym) - start);
+			}
+		}
+		NET_ASSERT(index == 0);
+
+		uint8* pOut = pOutput;
+		for (int i = 0; i < NumLanes; i++)
+		{
+			for (int j = 0; j < 64; j += 8)
+				*pOut++ = uint8(states[i] >> j);
+		}
+		for (size_t i = m_words.size(); i-- > 0; )
+		{
+			const uint32 word = m_words[i];
+			*pOut++ = uint8(word);
+			*pOut++ = uint8(word >> 8);
+			*pOut++ = uint8(word >> 16);
+			*pOut++ = uint8(word >> 24);
+		}
+		return pOut - pOutput;
+	}
+
+private:
+	std::vector<uint32> m_words;
+	CScale              m_scale;
+};
+
+// Decode and Update work like the ones of CCommInputStream
+class CDecoder
+{
+public:
+	CDecoder(const uint8* pInput, size_t size)
+		: m_pInput(pInput)
+		, m_pEnd(pInput + size)
+		, m_numSymbols(0)
+		, m_slot(0)
+	{
+		for (int i = 0; i < NumLanes; i++)
+		{
+			m_states[i] = 0;
+			for (int j = 0; j < 64; j += 8)
+				m_states[i] |= uint64(GetByte()) << j;
+		}
+	}
+
+	uint32 Decode(uint64 tot)
+	{
+		NET_ASSERT(tot);
+		if (tot > MaxDirectTot)
+		{
+			// both halves are read here, Update has nothing left to do
+			const uint32 high = DecodeUniform(((tot - 1) >> 16) + 1);
+			return (high << 16) | DecodeUniform(1 << 16);
+		}
+		m_scale.Set(tot);
+		m_slot = uint32(m_states[m_numSymbols % NumLanes] & ((1ull << m_scale.GetScaleBits()) - 1));
+		return m_scale.Unmap(m_slot);
+	}
+
+	void Update(uint64 tot, uint32 low, uint32 sym)
+	{
+		if (tot > MaxDirectTot)
+			return;
+		const uint32 start = m_scale.Map(low);
+		const uint64 freq = m_scale.Map(uint64(low) + sym) - start;
+		uint64& state = m_states[m_numSymbols++ % NumLanes];
+		state = freq * (state >> m_scale.GetScaleBits()) + m_slot - start;
+		if (state < LowerBound)
+			state = (state << 32) | GetWord();
+	}
+
+	// a raw bits symbol decodes to the low bits of the state, no lookup needed
+	uint32 ReadBits(int bits)
+	{
+		uint64& state = m_states[m_numSymbols++ % NumLanes];
+		const uint32 value = uint32(state & ((1ull << bits) - 1));
+		state >>= bits;
+		if (state < LowerBound)
+			state = (state << 32) | GetWord();
+		return value;
+	}
+
+private:
+	uint8 GetByte()
+	{
+		return (m_pInput != m_pEnd) ? *m_pInput++ : 0;
+	}
+
+	uint32 GetWord()
+	{
+		if (m_pEnd - m_pInput >= 4)
+		{
+			const uint32 word = m_pInput[0] | (m_pInput[1] << 8) | (m_pInput[2] << 16) | (uint32(m_pInput[3]) << 24);
+			m_pInput += 4;
+			return word;
+		}
+		uint32 word = GetByte();
+		word |= GetByte() << 8;
+		word |= GetByte() << 16;
+		word |= uint32(GetByte()) << 24;
+		return word;
+	}
+
+	uint32 DecodeUniform(uint64 tot)
+	{
+		const uint32 value = Decode(tot);
+		Update(tot, value, 1);
+		return value;
+	}
+
+	const uint8* m_pInput;
+	const uint8* m_pEnd;
+	uint64       m_states[NumLanes];
+	uint32       m_numSymbols;
+	uint32       m_slot; // from Decode for Update
+	CScale       m_scale;
+};
+}
+
+namespace StreamCoderBenchmarkDetail
+{
+static const size_t MAX_CAPTURED_PACKETS = 256;
+
+	#if ENABLE_STREAM_CODER_CAPTURE
+struct SCapture
+{
+	SCapture() : next(0) {}
+
+	CryCriticalSection              lock;
+	std::vector<TCommStreamSymbols> packets;
+	size_t                          next;
+};
+
+static SCapture& GetCapture()
+{
+	static SCapture capture;
+	return capture;
+}
+	#endif
+
+static uint32 Random(uint32& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return state >> 8;
+}
+
+static void AddSymbol(TCommStreamSymbols& symbols, uint64 tot, uint32 low, uint32 sym)
+{
+	const SCommStreamSymbol symbol = { tot, low, sym };
+	symbols.push_back(symbol);
+}
+
+// A packet as the policies write it: message ids and flags from adaptive models, quantized values as raw bits,
+// and now and then a 32 bit field.
+static void MakeSyntheticPacket(TCommStreamSymbols& symbols, uint32& randomState)
+{
+	symbols.resize(0);
+	const uint32 numSymbols = 200 + Random(randomState) % 600;
+	while (symbols.size() < numSymbols)
+	{
+		switch (Random(randomState) % 8)
+		{
+		case 0:
+		case 1:
+			{
+				// skewed binary model
+				const uint32 p = 100 + Random(randomState) % 27;
+				if (Random(randomState) % 8)
+					AddSymbol(symbols, 128, 0, p);
+				else
+					AddSymbol(symbols, 128, p, 128 - p);
+			}
+			break;
+		case 2:
+			{
+				// adaptive model with an arbitrary total
+				const uint32 tot = 300 + Random(randomState) % 3000;
+				const uint32 sym = 1 + Random(randomState) % (tot / 4);
+				AddSymbol(symbols, tot, Random(randomState) % (tot - sym), sym);
+			}
+			break;
+		case 3:
+			{
+				// 32 bit field
+				const uint32 high = Random(randomState) << 8;
+				AddSymbol(symbols, uint64(1) << 32, high | (Random(randomState) & 0xff), 1);
+			}
+			break;
+		default:
+			{
+				const uint32 bits = 1 + Random(randomState) % 16;
+				AddSymbol(symbols, 1 << bits, Random(randomState) & ((1 << bits) - 1), 1);
+			}
+			break;
+		}
+	}
+}
+
+static bool IsPowerOfTwo(uint64 value)
+{
+	return (value & (value - 1)) == 0;
+}
+
+static size_t EncodeRange(CCommOutputStream& out, const TCommStreamSymbols& symbols)
+{
+	out.Reset();
+	for (size_t i = 0; i < symbols.size(); ++i)
+	{
+		const SCommStreamSymbol& symbol = symbols[i];
+		if (IsPowerOfTwo(symbol.tot))
+			out.EncodeShift(int(IntegerLog2(symbol.tot)), symbol.low, symbol.sym);
+		else
+			out.Encode(symbol.tot, symbol.low, symbol.sym);
+	}
+	return out.Flush();
+}
+
+// returns false if a decoded value isn't the encoded one
+static bool DecodeRange(const uint8* pData, size_t size, const TCommStreamSymbols& symbols)
+{
+	CCommInputStream in(pData, size);
+	bool ok = true;
+	for (size_t i = 0; i < symbols.size(); ++i)
+	{
+		const SCommStreamSymbol& symbol = symbols[i];
+		uint32 value;
+		if (IsPowerOfTwo(symbol.tot))
+		{
+			const int bits = int(IntegerLog2(symbol.tot));
+			value = in.DecodeShift(bits);
+			in.UpdateShift(bits, symbol.low, symbol.sym);
+		}
+		else
+		{
+			value = in.Decode(symbol.tot);
+			in.Update(symbol.tot, symbol.low, symbol.sym);
+		}
+		ok &= (value >= symbol.low) && (value - symbol.low < symbol.sym);
+	}
+	return ok;
+}
+
+static bool DecodeRans(const uint8* pData, size_t size, const TCommStreamSymbols& symbols)
+{
+	NRans::CDecoder in(pData, size);
+	bool ok = true;
+	for (size_t i = 0; i < symbols.size(); ++i)
+	{
+		const SCommStreamSymbol& symbol = symbols[i];
+		uint32 value;
+		if (symbol.sym == 1 && IsPowerOfTwo(symbol.tot) && symbol.tot <= NRans::MaxDirectTot)
+		{
+			value = in.ReadBits(int(IntegerLog2(symbol.tot)));
+		}
+		else
+		{
+			value = in.Decode(symbol.tot);
+			in.Update(symbol.tot, symbol.low, symbol.sym);
+		}
+		ok &= (value >= symbol.low) && (value - symbol.low < symbol.sym);
+	}
+	return ok;
+}
+}
+
+	#if ENABLE_STREAM_CODER_CAPTURE
+void CaptureStreamCoderPacket(const TCommStreamSymbols& symbols)
+{
+	using namespace StreamCoderBenchmarkDetail;
+
+	SCapture& capture = GetCapture();
+	AUTO_LOCK_T(CryCriticalSection, capture.lock);
+	if (capture.packets.size() < MAX_CAPTURED_PACKETS)
+		capture.packets.push_back(symbols);
+	else
+		capture.packets[capture.next] = symbols;
+	capture.next = (capture.next + 1) % MAX_CAPTURED_PACKETS;
+}
+	#endif
+
+void StreamCoderBenchmark(IConsoleCmdArgs* pArgs)
+{
+	using namespace StreamCoderBenchmarkDetail;
+
+	const uint32 numRepeats = pArgs->GetArgCount() > 1 ? clamp_tpl(atoi(pArgs->GetArg(1)), 1, 10000) : 100;
+
+	std::vector<TCommStreamSymbols> packets;
+	#if ENABLE_STREAM_CODER_CAPTURE
+	{
+		SCapture& capture = GetCapture();
+		AUTO_LOCK_T(CryCriticalSection, capture.lock);
+		packets = capture.packets;
+	}
+	#endif
+	const bool synthetic = packets.empty();
+	if (synthetic)
+	{
+		uint32 randomState = 0x5eed;
+		packets.resize(MAX_CAPTURED_PACKETS);
+		for (size_t i = 0; i < packets.size(); ++i)
+			MakeSyntheticPacket(packets[i], randomState);
+	}
+
+	size_t numSymbols = 0;
+	for (size_t i = 0; i < packets.size(); ++i)
+		numSymbols += packets[i].size();
+	if (!numSymbols)
+	{
+		CryLogAlways("Stream coder benchmark: the captured packets are empty");
+		return;
+	}
+
+	CryLogAlways("Stream coder benchmark: %" PRISIZE_T " %s packets, %" PRISIZE_T " symbols, %u repeats",
+	             packets.size(), synthetic ? "synthetic" : "captured", numSymbols, numRepeats);
+
+	ITimer* pTimer = gEnv->pTimer;
+	std::vector<uint8> buffer(64 * 1024);
+	CCommOutputStream rangeOut(&buffer[0], buffer.size());
+	NRans::CEncoder ransOut;
+	const char* names[] = { "range", "rANS" };
+	for (int coder = 0; coder < 2; ++coder)
+	{
+		CTimeValue encodeTime, decodeTime;
+		uint64 bytes = 0;
+		uint32 failures = 0;
+		for (uint32 repeat = 0; repeat < numRepeats; ++repeat)
+		{
+			for (size_t i = 0; i < packets.size(); ++i)
+			{
+				CTimeValue start = pTimer->GetAsyncTime();
+				const size_t size = coder ? ransOut.Encode(packets[i], &buffer[0]) : EncodeRange(rangeOut, packets[i]);
+				encodeTime += pTimer->GetAsyncTime() - start;
+				bytes += size;
+
+				start = pTimer->GetAsyncTime();
+				const bool ok = coder ? DecodeRans(&buffer[0], size, packets[i]) : DecodeRange(&buffer[0], size, packets[i]);
+				decodeTime += pTimer->GetAsyncTime() - start;
+				failures += ok ? 0 : 1;
+			}
+		}
+
+		const float symbolCount = float(numSymbols) * float(numRepeats);
+		const float packetCount = float(packets.size()) * float(numRepeats);
+		CryLogAlways("  %-5s: encode %.2f ns/symbol, decode %.2f ns/symbol, %.1f bytes/packet, %u failures",
+		             names[coder], encodeTime.GetSeconds() * 1e9f / symbolCount, decodeTime.GetSeconds() * 1e9f / symbolCount,
+		             float(bytes) / packetCount, failures);
+	}
+}
+
+#endif // USE_ARITHSTREAM
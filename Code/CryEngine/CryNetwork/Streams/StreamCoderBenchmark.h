@@ -0,0 +1,25 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#ifndef __STREAMCODERBENCHMARK_H__
+#define __STREAMCODERBENCHMARK_H__
+
+#pragma once
+
+#include "Config.h"
+
+#if USE_ARITHSTREAM
+
+	#include "ArithStream.h"
+
+	#if ENABLE_STREAM_CODER_CAPTURE
+// Keeps the symbols of the last sent packets (net_streamCoderCapture), so the coders can be compared on real traffic.
+void CaptureStreamCoderPacket(const TCommStreamSymbols& symbols);
+	#endif
+
+// console command: encodes and decodes the captured (or synthetic) packets with the range coder and rANS, logs time
+// and size
+void StreamCoderBenchmark(IConsoleCmdArgs* pArgs);
+
+#endif // USE_ARITHSTREAM
+
+#endif
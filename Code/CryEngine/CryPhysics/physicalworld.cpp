@@ -118,7 +118,7 @@ int GetEntityProfileType(CPhysicalEntity *pent)
 }
 
 
-CPhysicalWorld::CPhysicalWorld(ILog *pLog) : m_nWorkerThreads(0)
+CPhysicalWorld::CPhysicalWorld(ILog *pLog) : m_nWorkerThreads(0), m_nStepJobs(0)
 {
 	m_pLog = pLog;
 	g_pPhysWorlds[g_nPhysWorlds] = this;
@@ -232,6 +232,9 @@ CPhysicalWorld::CPhysicalWorld(ILog *pLog) : m_nWorkerThreads(0)
 	m_vars.numThreads = 2;
 	m_vars.physCPU = 4;
 	m_vars.physWorkerCPU = 1;
+	m_vars.bJobSystemStep = 0;
+	m_vars.jobSystemStepMinCost = 32;
+	m_vars.bRwiBatchPackets = 1;
 	m_vars.helperOffset.zero();
 	m_vars.timeScalePlayers = 1.0f;
 	MARK_UNUSED m_vars.flagsColliderDebris;
@@ -344,7 +347,7 @@ void CPhysicalWorld::Init()
 	for(i=0;i<=MAX_PHYS_THREADS;i++) {
 		m_pHeightfield[i] = 0;
 		m_lockCaller[i] = 0;
-		m_threadData[i].szList=0; m_threadData[i].pTmpEntList=0;
+		m_threadData[i].szList=0; m_threadData[i].pTmpEntList=0; m_threadData[i].pRwiPacketBuf=0;
 		m_threadData[i].szTmpPartBVList=m_threadData[i].nTmpPartBVs=0;
 		m_threadData[i].pTmpPartBVList=0; m_threadData[i].pTmpPartBVListOwner=0;
 		m_threadData[i].pTmpPrecompEntsLE=0; m_threadData[i].nPrecompEntsAllocLE=0;
@@ -592,6 +595,7 @@ void CPhysicalWorld::Shutdown(int bDeleteGeometries)
 		delete[] m_threadData[i].pTmpEntList;
 	for(i=0;i<=MAX_PHYS_THREADS;i++) {
 		m_threadData[i].szList=0; m_threadData[i].pTmpEntList=0;
+		delete m_threadData[i].pRwiPacketBuf; m_threadData[i].pRwiPacketBuf=0;
 	}
 
 	m_pEventFirst = m_pEventLast = 0;
@@ -2095,6 +2099,7 @@ void CPhysicalWorld::ProcessNextLivingEntity(float time_interval, int bSkipFlagg
 {
 	CPhysicalEntity *pent,*pentEnd;
 	Vec3 BBox[2],BBoxNew[2],velAbs;
+	const int nWorkers = GetNumStepWorkers();
 	do {
 		{ WriteLock lock(m_lockNextEntityGroup);
 			if (!m_pCurEnt)
@@ -2114,19 +2119,19 @@ void CPhysicalWorld::ProcessNextLivingEntity(float time_interval, int bSkipFlagg
 			}
 			m_pCurEnt = pentEnd->m_next;
 		}
-		if (m_nWorkerThreads>0) {
-			assert(m_nWorkerThreads+FIRST_WORKER_THREAD<=MAX_PHYS_THREADS);
+		if (nWorkers>0) {
+			assert(nWorkers+FIRST_WORKER_THREAD<=MAX_PHYS_THREADS);
 			int i;
 			do {
 				do {
 					ReadLock lockr(m_lockPlayerGroups);
-					for(i=0; i<m_nWorkerThreads+FIRST_WORKER_THREAD && (i==iCaller || !AABB_overlap(m_BBoxPlayerGroup[i],BBox)); i++);
-					if (i>=m_nWorkerThreads+FIRST_WORKER_THREAD)
+					for(i=0; i<nWorkers+FIRST_WORKER_THREAD && (i==iCaller || !AABB_overlap(m_BBoxPlayerGroup[i],BBox)); i++);
+					if (i>=nWorkers+FIRST_WORKER_THREAD)
 						break;
 				} while(true);
 				{ WriteLock lockw(m_lockPlayerGroups);
-					for(i=0; i<m_nWorkerThreads+FIRST_WORKER_THREAD && (i==iCaller || !AABB_overlap(m_BBoxPlayerGroup[i],BBox)); i++);
-					if (i>=m_nWorkerThreads+FIRST_WORKER_THREAD) {
+					for(i=0; i<nWorkers+FIRST_WORKER_THREAD && (i==iCaller || !AABB_overlap(m_BBoxPlayerGroup[i],BBox)); i++);
+					if (i>=nWorkers+FIRST_WORKER_THREAD) {
 						m_BBoxPlayerGroup[iCaller][0] = BBox[0];
 						m_BBoxPlayerGroup[iCaller][1] = BBox[1];
 						break;
@@ -2140,7 +2145,7 @@ void CPhysicalWorld::ProcessNextLivingEntity(float time_interval, int bSkipFlagg
 			if (pent==pentEnd)
 				break;
 		}	while (pent=pent->m_next);
-		if (m_nWorkerThreads>0) {
+		if (nWorkers>0) {
 			WriteLock lock(m_lockPlayerGroups);
 			m_BBoxPlayerGroup[iCaller][0]=m_BBoxPlayerGroup[iCaller][1] = Vec3(1e10f);
 		}
@@ -2198,19 +2203,80 @@ void CPhysicalWorld::ThreadProc(int ithread, SPhysTask *pTask)
 			m_threadDone[ithread-FIRST_WORKER_THREAD].Set();
 			break;
 		}
-		switch(m_rq.ipass) {
-			case 0:
-			case 1: ProcessNextEntityIsland(m_rq.time_interval, m_rq.ipass, m_rq.iter, *m_rq.pbAllGroupsFinished,ithread); break;
-			case 2: ProcessNextEngagedIndependentEntity(ithread); break;
-			case 3: ProcessNextLivingEntity(m_rq.time_interval, m_rq.bSkipFlagged, ithread); break;
-			case 4: ProcessNextIndependentEntity(m_rq.time_interval, m_rq.bSkipFlagged, ithread); break;
-			case 5: ProcessBreakingEntities(m_rq.time_interval); break;
-		}
+		ProcessThreadTask(ithread);
 		m_threadDone[ithread-FIRST_WORKER_THREAD].Set();
 	}
 	AtomicAdd(&m_nWorkerThreads,-1);
 }
 
+void CPhysicalWorld::ProcessThreadTask(int ithread)
+{
+	switch(m_rq.ipass) {
+		case 0:
+		case 1: ProcessNextEntityIsland(m_rq.time_interval, m_rq.ipass, m_rq.iter, *m_rq.pbAllGroupsFinished,ithread); break;
+		case 2: ProcessNextEngagedIndependentEntity(ithread); break;
+		case 3: ProcessNextLivingEntity(m_rq.time_interval, m_rq.bSkipFlagged, ithread); break;
+		case 4: ProcessNextIndependentEntity(m_rq.time_interval, m_rq.bSkipFlagged, ithread); break;
+		case 5: ProcessBreakingEntities(m_rq.time_interval); break;
+	}
+}
+
+int CPhysicalWorld::EstimateStepTaskCost(int ipass, int maxCost)
+{
+	// rough cost in entity steps; island entities also count their colliders, since those drive contact solving
+	// the lists are only walked up to maxCost, a larger cost wouldn't change the number of lanes
+	CPhysicalEntity *pent,**pentlist;
+	int cost = 0;
+	switch(ipass) {
+		case 0:
+		case 1:
+			if (m_nGroups-m_iCurGroup>=maxCost) // each island has at least one entity
+				return maxCost;
+			for(int i=m_iCurGroup; i<m_nGroups && cost<maxCost; i++) for(pent=m_pTmpEntList1[i]; pent && cost<maxCost; pent=pent->m_next_coll)
+				cost += 1+pent->GetColliders(pentlist);
+			break;
+		case 2:
+		case 4: for(pent=(CPhysicalEntity*)m_pCurEnt; pent && cost<maxCost; pent=pent->m_next_coll2) cost++; break;
+		case 3: for(pent=(CPhysicalEntity*)m_pCurEnt; pent && cost<maxCost; pent=pent->m_next) cost++; break;
+	}
+	return min(cost,maxCost);
+}
+
+void CPhysicalWorld::StartStepJobs()
+{
+	if (!m_vars.bJobSystemStep || !gEnv->pJobManager)
+		return;
+	// each job takes one of the per-thread data slots, lanes below FIRST_WORKER_THREAD are run by the caller
+	// only as many jobs are spawned as the estimated task cost justifies, the rest of the pool stays free for other systems
+	int nLanes = min(MAX_PHYS_THREADS, (int)gEnv->pJobManager->GetNumWorkerThreads()+FIRST_WORKER_THREAD);
+	const int minCost = max(1,m_vars.jobSystemStepMinCost);
+	nLanes = max(1, min(nLanes, EstimateStepTaskCost(m_rq.ipass, nLanes*minCost)/minCost));
+	m_nStepJobs = max(0, nLanes-FIRST_WORKER_THREAD);
+	for(int ilane=FIRST_WORKER_THREAD; ilane<nLanes; ilane++)
+		gEnv->pJobManager->AddLambdaJob("PhysicsStepTask", [this,ilane]() { ProcessStepJob(ilane); }, JobManager::eHighPriority, &m_stepJobState);
+}
+
+void CPhysicalWorld::FinishStepJobs()
+{
+	if (m_nStepJobs) {
+		gEnv->pJobManager->WaitForJob(m_stepJobState);
+		m_nStepJobs = 0;
+	}
+}
+
+void CPhysicalWorld::ProcessStepJob(int ilane)
+{
+#if MAX_PHYS_THREADS>1
+	// job workers are shared with other systems, so the physics thread index is only borrowed for the job's duration
+	int *pidxPrev = TLS_GET(int*, g_pidxPhysThread);
+	MarkAsPhysWorkerThread(&ilane);
+#endif
+	ProcessThreadTask(ilane);
+#if MAX_PHYS_THREADS>1
+	TLS_SET(g_pidxPhysThread, pidxPrev);
+#endif
+}
+
 int __curstep = 0; // debug
 
 void CPhysicalWorld::TimeStep(float time_interval, int flags)
@@ -2227,19 +2293,20 @@ void CPhysicalWorld::TimeStep(float time_interval, int flags)
 	//	m_pLog = 0;
 
 	m_vars.numThreads = min(m_vars.numThreads,MAX_PHYS_THREADS);
-	if (m_vars.numThreads!=m_nWorkerThreads+FIRST_WORKER_THREAD) {
+	const int numThreads = m_vars.bJobSystemStep ? FIRST_WORKER_THREAD : m_vars.numThreads; // job system stepping doesn't use physics worker threads
+	if (numThreads!=m_nWorkerThreads+FIRST_WORKER_THREAD) {
 		for(i=m_nWorkerThreads-1;i>=0;i--) {
 			m_threads[i]->bStop=1,m_threadStart[i].Set(), m_threadDone[i].Wait();
 			delete m_threads[i]; m_threads[i] = NULL;
 		}
 
-		for(i=0;i<m_vars.numThreads-FIRST_WORKER_THREAD;i++) {
+		for(i=0;i<numThreads-FIRST_WORKER_THREAD;i++) {
 			m_threads[i] = new SPhysTask(this,i+FIRST_WORKER_THREAD);
 			if (!gEnv->pThreadManager->SpawnThread(m_threads[i], "PhysicsWorkerThread_%u", i)) {
 				CryFatalError("Error spawning \"PhysicsWorkerThread_%u\" thread.", i);
 			}
 		}
-		for(; m_nWorkerThreads!=m_vars.numThreads-FIRST_WORKER_THREAD; )
+		for(; m_nWorkerThreads!=numThreads-FIRST_WORKER_THREAD; )
 			CrySleep(1);
 	}
 
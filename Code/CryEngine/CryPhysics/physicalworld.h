@@ -8,11 +8,13 @@
 #include "physicalentity.h"
 #include "geoman.h"
 #include <CryThreading/IThreadManager.h>
+#include <CryThreading/IJobManager.h>
 
 const int NSURFACETYPES = 512;
 const int PLACEHOLDER_CHUNK_SZLG2 = 8;
 const int PLACEHOLDER_CHUNK_SZ = 1<<PLACEHOLDER_CHUNK_SZLG2;
 const int QUEUE_SLOT_SZ = 8192;
+const int RWI_PACKET_SIZE = 4;	// rays traced together by RayWorldIntersectionBatch (one SSE register)
 
 const int PENT_SETPOSED = 1<<16;
 const int PENT_QUEUED_BIT = 17;
@@ -110,9 +112,26 @@ struct CRY_ALIGN(128) SPrecompPartBV {
 	int ient; int ipart; int iparttype;
 };
 
+// grid entities of a packet cell whose quantized bounds are crossed by some of the packet rays
+struct SRwiPacketEnt {
+	CPhysicalPlaceholder *pent;
+	int iSimClass;
+	int lanes;
+	float tenter[RWI_PACKET_SIZE];	// where the ray enters the bounds, as a fraction of the ray
+};
+
+// scratch of RayWorldIntersectionPacket, kept per caller
+struct SRwiPacketBuffers {
+	std::vector<int> cells[RWI_PACKET_SIZE];		// the cells each ray walks, in walk order
+	std::vector<Vec2i> cellEnts[RWI_PACKET_SIZE];	// the range of ents of each of the cells above
+	std::vector<uint64> sorted;									// cell<<32 | ray<<28 | the cell's index in the walk
+	std::vector<SRwiPacketEnt> ents;
+};
+
 struct SThreadData {
 	CPhysicalEntity **pTmpEntList;
 	int szList;
+	SRwiPacketBuffers *pRwiPacketBuf;	// allocated by the first RayWorldIntersectionBatch with packets
 
 	SPrecompPartBV *pTmpPartBVList;
 	int szTmpPartBVList, nTmpPartBVs;
@@ -217,12 +236,16 @@ struct SPhysTask : public IThread {
 #define THREAD_TASK(a,b) \
 	m_rq.ipass=a; \
 	for(int ithread=0;ithread<m_nWorkerThreads;ithread++)	m_threadStart[ithread].Set();	\
+	StartStepJobs(); \
 	b; \
+	FinishStepJobs(); \
 	for(int ithread=0;ithread<m_nWorkerThreads;ithread++)	m_threadDone[ithread].Wait();
 #else
 #define THREAD_TASK(a,b) \
 	m_rq.ipass=a; \
 	for(int ithread=0;ithread<m_nWorkerThreads;ithread++)	m_threadStart[ithread].Set();	\
+	StartStepJobs(); \
+	FinishStepJobs(); \
 	for(int ithread=0;ithread<m_nWorkerThreads;ithread++)	m_threadDone[ithread].Wait();
 #endif
 
@@ -336,10 +359,18 @@ public:
 		return RayWorldIntersection(rp, pNameTag, iCaller);
 	}
 	virtual int RayWorldIntersection(const SRWIParams &rp, const char *pNameTag="RayWorldIntersection(Physics)", int iCaller=get_iCaller_int());
+	virtual int RayWorldIntersectionBatch(const SRWIParams *pRays, int nRays, ray_hit *pHits, int *pNumHits, const char *pNameTag="RayWorldIntersection(Physics)", int iCaller=get_iCaller_int());
 	virtual int TracePendingRays(int bDoTracing=1);
 
 	void RayHeightfield(const Vec3 &org,Vec3 &dir, ray_hit *hits, int flags, int iCaller);
 	void RayWater(const Vec3 &org,const Vec3 &dir, struct entity_grid_checker &egc, int flags,int nMaxHits, ray_hit *hits);
+	// the steps of RayWorldIntersection before and after the entity grid walk, shared with the packets of RayWorldIntersectionBatch
+	int RayPrepare(const SRWIParams &rp, Vec3 &dir, struct entity_grid_checker &egc, int iCaller);
+	int RayOutOfGridBounds(const Vec3 &origin_grid, const Vec3 &dir_grid);
+	void RayFinishGrid(const SRWIParams &rp, struct entity_grid_checker &egc, int iCaller);
+	int RayCollectHits(const SRWIParams &rp, const Vec3 &dir, struct entity_grid_checker &egc, int nTicks, int iCaller,
+		CPhysicalEntity *&pentLastHit,int &ipartLastHit,int &inodeLastHit);
+	int RayWorldIntersectionPacket(const SRWIParams *pRays, const int *pRayIdx, const int *pHitOffsets, int nRays, ray_hit *pHits, int *pNumHits, int iCaller);
 
 	virtual void SimulateExplosion(pe_explosion *pexpl, IPhysicalEntity **pSkipEnts=0,int nSkipEnts=0,
 		int iTypes=ent_rigid|ent_sleeping_rigid|ent_living|ent_independent, int iCaller=get_iCaller_int());
@@ -550,6 +581,13 @@ public:
 	void ProcessNextIndependentEntity(float time_interval, int bSkipFlagged, int iCaller);
 	void ProcessBreakingEntities(float time_interval);
 	void ThreadProc(int ithread, SPhysTask *pTask);
+	void ProcessThreadTask(int ithread);
+	// p_job_system_step: thread tasks are spread over JobManager jobs instead of the physics worker threads
+	void StartStepJobs();
+	void FinishStepJobs();
+	void ProcessStepJob(int ilane);
+	int EstimateStepTaskCost(int ipass, int maxCost);
+	int GetNumStepWorkers() const { return m_nWorkerThreads+m_nStepJobs; }
 
 	template<class T> void ReallocQueue(T *&pqueue, int sz,int &szAlloc, int &head,int &tail, int nGrow) {
 		if (sz==szAlloc) {
@@ -803,6 +841,8 @@ public:
 	int m_nGroups;
 	float m_maxGroupMass;
 	volatile int m_nWorkerThreads;
+	volatile int m_nStepJobs; // jobs running the current thread task in p_job_system_step mode, they act as workers
+	JobManager::SJobState m_stepJobState;
 	volatile int m_iCurGroup;
 	volatile CPhysicalEntity *m_pCurEnt;
 	volatile CPhysicalEntity *m_pMovedEnts;
@@ -1512,7 +1512,7 @@ int CRigidEntity::CheckForNewContacts(geom_world_data *pgwd0,intersection_params
 					this,pentlist[ient],i,j);
 				#if MAX_PHYS_THREADS>1
 				if ((ncontacts & ~-bSameGroup & -pentlist[ient]->m_iSimClass>>31) && 
-						((CRigidEntity*)pentlist[ient])->m_body.M>0 && m_pWorld->m_nWorkerThreads>1) 
+						((CRigidEntity*)pentlist[ient])->m_body.M>0 && m_pWorld->GetNumStepWorkers()>1) 
 				{	
 					if (pentlist[ient]->m_iGroup>=0 && m_pWorld->m_pGroupNums[pentlist[ient]->m_iGroup] < m_pWorld->m_pGroupNums[m_iGroup]) {
 						wait_for_ent(pentlist[ient]); 
@@ -122,24 +122,12 @@ struct entity_grid_checker {
 		ZeroStruct(thunkSubst);
 	}
 
-	NO_INLINE int check_cell(const Vec2i &icell, int &ilastcell) {
-
-		const float fCellX =(float)(icell.x);
-		const float fCellY = (float)(icell.y);
-		Vec2 fcell(fCellX, fCellY);
-		quotientf t((org2d+fcell)*dir2d, dir2d_len*dir2d_len);
-		if (t.x>maxt && (icell.x&icell.y)!=-1)
-			return 1;		
+	// physics on demand: creates the entities of the cell if the ray crosses it (has to be called with m_lockGrid read-locked)
+	void check_POD_cell(const Vec2i &icell) {
 		box bbox;
 		bbox.Basis.SetIdentity();
 		bbox.bOriented = 0;
-		geom_contact *pcontacts = 0;
-    geom_world_data *dummy = NULL;
-		pe_gridthunk *pthunk;
-		int ithunk,ithunk_next;
 		pe_PODcell *pPODcell;
-    IGeometry *pGeom = NULL; 
-		int i,j,ihit,imat,nCellEnts=0,nEntsChecked=0,bRecheckOtherParts,bNoThunkSubst;
 		pWorld->GetPODGridCellBBox(icell.x,icell.y, bbox.center,bbox.size);
 		if (bUsePhysOnDemand && (bbox.size.z>0.f) && box_ray_overlap_check(&bbox,&aray.m_ray)) {
 			AtomicAdd(&pWorld->m_lockGrid,-1);
@@ -164,21 +152,34 @@ struct entity_grid_checker {
 			UnmarkAsPODThread(pWorld);
 			ReadLockCond relock(pWorld->m_lockGrid,1); relock.SetActive(0);
 		}
+	}
+
+	NO_INLINE int check_cell(const Vec2i &icell, int &ilastcell) {
+
+		const float fCellX =(float)(icell.x);
+		const float fCellY = (float)(icell.y);
+		Vec2 fcell(fCellX, fCellY);
+		quotientf t((org2d+fcell)*dir2d, dir2d_len*dir2d_len);
+		if (t.x>maxt && (icell.x&icell.y)!=-1)
+			return 1;		
+		box bbox;
+		bbox.Basis.SetIdentity();
+		bbox.bOriented = 0;
+		pe_gridthunk *pthunk;
+		int ithunk,ithunk_next,bNoThunkSubst;
+		check_POD_cell(icell);
 		//fetch some memory references to avoid reloads
 		primitives::grid& RESTRICT_REFERENCE entgrid = pWorld->m_entgrid;
 		const Vec3 entgrid_origin			= entgrid.origin;
 		const int icellX = icell.x, icellY = icell.y;
 		const Vec2 entgrid_step	= entgrid.step;
-		const Vec2 entgrid_stepr	= entgrid.stepr;
 		pe_entgrid pEntGrid = pWorld->m_pEntGrid;
 		pe_gridthunk *const __restrict pgthunks = pWorld->m_gthunks;
 		const int gridIdx = entgrid.getcell_safe(icellX,icellY);
 		const float pWorld_m_zGran = pWorld->m_zGran;
-		const int pWorld_m_matWater = pWorld->m_matWater;
     /*const uint32 simClass[] = {1<<0,1<<1,1<<2,1<<3,1<<4,1<<5,1<<6,1<<7,1<<8,1<<9};*/
 
 		GET_GRID_AXIS(iEntAxisx, iEntAxisy, iEntAxisz, pWorld);
-		int ithunk_prev = 0;
 		pthunk = pgthunks+(ithunk = pEntGrid[gridIdx]);
 		bNoThunkSubst = iszero_mask(pThunkSubst);
 		pthunk = (pe_gridthunk*)((intptr_t)pthunk + ((intptr_t)pThunkSubst-(intptr_t)pthunk & ~bNoThunkSubst));
@@ -187,7 +188,6 @@ struct entity_grid_checker {
       const pe_gridthunk& thunk = *pthunk;
       
 			ithunk_next = thunk.inext;
-			ithunk_prev = ithunk;
 			PrefetchLine(thunk.pent, 0);	//We tend to L2 cache miss on access to thunk.iSimClass anyway, so this prefetch will actually help - Rich S
 
 			if ((objtypes & 1<<thunk.iSimClass)
@@ -211,96 +211,8 @@ struct entity_grid_checker {
 							 bbox.size[iEntAxisz] = (fBBoxZ1-fBBoxZ0)*0.5f*pWorld_m_zGran,
 							 box_ray_overlap_check(&bbox,&aray.m_ray)))
 				{
-					ReadLock lock(thunk.pent->m_lockUpdate);
-					bbox.center = (thunk.pent->m_BBox[0]+thunk.pent->m_BBox[1])*0.5f;
-					bbox.size = (thunk.pent->m_BBox[1]-thunk.pent->m_BBox[0])*0.5f;
-					nCellEnts++;
-
-					/*if ((bbox.center-aray.m_ray.origin-aray.m_dirn*((bbox.center-aray.m_ray.origin)*aray.m_dirn)).len2() > bbox.size.len2())
-					continue; // skip objects that lie to far from the ray
-					if ((box_ray_overlap_check(&bbox,&aray.m_ray) & nEnts-pWorld->m_nEnts>>31)==0)
-					continue;*/
-					if (nEnts>=szList)
-						szList = pWorld->ReallocTmpEntList(pTmpEntList,iCaller,szList+1024); 
-					nEntsChecked++;	
-					CPhysicalEntity *pent,*pentLog,*pentFlags,*pentList;
-					bCallbackUsed=bRecheckOtherParts = 0;
-
-					if (thunk.pent->m_iSimClass==5) {
-						if (((CPhysArea*)thunk.pent)->m_pb.iMedium!=0)
-							continue;
-						ray_hit ahit;
-						CPhysArea	*pPhysArea = (CPhysArea*)thunk.pent;
-						if (pPhysArea->RayTrace(aray.m_ray.origin,aray.m_ray.dir,&ahit)) {
-							pcontacts = g_RWIContacts;
-							pentFlags = &g_StaticPhysicalEntity;
-							pentFlags->m_parts[0].flags = geom_colltype_ray & -iszero((int)flags & rwi_force_pierceable_noncoll);
-							pcontacts->t = ahit.dist;
-							pcontacts->pt = ahit.pt; 
-							pcontacts->n = ahit.n;
-							pcontacts->id[0] = pWorld_m_matWater;
-							pcontacts->iNode[0] = -1;
-							pentList = pent = (CPhysicalEntity*)(pGridEnt = thunk.pent);
-							i=0; j=1; nParts=0; pentLog=0; goto gotcontacts;
-						}
-						continue;
-					}
-
-					//This is causing a load hit store on the branch two lines down. Safe to remove? Suspect not due to GetEntity() doing phys on demand and causing a reposition
-					//	call that could set m_bGridThunksChanged. Damn. Could it be set earlier...?
-					pWorld->m_bGridThunksChanged = 0;	
-					pentList = pentLog = pentFlags = pent = (pGridEnt=thunk.pent)->GetEntity();
-					if (pWorld->m_bGridThunksChanged) 
-						ithunk_next=pEntGrid[gridIdx], ithunk_prev=0;
-					pWorld->m_bGridThunksChanged = 0;
-					IF (pent->m_iDeletionTime, 0)
-						continue;
-					
-					if (IgnoreCollision(pent->m_collisionClass, collclass))
-						continue;
-
-					if ((nParts=pent->m_nParts)==0 || pent->m_flags&pef_use_geom_callbacks) {
-						SRayTraceRes rtr(&aray,pcontacts);
-						j = pent->RayTrace(rtr);
-						pcontacts = rtr.pcontacts;
-						i=0; bCallbackUsed=1; goto gotcontacts;
-					}
-
-					if (pent!=pGridEnt && pent->m_pEntBuddy!=pGridEnt) {
-						iPartSubst_inFlight = 
-							ipartSubst = -2-pGridEnt->m_id; ipartMask = -1;	nParts = 1;
-						pentList = (CPhysicalEntity*)pGridEnt;
-					}
-
-					for(i=ipartSubst; i<nParts+(ipartSubst+1-nParts & ipartMask); i++) {
-						if ((pent->m_parts[i].flags & flagsColliderAll)==flagsColliderAll && (pent->m_parts[i].flags & flagsColliderAny)) {
-							if (nParts>1) {
-								bbox.center = (pent->m_parts[i].BBox[0]+pent->m_parts[i].BBox[1])*0.5f;
-								bbox.size = (pent->m_parts[i].BBox[1]-pent->m_parts[i].BBox[0])*0.5f;
-								if (!box_ray_overlap_check(&bbox,&aray.m_ray))
-									continue;
-							}
-							gwd.offset = pent->m_pos + pent->m_qrot*pent->m_parts[i].pos;
-							//(pent->m_qrot*pent->m_parts[i].q).getmatrix(gwd.R);	//Q2M_IVO 
-							gwd.R = Matrix33(pent->m_qrot*pent->m_parts[i].q);
-							gwd.scale = pent->m_parts[i].scale;
-
-							pGeom = PrepGeom(pent->m_parts[i].pPhysGeom->pGeom,iCaller);
-							j = pGeom->Intersect(&aray, &gwd, dummy, &ip, pcontacts);
-
-gotcontacts:
-							bRecheckOtherParts = (j-1 & 1-nParts)>>31 & ipartMask;
-
-							check_cell_contact(j,pcontacts,phits,flags,pentFlags,nThroughHits,nThroughHitsAux, imat,ilastcell,aray,iSolidNode,pentLog,i,ihit);
-						}	else 
-							if (pent->m_parts[i].flags & geom_mat_substitutor && phits[0].pCollider && ((CPhysicalPlaceholder*)phits[0].pCollider)->m_id==-1 &&
-									pent->m_parts[i].pPhysGeom->pGeom->PointInsideStatus(((phits[0].pt-pent->m_pos)*pent->m_qrot-pent->m_parts[i].pos)*pent->m_parts[i].q)) 
-								phits[0].surface_idx = pent->GetMatId(pent->m_parts[i].pPhysGeom->surface_idx, i);
-					}
-
-					pTmpEntList[nEnts] = pentList; nEnts += 1+bRecheckOtherParts;
-					AtomicAdd(&pGridEnt->m_bProcessed, 1+bRecheckOtherParts<<iCaller);
-					iPartSubst_inFlight = ipartMask = ipartSubst = 0;
+					if (check_ent(thunk.pent,ilastcell))
+						ithunk_next = pEntGrid[gridIdx];
 
 					/*next_cell_ent:
 					if (thunk.iSimClass==6 && thunk.pent->m_iForeignFlags==0x100) {
@@ -315,6 +227,106 @@ gotcontacts:
 		return iszero((icell.y<<16|icell.x&0xFFFF)-ilastcell);
 	}
 
+	// traces the ray against the grid entity that passed the cell's bounding box test
+	// returns 1 if the entity grid thunks changed while getting the entity (the cell's list has to be restarted)
+	int check_ent(CPhysicalPlaceholder *pGridPent, int &ilastcell) {
+		box bbox;
+		bbox.Basis.SetIdentity();
+		bbox.bOriented = 0;
+		geom_contact *pcontacts = 0;
+    geom_world_data *dummy = NULL;
+    IGeometry *pGeom = NULL; 
+		int i,j,ihit,imat,bRecheckOtherParts,bThunksChanged=0;
+		ReadLock lock(pGridPent->m_lockUpdate);
+		bbox.center = (pGridPent->m_BBox[0]+pGridPent->m_BBox[1])*0.5f;
+		bbox.size = (pGridPent->m_BBox[1]-pGridPent->m_BBox[0])*0.5f;
+
+		/*if ((bbox.center-aray.m_ray.origin-aray.m_dirn*((bbox.center-aray.m_ray.origin)*aray.m_dirn)).len2() > bbox.size.len2())
+		continue; // skip objects that lie to far from the ray
+		if ((box_ray_overlap_check(&bbox,&aray.m_ray) & nEnts-pWorld->m_nEnts>>31)==0)
+		continue;*/
+		if (nEnts>=szList)
+			szList = pWorld->ReallocTmpEntList(pTmpEntList,iCaller,szList+1024); 
+		CPhysicalEntity *pent,*pentLog,*pentFlags,*pentList;
+		bCallbackUsed=bRecheckOtherParts = 0;
+
+		if (pGridPent->m_iSimClass==5) {
+			if (((CPhysArea*)pGridPent)->m_pb.iMedium!=0)
+				return 0;
+			ray_hit ahit;
+			CPhysArea	*pPhysArea = (CPhysArea*)pGridPent;
+			if (pPhysArea->RayTrace(aray.m_ray.origin,aray.m_ray.dir,&ahit)) {
+				pcontacts = g_RWIContacts;
+				pentFlags = &g_StaticPhysicalEntity;
+				pentFlags->m_parts[0].flags = geom_colltype_ray & -iszero((int)flags & rwi_force_pierceable_noncoll);
+				pcontacts->t = ahit.dist;
+				pcontacts->pt = ahit.pt; 
+				pcontacts->n = ahit.n;
+				pcontacts->id[0] = pWorld->m_matWater;
+				pcontacts->iNode[0] = -1;
+				pentList = pent = (CPhysicalEntity*)(pGridEnt = pGridPent);
+				i=0; j=1; nParts=0; pentLog=0; goto gotcontacts;
+			}
+			return 0;
+		}
+
+		//This is causing a load hit store on the branch two lines down. Safe to remove? Suspect not due to GetEntity() doing phys on demand and causing a reposition
+		//	call that could set m_bGridThunksChanged. Damn. Could it be set earlier...?
+		pWorld->m_bGridThunksChanged = 0;	
+		pentList = pentLog = pentFlags = pent = (pGridEnt=pGridPent)->GetEntity();
+		bThunksChanged = pWorld->m_bGridThunksChanged;
+		pWorld->m_bGridThunksChanged = 0;
+		IF (pent->m_iDeletionTime, 0)
+			return bThunksChanged;
+		
+		if (IgnoreCollision(pent->m_collisionClass, collclass))
+			return bThunksChanged;
+
+		if ((nParts=pent->m_nParts)==0 || pent->m_flags&pef_use_geom_callbacks) {
+			SRayTraceRes rtr(&aray,pcontacts);
+			j = pent->RayTrace(rtr);
+			pcontacts = rtr.pcontacts;
+			i=0; bCallbackUsed=1; goto gotcontacts;
+		}
+
+		if (pent!=pGridEnt && pent->m_pEntBuddy!=pGridEnt) {
+			iPartSubst_inFlight = 
+				ipartSubst = -2-pGridEnt->m_id; ipartMask = -1;	nParts = 1;
+			pentList = (CPhysicalEntity*)pGridEnt;
+		}
+
+		for(i=ipartSubst; i<nParts+(ipartSubst+1-nParts & ipartMask); i++) {
+			if ((pent->m_parts[i].flags & flagsColliderAll)==flagsColliderAll && (pent->m_parts[i].flags & flagsColliderAny)) {
+				if (nParts>1) {
+					bbox.center = (pent->m_parts[i].BBox[0]+pent->m_parts[i].BBox[1])*0.5f;
+					bbox.size = (pent->m_parts[i].BBox[1]-pent->m_parts[i].BBox[0])*0.5f;
+					if (!box_ray_overlap_check(&bbox,&aray.m_ray))
+						continue;
+				}
+				gwd.offset = pent->m_pos + pent->m_qrot*pent->m_parts[i].pos;
+				//(pent->m_qrot*pent->m_parts[i].q).getmatrix(gwd.R);	//Q2M_IVO 
+				gwd.R = Matrix33(pent->m_qrot*pent->m_parts[i].q);
+				gwd.scale = pent->m_parts[i].scale;
+
+				pGeom = PrepGeom(pent->m_parts[i].pPhysGeom->pGeom,iCaller);
+				j = pGeom->Intersect(&aray, &gwd, dummy, &ip, pcontacts);
+
+gotcontacts:
+				bRecheckOtherParts = (j-1 & 1-nParts)>>31 & ipartMask;
+
+				check_cell_contact(j,pcontacts,phits,flags,pentFlags,nThroughHits,nThroughHitsAux, imat,ilastcell,aray,iSolidNode,pentLog,i,ihit);
+			}	else 
+				if (pent->m_parts[i].flags & geom_mat_substitutor && phits[0].pCollider && ((CPhysicalPlaceholder*)phits[0].pCollider)->m_id==-1 &&
+						pent->m_parts[i].pPhysGeom->pGeom->PointInsideStatus(((phits[0].pt-pent->m_pos)*pent->m_qrot-pent->m_parts[i].pos)*pent->m_parts[i].q)) 
+					phits[0].surface_idx = pent->GetMatId(pent->m_parts[i].pPhysGeom->surface_idx, i);
+		}
+
+		pTmpEntList[nEnts] = pentList; nEnts += 1+bRecheckOtherParts;
+		AtomicAdd(&pGridEnt->m_bProcessed, 1+bRecheckOtherParts<<iCaller);
+		iPartSubst_inFlight = ipartMask = ipartSubst = 0;
+		return bThunksChanged;
+	}
+
 	ILINE void check_cell_contact(int& j,geom_contact *&pcontacts, ray_hit *phits, unsigned int flags,
 		CPhysicalEntity *pentFlags,int& nThroughHits, int& nThroughHitsAux, int& imat, int &ilastcell,CRayGeom& aray,
 		int& iSolidNode, CPhysicalEntity *pentLog,int i, int& ihit)
@@ -506,9 +518,8 @@ int CPhysicalWorld::RayWorldIntersection(const IPhysicalWorld::SRWIParams &rp, c
 	} 
 
 	PHYS_FUNC_PROFILER( pNameTag );
-	int i,nHits; for(i=0;i<rp.nMaxHits;i++) { hits[i].dist=1E10; hits[i].bTerrain=0; hits[i].pCollider=0; }
+	int i,nHits;
 	entity_grid_checker egc;
-	egc.nThroughHits = egc.nThroughHitsAux = 0;
 	CPhysicalEntity *pentLastHit = 0;
 	int ipartLastHit,inodeLastHit;
 	IF (rp.phitLast, 0) {
@@ -520,6 +531,63 @@ int CPhysicalWorld::RayWorldIntersection(const IPhysicalWorld::SRWIParams &rp, c
 	assert(iCaller<=MAX_PHYS_THREADS);
 	WriteLockCond lock(m_lockCaller[iCaller], iCaller==MAX_PHYS_THREADS);
 
+	IF (RayPrepare(rp,dir,egc,iCaller), 1) {
+		MarkSkipEnts(rp.pSkipEnts,rp.nSkipEnts,1<<iCaller);
+		Vec3 origin_grid = (rp.org-m_entgrid.origin).GetPermutated(m_iEntAxisz), dir_grid = dir.GetPermutated(m_iEntAxisz);
+
+		if (pentLastHit) {
+			egc.maxt = 1E20f;
+			egc.thunkSubst.inext = 0;
+			egc.thunkSubst.pent = pentLastHit;
+			egc.thunkSubst.iSimClass = pentLastHit->m_iSimClass;
+			egc.pThunkSubst = &egc.thunkSubst;
+			egc.iPartSubst_initial = egc.ipartSubst = ipartLastHit; egc.ipartMask = -1;
+			egc.gwd.iStartNode = inodeLastHit;
+			egc.check_cell(Vec2i(0,0),i);
+			if (rp.hits[0].dist>0) {
+				dir=egc.aray.m_ray.dir = hits[0].pt-egc.aray.m_ray.origin;
+				dir_grid = dir.GetPermutated(m_iEntAxisz);
+				egc.dir2d.set(dir_grid.x*m_entgrid.stepr.x, dir_grid.y*m_entgrid.stepr.y);
+				egc.dir2d_len = len(egc.dir2d);
+			}
+			egc.pThunkSubst=0; egc.ipartSubst=egc.ipartMask=0; egc.gwd.iStartNode=0;
+		}
+		egc.maxt = egc.dir2d_len*(egc.dir2d_len+sqrt2)+0.0001f;
+
+		{
+		ReadLock lockg(m_lockGrid);
+			IF (RayOutOfGridBounds(origin_grid,dir_grid), 0)
+				egc.check_cell(Vec2i(-1,-1),i);
+
+			DrawRayOnGrid(&m_entgrid, origin_grid,dir_grid, egc);
+		}
+
+		RayFinishGrid(rp,egc,iCaller);
+	}
+
+	int nTicks=0;
+#ifndef PHYS_FUNC_PROFILER_DISABLED
+	if (m_vars.iDrawHelpers & 64)
+		nTicks = CryGetTicks()-func_profiler.m_iStartTime;
+#endif
+	nHits = RayCollectHits(rp,dir,egc,nTicks,iCaller, pentLastHit,ipartLastHit,inodeLastHit);
+
+	if (rp.phitLast && rp.flags & rwi_update_last_hit) {
+		rp.phitLast->pCollider = pentLastHit;
+		rp.phitLast->ipart = ipartLastHit;
+		rp.phitLast->iNode = inodeLastHit;
+	}
+
+	return nHits;
+}
+
+int CPhysicalWorld::RayPrepare(const SRWIParams &rp, Vec3 &dir, entity_grid_checker &egc, int iCaller)
+{
+	ray_hit *hits = rp.hits;
+	int i,objtypes = rp.objtypes;
+	for(i=0;i<rp.nMaxHits;i++) { hits[i].dist=1E10; hits[i].bTerrain=0; hits[i].pCollider=0; }
+	egc.nThroughHits = egc.nThroughHitsAux = 0;
+
 	if ((objtypes & ent_terrain) && m_pHeightfield[iCaller]) {
     RayHeightfield(rp.org,dir,rp.hits,rp.flags,iCaller);
   }
@@ -531,8 +599,6 @@ int CPhysicalWorld::RayWorldIntersection(const IPhysicalWorld::SRWIParams &rp, c
 	}
 
 	IF (objtypes & ~(ent_terrain|ent_water), 1) {
-		MarkSkipEnts(rp.pSkipEnts,rp.nSkipEnts,1<<iCaller);
-
 		egc.phits = rp.hits;
 		egc.pWorld = this;
 		egc.objtypes = objtypes;
@@ -563,64 +629,52 @@ int CPhysicalWorld::RayWorldIntersection(const IPhysicalWorld::SRWIParams &rp, c
 		egc.dir2d.set(dir_grid.x*m_entgrid.stepr.x, dir_grid.y*m_entgrid.stepr.y);
 		egc.dir2d_len = len(egc.dir2d);
 		egc.nEnts = 0;   
+		return 1;
+	}
+	return 0;
+}
 
-		if (pentLastHit) {
-			egc.maxt = 1E20f;
-			egc.thunkSubst.inext = 0;
-			egc.thunkSubst.pent = pentLastHit;
-			egc.thunkSubst.iSimClass = pentLastHit->m_iSimClass;
-			egc.pThunkSubst = &egc.thunkSubst;
-			egc.iPartSubst_initial = egc.ipartSubst = ipartLastHit; egc.ipartMask = -1;
-			egc.gwd.iStartNode = inodeLastHit;
-			egc.check_cell(Vec2i(0,0),i);
-			if (rp.hits[0].dist>0) {
-				dir=egc.aray.m_ray.dir = hits[0].pt-egc.aray.m_ray.origin;
-				dir_grid = dir.GetPermutated(m_iEntAxisz);
-				egc.dir2d.set(dir_grid.x*m_entgrid.stepr.x, dir_grid.y*m_entgrid.stepr.y);
-				egc.dir2d_len = len(egc.dir2d);
-			}
-			egc.pThunkSubst=0; egc.ipartSubst=egc.ipartMask=0; egc.gwd.iStartNode=0;
-		}
-		egc.maxt = egc.dir2d_len*(egc.dir2d_len+sqrt2)+0.0001f;
-
-		{
-		ReadLock lockg(m_lockGrid);
-	  const int checkOutOfBoundsCell = m_vars.iOutOfBounds & raycast_out_of_bounds;
-		  IF (checkOutOfBoundsCell, 0) {
-				if (fabsf(origin_grid.x*m_entgrid.stepr.x*2-m_entgrid.size.x)>m_entgrid.size.x || 
-						fabsf(origin_grid.y*m_entgrid.stepr.y*2-m_entgrid.size.y)>m_entgrid.size.y || 
-						fabsf((origin_grid.x+dir_grid.x)*m_entgrid.stepr.x*2-m_entgrid.size.x)>m_entgrid.size.x || 
-						fabsf((origin_grid.y+dir_grid.y)*m_entgrid.stepr.y*2-m_entgrid.size.y)>m_entgrid.size.y)
-					egc.check_cell(Vec2i(-1,-1),i);
-			}
-
-			DrawRayOnGrid(&m_entgrid, origin_grid,dir_grid, egc);
-		}
+int CPhysicalWorld::RayOutOfGridBounds(const Vec3 &origin_grid, const Vec3 &dir_grid)
+{
+	return m_vars.iOutOfBounds & raycast_out_of_bounds && 
+		(fabsf(origin_grid.x*m_entgrid.stepr.x*2-m_entgrid.size.x)>m_entgrid.size.x || 
+		 fabsf(origin_grid.y*m_entgrid.stepr.y*2-m_entgrid.size.y)>m_entgrid.size.y || 
+		 fabsf((origin_grid.x+dir_grid.x)*m_entgrid.stepr.x*2-m_entgrid.size.x)>m_entgrid.size.x || 
+		 fabsf((origin_grid.y+dir_grid.y)*m_entgrid.stepr.y*2-m_entgrid.size.y)>m_entgrid.size.y);
+}
 
-		for(i=0;i<egc.nEnts;i++)
-			AtomicAdd(&(egc.pTmpEntList[i]->m_pEntBuddy && egc.pTmpEntList[i]->m_pEntBuddy==egc.pTmpEntList[i] ?
+void CPhysicalWorld::RayFinishGrid(const SRWIParams &rp, entity_grid_checker &egc, int iCaller)
+{
+	ray_hit *hits = rp.hits;
+	int i;
+	for(i=0;i<egc.nEnts;i++)
+		AtomicAdd(&(egc.pTmpEntList[i]->m_pEntBuddy && egc.pTmpEntList[i]->m_pEntBuddy==egc.pTmpEntList[i] ?
 								egc.pTmpEntList[i]->m_pEntBuddy : egc.pTmpEntList[i])->m_bProcessed, -(1<<iCaller));
-		
-		UnmarkSkipEnts(rp.pSkipEnts,rp.nSkipEnts,1<<iCaller);
-
-		if (rp.flags & rwi_separate_important_hits) {
-			int j,idx[2]; ray_hit thit;
-			for(idx[0]=1,idx[1]=rp.nMaxHits-1,i=1; idx[0]+rp.nMaxHits-idx[1]-2<egc.nThroughHits+egc.nThroughHitsAux; i++) {
-				j = isneg(hits[idx[1]].dist-hits[idx[0]].dist);	// j = hits[1].dist<hits[0].dist ? 1:0;
-				j |= isneg(egc.nThroughHits-idx[0]);						// if (idx[0]>nThroughHits) j = 1; 
-				j &= rp.nMaxHits-egc.nThroughHitsAux-1-idx[1]>>31; // if (idx[1]<=nMaxHits-nThroughHits1-1) j=0;	
-				hits[idx[j]].bTerrain = i;
-				idx[j] += 1-j*2;
-			}
-			for(i=egc.nThroughHits+1; i<rp.nMaxHits-egc.nThroughHitsAux; i++)
-				hits[i].bTerrain = rp.nMaxHits+1;
-			for(i=1;i<rp.nMaxHits;) if (hits[i].bTerrain!=i && hits[i].bTerrain<rp.nMaxHits) {
-				thit=hits[hits[i].bTerrain]; hits[hits[i].bTerrain]=hits[i]; hits[i]=thit;
-			}	else i++;
+	
+	UnmarkSkipEnts(rp.pSkipEnts,rp.nSkipEnts,1<<iCaller);
+
+	if (rp.flags & rwi_separate_important_hits) {
+		int j,idx[2]; ray_hit thit;
+		for(idx[0]=1,idx[1]=rp.nMaxHits-1,i=1; idx[0]+rp.nMaxHits-idx[1]-2<egc.nThroughHits+egc.nThroughHitsAux; i++) {
+			j = isneg(hits[idx[1]].dist-hits[idx[0]].dist);	// j = hits[1].dist<hits[0].dist ? 1:0;
+			j |= isneg(egc.nThroughHits-idx[0]);						// if (idx[0]>nThroughHits) j = 1; 
+			j &= rp.nMaxHits-egc.nThroughHitsAux-1-idx[1]>>31; // if (idx[1]<=nMaxHits-nThroughHits1-1) j=0;	
+			hits[idx[j]].bTerrain = i;
+			idx[j] += 1-j*2;
 		}
+		for(i=egc.nThroughHits+1; i<rp.nMaxHits-egc.nThroughHitsAux; i++)
+			hits[i].bTerrain = rp.nMaxHits+1;
+		for(i=1;i<rp.nMaxHits;) if (hits[i].bTerrain!=i && hits[i].bTerrain<rp.nMaxHits) {
+			thit=hits[hits[i].bTerrain]; hits[hits[i].bTerrain]=hits[i]; hits[i]=thit;
+		}	else i++;
 	}
+}
 
-	nHits = 0;
+int CPhysicalWorld::RayCollectHits(const SRWIParams &rp, const Vec3 &dir, entity_grid_checker &egc, int nTicks, int iCaller,
+	CPhysicalEntity *&pentLastHit,int &ipartLastHit,int &inodeLastHit)
+{
+	ray_hit *hits = rp.hits;
+	int i,nHits = 0;
 	if (hits[0].dist>1E9f) {
 		hits[0].dist = -1;
 		hits[0].pt = rp.org+dir;
@@ -638,10 +692,6 @@ int CPhysicalWorld::RayWorldIntersection(const IPhysicalWorld::SRWIParams &rp, c
 		nHits++;
 	}
 	if (m_vars.iDrawHelpers & 64 && m_pRenderer) {
-		int nTicks=0;
-#ifndef PHYS_FUNC_PROFILER_DISABLED
-		nTicks = CryGetTicks()-func_profiler.m_iStartTime;
-#endif
 		int bQueued = iszero(m_lockTPR>>16^1 | iCaller);
 		m_pRenderer->DrawLine(rp.org,hits[0].pt,8-bQueued,1|nTicks*2);
 	}
@@ -659,16 +709,251 @@ int CPhysicalWorld::RayWorldIntersection(const IPhysicalWorld::SRWIParams &rp, c
 			hits[i].bTerrain=0; nHits++; 
 		}
 	}
+	return nHits;
+}
+
+struct SRwiBatchKey {
+	uint64 key;
+	int iray;
+	int ihit;	// where the hits of the ray start
+	bool operator<(const SRwiBatchKey &op) const { return key<op.key; }
+};
+
+ILINE uint32 SpreadBits16(uint32 x)
+{
+	x &= 0xFFFF;
+	x = (x | x<<8) & 0x00FF00FF;
+	x = (x | x<<4) & 0x0F0F0F0F;
+	x = (x | x<<2) & 0x33333333;
+	x = (x | x<<1) & 0x55555555;
+	return x;
+}
+
+// records the cells a packet ray walks without checking entities; physics on demand entities are created later,
+// when the ray is traced through the cell, so that nothing is created past its first hit
+struct entity_cell_collector {
+	entity_grid_checker *pegc;
+	std::vector<int> *pcells;
+	int ilastcell;
+
+	int check_cell(const Vec2i &icell, int &ilastcellWalk) {
+		quotientf t((pegc->org2d+Vec2((float)icell.x,(float)icell.y))*pegc->dir2d, pegc->dir2d_len*pegc->dir2d_len);
+		if (t.x>pegc->maxt && (icell.x&icell.y)!=-1)
+			return 1;
+		pcells->push_back(icell.y<<16|icell.x&0xFFFF);
+		ilastcell = ilastcellWalk;
+		return 0;
+	}
+};
+
+// clips the segments org+dir*[0,1] of the packet rays with the box, returns the mask of the rays that cross it
+ILINE int RayPacketBoxOverlap(const float *org, const float *dirInv, const Vec3 &bmin,const Vec3 &bmax, float *tenter)
+{
+#if CRY_PLATFORM_SSE2
+	__m128 t0,t1, tmin=_mm_setzero_ps(), tmax=_mm_set1_ps(1.0f);
+	for(int i=0;i<3;i++) {
+		const __m128 o=_mm_loadu_ps(org+i*RWI_PACKET_SIZE), dinv=_mm_loadu_ps(dirInv+i*RWI_PACKET_SIZE);
+		t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bmin[i]),o),dinv);
+		t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bmax[i]),o),dinv);
+		tmin = _mm_max_ps(tmin,_mm_min_ps(t0,t1));
+		tmax = _mm_min_ps(tmax,_mm_max_ps(t0,t1));
+	}
+	_mm_storeu_ps(tenter, tmin);
+	return _mm_movemask_ps(_mm_cmple_ps(tmin,tmax));
+#else
+	int i,ilane,mask=0;
+	for(ilane=0;ilane<RWI_PACKET_SIZE;ilane++) {
+		float t0,t1,tmin=0,tmax=1;
+		for(i=0;i<3;i++) {
+			t0 = (bmin[i]-org[i*RWI_PACKET_SIZE+ilane])*dirInv[i*RWI_PACKET_SIZE+ilane];
+			t1 = (bmax[i]-org[i*RWI_PACKET_SIZE+ilane])*dirInv[i*RWI_PACKET_SIZE+ilane];
+			tmin = max(tmin,min(t0,t1)); tmax = min(tmax,max(t0,t1));
+		}
+		tenter[ilane] = tmin;
+		mask |= (isneg(tmax-tmin)^1)<<ilane;
+	}
+	return mask;
+#endif
+}
 
-	if (rp.phitLast && rp.flags & rwi_update_last_hit) {
-		rp.phitLast->pCollider = pentLastHit;
-		rp.phitLast->ipart = ipartLastHit;
-		rp.phitLast->iNode = inodeLastHit;
+int CPhysicalWorld::RayWorldIntersectionPacket(const SRWIParams *pRays, const int *pRayIdx, const int *pHitOffsets, int nRays, ray_hit *pHits, int *pNumHits, int iCaller)
+{
+	entity_grid_checker egc[RWI_PACKET_SIZE];
+	SRWIParams rp[RWI_PACKET_SIZE];
+	Vec3 dir[RWI_PACKET_SIZE];
+	int i,j,ilane,bWalk[RWI_PACKET_SIZE],bOutOfBounds[RWI_PACKET_SIZE],ilastcell[RWI_PACKET_SIZE],nHitsTotal=0;
+	float org[3*RWI_PACKET_SIZE],dirInv[3*RWI_PACKET_SIZE];
+	CPhysicalEntity *pentLastHit; int ipartLastHit,inodeLastHit;
+	GET_GRID_AXIS(iEntAxisx, iEntAxisy, iEntAxisz, this);
+
+	assert(iCaller<=MAX_PHYS_THREADS);
+	WriteLockCond lock(m_lockCaller[iCaller], iCaller==MAX_PHYS_THREADS);
+	if (!m_threadData[iCaller].pRwiPacketBuf)
+		m_threadData[iCaller].pRwiPacketBuf = new SRwiPacketBuffers;
+	SRwiPacketBuffers &buf = *m_threadData[iCaller].pRwiPacketBuf;
+
+	for(ilane=0;ilane<RWI_PACKET_SIZE;ilane++) {
+		bWalk[ilane]=bOutOfBounds[ilane]=0; ilastcell[ilane]=-1;
+		for(i=0;i<3;i++) org[i*RWI_PACKET_SIZE+ilane]=1E10f, dirInv[i*RWI_PACKET_SIZE+ilane]=1.0f;
+		buf.cells[ilane].clear();
+		if (ilane>=nRays)
+			continue;
+		rp[ilane] = pRays[pRayIdx[ilane]];
+		rp[ilane].hits = pHits+pHitOffsets[ilane];
+		dir[ilane] = rp[ilane].dir;
+		if (!(bWalk[ilane] = RayPrepare(rp[ilane],dir[ilane],egc[ilane],iCaller)))
+			continue;
+		egc[ilane].maxt = egc[ilane].dir2d_len*(egc[ilane].dir2d_len+sqrt2)+0.0001f;
+		for(i=0;i<3;i++) {
+			org[i*RWI_PACKET_SIZE+ilane] = egc[ilane].aray.m_ray.origin[i];
+			dirInv[i*RWI_PACKET_SIZE+ilane] = fabs_tpl(egc[ilane].aray.m_ray.dir[i])>1E-20f ? 1.0f/egc[ilane].aray.m_ray.dir[i] : 1E30f;
+		}
 	}
 
-	return nHits;
+	{ ReadLock lockg(m_lockGrid);
+		// walk the grid with each ray, only collecting the cells
+		buf.sorted.clear();
+		for(ilane=0;ilane<nRays;ilane++) if (bWalk[ilane]) {
+			Vec3 origin_grid = (rp[ilane].org-m_entgrid.origin).GetPermutated(m_iEntAxisz), dir_grid = dir[ilane].GetPermutated(m_iEntAxisz);
+			entity_cell_collector ecc;
+			ecc.pegc = egc+ilane; ecc.pcells = buf.cells+ilane; ecc.ilastcell = -1;
+			bOutOfBounds[ilane] = RayOutOfGridBounds(origin_grid,dir_grid);
+			IF (bOutOfBounds[ilane], 0)
+				buf.cells[ilane].push_back(-1);
+			DrawRayOnGrid(&m_entgrid, origin_grid,dir_grid, ecc);
+			ilastcell[ilane] = ecc.ilastcell;
+			buf.cellEnts[ilane].resize(buf.cells[ilane].size());
+			for(i=0;i<(int)buf.cells[ilane].size();i++)
+				buf.sorted.push_back((uint64)(uint32)buf.cells[ilane][i]<<32 | (uint64)ilane<<28 | i);
+		}
+		std::sort(buf.sorted.begin(),buf.sorted.end());
+
+		// go through the entities of each cell once, testing their quantized bounds against all rays of the packet that walk the cell
+		const Vec3 entgrid_origin = m_entgrid.origin;
+		const Vec2 entgrid_step = m_entgrid.step;
+		buf.ents.clear();
+		for(i=0;i<(int)buf.sorted.size();) {
+			const int icell = (int)(buf.sorted[i]>>32), ix = (int)(short)(icell&0xFFFF), iy = icell>>16;
+			int lanes = 0, ient0 = (int)buf.ents.size();
+			for(j=i; j<(int)buf.sorted.size() && (int)(buf.sorted[j]>>32)==icell; j++)
+				lanes |= 1<<(int)(buf.sorted[j]>>28 & 15);
+			const int bInRange = m_entgrid.inrange(ix,iy);
+			const float fCellX=(float)ix, fCellY=(float)iy;
+			Vec3 bmin,bmax;
+			for(int ithunk=m_pEntGrid[m_entgrid.getcell_safe(ix,iy)]; ithunk; ithunk=m_gthunks[ithunk].inext) {
+				const pe_gridthunk &thunk = m_gthunks[ithunk];
+				SRwiPacketEnt ent;
+				if (bInRange) {
+					const float fBBox0=(float)thunk.BBox[0], fBBox1=(float)thunk.BBox[1], fBBox2=(float)thunk.BBox[2], fBBox3=(float)thunk.BBox[3];
+					// the same bounds as check_cell's center and size, slightly inflated so that the test stays conservative
+					bmin[iEntAxisx] = (fCellX+(fBBox0-0.005f)*(1.0f/256))*entgrid_step.x + entgrid_origin[iEntAxisx];
+					bmax[iEntAxisx] = (fCellX+(fBBox2+1.005f)*(1.0f/256))*entgrid_step.x + entgrid_origin[iEntAxisx];
+					bmin[iEntAxisy] = (fCellY+(fBBox1-0.005f)*(1.0f/256))*entgrid_step.y + entgrid_origin[iEntAxisy];
+					bmax[iEntAxisy] = (fCellY+(fBBox3+1.005f)*(1.0f/256))*entgrid_step.y + entgrid_origin[iEntAxisy];
+					bmin[iEntAxisz] = (float)thunk.BBoxZ0*m_zGran + entgrid_origin[iEntAxisz];
+					bmax[iEntAxisz] = (float)thunk.BBoxZ1*m_zGran + entgrid_origin[iEntAxisz];
+					if (!(ent.lanes = RayPacketBoxOverlap(org,dirInv, bmin-Vec3(0.001f),bmax+Vec3(0.001f), ent.tenter) & lanes))
+						continue;
+				}	else {
+					ent.lanes = lanes;
+					for(ilane=0;ilane<RWI_PACKET_SIZE;ilane++) ent.tenter[ilane] = 0;
+				}
+				ent.pent = thunk.pent;
+				ent.iSimClass = thunk.iSimClass;
+				buf.ents.push_back(ent);
+			}
+			for(; i<j; i++)
+				buf.cellEnts[buf.sorted[i]>>28 & 15][buf.sorted[i] & (1<<28)-1].set(ient0, (int)buf.ents.size());
+		}
+
+		// trace each ray against the entities its walk found, cell by cell in walk order
+		const int iLastPODUpdate = m_iLastPODUpdate;
+		for(ilane=0;ilane<nRays;ilane++) if (bWalk[ilane]) {
+			entity_grid_checker &egcl = egc[ilane];
+			const int lane = 1<<ilane;
+			const float dirlen2 = egcl.aray.m_ray.dir.len2();
+			int icell,ilastcellDummy,bThunksChanged=0;
+			egcl.szList = GetTmpEntList(egcl.pTmpEntList, iCaller);	// could have been reallocated by the previous rays
+			MarkSkipEnts(rp[ilane].pSkipEnts,rp[ilane].nSkipEnts,1<<iCaller);
+			for(i=0;i<(int)buf.cells[ilane].size();i++) {
+				const int bWalkCell = i>0 || !bOutOfBounds[ilane];	// the out of bounds cell is checked before the walk, like in RayWorldIntersection
+				int &ilast = bWalkCell ? ilastcell[ilane] : ilastcellDummy;
+				Vec2i cell((int)(short)((icell=buf.cells[ilane][i])&0xFFFF), icell>>16);
+				if (!bThunksChanged) {
+					// like check_cell, create the cell's physics on demand entities only once the ray gets there;
+					// entities created by this or an earlier ray of the packet aren't in the collected lists
+					egcl.check_POD_cell(cell);
+					bThunksChanged = m_iLastPODUpdate!=iLastPODUpdate;
+				}
+				if (!bThunksChanged) {
+					const float tcur = dirlen2>0 ? egcl.aray.m_ray.dir*dir[ilane]/dirlen2 : 1.0f;
+					for(j=buf.cellEnts[ilane][i].x; j<buf.cellEnts[ilane][i].y; j++) {
+						const SRwiPacketEnt &ent = buf.ents[j];
+						if (ent.lanes & lane && egcl.objtypes & 1<<ent.iSimClass && !(ent.pent->m_bProcessed & 1<<iCaller) && ent.tenter[ilane]<=tcur
+								&& (!egcl.pSkipForeignData || (CPhysicalPlaceholder*)ent.pent->CPhysicalPlaceholder::GetForeignData(egcl.iSkipForeignData)!=egcl.pSkipForeignData))
+							bThunksChanged |= egcl.check_ent(ent.pent,ilast);
+					}
+					if (bThunksChanged)	// the cell's list changed, check what's new in it
+						egcl.check_cell(cell,ilast);
+				}	else	// the lists collected for the rest of the walk can be out of date
+					egcl.check_cell(cell,ilast);
+				if (bWalkCell && (icell==ilastcell[ilane] || (cell.y<<16|cell.x)==ilastcell[ilane]))
+					break;
+			}
+			RayFinishGrid(rp[ilane],egcl,iCaller);
+		}
+	}
+
+	for(ilane=0;ilane<nRays;ilane++) {
+		pentLastHit=0;
+		nHitsTotal += (pNumHits[pRayIdx[ilane]] = RayCollectHits(rp[ilane],dir[ilane],egc[ilane],0,iCaller, pentLastHit,ipartLastHit,inodeLastHit));
+	}
+	return nHitsTotal;
 }
 
+int CPhysicalWorld::RayWorldIntersectionBatch(const SRWIParams *pRays, int nRays, ray_hit *pHits, int *pNumHits, const char *pNameTag, int iCaller)
+{
+	FUNCTION_PROFILER( GetISystem(),PROFILE_PHYSICS );
+
+	// trace the rays ordered by the entity grid cell of their origin (along a z-curve) and their direction octant,
+	// so consecutive rays walk the same cells and find the same grid thunks and BV trees in cache
+	SRwiBatchKey keysBuf[256], *pKeys = nRays<=CRY_ARRAY_COUNT(keysBuf) ? keysBuf : new SRwiBatchKey[nRays];
+	int i,n,nHitsTotal=0,iRayPacket[RWI_PACKET_SIZE],iHitPacket[RWI_PACKET_SIZE];
+	for(i=0;i<nRays;i++) {
+		const Vec3 origin_grid = (pRays[i].org-m_entgrid.origin).GetPermutated(m_iEntAxisz), dir_grid = pRays[i].dir.GetPermutated(m_iEntAxisz);
+		const uint32 ix = (uint32)float2int(origin_grid.x*m_entgrid.stepr.x-0.5f)+0x8000u;
+		const uint32 iy = (uint32)float2int(origin_grid.y*m_entgrid.stepr.y-0.5f)+0x8000u;
+		const uint32 octant = isneg(dir_grid.x) | isneg(dir_grid.y)<<1 | isneg(dir_grid.z)<<2;
+		pKeys[i].key = (uint64)(SpreadBits16(ix) | SpreadBits16(iy)<<1)<<3 | octant;
+		pKeys[i].iray = i;
+		pKeys[i].ihit = nHitsTotal;
+		nHitsTotal += pRays[i].nMaxHits;
+	}
+	std::sort(pKeys, pKeys+nRays);
+
+	// neighbouring rays are traced in packets: the entity grid is walked once per packet cell, with the entity bounds tested 
+	// against all rays of the packet at once; rays with a cached last hit go one by one
+	for(i=0,nHitsTotal=0; i<nRays; ) {
+		for(n=0; m_vars.bRwiBatchPackets && n<RWI_PACKET_SIZE && i+n<nRays && !pRays[pKeys[i+n].iray].phitLast && pRays[pKeys[i+n].iray].dir.len2()>0; n++)
+			iRayPacket[n]=pKeys[i+n].iray, iHitPacket[n]=pKeys[i+n].ihit;
+		if (n>1) {
+			nHitsTotal += RayWorldIntersectionPacket(pRays,iRayPacket,iHitPacket,n, pHits,pNumHits, iCaller);
+			i += n;
+			continue;
+		}
+		const int iray=pKeys[i].iray, ihit=pKeys[i].ihit; i++;
+		SRWIParams rp = pRays[iray];
+		rp.hits = pHits+ihit;
+		rp.flags &= ~rwi_queue;
+		nHitsTotal += (pNumHits[iray] = RayWorldIntersection(rp, pNameTag, iCaller));
+	}
+
+	if (pKeys!=keysBuf)
+		delete[] pKeys;
+	return nHitsTotal;
+}
+
+
 int CPhysicalWorld::TracePendingRays(int bDoTracing)
 {	
 	int i,nChex=0;
@@ -2073,6 +2073,8 @@ struct CPhysVarsSerializer : Serializer {
 		DECLARE_MEMBER("bSkipRedundantColldet", ft_int, bSkipRedundantColldet)
 		DECLARE_MEMBER("bLimitSimpleSolverEnergy", ft_int, bLimitSimpleSolverEnergy)
 		DECLARE_MEMBER("numThreads", ft_int, numThreads)
+		DECLARE_MEMBER("bJobSystemStep", ft_int, bJobSystemStep)
+		DECLARE_MEMBER("jobSystemStepMinCost", ft_int, jobSystemStepMinCost)
 	}
 };
 
@@ -0,0 +1,218 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "ScriptGCScheduler.h"
+
+#include <CrySystem/ISystem.h>
+#include <CrySystem/IConsole.h>
+#include <CrySystem/ITimer.h>
+
+#pragma warning(push) // Because lua.h touches warning C4996
+extern "C" {
+#include <lua.h>
+}
+#pragma warning(pop)
+
+namespace
+{
+// averaging time of the allocation rate and the step cost, in seconds
+const float SMOOTHING_TIME = 0.5f;
+// steps are sized to take this part of the budget
+const float STEP_BUDGET_FRACTION = 0.25f;
+// part of the time the last frame stayed below the target which is added to the budget
+const float SLACK_FRACTION = 0.1f;
+const int   MAX_STEP_KB = 1024;
+}
+
+CScriptGCScheduler::CScriptGCScheduler()
+#if ENABLE_STATOSCOPE
+	: m_statoscopeDG(*this)
+	, L(NULL)
+#else
+	: L(NULL)
+#endif
+	, m_lastTotalAllocated(0)
+	, m_usPerKB(10.0f)
+	, m_heapKBAfterCycle(0)
+	, m_bCycleActive(false)
+	, m_frameBudgetMs(0.5f)
+	, m_maxFrameBudgetMs(2.0f)
+	, m_targetFrameTimeMs(33.3f)
+	, m_idleCycleGrowth(0.25f)
+	, m_minStepKB(2)
+{
+}
+
+CScriptGCScheduler::~CScriptGCScheduler()
+{
+	Shutdown();
+}
+
+void CScriptGCScheduler::Init(lua_State* pState)
+{
+	L = pState;
+	m_heapKBAfterCycle = (uint32)lua_gc(L, LUA_GCCOUNT, 0);
+
+	REGISTER_CVAR2("lua_gcFrameBudget", &m_frameBudgetMs, m_frameBudgetMs, VF_NULL,
+	               "Time in ms the Lua garbage collector may take per frame to keep up with the allocations of the scripts.\n"
+	               "Work which doesn't fit is carried to the next frame, Lua collects inside the allocations when it falls too far behind.");
+	REGISTER_CVAR2("lua_gcMaxFrameBudget", &m_maxFrameBudgetMs, m_maxFrameBudgetMs, VF_NULL,
+	               "Upper limit in ms of the Lua garbage collector frame budget, including the time added by lua_gcTargetFrameTime.");
+	REGISTER_CVAR2("lua_gcTargetFrameTime", &m_targetFrameTimeMs, m_targetFrameTimeMs, VF_NULL,
+	               "Frame time in ms the game aims for. A part of the time the last frame stayed below it is added to the Lua garbage collector budget.");
+	REGISTER_CVAR2("lua_gcIdleCycleGrowth", &m_idleCycleGrowth, m_idleCycleGrowth, VF_NULL,
+	               "Heap growth since the last Lua garbage collection cycle (0.25 = 25%) at which the idle time of the frame rate limiter starts a new cycle.\n"
+	               "0 only pays the collection debt in the idle time.");
+	REGISTER_CVAR2("lua_gcMinStepKB", &m_minStepKB, m_minStepKB, VF_NULL,
+	               "Smallest step of the Lua garbage collector in KB.");
+
+#if ENABLE_STATOSCOPE
+	if (gEnv->pStatoscope)
+		gEnv->pStatoscope->RegisterDataGroup(&m_statoscopeDG);
+#endif
+}
+
+void CScriptGCScheduler::Shutdown()
+{
+	if (!L)
+		return;
+	L = NULL;
+
+#if ENABLE_STATOSCOPE
+	if (gEnv->pStatoscope)
+		gEnv->pStatoscope->UnregisterDataGroup(&m_statoscopeDG);
+#endif
+
+	if (gEnv->pConsole)
+	{
+		gEnv->pConsole->UnregisterVariable("lua_gcFrameBudget");
+		gEnv->pConsole->UnregisterVariable("lua_gcMaxFrameBudget");
+		gEnv->pConsole->UnregisterVariable("lua_gcTargetFrameTime");
+		gEnv->pConsole->UnregisterVariable("lua_gcIdleCycleGrowth");
+		gEnv->pConsole->UnregisterVariable("lua_gcMinStepKB");
+	}
+}
+
+void CScriptGCScheduler::Update(uint64 totalAllocated, float frameTime)
+{
+	if (!L)
+		return;
+
+	FRAME_PROFILER("Lua GC", gEnv->pSystem, PROFILE_SCRIPT);
+
+	const float allocatedKB = (totalAllocated - m_lastTotalAllocated) / 1024.0f;
+	m_lastTotalAllocated = totalAllocated;
+
+	if (frameTime > 0.0f)
+	{
+		const float blend = min(frameTime / SMOOTHING_TIME, 1.0f);
+		m_stats.allocRateKB += (allocatedKB / frameTime - m_stats.allocRateKB) * blend;
+	}
+
+	// Lua's own pace: every KB allocated asks for a step of one KB. When the debt grows beyond the heap, the
+	// collector inside the allocations has done the work already.
+	m_stats.heapKB = (uint32)lua_gc(L, LUA_GCCOUNT, 0);
+	m_stats.debtKB = min(m_stats.debtKB + allocatedKB, (float)m_stats.heapKB);
+
+	const float frameMs = frameTime * 1000.0f;
+	float budgetMs = m_frameBudgetMs;
+	if (frameMs > 0.0f && frameMs < m_targetFrameTimeMs)
+		budgetMs += (m_targetFrameTimeMs - frameMs) * SLACK_FRACTION;
+	budgetMs = min(budgetMs, m_maxFrameBudgetMs);
+
+	m_stats.frameTimeMs = Collect(budgetMs, false);
+}
+
+void CScriptGCScheduler::UpdateIdle(float timeMs)
+{
+	if (!L || timeMs <= 0.0f)
+		return;
+
+	FRAME_PROFILER("Lua GC Idle", gEnv->pSystem, PROFILE_SCRIPT);
+
+	// start the next cycle early if the heap grew enough, instead of waiting for the allocations to run it
+	const uint32 heapKB = (uint32)lua_gc(L, LUA_GCCOUNT, 0);
+	const bool bStartCycle = m_idleCycleGrowth > 0.0f && heapKB > m_heapKBAfterCycle * (1.0f + m_idleCycleGrowth);
+	if (m_stats.debtKB <= 0.0f && !m_bCycleActive && !bStartCycle)
+	{
+		m_stats.idleTimeMs = 0.0f;
+		return;
+	}
+	if (bStartCycle)
+		m_bCycleActive = true;
+
+	m_stats.idleTimeMs = Collect(timeMs, true);
+}
+
+void CScriptGCScheduler::OnFullCollection()
+{
+	if (!L)
+		return;
+
+	m_stats.debtKB = 0.0f;
+	m_bCycleActive = false;
+	m_heapKBAfterCycle = (uint32)lua_gc(L, LUA_GCCOUNT, 0);
+	m_stats.heapKB = m_heapKBAfterCycle;
+	++m_stats.numCycles;
+}
+
+float CScriptGCScheduler::Collect(float timeMs, bool bIdle)
+{
+	// the steps take microseconds, CTimeValue is too coarse for them
+	const float ticksPerUs = gEnv->pTimer->GetTicksPerSecond() / 1000000.0f;
+	const int64 startTicks = CryGetTicks();
+	const int64 endTicks = startTicks + (int64)(timeMs * 1000.0f * ticksPerUs);
+	int64 now = startTicks;
+
+	// in idle time a started cycle is finished even without debt
+	while (now < endTicks && (m_stats.debtKB > 0.0f || (bIdle && m_bCycleActive)))
+	{
+		const float remainingUs = (endTicks - now) / ticksPerUs;
+		const float stepUs = max(remainingUs * STEP_BUDGET_FRACTION, 1.0f);
+		int stepKB = (int)(stepUs / max(m_usPerKB, 0.01f));
+		if (m_stats.debtKB > 0.0f)
+			stepKB = min(stepKB, (int)m_stats.debtKB + 1);
+		stepKB = clamp_tpl(stepKB, max(m_minStepKB, 1), MAX_STEP_KB);
+
+		const bool bCycleDone = lua_gc(L, LUA_GCSTEP, stepKB) != 0;
+
+		const int64 stepEnd = CryGetTicks();
+		const float usPerKB = (stepEnd - now) / ticksPerUs / stepKB;
+		m_usPerKB += (usPerKB - m_usPerKB) * STEP_BUDGET_FRACTION;
+		now = stepEnd;
+
+		m_stats.stepKB = stepKB;
+		m_stats.debtKB = max(m_stats.debtKB - stepKB, 0.0f);
+		m_bCycleActive = !bCycleDone;
+		if (bCycleDone)
+		{
+			// nothing is owed for a finished cycle, the next one starts with the allocations
+			m_stats.debtKB = 0.0f;
+			m_heapKBAfterCycle = (uint32)lua_gc(L, LUA_GCCOUNT, 0);
+			++m_stats.numCycles;
+			break;
+		}
+	}
+
+	m_stats.heapKB = (uint32)lua_gc(L, LUA_GCCOUNT, 0);
+	return (now - startTicks) / ticksPerUs / 1000.0f;
+}
+
+#if ENABLE_STATOSCOPE
+IStatoscopeDataGroup::SDescription CScriptGCScheduler::SStatoscopeDG::GetDescription() const
+{
+	return SDescription('G', "lua gc", "['/LuaGC/' (float frameTimeMS) (float idleTimeMS) (float heapMB) (float allocRateKBs) (float debtKB) (int stepKB) (int cycles)]");
+}
+
+void CScriptGCScheduler::SStatoscopeDG::Write(IStatoscopeFrameRecord& fr)
+{
+	const SStats& stats = m_scheduler.GetStats();
+	fr.AddValue(stats.frameTimeMs);
+	fr.AddValue(stats.idleTimeMs);
+	fr.AddValue(stats.heapKB / 1024.0f);
+	fr.AddValue(stats.allocRateKB);
+	fr.AddValue(stats.debtKB);
+	fr.AddValue((int)stats.stepKB);
+	fr.AddValue((int)stats.numCycles);
+}
+#endif
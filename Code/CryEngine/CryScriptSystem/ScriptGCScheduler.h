@@ -0,0 +1,88 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+//
+// ScriptGCScheduler.h: paces the incremental Lua garbage collector.
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef __SCRIPTGCSCHEDULER_H__
+#define __SCRIPTGCSCHEDULER_H__
+
+#pragma once
+
+#include <CrySystem/Profilers/IStatoscope.h>
+
+struct lua_State;
+
+// Lua collects incrementally while scripts allocate, and used to get a fixed step of 2KB per frame on top.
+// Script heavy levels outpaced that step, so the collector did most of its work inside script calls, and
+// in bursts. The scheduler instead keeps a debt of the bytes Lua allocated since the last collection work and
+// pays it each frame in steps, as many as fit into the frame budget (lua_gcFrameBudget, plus a part of the
+// time the last frame stayed below lua_gcTargetFrameTime). The step size follows the measured cost per KB,
+// so a single step doesn't overrun the budget. Whatever doesn't fit is carried to the next frame.
+// The time the frame rate limiter waits at the start of a frame is given to the collector as well: the
+// debt is paid there first, and a new cycle is started ahead of time when the heap grew enough.
+class CScriptGCScheduler
+{
+public:
+	struct SStats
+	{
+		SStats() { memset(this, 0, sizeof(*this)); }
+
+		float  frameTimeMs;  // collection time in the last frame update
+		float  idleTimeMs;   // collection time in the last idle update
+		float  allocRateKB;  // smoothed, KB per second
+		float  debtKB;
+		uint32 heapKB;
+		uint32 stepKB;       // size of the last step
+		uint32 numCycles;    // completed collection cycles
+	};
+
+	CScriptGCScheduler();
+	~CScriptGCScheduler();
+
+	void          Init(lua_State* L);
+	void          Shutdown();
+
+	// Once per frame, totalAllocated is the number of bytes Lua allocated since start.
+	void          Update(uint64 totalAllocated, float frameTime);
+	// Spends up to timeMs on collection work, while the frame waits anyway.
+	void          UpdateIdle(float timeMs);
+	// A full collection was done outside the scheduler.
+	void          OnFullCollection();
+
+	const SStats& GetStats() const { return m_stats; }
+
+private:
+	// runs steps for up to timeMs, returns the time spent in ms
+	float Collect(float timeMs, bool bIdle);
+
+#if ENABLE_STATOSCOPE
+	struct SStatoscopeDG : public IStatoscopeDataGroup
+	{
+		SStatoscopeDG(const CScriptGCScheduler& scheduler) : m_scheduler(scheduler) {}
+
+		virtual SDescription GetDescription() const;
+		virtual void         Write(IStatoscopeFrameRecord& fr);
+
+		const CScriptGCScheduler& m_scheduler;
+	};
+
+	SStatoscopeDG m_statoscopeDG;
+#endif
+
+	lua_State* L;
+	SStats     m_stats;
+	uint64     m_lastTotalAllocated;
+	float      m_usPerKB;         // measured cost of a step, smoothed
+	uint32     m_heapKBAfterCycle;
+	bool       m_bCycleActive;
+
+	float      m_frameBudgetMs;
+	float      m_maxFrameBudgetMs;
+	float      m_targetFrameTimeMs;
+	float      m_idleCycleGrowth;
+	int        m_minStepKB;
+};
+
+#endif // __SCRIPTGCSCHEDULER_H__
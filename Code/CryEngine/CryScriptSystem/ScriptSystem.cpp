@@ -44,9 +44,6 @@ extern HANDLE gDLLHandle;
 
 #include "LuaRemoteDebug/LuaRemoteDebug.h"
 
-// Fine tune this value for optimal performance/memory
-#define PER_FRAME_LUA_GC_STEP        2
-
 #define LUA_NODE_ALLOCATOR_BLOCKSIZE 128 * 1024
 #define LUA_NODE_ALLOCATOR_TYPE      eCryDefaultMalloc
 
@@ -55,6 +52,8 @@ extern HANDLE gDLLHandle;
 //////////////////////////////////////////////////////////////////////
 int g_dumpStackOnAlloc = 0;
 int g_nPrecaution = 0; // will cause delayed crash, will make engine extremelly unstable.
+// Bytes Lua allocated since start, frees aren't subtracted. Paces the garbage collector, see CScriptGCScheduler.
+uint64 g_nLuaAllocatedBytes = 0;
 
 // Global Lua debugger pointer (if initialized)
 CLUADbg* g_pLuaDebugger = 0;
@@ -107,6 +106,11 @@ void LuaGarbargeCollect(IConsoleCmdArgs*)
 	gEnv->pScriptSystem->ForceGarbageCollection();
 }
 
+void LuaDumpGCStats(IConsoleCmdArgs*)
+{
+	((CScriptSystem*)gEnv->pScriptSystem)->DumpGCStats();
+}
+
 inline CScriptTable* AllocTable() { return new CScriptTable; }
 //	inline void FreeTable( CScriptTable *pTable ) { /*delete pTable;*/ }
 }
@@ -226,6 +230,9 @@ extern "C"
 		if (g_dumpStackOnAlloc)
 			DumpCallStack(g_LStack);
 
+		if (nsize > (ptr ? osize : 0))
+			g_nLuaAllocatedBytes += nsize - (ptr ? osize : 0);
+
 	#if !defined(NOT_USE_CRY_MEMORY_MANAGER) && !defined(_DEBUG)
 		void* ret = gLuaAlloc.re_alloc(ptr, osize, nsize);
 		return ret;
@@ -718,6 +725,8 @@ CScriptSystem::~CScriptSystem()
 
 	m_stdScriptBinds.Done();
 
+	m_gcScheduler.Shutdown();
+
 	if (L)
 	{
 		lua_close(L);
@@ -780,6 +789,9 @@ bool CScriptSystem::Init(ISystem* pSystem, bool bStdLibs, int nStackSize)
 	REGISTER_COMMAND("lua_dump_coverage", LuaDumpCoverage, VF_NULL,
 	                 "Dumps lua states");
 	REGISTER_COMMAND("lua_garbagecollect", LuaGarbargeCollect, VF_NULL, "Forces a garbage collection of the lua state");
+	REGISTER_COMMAND("lua_dump_gc_stats", LuaDumpGCStats, VF_NULL, "Logs the state of the lua garbage collector and the allocations per size class of the lua allocator");
+
+	m_gcScheduler.Init(L);
 
 	// Publish the debugging mode as console variable
 	m_cvar_script_debugger = REGISTER_INT_CB("lua_debugger", 0, VF_CHEAT,
@@ -1808,6 +1820,7 @@ void CScriptSystem::ForceGarbageCollection()
 
 	// Do a full garbage collection cycle.
 	lua_gc(L, LUA_GCCOLLECT, 0);
+	m_gcScheduler.OnFullCollection();
 
 	int fracUsage = lua_gc(L, LUA_GCCOUNTB, 0);
 	int totalUsage = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + fracUsage;
@@ -1836,6 +1849,34 @@ void CScriptSystem::ForceGarbageCollection()
 	   OutputDebugString(sTemp);*/
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CScriptSystem::CollectGarbageIdle(float timeMs)
+{
+	m_gcScheduler.UpdateIdle(timeMs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CScriptSystem::DumpGCStats()
+{
+	const CScriptGCScheduler::SStats& stats = m_gcScheduler.GetStats();
+	CryLogAlways("Lua GC: heap %u KB, allocating %.1f KB/s, debt %.1f KB, last step %u KB, %u cycles",
+	             stats.heapKB, stats.allocRateKB, stats.debtKB, stats.stepKB, stats.numCycles);
+	CryLogAlways("Lua GC: %.3f ms in the last frame, %.3f ms in the last idle time", stats.frameTimeMs, stats.idleTimeMs);
+
+#if !USE_RAW_LUA_ALLOCS && defined(USE_GLOBAL_BUCKET_ALLOCATOR)
+	std::vector<lua_allocator::BucketStats> buckets(lua_allocator::GetNumBuckets());
+	buckets.resize(gLuaAlloc.GetBucketStats(&buckets[0], buckets.size()));
+	CryLogAlways("Lua allocator: %" PRISIZE_T " KB storage, %" PRISIZE_T " KB allocated", gLuaAlloc.GetBucketStorageSize() / 1024, gLuaAlloc.get_alloc_size() / 1024);
+	CryLogAlways("  size     live  live KB  allocations");
+	for (size_t i = 0; i < buckets.size(); ++i)
+	{
+		const lua_allocator::BucketStats& bucket = buckets[i];
+		if (bucket.allocCount)
+			CryLogAlways("  %4" PRISIZE_T " %8u %8" PRISIZE_T " %12u", bucket.itemSize, bucket.liveCount, bucket.itemSize * bucket.liveCount / 1024, bucket.allocCount);
+	}
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 int CScriptSystem::GetCGCount()
@@ -2169,41 +2210,10 @@ void CScriptSystem::Update()
 		pScriptSystem->SetGlobalValue("_aitick", aiTicks);
 	}
 
-	//TRACE("GC DELTA %d",m_pScriptSystem->GetCGCount()-nStartGC);
-	//int nStartGC = pScriptSystem->GetCGCount();
-
-	bool bKickIn = false;                             // Invoke Gargabe Collector
-
-	if (currTime - m_lastGCTime > m_fGCFreq)  // g_GC_Frequence->GetIVal())
-		bKickIn = true;
-
-	int nGCCount = pScriptSystem->GetCGCount();
-
-	bool bNoLuaGC = false;
-
-	if (nGCCount - m_nLastGCCount > 2000 && !bNoLuaGC)   //
-		bKickIn = true;
-
-	//if(bKickIn)
-	{
-		FRAME_PROFILER("Lua GC", m_pSystem, PROFILE_SCRIPT);
-
-		//CryLog( "Lua GC=%d",GetCGCount() );
-
-		//float fTimeBefore=pTimer->GetAsyncCurTime()*1000;
-
-		// Do a full garbage collection cycle.
-		//pScriptSystem->ForceGarbageCollection();
-
-		// Do incremental Garbage Collection
-		lua_gc(L, LUA_GCSTEP, (PER_FRAME_LUA_GC_STEP));
-
-		m_nLastGCCount = pScriptSystem->GetCGCount();
-		m_lastGCTime = currTime;
-		//float fTimeAfter=pTimer->GetAsyncCurTime()*1000;
-		//CryLog("--[after coll]GC DELTA %d ",pScriptSystem->GetCGCount()-nGCCount);
-		//TRACE("--[after coll]GC DELTA %d [time =%f]",m_pScriptSystem->GetCGCount()-nStartGC,fTimeAfter-fTimeBefore);
-	}
+	// Do incremental Garbage Collection, paced by the allocations and the frame time
+	m_gcScheduler.Update(g_nLuaAllocatedBytes, frameTime);
+	m_nLastGCCount = pScriptSystem->GetCGCount();
+	m_lastGCTime = currTime;
 
 	m_pScriptTimerMgr->Update(nCurTime.GetMilliSecondsAsInt64());
 }
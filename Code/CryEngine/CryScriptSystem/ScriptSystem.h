@@ -14,6 +14,7 @@ extern "C" {
 #include "StackGuard.h"
 #include "ScriptBindings/ScriptBinding.h"
 #include "ScriptTimerMgr.h"
+#include "ScriptGCScheduler.h"
 
 class CLUADbg;
 
@@ -168,6 +169,7 @@ public:
 
 	virtual IScriptTable* CreateUserData(void* ptr, size_t size);
 	virtual void          ForceGarbageCollection();
+	virtual void          CollectGarbageIdle(float timeMs);
 	virtual int           GetCGCount();
 	virtual void          SetGCThreshhold(int nKb);
 	virtual void          Release();
@@ -218,6 +220,7 @@ public:
 	void                  GetCallStack(std::vector<SLuaStackEntry>& callstack);
 	bool                  IsCallStackEmpty(void);
 	void                  DumpStateToFile(const char* filename);
+	void                  DumpGCStats();
 
 	//////////////////////////////////////////////////////////////////////////
 	// Facility to pre-catch any lua buffer
@@ -284,6 +287,7 @@ private:
 	int                   m_forceReloadCount;
 
 	CScriptTimerMgr*      m_pScriptTimerMgr;
+	CScriptGCScheduler    m_gcScheduler;
 
 	// Store a simple callstack that can be inspected in C++ debugger
 	const static int MAX_CALLDEPTH = 32;
@@ -0,0 +1,938 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "AsyncLogWriter.h"
+#include <CrySystem/IConsole.h>
+#include <CryString/CryPath.h>
+
+namespace
+{
+// Buffer of the calling thread: the instance id in the upper 16 bits, the buffer index + 1 in the lower ones.
+THREADLOCAL uint32 gThreadBufferKey = 0;
+volatile LONG gNumWriterInstances = 0;
+
+const char kBinaryLogMagic[8] = { 'C', 'R', 'Y', 'B', 'L', 'O', 'G', '1' };
+
+// Binary log entries
+enum EEntryTag
+{
+	eET_Format     = 'F', // uint32 id, uint32 length, format string
+	eET_ThreadName = 'N', // uint64 thread id, uint32 length, name
+	eET_Text       = 'T', // int64 ticks, uint64 thread id, uint8 log type, uint8 flags, uint32 length, text
+	eET_Message    = 'M', // int64 ticks, uint64 thread id, uint8 log type, uint8 flags, uint32 format id, uint32 arg bytes, args
+};
+
+// Encoded arguments, each a tag byte followed by the value
+enum EArgTag
+{
+	eAT_Int32   = 'i',
+	eAT_Int64   = 'l',
+	eAT_Double  = 'f',
+	eAT_Pointer = 'p',
+	eAT_String  = 's', // uint16 length, characters
+};
+
+struct SFormatSpec
+{
+	const char* szEnd; // after the conversion character
+	uint8       tag;   // 0 for "%%"
+	bool        bWidthArg;
+	bool        bPrecisionArg;
+	int         precision; // literal precision, -1 if there's none
+};
+
+// Parses the conversion szSpec points to, the '%'. Returns false for conversions which can't be stored, e.g. %n or wide strings.
+bool ParseFormatSpec(const char* szSpec, SFormatSpec& spec)
+{
+	const char* p = szSpec + 1;
+	spec.bWidthArg = spec.bPrecisionArg = false;
+	spec.precision = -1;
+
+	while (*p && strchr("-+ #0'", *p))
+		++p;
+	if (*p == '*')
+	{
+		spec.bWidthArg = true;
+		++p;
+	}
+	while (*p >= '0' && *p <= '9')
+		++p;
+	if (*p == '.')
+	{
+		++p;
+		if (*p == '*')
+		{
+			spec.bPrecisionArg = true;
+			++p;
+		}
+		else
+		{
+			spec.precision = 0;
+			while (*p >= '0' && *p <= '9')
+				spec.precision = min(spec.precision * 10 + (*p++ - '0'), 0xffff);
+		}
+	}
+
+	size_t intSize = sizeof(int);
+	bool bWide = false;
+	bool bLongDouble = false;
+	switch (*p)
+	{
+	case 'h':
+		p += p[1] == 'h' ? 2 : 1;
+		break;
+	case 'l':
+		if (p[1] == 'l')
+		{
+			intSize = sizeof(int64);
+			p += 2;
+		}
+		else
+		{
+			intSize = sizeof(long);
+			bWide = true;
+			++p;
+		}
+		break;
+	case 'j':
+	case 'q':
+		intSize = sizeof(int64);
+		++p;
+		break;
+	case 'z':
+	case 't':
+		intSize = sizeof(size_t);
+		++p;
+		break;
+	case 'L':
+		bLongDouble = true;
+		++p;
+		break;
+	case 'I':
+		if (p[1] == '6' && p[2] == '4')
+		{
+			intSize = sizeof(int64);
+			p += 3;
+		}
+		else if (p[1] == '3' && p[2] == '2')
+		{
+			p += 3;
+		}
+		else
+		{
+			intSize = sizeof(size_t);
+			++p;
+		}
+		break;
+	}
+
+	spec.szEnd = *p ? p + 1 : p;
+	switch (*p)
+	{
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+		spec.tag = intSize == sizeof(int64) ? eAT_Int64 : eAT_Int32;
+		return true;
+	case 'c':
+		spec.tag = eAT_Int32;
+		return !bWide;
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		spec.tag = eAT_Double;
+		return !bLongDouble;
+	case 's':
+		spec.tag = eAT_String;
+		return !bWide;
+	case 'p':
+		spec.tag = eAT_Pointer;
+		return true;
+	case '%':
+		spec.tag = 0;
+		return true;
+	default:
+		return false;
+	}
+}
+
+template<class T>
+ILINE bool PutArg(uint8*& p, const uint8* pEnd, uint8 tag, T value)
+{
+	if (pEnd - p < (ptrdiff_t)(1 + sizeof(T)))
+		return false;
+	*p++ = tag;
+	memcpy(p, &value, sizeof(T));
+	p += sizeof(T);
+	return true;
+}
+
+template<class T>
+ILINE bool GetArg(const uint8*& p, const uint8* pEnd, uint8 tag, T& value)
+{
+	if (pEnd - p < (ptrdiff_t)(1 + sizeof(T)) || *p != tag)
+		return false;
+	memcpy(&value, p + 1, sizeof(T));
+	p += 1 + sizeof(T);
+	return true;
+}
+
+// Stores the arguments of the conversions of szFormat. Returns the number of bytes, or -1 if they can't be stored.
+int EncodeArgs(const char* szFormat, va_list args, uint8* pOut, size_t capacity)
+{
+	uint8* p = pOut;
+	const uint8* pEnd = pOut + capacity;
+
+	for (const char* szSpec = strchr(szFormat, '%'); szSpec; szSpec = strchr(szSpec, '%'))
+	{
+		SFormatSpec spec;
+		if (!ParseFormatSpec(szSpec, spec))
+			return -1;
+		szSpec = spec.szEnd;
+		if (!spec.tag)
+			continue;
+
+		if (spec.bWidthArg && !PutArg(p, pEnd, eAT_Int32, va_arg(args, int)))
+			return -1;
+		int precision = spec.precision;
+		if (spec.bPrecisionArg && !PutArg(p, pEnd, eAT_Int32, precision = va_arg(args, int)))
+			return -1;
+
+		bool bStored = true;
+		switch (spec.tag)
+		{
+		case eAT_Int32:
+			bStored = PutArg(p, pEnd, eAT_Int32, va_arg(args, int));
+			break;
+		case eAT_Int64:
+			bStored = PutArg(p, pEnd, eAT_Int64, va_arg(args, int64));
+			break;
+		case eAT_Double:
+			bStored = PutArg(p, pEnd, eAT_Double, va_arg(args, double));
+			break;
+		case eAT_Pointer:
+			bStored = PutArg(p, pEnd, eAT_Pointer, (uint64)(UINT_PTR)va_arg(args, void*));
+			break;
+		case eAT_String:
+			{
+				const char* szString = va_arg(args, const char*);
+				if (!szString)
+					szString = "(null)";
+				// with a precision the string doesn't have to be terminated, e.g. "%.4s" for four character codes
+				const size_t length = precision >= 0 ? strnlen(szString, precision) : strlen(szString);
+				bStored = length <= 0xffff && PutArg(p, pEnd, eAT_String, (uint16)length) && pEnd - p >= (ptrdiff_t)length;
+				if (bStored)
+				{
+					memcpy(p, szString, length);
+					p += length;
+				}
+			}
+			break;
+		}
+		if (!bStored)
+			return -1;
+	}
+
+	return (int)(p - pOut);
+}
+
+// Formats szFormat with the arguments stored by EncodeArgs
+bool DecodeArgs(const char* szFormat, const uint8* pArgs, uint32 argBytes, string& out)
+{
+	const uint8* p = pArgs;
+	const uint8* pEnd = pArgs + argBytes;
+
+	const char* szText = szFormat;
+	for (const char* szSpec = strchr(szText, '%'); szSpec; szSpec = strchr(szText, '%'))
+	{
+		out.append(szText, szSpec - szText);
+
+		SFormatSpec spec;
+		if (!ParseFormatSpec(szSpec, spec))
+			return false;
+		szText = spec.szEnd;
+		if (!spec.tag)
+		{
+			out += '%';
+			continue;
+		}
+
+		// The conversion without the length modifiers, the stored width and precision and the stored size of the argument.
+		CryStackStringT<char, 64> conversion("%");
+		for (const char* c = szSpec + 1; c < spec.szEnd - 1 && !isalpha((unsigned char)*c); ++c)
+		{
+			int32 value;
+			if (*c != '*')
+				conversion += *c;
+			else if (GetArg(p, pEnd, eAT_Int32, value))
+				conversion += CryStackStringT<char, 16>().Format("%d", value).c_str();
+			else
+				return false;
+		}
+
+		string formatted;
+		const char conversionChar = spec.szEnd[-1];
+		switch (spec.tag)
+		{
+		case eAT_Int32:
+			{
+				int32 value;
+				if (!GetArg(p, pEnd, eAT_Int32, value))
+					return false;
+				conversion += conversionChar;
+				formatted.Format(conversion.c_str(), value);
+			}
+			break;
+		case eAT_Int64:
+			{
+				int64 value;
+				if (!GetArg(p, pEnd, eAT_Int64, value))
+					return false;
+				conversion += "ll";
+				conversion += conversionChar;
+				formatted.Format(conversion.c_str(), (long long)value);
+			}
+			break;
+		case eAT_Double:
+			{
+				double value;
+				if (!GetArg(p, pEnd, eAT_Double, value))
+					return false;
+				conversion += conversionChar;
+				formatted.Format(conversion.c_str(), value);
+			}
+			break;
+		case eAT_Pointer:
+			{
+				uint64 value;
+				if (!GetArg(p, pEnd, eAT_Pointer, value))
+					return false;
+				conversion += "llx";
+				formatted.Format(("0x" + string(conversion.c_str())).c_str(), (unsigned long long)value);
+			}
+			break;
+		case eAT_String:
+			{
+				uint16 length;
+				if (!GetArg(p, pEnd, eAT_String, length) || pEnd - p < length)
+					return false;
+				const string value((const char*)p, length);
+				p += length;
+				conversion += 's';
+				formatted.Format(conversion.c_str(), value.c_str());
+			}
+			break;
+		}
+		out += formatted;
+	}
+
+	out += szText;
+	return true;
+}
+
+template<class T>
+ILINE void WriteValue(FILE* pFile, T value)
+{
+	fwrite(&value, sizeof(T), 1, pFile);
+}
+
+struct SBinaryLogReader
+{
+	const uint8* p;
+	const uint8* pEnd;
+
+	template<class T>
+	bool Read(T& value)
+	{
+		if (pEnd - p < (ptrdiff_t)sizeof(T))
+			return false;
+		memcpy(&value, p, sizeof(T));
+		p += sizeof(T);
+		return true;
+	}
+
+	bool ReadBytes(const uint8*& pBytes, uint32 length)
+	{
+		if (pEnd - p < (ptrdiff_t)length)
+			return false;
+		pBytes = p;
+		p += length;
+		return true;
+	}
+};
+}
+
+int CAsyncLogWriter::CV_log_AsyncFlushMs = 100;
+int CAsyncLogWriter::CV_log_AsyncFlushOnError = 1;
+int CAsyncLogWriter::CV_log_AsyncBufferSize = 64;
+
+//////////////////////////////////////////////////////////////////////////
+CAsyncLogWriter::CAsyncLogWriter()
+	: m_numBuffers(0)
+	, m_sequence(0)
+	, m_flushRequests(0)
+	, m_flushesDone(0)
+	, m_instanceId(CryInterlockedIncrement(&gNumWriterInstances) & 0xffff)
+	, m_mode(eMode_Off)
+	, m_bAccepting(false)
+	, m_bRun(false)
+	, m_pFile(nullptr)
+	, m_bFirstLine(true)
+{
+	memset(m_buffers, 0, sizeof(m_buffers));
+	memset(m_readEnds, 0, sizeof(m_readEnds));
+	memset(m_threadNamesWritten, 0, sizeof(m_threadNamesWritten));
+}
+
+CAsyncLogWriter::~CAsyncLogWriter()
+{
+	Stop();
+
+	for (int i = 0; i < m_numBuffers; ++i)
+	{
+		delete[] m_buffers[i].pData;
+	}
+}
+
+void CAsyncLogWriter::RegisterCVars()
+{
+	REGISTER_CVAR2("log_AsyncFlushMs", &CV_log_AsyncFlushMs, 100, VF_NULL,
+	               "Interval in milliseconds in which the writer thread of log_Async writes the queued messages to the file");
+	REGISTER_CVAR2("log_AsyncFlushOnError", &CV_log_AsyncFlushOnError, 1, VF_NULL,
+	               "When enabled, the writer thread of log_Async writes warnings and errors to the file right away");
+	REGISTER_CVAR2("log_AsyncBufferSize", &CV_log_AsyncBufferSize, 64, VF_NULL,
+	               "Size in KB of the buffer each thread queues its messages in with log_Async, rounded up to a power of two.\n"
+	               "A thread waits for the writer thread while its buffer is full. Only affects threads logging for the first time.");
+}
+
+void CAsyncLogWriter::GetBinaryFileName(const char* szLogFileName, string& binaryFileName)
+{
+	binaryFileName = PathUtil::ReplaceExtension(szLogFileName, "binlog");
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CAsyncLogWriter::Start(const char* szLogFileName, EMode mode)
+{
+	Stop();
+
+	if (mode == eMode_Off)
+		return false;
+
+	CDebugAllowFileAccess ignoreInvalidFileAccess;
+
+	if (mode == eMode_Binary)
+	{
+		string binaryFileName;
+		GetBinaryFileName(szLogFileName, binaryFileName);
+		m_pFile = fxopen(binaryFileName.c_str(), "wb");
+		if (!m_pFile)
+			return false;
+
+		fwrite(kBinaryLogMagic, sizeof(kBinaryLogMagic), 1, m_pFile);
+		WriteValue(m_pFile, (int64)gEnv->pTimer->GetTicksPerSecond());
+		WriteValue(m_pFile, (int64)CryGetTicks());
+		WriteValue(m_pFile, (int64)time(nullptr));
+		m_formatIds.clear();
+		memset(m_threadNamesWritten, 0, sizeof(m_threadNamesWritten));
+	}
+	else
+	{
+		// appends to the lines written so far, they may not end with a new line
+		m_pFile = fxopen(szLogFileName, "a+b");
+		if (!m_pFile)
+			return false;
+
+		m_bFirstLine = true;
+		if (fseek(m_pFile, -1, SEEK_END) == 0)
+			m_bFirstLine = fgetc(m_pFile) == '\n';
+	}
+	setvbuf(m_pFile, nullptr, _IOFBF, 256 * 1024);
+
+	m_mode = mode;
+	m_bRun = true;
+	if (!gEnv->pThreadManager->SpawnThread(this, "AsyncLogWriter"))
+	{
+		m_bRun = false;
+		m_mode = eMode_Off;
+		fclose(m_pFile);
+		m_pFile = nullptr;
+		return false;
+	}
+
+	MemoryBarrier();
+	m_bAccepting = true;
+	return true;
+}
+
+void CAsyncLogWriter::Stop()
+{
+	if (m_mode == eMode_Off)
+		return;
+
+	// Threads which didn't see m_bAccepting cleared are still writing their message, it's written below.
+	m_bAccepting = false;
+	MemoryBarrier();
+	for (int i = 0; i < m_numBuffers; ++i)
+	{
+		while (m_buffers[i].bWriting)
+			CrySleep(0);
+	}
+
+	m_bRun = false;
+	m_wakeUp.Set();
+	gEnv->pThreadManager->JoinThread(this, eJM_Join);
+
+	if (m_mode == eMode_Text && !m_bFirstLine)
+		fputc('\n', m_pFile);
+	fclose(m_pFile);
+	m_pFile = nullptr;
+	m_mode = eMode_Off;
+
+	LONG numStalls = 0;
+	for (int i = 0; i < m_numBuffers; ++i)
+	{
+		numStalls += CryInterlockedExchange(&m_buffers[i].numStalls, 0);
+	}
+	if (numStalls)
+	{
+		CryLogAlways("Async log: threads waited %d times for the writer thread, increase log_AsyncBufferSize or decrease log_AsyncFlushMs", (int)numStalls);
+	}
+}
+
+void CAsyncLogWriter::Flush(uint32 timeoutMs)
+{
+	if (m_mode == eMode_Off)
+		return;
+
+	const LONG request = CryInterlockedIncrement(&m_flushRequests);
+	m_wakeUp.Set();
+
+	const int64 endTicks = CryGetTicks() + gEnv->pTimer->GetTicksPerSecond() * timeoutMs / 1000;
+	while ((int32)(m_flushesDone - request) < 0 && m_bRun && CryGetTicks() < endTicks)
+	{
+		CrySleep(1);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CAsyncLogWriter::WriteText(const char* szText, bool bAdd, bool bError)
+{
+	SThreadBuffer* pBuffer = GetThreadBuffer();
+	if (!pBuffer)
+		return false;
+
+	// the writer thread starts each line with the new line of the previous one
+	uint32 length = (uint32)strlen(szText);
+	if (length && szText[length - 1] == '\n')
+		--length;
+
+	pBuffer->bWriting = 1;
+	MemoryBarrier();
+	SRecord* pRecord = m_bAccepting ? BeginRecord(pBuffer, sizeof(SRecord) + length) : nullptr;
+	if (!pRecord)
+	{
+		pBuffer->bWriting = 0;
+		return false;
+	}
+
+	pRecord->kind = eRK_Text;
+	pRecord->logType = 0;
+	pRecord->flags = (bAdd ? eRF_Add : 0) | (bError ? eRF_Error : 0);
+	pRecord->textLength = length;
+	pRecord->argBytes = 0;
+	memcpy(pRecord + 1, szText, length);
+
+	EndRecord(pBuffer, pRecord);
+	pBuffer->bWriting = 0;
+
+	if (bError && CV_log_AsyncFlushOnError)
+		m_wakeUp.Set();
+	return true;
+}
+
+bool CAsyncLogWriter::WriteBinary(uint8 logType, const char* szFormat, va_list args)
+{
+	SThreadBuffer* pBuffer = GetThreadBuffer();
+	if (!pBuffer)
+		return false;
+
+	uint8 argData[1024];
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	const int argBytes = EncodeArgs(szFormat, argsCopy, argData, sizeof(argData));
+	va_end(argsCopy);
+	if (argBytes < 0)
+		return false;
+
+	// the format is copied as well, it isn't necessarily a literal
+	const uint32 formatLength = (uint32)strlen(szFormat);
+
+	pBuffer->bWriting = 1;
+	MemoryBarrier();
+	SRecord* pRecord = m_bAccepting ? BeginRecord(pBuffer, sizeof(SRecord) + formatLength + argBytes) : nullptr;
+	if (!pRecord)
+	{
+		pBuffer->bWriting = 0;
+		return false;
+	}
+
+	pRecord->kind = eRK_Binary;
+	pRecord->logType = logType;
+	pRecord->flags = 0;
+	pRecord->textLength = formatLength;
+	pRecord->argBytes = argBytes;
+	memcpy(pRecord + 1, szFormat, formatLength);
+	memcpy((uint8*)(pRecord + 1) + formatLength, argData, argBytes);
+
+	EndRecord(pBuffer, pRecord);
+	pBuffer->bWriting = 0;
+	return true;
+}
+
+CAsyncLogWriter::SThreadBuffer* CAsyncLogWriter::GetThreadBuffer()
+{
+	const uint32 key = gThreadBufferKey;
+	if ((key >> 16) == m_instanceId)
+		return &m_buffers[(key & 0xffff) - 1];
+
+	if (m_numBuffers == eMaxThreadBuffers)
+		return nullptr;
+
+	AUTO_LOCK(m_lock);
+
+	if (m_numBuffers == eMaxThreadBuffers)
+		return nullptr;
+
+	uint32 size = 4096;
+	while (size < (uint32)CV_log_AsyncBufferSize * 1024)
+		size <<= 1;
+
+	SThreadBuffer& buffer = m_buffers[m_numBuffers];
+	buffer.threadId = CryGetCurrentThreadId();
+	buffer.pData = new uint8[size];
+	buffer.mask = size - 1;
+	buffer.writePos = 0;
+	buffer.readPos = 0;
+	buffer.bWriting = 0;
+	buffer.numStalls = 0;
+	buffer.nextWritePos = 0;
+
+	// Publish after the buffer is set up, the writer thread reads m_numBuffers without the lock.
+	MemoryBarrier();
+	++m_numBuffers;
+	gThreadBufferKey = (m_instanceId << 16) | (uint32)m_numBuffers;
+	return &buffer;
+}
+
+CAsyncLogWriter::SRecord* CAsyncLogWriter::BeginRecord(SThreadBuffer* pBuffer, uint32 size)
+{
+	size = Align(size, 8);
+	const uint32 capacity = pBuffer->mask + 1;
+	if (size > capacity / 2)
+		return nullptr;
+
+	// Single producer: only this thread moves writePos, the writer thread only moves readPos.
+	LONG writePos = pBuffer->writePos;
+	uint32 offset = writePos & pBuffer->mask;
+	const uint32 contiguous = capacity - offset;
+	const uint32 needed = size > contiguous ? size + contiguous : size;
+
+	if (capacity - (uint32)(writePos - pBuffer->readPos) < needed)
+	{
+		CryInterlockedIncrement(&pBuffer->numStalls);
+		do
+		{
+			m_wakeUp.Set();
+			CrySleep(1);
+		}
+		while (capacity - (uint32)(writePos - pBuffer->readPos) < needed);
+	}
+	// Don't write into the space before the writer thread is done with it.
+	MemoryBarrier();
+
+	if (size > contiguous)
+	{
+		SRecord* pPadding = (SRecord*)(pBuffer->pData + offset);
+		pPadding->size = contiguous;
+		pPadding->kind = eRK_Padding;
+		writePos += contiguous;
+		offset = 0;
+	}
+
+	SRecord* pRecord = (SRecord*)(pBuffer->pData + offset);
+	pRecord->size = size;
+	pBuffer->nextWritePos = writePos + size;
+	return pRecord;
+}
+
+void CAsyncLogWriter::EndRecord(SThreadBuffer* pBuffer, SRecord* pRecord)
+{
+	pRecord->sequence = CryInterlockedIncrement(&m_sequence);
+	pRecord->ticks = CryGetTicks();
+
+	const uint32 halfCapacity = (pBuffer->mask + 1) / 2;
+	const bool bWakeUp = (uint32)(pBuffer->writePos - pBuffer->readPos) < halfCapacity && (uint32)(pBuffer->nextWritePos - pBuffer->readPos) >= halfCapacity;
+
+	MemoryBarrier();
+	pBuffer->writePos = pBuffer->nextWritePos;
+
+	// the writer thread is woken up once when the buffer gets half full
+	if (bWakeUp)
+		m_wakeUp.Set();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CAsyncLogWriter::ThreadEntry()
+{
+	while (m_bRun)
+	{
+		m_wakeUp.Wait(max(CV_log_AsyncFlushMs, 1));
+
+		const LONG flushRequests = m_flushRequests;
+		MemoryBarrier();
+		if (WriteQueued())
+			fflush(m_pFile);
+		m_flushesDone = flushRequests;
+	}
+
+	WriteQueued();
+	fflush(m_pFile);
+	m_flushesDone = m_flushRequests;
+}
+
+bool CAsyncLogWriter::WriteQueued()
+{
+	const LONG numBuffers = m_numBuffers;
+	MemoryBarrier();
+
+	m_pending.clear();
+	for (LONG i = 0; i < numBuffers; ++i)
+	{
+		SThreadBuffer& buffer = m_buffers[i];
+		const LONG writePos = buffer.writePos;
+		MemoryBarrier();
+
+		for (LONG pos = buffer.readPos; pos != writePos; )
+		{
+			const SRecord* pRecord = (const SRecord*)(buffer.pData + (pos & buffer.mask));
+			if (pRecord->kind != eRK_Padding)
+			{
+				SPendingRecord pending = { pRecord, (uint32)i, pRecord->sequence };
+				m_pending.push_back(pending);
+			}
+			pos += pRecord->size;
+		}
+		m_readEnds[i] = writePos;
+	}
+
+	// In the order the messages were logged. A message which got its number but wasn't published
+	// in time is written with the next batch, after messages logged later by other threads.
+	std::sort(m_pending.begin(), m_pending.end());
+
+	for (size_t i = 0; i < m_pending.size(); ++i)
+	{
+		if (m_mode == eMode_Binary)
+			WriteBinaryRecord(*m_pending[i].pRecord, m_pending[i].bufferIndex);
+		else
+			WriteTextRecord(*m_pending[i].pRecord);
+	}
+
+	// Hand the space back to the threads only after the records are written out.
+	MemoryBarrier();
+	for (LONG i = 0; i < numBuffers; ++i)
+	{
+		m_buffers[i].readPos = m_readEnds[i];
+	}
+
+	return !m_pending.empty();
+}
+
+void CAsyncLogWriter::WriteTextRecord(const SRecord& record)
+{
+	if (!m_bFirstLine && !(record.flags & eRF_Add))
+		fputc('\n', m_pFile);
+	m_bFirstLine = false;
+
+	const char* pText = (const char*)(&record + 1);
+	if (record.kind == eRK_Text)
+	{
+		fwrite(pText, 1, record.textLength, m_pFile);
+	}
+	else
+	{
+		const string format(pText, record.textLength);
+		string text;
+		DecodeArgs(format.c_str(), (const uint8*)pText + record.textLength, record.argBytes, text);
+		fputs(text.c_str(), m_pFile);
+	}
+}
+
+void CAsyncLogWriter::WriteBinaryRecord(const SRecord& record, uint32 bufferIndex)
+{
+	const uint64 threadId = (uint64)m_buffers[bufferIndex].threadId;
+	if (!m_threadNamesWritten[bufferIndex])
+	{
+		m_threadNamesWritten[bufferIndex] = true;
+		const char* szName = gEnv->pThreadManager->GetThreadName(m_buffers[bufferIndex].threadId);
+		const uint32 length = szName ? (uint32)strlen(szName) : 0;
+		WriteValue(m_pFile, (uint8)eET_ThreadName);
+		WriteValue(m_pFile, threadId);
+		WriteValue(m_pFile, length);
+		fwrite(szName, 1, length, m_pFile);
+	}
+
+	const char* pText = (const char*)(&record + 1);
+	if (record.kind == eRK_Text)
+	{
+		WriteValue(m_pFile, (uint8)eET_Text);
+		WriteValue(m_pFile, record.ticks);
+		WriteValue(m_pFile, threadId);
+		WriteValue(m_pFile, record.logType);
+		WriteValue(m_pFile, record.flags);
+		WriteValue(m_pFile, record.textLength);
+		fwrite(pText, 1, record.textLength, m_pFile);
+	}
+	else
+	{
+		const uint32 formatId = GetFormatId(pText, record.textLength);
+		WriteValue(m_pFile, (uint8)eET_Message);
+		WriteValue(m_pFile, record.ticks);
+		WriteValue(m_pFile, threadId);
+		WriteValue(m_pFile, record.logType);
+		WriteValue(m_pFile, record.flags);
+		WriteValue(m_pFile, formatId);
+		WriteValue(m_pFile, record.argBytes);
+		fwrite(pText + record.textLength, 1, record.argBytes, m_pFile);
+	}
+}
+
+uint32 CAsyncLogWriter::GetFormatId(const char* szFormat, uint32 length)
+{
+	const string format(szFormat, length);
+	std::map<string, uint32>::const_iterator it = m_formatIds.find(format);
+	if (it != m_formatIds.end())
+		return it->second;
+
+	// each format string is written once, before the first message using it
+	const uint32 formatId = (uint32)m_formatIds.size();
+	m_formatIds[format] = formatId;
+	WriteValue(m_pFile, (uint8)eET_Format);
+	WriteValue(m_pFile, formatId);
+	WriteValue(m_pFile, length);
+	fwrite(szFormat, 1, length, m_pFile);
+	return formatId;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CAsyncLogWriter::DecodeBinary(const char* szBinaryFileName, const char* szTextFileName)
+{
+	CDebugAllowFileAccess ignoreInvalidFileAccess;
+
+	std::vector<uint8> data;
+	if (FILE* pIn = fxopen(szBinaryFileName, "rb"))
+	{
+		fseek(pIn, 0, SEEK_END);
+		const long size = ftell(pIn);
+		fseek(pIn, 0, SEEK_SET);
+		if (size > 0)
+		{
+			data.resize(size);
+			data.resize(fread(&data[0], 1, size, pIn));
+		}
+		fclose(pIn);
+	}
+
+	SBinaryLogReader reader = { data.empty() ? nullptr : &data[0], data.empty() ? nullptr : &data[0] + data.size() };
+	const uint8* pMagic;
+	int64 ticksPerSecond, startTicks, startTime;
+	if (!reader.ReadBytes(pMagic, sizeof(kBinaryLogMagic)) || memcmp(pMagic, kBinaryLogMagic, sizeof(kBinaryLogMagic))
+	    || !reader.Read(ticksPerSecond) || !reader.Read(startTicks) || !reader.Read(startTime) || ticksPerSecond <= 0)
+	{
+		return false;
+	}
+
+	FILE* pOut = fxopen(szTextFileName, "wt");
+	if (!pOut)
+		return false;
+
+	char szStartTime[64] = "";
+	const time_t logStartTime = (time_t)startTime;
+	strftime(szStartTime, sizeof(szStartTime), "%Y-%m-%d %H:%M:%S", localtime(&logStartTime));
+	fprintf(pOut, "Binary log started %s", szStartTime);
+
+	std::vector<string> formats;
+	std::map<uint64, string> threadNames;
+	string text;
+
+	// A log written until a crash may end in the middle of an entry.
+	uint8 tag;
+	while (reader.Read(tag))
+	{
+		uint32 id, length;
+		uint64 threadId;
+		int64 ticks;
+		uint8 logType, flags;
+		const uint8* pBytes;
+
+		if (tag == eET_Format)
+		{
+			if (!reader.Read(id) || !reader.Read(length) || !reader.ReadBytes(pBytes, length))
+				break;
+			if (id >= formats.size())
+				formats.resize(id + 1);
+			formats[id].assign((const char*)pBytes, length);
+			continue;
+		}
+		if (tag == eET_ThreadName)
+		{
+			if (!reader.Read(threadId) || !reader.Read(length) || !reader.ReadBytes(pBytes, length))
+				break;
+			threadNames[threadId].assign((const char*)pBytes, length);
+			continue;
+		}
+		if ((tag != eET_Text && tag != eET_Message) || !reader.Read(ticks) || !reader.Read(threadId) || !reader.Read(logType) || !reader.Read(flags))
+			break;
+
+		text.clear();
+		if (tag == eET_Text)
+		{
+			if (!reader.Read(length) || !reader.ReadBytes(pBytes, length))
+				break;
+			text.assign((const char*)pBytes, length);
+		}
+		else
+		{
+			uint32 argBytes;
+			if (!reader.Read(id) || !reader.Read(argBytes) || !reader.ReadBytes(pBytes, argBytes))
+				break;
+			if (id >= formats.size() || !DecodeArgs(formats[id].c_str(), pBytes, argBytes, text))
+				text.Format("<can't decode message with format %u>", id);
+		}
+
+		if (flags & eRF_Add)
+		{
+			fputs(text.c_str(), pOut);
+		}
+		else
+		{
+			const std::map<uint64, string>::const_iterator itName = threadNames.find(threadId);
+			const double seconds = (double)(ticks - startTicks) / (double)ticksPerSecond;
+			if (itName != threadNames.end() && !itName->second.empty())
+				fprintf(pOut, "\n<%.3f> [%s] %s", seconds, itName->second.c_str(), text.c_str());
+			else
+				fprintf(pOut, "\n<%.3f> [%" PRIu64 "] %s", seconds, threadId, text.c_str());
+		}
+	}
+
+	fputc('\n', pOut);
+	fclose(pOut);
+	return true;
+}
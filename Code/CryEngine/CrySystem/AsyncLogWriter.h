@@ -0,0 +1,147 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Writes the log file on its own thread. Every thread appends
+//               its messages to a lock-free ring buffer of its own, the
+//               writer thread merges them in the order they were logged and
+//               writes them in batches. In binary mode the format string and
+//               the arguments are written instead of the formatted text.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __asynclogwriter_h__
+#define __asynclogwriter_h__
+#pragma once
+
+#include <CryThreading/IThreadManager.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+class CAsyncLogWriter : public IThread
+{
+public:
+	enum EMode
+	{
+		eMode_Off,
+		eMode_Text,   // the log file, formatted by the calling thread
+		eMode_Binary, // <log file>.binlog, to be decoded with log_DecodeBinary
+	};
+
+	CAsyncLogWriter();
+	~CAsyncLogWriter();
+
+	static void  RegisterCVars();
+
+	// Only to be called by the main thread
+	bool         Start(const char* szLogFileName, EMode mode);
+	void         Stop();
+
+	EMode        GetMode() const   { return m_mode; }
+	bool         IsRunning() const { return m_mode != eMode_Off; }
+
+	// Return false if the message can't be queued, then the caller has to write it itself.
+	bool WriteText(const char* szText, bool bAdd, bool bError);
+	bool WriteBinary(uint8 logType, const char* szFormat, va_list args);
+
+	// Waits until the messages queued so far are written and flushed to the file
+	void Flush(uint32 timeoutMs = 10000);
+
+	// Formats the messages of a binary log into a text file
+	static bool DecodeBinary(const char* szBinaryFileName, const char* szTextFileName);
+
+	static void GetBinaryFileName(const char* szLogFileName, string& binaryFileName);
+
+protected:
+	// IThread
+	virtual void ThreadEntry();
+
+private:
+	enum { eMaxThreadBuffers = 256 };
+
+	enum ERecordKind
+	{
+		eRK_Padding,
+		eRK_Text,
+		eRK_Binary,
+	};
+
+	enum ERecordFlags
+	{
+		eRF_Add   = BIT(0),
+		eRF_Error = BIT(1),
+	};
+
+	// Followed by the text or by the format string and the encoded arguments, the size is a multiple of 8.
+	struct SRecord
+	{
+		uint32 size;
+		uint8  kind;
+		uint8  logType;
+		uint8  flags;
+		uint8  padding;
+		LONG   sequence;
+		uint32 textLength;
+		int64  ticks;
+		uint32 argBytes;
+		uint32 padding2;
+	};
+
+	// Written only by the thread owning it and read only by the writer thread.
+	// The buffers live as long as the writer, so a thread keeps its buffer when the writer is restarted.
+	struct SThreadBuffer
+	{
+		threadID      threadId;
+		uint8*        pData;
+		uint32        mask;
+		volatile LONG writePos;
+		volatile LONG readPos;
+		volatile LONG bWriting;     // set while the thread writes, Stop waits for it
+		volatile LONG numStalls;    // times the thread waited for the writer thread
+		LONG          nextWritePos; // of the record being written
+	};
+
+	struct SPendingRecord
+	{
+		const SRecord* pRecord;
+		uint32         bufferIndex;
+		LONG           sequence;
+
+		bool operator<(const SPendingRecord& other) const { return (int32)(sequence - other.sequence) < 0; }
+	};
+
+	SThreadBuffer* GetThreadBuffer();
+	SRecord*       BeginRecord(SThreadBuffer* pBuffer, uint32 size);
+	void           EndRecord(SThreadBuffer* pBuffer, SRecord* pRecord);
+
+	bool           WriteQueued();
+	void           WriteTextRecord(const SRecord& record);
+	void           WriteBinaryRecord(const SRecord& record, uint32 bufferIndex);
+	uint32         GetFormatId(const char* szFormat, uint32 length);
+
+	CryEvent                        m_wakeUp;
+	CryCriticalSection              m_lock; // guards buffer creation
+	SThreadBuffer                   m_buffers[eMaxThreadBuffers];
+	LONG                            m_readEnds[eMaxThreadBuffers];
+	bool                            m_threadNamesWritten[eMaxThreadBuffers];
+	volatile LONG                   m_numBuffers;
+	volatile LONG                   m_sequence;
+	volatile LONG                   m_flushRequests;
+	volatile LONG                   m_flushesDone;
+	uint32                          m_instanceId;
+
+	EMode                           m_mode;
+	volatile bool                   m_bAccepting;
+	volatile bool                   m_bRun;
+	FILE*                           m_pFile;
+	bool                            m_bFirstLine;
+
+	std::vector<SPendingRecord>     m_pending;
+	std::map<string, uint32>        m_formatIds;
+
+	static int                      CV_log_AsyncFlushMs;
+	static int                      CV_log_AsyncFlushOnError;
+	static int                      CV_log_AsyncBufferSize;
+};
+
+#endif
@@ -29,6 +29,18 @@ const char c_sys_budget_numdrawcalls[] = "sys_budget_numdrawcalls";
 const char c_sys_budget_numpolys[] = "sys_budget_numpolys";
 const char c_sys_budget_streamingthroughput[] = "sys_budget_streamingthroughput";
 
+// indexed by EServerFrameStage, default limits are meant for a 30Hz dedicated server
+const char* const c_sys_budget_server[eSFS_Count] =
+{
+	"sys_budget_server_netrecv",
+	"sys_budget_server_gamerules",
+	"sys_budget_server_entity",
+	"sys_budget_server_physics",
+	"sys_budget_server_ai",
+	"sys_budget_server_netsend",
+};
+const float c_serverFrameStageDefaultLimitInMS[eSFS_Count] = { 2.0f, 4.0f, 8.0f, 8.0f, 6.0f, 3.0f };
+
 CBudgetingSystem::CBudgetingSystem()
 	: m_pRenderer(0)
 	, m_pAuxRenderer(0)
@@ -47,6 +59,9 @@ CBudgetingSystem::CBudgetingSystem()
 	, m_width(0)
 	, m_height(0)
 {
+	for (int i = 0; i < eSFS_Count; ++i)
+		m_serverFrameStageLimitInMS[i] = c_serverFrameStageDefaultLimitInMS[i];
+
 	IConsole* pConsole(gEnv->pConsole);
 	if (0 != pConsole)
 	{
@@ -59,6 +74,8 @@ CBudgetingSystem::CBudgetingSystem()
 		REGISTER_CVAR2(c_sys_budget_numdrawcalls, &m_numDrawCallsLimit, m_numDrawCallsLimit, VF_DUMPTODISK, "Sets the upper limit for number of draw calls per frame.");
 		REGISTER_CVAR2(c_sys_budget_numpolys, &m_numPolysLimit, m_numPolysLimit, VF_DUMPTODISK, "Sets the upper limit for number of polygons per frame.");
 		REGISTER_CVAR2(c_sys_budget_streamingthroughput, &m_streamingThroughputLimit, m_streamingThroughputLimit, VF_DUMPTODISK, "Sets the upper limit for streaming throughput(KB/s).");
+		for (int i = 0; i < eSFS_Count; ++i)
+			REGISTER_CVAR2(c_sys_budget_server[i], &m_serverFrameStageLimitInMS[i], m_serverFrameStageLimitInMS[i], VF_DUMPTODISK, "Sets the upper limit for the time (in ms) of this stage of a dedicated server frame.");
 	}
 
 	RegisterWithPerfHUD();
@@ -101,6 +118,8 @@ CBudgetingSystem::Release()
 		pConsole->UnregisterVariable(c_sys_budget_numdrawcalls);
 		pConsole->UnregisterVariable(c_sys_budget_numpolys);
 		pConsole->UnregisterVariable(c_sys_budget_streamingthroughput);
+		for (int i = 0; i < eSFS_Count; ++i)
+			pConsole->UnregisterVariable(c_sys_budget_server[i]);
 	}
 
 	delete this;
@@ -161,6 +180,13 @@ CBudgetingSystem::SetBudget(int sysMemLimitInMB, int videoMemLimitInMB,
 	m_numDrawCallsLimit = numDrawCallsLimit;
 }
 
+void
+CBudgetingSystem::SetServerFrameStageLimit(EServerFrameStage stage, float stageTimeLimitInMS)
+{
+	assert(stage >= 0 && stage < eSFS_Count);
+	m_serverFrameStageLimitInMS[stage] = stageTimeLimitInMS;
+}
+
 int
 CBudgetingSystem::GetSysMemLimit() const
 {
@@ -216,6 +242,13 @@ CBudgetingSystem::GetBudget(int& sysMemLimitInMB, int& videoMemLimitInMB,
 	numDrawCallsLimit = m_numDrawCallsLimit;
 }
 
+float
+CBudgetingSystem::GetServerFrameStageLimit(EServerFrameStage stage) const
+{
+	assert(stage >= 0 && stage < eSFS_Count);
+	return(m_serverFrameStageLimitInMS[stage]);
+}
+
 void
 CBudgetingSystem::MonitorBudget()
 {
@@ -29,6 +29,7 @@ public:
 	virtual void SetStreamingThroughputLimit(float streamingThroughputLimit);
 	virtual void SetBudget(int sysMemLimitInMB, int videoMemLimitInMB,
 	                       float frameTimeLimitInMS, int soundChannelsPlayingLimit, int SoundMemLimitInMB, int SoundCPULimit, int numDrawCallsLimit);
+	virtual void SetServerFrameStageLimit(EServerFrameStage stage, float stageTimeLimitInMS);
 
 	virtual int   GetSysMemLimit() const;
 	virtual int   GetVideoMemLimit() const;
@@ -40,6 +41,7 @@ public:
 	virtual float GetStreamingThroughputLimit() const;
 	virtual void  GetBudget(int& sysMemLimitInMB, int& videoMemLimitInMB,
 	                        float& frameTimeLimitInMS, int& soundChannelsPlayingLimit, int& SoundMemLimitInMB, int& SoundCPULimitInPercent, int& numDrawCallsLimit) const;
+	virtual float GetServerFrameStageLimit(EServerFrameStage stage) const;
 
 	virtual void MonitorBudget();
 	virtual void Render(float x, float y);
@@ -85,6 +87,7 @@ protected:
 	int             m_numDrawCallsLimit;
 	int             m_numPolysLimit;
 	float           m_streamingThroughputLimit;
+	float           m_serverFrameStageLimitInMS[eSFS_Count];
 	int             m_width;
 	int             m_height;
 };
@@ -138,6 +138,18 @@ static inline void __cpuid(int CPUInfo[4], int InfoType)
 {
 	asm volatile ("cpuid" : "=a" (*CPUInfo), "=b" (*(CPUInfo + 1)), "=c" (*(CPUInfo + 2)), "=d" (*(CPUInfo + 3)) : "a" (InfoType));
 }
+
+static inline void __cpuidex(int CPUInfo[4], int InfoType, int SubLeaf)
+{
+	asm volatile ("cpuid" : "=a" (*CPUInfo), "=b" (*(CPUInfo + 1)), "=c" (*(CPUInfo + 2)), "=d" (*(CPUInfo + 3)) : "a" (InfoType), "c" (SubLeaf));
+}
+
+static inline uint64 _xgetbv(unsigned int Index)
+{
+	uint32 eax, edx;
+	asm volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (Index));
+	return ((uint64)edx << 32) | eax;
+}
 #endif // CRY_PLATFORM_MAC
 
 bool IsAMD()
@@ -345,6 +357,23 @@ unsigned long GetCPUFeatureSet()
 			features |= CFI_SSE;
 		if (CPUInfo[2] & (1 << 0))
 			features |= CFI_SSE3;
+
+		// the wide registers are only usable if the OS saves them (OSXSAVE and the state bits in XCR0)
+		const bool bOSXSave = (CPUInfo[2] & (1 << 27)) != 0;
+		const uint64 xcr0 = bOSXSave ? _xgetbv(0) : 0;
+		const bool bOSSavesYmm = (xcr0 & 0x6) == 0x6;
+		const bool bOSSavesZmm = (xcr0 & 0xe6) == 0xe6;
+		if ((CPUInfo[2] & (1 << 28)) && bOSSavesYmm)
+			features |= CFI_AVX;
+
+		if (nIds >= 7 && (features & CFI_AVX))
+		{
+			__cpuidex(CPUInfo, 0x00000007, 0);
+			if (CPUInfo[1] & (1 << 5))
+				features |= CFI_AVX2;
+			if ((CPUInfo[1] & (1 << 16)) && bOSSavesZmm)
+				features |= CFI_AVX512;
+		}
 	}
 
 	if (nExIds > 0x80000000)
@@ -1680,6 +1709,22 @@ void CCpuFeatures::Detect(void)
 				{
 					m_Cpu[nCpu].mFeatures |= CFI_SSE2;
 				}
+
+				// the kernel only reports these when it saves the wide registers
+				if (strstr(buffer + index, " avx"))
+				{
+					m_Cpu[nCpu].mFeatures |= CFI_AVX;
+				}
+
+				if (strstr(buffer + index, " avx2"))
+				{
+					m_Cpu[nCpu].mFeatures |= CFI_AVX2;
+				}
+
+				if (strstr(buffer + index, " avx512f"))
+				{
+					m_Cpu[nCpu].mFeatures |= CFI_AVX512;
+				}
 			}
 		}
 		m_NumLogicalProcessors = m_NumAvailProcessors = nCpu + 1;
@@ -1795,6 +1840,9 @@ void CCpuFeatures::Detect(void)
 		CryLogAlways("  SSE: %s", (p->mFeatures & CFI_SSE) ? "present" : "not present");
 		CryLogAlways("  SSE2: %s", (p->mFeatures & CFI_SSE2) ? "present" : "not present");
 		CryLogAlways("  SSE3: %s", (p->mFeatures & CFI_SSE3) ? "present" : "not present");
+		CryLogAlways("  AVX: %s", (p->mFeatures & CFI_AVX) ? "present" : "not present");
+		CryLogAlways("  AVX2: %s", (p->mFeatures & CFI_AVX2) ? "present" : "not present");
+		CryLogAlways("  AVX-512: %s", (p->mFeatures & CFI_AVX512) ? "present" : "not present");
 		if (p->mbSerialPresent)
 			CryLogAlways("  Serial number: %s", p->mSerialNumber);
 		else
@@ -1818,5 +1866,8 @@ void CCpuFeatures::Detect(void)
 	if (hasSSE())   g_CpuFlags |= CPUF_SSE;
 	if (hasSSE2())  g_CpuFlags |= CPUF_SSE2;
 	if (hasSSE3())  g_CpuFlags |= CPUF_SSE3;
+	if (hasAVX())   g_CpuFlags |= CPUF_AVX;
+	if (hasAVX2())  g_CpuFlags |= CPUF_AVX2;
+	if (hasAVX512()) g_CpuFlags |= CPUF_AVX512;
 	if (has3DNow()) g_CpuFlags |= CPUF_3DNOW;
 }
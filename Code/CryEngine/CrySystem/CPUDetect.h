@@ -27,6 +27,9 @@
 #define CFI_SSE          8
 #define CFI_SSE2         0x10
 #define CFI_SSE3         0x20
+#define CFI_AVX          0x40
+#define CFI_AVX2         0x80
+#define CFI_AVX512       0x100
 
 /// Type of Cpu Vendor.
 enum ECpuVendor
@@ -136,6 +139,9 @@ public:
 	bool         hasSSE()                              { return (m_Cpu[0].mFeatures & CFI_SSE) != 0; }
 	bool         hasSSE2()                             { return (m_Cpu[0].mFeatures & CFI_SSE2) != 0; }
 	bool         hasSSE3()                             { return (m_Cpu[0].mFeatures & CFI_SSE3) != 0; }
+	bool         hasAVX()                              { return (m_Cpu[0].mFeatures & CFI_AVX) != 0; }
+	bool         hasAVX2()                             { return (m_Cpu[0].mFeatures & CFI_AVX2) != 0; }
+	bool         hasAVX512()                           { return (m_Cpu[0].mFeatures & CFI_AVX512) != 0; }
 	bool         has3DNow()                            { return (m_Cpu[0].mFeatures & CFI_3DNOW) != 0; }
 	bool         hasMMX()                              { return (m_Cpu[0].mFeatures & CFI_MMX) != 0; }
 
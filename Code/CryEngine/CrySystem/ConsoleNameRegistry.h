@@ -0,0 +1,189 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Case insensitive open addressing hash table from console
+//               names to slots. A slot is created when its name is first
+//               registered or asked for and lives as long as the registry,
+//               so a pointer to it can be cached by callers looking the
+//               name up often and stays valid when the name is registered
+//               again.
+//               Lookups take no lock and can run on any thread. Slots are
+//               created under a lock and published after they are complete;
+//               a grown table replaces the old one, which is kept until the
+//               registry is destroyed, as lookups may still be reading it.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __consolenameregistry_h__
+#define __consolenameregistry_h__
+#pragma once
+
+template<class T>
+class CConsoleNameRegistry
+{
+public:
+	struct SSlot
+	{
+		T*            pValue;     // NULL while nothing is registered with the name
+		volatile LONG numLookups; // counted while con_lookup_stats is on
+		string        name;
+	};
+
+	CConsoleNameRegistry()
+		: m_numSlots(0)
+	{
+		STable* pTable = new STable(eInitialSize);
+		m_tables.push_back(pTable);
+		m_pTable = pTable;
+	}
+
+	~CConsoleNameRegistry()
+	{
+		const std::vector<SEntry>& entries = m_pTable->entries;
+		for (size_t i = 0; i < entries.size(); ++i)
+			delete entries[i].pSlot;
+		for (size_t i = 0; i < m_tables.size(); ++i)
+			delete m_tables[i];
+	}
+
+	// FNV-1a over the lower case name
+	static uint32 HashName(const char* szName)
+	{
+		uint32 hash = 2166136261u;
+		for (; *szName; ++szName)
+			hash = (hash ^ (uint8)::tolower((uint8)*szName)) * 16777619u;
+		return hash;
+	}
+
+	// NULL if the name was never registered or asked for
+	SSlot* FindSlot(const char* szName, uint32 hash) const
+	{
+		const std::vector<SEntry>& entries = m_pTable->entries;
+		const uint32 mask = (uint32)entries.size() - 1;
+		for (uint32 i = hash & mask;; i = (i + 1) & mask)
+		{
+			const SEntry& entry = entries[i];
+			SSlot* pSlot = entry.pSlot;
+			if (!pSlot)
+				return NULL;
+			if (entry.hash == hash && !stricmp(pSlot->name.c_str(), szName))
+				return pSlot;
+		}
+	}
+
+	SSlot* FindSlot(const char* szName) const { return FindSlot(szName, HashName(szName)); }
+
+	// Creates the slot if there is none yet, safe to call from any thread
+	SSlot* GetSlot(const char* szName, uint32 hash)
+	{
+		if (SSlot* pSlot = FindSlot(szName, hash))
+			return pSlot;
+
+		AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+
+		// another thread might have created it meanwhile
+		if (SSlot* pSlot = FindSlot(szName, hash))
+			return pSlot;
+
+		if ((m_numSlots + 1) * 10 > m_pTable->entries.size() * 7)
+			Grow();
+
+		SSlot* pSlot = new SSlot;
+		pSlot->pValue = NULL;
+		pSlot->numLookups = 0;
+		pSlot->name = szName;
+		Insert(m_pTable, hash, pSlot);
+		++m_numSlots;
+		return pSlot;
+	}
+
+	SSlot* GetSlot(const char* szName) { return GetSlot(szName, HashName(szName)); }
+
+	T*     Find(const char* szName) const
+	{
+		const SSlot* pSlot = FindSlot(szName);
+		return pSlot ? pSlot->pValue : NULL;
+	}
+
+	void Set(const char* szName, T* pValue) { GetSlot(szName)->pValue = pValue; }
+
+	// In no particular order, including the slots of unregistered names
+	void GetSlots(std::vector<SSlot*>& slots) const
+	{
+		AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+		const std::vector<SEntry>& entries = m_pTable->entries;
+		slots.reserve(slots.size() + m_numSlots);
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (SSlot* pSlot = entries[i].pSlot)
+				slots.push_back(pSlot);
+		}
+	}
+
+	size_t GetNumSlots() const { return m_numSlots; }
+
+	void   GetMemoryUsage(ICrySizer* pSizer) const
+	{
+		AUTO_LOCK_T(CryCriticalSectionNonRecursive, m_lock);
+		for (size_t i = 0; i < m_tables.size(); ++i)
+			pSizer->AddObject(m_tables[i], sizeof(STable) + m_tables[i]->entries.capacity() * sizeof(SEntry));
+		const std::vector<SEntry>& entries = m_pTable->entries;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (const SSlot* pSlot = entries[i].pSlot)
+				pSizer->AddObject(pSlot, sizeof(SSlot) + pSlot->name.capacity());
+		}
+	}
+
+private:
+	enum { eInitialSize = 1024 }; // a power of two, about as many variables as a game registers
+
+	struct SEntry
+	{
+		SEntry() : hash(0), pSlot(NULL) {}
+
+		uint32          hash;
+		SSlot* volatile pSlot; // set last, a lookup seeing it also sees the hash and the slot contents
+	};
+
+	struct STable
+	{
+		explicit STable(size_t size) : entries(size) {}
+
+		std::vector<SEntry> entries; // size is a power of two, empty entries have no slot
+	};
+
+	// with the lock held
+	void Insert(STable* pTable, uint32 hash, SSlot* pSlot)
+	{
+		std::vector<SEntry>& entries = pTable->entries;
+		const uint32 mask = (uint32)entries.size() - 1;
+		uint32 i = hash & mask;
+		while (entries[i].pSlot)
+			i = (i + 1) & mask;
+		entries[i].hash = hash;
+		CryInterlockedExchangePointer((void* volatile*)&entries[i].pSlot, pSlot);
+	}
+
+	// with the lock held, the new table is filled before it's published
+	void Grow()
+	{
+		const std::vector<SEntry>& entries = m_pTable->entries;
+		STable* pTable = new STable(entries.size() * 2);
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (SSlot* pSlot = entries[i].pSlot)
+				Insert(pTable, entries[i].hash, pSlot);
+		}
+		m_tables.push_back(pTable);
+		CryInterlockedExchangePointer((void* volatile*)&m_pTable, pTable);
+	}
+
+	STable* volatile                       m_pTable;
+	std::vector<STable*>                   m_tables; // all tables ever used, including the current one
+	size_t                                 m_numSlots;
+	mutable CryCriticalSectionNonRecursive m_lock;
+};
+
+#endif
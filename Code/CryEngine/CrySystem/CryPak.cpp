@@ -404,6 +404,7 @@ CCryPak::CCryPak(IMiniLog* pLog, PakVars* pPakVars, const bool bLvlRes, const IG
 	m_eRecordFileOpenList(RFOM_Disabled),
 	m_pPakVars(pPakVars ? pPakVars : &g_cvars.pakVars),
 	m_fFileAcessTime(0.f),
+	m_fLevelLoadStartTime(0.f),
 	m_bLvlRes(bLvlRes),
 	m_renderThreadId(0),
 	m_pWidget(NULL)
@@ -1338,7 +1339,10 @@ const char* CCryPak::AdjustFileNameInternal(const char* src, char* dst, unsigned
 bool CCryPak::CopyFileOnDisk(const char* source, const char* dest, bool bFailIfExist)
 {
 #if CRY_PLATFORM_WINDOWS
-	return ::CopyFile((LPCSTR)source, (LPCSTR)dest, bFailIfExist) == TRUE;
+	const bool bCopied = ::CopyFile((LPCSTR)source, (LPCSTR)dest, bFailIfExist) == TRUE;
+	if (bCopied)
+		m_negativeLookups.Invalidate();
+	return bCopied;
 #else
 	if (bFailIfExist && IsFileExist(dest, eFileLocation_OnDisk))
 		return false;
@@ -1401,6 +1405,24 @@ bool CCryPak::IsFileExist(const char* sFilename, EFileSearchLocation fileLocatio
 		return false;
 	}
 
+	// the pak lookup alone is cheap with the path index, misses are worth remembering when the disk is asked as well
+	if (m_pPakVars->nNegativeLookupCache)
+	{
+		const uint32 nGeneration = m_negativeLookups.GetGeneration();
+		const uint64 nHash = CPakPathIndex::HashPath(szFullPath) + (uint64)fileLocation;
+		if (m_negativeLookups.Contains(nHash))
+			return false;
+		if (IsFileExistInternal(szFullPath, fileLocation, nVarPakPriority))
+			return true;
+		m_negativeLookups.Add(nHash, nGeneration);
+		return false;
+	}
+
+	return IsFileExistInternal(szFullPath, fileLocation, nVarPakPriority);
+}
+
+bool CCryPak::IsFileExistInternal(const char* szFullPath, EFileSearchLocation fileLocation, int nVarPakPriority)
+{
 	if (nVarPakPriority == ePakPriorityFileFirst ||
 	    (nVarPakPriority == ePakPriorityFileFirstModsOnly && IsModPath(szFullPath))) // if the file system files have priority now..
 	{
@@ -1664,6 +1686,10 @@ FILE* CCryPak::FOpen(const char* pName, const char* szMode, unsigned nInputFlags
 		else
 			file = CIOWrapper::FopenLocked(szFullPath, smode);
 
+		// once the file exists, a miss cached by a concurrent lookup before would hide it
+		if (file)
+			m_negativeLookups.Invalidate();
+
 #if !defined(_RELEASE)
 		if (file && g_cvars.pakVars.nLogAllFileAccess)
 		{
@@ -1854,6 +1880,11 @@ ZipDir::FileEntry* CCryPak::FindPakFileEntry(const char* szPath, unsigned int& n
 
 	unsigned nNameLen = (unsigned)strlen(szPath);
 	AUTO_READLOCK(m_csZips);
+
+	ZipDir::FileEntry* pIndexedFileEntry = NULL;
+	if (m_pPakVars->nPathIndex && m_pathIndex.FindFile(szPath, nNameLen, bSkipInMemoryPaks, pIndexedFileEntry, nArchiveFlags, pZip))
+		return pIndexedFileEntry;
+
 	// scan through registered pak files and try to find this file
 	for (ZipArray::reverse_iterator itZip = m_arrZips.rbegin(); itZip != m_arrZips.rend(); ++itZip)
 	{
@@ -2399,6 +2430,8 @@ bool CCryPak::LoadPakToMemory(const char* pName, ICryPak::EInMemoryPakLocation n
 			}
 			else
 			{
+				if (it->pZip->IsMapped())
+					CryLog("Unmapping pak %s, its files are read through stdio from now on", it->GetFullPath());
 				it->pZip->UnloadFromMemory();
 			}
 			return true;
@@ -2424,7 +2457,9 @@ void CCryPak::LoadPaksToMemory(int nMaxPakSize, bool bLoadToMemory)
 		}
 		else
 		{
-			// Unload
+			// Unload, mapped paks included
+			if (itZip->pZip->IsMapped())
+				CryLog("Unmapping pak %s, its files are read through stdio from now on", itZip->GetFullPath());
 			itZip->pZip->UnloadFromMemory();
 		}
 	}
@@ -2548,6 +2583,9 @@ bool CCryPak::OpenPackCommon(const char* szBindRoot, const char* szFullPath, uns
 		m_pLog->LogWithType(IMiniLog::eComment, "Opening pak file %s to %s", szFullPath, szBindRoot ? szBindRoot : "<NIL>");
 		desc.pZip = static_cast<CryArchive*>((ICryArchive*)desc.pArchive)->GetCache();
 
+		if (m_pPakVars->nMappedPaks && !desc.pZip->IsInMemory())
+			desc.pZip->MapToMemory();
+
 		//Append the pak to the end but before any override paks
 		ZipArray::reverse_iterator revItZip = m_arrZips.rbegin();
 		if ((nPakFlags& ICryArchive::FLAGS_OVERRIDE_PAK) == 0)
@@ -2562,6 +2600,8 @@ bool CCryPak::OpenPackCommon(const char* szBindRoot, const char* szFullPath, uns
 		}
 		ZipArray::iterator itZipPlace = revItZip.base();
 		m_arrZips.insert(itZipPlace, desc);
+		m_pathIndex.AddPak(desc.pZip, desc.pArchive, desc.strBindRoot.c_str(), (nPakFlags & ICryArchive::FLAGS_OVERRIDE_PAK) != 0);
+		m_negativeLookups.Invalidate();
 
 #if 0
 		CryLog("---START Pack List: OpenPackCommon '%s' 0x%X---", szFullPath, nPakFlags);
@@ -2601,7 +2641,9 @@ bool CCryPak::ClosePack(const char* pName, unsigned nFlags)
 			bool bResult = (it->pZip->NumRefs() == 2) && it->pArchive->NumRefs() == 1;
 			if (bResult)
 			{
+				m_pathIndex.RemovePak(it->pZip);
 				m_arrZips.erase(it);
+				m_negativeLookups.Invalidate();
 			}
 #if 0
 			CryLog("---START Pack List: ClosePack '%s' 0x%X---", pName, nFlags);
@@ -2927,14 +2969,14 @@ size_t CZipPseudoFile::FRead(void* pDest, size_t nSize, size_t nCount, FILE* hFi
 		}
 		else
 		{
-			unsigned char* pSrc = (unsigned char*)GetFile()->GetData();
+			const unsigned char* pSrc = (const unsigned char*)GetFile()->GetReadOnlyData();
 			if (!pSrc)
 				return 0;
 			pSrc += m_nCurSeek;
 			m_nCurSeek += nTotal;
 
 			unsigned char* itDest = (unsigned char*)pDest;
-			unsigned char* itSrc = pSrc, * itSrcEnd = pSrc + nTotal;
+			const unsigned char* itSrc = pSrc, * itSrcEnd = pSrc + nTotal;
 			nTotal = 0;
 			for (; itSrc != itSrcEnd; ++itSrc)
 			{
@@ -2996,7 +3038,7 @@ int CZipPseudoFile::FScanfv(const char* szFormat, va_list args)
 {
 	if (!GetFile())
 		return 0;
-	char* pSrc = (char*)GetFile()->GetData();
+	const char* pSrc = (const char*)GetFile()->GetReadOnlyData();
 	if (!pSrc)
 		return 0;
 	// now scan the pSrc+m_nCurSeek
@@ -3008,7 +3050,7 @@ char* CZipPseudoFile::FGets(char* pBuf, int n)
 	if (!GetFile())
 		return NULL;
 
-	char* pData = (char*)GetFile()->GetData();
+	const char* pData = (const char*)GetFile()->GetReadOnlyData();
 	if (!pData)
 		return NULL;
 	int nn = 0;
@@ -3040,7 +3082,7 @@ int CZipPseudoFile::Getc()
 {
 	if (!GetFile())
 		return EOF;
-	char* pData = (char*)GetFile()->GetData();
+	const char* pData = (const char*)GetFile()->GetReadOnlyData();
 	if (!pData)
 		return EOF;
 	int c = EOF;
@@ -3069,6 +3111,7 @@ CCachedFileData::CCachedFileData(class CCryPak* pPak, ZipDir::Cache* pZip, unsig
 	m_pPak = pPak;
 	m_nArchiveFlags = nArchiveFlags;
 	m_pFileData = NULL;
+	m_pMappedData = NULL;
 	m_pZip = pZip;
 	m_pFileEntry = pFileEntry;
 
@@ -3096,6 +3139,8 @@ CCachedFileData::~CCachedFileData()
 		g_pPakHeap->FreeTemporary(m_pFileData);
 		m_pFileData = NULL;
 	}
+	m_pMappedData = NULL;
+	m_pMappedBlock = NULL;
 
 	m_pZip = NULL;
 	m_pFileEntry = NULL;
@@ -3174,6 +3219,32 @@ void* CCachedFileData::GetData(bool bRefreshCache, const bool decompress /* = tr
 	return m_pFileData;
 }
 
+//////////////////////////////////////////////////////////////////////////
+const void* CCachedFileData::GetReadOnlyData()
+{
+	if (m_pFileData || m_pMappedData)
+		return m_pFileData ? m_pFileData : m_pMappedData;
+
+	// stored entries of a mapped pak don't need a copy, the data is returned as view into the mapping
+	if (m_pFileEntry && m_pFileEntry->nMethod == ZipFile::METHOD_STORE && m_pZip->IsMapped())
+	{
+		AUTO_LOCK_CS(m_csDecompressDecryptLock);
+		if (!m_pMappedData)
+		{
+			_smart_ptr<IMemoryBlock> pMappedBlock;
+			if (const void* pMappedData = m_pZip->GetMappedFileData(m_pFileEntry, pMappedBlock))
+			{
+				m_pMappedBlock = pMappedBlock;
+				m_pMappedData = pMappedData;
+			}
+		}
+		if (m_pMappedData)
+			return m_pMappedData;
+	}
+
+	return GetData();
+}
+
 //////////////////////////////////////////////////////////////////////////
 int64 CCachedFileData::ReadData(void* pBuffer, int64 nFileOffset, int64 nReadSize)
 {
@@ -3478,6 +3549,7 @@ void CCryPak::GetMemoryStatistics(ICrySizer* pSizer)
 		AUTO_READLOCK(m_csZips);
 		SIZER_SUBCOMPONENT_NAME(pSizer, "Zips");
 		pSizer->AddObject(m_arrZips);
+		m_pathIndex.GetMemoryUsage(pSizer);
 	}
 
 	{
@@ -4522,6 +4594,28 @@ IMemoryBlock* CCryPak::PoolAllocMemoryBlock(size_t nSize, const char* sUsage, si
 	return new CFilePoolMemoryBlock(nSize, sUsage, nAlign);
 }
 
+#if CRY_PLATFORM_LINUX
+//////////////////////////////////////////////////////////////////////////
+// Resident set of the process, split into pages which are shared with the page cache (e.g. mapped paks) and private ones.
+static bool GetResidentSetSize(uint64& nSharedBytes, uint64& nPrivateBytes)
+{
+	FILE* pFile = fopen("/proc/self/statm", "r");
+	if (!pFile)
+		return false;
+
+	unsigned long nSizePages = 0, nResidentPages = 0, nSharedPages = 0;
+	const bool bRead = fscanf(pFile, "%lu %lu %lu", &nSizePages, &nResidentPages, &nSharedPages) == 3;
+	fclose(pFile);
+	if (!bRead)
+		return false;
+
+	const uint64 nPageSize = (uint64)sysconf(_SC_PAGESIZE);
+	nSharedBytes = nSharedPages * nPageSize;
+	nPrivateBytes = (nResidentPages - nSharedPages) * nPageSize;
+	return true;
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 void CCryPak::OnSystemEvent(ESystemEvent event, UINT_PTR wparam, UINT_PTR lparam)
 {
@@ -4529,12 +4623,21 @@ void CCryPak::OnSystemEvent(ESystemEvent event, UINT_PTR wparam, UINT_PTR lparam
 	{
 	case ESYSTEM_EVENT_LEVEL_LOAD_START:
 		m_fFileAcessTime = 0;
+		m_fLevelLoadStartTime = m_pITimer->GetAsyncCurTime();
 		break;
 	case ESYSTEM_EVENT_LEVEL_LOAD_END:
 		{
 			// Log used time.
 			CryLog("File access time during level loading: %.2f seconds", m_fFileAcessTime);
 			m_fFileAcessTime = 0;
+
+			// to compare mapped and stdio paks (sys_PakMapped)
+			CryLog("Level loading took %.2f seconds, paks %s", m_pITimer->GetAsyncCurTime() - m_fLevelLoadStartTime, m_pPakVars->nMappedPaks ? "mapped" : "read via stdio");
+#if CRY_PLATFORM_LINUX
+			uint64 nSharedBytes = 0, nPrivateBytes = 0;
+			if (GetResidentSetSize(nSharedBytes, nPrivateBytes))
+				CryLog("Resident memory after level loading: %u MB shared with page cache, %u MB private", (uint)(nSharedBytes >> 20), (uint)(nPrivateBytes >> 20));
+#endif
 		}
 		break;
 
@@ -4590,9 +4693,10 @@ EStreamSourceMediaType CCryPak::GetMediaType(ZipDir::Cache* pZip, unsigned int n
 	EStreamSourceMediaType mediaType = eStreamSourceTypeDisc;
 
 	// Highest priority for files that are in memory already and can be loaded very fast.
+	// Mapped paks aren't, reading them may fault the pages in from the disk they live on.
 	if (pZip)
 	{
-		if (pZip->IsInMemory())
+		if (pZip->IsInMemory() && !pZip->IsMapped())
 			mediaType = eStreamSourceTypeMemory;
 		else if (IsInstalledToHDD() || (nArchiveFlags & ICryArchive::FLAGS_ON_HDD))
 			mediaType = eStreamSourceTypeHDD;
@@ -4647,6 +4751,7 @@ bool CCryPak::SetPackAccessible(bool bAccessible, const char* pName, unsigned nF
 	{
 		if (!stricmp(szZipPath, it->GetFullPath()))
 		{
+			m_negativeLookups.Invalidate();
 			return it->pArchive->SetPackAccessible(bAccessible);
 		}
 	}
@@ -4665,6 +4770,7 @@ void CCryPak::SetPacksAccessibleForLevel(const char* sLevelName)
 		const bool bRequired = m_pPakVars->nDisableNonLevelRelatedPaks ? pPlatform->IsPakRequiredForLevel(it->GetFullPath(), sLevelName) : true;
 		it->pArchive->SetPackAccessible(bRequired);
 	}
+	m_negativeLookups.Invalidate();
 }
 
 void CCryPak::CreatePerfHUDWidget()
@@ -4716,7 +4822,7 @@ void CCryPak::CPakFileWidget::Update()
 
 		m_pTable->AddData(0, col, it->pZip->GetFilePath());
 		m_pTable->AddData(1, col, it->strBindRoot.c_str());
-		m_pTable->AddData(2, col, it->pZip->IsInMemory() ? "true" : "false");
+		m_pTable->AddData(2, col, it->pZip->IsMapped() ? "mapped" : it->pZip->IsInMemory() ? "true" : "false");
 		m_pTable->AddData(3, col, (it->pArchive->GetFlags() & ICryArchive::FLAGS_OVERRIDE_PAK) ? "true" : "false");
 	}
 }
@@ -19,6 +19,7 @@
 #include <CrySystem/File/ICryPak.h>
 #include <CrySystem/IMiniLog.h>
 #include "ZipDir.h"
+#include "CryPakPathIndex.h"
 #include "MTSafeAllocator.h"
 #include <CryCore/StlUtils.h>
 #include "PakVars.h"
@@ -42,6 +43,9 @@ struct CCachedFileData : public _i_reference_target_t
 	// by default, if bRefreshCache is true, and the data isn't in the cache already,m
 	// the cache is refreshed. Otherwise, it returns whatever cache is (NULL if the data isn't cached yet)
 	void* GetData(bool bRefreshCache = true, const bool decompress = true, const bool allocateForDecompressed = true, const bool decrypt = true);
+	// Like GetData, but stored entries of a mapped pak are returned as a view into the mapping without a copy.
+	// The view is shared by all opened instances of the file and must not be written to.
+	const void* GetReadOnlyData();
 	// Uncompress file data directly to provided memory.
 	bool  GetDataTo(void* pFileData, int nDataSize, bool bDecompress = true);
 
@@ -80,6 +84,9 @@ struct CCachedFileData : public _i_reference_target_t
 
 public:
 	void* m_pFileData;
+	// view into a mapped pak returned by GetReadOnlyData, m_pMappedBlock keeps the mapping alive
+	const void*              m_pMappedData;
+	_smart_ptr<IMemoryBlock> m_pMappedBlock;
 
 	// the zip file in which this file is opened
 	ZipDir::CachePtr   m_pZip;
@@ -289,6 +296,7 @@ class CCryPak : public ICryPak, public ISystemEventListener
 	typedef std::vector<PackDesc, stl::STLGlobalAllocator<PackDesc>> ZipArray;
 	CryReadModifyLock m_csZips;
 	ZipArray          m_arrZips;
+	CPakPathIndex     m_pathIndex;        // the files of m_arrZips, guarded by m_csZips
 	friend class CCryPakFindData;
 
 protected:
@@ -329,6 +337,7 @@ private:
 
 	ITimer*                             m_pITimer;
 	float                               m_fFileAcessTime;                           // Time used to perform file operations
+	float                               m_fLevelLoadStartTime;                      // Async time when the current level load started
 	std::vector<ICryPakFileAcesssSink*> m_FileAccessSinks;                          // useful for gathering file access statistics
 
 	const PakVars*                      m_pPakVars;
@@ -352,6 +361,9 @@ private:
 	bool        AdjustAliases(char* dst);
 	const char* AdjustFileNameInternal(const char* src, char dst[g_nMaxPath], unsigned nFlags);
 
+	// IsFileExist with the adjusted path, without the negative lookup cache
+	bool        IsFileExistInternal(const char* szFullPath, EFileSearchLocation fileLocation, int nVarPakPriority);
+
 #if CRY_PLATFORM_ANDROID && defined(ANDROID_OBB)
 	static FILE*          m_pMainObbExpFile;  /// Reference to main expansion file.
 	static FILE*          m_pPatchObbExpFile; /// Reference to patch expansion file.
@@ -647,6 +659,8 @@ public: // ---------------------------------------------------------------------
 
 	std::set<uint32, std::less<uint32>, stl::STLGlobalAllocator<uint32>> m_filesCachedOnHDD;
 
+	CPakNegativeLookupCache m_negativeLookups;
+
 	// gets the current pak priority
 	virtual int                    GetPakPriority() override;
 
@@ -0,0 +1,245 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+#include "CryPakPathIndex.h"
+#include <CrySystem/File/ICryPak.h>
+
+namespace
+{
+const uint64 kPathHashSeed = 14695981039346656037ull;
+
+// FNV-1a over the path as ZipDir::FindData::PreFind compares it
+ILINE uint64 HashPathAppend(uint64 nHash, const char* szPath)
+{
+	for (; *szPath; ++szPath)
+	{
+		char c = (char)::tolower(*szPath);
+		if (c == '\\')
+			c = '/';
+		nHash = (nHash ^ (uint8)c) * 1099511628211ull;
+	}
+	return nHash;
+}
+
+// the bind roots of two paks may differ in case or slashes and still have the same files
+bool PathHasPrefix(const char* szPath, const char* szPrefix, size_t nPrefixLen)
+{
+	for (size_t i = 0; i < nPrefixLen; ++i)
+	{
+		char a = (char)::tolower(szPath[i]);
+		char b = (char)::tolower(szPrefix[i]);
+		if (a == '\\')
+			a = '/';
+		if (b == '\\')
+			b = '/';
+		if (a != b || !a)
+			return false;
+	}
+	return true;
+}
+}
+
+//////////////////////////////////////////////////////////////////////////
+CPakPathIndex::CPakPathIndex()
+	: m_nNumUnindexedPaks(0)
+	, m_nPakSequence(0)
+{
+}
+
+CPakPathIndex::~CPakPathIndex()
+{
+	for (size_t i = 0; i < m_paks.size(); ++i)
+	{
+		delete m_paks[i];
+	}
+}
+
+uint64 CPakPathIndex::HashPath(const char* szPath)
+{
+	return HashPathAppend(kPathHashSeed, szPath);
+}
+
+void CPakPathIndex::AddPak(ZipDir::Cache* pZip, ICryArchive* pArchive, const char* szBindRoot, bool bOverride)
+{
+	SPak* pPak = new SPak;
+	pPak->pZip = pZip;
+	pPak->pArchive = pArchive;
+	pPak->strBindRoot = szBindRoot;
+	pPak->nBindRootHash = HashPath(szBindRoot);
+	// same order as the paks are inserted into CCryPak::m_arrZips: above all others, but below the override paks
+	pPak->nPriority = (bOverride ? (1ull << 32) : 0) + ++m_nPakSequence;
+	pPak->bIndexed = pZip->GetRoot() != nullptr;
+
+	std::vector<SPak*>::iterator itInsert = m_paks.end();
+	while (itInsert != m_paks.begin() && (*(itInsert - 1))->nPriority > pPak->nPriority)
+		--itInsert;
+	m_paks.insert(itInsert, pPak);
+
+	if (pPak->bIndexed)
+		IndexDirectory(pPak, pZip->GetRoot(), pPak->nBindRootHash);
+	else
+		++m_nNumUnindexedPaks;
+}
+
+void CPakPathIndex::RemovePak(ZipDir::Cache* pZip)
+{
+	for (std::vector<SPak*>::iterator it = m_paks.begin(); it != m_paks.end(); ++it)
+	{
+		SPak* pPak = *it;
+		if (pPak->pZip != pZip)
+			continue;
+
+		m_paks.erase(it);
+		if (pPak->bIndexed)
+		{
+			char szPath[ICryPak::g_nMaxPath];
+			cry_strcpy(szPath, pPak->strBindRoot.c_str());
+			UnindexDirectory(pPak, pZip->GetRoot(), pPak->nBindRootHash, szPath, strlen(szPath));
+		}
+		else
+		{
+			--m_nNumUnindexedPaks;
+		}
+		delete pPak;
+		return;
+	}
+}
+
+void CPakPathIndex::IndexDirectory(SPak* pPak, const ZipDir::DirHeader* pDir, uint64 nHash)
+{
+	const char* pNamePool = pDir->GetNamePool();
+	for (unsigned i = 0; i < pDir->numFiles; ++i)
+	{
+		const uint64 nFileHash = HashPathAppend(nHash, pDir->GetFileEntry(i)->GetName(pNamePool));
+		SPak*& pFilePak = m_files[nFileHash];
+		if (!pFilePak || pFilePak->nPriority < pPak->nPriority)
+			pFilePak = pPak;
+	}
+	for (unsigned i = 0; i < pDir->numDirs; ++i)
+	{
+		const ZipDir::DirEntry* pDirEntry = pDir->GetSubdirEntry(i);
+		IndexDirectory(pPak, pDirEntry->GetDirectory(), HashPathAppend(HashPathAppend(nHash, pDirEntry->GetName(pNamePool)), "/"));
+	}
+}
+
+void CPakPathIndex::UnindexDirectory(SPak* pPak, const ZipDir::DirHeader* pDir, uint64 nHash, char* szPath, size_t nPathLen)
+{
+	const char* pNamePool = pDir->GetNamePool();
+	for (unsigned i = 0; i < pDir->numFiles; ++i)
+	{
+		const char* szName = pDir->GetFileEntry(i)->GetName(pNamePool);
+		TFileMap::iterator itFile = m_files.find(HashPathAppend(nHash, szName));
+		if (itFile == m_files.end() || itFile->second != pPak)
+			continue;
+
+		// the file is read from the next pak having it now
+		cry_strcpy(szPath + nPathLen, ICryPak::g_nMaxPath - nPathLen, szName);
+		const size_t nFilePathLen = strlen(szPath);
+		SPak* pNextPak = nullptr;
+		for (std::vector<SPak*>::reverse_iterator it = m_paks.rbegin(); it != m_paks.rend() && !pNextPak; ++it)
+		{
+			const SPak* pOther = *it;
+			const size_t nRootLen = pOther->strBindRoot.length();
+			if (pOther->bIndexed && nFilePathLen > nRootLen && PathHasPrefix(szPath, pOther->strBindRoot.c_str(), nRootLen) && pOther->pZip->FindFile(szPath + nRootLen))
+				pNextPak = *it;
+		}
+
+		if (pNextPak)
+			itFile->second = pNextPak;
+		else
+			m_files.erase(itFile);
+	}
+	for (unsigned i = 0; i < pDir->numDirs; ++i)
+	{
+		const ZipDir::DirEntry* pDirEntry = pDir->GetSubdirEntry(i);
+		const char* szName = pDirEntry->GetName(pNamePool);
+		cry_strcpy(szPath + nPathLen, ICryPak::g_nMaxPath - nPathLen, szName);
+		cry_strcat(szPath, ICryPak::g_nMaxPath, "/");
+		UnindexDirectory(pPak, pDirEntry->GetDirectory(), HashPathAppend(HashPathAppend(nHash, szName), "/"), szPath, strlen(szPath));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CPakPathIndex::FindFile(const char* szPath, size_t nPathLen, bool bSkipInMemoryPaks, ZipDir::FileEntry*& pFileEntry, unsigned int& nArchiveFlags, ZipDir::CachePtr* pZip) const
+{
+	pFileEntry = nullptr;
+	nArchiveFlags = 0;
+
+	TFileMap::const_iterator itFile = m_files.find(HashPath(szPath));
+	const SPak* pCandidate = itFile != m_files.end() ? itFile->second : nullptr;
+
+	if (m_nNumUnindexedPaks == 0)
+	{
+		if (!pCandidate)
+			return true;
+		// a disabled pak, a pak with the bind root in different case or a hash collision: the slow way decides
+		return IsUsable(pCandidate, bSkipInMemoryPaks) && FindInPak(pCandidate, szPath, nPathLen, pFileEntry, nArchiveFlags, pZip);
+	}
+
+	// the paks which can't be indexed above the candidate still have to be asked
+	for (std::vector<SPak*>::const_reverse_iterator it = m_paks.rbegin(); it != m_paks.rend(); ++it)
+	{
+		const SPak* pPak = *it;
+		if (pPak == pCandidate)
+			return IsUsable(pPak, bSkipInMemoryPaks) && FindInPak(pPak, szPath, nPathLen, pFileEntry, nArchiveFlags, pZip);
+		if (!pPak->bIndexed && IsUsable(pPak, bSkipInMemoryPaks) && FindInPak(pPak, szPath, nPathLen, pFileEntry, nArchiveFlags, pZip))
+			return true;
+	}
+	return true;
+}
+
+bool CPakPathIndex::IsUsable(const SPak* pPak, bool bSkipInMemoryPaks) const
+{
+	const unsigned int nFlags = pPak->pArchive->GetFlags();
+	if (bSkipInMemoryPaks && (nFlags & ICryArchive::FLAGS_IN_MEMORY_MASK))
+		return false;
+	return (nFlags & ICryArchive::FLAGS_DISABLE_PAK) == 0;
+}
+
+bool CPakPathIndex::FindInPak(const SPak* pPak, const char* szPath, size_t nPathLen, ZipDir::FileEntry*& pFileEntry, unsigned int& nArchiveFlags, ZipDir::CachePtr* pZip) const
+{
+	// the same test as the search through all paks
+	const size_t nRootLen = pPak->strBindRoot.length();
+	if (nPathLen <= nRootLen || memcmp(pPak->strBindRoot.c_str(), szPath, nRootLen))
+		return false;
+
+	pFileEntry = pPak->pZip->FindFile(szPath + nRootLen);
+	if (!pFileEntry)
+		return false;
+
+	if (pZip)
+		*pZip = pPak->pZip;
+	nArchiveFlags = pPak->pArchive->GetFlags();
+	return true;
+}
+
+void CPakPathIndex::GetMemoryUsage(ICrySizer* pSizer) const
+{
+	pSizer->AddObject(this, sizeof(*this));
+	pSizer->AddObject(&m_paks, m_paks.capacity() * sizeof(SPak*) + m_paks.size() * sizeof(SPak));
+	pSizer->AddObject(&m_files, m_files.size() * (sizeof(TFileMap::value_type) + sizeof(void*)) + m_files.bucket_count() * sizeof(void*));
+}
+
+//////////////////////////////////////////////////////////////////////////
+CPakNegativeLookupCache::CPakNegativeLookupCache()
+	: m_nGeneration(0)
+{
+	memset((void*)m_entries, 0, sizeof(m_entries));
+}
+
+bool CPakNegativeLookupCache::Contains(uint64 nHash) const
+{
+	return m_entries[nHash & (eNumEntries - 1)] == (int64)Key(nHash, GetGeneration());
+}
+
+void CPakNegativeLookupCache::Add(uint64 nHash, uint32 nGeneration)
+{
+	// a miss found before an invalidation must not be added after it
+	if (nGeneration == GetGeneration())
+		m_entries[nHash & (eNumEntries - 1)] = (int64)Key(nHash, nGeneration);
+}
+
+void CPakNegativeLookupCache::Invalidate()
+{
+	CryInterlockedIncrement(&m_nGeneration);
+}
@@ -0,0 +1,86 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Index of the files of all opened paks by their full path,
+//               so finding the pak a file is read from doesn't have to ask
+//               every pak. And a cache of recent IsFileExist misses.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __CRYPAKPATHINDEX_H__
+#define __CRYPAKPATHINDEX_H__
+#pragma once
+
+#include "ZipDir.h"
+#include <unordered_map>
+
+// The index knows the paks in the same order as CCryPak::m_arrZips and is updated under the same lock.
+// Paks with file names stored as CRC32 can't be enumerated, the index only tracks where they are in the order.
+class CPakPathIndex
+{
+public:
+	CPakPathIndex();
+	~CPakPathIndex();
+
+	// Hash of the path as the paks compare them: lower case, either slash.
+	static uint64 HashPath(const char* szPath);
+
+	// bOverride: the pak was opened with ICryArchive::FLAGS_OVERRIDE_PAK, it's above all paks opened without
+	void AddPak(ZipDir::Cache* pZip, ICryArchive* pArchive, const char* szBindRoot, bool bOverride);
+	void RemovePak(ZipDir::Cache* pZip);
+
+	// Returns false if the index can't answer for sure and the paks have to be searched one by one,
+	// e.g. when the pak with the file is disabled and another pak could have the file as well.
+	bool FindFile(const char* szPath, size_t nPathLen, bool bSkipInMemoryPaks, ZipDir::FileEntry*& pFileEntry, unsigned int& nArchiveFlags, ZipDir::CachePtr* pZip) const;
+
+	size_t GetNumFiles() const { return m_files.size(); }
+	void   GetMemoryUsage(ICrySizer* pSizer) const;
+
+private:
+	struct SPak
+	{
+		ZipDir::Cache* pZip;
+		ICryArchive*   pArchive;
+		string         strBindRoot; // as in the PackDesc
+		uint64         nBindRootHash;
+		uint64         nPriority;   // the higher the later the pak is searched
+		bool           bIndexed;
+	};
+
+	// The pak with the highest priority having a file with the path hash
+	typedef std::unordered_map<uint64, SPak*> TFileMap;
+
+	void       IndexDirectory(SPak* pPak, const ZipDir::DirHeader* pDir, uint64 nHash);
+	void       UnindexDirectory(SPak* pPak, const ZipDir::DirHeader* pDir, uint64 nHash, char* szPath, size_t nPathLen);
+	bool       IsUsable(const SPak* pPak, bool bSkipInMemoryPaks) const;
+	bool       FindInPak(const SPak* pPak, const char* szPath, size_t nPathLen, ZipDir::FileEntry*& pFileEntry, unsigned int& nArchiveFlags, ZipDir::CachePtr* pZip) const;
+
+	std::vector<SPak*> m_paks; // ascending priority
+	TFileMap           m_files;
+	uint32             m_nNumUnindexedPaks;
+	uint32             m_nPakSequence;
+};
+
+// Misses of IsFileExist, which for loose files can cost a file system query each.
+// Lock-free: the entries are hashes combined with the generation, invalidating makes all entries stale at once.
+class CPakNegativeLookupCache
+{
+public:
+	CPakNegativeLookupCache();
+
+	uint32 GetGeneration() const { return (uint32)m_nGeneration; }
+	bool   Contains(uint64 nHash) const;
+	void   Add(uint64 nHash, uint32 nGeneration);
+	void   Invalidate();
+
+private:
+	enum { eNumEntries = 8192 };
+
+	uint64        Key(uint64 nHash, uint32 nGeneration) const { return (nHash ^ ((uint64)nGeneration * 0x9E3779B97F4A7C15ull)) | 1; }
+
+	volatile int64 m_entries[eNumEntries];
+	volatile LONG  m_nGeneration;
+};
+
+#endif // __CRYPAKPATHINDEX_H__
@@ -25,6 +25,7 @@
 #include <CrySystem/Profilers/IStatoscope.h>
 
 #include "Sampler.h"
+#include "TraceRecorder.h"
 #include <CryThreading/IThreadManager.h>
 #include "Timer.h"
 
@@ -624,6 +625,11 @@ void CFrameProfileSystem::StartProfilerSection(CFrameProfilerSection* pSection)
 //////////////////////////////////////////////////////////////////////////
 void CFrameProfileSystem::EndProfilerSection(CFrameProfilerSection* pSection)
 {
+	if (CTraceRecorder::IsRecording())
+	{
+		CTraceRecorder::RecordSection(pSection->m_pFrameProfiler, pSection->m_startTime, CryGetTicks());
+	}
+
 	AccumulateProfilerSection(pSection);
 
 	// Not in a SLICE_AND_SLEEP here, account for call overhead.
@@ -825,6 +831,11 @@ void CFrameProfileSystem::EndCustomSection(CCustomProfilerSection* pSection)
 //////////////////////////////////////////////////////////////////////////
 void CFrameProfileSystem::StartFrame()
 {
+	if (CTraceRecorder::IsRecording())
+	{
+		CTraceRecorder::GetInstance().RecordFrame(gEnv->nMainFrameID);
+	}
+
 	SetThreadSupport(gEnv->pConsole->GetCVar("profile_allthreads")->GetIVal());
 	m_ProfilerThreads.Reset();
 
@@ -12,10 +12,12 @@
 
 #include "FallbackBackend/FallBackBackend.h"
 #include "PCBackEnd/ThreadBackEnd.h"
+#include "WorkStealingBackEnd/WorkStealingBackEnd.h"
 #include "BlockingBackend/BlockingBackEnd.h"
 
 #include "../System.h"
 #include "../CPUDetect.h"
+#include "../TraceRecorder.h"
 
 namespace JobManager {
 namespace Detail {
@@ -53,6 +55,10 @@ void JobManager::CWorkerBackEndProfiler::Init(uint16 numWorkers)
 	// Init Job Stats
 	ZeroMemory(m_JobStatsInfo.m_pJobStats, sizeof(m_JobStatsInfo.m_pJobStats));
 
+	// Init Graph Stats
+	for (uint32 i = 0; i < JobManager::detail::eJOB_FRAME_STATS; ++i)
+		m_GraphStatsInfo.m_nNumNodes[i] = 0;
+
 	// Init Worker Stats
 	for (uint32 i = 0; i < JobManager::detail::eJOB_FRAME_STATS; ++i)
 	{
@@ -88,6 +94,7 @@ void JobManager::CWorkerBackEndProfiler::Update(const uint32 curTimeSample)
 	// Reset next buffer slot and start its time period
 	ResetWorkerStats(nNextIndex, curTimeSample);
 	ResetJobStats(nNextIndex);
+	ResetGraphStats(nNextIndex);
 
 	// Advance buffer index
 	m_nCurBufIndex = nNextIndex;
@@ -233,6 +240,39 @@ void JobManager::CWorkerBackEndProfiler::RecordJob(const uint16 profileIndex, co
 		numJobsExecuted = *const_cast<volatile uint32*>(&workerStats.nNumJobsExecuted);
 	}
 	while (CryInterlockedCompareExchange(alias_cast<volatile LONG*>(&workerStats.nNumJobsExecuted), numJobsExecuted + 1, numJobsExecuted) != numJobsExecuted);
+
+#if defined(USE_FRAME_PROFILER)
+	if (CTraceRecorder::IsRecording())
+	{
+		CTraceRecorder::RecordJob(jobStats.cpName, workerId, runTimeMicroSec);
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobManager::CWorkerBackEndProfiler::RecordGraphNode(const uint16 profileIndex, const SJobGraphNodeFrameStats& rNodeStats)
+{
+	// Reserve a slot, nodes beyond the per frame limit are dropped
+	const LONG nSlot = CryInterlockedIncrement(&m_GraphStatsInfo.m_nNumNodes[profileIndex]) - 1;
+	if (nSlot >= JobManager::detail::eJOB_FRAME_STATS_MAX_GRAPH_NODES)
+		return;
+
+	m_GraphStatsInfo.m_pNodeStats[profileIndex * JobManager::detail::eJOB_FRAME_STATS_MAX_GRAPH_NODES + nSlot] = rNodeStats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobManager::CWorkerBackEndProfiler::GetFrameGraphStats(TJobGraphFrameStatsContainer& rNodeStats) const
+{
+	uint8 nTailIndex = (m_nCurBufIndex + 1);
+	nTailIndex = (nTailIndex > (JobManager::detail::eJOB_FRAME_STATS - 1)) ? 0 : nTailIndex;
+
+	const JobManager::SJobGraphNodeFrameStats* pNodeStatsToCopyFrom = &m_GraphStatsInfo.m_pNodeStats[nTailIndex * JobManager::detail::eJOB_FRAME_STATS_MAX_GRAPH_NODES];
+	const uint32 nNumNodes = min((uint32)m_GraphStatsInfo.m_nNumNodes[nTailIndex], (uint32)JobManager::detail::eJOB_FRAME_STATS_MAX_GRAPH_NODES);
+
+	rNodeStats.clear();
+	rNodeStats.reserve(nNumNodes);
+	for (uint32 i = 0; i < nNumNodes; ++i)
+		rNodeStats.push_back(pNodeStatsToCopyFrom[i]);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -339,6 +379,12 @@ void JobManager::CWorkerBackEndProfiler::ResetJobStats(const uint8 nBufferIndex)
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void JobManager::CWorkerBackEndProfiler::ResetGraphStats(const uint8 nBufferIndex)
+{
+	m_GraphStatsInfo.m_nNumNodes[nBufferIndex] = 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 JobManager::CJobManager* JobManager::CJobManager::Instance()
 {
@@ -358,6 +404,7 @@ JobManager::CJobManager::CJobManager()
 	: m_Initialized(false),
 	m_pFallBackBackEnd(NULL),
 	m_pThreadBackEnd(NULL),
+	m_bWorkStealingBackEnd(false),
 	m_pBlockingBackEnd(NULL),
 	m_nJobIdCounter(0),
 	m_nJobSystemEnabled(1),
@@ -548,7 +595,14 @@ void JobManager::CJobManager::AddJob(JobManager::CJobDelegator& crJob, const Job
 	IF (m_pBlockingBackEnd && crJob.IsBlocking(), 0)
 		return static_cast<BlockingBackEnd::CBlockingBackEnd*>(m_pBlockingBackEnd)->BlockingBackEnd::CBlockingBackEnd::AddJob(crJob, cJobHandle, infoBlock);
 
+	// jobs added from a thread with a backend override, see detail::SetThreadBackEndOverride
+	IBackend* const pBackEndOverride = JobManager::detail::GetThreadBackEndOverride();
+	IF (pBackEndOverride != NULL, 0)
+		return pBackEndOverride->AddJob(crJob, cJobHandle, infoBlock);
+
 	// default case is the threadbackend
+	IF (m_pThreadBackEnd && m_bWorkStealingBackEnd, 0)
+		return static_cast<WorkStealingBackEnd::CWorkStealingBackEnd*>(m_pThreadBackEnd)->WorkStealingBackEnd::CWorkStealingBackEnd::AddJob(crJob, cJobHandle, infoBlock);
 	if (m_pThreadBackEnd)
 		return static_cast<ThreadBackEnd::CThreadBackEnd*>(m_pThreadBackEnd)->ThreadBackEnd::CThreadBackEnd::AddJob(crJob, cJobHandle, infoBlock);
 
@@ -580,6 +634,15 @@ void JobManager::CJobManager::Init(uint32 nSysMaxWorker)
 
 	m_Initialized = true;
 
+	// replace the shared queue thread backend by the work stealing one if requested
+	ICVar* pBackEndCVar = gEnv->pConsole ? gEnv->pConsole->GetCVar("sys_job_system_backend") : NULL;
+	if (pBackEndCVar && pBackEndCVar->GetIVal() == 1)
+	{
+		delete m_pThreadBackEnd;
+		m_pThreadBackEnd = new WorkStealingBackEnd::CWorkStealingBackEnd();
+		m_bWorkStealingBackEnd = true;
+	}
+
 	// initialize the backends for this platform
 	if (m_pThreadBackEnd)
 	{
@@ -1567,6 +1630,64 @@ void JobManager::CJobManager::DumpJobList()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+void JobManager::CJobManager::DumpJobGraph()
+{
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	// the thread backend is released when it failed to initialize
+	IWorkerBackEndProfiler* pWorkerProfiler = m_pThreadBackEnd ? m_pThreadBackEnd->GetBackEndWorkerProfiler() : NULL;
+	if (!pWorkerProfiler)
+		return;
+
+	IWorkerBackEndProfiler::TJobGraphFrameStatsContainer nodeStats;
+	pWorkerProfiler->GetFrameGraphStats(nodeStats);
+
+	// group the nodes by graph run, in order of execution
+	std::sort(nodeStats.begin(), nodeStats.end(), [](const SJobGraphNodeFrameStats& a, const SJobGraphNodeFrameStats& b)
+	{
+		if (a.cpGraphName != b.cpGraphName)
+			return a.cpGraphName < b.cpGraphName;
+		if (a.nGraphRunId != b.nGraphRunId)
+			return a.nGraphRunId < b.nGraphRunId;
+		return (int)(a.nStartTime - b.nStartTime) < 0;
+	});
+
+	// only the edge from the predecessor which released a node is known, this is the edge on the critical path
+	// continuations (nodes run inline by the releasing worker) are drawn bold
+	CryLogAlways("== JobManager job graphs of the last frame (%u nodes) ==", (uint32)nodeStats.size());
+	CryLogAlways("digraph JobGraph {");
+	CryLogAlways("\trankdir=LR;");
+	for (uint32 i = 0, nCluster = 0; i < nodeStats.size(); ++nCluster)
+	{
+		const SJobGraphNodeFrameStats& rFirst = nodeStats[i];
+		CryLogAlways("\tsubgraph cluster_%u {", nCluster);
+		CryLogAlways("\t\tlabel=\"%s (run %u)\";", rFirst.cpGraphName, rFirst.nGraphRunId);
+
+		uint32 nEnd = i;
+		for (; nEnd < nodeStats.size() && nodeStats[nEnd].cpGraphName == rFirst.cpGraphName && nodeStats[nEnd].nGraphRunId == rFirst.nGraphRunId; ++nEnd)
+		{
+			const SJobGraphNodeFrameStats& rNode = nodeStats[nEnd];
+			CryLogAlways("\t\tn%u_%u [label=\"%s\\n+%uus %uus\\nworker %d\"];", nCluster, rNode.nNodeIndex, rNode.cpNodeName,
+			             rNode.nStartTime - rFirst.nStartTime, rNode.nEndTime - rNode.nStartTime, rNode.nWorkerId == 0xFF ? -1 : (int)rNode.nWorkerId);
+		}
+		for (uint32 j = i; j < nEnd; ++j)
+		{
+			const SJobGraphNodeFrameStats& rNode = nodeStats[j];
+			if (rNode.nReleasedByNodeIndex != 0xFFFF)
+			{
+				CryLogAlways("\t\tn%u_%u -> n%u_%u%s;", nCluster, rNode.nReleasedByNodeIndex, nCluster, rNode.nNodeIndex,
+				             rNode.bContinuation ? " [style=bold]" : "");
+			}
+		}
+		CryLogAlways("\t}");
+		i = nEnd;
+	}
+	CryLogAlways("}");
+#else
+	CryLogAlways("JobManager: job graph stats require JOBMANAGER_SUPPORT_FRAMEPROFILER");
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool JobManager::CJobManager::OnInputEvent(const SInputEvent& event)
 {
@@ -1601,6 +1722,7 @@ void JobManager::CJobManager::AddBlockingFallbackJob(JobManager::SInfoBlock* pIn
 ///////////////////////////////////////////////////////////////////////////////
 TLS_DEFINE(uint32, gWorkerThreadId);
 TLS_DEFINE(uintptr_t, gFallbackInfoBlocks);
+TLS_DEFINE(uintptr_t, gThreadBackEndOverride);
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace JobManager {
@@ -1626,6 +1748,18 @@ uint32 JobManager::detail::GetWorkerThreadId()
 	return is_marked_worker_thread_id(nID) ? unmark_worker_thread_id(nID) : ~0;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void JobManager::detail::SetThreadBackEndOverride(JobManager::IBackend* pBackEnd)
+{
+	TLS_SET(gThreadBackEndOverride, (uintptr_t)pBackEnd);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+JobManager::IBackend* JobManager::detail::GetThreadBackEndOverride()
+{
+	return (JobManager::IBackend*)TLS_GET(uintptr_t, gThreadBackEndOverride);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void JobManager::detail::PushToFallbackJobList(JobManager::SInfoBlock* pInfoBlock)
 {
@@ -33,6 +33,11 @@ JobManager::SInfoBlock* PopFromFallbackJobList();
 void   SetWorkerThreadId(uint32 nWorkerThreadId);
 uint32 GetWorkerThreadId();
 
+// functions to access the per thread backend override, jobs added from a thread with an override
+// go to that backend instead of the thread backend (used to benchmark private backend instances)
+void      SetThreadBackEndOverride(IBackend* pBackEnd);
+IBackend* GetThreadBackEndOverride();
+
 } // namespace detail
 
 // Tracks CPU/PPU worker thread(s) utilization and job execution time per frame
@@ -54,6 +59,9 @@ public:
 	// Record execution information for a registered job
 	virtual void RecordJob(const uint16 profileIndex, const uint8 workerId, const uint32 jobId, const uint32 runTimeMicroSec);
 
+	// Record the execution of a job graph node
+	virtual void RecordGraphNode(const uint16 profileIndex, const SJobGraphNodeFrameStats& rNodeStats);
+
 	// Get worker frame stats for the JobManager::detail::eJOB_FRAME_STATS - 1 frame
 	virtual void GetFrameStats(JobManager::CWorkerFrameStats& rStats) const;
 	virtual void GetFrameStats(TJobFrameStatsContainer& rJobStats, IWorkerBackEndProfiler::EJobSortOrder jobSortOrder) const;
@@ -63,6 +71,9 @@ public:
 	virtual void GetFrameStatsSummary(SWorkerFrameStatsSummary& rStats) const;
 	virtual void GetFrameStatsSummary(SJobFrameStatsSummary& rStats) const;
 
+	// Get the job graph nodes executed during the JobManager::detail::eJOB_FRAME_STATS - 1 frame
+	virtual void GetFrameGraphStats(TJobGraphFrameStatsContainer& rNodeStats) const;
+
 	// Returns the index of the active multi-buffered profile data
 	virtual uint16 GetProfileIndex() const;
 
@@ -74,6 +85,7 @@ protected:
 	void GetJobStats(const uint8 nBufferIndex, TJobFrameStatsContainer& rJobStatsContainer, IWorkerBackEndProfiler::EJobSortOrder jobSortOrder) const;
 	void ResetWorkerStats(const uint8 nBufferIndex, const uint32 curTimeSample);
 	void ResetJobStats(const uint8 nBufferIndex);
+	void ResetGraphStats(const uint8 nBufferIndex);
 
 protected:
 	struct SJobStatsInfo
@@ -81,6 +93,12 @@ protected:
 		JobManager::SJobFrameStats m_pJobStats[JobManager::detail::eJOB_FRAME_STATS * JobManager::detail::eJOB_FRAME_STATS_MAX_SUPP_JOBS];    // Array of job stats (multi buffered)
 	};
 
+	struct SGraphStatsInfo
+	{
+		JobManager::SJobGraphNodeFrameStats m_pNodeStats[JobManager::detail::eJOB_FRAME_STATS * JobManager::detail::eJOB_FRAME_STATS_MAX_GRAPH_NODES]; // Array of executed graph nodes (multi buffered)
+		volatile LONG                       m_nNumNodes[JobManager::detail::eJOB_FRAME_STATS];                                                      // Number of recorded graph nodes (multi buffered)
+	};
+
 	struct SWorkerStatsInfo
 	{
 		uint32                    m_nStartTime[JobManager::detail::eJOB_FRAME_STATS]; // Start Time of sample period (multi buffered)
@@ -93,6 +111,7 @@ protected:
 	uint8            m_nCurBufIndex;      // Current buffer index [0,(JobManager::detail::eJOB_FRAME_STATS-1)]
 	SJobStatsInfo    m_JobStatsInfo;      // Information about all job activities
 	SWorkerStatsInfo m_WorkerStatsInfo;   // Information about each worker's utilization
+	SGraphStatsInfo  m_GraphStatsInfo;    // Information about executed job graph nodes
 };
 
 class CJobLambda : public CJobBase
@@ -255,6 +274,7 @@ public:
 	virtual SJobFinishedConditionVariable* GetSemaphore(JobManager::TSemaphoreHandle nSemaphoreHandle, volatile const void* pOwner) override;
 
 	virtual void DumpJobList() override;
+	virtual void DumpJobGraph() override;
 
 	virtual bool OnInputEvent(const SInputEvent &event) override;
 
@@ -281,6 +301,7 @@ private:
 
 	IBackend* m_pFallBackBackEnd;               // Backend for development, jobs are executed in their calling thread
 	IBackend* m_pThreadBackEnd;                 // Backend for regular jobs, available on PC/XBOX. on Xbox threads are polling with a low priority
+	bool m_bWorkStealingBackEnd;                // true if m_pThreadBackEnd is the work stealing implementation (sys_job_system_backend 1)
 	IBackend* m_pBlockingBackEnd;               // Backend for tasks which can block to prevent stalling regular jobs in this case
 
 	uint16 m_nJobIdCounter;                     // JobId counter for jobs dynamically allocated at runtime
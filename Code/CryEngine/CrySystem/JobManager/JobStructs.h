@@ -23,8 +23,9 @@ enum EAddJobRes
 //triple buffer frame stats
 enum
 {
-	eJOB_FRAME_STATS               = 3,
-	eJOB_FRAME_STATS_MAX_SUPP_JOBS = 64
+	eJOB_FRAME_STATS                 = 3,
+	eJOB_FRAME_STATS_MAX_SUPP_JOBS   = 64,
+	eJOB_FRAME_STATS_MAX_GRAPH_NODES = 1024     // job graph node executions recorded per frame, further ones are dropped
 };
 
 // configuration for job queue sizes:
@@ -40,6 +41,13 @@ static const unsigned int cMaxWorkQueueJobs_BlockingBackEnd_RegularPriority = 25
 static const unsigned int cMaxWorkQueueJobs_BlockingBackEnd_LowPriority = 512;
 static const unsigned int cMaxWorkQueueJobs_BlockingBackEnd_StreamPriority = 128;
 
+// the work stealing backend has one deque per worker and priority level, so keep them smaller
+// jobs which don't fit into the local deque are pushed into the shared (thread backend sized) queue
+static const unsigned int cMaxWorkQueueJobs_WorkStealingDeque_HighPriority = 32;
+static const unsigned int cMaxWorkQueueJobs_WorkStealingDeque_RegularPriority = 256;
+static const unsigned int cMaxWorkQueueJobs_WorkStealingDeque_LowPriority = 128;
+static const unsigned int cMaxWorkQueueJobs_WorkStealingDeque_StreamPriority = 64;
+
 // struct to manage the state of a job slot
 // used to indicate that a info block has been finished writing
 struct SJobQueueSlotState
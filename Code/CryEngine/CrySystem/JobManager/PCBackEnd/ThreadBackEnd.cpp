@@ -15,9 +15,10 @@
 #include "../../CPUDetect.h"
 
 ///////////////////////////////////////////////////////////////////////////////
-JobManager::ThreadBackEnd::CThreadBackEnd::CThreadBackEnd()
+JobManager::ThreadBackEnd::CThreadBackEnd::CThreadBackEnd(const char* szWorkerThreadName)
 	: m_Semaphore(SJobQueue_ThreadBackEnd::eMaxWorkQueueJobsRegularPriority)
 	, m_nNumWorkerThreads(0)
+	, m_szWorkerThreadName(szWorkerThreadName)
 {
 	m_JobQueue.Init();
 
@@ -61,9 +62,9 @@ bool JobManager::ThreadBackEnd::CThreadBackEnd::Init(uint32 nSysMaxWorker)
 	{
 		m_arrWorkerThreads[i] = new CThreadBackEndWorkerThread(this, m_Semaphore, m_JobQueue, i);
 
-		if (!gEnv->pThreadManager->SpawnThread(m_arrWorkerThreads[i], "JobSystem_Worker_%u", i))
+		if (!gEnv->pThreadManager->SpawnThread(m_arrWorkerThreads[i], m_szWorkerThreadName, i))
 		{
-			CryFatalError("Error spawning \"JobSystem_Worker_%u\" thread.", i);
+			CryFatalError("Error spawning \"%s\" thread %u.", m_szWorkerThreadName, i);
 		}
 	}
 #if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
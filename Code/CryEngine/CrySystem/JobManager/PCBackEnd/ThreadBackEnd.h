@@ -209,8 +209,10 @@ public:
 
 	// Signals the thread that it should not accept anymore work and exit
 	void SignalStopWork();
+
+	// Drains a producer/consumer queue job, shared with the work stealing backend
+	static void DoWorkProducerConsumerQueue(SInfoBlock& rInfoBlock);
 private:
-	void DoWorkProducerConsumerQueue(SInfoBlock& rInfoBlock);
 
 	uint32                               m_nId;                   // id of the worker thread
 	volatile bool                        m_bStop;
@@ -225,7 +227,8 @@ private:
 class CThreadBackEnd : public IBackend
 {
 public:
-	CThreadBackEnd();
+	// instances running at the same time need different worker thread names (printf format with the worker id)
+	explicit CThreadBackEnd(const char* szWorkerThreadName = "JobSystem_Worker_%u");
 	virtual ~CThreadBackEnd();
 
 	bool           Init(uint32 nSysMaxWorker);
@@ -250,6 +253,7 @@ private:
 	detail::CWaitForJobObject                m_Semaphore;             // semaphore to count available jobs, to allow the workers to go sleeping instead of spinning when no work is required
 	std::vector<CThreadBackEndWorkerThread*> m_arrWorkerThreads;      // array of worker threads
 	uint8 m_nNumWorkerThreads;                                        // number of worker threads
+	const char*                              m_szWorkerThreadName;    // format of the worker thread names
 
 	// members required for profiling jobs in the frame profiler
 #if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
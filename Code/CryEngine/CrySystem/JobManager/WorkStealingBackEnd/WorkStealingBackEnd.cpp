@@ -0,0 +1,658 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  File name:   WorkStealingBackEnd.cpp
+//  Version:     v1.00
+//  Compilers:   Visual Studio.NET
+// -------------------------------------------------------------------------
+//  History:
+////////////////////////////////////////////////////////////////////////////
+#include "StdAfx.h"
+#include "WorkStealingBackEnd.h"
+#include "../JobManager.h"
+#include "../../System.h"
+#include "../../CPUDetect.h"
+
+namespace JobManager {
+namespace WorkStealingBackEnd {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+static uint32 GetDequeCapacity(uint32 nPriorityLevel)
+{
+	switch (nPriorityLevel)
+	{
+	case eHighPriority:
+		return JobManager::detail::cMaxWorkQueueJobs_WorkStealingDeque_HighPriority;
+	case eRegularPriority:
+		return JobManager::detail::cMaxWorkQueueJobs_WorkStealingDeque_RegularPriority;
+	case eLowPriority:
+		return JobManager::detail::cMaxWorkQueueJobs_WorkStealingDeque_LowPriority;
+	case eStreamPriority:
+		return JobManager::detail::cMaxWorkQueueJobs_WorkStealingDeque_StreamPriority;
+	default:
+		return 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the profilers are shared by all workers and never released, the workers cache the ones they used
+static CFrameProfiler* GetWorkStealingFrameProfilerForName(const char* name)
+{
+	struct SFrameProfilers
+	{
+		SFrameProfilers() { profilers.reserve(256); }
+
+		CryCriticalSectionNonRecursive                      lock;
+		std::vector<std::pair<const char*, CFrameProfiler*>> profilers;
+	};
+	static SFrameProfilers s_profilers;
+
+	AUTO_LOCK_T(CryCriticalSectionNonRecursive, s_profilers.lock);
+	for (auto& p : s_profilers.profilers)
+	{
+		if (p.first == name)
+			return p.second;
+	}
+	CFrameProfiler* pNewProfiler = new CFrameProfiler(PROFILE_SYSTEM, EProfileDescription::REGION, name, "", 0);
+	s_profilers.profilers.push_back(std::make_pair(name, pNewProfiler));
+	return pNewProfiler;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+CWorkStealingDeque::CWorkStealingDeque()
+	: m_nTop(0)
+	, m_nBottom(0)
+	, m_pInfoBlocks(NULL)
+	, m_pInfoBlockStates(NULL)
+	, m_nMask(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CWorkStealingDeque::Init(uint32 nCapacity)
+{
+	assert(nCapacity > 0 && (nCapacity & (nCapacity - 1)) == 0 && "work stealing deque capacity needs to be a power of two");
+
+	m_pInfoBlocks = static_cast<JobManager::SInfoBlock*>(CryModuleMemalign(nCapacity * sizeof(JobManager::SInfoBlock), 128));
+	m_pInfoBlockStates = static_cast<JobManager::detail::SJobQueueSlotState*>(CryModuleMemalign(nCapacity * sizeof(JobManager::detail::SJobQueueSlotState), 128));
+	memset(m_pInfoBlocks, 0, nCapacity * sizeof(JobManager::SInfoBlock));
+	memset(m_pInfoBlockStates, 0, nCapacity * sizeof(JobManager::detail::SJobQueueSlotState));
+
+	m_nMask = nCapacity - 1;
+	m_nTop = 0;
+	m_nBottom = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CWorkStealingDeque::Release()
+{
+	if (m_pInfoBlocks)
+		CryModuleMemalignFree(m_pInfoBlocks);
+	if (m_pInfoBlockStates)
+		CryModuleMemalignFree(m_pInfoBlockStates);
+
+	m_pInfoBlocks = NULL;
+	m_pInfoBlockStates = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+JobManager::SInfoBlock* CWorkStealingDeque::BeginPush()
+{
+	const int64 nBottom = m_nBottom;
+	const int64 nTop = m_nTop;
+	IF (nBottom - nTop > m_nMask, 0)
+		return NULL;
+
+	// a thief which won the slot before might still copy it out, wait for it to finish
+	const int64 nSlot = nBottom & m_nMask;
+	int iter = 0;
+	while (m_pInfoBlockStates[nSlot].IsReady())
+	{
+		CrySleep(iter++ > 10 ? 1 : 0);
+	}
+
+	return &m_pInfoBlocks[nSlot];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CWorkStealingDeque::EndPush()
+{
+	const int64 nBottom = m_nBottom;
+
+	// make the info block visible before the new bottom is published
+	m_pInfoBlockStates[nBottom & m_nMask].SetReady();
+	MemoryBarrier();
+	m_nBottom = nBottom + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CWorkStealingDeque::Pop(JobManager::SInfoBlock& rInfoBlock)
+{
+	const int64 nBottom = m_nBottom - 1;
+	m_nBottom = nBottom;
+	// the store to bottom has to be visible before we read top (store-load ordering)
+	MemoryBarrier();
+	const int64 nTop = m_nTop;
+
+	if (nTop > nBottom)
+	{
+		// deque was empty, restore bottom
+		m_nBottom = nBottom + 1;
+		return false;
+	}
+
+	bool bGotJob = true;
+	if (nTop == nBottom)
+	{
+		// last job in the deque, race against the thieves for it
+		bGotJob = CryInterlockedCompareExchange64(&m_nTop, nTop + 1, nTop) == nTop;
+		m_nBottom = nBottom + 1;
+	}
+
+	if (bGotJob)
+		CopyOut(nBottom, rInfoBlock);
+
+	return bGotJob;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool CWorkStealingDeque::Steal(JobManager::SInfoBlock& rInfoBlock)
+{
+	const int64 nTop = m_nTop;
+	MemoryBarrier();
+	const int64 nBottom = m_nBottom;
+
+	if (nTop >= nBottom)
+		return false;
+
+	if (CryInterlockedCompareExchange64(&m_nTop, nTop + 1, nTop) != nTop)
+		return false;
+
+	CopyOut(nTop, rInfoBlock);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void CWorkStealingDeque::CopyOut(int64 nPosition, JobManager::SInfoBlock& rInfoBlock)
+{
+	const int64 nSlot = nPosition & m_nMask;
+	JobManager::SInfoBlock* pCurrentJobSlot = &m_pInfoBlocks[nSlot];
+	pCurrentJobSlot->AssignMembersTo(&rInfoBlock);
+
+	// don't keep lambda captures alive until the slot is reused
+	pCurrentJobSlot->jobLambdaInvoker = nullptr;
+
+	// hand the slot back to the owner
+	MemoryBarrier();
+	m_pInfoBlockStates[nSlot].SetNotReady();
+}
+
+} // namespace detail
+} // namespace WorkStealingBackEnd
+} // namespace JobManager
+
+///////////////////////////////////////////////////////////////////////////////
+JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::CWorkStealingBackEnd(const char* szWorkerThreadName)
+	: m_Semaphore(SJobQueue_ThreadBackEnd::eMaxWorkQueueJobsRegularPriority)
+	, m_pWorkerDeques(NULL)
+	, m_nNumWorkerThreads(0)
+	, m_szWorkerThreadName(szWorkerThreadName)
+{
+	m_JobQueue.Init();
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	m_pBackEndWorkerProfiler = 0;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::~CWorkStealingBackEnd()
+{
+	if (m_pWorkerDeques)
+	{
+		for (uint32 i = 0; i < m_nNumWorkerThreads * eNumPriorityLevel; ++i)
+		{
+			m_pWorkerDeques[i].Release();
+			m_pWorkerDeques[i].~CWorkStealingDeque();
+		}
+		CryModuleMemalignFree(m_pWorkerDeques);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::Init(uint32 nSysMaxWorker)
+{
+	// find out how many workers to create
+#if CRY_PLATFORM_DURANGO || CRY_PLATFORM_ORBIS
+	const uint32 nNumCores = 4;
+#else
+	CCpuFeatures* pCPU = ((CSystem*)gEnv->pSystem)->GetCPUFeatures();
+	const uint32 nNumCores = pCPU->GetPhysCPUCount();
+#endif
+
+	uint32 nNumWorkerToCreate = 0;
+
+	if (nSysMaxWorker)
+		nNumWorkerToCreate = std::min(nSysMaxWorker, nNumCores);
+	else
+		nNumWorkerToCreate = nNumCores;
+
+	if (nNumWorkerToCreate == 0)
+		return false;
+
+	m_nNumWorkerThreads = nNumWorkerToCreate;
+
+	// the deques need to exist before the first worker can add a job
+	// each deque keeps its top and bottom on separate cache lines, so allocate them aligned
+	m_pWorkerDeques = static_cast<detail::CWorkStealingDeque*>(CryModuleMemalign(nNumWorkerToCreate * eNumPriorityLevel * sizeof(detail::CWorkStealingDeque), 128));
+	for (uint32 i = 0; i < nNumWorkerToCreate; ++i)
+	{
+		for (uint32 nPriorityLevel = 0; nPriorityLevel < eNumPriorityLevel; ++nPriorityLevel)
+		{
+			new(&GetDeque(i, nPriorityLevel))detail::CWorkStealingDeque();
+			GetDeque(i, nPriorityLevel).Init(detail::GetDequeCapacity(nPriorityLevel));
+		}
+	}
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	m_pBackEndWorkerProfiler = new JobManager::CWorkerBackEndProfiler;
+	m_pBackEndWorkerProfiler->Init(nNumWorkerToCreate);
+#endif
+
+	m_arrWorkerThreads.resize(nNumWorkerToCreate);
+
+	for (uint32 i = 0; i < nNumWorkerToCreate; ++i)
+	{
+		m_arrWorkerThreads[i] = new CWorkStealingBackEndWorkerThread(this, m_Semaphore, i);
+
+		if (!gEnv->pThreadManager->SpawnThread(m_arrWorkerThreads[i], m_szWorkerThreadName, i))
+		{
+			CryFatalError("Error spawning \"%s\" thread %u.", m_szWorkerThreadName, i);
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::ShutDown()
+{
+	// 1. Signal all threads to stop
+	uint32 numOfStoppedThreads = 0;
+	for (uint32 i = 0; i < m_arrWorkerThreads.size(); ++i)
+	{
+		if (m_arrWorkerThreads[i] == NULL)
+			continue;
+		m_arrWorkerThreads[i]->SignalStopWork();
+		++numOfStoppedThreads;
+	}
+
+	// 2. Release semaphore count to wake up some/all threads waiting on the semaphore
+	for (uint32 i = 0; i < numOfStoppedThreads; ++i)
+	{
+		m_Semaphore.SignalNewJob();
+	}
+
+	// 3. Wait for threads to exit and delete worker thread
+	for (uint32 i = 0; i < m_arrWorkerThreads.size(); ++i)
+	{
+		if (m_arrWorkerThreads[i] == NULL)
+			continue;
+
+		if (gEnv->pThreadManager->JoinThread(m_arrWorkerThreads[i], eJM_Join))
+		{
+			delete m_arrWorkerThreads[i];
+			m_arrWorkerThreads[i] = NULL;
+		}
+	}
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	SAFE_DELETE(m_pBackEndWorkerProfiler);
+#endif
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::AddJob(JobManager::CJobDelegator& crJob, const JobManager::TJobHandle cJobHandle, JobManager::SInfoBlock& rInfoBlock)
+{
+	uint32 nJobPriority = crJob.GetPriorityLevel();
+	CJobManager* __restrict pJobManager = CJobManager::Instance();
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Acquire Infoblock to use
+	// jobs added from one of our workers go into the worker's own deque, this doesn't touch any shared cache line
+	const uint32 nWorkerId = JobManager::detail::GetWorkerThreadId();
+	detail::CWorkStealingDeque* pDeque = nWorkerId < m_nNumWorkerThreads ? &GetDeque(nWorkerId, nJobPriority) : NULL;
+	JobManager::SInfoBlock* pJobInfoBlock = pDeque ? pDeque->BeginPush() : NULL;
+
+	// otherwise (or if the local deque is full) use the shared queue, same rules as in the thread backend
+	uint32 jobSlot = ~0;
+	JobManager::SInfoBlock* pFallbackInfoBlock = NULL;
+	JobManager::detail::EAddJobRes cEnqRes = JobManager::detail::eAJR_Success;
+	if (pJobInfoBlock == NULL)
+	{
+		pDeque = NULL;
+
+		// only wait for a jobslot if we are submitting from a regular thread, or if we are submitting
+		// a blocking job from a regular worker thread
+		bool bWaitForFreeJobSlot = (JobManager::IsWorkerThread() == false) && (JobManager::IsBlockingWorkerThread() == false);
+		cEnqRes = m_JobQueue.GetJobSlot(jobSlot, nJobPriority, bWaitForFreeJobSlot);
+
+		// allocate fallback infoblock if needed
+		IF (cEnqRes == JobManager::detail::eAJR_NeedFallbackJobInfoBlock, 0)
+			pFallbackInfoBlock = new JobManager::SInfoBlock();
+
+		PREFAST_ASSUME(pFallbackInfoBlock);
+		pJobInfoBlock = (cEnqRes == JobManager::detail::eAJR_NeedFallbackJobInfoBlock ? pFallbackInfoBlock : &m_JobQueue.jobInfoBlocks[nJobPriority][jobSlot]);
+	}
+
+#if !defined(_RELEASE)
+	pJobManager->IncreaseRunJobs();
+	if (cEnqRes == JobManager::detail::eAJR_NeedFallbackJobInfoBlock)
+		pJobManager->IncreaseRunFallbackJobs();
+#endif
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Initialize the InfoBlock
+	JobManager::SInfoBlock& RESTRICT_REFERENCE rJobInfoBlock = *pJobInfoBlock;
+	rInfoBlock.AssignMembersTo(&rJobInfoBlock);
+
+	// copy job parameter if it is a non-queue job
+	if (crJob.GetQueue() == NULL)
+	{
+		JobManager::CJobManager::CopyJobParameter(crJob.GetParamDataSize(), rJobInfoBlock.GetParamAddress(), crJob.GetJobParamData());
+	}
+
+	assert(rInfoBlock.jobInvoker);
+
+	const uint32 cJobId = cJobHandle->jobId;
+	rJobInfoBlock.jobId = (unsigned char)cJobId;
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	assert(cJobId < JobManager::detail::eJOB_FRAME_STATS_MAX_SUPP_JOBS);
+	m_pBackEndWorkerProfiler->RegisterJob(cJobId, pJobManager->GetJobName(rInfoBlock.jobInvoker));
+	rJobInfoBlock.frameProfIndex = (unsigned char)m_pBackEndWorkerProfiler->GetProfileIndex();
+#endif
+
+	/////////////////////////////////////////////////////////////////////////////
+	// initialization finished, make all visible for worker threads
+	IF (cEnqRes == JobManager::detail::eAJR_NeedFallbackJobInfoBlock, 0)
+	{
+		// catch submission from regular workers to the blocking backend
+		if (crJob.IsBlocking())
+		{
+			pJobManager->AddBlockingFallbackJob(pFallbackInfoBlock, JobManager::GetWorkerThreadId());
+
+			// Release semaphore count to signal the workers that work is available
+			m_Semaphore.SignalNewJob();
+		}
+		else
+		{
+			JobManager::detail::PushToFallbackJobList(&rJobInfoBlock);
+		}
+	}
+	else if (pDeque)
+	{
+		pDeque->EndPush();
+
+		// Release semaphore count to signal the workers that work is available
+		m_Semaphore.SignalNewJob();
+	}
+	else
+	{
+		MemoryBarrier();
+		m_JobQueue.jobInfoBlockStates[nJobPriority][jobSlot].SetReady();
+
+		// Release semaphore count to signal the workers that work is available
+		m_Semaphore.SignalNewJob();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::GetJob(uint32 nWorkerId, JobManager::SInfoBlock& rInfoBlock, uint32& rPriorityLevel)
+{
+	const uint32 nNumWorkers = m_nNumWorkerThreads;
+
+	for (uint32 nPriorityLevel = 0; nPriorityLevel < eNumPriorityLevel; ++nPriorityLevel)
+	{
+		rPriorityLevel = nPriorityLevel;
+
+		// 1. own deque, newest job first since its data is most likely still in the cache
+		if (GetDeque(nWorkerId, nPriorityLevel).Pop(rInfoBlock))
+			return true;
+
+		// 2. jobs added from non worker threads
+		if (PullFromSharedQueue(nPriorityLevel, rInfoBlock))
+			return true;
+
+		// 3. steal the oldest job from another worker, start with our neighbour to spread the victims
+		for (uint32 i = 1; i < nNumWorkers; ++i)
+		{
+			const uint32 nVictim = (nWorkerId + i) % nNumWorkers;
+			if (GetDeque(nVictim, nPriorityLevel).Steal(rInfoBlock))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool JobManager::WorkStealingBackEnd::CWorkStealingBackEnd::PullFromSharedQueue(uint32 nPriorityLevel, JobManager::SInfoBlock& rInfoBlock)
+{
+	// 1. get our job slot index, only look at the requested priority level
+	uint64 currentPullIndex = ~0;
+	uint64 currentPushIndex = ~0;
+	do
+	{
+		currentPullIndex = CryInterlockedCompareExchange64(alias_cast<volatile int64*>(&m_JobQueue.pull.index), 0, 0);
+		currentPushIndex = CryInterlockedCompareExchange64(alias_cast<volatile int64*>(&m_JobQueue.push.index), 0, 0);
+
+		if (JobManager::SJobQueuePos::ExtractIndex(currentPullIndex, nPriorityLevel) == JobManager::SJobQueuePos::ExtractIndex(currentPushIndex, nPriorityLevel))
+			return false;
+
+		const uint64 newPullIndex = JobManager::SJobQueuePos::IncreaseIndex(currentPullIndex, nPriorityLevel);
+		if (CryInterlockedCompareExchange64(alias_cast<volatile int64*>(&m_JobQueue.pull.index), newPullIndex, currentPullIndex) == currentPullIndex)
+			break;
+	}
+	while (true);
+
+	// compute our jobslot index from the only increasing publish index
+	uint32 nExtractedCurIndex = static_cast<uint32>(JobManager::SJobQueuePos::ExtractIndex(currentPullIndex, nPriorityLevel));
+	uint32 nNumWorkerQueueJobs = m_JobQueue.GetMaxWorkerQueueJobs(nPriorityLevel);
+	uint32 nJobSlot = nExtractedCurIndex & (nNumWorkerQueueJobs - 1);
+
+	// 2. Wait till the producer has finished writing all data to the SInfoBlock
+	JobManager::detail::SJobQueueSlotState* pJobInfoBlockState = &m_JobQueue.jobInfoBlockStates[nPriorityLevel][nJobSlot];
+	int iter = 0;
+	while (!pJobInfoBlockState->IsReady())
+	{
+		CrySleep(iter++ > 10 ? 1 : 0);
+	}
+
+	// 3. Get a local copy of the info block as soon as it is ready to be used
+	JobManager::SInfoBlock* pCurrentJobSlot = &m_JobQueue.jobInfoBlocks[nPriorityLevel][nJobSlot];
+	pCurrentJobSlot->AssignMembersTo(&rInfoBlock);
+
+	// 4. Remark the job state as suspended
+	MemoryBarrier();
+	pJobInfoBlockState->SetNotReady();
+
+	// 5. Mark the jobslot as free again
+	MemoryBarrier();
+	pCurrentJobSlot->Release((1 << JobManager::SJobQueuePos::eBitsPerPriorityLevel) / nNumWorkerQueueJobs);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobManager::WorkStealingBackEnd::CWorkStealingBackEndWorkerThread::SignalStopWork()
+{
+	m_bStop = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobManager::WorkStealingBackEnd::CWorkStealingBackEndWorkerThread::ThreadEntry()
+{
+	// set up thread id
+	JobManager::detail::SetWorkerThreadId(m_nId);
+
+	LARGE_INTEGER freq;
+	double frequency;
+	QueryPerformanceFrequency(&freq);
+	frequency = 1.f / static_cast<double>(freq.QuadPart);
+	uint64 nTicksInJobExecution = 0;
+	const float fMinTimeInJobExecution = 1.0f;
+
+	CJobManager* __restrict pJobManager = CJobManager::Instance();
+
+	do
+	{
+		SInfoBlock infoBlock;
+		uint32 nPriorityLevel = ~0;
+		JobManager::SInfoBlock* pFallbackInfoBlock = JobManager::detail::PopFromFallbackJobList();
+
+		IF (pFallbackInfoBlock, 0)
+		{
+			CRY_PROFILE_REGION(PROFILE_SYSTEM, "JobWorkerThread: Fallback");
+
+			// in case of a fallback job, just get it from the global per thread list
+			pFallbackInfoBlock->AssignMembersTo(&infoBlock);
+			if (!infoBlock.HasQueue())  // copy parameters for non producer/consumer jobs
+			{
+				JobManager::CJobManager::CopyJobParameter(infoBlock.paramSize << 4, infoBlock.GetParamAddress(), pFallbackInfoBlock->GetParamAddress());
+			}
+
+			// free temp info block again
+			delete pFallbackInfoBlock;
+		}
+		else
+		{
+			///////////////////////////////////////////////////////////////////////////
+			// wait for new work
+			// we will only do a real wait if jobs accumulated time was more
+			// than fMinTimeInJobExecution ms, to prevent system calls when we
+			// execute a massive number of small jobs
+			float fMSInJobExecution = static_cast<float>(nTicksInJobExecution * 1000.0f * frequency);
+			if (fMSInJobExecution > fMinTimeInJobExecution || !m_rSemaphore.TryGetJob())
+			{
+				m_rSemaphore.WaitForNewJob(m_nId);
+				nTicksInJobExecution = 0;
+			}
+
+			IF (m_bStop == true, 0)
+				break;
+
+			///////////////////////////////////////////////////////////////////////////
+			// the semaphore count guarantees that a job is available (or about to be published) in one of the queues
+			CSimpleThreadBackOff backoff;
+			while (!m_pBackend->GetJob(m_nId, infoBlock, nPriorityLevel))
+			{
+				backoff.backoff();
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////
+		// now we have a valid SInfoBlock to start work on it
+		// check if it is a producer/consumer queue job
+		IF (infoBlock.HasQueue(), 0)
+		{
+			ThreadBackEnd::CThreadBackEndWorkerThread::DoWorkProducerConsumerQueue(infoBlock);
+		}
+		else
+		{
+			// Now we are safe to use the info block
+			assert(infoBlock.jobInvoker);
+			assert(infoBlock.GetParamAddress());
+
+			// store job start time
+#if defined(JOBMANAGER_SUPPORT_PROFILING)
+			SJobProfilingData* pJobProfilingData = gEnv->GetJobManager()->GetProfilingData(infoBlock.profilerIndex);
+			pJobProfilingData->nStartTime = gEnv->pTimer->GetAsyncTime();
+			pJobProfilingData->nWorkerThread = GetWorkerThreadId();
+#endif
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+			const uint64 nStartTime = JobManager::IWorkerBackEndProfiler::GetTimeSample();
+#endif
+
+			{
+				// call delegator function to invoke job entry
+#if !defined(_RELEASE) || defined(PERFORMANCE_BUILD)
+				const char* jobName = pJobManager->GetJobName(infoBlock.jobInvoker);
+
+				char job_info[128];
+				CFrameProfiler* pProfiler = GetFrameProfilerForName(jobName);
+				CFrameProfilerSection frameProfilerSection2(pProfiler, jobName, jobName, EProfileDescription::SECTION);
+				BROFILER_SECTION(jobName)
+
+				cry_sprintf(job_info, "%s (Prio %u)", jobName, nPriorityLevel);
+
+				CRYPROFILE_SCOPE_PROFILE_MARKER(job_info);
+				CRYPROFILE_SCOPE_PLATFORM_MARKER(job_info);
+#endif
+
+				uint64 nJobStartTicks = CryGetTicks();
+
+				if (infoBlock.jobLambdaInvoker)
+				{
+					infoBlock.jobLambdaInvoker();
+				}
+				else
+				{
+					(*infoBlock.jobInvoker)(infoBlock.GetParamAddress());
+				}
+				nTicksInJobExecution += CryGetTicks() - nJobStartTicks;
+			}
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+			JobManager::IWorkerBackEndProfiler* workerProfiler = m_pBackend->GetBackEndWorkerProfiler();
+			const uint64 nEndTime = JobManager::IWorkerBackEndProfiler::GetTimeSample();
+			workerProfiler->RecordJob(infoBlock.frameProfIndex, m_nId, static_cast<const uint32>(infoBlock.jobId), static_cast<const uint32>(nEndTime - nStartTime));
+#endif
+
+			IF (infoBlock.GetJobState(), 1)
+			{
+				SJobState* pJobState = infoBlock.GetJobState();
+				pJobState->SetStopped();
+			}
+#if defined(JOBMANAGER_SUPPORT_PROFILING)
+			pJobProfilingData->nEndTime = gEnv->pTimer->GetAsyncTime();
+#endif
+		}
+
+	}
+	while (m_bStop == false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(_RELEASE) || defined(PERFORMANCE_BUILD)
+CFrameProfiler* JobManager::WorkStealingBackEnd::CWorkStealingBackEndWorkerThread::GetFrameProfilerForName(const char* name)
+{
+	for (auto& p : m_frameProfilers)
+	{
+		if (p.first == name)
+			return p.second;
+	}
+	CFrameProfiler* pProfiler = detail::GetWorkStealingFrameProfilerForName(name);
+	m_frameProfilers.push_back(std::make_pair(name, pProfiler));
+	return pProfiler;
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+JobManager::WorkStealingBackEnd::CWorkStealingBackEndWorkerThread::CWorkStealingBackEndWorkerThread(CWorkStealingBackEnd* pBackend, ThreadBackEnd::detail::CWaitForJobObject& rSemaphore, uint32 nId) :
+	m_nId(nId),
+	m_bStop(false),
+	m_rSemaphore(rSemaphore),
+	m_pBackend(pBackend)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+JobManager::WorkStealingBackEnd::CWorkStealingBackEndWorkerThread::~CWorkStealingBackEndWorkerThread()
+{
+
+}
@@ -0,0 +1,148 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  File name:   WorkStealingBackEnd.h
+//  Version:     v1.00
+//  Compilers:   Visual Studio.NET
+// -------------------------------------------------------------------------
+//  History:
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef WORK_STEALING_BACKEND_H_
+#define WORK_STEALING_BACKEND_H_
+
+#include <CryThreading/IJobManager.h>
+#include "../JobStructs.h"
+#include "../PCBackEnd/ThreadBackEnd.h"
+
+#include <CryThreading/IThreadManager.h>
+
+namespace JobManager
+{
+class CJobManager;
+class CWorkerBackEndProfiler;
+}
+
+namespace JobManager {
+namespace WorkStealingBackEnd {
+namespace detail {
+
+// single producer/multi consumer deque (Chase-Lev) of job info blocks
+// only the owning worker is allowed to push and pop (LIFO end), all other workers steal (FIFO end)
+// the info blocks are stored in place, a slot state guards a slot against being
+// overwritten by the owner while a thief is still copying it out
+class CWorkStealingDeque
+{
+public:
+	CWorkStealingDeque();
+
+	void Init(uint32 nCapacity);
+	void Release();
+
+	// owner only: returns the info block to fill, or NULL if the deque is full
+	// each successful BeginPush has to be followed by an EndPush to publish the job
+	JobManager::SInfoBlock* BeginPush();
+	void                    EndPush();
+
+	// owner only: takes the most recently pushed job
+	bool Pop(JobManager::SInfoBlock& rInfoBlock);
+
+	// any thread: takes the oldest job, fails if the deque is empty or another thread won the race
+	bool Steal(JobManager::SInfoBlock& rInfoBlock);
+
+	bool IsEmpty() const { return m_nBottom <= m_nTop; }
+
+private:
+	void CopyOut(int64 nPosition, JobManager::SInfoBlock& rInfoBlock);
+
+	CRY_ALIGN(128) volatile int64 m_nTop;                       // position thieves steal from, only advanced by CAS
+	CRY_ALIGN(128) volatile int64 m_nBottom;                    // position the owner pushes to, only written by the owner
+
+	JobManager::SInfoBlock*                 m_pInfoBlocks;      // aligned array of info blocks, indexed by position & m_nMask
+	JobManager::detail::SJobQueueSlotState* m_pInfoBlockStates; // ready == slot holds a job which wasn't copied out yet
+	int64 m_nMask;
+};
+
+} // namespace detail
+
+// forward declarations
+class CWorkStealingBackEnd;
+
+// class to represent a worker thread of the work stealing backend
+class CWorkStealingBackEndWorkerThread : public IThread
+{
+public:
+	CWorkStealingBackEndWorkerThread(CWorkStealingBackEnd* pBackend, ThreadBackEnd::detail::CWaitForJobObject& rSemaphore, uint32 nId);
+	~CWorkStealingBackEndWorkerThread();
+
+	// Start accepting work on thread
+	virtual void ThreadEntry();
+
+	// Signals the thread that it should not accept anymore work and exit
+	void SignalStopWork();
+
+private:
+#if !defined(_RELEASE) || defined(PERFORMANCE_BUILD)
+	// looks up the profilers shared by all workers only on the first use of a job name
+	CFrameProfiler* GetFrameProfilerForName(const char* name);
+
+	std::vector<std::pair<const char*, CFrameProfiler*>> m_frameProfilers;
+#endif
+
+	uint32                                   m_nId;             // id of the worker thread
+	volatile bool                            m_bStop;
+	ThreadBackEnd::detail::CWaitForJobObject& m_rSemaphore;
+	CWorkStealingBackEnd*                    m_pBackend;
+};
+
+// work stealing implementation of the PC backend
+// each worker owns one deque per priority level, jobs added from a worker go into its own deque,
+// jobs added from any other thread go into a shared job queue (same as the thread backend)
+// idle workers first drain their own deque, then the shared queue and finally steal from other workers,
+// always starting with the highest priority level
+// the semaphore counts all available jobs over all queues, as in the thread backend
+class CWorkStealingBackEnd : public IBackend
+{
+public:
+	// instances running at the same time need different worker thread names (printf format with the worker id)
+	explicit CWorkStealingBackEnd(const char* szWorkerThreadName = "JobSystem_Worker_%u");
+	virtual ~CWorkStealingBackEnd();
+
+	bool           Init(uint32 nSysMaxWorker);
+	bool           ShutDown();
+	void           Update() {}
+
+	virtual void   AddJob(JobManager::CJobDelegator& crJob, const JobManager::TJobHandle cJobHandle, JobManager::SInfoBlock& rInfoBlock);
+
+	virtual uint32 GetNumWorkerThreads() const { return m_nNumWorkerThreads; }
+
+	// find a job for a worker which acquired the semaphore, returns false if all queues were empty during the search
+	bool GetJob(uint32 nWorkerId, JobManager::SInfoBlock& rInfoBlock, uint32& rPriorityLevel);
+
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	JobManager::IWorkerBackEndProfiler* GetBackEndWorkerProfiler() const { return m_pBackEndWorkerProfiler; }
+#endif
+
+private:
+	friend class JobManager::CJobManager;
+
+	detail::CWorkStealingDeque& GetDeque(uint32 nWorkerId, uint32 nPriorityLevel) { return m_pWorkerDeques[nWorkerId * eNumPriorityLevel + nPriorityLevel]; }
+	bool                        PullFromSharedQueue(uint32 nPriorityLevel, JobManager::SInfoBlock& rInfoBlock);
+
+	JobManager::SJobQueue_ThreadBackEnd              m_JobQueue;          // shared job queue for jobs added from non worker threads
+	ThreadBackEnd::detail::CWaitForJobObject         m_Semaphore;         // semaphore to count available jobs, to allow the workers to go sleeping instead of spinning when no work is required
+	detail::CWorkStealingDeque*                      m_pWorkerDeques;     // eNumPriorityLevel deques per worker
+	std::vector<CWorkStealingBackEndWorkerThread*>   m_arrWorkerThreads;  // array of worker threads
+	uint8 m_nNumWorkerThreads;                                            // number of worker threads
+	const char*                                      m_szWorkerThreadName; // format of the worker thread names
+
+	// members required for profiling jobs in the frame profiler
+#if defined(JOBMANAGER_SUPPORT_FRAMEPROFILER)
+	JobManager::IWorkerBackEndProfiler* m_pBackEndWorkerProfiler;
+#endif
+};
+
+} // namespace WorkStealingBackEnd
+} // namespace JobManager
+
+#endif // WORK_STEALING_BACKEND_H_
@@ -132,6 +132,10 @@ CLog::CLog(ISystem* pSystem)
 	, m_topIndenter(nullptr)
 #endif
 	, m_pLogIncludeTime(nullptr)
+	, m_pLogAsync(nullptr)
+	, m_lastLineTime(0)
+	, m_firstLineTime(0)
+	, m_serverTime(0)
 	, m_pConsole(nullptr)
 	, m_iLastHistoryItem(0)
 #if KEEP_LOG_FILE_OPEN
@@ -212,6 +216,22 @@ void CLog::RegisterConsoleVariables()
 #if KEEP_LOG_FILE_OPEN
 		REGISTER_COMMAND("log_flush", &LogFlushFile, 0, "Flush the log file");
 #endif
+
+		m_pLogAsync = REGISTER_INT("log_Async", 0, VF_NULL,
+		                           "Writes the log file on a writer thread, the threads logging only queue their messages.\n"
+		                           "Usage: log_Async [0/1/2]\n"
+		                           "  0=off, the main thread writes the file (default)\n"
+		                           "  1=text, the messages are formatted by the logging thread\n"
+		                           "  2=binary, messages for the file only are queued unformatted and everything is written to the .binlog\n"
+		                           "    file next to the log file instead, see log_DecodeBinary\n"
+		                           "Messages written by the writer thread aren't sent to the debugger output.");
+		CAsyncLogWriter::RegisterCVars();
+		REGISTER_COMMAND("log_DecodeBinary", &LogDecodeBinary, 0,
+		                 "Formats the messages of a log written with log_Async 2 into a text file.\n"
+		                 "Usage: log_DecodeBinary [binlog file] [text file]");
+		REGISTER_COMMAND("log_AsyncBenchmark", &LogAsyncBenchmark, VF_CHEAT,
+		                 "Logs to the file from several threads, with each log_Async mode, and reports the log calls per second.\n"
+		                 "Usage: log_AsyncBenchmark [numThreads] [callsPerThread]");
 	}
 	/*
 	   //testbed
@@ -257,6 +277,8 @@ CLog::~CLog()
 	assert(m_indentation == 0);
 #endif
 
+	m_asyncLogWriter.Stop();
+
 	CreateBackupFile();
 
 	UnregisterConsoleVariables();
@@ -272,6 +294,7 @@ void CLog::UnregisterConsoleVariables()
 	m_pLogVerbosityOverridesWriteToFile = 0;
 	m_pLogIncludeTime = 0;
 	m_pLogSpamDelay = 0;
+	m_pLogAsync = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -472,6 +495,14 @@ void CLog::LogV(const ELogType type, int flags, const char* szFormat, va_list ar
 		return;
 	}
 
+	// messages for the file only, which aren't checked for spam and don't go to the validator or the remote console
+	if (bfile && !bconsole && type != eWarning && type != eWarningAlways && type != eError && type != eErrorAlways
+	    && !(m_pLogSpamDelay && m_pLogSpamDelay->GetFVal() > 0.0f) && !GetISystem()->GetIRemoteConsole()->IsStarted()
+	    && LogBinary(type, szCommand, args))
+	{
+		return;
+	}
+
 	bool bError = false;
 
 	const char* szPrefix = nullptr;
@@ -661,6 +692,7 @@ void CLog::LogStringToConsole(const char* szString, bool bAdd)
 		msg.bAdd = bAdd;
 		msg.bError = false;
 		msg.bConsole = true;
+		msg.bCallbacksOnly = false;
 		// don't try to store the log message for later in case of out of memory, since then its very likely that this allocation
 		// also fails and results in a stack overflow. This way we should at least get a out of memory on-screen message instead of
 		// a not obvious crash
@@ -872,60 +904,28 @@ const char* CLog::GetAssetScopeString()
 
 //////////////////////////////////////////////////////////////////////
 #if !defined(EXCLUDE_NORMAL_LOG)
-void CLog::LogStringToFile(const char* szString, bool bAdd, bool bError)
+//////////////////////////////////////////////////////////////////////
+// Removes the color codes and adds the indentation and the time as set by log_IncludeTime
+void CLog::DecorateFileString(LogStringType& str, bool bIndent)
 {
-	#if defined(_RELEASE) && defined(EXCLUDE_NORMAL_LOG) // no file logging in release
-	return;
-	#endif
-
-	if (!szString)
-	{
-		return;
-	}
-
-	//////////////////////////////////////////////////////////////////////////
-	if (CryGetCurrentThreadId() != m_nMainThreadId && m_eLogMode != eLogMode_AppCrash)
-	{
-		// When logging from other thread then main, push all log strings to queue.
-		SLogMsg msg;
-		msg.msg = szString;
-		msg.bAdd = bAdd;
-		msg.bError = bError;
-		msg.bConsole = false;
-		// don't try to store the log message for later in case of out of memory, since then its very likely that this allocation
-		// also fails and results in a stack overflow. This way we should at least get a out of memory on-screen message instead of
-		// a not obvious crash
-		if (gEnv->bIsOutOfMemory == false)
-		{
-			m_threadSafeMsgQueue.push(msg);
-		}
-		return;
-	}
-	//////////////////////////////////////////////////////////////////////////
-
-	if (!m_pSystem)
-	{
-		return;
-	}
-
-	LogStringType tempString;
-	tempString = szString;
-
 	// Skip any non character.
-	if (tempString.length() > 0 && tempString.at(0) < 32)
+	if (str.length() > 0 && str.at(0) < 32)
 	{
-		tempString.erase(0, 1);
+		str.erase(0, 1);
 	}
 
-	RemoveColorCodeInPlace(tempString);
+	RemoveColorCodeInPlace(str);
 
 	#if defined(SUPPORT_LOG_IDENTER)
-	if (m_topIndenter)
+	if (bIndent)
 	{
-		m_topIndenter->DisplaySectionText();
-	}
+		if (m_topIndenter)
+		{
+			m_topIndenter->DisplaySectionText();
+		}
 
-	tempString = m_indentWithString + tempString;
+		str = m_indentWithString + str;
+	}
 	#endif
 
 	if (m_pLogIncludeTime && gEnv->pTimer)
@@ -936,9 +936,10 @@ void CLog::LogStringToFile(const char* szString, bool bAdd, bool bError)
 		{
 			if (gEnv->pGame)
 			{
-				CTimeValue serverTime = gEnv->pGame->GetIGameFramework()->GetServerTime();
-				cry_sprintf(sTime, "<%.2f> ", serverTime.GetSeconds());
-				tempString.insert(0, sTime);
+				if (CryGetCurrentThreadId() == m_nMainThreadId)
+					m_serverTime = gEnv->pGame->GetIGameFramework()->GetServerTime().GetValue();
+				cry_sprintf(sTime, "<%.2f> ", CTimeValue(m_serverTime).GetSeconds());
+				str.insert(0, sTime);
 			}
 			dwCVarState = 1; // Afterwards insert time as-if Log_IncludeTime == 1
 		}
@@ -951,39 +952,81 @@ void CLog::LogStringToFile(const char* szString, bool bAdd, bool bError)
 				struct tm* today = localtime(&ltime);
 				strftime(sTime, CRY_ARRAY_COUNT(sTime), "<%H:%M:%S> ", today);
 				sTime[CRY_ARRAY_COUNT(sTime) - 1] = 0;
-				tempString.insert(0, sTime);
+				str.insert(0, sTime);
 			}
 			if (dwCVarState & 2) // Log_IncludeTime
 			{
-				static CTimeValue lasttime;
 				const CTimeValue currenttime = gEnv->pTimer->GetAsyncTime();
+				const CTimeValue lasttime = CryInterlockedExchange64(&m_lastLineTime, currenttime.GetValue());
 				if (lasttime != CTimeValue())
 				{
 					const uint32 dwMs = (uint32)((currenttime - lasttime).GetMilliSeconds());
 					cry_sprintf(sTime, "<%3u.%.3u>: ", dwMs / 1000, dwMs % 1000);
-					tempString.insert(0, sTime);
+					str.insert(0, sTime);
 				}
-				lasttime = currenttime;
 			}
 		}
 		else if (dwCVarState == 4) // Log_IncludeTime
 		{
-			static bool bFirst = true;
-			static CTimeValue lasttime;
 			const CTimeValue currenttime = gEnv->pTimer->GetAsyncTime();
-			if (lasttime != CTimeValue())
+			const CTimeValue firsttime = CryInterlockedCompareExchange64(&m_firstLineTime, currenttime.GetValue(), 0);
+			if (firsttime != CTimeValue())
 			{
-				const uint32 dwMs = (uint32)((currenttime - lasttime).GetMilliSeconds());
+				const uint32 dwMs = (uint32)((currenttime - firsttime).GetMilliSeconds());
 				cry_sprintf(sTime, "<%3u.%.3u>: ", dwMs / 1000, dwMs % 1000);
-				tempString.insert(0, sTime);
-			}
-			if (bFirst)
-			{
-				lasttime = currenttime;
-				bFirst = false;
+				str.insert(0, sTime);
 			}
 		}
 	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void CLog::LogStringToFile(const char* szString, bool bAdd, bool bError)
+{
+	#if defined(_RELEASE) && defined(EXCLUDE_NORMAL_LOG) // no file logging in release
+	return;
+	#endif
+
+	if (!szString)
+	{
+		return;
+	}
+
+	if (m_asyncLogWriter.IsRunning() && m_eLogMode != eLogMode_AppCrash && LogStringToFileAsync(szString, bAdd, bError))
+	{
+		return;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	if (CryGetCurrentThreadId() != m_nMainThreadId && m_eLogMode != eLogMode_AppCrash)
+	{
+		// When logging from other thread then main, push all log strings to queue.
+		SLogMsg msg;
+		msg.msg = szString;
+		msg.bAdd = bAdd;
+		msg.bError = bError;
+		msg.bConsole = false;
+		msg.bCallbacksOnly = false;
+		// don't try to store the log message for later in case of out of memory, since then its very likely that this allocation
+		// also fails and results in a stack overflow. This way we should at least get a out of memory on-screen message instead of
+		// a not obvious crash
+		if (gEnv->bIsOutOfMemory == false)
+		{
+			m_threadSafeMsgQueue.push(msg);
+		}
+		return;
+	}
+	//////////////////////////////////////////////////////////////////////////
+
+	if (!m_pSystem)
+	{
+		return;
+	}
+
+	LogStringType tempString;
+	tempString = szString;
+
+	DecorateFileString(tempString, true);
 
 	#if !KEEP_LOG_FILE_OPEN
 	// add \n at end.
@@ -1076,6 +1119,70 @@ void CLog::LogStringToFile(const char* szString, bool bAdd, bool bError)
 	#endif
 }
 
+//////////////////////////////////////////////////////////////////////
+// Decorates the string on the calling thread and queues it for the writer thread of log_Async.
+// The callbacks are still only called by the main thread.
+bool CLog::LogStringToFileAsync(const char* szString, bool bAdd, bool bError)
+{
+	const bool bMainThread = CryGetCurrentThreadId() == m_nMainThreadId;
+
+	LogStringType tempString;
+	tempString = szString;
+	DecorateFileString(tempString, bMainThread);
+
+	const int logToFile = m_pLogWriteToFile ? m_pLogWriteToFile->GetIVal() : 1;
+	if (logToFile && !m_asyncLogWriter.WriteText(tempString.c_str(), bAdd, bError))
+	{
+		return false;
+	}
+
+	if (!m_callbacks.empty())
+	{
+	#if !KEEP_LOG_FILE_OPEN
+		if (tempString.empty() || tempString[tempString.length() - 1] != '\n')
+		{
+			tempString += '\n';
+		}
+	#endif
+
+		if (bMainThread)
+		{
+			for (Callbacks::iterator it = m_callbacks.begin(); it != m_callbacks.end(); ++it)
+			{
+				(*it)->OnWriteToFile(tempString.c_str(), !bAdd);
+			}
+		}
+		else if (gEnv->bIsOutOfMemory == false)
+		{
+			SLogMsg msg;
+			msg.msg = tempString;
+			msg.bAdd = bAdd;
+			msg.bError = bError;
+			msg.bConsole = false;
+			msg.bCallbacksOnly = true;
+			m_threadSafeMsgQueue.push(msg);
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// With the binary log, messages only going to the file are queued without formatting them
+bool CLog::LogBinary(ELogType type, const char* szFormat, va_list args)
+{
+	if (m_asyncLogWriter.GetMode() != CAsyncLogWriter::eMode_Binary || m_eLogMode == eLogMode_AppCrash || !m_callbacks.empty())
+	{
+		return false;
+	}
+	if (m_pLogWriteToFile && !m_pLogWriteToFile->GetIVal())
+	{
+		return false;
+	}
+
+	return m_asyncLogWriter.WriteBinary((uint8)type, szFormat, args);
+}
+
 //same as above but to a file
 //////////////////////////////////////////////////////////////////////
 void CLog::LogToFilePlus(const char* szFormat, ...)
@@ -1126,6 +1233,11 @@ void CLog::LogToFile(const char* szFormat, ...)
 	LogStringType temp;
 	va_list arglist;
 	va_start(arglist, szFormat);
+	if (LogBinary(eMessage, szCommand, arglist))
+	{
+		va_end(arglist);
+		return;
+	}
 	temp.FormatV(szCommand, arglist);
 	va_end(arglist);
 
@@ -1323,6 +1435,9 @@ bool CLog::SetFileName(const char* filename)
 	if (temp.empty() || temp.size() >= sizeof(m_szFilename))
 		return false;
 
+	// the writer thread is started again for the new file by the next Update
+	m_asyncLogWriter.Stop();
+
 	cry_strcpy(m_szFilename, temp.c_str());
 
 	CreateBackupFile();
@@ -1443,10 +1558,23 @@ void CLog::Update()
 
 	if (CryGetCurrentThreadId() == m_nMainThreadId)
 	{
+		UpdateAsyncMode();
+
+		// for the lines of the other threads
+		if (gEnv->pGame && m_pLogIncludeTime && m_pLogIncludeTime->GetIVal() == 5)
+			m_serverTime = gEnv->pGame->GetIGameFramework()->GetServerTime().GetValue();
+
 		auto messages = m_threadSafeMsgQueue.pop_all();
 		for (const SLogMsg& msg : messages)
 		{
-			if (msg.bConsole)
+			if (msg.bCallbacksOnly)
+			{
+				for (Callbacks::iterator it = m_callbacks.begin(); it != m_callbacks.end(); ++it)
+				{
+					(*it)->OnWriteToFile(msg.msg.c_str(), !msg.bAdd);
+				}
+			}
+			else if (msg.bConsole)
 				LogStringToConsole(msg.msg, msg.bAdd);
 			else
 				LogStringToFile(msg.msg, msg.bAdd, msg.bConsole);
@@ -1484,6 +1612,7 @@ const char* CLog::GetModuleFilter()
 void CLog::Flush()
 {
 	Update();
+	m_asyncLogWriter.Flush();
 #if KEEP_LOG_FILE_OPEN
 	if (m_pLogFile)
 	{
@@ -1495,6 +1624,7 @@ void CLog::Flush()
 void CLog::FlushAndClose()
 {
 	Update();
+	m_asyncLogWriter.Stop();
 #if KEEP_LOG_FILE_OPEN
 	if (m_pLogFile)
 	{
@@ -1510,8 +1640,144 @@ void CLog::LogFlushFile(IConsoleCmdArgs* pArgs)
 }
 #endif
 
+//////////////////////////////////////////////////////////////////////////
+void CLog::UpdateAsyncMode()
+{
+	const int mode = m_pLogAsync ? clamp_tpl(m_pLogAsync->GetIVal(), (int)CAsyncLogWriter::eMode_Off, (int)CAsyncLogWriter::eMode_Binary) : (int)CAsyncLogWriter::eMode_Off;
+	if (mode == m_asyncLogWriter.GetMode())
+		return;
+
+	m_asyncLogWriter.Stop();
+	if (mode == CAsyncLogWriter::eMode_Off || !m_szFilename[0])
+		return;
+
+#if KEEP_LOG_FILE_OPEN
+	// the lines buffered by the main thread go first
+	CloseLogFile(true);
+#endif
+
+	if (!m_asyncLogWriter.Start(m_szFilename, (CAsyncLogWriter::EMode)mode))
+	{
+		m_pLogAsync->Set(CAsyncLogWriter::eMode_Off);
+		LogWarning("log_Async: can't start the writer thread for %s", m_szFilename);
+	}
+}
+
+namespace
+{
+class CLogBenchmarkThread : public IThread
+{
+public:
+	CLogBenchmarkThread(uint32 threadIndex, uint32 numCalls)
+		: m_threadIndex(threadIndex)
+		, m_numCalls(numCalls)
+	{
+	}
+
+protected:
+	virtual void ThreadEntry()
+	{
+		for (uint32 i = 0; i < m_numCalls; ++i)
+		{
+			gEnv->pLog->LogToFile("Log benchmark: thread %u, message %u, value %.3f, %s", m_threadIndex, i, (float)i * 0.25f, "argument");
+		}
+	}
+
+private:
+	uint32 m_threadIndex;
+	uint32 m_numCalls;
+};
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The calls/s are for the logging threads only, the time until all is written includes the main thread or the writer thread writing the file.
+void CLog::LogAsyncBenchmark(IConsoleCmdArgs* pArgs)
+{
+	ICVar* pAsyncCVar = gEnv->pConsole->GetCVar("log_Async");
+	ICVar* pFileVerbosityCVar = gEnv->pConsole->GetCVar("log_WriteToFileVerbosity");
+	if (!pAsyncCVar || !gEnv->pTimer)
+		return;
+	if (pFileVerbosityCVar && pFileVerbosityCVar->GetIVal() < 2)
+	{
+		CryLogAlways("log_AsyncBenchmark: log_WriteToFileVerbosity has to be 2 or higher");
+		return;
+	}
+
+	const uint32 numThreads = pArgs->GetArgCount() > 1 ? (uint32)clamp_tpl(atoi(pArgs->GetArg(1)), 1, 64) : 4u;
+	const uint32 numCalls = pArgs->GetArgCount() > 2 ? (uint32)max(atoi(pArgs->GetArg(2)), 1) : 10000u;
+
+	CryLogAlways("== Log benchmark: %u threads logging %u messages each ==", numThreads, numCalls);
+
+	static const char* szModeNames[] = { "synchronous", "async text", "async binary" };
+	const int oldMode = pAsyncCVar->GetIVal();
+	std::vector<CLogBenchmarkThread*> threads(numThreads);
+
+	for (int mode = CAsyncLogWriter::eMode_Off; mode <= CAsyncLogWriter::eMode_Binary; ++mode)
+	{
+		pAsyncCVar->Set(mode);
+		gEnv->pLog->Update(); // starts or stops the writer thread
+
+		const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+		uint32 numSpawned = 0;
+		for (uint32 i = 0; i < numThreads; ++i)
+		{
+			threads[i] = new CLogBenchmarkThread(i, numCalls);
+			if (!gEnv->pThreadManager->SpawnThread(threads[i], "LogBenchmark_%u", i))
+			{
+				SAFE_DELETE(threads[i]);
+				continue;
+			}
+			++numSpawned;
+		}
+		for (uint32 i = 0; i < numThreads; ++i)
+		{
+			if (threads[i])
+			{
+				gEnv->pThreadManager->JoinThread(threads[i], eJM_Join);
+				SAFE_DELETE(threads[i]);
+			}
+		}
+		const float callTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+		// the main thread writes what the other threads queued, or waits for the writer thread to write it
+		gEnv->pLog->Flush();
+		const float totalTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+		CryLogAlways("  %-12s: %.0f log calls/s, %.2f ms until all is written",
+		             szModeNames[mode], (float)numSpawned * numCalls / max(callTime * 0.001f, FLT_EPSILON), totalTime);
+	}
+
+	pAsyncCVar->Set(oldMode);
+	gEnv->pLog->Update();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CLog::LogDecodeBinary(IConsoleCmdArgs* pArgs)
+{
+	string binaryFileName;
+	if (pArgs->GetArgCount() > 1)
+		binaryFileName = pArgs->GetArg(1);
+	else
+		CAsyncLogWriter::GetBinaryFileName(gEnv->pLog->GetFileName(), binaryFileName);
+	const string textFileName = pArgs->GetArgCount() > 2 ? string(pArgs->GetArg(2)) : PathUtil::ReplaceExtension(binaryFileName, "decoded.log");
+
+	// in case it's the log being written
+	gEnv->pLog->Flush();
+
+	if (CAsyncLogWriter::DecodeBinary(binaryFileName.c_str(), textFileName.c_str()))
+		CryLogAlways("log_DecodeBinary: written %s", textFileName.c_str());
+	else
+		CryLogAlways("log_DecodeBinary: can't decode %s", binaryFileName.c_str());
+}
+
 void CLog::SetLogMode(ELogMode eLogMode)
 {
+	// from now on the crashing thread writes the file itself, after what's queued already
+	if (eLogMode == eLogMode_AppCrash && m_eLogMode != eLogMode_AppCrash)
+	{
+		m_asyncLogWriter.Flush(500);
+	}
+
 	m_eLogMode = eLogMode;
 }
 
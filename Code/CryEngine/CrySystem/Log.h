@@ -5,6 +5,7 @@
 #include <CrySystem/ILog.h>
 #include <CryThreading/CryAtomics.h>
 #include <CryThreading/MultiThread_Containers.h>
+#include "AsyncLogWriter.h"
 
 //////////////////////////////////////////////////////////////////////
 
@@ -86,14 +87,24 @@ private: // -------------------------------------------------------------------
 #if !defined(EXCLUDE_NORMAL_LOG)
 	void LogStringToFile(const char* szString, bool bAdd, bool bError = false);
 	void LogStringToConsole(const char* szString, bool bAdd = false);
+	bool LogStringToFileAsync(const char* szString, bool bAdd, bool bError);
+	bool LogBinary(ELogType type, const char* szFormat, va_list args);
+	void DecorateFileString(LogStringType& str, bool bIndent);
 #else
 	void LogStringToFile(const char* szString, bool bAdd, bool bError = false) {};
 	void LogStringToConsole(const char* szString, bool bAdd = false)           {};
+	bool LogBinary(ELogType type, const char* szFormat, va_list args)          { return false; }
 #endif // !defined(EXCLUDE_NORMAL_LOG)
 
 	FILE* OpenLogFile(const char* filename, const char* mode);
 	void  CloseLogFile(bool force = false);
 
+	// starts or stops the writer thread when log_Async changed
+	void  UpdateAsyncMode();
+
+	static void LogAsyncBenchmark(IConsoleCmdArgs* pArgs);
+	static void LogDecodeBinary(IConsoleCmdArgs* pArgs);
+
 	// will format the message into m_szTemp
 	void FormatMessage(const char* szCommand, ...) PRINTF_PARAMS(2, 3);
 
@@ -133,6 +144,14 @@ private: // -------------------------------------------------------------------
 #endif
 
 	ICVar*             m_pLogIncludeTime;                 //
+	ICVar*             m_pLogAsync;                       //
+
+	CAsyncLogWriter    m_asyncLogWriter;
+
+	// log_IncludeTime state, lines are decorated on the logging threads with log_Async
+	volatile int64     m_lastLineTime;    // 2: of the previous line
+	volatile int64     m_firstLineTime;   // 4: of the first line
+	volatile int64     m_serverTime;      // 5: sampled on the main thread, the game framework isn't thread safe
 
 	IConsole*          m_pConsole;                        //
 
@@ -195,6 +214,7 @@ public: // -------------------------------------------------------------------
 		bool          bError;
 		bool          bAdd;
 		bool          bConsole;
+		bool          bCallbacksOnly; // written by the async log writer already
 		void          GetMemoryUsage(ICrySizer* pSizer) const {}
 	};
 	CryMT::queue<SLogMsg>              m_threadSafeMsgQueue;
@@ -31,10 +31,13 @@ struct PakVars
 	int nLogInvalidFileAccess;
 	int nLoadFrontendShaderCache;
 	int nUncachedStreamReads;
+	int nMappedPaks;
 #ifndef _RELEASE
 	int nLogAllFileAccess;
 #endif
 	int nDisableNonLevelRelatedPaks;
+	int nPathIndex;
+	int nNegativeLookupCache;
 
 	PakVars()
 		: nPriority(0)
@@ -47,6 +50,7 @@ struct PakVars
 		, nSaveLevelResourceList(0)
 		, nValidateFileHashes(0)
 		, nUncachedStreamReads(1)
+		, nMappedPaks(0)
 	{
 		nInMemoryPerPakSizeLimit = 6;    // 6 Megabytes limit
 		nTotalInMemoryPakSizeLimit = 30; // Megabytes
@@ -78,6 +82,8 @@ struct PakVars
 
 		nLoadFrontendShaderCache = 0;
 		nDisableNonLevelRelatedPaks = 1;
+		nPathIndex = 1;
+		nNegativeLookupCache = 0;
 	}
 };
 
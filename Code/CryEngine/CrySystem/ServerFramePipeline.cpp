@@ -0,0 +1,218 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include <StdAfx.h>
+#include "ServerFramePipeline.h"
+#include <CrySystem/ISystem.h>
+#include <CrySystem/ITimer.h>
+#include <CrySystem/IConsole.h>
+#include <CryScriptSystem/IScriptSystem.h>
+
+static const char* const s_stageNames[eSFS_Count] =
+{
+	"NetworkReceive",
+	"GameRules",
+	"Entity",
+	"Physics",
+	"AI",
+	"NetworkSend",
+};
+
+CServerFramePipeline::SStageStats::SStageStats()
+	: frameTimeMS(0.0f)
+	, budgetMS(0.0f)
+{
+	memset(history, 0, sizeof(history));
+}
+
+CServerFramePipeline::CServerFramePipeline(ISystem* pSystem)
+#if ENABLE_STATOSCOPE
+	: m_statoscopeDG(*this)
+	, m_nFrames(0)
+#else
+	: m_nFrames(0)
+#endif
+	, m_bInFrame(false)
+	, m_nEnabled(0)
+	, m_nWarnOverBudget(1)
+{
+	REGISTER_CVAR2("sv_DedicatedFramePipeline", &m_nEnabled, m_nEnabled, VF_NULL,
+	               "Drives the dedicated server frame as fixed stages with per stage budgets (sys_budget_server_*).\n"
+	               "Frames start on a fixed tick deadline of sv_DedicatedMaxRate instead of the averaged sleep.\n"
+	               "Usage: sv_DedicatedFramePipeline [0/1]\n"
+	               "Default is 0 (off).");
+	REGISTER_CVAR2("sv_DedicatedFramePipelineWarn", &m_nWarnOverBudget, m_nWarnOverBudget, VF_NULL,
+	               "Logs a warning (at most once per second and stage) when a stage of the dedicated server frame exceeds its budget.\n"
+	               "Usage: sv_DedicatedFramePipelineWarn [0/1]\n"
+	               "Default is 1 (on).");
+
+#if ENABLE_STATOSCOPE
+	if (gEnv->pStatoscope)
+		gEnv->pStatoscope->RegisterDataGroup(&m_statoscopeDG);
+#endif
+}
+
+CServerFramePipeline::~CServerFramePipeline()
+{
+#if ENABLE_STATOSCOPE
+	if (gEnv->pStatoscope)
+		gEnv->pStatoscope->UnregisterDataGroup(&m_statoscopeDG);
+#endif
+
+	if (gEnv->pConsole)
+	{
+		gEnv->pConsole->UnregisterVariable("sv_DedicatedFramePipeline");
+		gEnv->pConsole->UnregisterVariable("sv_DedicatedFramePipelineWarn");
+	}
+}
+
+const char* CServerFramePipeline::GetStageName(EServerFrameStage stage)
+{
+	assert(stage >= 0 && stage < eSFS_Count);
+	return s_stageNames[stage];
+}
+
+CTimeValue CServerFramePipeline::WaitForNextTick(float tickRate)
+{
+	FUNCTION_PROFILER(gEnv->pSystem, PROFILE_SYSTEM);
+
+	ITimer* const pTimer = gEnv->pTimer;
+	const CTimeValue tickLength(1.0f / CLAMP(tickRate, 5.0f, 500.0f));
+	CTimeValue now = pTimer->GetAsyncTime();
+
+	// a frame which took longer than a whole tick starts the schedule over, catching up by running several
+	// short frames in a row would only move the spike to the clients
+	if (m_nextTickTime.GetValue() == 0 || (now - m_nextTickTime) > tickLength)
+		m_nextTickTime = now;
+
+	// the wait is spent on the script garbage collection first, leaving a margin for the last step
+	if (gEnv->pScriptSystem && (m_nextTickTime - now).GetMilliSeconds() > 1.0f)
+	{
+		gEnv->pScriptSystem->CollectGarbageIdle((m_nextTickTime - now).GetMilliSeconds() - 1.0f);
+		now = pTimer->GetAsyncTime();
+	}
+
+	// sleep in whole milliseconds while the deadline is far enough away, then yield until it's reached
+	const float remainingMS = (m_nextTickTime - now).GetMilliSeconds();
+	if (remainingMS > 2.0f)
+		CrySleep((unsigned int)(remainingMS - 1.0f));
+	while ((now = pTimer->GetAsyncTime()) < m_nextTickTime)
+		CrySleep(0);
+
+	SStageStats& tickStats = m_stats[TICK_STATS_SLOT];
+	tickStats.frameTimeMS = (now - m_nextTickTime).GetMilliSeconds();
+	tickStats.budgetMS = tickLength.GetMilliSeconds();
+
+	m_nextTickTime += tickLength;
+
+	for (uint32 i = 0; i < eSFS_Count; ++i)
+		m_stats[i].frameTimeMS = 0.0f;
+	m_bInFrame = true;
+
+	return now;
+}
+
+void CServerFramePipeline::EndFrame()
+{
+	if (!m_bInFrame)
+		return;
+	m_bInFrame = false;
+
+	const IBudgetingSystem* pBudgetingSystem = gEnv->pSystem->GetIBudgetingSystem();
+	const CTimeValue now = gEnv->pTimer->GetAsyncTime();
+	const uint32 historyIndex = m_nFrames % HISTORY_SIZE;
+
+	for (uint32 i = 0; i < NUM_STATS_SLOTS; ++i)
+	{
+		SStageStats& stats = m_stats[i];
+		if (i != TICK_STATS_SLOT)
+			stats.budgetMS = pBudgetingSystem ? pBudgetingSystem->GetServerFrameStageLimit((EServerFrameStage)i) : 0.0f;
+
+		stats.history[historyIndex] = stats.frameTimeMS;
+
+		if (m_nWarnOverBudget && i != TICK_STATS_SLOT && stats.budgetMS > 0.0f && stats.frameTimeMS > stats.budgetMS
+		    && (now - stats.lastWarningTime).GetSeconds() >= 1.0f)
+		{
+			stats.lastWarningTime = now;
+			CryLogAlways("ServerFramePipeline: %s took %.2f ms, budget is %.2f ms", s_stageNames[i], stats.frameTimeMS, stats.budgetMS);
+		}
+	}
+
+	++m_nFrames;
+}
+
+void CServerFramePipeline::BeginStage(EServerFrameStage stage)
+{
+	m_stats[stage].startTime = gEnv->pTimer->GetAsyncTime();
+}
+
+void CServerFramePipeline::EndStage(EServerFrameStage stage)
+{
+	SStageStats& stats = m_stats[stage];
+	stats.frameTimeMS += (gEnv->pTimer->GetAsyncTime() - stats.startTime).GetMilliSeconds();
+}
+
+void CServerFramePipeline::Summarize(uint32 slot, SSummary& summary) const
+{
+	const SStageStats& stats = m_stats[slot];
+	const uint32 numFrames = min((uint32)m_nFrames, (uint32)HISTORY_SIZE);
+
+	memset(&summary, 0, sizeof(summary));
+	summary.lastMS = m_nFrames ? stats.history[(m_nFrames - 1) % HISTORY_SIZE] : 0.0f;
+	summary.budgetMS = stats.budgetMS;
+	if (!numFrames)
+		return;
+
+	float sorted[HISTORY_SIZE];
+	memcpy(sorted, stats.history, numFrames * sizeof(float));
+	std::sort(sorted, sorted + numFrames);
+
+	static const float percentiles[] = { 0.5f, 0.95f, 0.99f };
+	for (uint32 i = 0; i < CRY_ARRAY_COUNT(percentiles); ++i)
+		summary.percentileMS[i] = sorted[min((uint32)(percentiles[i] * numFrames), numFrames - 1)];
+	summary.maxMS = sorted[numFrames - 1];
+
+	// counted against the current budget, which may have changed since the older frames
+	if (stats.budgetMS > 0.0f)
+		summary.numOverBudget = (uint32)(sorted + numFrames - std::upper_bound(sorted, sorted + numFrames, stats.budgetMS));
+
+	for (uint32 i = 0; i < numFrames; ++i)
+	{
+		uint32 bucket = 0;
+		for (float limitMS = 1.0f; bucket < HISTOGRAM_SIZE - 1 && sorted[i] >= limitMS; limitMS *= 2.0f)
+			++bucket;
+		++summary.histogram[bucket];
+	}
+}
+
+#if ENABLE_STATOSCOPE
+IStatoscopeDataGroup::SDescription CServerFramePipeline::SStatoscopeDG::GetDescription() const
+{
+	return SDescription('h', "server frame stages", "['/ServerFrame/$/' (float timeMS) (float budgetMS) (float p50MS) (float p95MS) (float p99MS) (float maxMS) (int overBudget) "
+	                                                "(int lt1ms) (int lt2ms) (int lt4ms) (int lt8ms) (int lt16ms) (int lt32ms) (int ge32ms)]");
+}
+
+uint32 CServerFramePipeline::SStatoscopeDG::PrepareToWrite()
+{
+	return m_pipeline.IsEnabled() ? (uint32)NUM_STATS_SLOTS : 0;
+}
+
+void CServerFramePipeline::SStatoscopeDG::Write(IStatoscopeFrameRecord& fr)
+{
+	for (uint32 i = 0; i < NUM_STATS_SLOTS; ++i)
+	{
+		SSummary summary;
+		m_pipeline.Summarize(i, summary);
+
+		fr.AddValue(i == TICK_STATS_SLOT ? "TickLateness" : s_stageNames[i]);
+		fr.AddValue(summary.lastMS);
+		fr.AddValue(summary.budgetMS);
+		fr.AddValue(summary.percentileMS[0]);
+		fr.AddValue(summary.percentileMS[1]);
+		fr.AddValue(summary.percentileMS[2]);
+		fr.AddValue(summary.maxMS);
+		fr.AddValue((int)summary.numOverBudget);
+		for (uint32 j = 0; j < HISTOGRAM_SIZE; ++j)
+			fr.AddValue((int)summary.histogram[j]);
+	}
+}
+#endif
@@ -0,0 +1,128 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+//
+//	File: ServerFramePipeline.h
+//  Description: Fixed tick scheduling and per stage timing of dedicated
+//               server frames
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef __SERVERFRAMEPIPELINE_H__
+#define __SERVERFRAMEPIPELINE_H__
+
+#pragma once
+
+#include <CrySystem/IBudgetingSystem.h>
+#include <CrySystem/TimeValue.h>
+#include <CrySystem/Profilers/IStatoscope.h>
+
+struct ISystem;
+
+// When sv_DedicatedFramePipeline is set, the dedicated server frame is driven as a fixed sequence of stages:
+// network receive, game rules, entity, physics, AI and network send. The frame starts on an absolute tick
+// deadline derived from sv_DedicatedMaxRate instead of the averaged sleep of CSystem::SleepIfNeeded, so the
+// tick rate doesn't drift with the frame cost. Sending the serialized state is left to the network thread,
+// which overlaps with waiting for the next tick.
+// Each stage is timed against its sys_budget_server_* limit of the budgeting system. A history of the last
+// frames is kept per stage and exported to Statoscope as percentiles and a time histogram.
+class CServerFramePipeline
+{
+public:
+	CServerFramePipeline(ISystem* pSystem);
+	~CServerFramePipeline();
+
+	bool       IsEnabled() const { return m_nEnabled != 0; }
+
+	// Sleeps until the next tick is due and starts a new frame, returns the time the frame started.
+	CTimeValue WaitForNextTick(float tickRate);
+	// Checks the stage times of the frame against their budgets and adds them to the history.
+	void       EndFrame();
+
+	void       BeginStage(EServerFrameStage stage);
+	void       EndStage(EServerFrameStage stage);
+
+	// Times a stage for the current scope, does nothing while the pipeline is disabled.
+	// A stage can be entered several times per frame, the times are accumulated.
+	class CStageScope
+	{
+	public:
+		CStageScope(CServerFramePipeline* pPipeline, EServerFrameStage stage)
+			: m_pPipeline(pPipeline && pPipeline->m_bInFrame ? pPipeline : NULL)
+			, m_stage(stage)
+		{
+			if (m_pPipeline)
+				m_pPipeline->BeginStage(m_stage);
+		}
+		~CStageScope()
+		{
+			if (m_pPipeline)
+				m_pPipeline->EndStage(m_stage);
+		}
+
+	private:
+		CServerFramePipeline* m_pPipeline;
+		EServerFrameStage     m_stage;
+	};
+
+	static const char* GetStageName(EServerFrameStage stage);
+
+private:
+	enum
+	{
+		HISTORY_SIZE    = 256,
+		HISTOGRAM_SIZE  = 7,   // buckets for < 1, 2, 4, 8, 16, 32 and >= 32 ms
+		TICK_STATS_SLOT = eSFS_Count,
+		NUM_STATS_SLOTS = eSFS_Count + 1,
+	};
+
+	struct SStageStats
+	{
+		SStageStats();
+
+		float      history[HISTORY_SIZE]; // times of the last frames in ms
+		float      frameTimeMS;           // accumulated time of the current frame
+		float      budgetMS;
+		CTimeValue startTime;
+		CTimeValue lastWarningTime;
+	};
+
+	struct SSummary
+	{
+		float  lastMS;
+		float  budgetMS;
+		float  percentileMS[3]; // 50th, 95th and 99th
+		float  maxMS;
+		uint32 numOverBudget;   // frames in the history which exceed the current budget
+		uint32 histogram[HISTOGRAM_SIZE];
+	};
+
+#if ENABLE_STATOSCOPE
+	struct SStatoscopeDG : public IStatoscopeDataGroup
+	{
+		SStatoscopeDG(const CServerFramePipeline& pipeline) : m_pipeline(pipeline) {}
+
+		virtual SDescription GetDescription() const;
+		virtual uint32       PrepareToWrite();
+		virtual void         Write(IStatoscopeFrameRecord& fr);
+
+		const CServerFramePipeline& m_pipeline;
+	};
+	friend struct SStatoscopeDG;
+
+	SStatoscopeDG m_statoscopeDG;
+#endif
+
+	void Summarize(uint32 slot, SSummary& summary) const;
+
+	SStageStats m_stats[NUM_STATS_SLOTS]; // stages followed by the tick lateness
+	uint32      m_nFrames;
+	CTimeValue  m_nextTickTime;
+	bool        m_bInFrame;
+
+	int         m_nEnabled;
+	int         m_nWarnOverBudget;
+};
+
+#define SERVER_FRAME_STAGE(pPipeline, stage) CServerFramePipeline::CStageScope serverFrameStage_ ## stage(pPipeline, stage)
+
+#endif
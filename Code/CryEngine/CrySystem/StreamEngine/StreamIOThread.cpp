@@ -48,6 +48,10 @@ CStreamingIOThread::~CStreamingIOThread()
 {
 	SignalStopWork();
 	gEnv->pThreadManager->JoinThread(this, eJM_Join);
+
+	for (size_t i = 0; i < m_readerThreads.size(); ++i)
+		delete m_readerThreads[i];
+	m_readerThreads.clear();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -248,102 +252,48 @@ void CStreamingIOThread::ThreadEntry()
 			{
 				CRY_PROFILE_REGION(PROFILE_SYSTEM, "StreamIO Process High Prio Task Handling");
 
-				// check if request was high prio, then decrease open count
-				if (pFileRequest->IgnoreOutofTmpMem())
+				// keep more reads in flight by handing the following requests of the sorted queue to the reader threads
+				// (not while out of temp memory, then only the request picked above is allowed to proceed)
+				CAsyncIOFileRequest* pBatch[STREAMING_IO_MAX_QUEUE_DEPTH];
+				uint32 nBatchErrors[STREAMING_IO_MAX_QUEUE_DEPTH];
+				uint32 nBatchSize = 0;
+
+				const uint32 nQueueDepth = bIsOOM ? 1 : UpdateQueueDepth();
+				pBatch[nBatchSize++] = pFileRequest.Relinquish();
+				while (nBatchSize < nQueueDepth && !m_fileRequestQueue.empty() && !m_fileRequestQueue.back()->HasFailed())
 				{
-					CryInterlockedDecrement(&m_iUrgentRequests);
+					pBatch[nBatchSize++] = m_fileRequestQueue.back();
+					m_fileRequestQueue.pop_back();
 				}
 
 				bIsOOM = false;
 
-				nSizeOnMedia = pFileRequest->m_nSizeOnMedia;
-				uint32 nError = 0;
-
-				// Handle file request.
-				if (m_bAbortReads)
-					nError = ERROR_ABORTED_ON_SHUTDOWN;
-				else if (pFileRequest->m_bReadBegun)
-					nError = pFileRequest->ReadFileResume(this);
-				else
-					nError = pFileRequest->ReadFile(this);
-
-#ifdef STREAMENGINE_ENABLE_STATS
-				pFileRequest->m_nReadCounter = m_nReadCounter++;
-#endif
-
-				if (nError == 0)
+				for (uint32 i = 0; i < nBatchSize; ++i)
 				{
-					if (pFileRequest->m_eMediaType != eStreamSourceTypeMemory)
-					{
-						pFileRequest->m_nReadHeadOffsetKB = (int32)(((int64)pFileRequest->m_nDiskOffset - m_nLastReadDiskOffset) >> 10); // in KB
-						m_nLastReadDiskOffset = pFileRequest->m_nDiskOffset + pFileRequest->m_nSizeOnMedia;
-
-#ifdef STREAMENGINE_ENABLE_STATS
-						m_NotInMemoryStats.m_nTempReadOffset += abs(pFileRequest->m_nReadHeadOffsetKB);
-						m_NotInMemoryStats.m_nTotalReadOffset += abs(pFileRequest->m_nReadHeadOffsetKB);
-
-						m_NotInMemoryStats.m_nTempRequestCount++;
-
-						// Calc IO bandwidth only for non memory files.
-						m_NotInMemoryStats.m_nTempBytesRead += pFileRequest->m_nSizeOnMedia;
-						m_NotInMemoryStats.m_TempReadTime += pFileRequest->m_readTime;
-#endif
-					}
-					else
+					// check if request was high prio, then decrease open count
+					if (pBatch[i]->IgnoreOutofTmpMem())
 					{
-#ifdef STREAMENGINE_ENABLE_STATS
-						m_InMemoryStats.m_nTempRequestCount++;
-
-						// Calc IO bandwidth only for in memory files.
-						m_InMemoryStats.m_nTempBytesRead += pFileRequest->m_nSizeOnMedia;
-						m_InMemoryStats.m_TempReadTime += pFileRequest->m_readTime;
-#endif
+						CryInterlockedDecrement(&m_iUrgentRequests);
 					}
-
-					CAsyncIOFileRequest::JobFinalize_Read(pFileRequest, m_pStreamEngine->GetJobEngineState());
+					nSizeOnMedia += pBatch[i]->m_nSizeOnMedia;
 				}
-				else
-				{
-					switch (nError)
-					{
-					case ERROR_OUT_OF_MEMORY:
-						bIsOOM = true;
-
-						pFileRequest->SetPriority(estpPreempted);
-
-						if (pFileRequest->IgnoreOutofTmpMem())
-							CryInterlockedIncrement(&m_iUrgentRequests);
-
-						m_fileRequestQueue.push_back(pFileRequest.Relinquish());
-						m_bNewRequests = true;
-						break;
-
-					case ERROR_PREEMPTED:
-						pFileRequest->SetPriority(estpPreempted);
-
-						if (pFileRequest->IgnoreOutofTmpMem())
-							CryInterlockedIncrement(&m_iUrgentRequests);
-
-						m_fileRequestQueue.push_back(pFileRequest.Relinquish());
-						m_bNewRequests = true;
-						break;
 
-					case ERROR_MISSCHEDULED:
-						// Request tried to read a file that has changed media type. Reset the sort key
-						// and reschedule.
-						pFileRequest->m_bSortKeyComputed = 0;
-						AddRequest(&*pFileRequest, false);
-						break;
+				for (uint32 i = 1; i < nBatchSize; ++i)
+					m_readerThreads[i - 1]->StartRead(pBatch[i]);
+				nBatchErrors[0] = ExecuteRead(pBatch[0]);
+				for (uint32 i = 1; i < nBatchSize; ++i)
+					nBatchErrors[i] = m_readerThreads[i - 1]->WaitForRead();
 
-					default:
-						pFileRequest->SyncWithDecrypt();
-						pFileRequest->SyncWithDecompress();
-						pFileRequest->Failed(nError);
-
-						CAsyncIOFileRequest::JobFinalize_Read(pFileRequest, m_pStreamEngine->GetJobEngineState());
-						break;
-					}
+				// Handle the results in queue order
+				for (uint32 i = 0; i < nBatchSize; ++i)
+				{
+					CAsyncIOFileRequest_TransferPtr pFinishedRequest(pBatch[i]);
+					FinishRead(pFinishedRequest, nBatchErrors[i], bIsOOM);
 				}
+
+				// preempted requests of a batch were pushed back in reverse order
+				if (nBatchSize > 1 && m_bNewRequests)
+					m_bNeedSorting = true;
 			}
 
 			//////////////////////////////////////////////////////////////////////////
@@ -404,6 +354,128 @@ void CStreamingIOThread::ThreadEntry()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+uint32 CStreamingIOThread::ExecuteRead(CAsyncIOFileRequest* pFileRequest)
+{
+	if (m_bAbortReads)
+		return ERROR_ABORTED_ON_SHUTDOWN;
+	else if (pFileRequest->m_bReadBegun)
+		return pFileRequest->ReadFileResume(this);
+	else
+		return pFileRequest->ReadFile(this);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CStreamingIOThread::FinishRead(CAsyncIOFileRequest_TransferPtr& pFileRequest, uint32 nError, bool& bIsOOM)
+{
+#ifdef STREAMENGINE_ENABLE_STATS
+	pFileRequest->m_nReadCounter = m_nReadCounter++;
+#endif
+
+	if (nError == 0)
+	{
+		if (pFileRequest->m_eMediaType != eStreamSourceTypeMemory)
+		{
+			pFileRequest->m_nReadHeadOffsetKB = (int32)(((int64)pFileRequest->m_nDiskOffset - m_nLastReadDiskOffset) >> 10); // in KB
+			m_nLastReadDiskOffset = pFileRequest->m_nDiskOffset + pFileRequest->m_nSizeOnMedia;
+
+#ifdef STREAMENGINE_ENABLE_STATS
+			m_NotInMemoryStats.m_nTempReadOffset += abs(pFileRequest->m_nReadHeadOffsetKB);
+			m_NotInMemoryStats.m_nTotalReadOffset += abs(pFileRequest->m_nReadHeadOffsetKB);
+
+			m_NotInMemoryStats.m_nTempRequestCount++;
+
+			// Calc IO bandwidth only for non memory files.
+			m_NotInMemoryStats.m_nTempBytesRead += pFileRequest->m_nSizeOnMedia;
+			m_NotInMemoryStats.m_TempReadTime += pFileRequest->m_readTime;
+#endif
+		}
+		else
+		{
+#ifdef STREAMENGINE_ENABLE_STATS
+			m_InMemoryStats.m_nTempRequestCount++;
+
+			// Calc IO bandwidth only for in memory files.
+			m_InMemoryStats.m_nTempBytesRead += pFileRequest->m_nSizeOnMedia;
+			m_InMemoryStats.m_TempReadTime += pFileRequest->m_readTime;
+#endif
+		}
+
+		CAsyncIOFileRequest::JobFinalize_Read(pFileRequest, m_pStreamEngine->GetJobEngineState());
+	}
+	else
+	{
+		switch (nError)
+		{
+		case ERROR_OUT_OF_MEMORY:
+			bIsOOM = true;
+
+			pFileRequest->SetPriority(estpPreempted);
+
+			if (pFileRequest->IgnoreOutofTmpMem())
+				CryInterlockedIncrement(&m_iUrgentRequests);
+
+			m_fileRequestQueue.push_back(pFileRequest.Relinquish());
+			m_bNewRequests = true;
+			break;
+
+		case ERROR_PREEMPTED:
+			pFileRequest->SetPriority(estpPreempted);
+
+			if (pFileRequest->IgnoreOutofTmpMem())
+				CryInterlockedIncrement(&m_iUrgentRequests);
+
+			m_fileRequestQueue.push_back(pFileRequest.Relinquish());
+			m_bNewRequests = true;
+			break;
+
+		case ERROR_MISSCHEDULED:
+			// Request tried to read a file that has changed media type. Reset the sort key
+			// and reschedule.
+			pFileRequest->m_bSortKeyComputed = 0;
+			AddRequest(&*pFileRequest, false);
+			break;
+
+		default:
+			pFileRequest->SyncWithDecrypt();
+			pFileRequest->SyncWithDecompress();
+			pFileRequest->Failed(nError);
+
+			CAsyncIOFileRequest::JobFinalize_Read(pFileRequest, m_pStreamEngine->GetJobEngineState());
+			break;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+uint32 CStreamingIOThread::UpdateQueueDepth()
+{
+	int nQueueDepth = 1;
+	switch (m_eMediaType)
+	{
+	case eStreamSourceTypeHDD:
+		nQueueDepth = g_cvars.sys_streaming_queue_depth_hdd;
+		break;
+	case eStreamSourceTypeDisc:
+		nQueueDepth = g_cvars.sys_streaming_queue_depth_disc;
+		break;
+	case eStreamSourceTypeMemory:
+		nQueueDepth = g_cvars.sys_streaming_queue_depth_memory;
+		break;
+	}
+	nQueueDepth = clamp_tpl(nQueueDepth, 1, STREAMING_IO_MAX_QUEUE_DEPTH);
+
+	// reader threads are only spawned once needed, so the cvars can be raised at runtime
+	while (m_readerThreads.size() < (size_t)(nQueueDepth - 1))
+	{
+		string name;
+		name.Format("%s Reader %d", m_name.c_str(), (int)m_readerThreads.size());
+		m_readerThreads.push_back(new CStreamingIOReaderThread(this, name.c_str()));
+	}
+
+	return (uint32)nQueueDepth;
+}
+
 #ifdef STREAMENGINE_ENABLE_STATS
 void CStreamingIOThread::SStats::Update(const CTimeValue& deltaT)
 {
@@ -685,6 +757,70 @@ bool CStreamingIOThread::IsMisscheduled(EStreamSourceMediaType mt) const
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 
+//////////////////////////////////////////////////////////////////////////
+CStreamingIOReaderThread::CStreamingIOReaderThread(CStreamingIOThread* pIOThread, const char* name)
+{
+	m_pIOThread = pIOThread;
+	m_pFileRequest = NULL;
+	m_nError = 0;
+	m_bCancelThreadRequest = false;
+	m_name = name;
+
+	if (!gEnv->pThreadManager->SpawnThread(this, name))
+	{
+		CryFatalError("Error spawning \"%s\" thread.", name);
+	}
+}
+
+CStreamingIOReaderThread::~CStreamingIOReaderThread()
+{
+	SignalStopWork();
+	gEnv->pThreadManager->JoinThread(this, eJM_Join);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CStreamingIOReaderThread::StartRead(CAsyncIOFileRequest* pFileRequest)
+{
+	assert(!m_pFileRequest);
+	m_pFileRequest = pFileRequest;
+	READ_WRITE_BARRIER
+	m_startEvent.Set();
+}
+
+//////////////////////////////////////////////////////////////////////////
+uint32 CStreamingIOReaderThread::WaitForRead()
+{
+	CRY_PROFILE_REGION_WAITING(PROFILE_SYSTEM, "Wait - StreamIO Reader");
+
+	m_doneEvent.Wait();
+	READ_WRITE_BARRIER
+	m_pFileRequest = NULL;
+	return m_nError;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CStreamingIOReaderThread::ThreadEntry()
+{
+	while (true)
+	{
+		m_startEvent.Wait();
+		if (m_bCancelThreadRequest)
+			break;
+
+		READ_WRITE_BARRIER
+		m_nError = m_pIOThread->ExecuteRead(m_pFileRequest);
+		READ_WRITE_BARRIER
+		m_doneEvent.Set();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CStreamingIOReaderThread::SignalStopWork()
+{
+	m_bCancelThreadRequest = true;
+	m_startEvent.Set();
+}
+
 //////////////////////////////////////////////////////////////////////////
 CStreamingWorkerThread::CStreamingWorkerThread(CStreamEngine* pStreamEngine, const char* name, EWorkerType type, SStreamRequestQueue* pQueue)
 {
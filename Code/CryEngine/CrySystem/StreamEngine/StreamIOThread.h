@@ -19,6 +19,10 @@
 #include <CryThreading/IThreadManager.h>
 
 class CStreamEngine;
+class CStreamingIOReaderThread;
+
+// upper limit for sys_streaming_queue_depth_*, the IO thread itself executes one of the reads
+#define STREAMING_IO_MAX_QUEUE_DEPTH 32
 
 //////////////////////////////////////////////////////////////////////////
 // Thread that performs IO operations.
@@ -50,6 +54,9 @@ public:
 
 	CStreamEngineWakeEvent& GetWakeEvent() { return m_awakeEvent; }
 
+	// Reads the data of a request, called by the IO thread and its reader threads
+	uint32                  ExecuteRead(CAsyncIOFileRequest* pFileRequest);
+
 	//////////////////////////////////////////////////////////////////////////
 	// IThread
 	//////////////////////////////////////////////////////////////////////////
@@ -62,8 +69,12 @@ public:
 
 protected:
 
-	void ProcessNewRequests();
-	void ProcessReset();
+	void   ProcessNewRequests();
+	void   ProcessReset();
+
+	// returns how many reads can be in flight for this media type, spawns missing reader threads
+	uint32 UpdateQueueDepth();
+	void   FinishRead(CAsyncIOFileRequest_TransferPtr& pFileRequest, uint32 nError, bool& bIsOOM);
 
 public:
 
@@ -115,6 +126,7 @@ private:
 	std::vector<CAsyncIOFileRequest*>   m_fileRequestQueue;
 	std::vector<CAsyncIOFileRequest*>   m_temporaryArray;
 	CryMT::vector<CAsyncIOFileRequest*> m_newFileRequests;
+	std::vector<CStreamingIOReaderThread*> m_readerThreads;
 
 	EStreamSourceMediaType              m_eMediaType;
 	uint32                              m_nFallbackMTs;
@@ -139,6 +151,45 @@ private:
 	uint32                 m_nReadCounter;
 };
 
+//////////////////////////////////////////////////////////////////////////
+// Thread that executes reads on behalf of an IO thread.
+// The IO thread hands out the next requests of its sorted queue to its reader threads, so that
+// several reads are in flight at once (see sys_streaming_queue_depth_*). The results are handled by
+// the IO thread in queue order, thus the completed requests go through the same finalization as before.
+//////////////////////////////////////////////////////////////////////////
+class CStreamingIOReaderThread : public IThread
+{
+public:
+	CStreamingIOReaderThread(CStreamingIOThread* pIOThread, const char* name);
+	~CStreamingIOReaderThread();
+
+	// Starts reading the request, there must be no read in flight
+	void   StartRead(CAsyncIOFileRequest* pFileRequest);
+	// Waits until the last started read finished and returns its error code
+	uint32 WaitForRead();
+
+	//////////////////////////////////////////////////////////////////////////
+	// IThread
+	//////////////////////////////////////////////////////////////////////////
+	// Start accepting work on thread
+	virtual void ThreadEntry();
+	//////////////////////////////////////////////////////////////////////////
+
+	// Signals the thread that it should not accept anymore work and exit
+	void SignalStopWork();
+
+private:
+	CStreamingIOThread*  m_pIOThread;
+	CAsyncIOFileRequest* m_pFileRequest;
+	uint32               m_nError;
+
+	volatile bool        m_bCancelThreadRequest;
+
+	CryEvent             m_startEvent;
+	CryEvent             m_doneEvent;
+	string               m_name;
+};
+
 //////////////////////////////////////////////////////////////////////////
 // Thread that performs IO operations.
 //////////////////////////////////////////////////////////////////////////
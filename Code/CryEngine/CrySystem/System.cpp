@@ -67,6 +67,7 @@
 #include "SystemEventDispatcher.h"
 #include "HardwareMouse.h"
 #include "ServerThrottle.h"
+#include "ServerFramePipeline.h"
 #include <CryMemory/ILocalMemoryUsage.h>
 #include "ResourceManager.h"
 #include "MemoryManager.h"
@@ -83,6 +84,7 @@
 #include "RemoteConsole/RemoteConsole.h"
 #include "ImeManager.h"
 #include "BootProfiler.h"
+#include "TraceRecorder.h"
 #include "NullImplementation/NULLAudioSystems.h"
 #include "NullImplementation/NULLRenderAuxGeom.h"
 
@@ -539,6 +541,10 @@ void CSystem::ShutDown()
 
 	m_FrameProfileSystem.Enable(false, false);
 
+#if defined(USE_FRAME_PROFILER)
+	CTraceRecorder::GetInstance().Shutdown();
+#endif
+
 #if defined(ENABLE_LOADING_PROFILER)
 	CLoadingProfilerSystem::ShutDown();
 #endif
@@ -1389,7 +1395,10 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 	#if defined(MAP_LOADING_SLICING)
 		gEnv->pSystemScheduler->SchedulingSleepIfNeeded();
 	#else
-		SleepIfNeeded();
+		if (m_pServerFramePipeline && m_pServerFramePipeline->IsEnabled())
+			m_lastTickTime = m_pServerFramePipeline->WaitForNextTick(m_svDedicatedMaxRate->GetFVal());
+		else
+			SleepIfNeeded();
 	#endif // defined(MAP_LOADING_SLICING)
 	}
 #endif //EXCLUDE_UPDATE_ON_CONSOLE
@@ -1626,6 +1635,9 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 				static CTimeValue sTimeLast = gEnv->pTimer->GetAsyncTime();
 				timeFrameMax.SetMilliSeconds((int64)(1000.f / ((float)maxFPS + safeMarginFPS)));
 				const CTimeValue timeLast = timeFrameMax + sTimeLast;
+				// the wait is spent on the script garbage collection first
+				if (m_env.pScriptSystem)
+					m_env.pScriptSystem->CollectGarbageIdle((timeLast - gEnv->pTimer->GetAsyncTime()).GetMilliSeconds());
 				while (timeLast.GetValue() > gEnv->pTimer->GetAsyncTime().GetValue())
 				{
 					CrySleep(0);
@@ -1651,6 +1663,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 	// initial network update
 	if (m_env.pNetwork)
 	{
+		SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_NetworkReceive);
 		m_env.pNetwork->SyncWithGame(eNGS_FrameStart);
 	}
 
@@ -1658,6 +1671,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 	// Update script system.
 	if (m_env.pScriptSystem)
 	{
+		SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_GameRules);
 		m_env.pScriptSystem->Update();
 	}
 
@@ -1787,12 +1801,14 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 					//update game
 					if (m_env.pGame)
 					{
+						SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_GameRules);
 						m_env.pGame->PrePhysicsUpdate();
 					}
 					//////////////////////////////////////////////////////////////////////
 					//update entity system
 					if (m_env.pEntitySystem && g_cvars.sys_entitysystem)
 					{
+						SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_Entity);
 						m_env.pEntitySystem->PrePhysicsUpdate();
 					}
 				}
@@ -1821,6 +1837,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 				if ((nPauseMode != 1) && !(updateFlags & ESYSUPDATE_IGNORE_PHYSICS) && g_cvars.sys_physics && !bNoUpdate)
 				{
 					FRAME_PROFILER("SysUpdate:physics", this, PROFILE_SYSTEM);
+					SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_Physics);
 
 					int iPrevTime = m_env.pPhysicalWorld->GetiPhysicsTime();
 					//float fPrevTime=m_env.pPhysicalWorld->GetPhysicsTime();
@@ -1866,6 +1883,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 				{
 					FRAME_PROFILER("SysUpdate:PumpLoggedEvents", this, PROFILE_SYSTEM);
 					CRYPROFILE_SCOPE_PROFILE_MARKER("PumpLoggedEvents");
+					SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_Physics);
 					m_env.pPhysicalWorld->PumpLoggedEvents();
 				}
 
@@ -1873,6 +1891,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 				if ((nPauseMode == 0) && !(updateFlags & ESYSUPDATE_IGNORE_AI) && g_cvars.sys_ai && !bNoUpdate)
 				{
 					FRAME_PROFILER("SysUpdate:AI", this, PROFILE_SYSTEM);
+					SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_AI);
 					//////////////////////////////////////////////////////////////////////
 					//update AI system - match physics
 					if (m_env.pAISystem && !m_cvAIUpdate->GetIVal() && g_cvars.sys_ai)
@@ -1969,6 +1988,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 		//update entity system
 		if (m_env.pEntitySystem && !bNoUpdate && g_cvars.sys_entitysystem)
 		{
+			SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_Entity);
 			m_env.pEntitySystem->Update();
 		}
 	}
@@ -2041,6 +2061,7 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 	// final network update
 	if (m_env.pNetwork)
 	{
+		SERVER_FRAME_STAGE(m_pServerFramePipeline.get(), eSFS_NetworkSend);
 		m_env.pNetwork->SyncWithGame(eNGS_FrameEnd);
 		m_env.pNetwork->SyncWithGame(eNGS_DisplayDebugInfo);
 		m_env.pNetwork->SyncWithGame(eNGS_WakeNetwork);   // This will wake the network thread up
@@ -2098,6 +2119,9 @@ bool CSystem::Update(int updateFlags, int nPauseMode)
 
 	UpdateUpdateTimes();
 
+	if (m_pServerFramePipeline)
+		m_pServerFramePipeline->EndFrame();
+
 	m_pSystemEventDispatcher->Update();
 
 	if (!gEnv->IsEditing() && m_eRuntimeState == ESYSTEM_EVENT_LEVEL_GAMEPLAY_START)
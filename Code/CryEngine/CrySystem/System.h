@@ -20,6 +20,7 @@
 
 struct IConsoleCmdArgs;
 class CServerThrottle;
+class CServerFramePipeline;
 struct ICryFactoryRegistryImpl;
 struct IZLibCompressor;
 class CLoadingProfilerSystem;
@@ -125,6 +126,9 @@ struct SSystemCVars
 	ICVar* sys_localization_folder;
 	ICVar* sys_build_folder;
 	int    sys_streaming_in_blocks;
+	int    sys_streaming_queue_depth_hdd;
+	int    sys_streaming_queue_depth_disc;
+	int    sys_streaming_queue_depth_memory;
 
 	int    sys_float_exceptions;
 	int    sys_no_crash_dialog;
@@ -419,6 +423,12 @@ public:
 			Flags |= CPUF_SSE;
 		if (m_pCpu->has3DNow())
 			Flags |= CPUF_3DNOW;
+		if (m_pCpu->hasAVX())
+			Flags |= CPUF_AVX;
+		if (m_pCpu->hasAVX2())
+			Flags |= CPUF_AVX2;
+		if (m_pCpu->hasAVX512())
+			Flags |= CPUF_AVX512;
 
 		return Flags;
 	}
@@ -908,7 +918,8 @@ private: // ------------------------------------------------------
 	ESystemConfigSpec                m_nServerConfigSpec;
 	ESystemConfigSpec                m_nMaxConfigSpec;
 
-	std::unique_ptr<CServerThrottle> m_pServerThrottle;
+	std::unique_ptr<CServerThrottle>      m_pServerThrottle;
+	std::unique_ptr<CServerFramePipeline> m_pServerFramePipeline;
 
 	CProfilingSystem                 m_ProfilingSystem;
 	sUpdateTimes                     m_UpdateTimes[NUM_UPDATE_TIMES];
@@ -44,11 +44,13 @@
 #include <CrySystem/ICmdLine.h>
 #include <CrySystem/IProcess.h>
 #include <CryMono/IMonoRuntime.h>
+#include <CryThreading/IJobManager_JobDelegator.h>
 
 #include "CryPak.h"
 #include "XConsole.h"
 #include "Log.h"
 #include "XML/xml.h"
+#include "XML/XMLBinaryReader.h"
 #include "StreamEngine/StreamEngine.h"
 #include "BudgetingSystem.h"
 #include "PhysRenderer.h"
@@ -61,14 +63,18 @@
 #include "HardwareMouse.h"
 #include "Validator.h"
 #include "ServerThrottle.h"
+#include "ServerFramePipeline.h"
 #include "SystemCFG.h"
 #include "AutoDetectSpec.h"
 #include "ResourceManager.h"
 #include "LoadingProfiler.h"
 #include "BootProfiler.h"
+#include "TraceRecorder.h"
 #include "DiskProfiler.h"
 #include "Statoscope.h"
 #include "TestSystemLegacy.h"
+#include "JobManager/JobManager.h"
+#include "JobManager/WorkStealingBackEnd/WorkStealingBackEnd.h"
 #include "VisRegTest.h"
 #include "MTSafeAllocator.h"
 #include "NotificationNetwork.h"
@@ -415,6 +421,457 @@ static void CmdDumpJobManagerJobList(IConsoleCmdArgs* pArgs)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+static void CmdDumpJobManagerJobGraph(IConsoleCmdArgs* pArgs)
+{
+	if (gEnv->pJobManager)
+	{
+		gEnv->pJobManager->DumpJobGraph();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+namespace
+{
+volatile int g_nJobSystemBenchmarkCounter = 0;
+
+void JobSystemBenchmark_Leaf(volatile int* pCounter)
+{
+	CryInterlockedIncrement(pCounter);
+}
+
+void JobSystemBenchmark_Root(uint32 nNumChildJobs, JobManager::SJobState* pJobState, JobManager::IBackend* pBackEnd);
+}
+
+DECLARE_JOB("JobSystemBenchmark_Leaf", TJobSystemBenchmarkLeafJob, JobSystemBenchmark_Leaf);
+DECLARE_JOB("JobSystemBenchmark_Root", TJobSystemBenchmarkRootJob, JobSystemBenchmark_Root);
+
+namespace
+{
+void JobSystemBenchmark_Root(uint32 nNumChildJobs, JobManager::SJobState* pJobState, JobManager::IBackend* pBackEnd)
+{
+	// the child jobs go to the benchmarked backend as well
+	JobManager::detail::SetThreadBackEndOverride(pBackEnd);
+	for (uint32 i = 0; i < nNumChildJobs; ++i)
+	{
+		TJobSystemBenchmarkLeafJob job(&g_nJobSystemBenchmarkCounter);
+		job.RegisterJobState(pJobState);
+		job.Run();
+	}
+	JobManager::detail::SetThreadBackEndOverride(NULL);
+}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Measures the job dispatch overhead of both backends with empty jobs, once with all jobs added
+// from the calling thread and once with jobs added from inside other jobs.
+// Each backend runs as a private instance with as many workers as the job manager, whichever
+// sys_job_system_backend is active, so both are measured under the same conditions.
+static void CmdJobSystemBenchmark(IConsoleCmdArgs* pArgs)
+{
+	if (!gEnv->pJobManager || !gEnv->pTimer)
+		return;
+
+	// SJobState counts the running jobs in 16 bit, so wait for the jobs in batches
+	const uint32 nMaxJobsInFlight = 16384;
+	const uint32 nNumJobs = pArgs->GetArgCount() > 1 ? (uint32)max(atoi(pArgs->GetArg(1)), 1) : 262144u;
+	const uint32 nNumChildJobs = pArgs->GetArgCount() > 2 ? (uint32)clamp_tpl(atoi(pArgs->GetArg(2)), 1, (int)nMaxJobsInFlight - 1) : 32u;
+	const uint32 nNumWorkers = gEnv->pJobManager->GetNumWorkerThreads();
+
+	CryLogAlways("== JobSystem benchmark: %u workers ==", nNumWorkers);
+
+	static const char* const backEndNames[] = { "shared queue", "work stealing" };
+	for (uint32 nBackEnd = 0; nBackEnd < CRY_ARRAY_COUNT(backEndNames); ++nBackEnd)
+	{
+		JobManager::IBackend* pBackEnd = NULL;
+		if (nBackEnd == 0)
+			pBackEnd = new JobManager::ThreadBackEnd::CThreadBackEnd("JobSystem_Benchmark_%u");
+		else
+			pBackEnd = new JobManager::WorkStealingBackEnd::CWorkStealingBackEnd("JobSystem_Benchmark_%u");
+
+		if (!pBackEnd->Init(nNumWorkers))
+		{
+			CryLogAlways("  %s: failed to create the workers", backEndNames[nBackEnd]);
+			delete pBackEnd;
+			continue;
+		}
+		JobManager::detail::SetThreadBackEndOverride(pBackEnd);
+
+		// 1. all jobs added from the calling thread
+		CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+		for (uint32 nJob = 0; nJob < nNumJobs; nJob += nMaxJobsInFlight)
+		{
+			JobManager::SJobState jobState;
+			const uint32 nBatchEnd = min(nJob + nMaxJobsInFlight, nNumJobs);
+			for (uint32 i = nJob; i < nBatchEnd; ++i)
+			{
+				TJobSystemBenchmarkLeafJob job(&g_nJobSystemBenchmarkCounter);
+				job.RegisterJobState(&jobState);
+				job.Run();
+			}
+			jobState.Wait();
+		}
+		const float fFlatTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+		// 2. root jobs which add their child jobs from a worker thread
+		const uint32 nNumRootJobs = max(nNumJobs / nNumChildJobs, 1u);
+		const uint32 nRootJobsPerBatch = max(nMaxJobsInFlight / (nNumChildJobs + 1), 1u);
+		startTime = gEnv->pTimer->GetAsyncTime();
+		for (uint32 nJob = 0; nJob < nNumRootJobs; nJob += nRootJobsPerBatch)
+		{
+			JobManager::SJobState jobState;
+			const uint32 nBatchEnd = min(nJob + nRootJobsPerBatch, nNumRootJobs);
+			for (uint32 i = nJob; i < nBatchEnd; ++i)
+			{
+				TJobSystemBenchmarkRootJob job(nNumChildJobs, &jobState, pBackEnd);
+				job.RegisterJobState(&jobState);
+				job.Run();
+			}
+			jobState.Wait();
+		}
+		const float fNestedTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+		const uint32 nNumNestedJobs = nNumRootJobs * (nNumChildJobs + 1);
+
+		JobManager::detail::SetThreadBackEndOverride(NULL);
+		pBackEnd->ShutDown();
+		delete pBackEnd;
+
+		CryLogAlways("  %s, %u jobs added from the calling thread: %.2f ms, %.3f us/job, %.0f jobs/s",
+		             backEndNames[nBackEnd], nNumJobs, fFlatTime, fFlatTime * 1000.0f / nNumJobs, nNumJobs / max(fFlatTime * 0.001f, FLT_EPSILON));
+		CryLogAlways("  %s, %u jobs added from %u root jobs: %.2f ms, %.3f us/job, %.0f jobs/s",
+		             backEndNames[nBackEnd], nNumNestedJobs, nNumRootJobs, fNestedTime, fNestedTime * 1000.0f / nNumNestedJobs, nNumNestedJobs / max(fNestedTime * 0.001f, FLT_EPSILON));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+namespace
+{
+class CStreamingIOBenchmarkCallback : public IStreamCallback
+{
+public:
+	CStreamingIOBenchmarkCallback() : m_nCompleted(0), m_nErrors(0) {}
+
+	virtual void StreamAsyncOnComplete(IReadStream* pStream, unsigned nError)
+	{
+		if (nError)
+			CryInterlockedIncrement(&m_nErrors);
+		CryInterlockedIncrement(&m_nCompleted);
+	}
+
+	volatile int m_nCompleted;
+	volatile int m_nErrors;
+};
+
+inline uint8 StreamingIOBenchmarkByte(uint32 nFile, uint32 nOffset)
+{
+	return (uint8)(nFile * 131 + nOffset * 7);
+}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Writes a synthetic pak with many small files and streams all of them through the stream engine,
+// once with a single read in flight and once with the given queue depth for all IO threads.
+// The pak was just written, so the numbers are for the page cache, drop it before the run for cold reads.
+static void CmdStreamingIOBenchmark(IConsoleCmdArgs* pArgs)
+{
+	IStreamEngine* pStreamEngine = gEnv->pSystem->GetStreamEngine();
+	if (!pStreamEngine || !gEnv->pCryPak || !gEnv->pTimer)
+		return;
+
+	const uint32 nNumRequests = pArgs->GetArgCount() > 1 ? (uint32)max(atoi(pArgs->GetArg(1)), 1) : 8192u;
+	const uint32 nRequestSize = pArgs->GetArgCount() > 2 ? (uint32)max(atoi(pArgs->GetArg(2)), 1) : 4096u;
+	const int nQueueDepth = pArgs->GetArgCount() > 3 ? clamp_tpl(atoi(pArgs->GetArg(3)), 1, STREAMING_IO_MAX_QUEUE_DEPTH) : 8;
+
+	const char* szPakPath = "%USER%/streaming_io_benchmark.pak";
+	const char* szFileFormat = "%%USER%%/streaming_io_benchmark/%05u.dat";
+
+	// 1. write the pak, the files are stored as the stream engine would have to inflate compressed ones on the job system
+	{
+		_smart_ptr<ICryArchive> pArchive = gEnv->pCryPak->OpenArchive(szPakPath, ICryArchive::FLAGS_CREATE_NEW);
+		if (!pArchive)
+		{
+			CryLogAlways("sys_streaming_io_benchmark: can't create %s", szPakPath);
+			return;
+		}
+
+		std::vector<uint8> fileData(nRequestSize);
+		for (uint32 i = 0; i < nNumRequests; ++i)
+		{
+			for (uint32 j = 0; j < nRequestSize; ++j)
+				fileData[j] = StreamingIOBenchmarkByte(i, j);
+			pArchive->UpdateFile(string().Format("streaming_io_benchmark/%05u.dat", i).c_str(), &fileData[0], nRequestSize, ICryArchive::METHOD_STORE);
+		}
+	}
+
+	if (!gEnv->pCryPak->OpenPack(szPakPath))
+	{
+		CryLogAlways("sys_streaming_io_benchmark: can't open %s", szPakPath);
+		return;
+	}
+
+	CryLogAlways("== Streaming IO benchmark: %u requests of %u bytes ==", nNumRequests, nRequestSize);
+
+	ICVar* pQueueDepthCVars[] =
+	{
+		gEnv->pConsole->GetCVar("sys_streaming_queue_depth_hdd"),
+		gEnv->pConsole->GetCVar("sys_streaming_queue_depth_disc"),
+		gEnv->pConsole->GetCVar("sys_streaming_queue_depth_memory"),
+	};
+	int nOldQueueDepths[CRY_ARRAY_COUNT(pQueueDepthCVars)];
+	for (uint32 i = 0; i < CRY_ARRAY_COUNT(pQueueDepthCVars); ++i)
+		nOldQueueDepths[i] = pQueueDepthCVars[i]->GetIVal();
+
+	// external buffers, so the temp memory budget of the stream engine doesn't throttle the reads
+	std::vector<uint8> readData((size_t)nNumRequests * nRequestSize);
+	std::vector<IReadStreamPtr> streams(nNumRequests);
+
+	const int nPassQueueDepths[] = { 1, nQueueDepth };
+	for (uint32 nPass = 0; nPass < CRY_ARRAY_COUNT(nPassQueueDepths); ++nPass)
+	{
+		for (uint32 i = 0; i < CRY_ARRAY_COUNT(pQueueDepthCVars); ++i)
+			pQueueDepthCVars[i]->Set(nPassQueueDepths[nPass]);
+		memset(&readData[0], 0, readData.size());
+
+		CStreamingIOBenchmarkCallback callback;
+		const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+
+		for (uint32 i = 0; i < nNumRequests; ++i)
+		{
+			StreamReadParams params;
+			params.nSize = nRequestSize;
+			params.pBuffer = &readData[(size_t)i * nRequestSize];
+			params.nFlags = IStreamEngine::FLAGS_NO_SYNC_CALLBACK;
+			streams[i] = pStreamEngine->StartRead(eStreamTaskTypePak, string().Format(szFileFormat, i).c_str(), &callback, &params);
+		}
+
+		while (callback.m_nCompleted < (int)nNumRequests)
+		{
+			pStreamEngine->Update();
+			CrySleep(1);
+		}
+
+		const float fTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+		uint32 nNumMismatches = 0;
+		for (uint32 i = 0; i < nNumRequests; ++i)
+		{
+			const uint8* pData = &readData[(size_t)i * nRequestSize];
+			for (uint32 j = 0; j < nRequestSize; ++j)
+			{
+				if (pData[j] != StreamingIOBenchmarkByte(i, j))
+				{
+					++nNumMismatches;
+					break;
+				}
+			}
+			streams[i] = NULL;
+		}
+
+		CryLogAlways("  queue depth %2d: %.2f ms, %.0f requests/s, %.2f MB/s, %d errors, %u mismatches",
+		             nPassQueueDepths[nPass], fTime, nNumRequests / max(fTime * 0.001f, FLT_EPSILON),
+		             (float)nNumRequests * nRequestSize / (1024.0f * 1024.0f) / max(fTime * 0.001f, FLT_EPSILON), callback.m_nErrors, nNumMismatches);
+	}
+
+	for (uint32 i = 0; i < CRY_ARRAY_COUNT(pQueueDepthCVars); ++i)
+		pQueueDepthCVars[i]->Set(nOldQueueDepths[i]);
+
+	gEnv->pCryPak->ClosePack(szPakPath);
+	gEnv->pCryPak->RemoveFile(szPakPath);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Writes synthetic paks with small files spread over them and looks files up in the paks, once searching
+// the paks one by one and once with the path index. Half of the lookups are for files no pak has.
+static void CmdPakLookupBenchmark(IConsoleCmdArgs* pArgs)
+{
+	if (!gEnv->pCryPak || !gEnv->pTimer)
+		return;
+
+	const uint32 nNumPaks = pArgs->GetArgCount() > 1 ? (uint32)max(atoi(pArgs->GetArg(1)), 1) : 64u;
+	const uint32 nNumFiles = pArgs->GetArgCount() > 2 ? (uint32)max(atoi(pArgs->GetArg(2)), 1) : 100000u;
+	const uint32 nNumLookups = pArgs->GetArgCount() > 3 ? (uint32)max(atoi(pArgs->GetArg(3)), 2) : 1000000u;
+
+	ICVar* pPathIndexCVar = gEnv->pConsole->GetCVar("sys_PakPathIndex");
+	if (!pPathIndexCVar)
+		return;
+
+	const uint8 fileData[16] = { 0 };
+	std::vector<string> pakPaths(nNumPaks);
+	for (uint32 nPak = 0; nPak < nNumPaks; ++nPak)
+	{
+		pakPaths[nPak].Format("%%USER%%/pak_lookup_benchmark_%03u.pak", nPak);
+
+		_smart_ptr<ICryArchive> pArchive = gEnv->pCryPak->OpenArchive(pakPaths[nPak].c_str(), ICryArchive::FLAGS_CREATE_NEW);
+		if (!pArchive)
+		{
+			CryLogAlways("sys_pak_lookup_benchmark: can't create %s", pakPaths[nPak].c_str());
+			return;
+		}
+		for (uint32 i = nPak; i < nNumFiles; i += nNumPaks)
+			pArchive->UpdateFile(string().Format("pak_lookup_benchmark/%03u/%06u.dat", i % 100, i).c_str(), const_cast<uint8*>(fileData), sizeof(fileData), ICryArchive::METHOD_STORE);
+	}
+
+	for (uint32 nPak = 0; nPak < nNumPaks; ++nPak)
+	{
+		if (!gEnv->pCryPak->OpenPack(pakPaths[nPak].c_str()))
+			CryLogAlways("sys_pak_lookup_benchmark: can't open %s", pakPaths[nPak].c_str());
+	}
+
+	// every other lookup misses, the file numbers are spread so consecutive lookups hit different paks
+	std::vector<string> lookupPaths(min(nNumLookups, 2 * nNumFiles));
+	for (uint32 i = 0; i < lookupPaths.size(); ++i)
+	{
+		const uint32 nFile = (uint32)(((uint64)(i / 2) * 7919) % nNumFiles);
+		lookupPaths[i].Format("%%USER%%/pak_lookup_benchmark/%03u/%06u.%s", nFile % 100, nFile, (i & 1) ? "missing" : "dat");
+	}
+
+	CryLogAlways("== Pak lookup benchmark: %u files in %u paks, %u lookups ==", nNumFiles, nNumPaks, nNumLookups);
+
+	const int nOldPathIndex = pPathIndexCVar->GetIVal();
+	for (int nPathIndex = 0; nPathIndex < 2; ++nPathIndex)
+	{
+		pPathIndexCVar->Set(nPathIndex);
+
+		uint32 nNumFound = 0;
+		const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+		for (uint32 i = 0; i < nNumLookups; ++i)
+		{
+			if (gEnv->pCryPak->IsFileExist(lookupPaths[i % lookupPaths.size()].c_str(), ICryPak::eFileLocation_InPak))
+				++nNumFound;
+		}
+		const float fTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+		CryLogAlways("  %-12s: %.2f ms, %.0f lookups/s, %u of %u found", nPathIndex ? "path index" : "pak by pak",
+		             fTime, nNumLookups / max(fTime * 0.001f, FLT_EPSILON), nNumFound, nNumLookups);
+	}
+	pPathIndexCVar->Set(nOldPathIndex);
+
+	for (uint32 nPak = 0; nPak < nNumPaks; ++nPak)
+	{
+		gEnv->pCryPak->ClosePack(pakPaths[nPak].c_str());
+		gEnv->pCryPak->RemoveFile(pakPaths[nPak].c_str());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void CollectXmlFiles(const string& sFolder, std::vector<string>& files)
+{
+	_finddata_t fd;
+	const intptr_t handle = gEnv->pCryPak->FindFirst((sFolder + "/*.*").c_str(), &fd);
+	if (handle == -1)
+		return;
+
+	do
+	{
+		if (!strcmp(fd.name, ".") || !strcmp(fd.name, ".."))
+			continue;
+
+		const string sPath = sFolder + "/" + fd.name;
+		const char* szExt = PathUtil::GetExt(fd.name);
+		if (fd.attrib & _A_SUBDIR)
+			CollectXmlFiles(sPath, files);
+		else if (!stricmp(szExt, "xml") || !stricmp(szExt, "adb") || !stricmp(szExt, "mtl"))
+			files.push_back(sPath);
+	}
+	while (gEnv->pCryPak->FindNext(handle, &fd) >= 0);
+
+	gEnv->pCryPak->FindClose(handle);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Loads the binary XML files of a folder, the current level by default: once read into an own copy as
+// XmlParserImp::ParseFile did before, once directly from the pak entries, and once more from the pak entries
+// while the documents of a previous load are alive, so that their contents are shared.
+// Text XML files are counted but not parsed.
+static void CmdXmlLoadBenchmark(IConsoleCmdArgs* pArgs)
+{
+	if (!gEnv->pCryPak || !gEnv->pTimer)
+		return;
+
+	string sFolder = pArgs->GetArgCount() > 1 ? pArgs->GetArg(1) : "";
+	if (sFolder.empty() && gEnv->p3DEngine)
+		sFolder = PathUtil::RemoveSlash(gEnv->p3DEngine->GetLevelFilePath(""));
+	if (sFolder.empty())
+	{
+		CryLogAlways("sys_xml_load_benchmark: no level is loaded, pass a folder");
+		return;
+	}
+	const int nNumRepeats = pArgs->GetArgCount() > 2 ? max(atoi(pArgs->GetArg(2)), 1) : 3;
+
+	std::vector<string> files;
+	CollectXmlFiles(sFolder, files);
+
+	CryLogAlways("== XML load benchmark: %" PRISIZE_T " files in %s, %d repeats ==", files.size(), sFolder.c_str(), nNumRepeats);
+
+	enum EPass { ePass_Copy, ePass_Pak, ePass_PakShared, ePass_Count };
+	const char* szPassNames[ePass_Count] = { "copy", "pak", "pak shared" };
+
+	std::vector<XmlNodeRef> documents;
+	for (int nPass = 0; nPass < ePass_Count; ++nPass)
+	{
+		typedef XMLBinary::XMLBinaryReader TReader;
+
+		if (nPass == ePass_PakShared)
+		{
+			documents.resize(files.size());
+			for (size_t i = 0; i < files.size(); ++i)
+			{
+				CCryFile file;
+				TReader reader;
+				TReader::EResult result;
+				if (file.Open(files[i].c_str(), "rb"))
+					documents[i] = reader.LoadFromPakFile(file.GetHandle(), result);
+			}
+		}
+
+		uint32 nNumBinary = 0;
+		uint32 nNumText = 0;
+		uint64 nNumBytes = 0;
+		const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+
+		for (int nRepeat = 0; nRepeat < nNumRepeats; ++nRepeat)
+		{
+			for (size_t i = 0; i < files.size(); ++i)
+			{
+				CCryFile file;
+				if (!file.Open(files[i].c_str(), "rb"))
+					continue;
+
+				TReader reader;
+				TReader::EResult result = TReader::eResult_NotInPak;
+				XmlNodeRef root;
+				if (nPass != ePass_Copy)
+					root = reader.LoadFromPakFile(file.GetHandle(), result);
+
+				const size_t nFileSize = file.GetLength();
+				if (result == TReader::eResult_NotInPak && nFileSize)
+				{
+					char* pFileContents = new char[nFileSize];
+					if (file.ReadRaw(pFileContents, nFileSize) == nFileSize)
+						root = reader.LoadFromBuffer(TReader::eBufferMemoryHandling_TakeOwnership, pFileContents, nFileSize, result);
+					if (!root)
+						delete[] pFileContents;
+				}
+
+				if (result == TReader::eResult_Success)
+				{
+					++nNumBinary;
+					nNumBytes += nFileSize;
+				}
+				else if (result == TReader::eResult_NotBinXml)
+				{
+					++nNumText;
+				}
+			}
+		}
+
+		const float fTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+		CryLogAlways("  %-10s: %.2f ms, %.3f ms per binary file, %u binary files, %u text files, %.2f MB",
+		             szPassNames[nPass], fTime, fTime / max(nNumBinary, 1u), nNumBinary / nNumRepeats, nNumText / nNumRepeats,
+		             (float)nNumBytes / nNumRepeats / (1024.0f * 1024.0f));
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 static void CmdDumpThreadConfigList(IConsoleCmdArgs* pArgs)
 {
@@ -1373,6 +1830,88 @@ void OnDrawHelpersStrChange(ICVar* pVar)
 	gEnv->pPhysicalWorld->GetPhysVars()->iDrawHelpers = StrToPhysHelpers(pVar->GetString());
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Compares RayWorldIntersectionBatch, with the rays traced one by one in its sorted order and in packets (p_rwi_batch_packets),
+// against tracing the same rays one by one.
+// The rays start at random points around the camera, optionally after loading a world dump (as written by p_do_step 2),
+// which replaces the current physical world.
+static void CmdPhysRwiBatchBenchmark(IConsoleCmdArgs* pArgs)
+{
+	IPhysicalWorld* pWorld = gEnv->pPhysicalWorld;
+	if (!pWorld || !gEnv->pTimer)
+		return;
+
+	const int nRays = pArgs->GetArgCount() > 1 ? max(atoi(pArgs->GetArg(1)), 1) : 16384;
+	const float rayLength = pArgs->GetArgCount() > 2 ? max((float)atof(pArgs->GetArg(2)), 0.01f) : 50.0f;
+	if (pArgs->GetArgCount() > 3 && !pWorld->SerializeWorld(pArgs->GetArg(3), 0))
+	{
+		CryLogAlways("p_rwi_batch_benchmark: can't load world dump %s", pArgs->GetArg(3));
+		return;
+	}
+
+	// random rays in a box around the camera, with the same seed for every run
+	const Vec3 center = gEnv->pSystem->GetViewCamera().GetPosition();
+	CRndGen rnd(0x5eed);
+	std::vector<IPhysicalWorld::SRWIParams> rays(nRays);
+	for (int i = 0; i < nRays; ++i)
+	{
+		rays[i].org = center + rnd.GetRandomComponentwise(Vec3(-rayLength), Vec3(rayLength));
+		rays[i].dir = rnd.GetRandomUnitVector<Vec3>() * rayLength;
+		rays[i].objtypes = ent_all;
+		rays[i].flags = rwi_stop_at_pierceable;
+		rays[i].nMaxHits = 1;
+	}
+
+	std::vector<ray_hit> scalarHits(nRays), batchHits(nRays);
+	std::vector<int> numBatchHits(nRays);
+	int nScalarHits = 0;
+	for (int pass = 0; pass < 2; ++pass)	// the first pass only warms up the caches
+	{
+		nScalarHits = 0;
+		for (int i = 0; i < nRays; ++i)
+		{
+			IPhysicalWorld::SRWIParams rp = rays[i];
+			rp.hits = &scalarHits[i];
+			nScalarHits += pWorld->RayWorldIntersection(rp);
+		}
+	}
+
+	CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+	for (int i = 0; i < nRays; ++i)
+	{
+		IPhysicalWorld::SRWIParams rp = rays[i];
+		rp.hits = &scalarHits[i];
+		pWorld->RayWorldIntersection(rp);
+	}
+	const float fScalarTime = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+	// the batch with the rays traced one by one in the sorted order, then in packets
+	PhysicsVars* pVars = pWorld->GetPhysVars();
+	const int bPackets = pVars->bRwiBatchPackets;
+	float fBatchTime[2];
+	int nBatchHits[2], nMismatches[2];
+	for (int bPacket = 0; bPacket < 2; ++bPacket)
+	{
+		pVars->bRwiBatchPackets = bPacket;
+		startTime = gEnv->pTimer->GetAsyncTime();
+		nBatchHits[bPacket] = pWorld->RayWorldIntersectionBatch(&rays[0], nRays, &batchHits[0], &numBatchHits[0]);
+		fBatchTime[bPacket] = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+		nMismatches[bPacket] = 0;
+		for (int i = 0; i < nRays; ++i)
+			nMismatches[bPacket] += scalarHits[i].pCollider != batchHits[i].pCollider || fabs_tpl(scalarHits[i].dist - batchHits[i].dist) > 1e-4f;
+	}
+	pVars->bRwiBatchPackets = bPackets;
+
+	CryLogAlways("== RayWorldIntersection batch benchmark: %d rays of %.1fm ==", nRays, rayLength);
+	CryLogAlways("  one by one:       %.2f ms, %.0f rays/s, %d hits", fScalarTime, nRays / max(fScalarTime * 0.001f, FLT_EPSILON), nScalarHits);
+	CryLogAlways("  batch, scalar:    %.2f ms, %.0f rays/s, %d hits, %d rays with different results", 
+	             fBatchTime[0], nRays / max(fBatchTime[0] * 0.001f, FLT_EPSILON), nBatchHits[0], nMismatches[0]);
+	CryLogAlways("  batch, packets:   %.2f ms, %.0f rays/s, %d hits, %d rays with different results", 
+	             fBatchTime[1], nRays / max(fBatchTime[1] * 0.001f, FLT_EPSILON), nBatchHits[1], nMismatches[1]);
+	CryLogAlways("  packets are %.2fx as fast as the scalar batch", fBatchTime[0] / max(fBatchTime[1], FLT_EPSILON));
+}
+
 bool CSystem::InitPhysics(const SSystemInitParams& initParams)
 {
 	LOADING_TIME_PROFILE_SECTION(GetISystem());
@@ -1588,6 +2127,12 @@ bool CSystem::InitPhysics(const SSystemInitParams& initParams)
 	               "Turns on explosions debug mode");
 	REGISTER_CVAR2("p_num_threads", &pVars->numThreads, pVars->numThreads, 0,
 	               "The number of internal physics threads");
+	REGISTER_CVAR2("p_job_system_step", &pVars->bJobSystemStep, pVars->bJobSystemStep, 0,
+	               "Runs entity islands, living and independent entities as JobManager jobs instead of on the p_num_threads physics threads");
+	REGISTER_CVAR2("p_job_system_step_min_cost", &pVars->jobSystemStepMinCost, pVars->jobSystemStepMinCost, 0,
+	               "Estimated cost (entities plus their colliders) each additional physics job has to cover in p_job_system_step mode");
+	REGISTER_CVAR2("p_rwi_batch_packets", &pVars->bRwiBatchPackets, pVars->bRwiBatchPackets, 0,
+	               "Traces the rays of RayWorldIntersectionBatch in packets of 4 that test the entity grid bounds together");
 	REGISTER_CVAR2("p_joint_damage_accum", &pVars->jointDmgAccum, pVars->jointDmgAccum, 0,
 	               "Default fraction of damage (tension) accumulated on a breakable joint");
 	REGISTER_CVAR2("p_joint_damage_accum_threshold", &pVars->jointDmgAccumThresh, pVars->jointDmgAccumThresh, 0,
@@ -1622,6 +2167,10 @@ bool CSystem::InitPhysics(const SSystemInitParams& initParams)
 	REGISTER_CVAR2("p_num_startup_overload_checks", &pVars->nStartupOverloadChecks, pVars->nStartupOverloadChecks, 0,
 	               "For this many frames after loading a level, check if the physics gets overloaded and freezes non-player physicalized objects that are slow enough");
 
+	REGISTER_COMMAND("p_rwi_batch_benchmark", CmdPhysRwiBatchBenchmark, VF_CHEAT,
+	                 "Compares batched RayWorldIntersection, traced one by one and in packets, against single rays around the camera.\n"
+	                 "Usage: p_rwi_batch_benchmark [numRays] [rayLength] [worldDumpFile]");
+
 	pVars->flagsColliderDebris = geom_colltype_debris;
 	pVars->flagsANDDebris = ~(geom_colltype_vehicle | geom_colltype6);
 	pVars->ticksPerSecond = gEnv->pTimer->GetTicksPerSecond();
@@ -2762,6 +3311,9 @@ L_done:;
 #ifdef ENABLE_LOADING_PROFILER
 		CBootProfiler::GetInstance().RegisterCVars();
 #endif
+#if defined(USE_FRAME_PROFILER)
+		CTraceRecorder::GetInstance().RegisterCVars();
+#endif
 
 		// Register Audio-related system CVars
 		CreateAudioVars();
@@ -3220,7 +3772,10 @@ L_done:;
 			InitNetwork(startupParams);
 
 			if (gEnv->IsDedicated())
+			{
 				m_pServerThrottle.reset(new CServerThrottle(this, m_pCpu->GetCPUCount()));
+				m_pServerFramePipeline.reset(new CServerFramePipeline(this));
+			}
 		}
 		InlineInitializationProcessing("CSystem::Init InitNetwork");
 
@@ -4811,7 +5366,18 @@ void CSystem::CreateSystemVars()
 	attachVariable("sys_PakValidateFileHash", &g_cvars.pakVars.nValidateFileHashes, "Validate file hashes in pak files for collisions");
 	attachVariable("sys_LoadFrontendShaderCache", &g_cvars.pakVars.nLoadFrontendShaderCache, "Load frontend shader cache (on/off)");
 	attachVariable("sys_UncachedStreamReads", &g_cvars.pakVars.nUncachedStreamReads, "Enable stream reads via an uncached file handle");
+	attachVariable("sys_PakMapped", &g_cvars.pakVars.nMappedPaks,
+	               "Linux only: if non-0, paks opened afterwards are memory mapped instead of being read via stdio.\n"
+	               "Stored files are returned without copy and compressed files are inflated straight from the mapping,\n"
+	               "the pages are shared via the page cache with all processes using the same paks (e.g. several dedicated servers).");
 	attachVariable("sys_PakDisableNonLevelRelatedPaks", &g_cvars.pakVars.nDisableNonLevelRelatedPaks, "Disables all paks that are not required by specific level; This is used with per level splitted assets.");
+	attachVariable("sys_PakPathIndex", &g_cvars.pakVars.nPathIndex,
+	               "If non-0, the pak a file is read from is looked up in one index of the files of all opened paks,\n"
+	               "otherwise all paks are searched one after the other.");
+	attachVariable("sys_PakNegativeLookupCache", &g_cvars.pakVars.nNegativeLookupCache,
+	               "If non-0, IsFileExist remembers recent misses. The cache is reset when paks are opened, closed or made (in)accessible\n"
+	               "and when files are created or copied through CryPak, but files created on disk by other means aren't seen while cached.\n"
+	               "Removing files doesn't reset it, a cached miss stays a miss.");
 
 	{
 		int nDefaultRenderSplashScreen = 1;
@@ -4990,7 +5556,17 @@ void CSystem::CreateSystemVars()
 	                                           "Defaults to 4 on consoles and 8 threads an PC"
 	                                           "Set to 0 to create as many threads as cores are available");
 
+	REGISTER_INT("sys_job_system_backend", 0, VF_REQUIRE_APP_RESTART,
+	             "Selects the implementation of the regular job system backend, read when the job system is initialized.\n"
+	             "Usage: sys_job_system_backend 0/1\n"
+	             "0: All workers pull from one shared job queue per priority level.\n"
+	             "1: Each worker owns a work stealing deque per priority level, jobs added from a worker stay on it unless stolen by an idle worker.");
+
 	REGISTER_COMMAND("sys_job_system_dump_job_list", CmdDumpJobManagerJobList, VF_CHEAT, "Show a list of all registered job in the console");
+	REGISTER_COMMAND("sys_job_system_dump_job_graph", CmdDumpJobManagerJobGraph, VF_CHEAT, "Print the job graphs executed during the last frame in graphviz dot format to the log");
+	REGISTER_COMMAND("sys_job_system_benchmark", CmdJobSystemBenchmark, VF_CHEAT,
+	                 "Measures the job dispatch overhead of the shared queue and the work stealing job system backends with empty jobs.\n"
+	                 "Usage: sys_job_system_benchmark [numJobs] [childJobsPerRootJob]");
 
 	m_sys_spec = REGISTER_INT_CB("sys_spec", CONFIG_CUSTOM, VF_ALWAYSONCHANGE,    // starts with CONFIG_CUSTOM so callback is called when setting initial value
 	                             "Tells the system cfg spec. (0=custom, 1=low, 2=med, 3=high, 4=very high, 5=XBoxOne, 6=PS4)",
@@ -5072,6 +5648,29 @@ void CSystem::CreateSystemVars()
 	REGISTER_CVAR2("sys_streaming_in_blocks", &g_cvars.sys_streaming_in_blocks, 1, VF_NULL,
 	               "Streaming of large files happens in blocks");
 
+#if CRY_PLATFORM_LINUX && defined(DEDICATED_SERVER)
+	#define DEFAULT_STREAMING_QUEUE_DEPTH_HDD 8
+#else
+	#define DEFAULT_STREAMING_QUEUE_DEPTH_HDD 1
+#endif
+	REGISTER_CVAR2("sys_streaming_queue_depth_hdd", &g_cvars.sys_streaming_queue_depth_hdd, DEFAULT_STREAMING_QUEUE_DEPTH_HDD, VF_NULL,
+	               "Number of reads the HDD streaming IO thread keeps in flight (1 to " STRINGIFY(STREAMING_IO_MAX_QUEUE_DEPTH) ").\n"
+	               "Additional reads are executed by reader threads, on Linux paks are read with pread so the reads don't serialize.");
+	REGISTER_CVAR2("sys_streaming_queue_depth_disc", &g_cvars.sys_streaming_queue_depth_disc, 1, VF_NULL,
+	               "Number of reads the optical drive streaming IO thread keeps in flight (1 to " STRINGIFY(STREAMING_IO_MAX_QUEUE_DEPTH) ")");
+	REGISTER_CVAR2("sys_streaming_queue_depth_memory", &g_cvars.sys_streaming_queue_depth_memory, 1, VF_NULL,
+	               "Number of reads the in memory streaming IO thread keeps in flight (1 to " STRINGIFY(STREAMING_IO_MAX_QUEUE_DEPTH) ")");
+	REGISTER_COMMAND("sys_streaming_io_benchmark", CmdStreamingIOBenchmark, VF_CHEAT,
+	                 "Streams a synthetic pak of small files, once with a single read in flight and once with the given queue depth.\n"
+	                 "Usage: sys_streaming_io_benchmark [numRequests] [requestSize] [queueDepth]");
+	REGISTER_COMMAND("sys_pak_lookup_benchmark", CmdPakLookupBenchmark, VF_CHEAT,
+	                 "Looks files up in synthetic paks, once pak by pak and once with the path index (sys_PakPathIndex).\n"
+	                 "Usage: sys_pak_lookup_benchmark [numPaks] [numFiles] [numLookups]");
+	REGISTER_COMMAND("sys_xml_load_benchmark", CmdXmlLoadBenchmark, VF_CHEAT,
+	                 "Loads the binary XML files of a folder read into a copy, directly from the pak entries and with shared pak entries.\n"
+	                 "Usage: sys_xml_load_benchmark [folder] [repeats]\n"
+	                 "The folder defaults to the current level.");
+
 #if CRY_PLATFORM_WINDOWS && !defined(_RELEASE)
 	#define CVAR_FPE_DEFAULT_VALUE 1
 #else
@@ -0,0 +1,404 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+#include "StdAfx.h"
+
+#if defined(USE_FRAME_PROFILER)
+
+	#include "TraceRecorder.h"
+	#include "FrameProfileSystem.h"
+	#include <CrySystem/IConsole.h>
+	#include <CrySystem/ITimer.h>
+
+extern int CryMemoryGetAllocatedSize();
+
+namespace
+{
+CTraceRecorder gTraceRecorderInstance;
+
+// Buffer of the calling thread, created on its first event.
+THREADLOCAL CTraceRecorder::SThreadBuffer* gpThreadBuffer = nullptr;
+
+const char* GetCategory(uint32 type)
+{
+	switch (type)
+	{
+	case CTraceRecorder::eET_Wait:
+		return "wait";
+	case CTraceRecorder::eET_Job:
+		return "job";
+	case CTraceRecorder::eET_Frame:
+		return "frame";
+	case CTraceRecorder::eET_Memory:
+		return "memory";
+	default:
+		return "section";
+	}
+}
+}
+
+volatile bool CTraceRecorder::s_bRecording = false;
+int CTraceRecorder::CV_sys_trace_buffer_events = 16384;
+int CTraceRecorder::CV_sys_trace_flush_ms = 10;
+
+//////////////////////////////////////////////////////////////////////////
+CTraceRecorder& CTraceRecorder::GetInstance()
+{
+	return gTraceRecorderInstance;
+}
+
+CTraceRecorder::CTraceRecorder()
+	: m_numBuffers(0)
+	, m_pFile(nullptr)
+	, m_bFirstEvent(true)
+	, m_bRun(false)
+	, m_sessionId(0)
+	, m_startTicks(0)
+	, m_microSecondsPerTick(0.0)
+	, m_savedProfileDeep(-1)
+	, m_savedProfileAllThreads(-1)
+{
+	memset(m_buffers, 0, sizeof(m_buffers));
+}
+
+CTraceRecorder::~CTraceRecorder()
+{
+	for (int i = 0; i < m_numBuffers; ++i)
+	{
+		delete[] m_buffers[i].pEvents;
+	}
+}
+
+void CTraceRecorder::RegisterCVars()
+{
+	REGISTER_CVAR2("sys_trace_buffer_events", &CV_sys_trace_buffer_events, 16384, VF_DEV_ONLY,
+	               "Number of events of the ring buffer of each thread recorded by sys_trace_start, rounded up to a power of two.\n"
+	               "Events are dropped while the buffer of a thread is full. Only affects threads recording their first event.");
+	REGISTER_CVAR2("sys_trace_flush_ms", &CV_sys_trace_flush_ms, 10, VF_DEV_ONLY,
+	               "Interval in milliseconds in which the trace recorder writes the recorded events to the file");
+	REGISTER_COMMAND("sys_trace_start", CmdTraceStart, VF_DEV_ONLY,
+	                 "Starts recording profile sections, jobs, waits and memory into %USER%/TestResults/trace_<name>.json.\n"
+	                 "The file is in the Chrome trace event format and can be opened with chrome://tracing or ui.perfetto.dev.\n"
+	                 "Turns on profile_deep and profile_allthreads while recording, so all sections of all threads are recorded,\n"
+	                 "sys_trace_stop restores them. No sections are recorded while profile_display shows the allocated memory.\n"
+	                 "Usage: sys_trace_start [name]");
+	REGISTER_COMMAND("sys_trace_stop", CmdTraceStop, VF_DEV_ONLY, "Stops the recording started by sys_trace_start and closes the file");
+}
+
+void CTraceRecorder::Shutdown()
+{
+	Stop();
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CTraceRecorder::Start(const char* szName)
+{
+	AUTO_LOCK(m_lock);
+
+	if (m_pFile)
+	{
+		CryLogAlways("Trace recorder: already recording to %s", m_fileName.c_str());
+		return false;
+	}
+
+	static const char* szTestResults = "%USER%/TestResults";
+	const string filePath = string(szTestResults) + "/trace_" + szName + ".json";
+	char path[ICryPak::g_nMaxPath] = "";
+	gEnv->pCryPak->AdjustFileName(filePath.c_str(), path, ICryPak::FLAGS_PATH_REAL | ICryPak::FLAGS_FOR_WRITING);
+	gEnv->pCryPak->MakeDir(szTestResults);
+
+	m_pFile = ::fopen(path, "wb");
+	if (!m_pFile)
+	{
+		CryLogAlways("Trace recorder: can't open %s for writing", path);
+		return false;
+	}
+	m_fileName = path;
+
+	// Discard what the threads recorded since the last recording, the writer thread isn't running yet.
+	for (int i = 0; i < m_numBuffers; ++i)
+	{
+		m_buffers[i].readPos = m_buffers[i].writePos;
+		CryInterlockedExchange(&m_buffers[i].numDropped, 0);
+	}
+
+	++m_sessionId;
+	m_bFirstEvent = true;
+	m_startTicks = CryGetTicks();
+	m_microSecondsPerTick = 1000000.0 / (double)gEnv->pTimer->GetTicksPerSecond();
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", m_pFile);
+
+	m_bRun = true;
+	if (!gEnv->pThreadManager->SpawnThread(this, "TraceRecorder"))
+	{
+		CryLogAlways("Trace recorder: error spawning the writer thread");
+		m_bRun = false;
+		::fclose(m_pFile);
+		m_pFile = nullptr;
+		return false;
+	}
+
+	EnableProfileSections(true);
+
+	MemoryBarrier();
+	s_bRecording = true;
+	CryLogAlways("Trace recorder: recording to %s", m_fileName.c_str());
+	return true;
+}
+
+void CTraceRecorder::Stop()
+{
+	AUTO_LOCK(m_lock);
+
+	if (!m_pFile)
+		return;
+
+	s_bRecording = false;
+	m_bRun = false;
+	gEnv->pThreadManager->JoinThread(this, eJM_Join);
+	EnableProfileSections(false);
+
+	// Events recorded after this last flush are discarded by the next Start.
+	Flush();
+
+	for (int i = 0; i < m_numBuffers; ++i)
+	{
+		const SThreadBuffer& buffer = m_buffers[i];
+		if (buffer.numDropped)
+		{
+			CryLogAlways("Trace recorder: dropped %d events of thread %s, increase sys_trace_buffer_events or decrease sys_trace_flush_ms",
+			             (int)buffer.numDropped, gEnv->pThreadManager->GetThreadName(buffer.threadId));
+		}
+	}
+
+	fputs("\n]}\n", m_pFile);
+	::fclose(m_pFile);
+	m_pFile = nullptr;
+	CryLogAlways("Trace recorder: written %s", m_fileName.c_str());
+}
+
+void CTraceRecorder::EnableProfileSections(bool bEnable)
+{
+	// Without profile_deep only the REGION sections are started, and the sections of other threads than the main
+	// thread only with profile_allthreads, see CFrameProfilerSection and CFrameProfileSystem::StartProfilerSection.
+	ICVar* pDeep = gEnv->pConsole->GetCVar("profile_deep");
+	ICVar* pAllThreads = gEnv->pConsole->GetCVar("profile_allthreads");
+	if (bEnable)
+	{
+		if (pDeep)
+		{
+			m_savedProfileDeep = pDeep->GetIVal();
+			pDeep->Set(1);
+		}
+		if (pAllThreads)
+		{
+			m_savedProfileAllThreads = pAllThreads->GetIVal();
+			pAllThreads->Set(max(m_savedProfileAllThreads, 1));
+		}
+		// Both are applied at the next frame otherwise.
+		gEnv->bDeepProfiling = 1;
+		if (gEnv->pFrameProfileSystem)
+			static_cast<CFrameProfileSystem*>(gEnv->pFrameProfileSystem)->SetThreadSupport(max(m_savedProfileAllThreads, 1));
+	}
+	else
+	{
+		if (pDeep && m_savedProfileDeep >= 0)
+			pDeep->Set(m_savedProfileDeep);
+		if (pAllThreads && m_savedProfileAllThreads >= 0)
+			pAllThreads->Set(m_savedProfileAllThreads);
+		m_savedProfileDeep = -1;
+		m_savedProfileAllThreads = -1;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CTraceRecorder::RecordSection(const CFrameProfiler* pProfiler, int64 startTicks, int64 endTicks)
+{
+	const uint32 type = (pProfiler->m_description & EProfileDescription::WAITING) ? eET_Wait : eET_Section;
+	Record(type, pProfiler->m_name, startTicks, endTicks, 0);
+}
+
+void CTraceRecorder::RecordJob(const char* szJobName, uint32 workerId, uint32 runTimeMicroSec)
+{
+	// called by the worker when the job is done, the job started its run time ago
+	const int64 endTicks = CryGetTicks();
+	const int64 startTicks = endTicks - (int64)(runTimeMicroSec / gTraceRecorderInstance.m_microSecondsPerTick);
+	Record(eET_Job, szJobName, startTicks, endTicks, workerId);
+}
+
+void CTraceRecorder::RecordFrame(uint32 frameId)
+{
+	const int64 ticks = CryGetTicks();
+	Record(eET_Frame, "Frame", ticks, 0, frameId);
+	Record(eET_Memory, "Memory", ticks, CryMemoryGetAllocatedSize(), 0);
+}
+
+void CTraceRecorder::Record(uint32 type, const char* szName, int64 start, int64 value, uint32 arg)
+{
+	SThreadBuffer* pBuffer = gpThreadBuffer;
+	if (!pBuffer)
+	{
+		pBuffer = gpThreadBuffer = gTraceRecorderInstance.CreateThreadBuffer();
+		if (!pBuffer)
+			return;
+	}
+
+	// Single producer: only this thread moves writePos, the writer thread only moves readPos.
+	const LONG writePos = pBuffer->writePos;
+	if ((uint32)(writePos - pBuffer->readPos) > pBuffer->mask)
+	{
+		CryInterlockedIncrement(&pBuffer->numDropped);
+		return;
+	}
+
+	SEvent& event = pBuffer->pEvents[writePos & pBuffer->mask];
+	event.szName = szName ? szName : "";
+	event.start = start;
+	event.value = value;
+	event.arg = arg;
+	event.type = type;
+
+	MemoryBarrier();
+	pBuffer->writePos = writePos + 1;
+}
+
+CTraceRecorder::SThreadBuffer* CTraceRecorder::CreateThreadBuffer()
+{
+	if (m_numBuffers == eMaxThreadBuffers)
+		return nullptr;
+
+	AUTO_LOCK(m_lock);
+
+	if (m_numBuffers == eMaxThreadBuffers)
+		return nullptr;
+
+	uint32 numEvents = 64;
+	while (numEvents < (uint32)CV_sys_trace_buffer_events)
+		numEvents <<= 1;
+
+	SThreadBuffer& buffer = m_buffers[m_numBuffers];
+	buffer.threadId = CryGetCurrentThreadId();
+	buffer.pEvents = new SEvent[numEvents];
+	buffer.mask = numEvents - 1;
+	buffer.writePos = 0;
+	buffer.readPos = 0;
+	buffer.numDropped = 0;
+	buffer.sessionId = 0;
+
+	// Publish after the buffer is set up, the writer thread reads m_numBuffers without the lock.
+	MemoryBarrier();
+	++m_numBuffers;
+	return &buffer;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CTraceRecorder::ThreadEntry()
+{
+	while (m_bRun)
+	{
+		Flush();
+		CrySleep(max(CV_sys_trace_flush_ms, 1));
+	}
+}
+
+void CTraceRecorder::Flush()
+{
+	const int numBuffers = m_numBuffers;
+	MemoryBarrier();
+
+	for (int i = 0; i < numBuffers; ++i)
+	{
+		SThreadBuffer& buffer = m_buffers[i];
+		const LONG readPos = buffer.readPos;
+		const LONG writePos = buffer.writePos;
+		if (readPos == writePos)
+			continue;
+		MemoryBarrier();
+
+		if (buffer.sessionId != m_sessionId)
+		{
+			buffer.sessionId = m_sessionId;
+			fprintf(m_pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu64 ",\"args\":{\"name\":",
+			        m_bFirstEvent ? "" : ",\n", (uint64)buffer.threadId);
+			WriteString(gEnv->pThreadManager->GetThreadName(buffer.threadId));
+			fputs("}}", m_pFile);
+			m_bFirstEvent = false;
+		}
+
+		for (LONG pos = readPos; pos != writePos; ++pos)
+		{
+			WriteEvent(buffer, buffer.pEvents[pos & buffer.mask]);
+		}
+
+		// Hand the slots back to the producer only after they are written out.
+		MemoryBarrier();
+		buffer.readPos = writePos;
+	}
+
+	fflush(m_pFile);
+}
+
+void CTraceRecorder::WriteEvent(const SThreadBuffer& buffer, const SEvent& event)
+{
+	fprintf(m_pFile, "%s{\"name\":", m_bFirstEvent ? "" : ",\n");
+	m_bFirstEvent = false;
+	WriteString(event.szName);
+	fprintf(m_pFile, ",\"cat\":\"%s\",\"pid\":1,\"tid\":%" PRIu64 ",\"ts\":%.3f", GetCategory(event.type), (uint64)buffer.threadId, ToMicroSeconds(event.start - m_startTicks));
+
+	switch (event.type)
+	{
+	case eET_Frame:
+		fprintf(m_pFile, ",\"ph\":\"i\",\"s\":\"g\",\"args\":{\"id\":%u}}", event.arg);
+		break;
+	case eET_Memory:
+		fprintf(m_pFile, ",\"ph\":\"C\",\"args\":{\"allocated\":%" PRId64 "}}", event.value);
+		break;
+	case eET_Job:
+		fprintf(m_pFile, ",\"ph\":\"X\",\"dur\":%.3f,\"args\":{\"worker\":%u}}", ToMicroSeconds(event.value - event.start), event.arg);
+		break;
+	default:
+		fprintf(m_pFile, ",\"ph\":\"X\",\"dur\":%.3f}", ToMicroSeconds(event.value - event.start));
+		break;
+	}
+}
+
+void CTraceRecorder::WriteString(const char* szString)
+{
+	fputc('"', m_pFile);
+	for (const char* p = szString ? szString : ""; *p; ++p)
+	{
+		const unsigned char c = (unsigned char)*p;
+		if (c == '"' || c == '\\')
+		{
+			fputc('\\', m_pFile);
+			fputc(c, m_pFile);
+		}
+		else if (c < 0x20)
+		{
+			fprintf(m_pFile, "\\u%04x", c);
+		}
+		else
+		{
+			fputc(c, m_pFile);
+		}
+	}
+	fputc('"', m_pFile);
+}
+
+double CTraceRecorder::ToMicroSeconds(int64 ticks) const
+{
+	return (double)ticks * m_microSecondsPerTick;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CTraceRecorder::CmdTraceStart(IConsoleCmdArgs* pArgs)
+{
+	const char* szName = pArgs->GetArgCount() > 1 ? pArgs->GetArg(1) : "capture";
+	GetInstance().Start(szName);
+}
+
+void CTraceRecorder::CmdTraceStop(IConsoleCmdArgs* pArgs)
+{
+	GetInstance().Stop();
+}
+
+#endif // USE_FRAME_PROFILER
@@ -0,0 +1,120 @@
+// Copyright 2001-2016 Crytek GmbH / Crytek Group. All rights reserved.
+
+// -------------------------------------------------------------------------
+//  Description: Records profile sections, jobs, waits and memory counters
+//               into per thread ring buffers and streams them to a file in
+//               the Chrome trace event format, which chrome://tracing and
+//               the Perfetto UI open directly.
+// -------------------------------------------------------------------------
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __tracerecorder_h__
+#define __tracerecorder_h__
+#pragma once
+
+#if defined(USE_FRAME_PROFILER)
+
+	#include <CryThreading/IThreadManager.h>
+
+class CFrameProfiler;
+struct IConsoleCmdArgs;
+
+//////////////////////////////////////////////////////////////////////////
+
+class CTraceRecorder : public IThread
+{
+public:
+	enum EEventType
+	{
+		eET_Section,
+		eET_Wait,
+		eET_Job,
+		eET_Frame,
+		eET_Memory,
+	};
+
+	struct SEvent
+	{
+		const char* szName;
+		int64       start;   // ticks
+		int64       value;   // end ticks, or the counter value
+		uint32      arg;
+		uint32      type;
+	};
+
+	// Written only by the thread owning it and read only by the writer thread.
+	// The buffers live as long as the recorder, so a thread keeps its buffer across recordings.
+	struct SThreadBuffer
+	{
+		threadID      threadId;
+		SEvent*       pEvents;
+		uint32        mask;
+		volatile LONG writePos;
+		volatile LONG readPos;
+		volatile LONG numDropped;
+		uint32        sessionId; // the recording the thread name was last written for
+	};
+
+	CTraceRecorder();
+	~CTraceRecorder();
+
+	static CTraceRecorder& GetInstance();
+
+	void                   RegisterCVars();
+	void                   Shutdown();
+
+	bool                   Start(const char* szName);
+	void                   Stop();
+
+	static ILINE bool      IsRecording() { return s_bRecording; }
+
+	// Hooks, only to be called when IsRecording()
+	static void RecordSection(const CFrameProfiler* pProfiler, int64 startTicks, int64 endTicks);
+	static void RecordJob(const char* szJobName, uint32 workerId, uint32 runTimeMicroSec);
+	void        RecordFrame(uint32 frameId);
+
+protected:
+	// IThread
+	virtual void ThreadEntry();
+
+private:
+	enum { eMaxThreadBuffers = 256 };
+
+	static void    Record(uint32 type, const char* szName, int64 start, int64 value, uint32 arg);
+	SThreadBuffer* CreateThreadBuffer();
+
+	// Forces the cvars on which the profile sections reaching RecordSection depend, and restores them
+	void           EnableProfileSections(bool bEnable);
+
+	void           Flush();
+	void           WriteEvent(const SThreadBuffer& buffer, const SEvent& event);
+	void           WriteString(const char* szString);
+	double         ToMicroSeconds(int64 ticks) const;
+
+	static void    CmdTraceStart(IConsoleCmdArgs* pArgs);
+	static void    CmdTraceStop(IConsoleCmdArgs* pArgs);
+
+	static volatile bool          s_bRecording;
+
+	SThreadBuffer                 m_buffers[eMaxThreadBuffers];
+	volatile LONG                 m_numBuffers;
+	CryCriticalSection            m_lock;       // guards Start/Stop and buffer creation
+
+	FILE*                         m_pFile;
+	bool                          m_bFirstEvent;
+	volatile bool                 m_bRun;
+	uint32                        m_sessionId;
+	int64                         m_startTicks;
+	double                        m_microSecondsPerTick;
+	string                        m_fileName;
+	int                           m_savedProfileDeep;       // before Start, -1 if not forced
+	int                           m_savedProfileAllThreads;
+
+	static int                    CV_sys_trace_buffer_events;
+	static int                    CV_sys_trace_flush_ms;
+};
+
+#endif // USE_FRAME_PROFILER
+
+#endif
@@ -256,6 +256,7 @@ int CXConsole::con_line_buffer_size = 500;
 int CXConsole::con_showonload = 0;
 int CXConsole::con_debug = 0;
 int CXConsole::con_restricted = 0;
+int CXConsole::con_lookup_stats = 0;
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -302,6 +303,8 @@ CXConsole::CXConsole()
 
 	m_currentLoadConfigType = eLoadConfigInit;
 
+	ResetLookupStats();
+
 	CNotificationNetworkConsole::Initialize();
 
 }
@@ -430,6 +433,7 @@ void CXConsole::Init(CSystem* pSystem)
 	REGISTER_CVAR(con_showonload, 0, VF_NULL, "Show console on level loading");
 	REGISTER_CVAR(con_debug, 0, VF_CHEAT, "Log call stack on every GetCVar call");
 	REGISTER_CVAR(con_restricted, con_restricted, VF_RESTRICTEDMODE, "0=normal mode / 1=restricted access to the console");        // later on VF_RESTRICTEDMODE should be removed (to 0)
+	REGISTER_CVAR_CB(con_lookup_stats, 0, VF_NULL, "1=measure the cost of looking up console variables and commands by name, see con_dump_lookup_stats", OnLookupStatsChange);
 
 	if (m_pSystem->IsDevMode()  // unrestricted console for -DEVMODE
 	    || gEnv->IsDedicated()) // unrestricted console for dedicated server
@@ -494,6 +498,10 @@ void CXConsole::Init(CSystem* pSystem)
 #endif
 
 	REGISTER_COMMAND("Bind", &Bind, VF_NULL, "");
+	REGISTER_COMMAND("con_dump_lookup_stats", &CmdDumpLookupStats, VF_NULL,
+	                 "Logs the cost of looking up console variables and commands by name since con_lookup_stats was turned on\n"
+	                 "and compares the lookup of all variables by the hash registry to the sorted map\n"
+	                 "con_dump_lookup_stats [reset]");
 	REGISTER_COMMAND("wait_seconds", &Command_SetWaitSeconds, VF_BLOCKFRAME,
 	                 "Forces the console to wait for a given number of seconds before the next deferred command is processed\n"
 	                 "Works only in deferred command mode");
@@ -598,7 +606,8 @@ void CXConsole::RegisterVar(ICVar* pCVar, ConsoleVarFunc pChangeFunc)
 
 	ConsoleVariablesMapItor::value_type value = ConsoleVariablesMapItor::value_type(pCVar->GetName(), pCVar);
 
-	m_mapVariables.insert(value);
+	if (m_mapVariables.insert(value).second)
+		m_variableRegistry.Set(pCVar->GetName(), pCVar);
 
 	int flags = pCVar->GetFlags();
 
@@ -847,7 +856,7 @@ ICVar* CXConsole::Register(const char* sName, int* src, int iValue, int nFlags,
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::Register(int): variable [%s] is already registered", pCVar->GetName());
@@ -876,7 +885,7 @@ ICVar* CXConsole::RegisterCVarGroup(const char* szName, const char* szFileName)
 	if (strnicmp(szName, "sys_spec_", 9) != 0)
 		return 0;
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, szName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(szName);
 	if (pCVar)
 	{
 		return pCVar; // Already registered, this is expected when loading engine specs after game specs.
@@ -906,7 +915,7 @@ ICVar* CXConsole::Register(const char* sName, float* src, float fValue, int nFla
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::Register(float): variable [%s] is already registered", pCVar->GetName());
@@ -928,7 +937,7 @@ ICVar* CXConsole::Register(const char* sName, const char** src, const char* defa
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::Register(const char*): variable [%s] is already registered", pCVar->GetName());
@@ -949,7 +958,7 @@ ICVar* CXConsole::RegisterString(const char* sName, const char* sValue, int nFla
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::RegisterString(const char*): variable [%s] is already registered", pCVar->GetName());
@@ -969,7 +978,7 @@ ICVar* CXConsole::RegisterFloat(const char* sName, float fValue, int nFlags, con
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::RegisterFloat(): variable [%s] is already registered", pCVar->GetName());
@@ -989,7 +998,7 @@ ICVar* CXConsole::RegisterInt(const char* sName, int iValue, int nFlags, const c
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::RegisterInt(): variable [%s] is already registered", pCVar->GetName());
@@ -1009,7 +1018,7 @@ ICVar* CXConsole::RegisterInt64(const char* sName, int64 iValue, int nFlags, con
 {
 	AssertName(sName);
 
-	ICVar* pCVar = stl::find_in_map(m_mapVariables, sName, NULL);
+	ICVar* pCVar = m_variableRegistry.Find(sName);
 	if (pCVar)
 	{
 		gEnv->pLog->LogError("[CVARS]: [DUPLICATE] CXConsole::RegisterInt64(): variable [%s] is already registered", pCVar->GetName());
@@ -1047,6 +1056,7 @@ void CXConsole::UnregisterVariable(const char* sVarName, bool bDelete)
 	}
 
 	m_mapVariables.erase(sVarName);
+	m_variableRegistry.Set(sVarName, NULL);
 
 	delete pCVar;
 }
@@ -1165,36 +1175,61 @@ ICVar* CXConsole::GetCVar(const char* sName)
 		m_pSystem->debug_LogCallStack();
 	}
 
-	// Fast map lookup for case-sensitive match.
-	ConsoleVariablesMapItor it;
+	if (con_lookup_stats)
+	{
+		const int64 startTicks = CryGetTicks();
+		VariableRegistry::SSlot* pSlot = m_variableRegistry.FindSlot(sName);
+		ICVar* pCVar = pSlot ? pSlot->pValue : NULL;
+		CountLookup(pCVar ? &pSlot->numLookups : NULL, CryGetTicks() - startTicks);
+		return pCVar;
+	}
 
-	it = m_mapVariables.find(sName);
-	if (it != m_mapVariables.end())
-		return it->second;
+	return m_variableRegistry.Find(sName);
+}
 
-	/*
-	   if(!bCaseSensitive)
-	   {
-	    // Much slower but allows names with wrong case (use only where performance doesn't matter).
-	    for(it=m_mapVariables.begin(); it!=m_mapVariables.end(); ++it)
-	    {
-	      if(stricmp(it->first,sName)==0)
-	        return it->second;
-	    }
-	   }
-	   test else
-	   {
-	    for(it=m_mapVariables.begin(); it!=m_mapVariables.end(); ++it)
-	    {
-	      if(stricmp(it->first,sName)==0)
-	      {
-	        CryFatalError("Error: Wrong case for '%s','%s'",it->first,sName);
-	      }
-	    }
-	   }
-	 */
+//////////////////////////////////////////////////////////////////////////
+ICVar* const* CXConsole::GetCVarSlot(const char* sName)
+{
+	assert(sName);
+	return &m_variableRegistry.GetSlot(sName)->pValue;
+}
 
-	return NULL;    // haven't found this name
+//////////////////////////////////////////////////////////////////////////
+void CXConsole::ResetLookupStats()
+{
+	m_lookupStats.numLookups = 0;
+	m_lookupStats.numMisses = 0;
+	m_lookupStats.ticks = 0;
+	m_lookupStats.startFrameId = gEnv->nMainFrameID;
+	m_lookupStats.startTicks = CryGetTicks();
+
+	std::vector<VariableRegistry::SSlot*> variableSlots;
+	m_variableRegistry.GetSlots(variableSlots);
+	for (size_t i = 0; i < variableSlots.size(); ++i)
+		variableSlots[i]->numLookups = 0;
+
+	std::vector<CommandRegistry::SSlot*> commandSlots;
+	m_commandRegistry.GetSlots(commandSlots);
+	for (size_t i = 0; i < commandSlots.size(); ++i)
+		commandSlots[i]->numLookups = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CXConsole::CountLookup(volatile LONG* pSlotLookups, int64 ticks)
+{
+	CryInterlockedIncrement(&m_lookupStats.numLookups);
+	CryInterlockedAdd(&m_lookupStats.ticks, (size_t)ticks);
+	if (pSlotLookups)
+		CryInterlockedIncrement(pSlotLookups);
+	else
+		CryInterlockedIncrement(&m_lookupStats.numMisses);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CXConsole::OnLookupStatsChange(ICVar* pVar)
+{
+	if (pVar->GetIVal())
+		static_cast<CXConsole*>(gEnv->pConsole)->ResetLookupStats();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1832,7 +1867,7 @@ void CXConsole::AddCommand(const char* sCommand, ConsoleCommandFunc func, int nF
 {
 	AssertName(sCommand);
 
-	if (m_mapCommands.find(sCommand) == m_mapCommands.end())
+	if (!m_commandRegistry.Find(sCommand))
 	{
 		CConsoleCommand cmd;
 		cmd.m_sName = sCommand;
@@ -1842,7 +1877,8 @@ void CXConsole::AddCommand(const char* sCommand, ConsoleCommandFunc func, int nF
 			cmd.m_sHelp = sHelp;
 		}
 		cmd.m_nFlags = nFlags;
-		m_mapCommands.insert(std::make_pair(cmd.m_sName, cmd));
+		ConsoleCommandsMapItor itCmd = m_mapCommands.insert(std::make_pair(cmd.m_sName, cmd)).first;
+		m_commandRegistry.Set(sCommand, &itCmd->second);
 	}
 	else
 	{
@@ -1858,7 +1894,7 @@ void CXConsole::AddCommand(const char* sCommand, const char* sScriptFunc, int nF
 {
 	AssertName(sCommand);
 
-	if (m_mapCommands.find(sCommand) == m_mapCommands.end())
+	if (!m_commandRegistry.Find(sCommand))
 	{
 		CConsoleCommand cmd;
 		cmd.m_sName = sCommand;
@@ -1868,7 +1904,8 @@ void CXConsole::AddCommand(const char* sCommand, const char* sScriptFunc, int nF
 			cmd.m_sHelp = sHelp;
 		}
 		cmd.m_nFlags = nFlags;
-		m_mapCommands.insert(std::make_pair(cmd.m_sName, cmd));
+		ConsoleCommandsMapItor itCmd = m_mapCommands.insert(std::make_pair(cmd.m_sName, cmd)).first;
+		m_commandRegistry.Set(sCommand, &itCmd->second);
 	}
 	else
 	{
@@ -1884,7 +1921,10 @@ void CXConsole::RemoveCommand(const char* sName)
 {
 	ConsoleCommandsMap::iterator ite = m_mapCommands.find(sName);
 	if (ite != m_mapCommands.end())
+	{
 		m_mapCommands.erase(ite);
+		m_commandRegistry.Set(sName, NULL);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -2261,9 +2301,6 @@ void CXConsole::ExecuteStringInternal(const char* command, const bool bFromConso
 		}
 	}
 
-	ConsoleCommandsMapItor itrCmd;
-	ConsoleVariablesMapItor itrVar;
-
 	std::list<string> lineCommands;
 	SplitCommands(command, lineCommands);
 
@@ -2314,21 +2351,28 @@ void CXConsole::ExecuteStringInternal(const char* command, const bool bFromConso
 			}
 		}
 
+		// the name is hashed once for both lookups
+		const int64 startTicks = con_lookup_stats ? CryGetTicks() : 0;
+		const uint32 nameHash = VariableRegistry::HashName(sCommand.c_str());
+
 		//////////////////////////////////////////
 		//Check if is a command
-		itrCmd = m_mapCommands.find(sCommand);
-		if (itrCmd != m_mapCommands.end())
+		CommandRegistry::SSlot* pCmdSlot = m_commandRegistry.FindSlot(sCommand.c_str(), nameHash);
+		CConsoleCommand* pCmd = pCmdSlot ? pCmdSlot->pValue : NULL;
+		if (pCmd && con_lookup_stats)
+			CountLookup(&pCmdSlot->numLookups, CryGetTicks() - startTicks);
+		if (pCmd)
 		{
-			if (((itrCmd->second).m_nFlags & VF_RESTRICTEDMODE) || !con_restricted || !bFromConsole)     // in restricted mode we allow only VF_RESTRICTEDMODE CVars&CCmd
+			if ((pCmd->m_nFlags & VF_RESTRICTEDMODE) || !con_restricted || !bFromConsole)     // in restricted mode we allow only VF_RESTRICTEDMODE CVars&CCmd
 			{
-				if (itrCmd->second.m_nFlags & VF_BLOCKFRAME)
+				if (pCmd->m_nFlags & VF_BLOCKFRAME)
 					m_blockCounter++;
 
 				{
 					ScopedSwitchToGlobalHeap globalHeap;
 					sTemp = sLineCommand;
 				}
-				ExecuteCommand((itrCmd->second), sTemp);
+				ExecuteCommand(*pCmd, sTemp);
 
 				continue;
 			}
@@ -2336,11 +2380,12 @@ void CXConsole::ExecuteStringInternal(const char* command, const bool bFromConso
 
 		//////////////////////////////////////////
 		//Check  if is a variable
-		itrVar = m_mapVariables.find(sCommand);
-		if (itrVar != m_mapVariables.end())
+		VariableRegistry::SSlot* pVarSlot = m_variableRegistry.FindSlot(sCommand.c_str(), nameHash);
+		ICVar* pCVar = pVarSlot ? pVarSlot->pValue : NULL;
+		if (!pCmd && con_lookup_stats)
+			CountLookup(pCVar ? &pVarSlot->numLookups : NULL, CryGetTicks() - startTicks);
+		if (pCVar)
 		{
-			ICVar* pCVar = itrVar->second;
-
 			if ((pCVar->GetFlags() & VF_RESTRICTEDMODE) || !con_restricted || !bFromConsole)     // in restricted mode we allow only VF_RESTRICTEDMODE CVars&CCmd
 			{
 				if (pCVar->GetFlags() & VF_BLOCKFRAME)
@@ -2353,8 +2398,7 @@ void CXConsole::ExecuteStringInternal(const char* command, const bool bFromConso
 
 					if (sTemp == "?")
 					{
-						ICVar* v = itrVar->second;
-						DisplayHelp(v->GetHelp(), sCommand.c_str());
+						DisplayHelp(pCVar->GetHelp(), sCommand.c_str());
 						return;
 					}
 
@@ -3402,6 +3446,88 @@ void CXConsole::CmdDumpLastHashedAnticheatVars(IConsoleCmdArgs* pArgs)
 #endif
 }
 
+void CXConsole::CmdDumpLookupStats(IConsoleCmdArgs* pArgs)
+{
+	CXConsole* pConsole = (CXConsole*)gEnv->pConsole;
+	const SLookupStats& stats = pConsole->m_lookupStats;
+
+	if (pArgs->GetArgCount() > 1 && !stricmp(pArgs->GetArg(1), "reset"))
+	{
+		pConsole->ResetLookupStats();
+		return;
+	}
+
+	const double ticksPerMs = gEnv->pTimer->GetTicksPerSecond() / 1000.0;
+
+	if (con_lookup_stats)
+	{
+		const int numFrames = max((int)gEnv->nMainFrameID - stats.startFrameId, 1);
+		const int numLookups = (int)stats.numLookups;
+		const double lookupMs = stats.ticks / ticksPerMs;
+		const double elapsedMs = max((CryGetTicks() - stats.startTicks) / ticksPerMs, 0.001);
+		CryLogAlways("Console lookups by name over %d frames: %d (%.1f per frame), %d of unknown names",
+		             numFrames, numLookups, (double)numLookups / numFrames, (int)stats.numMisses);
+		CryLogAlways("Console lookup time: %.3f ms, %.2f us per frame, %.0f ns per lookup, %.4f%% of the %.1f s",
+		             lookupMs, lookupMs * 1000.0 / numFrames, numLookups ? lookupMs * 1000000.0 / numLookups : 0.0, lookupMs * 100.0 / elapsedMs, elapsedMs / 1000.0);
+
+		// the names looked up most often, good candidates for a CCVarHandle
+		std::vector<std::pair<int, const char*>> counts;
+		std::vector<VariableRegistry::SSlot*> variableSlots;
+		pConsole->m_variableRegistry.GetSlots(variableSlots);
+		for (size_t i = 0; i < variableSlots.size(); ++i)
+		{
+			if (variableSlots[i]->numLookups)
+				counts.push_back(std::make_pair((int)variableSlots[i]->numLookups, variableSlots[i]->name.c_str()));
+		}
+		std::vector<CommandRegistry::SSlot*> commandSlots;
+		pConsole->m_commandRegistry.GetSlots(commandSlots);
+		for (size_t i = 0; i < commandSlots.size(); ++i)
+		{
+			if (commandSlots[i]->numLookups)
+				counts.push_back(std::make_pair((int)commandSlots[i]->numLookups, commandSlots[i]->name.c_str()));
+		}
+		std::sort(counts.begin(), counts.end(), [](const std::pair<int, const char*>& a, const std::pair<int, const char*>& b) { return a.first > b.first; });
+
+		for (size_t i = 0; i < counts.size() && i < 20; ++i)
+			CryLogAlways("  %8d (%.1f per frame) %s", counts[i].first, (float)counts[i].first / numFrames, counts[i].second);
+	}
+	else
+	{
+		CryLogAlways("Console lookups by name are only measured while con_lookup_stats is 1");
+	}
+
+	// every registered variable by the sorted map and by the hash registry
+	std::vector<const char*> names;
+	names.reserve(pConsole->m_mapVariables.size());
+	for (ConsoleVariablesMap::const_iterator it = pConsole->m_mapVariables.begin(); it != pConsole->m_mapVariables.end(); ++it)
+		names.push_back(it->first);
+	if (names.empty())
+		return;
+
+	const int numRepeats = 100;
+	size_t numFound = 0;
+
+	int64 startTicks = CryGetTicks();
+	for (int repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		for (size_t i = 0; i < names.size(); ++i)
+			numFound += pConsole->m_mapVariables.find(names[i]) != pConsole->m_mapVariables.end();
+	}
+	const int64 mapTicks = CryGetTicks() - startTicks;
+
+	startTicks = CryGetTicks();
+	for (int repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		for (size_t i = 0; i < names.size(); ++i)
+			numFound += pConsole->m_variableRegistry.Find(names[i]) != NULL;
+	}
+	const int64 registryTicks = CryGetTicks() - startTicks;
+
+	const double nsPerTick = 1000000.0 / ticksPerMs / ((double)names.size() * numRepeats);
+	CryLogAlways("Looking up all %d variables %d times: %.1f ns per lookup in the sorted map, %.1f ns in the hash registry (%d slots, %d found)",
+	             (int)names.size(), numRepeats, mapTicks * nsPerTick, registryTicks * nsPerTick, (int)pConsole->m_variableRegistry.GetNumSlots(), (int)numFound);
+}
+
 void CXConsole::PrintCheatVars(bool bUseLastHashRange)
 {
 #if defined(DEFENCE_CVAR_HASH_LOGGING)
@@ -3690,6 +3816,8 @@ void CXConsole::GetMemoryUsage(class ICrySizer* pSizer) const
 	pSizer->AddObject(m_dqHistory);
 	pSizer->AddObject(m_mapCommands);
 	pSizer->AddObject(m_mapBinds);
+	m_commandRegistry.GetMemoryUsage(pSizer);
+	m_variableRegistry.GetMemoryUsage(pSizer);
 }
 
 //////////////////////////////////////////////////////////////////////////
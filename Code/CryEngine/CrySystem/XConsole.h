@@ -11,6 +11,7 @@
 #include <CryInput/IInput.h>
 #include <CryCore/CryCrc32.h>
 #include "Timer.h"
+#include "ConsoleNameRegistry.h"
 
 //forward declaration
 struct IIpnut;
@@ -154,6 +155,7 @@ public:
 	virtual bool                   GetLineNo(const int indwLineNo, char* outszBuffer, const int indwBufferSize) const;
 	virtual int                    GetLineCount() const;
 	virtual ICVar*                 GetCVar(const char* name);
+	virtual ICVar* const*          GetCVarSlot(const char* name);
 	virtual char*                  GetVariable(const char* szVarName, const char* szFileName, const char* def_val);
 	virtual float                  GetVariable(const char* szVarName, const char* szFileName, float def_val);
 	virtual void                   PrintLine(const char* s);
@@ -268,6 +270,7 @@ protected: // ------------------------------------------------------------------
 
 	static void        CmdDumpAllAnticheatVars(IConsoleCmdArgs* pArgs);
 	static void        CmdDumpLastHashedAnticheatVars(IConsoleCmdArgs* pArgs);
+	static void        CmdDumpLookupStats(IConsoleCmdArgs* pArgs);
 
 private: // ----------------------------------------------------------
 
@@ -287,6 +290,10 @@ private: // ----------------------------------------------------------
 	typedef std::map<string, CConsoleCommand, string_nocase_lt>                        ConsoleCommandsMap;
 	typedef ConsoleCommandsMap::iterator                                               ConsoleCommandsMapItor;
 
+	// Hashed lookup by name, the maps above are kept for the iteration in alphabetical order
+	typedef CConsoleNameRegistry<ICVar>                                                VariableRegistry;
+	typedef CConsoleNameRegistry<CConsoleCommand>                                      CommandRegistry; // points into m_mapCommands
+
 	typedef std::map<string, string>                                                   ConsoleBindsMap;
 	typedef ConsoleBindsMap::iterator                                                  ConsoleBindsMapItor;
 
@@ -313,6 +320,20 @@ private: // ----------------------------------------------------------
 
 	typedef std::list<IConsoleVarSink*> ConsoleVarSinks;
 
+	// Cost of looking up variables and commands by name while con_lookup_stats is on
+	struct SLookupStats
+	{
+		volatile LONG   numLookups;
+		volatile LONG   numMisses;
+		volatile size_t ticks;
+		int             startFrameId;
+		int64           startTicks;
+	};
+
+	void        ResetLookupStats();
+	void        CountLookup(volatile LONG* pSlotLookups, int64 ticks);
+	static void OnLookupStatsChange(ICVar* pVar);
+
 	// --------------------------------------------------------------------------------
 
 	ConsoleBuffer                  m_dqConsoleBuffer;
@@ -333,6 +354,9 @@ private: // ----------------------------------------------------------
 	ConsoleCommandsMap             m_mapCommands;             //
 	ConsoleBindsMap                m_mapBinds;                //
 	ConsoleVariablesMap            m_mapVariables;            //
+	CommandRegistry                m_commandRegistry;
+	VariableRegistry               m_variableRegistry;
+	SLookupStats                   m_lookupStats;
 	ConsoleVariablesVector         m_randomCheckedVariables;
 	ConsoleVariablesVector         m_alwaysCheckedVariables;
 	std::vector<IOutputPrintSink*> m_OutputSinks;             // objects in this vector are not released
@@ -390,6 +414,7 @@ private: // ----------------------------------------------------------
 	static int                     con_showonload;
 	static int                     con_debug;
 	static int                     con_restricted;
+	static int                     con_lookup_stats;
 
 	friend void Command_SetWaitSeconds(IConsoleCmdArgs* Cmd);
 	friend void Command_SetWaitFrames(IConsoleCmdArgs* Cmd);
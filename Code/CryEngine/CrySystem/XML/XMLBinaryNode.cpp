@@ -11,6 +11,7 @@
 
 #include <StdAfx.h>
 #include "XMLBinaryNode.h"
+#include "XMLBinaryReader.h"
 #include <CryMemory/CrySizer.h>
 
 #pragma warning(disable : 6031) // Return value ignored: 'sscanf'
@@ -24,6 +25,7 @@ CBinaryXmlData::CBinaryXmlData()
 	, pFileContents(0)
 	, nFileSize(0)
 	, bOwnsFileContentsMemory(true)
+	, pSharedContents(0)
 	, pBinaryNodes(0)
 	, nRefCount(0)
 {
@@ -32,11 +34,17 @@ CBinaryXmlData::CBinaryXmlData()
 //////////////////////////////////////////////////////////////////////////
 CBinaryXmlData::~CBinaryXmlData()
 {
-	if (bOwnsFileContentsMemory)
+	if (pSharedContents)
+	{
+		XMLBinary::XMLBinaryReader::ReleaseSharedContents(pSharedContents);
+		pSharedContents = 0;
+	}
+	else if (bOwnsFileContentsMemory)
 	{
 		delete[] pFileContents;
 	}
 	pFileContents = 0;
+	pMappedBlock = 0;
 
 	delete[] pBinaryNodes;
 	pBinaryNodes = 0;
@@ -44,7 +52,9 @@ CBinaryXmlData::~CBinaryXmlData()
 
 void CBinaryXmlData::GetMemoryUsage(ICrySizer* pSizer) const
 {
-	pSizer->AddObject(pFileContents, nFileSize);
+	// mapped contents are accounted with the pak
+	if (!pMappedBlock)
+		pSizer->AddObject(pFileContents, nFileSize);
 	const XMLBinary::BinaryFileHeader* pHeader = reinterpret_cast<const XMLBinary::BinaryFileHeader*>(pFileContents);
 	pSizer->AddObject(pBinaryNodes, sizeof(CBinaryXmlNode) * pHeader->nNodeCount);
 }
@@ -21,6 +21,12 @@ typedef int (__cdecl * XmlStrCmpFunc)(const char* str1, const char* str2);
 extern XmlStrCmpFunc g_pXmlStrCmp;
 
 class CBinaryXmlNode;
+struct IMemoryBlock;
+
+namespace XMLBinary
+{
+struct SSharedContents;
+}
 
 //////////////////////////////////////////////////////////////////////////
 class CBinaryXmlData
@@ -34,6 +40,10 @@ public:
 	const char*                 pFileContents;
 	size_t                      nFileSize;
 	bool                        bOwnsFileContentsMemory;
+	// set if pFileContents points into a mapped pak, keeps the mapping alive
+	_smart_ptr<IMemoryBlock>    pMappedBlock;
+	// set if pFileContents is shared with the other documents loaded from the same pak entry
+	XMLBinary::SSharedContents* pSharedContents;
 
 	CBinaryXmlNode*             pBinaryNodes;
 
@@ -6,6 +6,35 @@
 #include "StdAfx.h"
 #include "XMLBinaryReader.h"
 #include "XMLBinaryNode.h"
+#include "../CryPak.h"
+
+namespace
+{
+// Contents of the documents loaded from pak entries, by entry. An entry is removed when the last
+// document using it is released.
+struct SSharedContentsPool
+{
+	CryCriticalSection                            lock;
+	std::map<string, XMLBinary::SSharedContents*> contents;
+};
+
+SSharedContentsPool& GetSharedContentsPool()
+{
+	static SSharedContentsPool pool;
+	return pool;
+}
+
+// The header and the tables are accessed in place through their uint32 fields, but pak entries
+// are not aligned, so only aligned contents can be used without a copy.
+bool AreTablesAligned(const char* pContents)
+{
+	XMLBinary::BinaryFileHeader header;
+	memcpy(&header, pContents, sizeof(header));
+
+	const size_t alignmentMask = sizeof(uint32) - 1;
+	return ((reinterpret_cast<size_t>(pContents) | header.nNodeTablePosition | header.nAttributeTablePosition | header.nChildTablePosition) & alignmentMask) == 0;
+}
+}
 
 XMLBinary::XMLBinaryReader::XMLBinaryReader()
 {
@@ -41,6 +70,13 @@ XmlNodeRef XMLBinary::XMLBinaryReader::LoadFromFile(
 		return 0;
 	}
 
+	XmlNodeRef pRoot = LoadFromPakFile(xmlFile.GetHandle(), result);
+	if (result != eResult_NotInPak)
+	{
+		return pRoot;
+	}
+	result = eResult_Error;
+
 	const size_t fileSize = xmlFile.GetLength();
 	if (fileSize < sizeof(BinaryFileHeader))
 	{
@@ -152,6 +188,147 @@ XmlNodeRef XMLBinary::XMLBinaryReader::LoadFromBuffer(
 	return &pData->pBinaryNodes[0];
 }
 
+XmlNodeRef XMLBinary::XMLBinaryReader::LoadFromPakFile(FILE* hFile, EResult& result)
+{
+	LOADING_TIME_PROFILE_SECTION;
+
+	m_errorDescription[0] = 0;
+	result = eResult_NotInPak;
+
+	CCachedFileDataPtr pFileData = static_cast<CCryPak*>(gEnv->pCryPak)->GetOpenedFileDataInZip(hFile);
+	if (!pFileData || !pFileData->GetFileEntry())
+	{
+		return 0;
+	}
+
+	ZipDir::FileEntry* const pFileEntry = pFileData->GetFileEntry();
+	const size_t size = pFileEntry->desc.lSizeUncompressed;
+	if (size < sizeof(BinaryFileHeader))
+	{
+		result = eResult_NotBinXml;
+		SetErrorDescription("Not a binary XML - data size is too small.");
+		return 0;
+	}
+
+	// Stored entries of a mapped pak are used in place, the document keeps the mapping alive.
+	// Misaligned entries are copied below, like the entries of other paks.
+	if (pFileEntry->nMethod == ZipFile::METHOD_STORE && pFileData->GetZip()->IsMapped())
+	{
+		const char* const pMappedData = static_cast<const char*>(pFileData->GetReadOnlyData());
+		if (pMappedData && pFileData->m_pMappedBlock && AreTablesAligned(pMappedData))
+		{
+			Check(pMappedData, size, result);
+			if (result != eResult_Success)
+			{
+				return 0;
+			}
+
+			CBinaryXmlData* const pData = Create(pMappedData, size, result);
+			if (result != eResult_Success)
+			{
+				return 0;
+			}
+			pData->pMappedBlock = pFileData->m_pMappedBlock;
+			return &pData->pBinaryNodes[0];
+		}
+	}
+
+	// Check the header before reading the whole entry, text XML is read again by the caller.
+	BinaryFileHeader header;
+	if (pFileData->ReadData(&header, 0, sizeof(header)) != sizeof(header))
+	{
+		result = eResult_Error;
+		SetErrorDescription("Failed to read binary XML file, the file is corrupt.");
+		return 0;
+	}
+	CheckHeader(header, size, result);
+	if (result != eResult_Success)
+	{
+		return 0;
+	}
+
+	ZipDir::Cache* const pZip = pFileData->GetZip();
+	string key;
+	key.Format("%p:%s:%u:%08x:%u", pZip, pZip->GetFilePath(), pFileEntry->nNameOffset, pFileEntry->desc.lCRC32, static_cast<uint32>(size));
+
+	SSharedContentsPool& pool = GetSharedContentsPool();
+	SSharedContents* pSharedContents = 0;
+	{
+		AUTO_LOCK_T(CryCriticalSection, pool.lock);
+		std::map<string, SSharedContents*>::const_iterator it = pool.contents.find(key);
+		if (it != pool.contents.end())
+		{
+			pSharedContents = it->second;
+			++pSharedContents->nRefCount;
+		}
+	}
+	if (pSharedContents)
+	{
+		return CreateShared(pSharedContents, result);
+	}
+
+	char* const pFileContents = new char[size];
+	if (pFileData->ReadData(pFileContents, 0, size) != static_cast<int64>(size))
+	{
+		delete[] pFileContents;
+		result = eResult_Error;
+		SetErrorDescription("Failed to read binary XML file, the file is corrupt.");
+		return 0;
+	}
+
+	SSharedContents* const pContents = new SSharedContents;
+	pContents->pData = pFileContents;
+	pContents->nSize = size;
+	pContents->key = key;
+	pContents->nRefCount = 1;
+	{
+		AUTO_LOCK_T(CryCriticalSection, pool.lock);
+		if (!pool.contents.insert(std::make_pair(key, pContents)).second)
+		{
+			// another thread loaded the same entry meanwhile, this copy stays private
+			pContents->key.clear();
+		}
+	}
+
+	return CreateShared(pContents, result);
+}
+
+void XMLBinary::XMLBinaryReader::ReleaseSharedContents(SSharedContents* pContents)
+{
+	SSharedContentsPool& pool = GetSharedContentsPool();
+	{
+		AUTO_LOCK_T(CryCriticalSection, pool.lock);
+		if (--pContents->nRefCount > 0)
+		{
+			return;
+		}
+		if (!pContents->key.empty())
+		{
+			pool.contents.erase(pContents->key);
+		}
+	}
+
+	delete[] pContents->pData;
+	delete pContents;
+}
+
+XmlNodeRef XMLBinary::XMLBinaryReader::CreateShared(SSharedContents* pContents, EResult& result)
+{
+	CBinaryXmlData* const pData = Create(pContents->pData, pContents->nSize, result);
+	if (result != eResult_Success)
+	{
+		assert(pData == 0);
+		ReleaseSharedContents(pContents);
+		return 0;
+	}
+
+	assert(pData);
+	pData->pSharedContents = pContents;
+
+	// Return first node
+	return &pData->pBinaryNodes[0];
+}
+
 void XMLBinary::XMLBinaryReader::Check(const char* buffer, size_t size, EResult& result)
 {
 	m_errorDescription[0] = 0;
@@ -13,6 +13,15 @@ class CBinaryXmlData;
 
 namespace XMLBinary
 {
+// File contents shared by the binary XML documents loaded from the same pak entry.
+struct SSharedContents
+{
+	const char*  pData;
+	size_t       nSize;
+	string       key;
+	int          nRefCount; // guarded by the lock of the pool
+};
+
 class XMLBinaryReader
 {
 public:
@@ -20,7 +29,8 @@ public:
 	{
 		eResult_Success,
 		eResult_NotBinXml,
-		eResult_Error
+		eResult_Error,
+		eResult_NotInPak
 	};
 
 	enum EBufferMemoryHandling
@@ -41,12 +51,21 @@ public:
 	// Otherwise, the caller is responsible for releasing buffer's memory.
 	XmlNodeRef  LoadFromBuffer(EBufferMemoryHandling bufferMemoryHandling, const char* buffer, size_t size, EResult& result);
 
+	// Loads a file opened through CryPak directly from its pak entry. Stored entries of mapped paks
+	// are used in place without a copy, other entries are read once and their contents are shared by
+	// all documents loaded from the same entry while any of them is alive.
+	// Returns eResult_NotInPak if the file isn't in a pak, it has to be read the regular way then.
+	XmlNodeRef  LoadFromPakFile(FILE* hFile, EResult& result);
+
+	static void ReleaseSharedContents(SSharedContents* pContents);
+
 	const char* GetErrorDescription() const;
 
 private:
 	void            Check(const char* buffer, size_t size, EResult& result);
 	void            CheckHeader(const BinaryFileHeader& layout, size_t size, EResult& result);
 	CBinaryXmlData* Create(const char* buffer, size_t size, EResult& result);
+	XmlNodeRef      CreateShared(SSharedContents* pContents, EResult& result);
 	void            SetErrorDescription(const char* text);
 
 private:
@@ -1675,6 +1675,25 @@ XmlNodeRef XmlParserImp::ParseFile(const char* filename, XmlString& errorString,
 			return 0;
 		}
 
+		if (g_bEnableBinaryXmlLoading)
+		{
+			// binary XML from a pak is loaded without the copy below, see XMLBinaryReader::LoadFromPakFile()
+			XMLBinary::XMLBinaryReader reader;
+			XMLBinary::XMLBinaryReader::EResult result;
+			root = reader.LoadFromPakFile(xmlFile.GetHandle(), result);
+			if (root)
+			{
+				return root;
+			}
+			if (result == XMLBinary::XMLBinaryReader::eResult_Error)
+			{
+				cry_sprintf(str, "%s%s (%s)", errorPrefix, reader.GetErrorDescription(), filename);
+				errorString = str;
+				CryWarning(VALIDATOR_MODULE_SYSTEM, VALIDATOR_WARNING, "%s", str);
+				return 0;
+			}
+		}
+
 		pFileContents = new char[fileSize];
 		if (!pFileContents)
 		{
@@ -16,6 +16,10 @@
 #include "ZipEncrypt.h"
 #include "System.h"
 
+#ifdef SUPPORT_POSITIONAL_READS
+	#include <unistd.h>
+#endif
+
 using namespace ZipFile;
 
 #if CRY_PLATFORM_ANDROID && defined(ANDROID_OBB)
@@ -79,6 +83,30 @@ void ZipDir::Cache::UnloadFromMemory()
 	m_zipFile.UnloadFromMemory();
 }
 
+bool ZipDir::Cache::MapToMemory()
+{
+	CryAutoCriticalSection lock(m_pCacheData->m_csCacheIOLock);
+
+	if (!m_zipFile.MapToMemory())
+		return false;
+	m_nPakFileOffsetOnMedia = 0;
+	return true;
+}
+
+const void* ZipDir::Cache::GetMappedFileData(FileEntry* pFileEntry, _smart_ptr<IMemoryBlock>& rMappedBlock)
+{
+	if (!m_zipFile.IsMapped() || Refresh(pFileEntry) != ZD_ERROR_SUCCESS)
+		return NULL;
+
+	// the pak may get unloaded from another thread, the returned reference keeps the mapping alive
+	CryAutoCriticalSection lock(m_pCacheData->m_csCacheIOLock);
+	if (!m_zipFile.IsMapped() || (int64)pFileEntry->nFileDataOffset + pFileEntry->desc.lSizeCompressed > m_zipFile.m_nSize)
+		return NULL;
+
+	rMappedBlock = m_zipFile.m_pInMemoryData;
+	return (const char*)m_zipFile.m_pInMemoryData->GetData() + pFileEntry->nFileDataOffset;
+}
+
 // initializes this object from the given Zip file: caches the central directory
 // returns 0 if successfully parsed, error code if an error has occured
 ZipDir::CachePtr ZipDir::NewCache(const char* szFileName, CMTSafeHeap* pHeap, InitMethodEnum nInitMethod)
@@ -194,6 +222,14 @@ ZipDir::ErrorEnum ZipDir::Cache::ReadFile(FileEntry* pFileEntry, void* pCompress
 		pBuffer = pUncompressed;
 	}
 
+	// compressed data of a mapped pak is inflated straight from the mapping, no need for a temporary copy
+	_smart_ptr<IMemoryBlock> pMappedBlock;
+	if (!pBuffer && pUncompressed && decompress && pFileEntry->IsCompressed() && !pFileEntry->IsEncrypted() && nDataOffset == 0 && nDataReadSize == -1 && m_zipFile.IsMapped())
+	{
+		// not encrypted, so the buffer is only read by the inflate
+		pBuffer = const_cast<void*>(GetMappedFileData(pFileEntry, pMappedBlock));
+	}
+
 	if (!pBuffer)
 	{
 		if (!pUncompressed)
@@ -209,6 +245,7 @@ ZipDir::ErrorEnum ZipDir::Cache::ReadFile(FileEntry* pFileEntry, void* pCompress
 			pBuffer = pUncompressed;
 	}
 
+	if (!pMappedBlock)
 	{
 		CryAutoCriticalSection lock(m_pCacheData->m_csCacheIOLock); // guarantees that fseek() and fread() will be executed together
 		FRAME_PROFILER("ZipDir_Cache_ReadFile", gEnv->pSystem, PROFILE_SYSTEM);
@@ -434,6 +471,55 @@ ZipDir::ErrorEnum ZipDir::Cache::ReadFileStreaming(FileEntry* pFileEntry, void*
 	}
 #endif
 
+	// the streaming IO threads read concurrently, so avoid holding the cache lock while reading
+	if (!bRead && m_zipFile.IsMapped())
+	{
+		_smart_ptr<IMemoryBlock> pMappedBlock;
+		if (const char* pMappedData = (const char*)GetMappedFileData(pFileEntry, pMappedBlock))
+		{
+			if (!nDataReadSize)
+				nDataReadSize = pFileEntry->desc.lSizeCompressed;
+			memcpy(pOut, pMappedData + nDataOffset, (size_t)nDataReadSize);
+			bRead = true;
+		}
+	}
+
+#ifdef SUPPORT_POSITIONAL_READS
+	if (!bRead && !m_zipFile.IsInMemory() && m_zipFile.m_file)
+	{
+		FRAME_PROFILER("ZipDir_Cache_ReadFile", gEnv->pSystem, PROFILE_SYSTEM);
+
+		ErrorEnum nError = Refresh(pFileEntry);
+		if (nError != ZD_ERROR_SUCCESS)
+			return nError;
+
+		if (!nDataReadSize)
+			nDataReadSize = pFileEntry->desc.lSizeCompressed;
+		nDataOffset += pFileEntry->nFileDataOffset;
+
+		const int fd = fileno(m_zipFile.m_file);
+		char* pDest = (char*)pOut;
+		while (nDataReadSize > 0)
+		{
+			const ssize_t nRead = pread(fd, pDest, (size_t)nDataReadSize, (off_t)nDataOffset);
+			if (nRead <= 0)
+			{
+				if (nRead < 0 && errno == EINTR)
+					continue;
+
+				CryWarning(VALIDATOR_MODULE_SYSTEM, VALIDATOR_ERROR_DBGBRK, "ZipDir::ReadFileStreaming pread failed (%p %p) = %i", &m_zipFile, pFileEntry, errno);
+				return ZD_ERROR_IO_FAILED;
+			}
+
+			pDest += nRead;
+			nDataOffset += nRead;
+			nDataReadSize -= nRead;
+		}
+
+		bRead = true;
+	}
+#endif
+
 	if (!bRead)
 	{
 		return ReadFile(pFileEntry, pOut, NULL, false, nDataOffset, nDataReadSize, false);
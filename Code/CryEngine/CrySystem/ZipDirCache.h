@@ -107,6 +107,15 @@ struct Cache
 		return m_zipFile.IsInMemory();
 	}
 
+	bool IsMapped() const
+	{
+		return m_zipFile.IsMapped();
+	}
+
+	// returns the data of the file entry as stored in the mapped pak (thus possibly compressed/encrypted), NULL if the pak isn't mapped
+	// rMappedBlock receives a reference to the mapping which has to be held as long as the data is used
+	const void* GetMappedFileData(FileEntry* pFileEntry, _smart_ptr<IMemoryBlock>& rMappedBlock);
+
 	//explicitly sets the priority
 	uint64 SetPakFileOffsetOnMedia(uint64 off) { m_nPakFileOffsetOnMedia = off; return m_nPakFileOffsetOnMedia; }
 	uint64 GetPakFileOffsetOnMedia()           { return m_nPakFileOffsetOnMedia; }
@@ -200,6 +209,8 @@ public:
 	void Delete();
 	void PreloadToMemory(IMemoryBlock* pMemoryBlock = NULL);
 	void UnloadFromMemory();
+	// maps the whole pak instead of reading it through stdio, returns false if not supported or failed
+	bool MapToMemory();
 private:
 	// the constructor/destructor cannot be called at all - everything will go through the factory class
 	Cache() { m_nCacheFactoryFlags = 0; m_nPakFileOffsetOnMedia = 0; }
@@ -18,6 +18,11 @@
 LINK_SYSTEM_LIBRARY("shlwapi.lib")
 #endif
 
+#ifdef SUPPORT_MAPPED_PAKS
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
 using namespace ZipFile;
 
 void        ZlibInflateElement_Impl(const void* pCompressed, void* pUncompressed, unsigned long compressedSize, unsigned long nUnCompressedSize, unsigned long* pUncompressedSize, int* pReturnCode, CMTSafeHeap* pHeap);
@@ -362,6 +367,64 @@ error:
 void ZipDir::CZipFile::UnloadFromMemory()
 {
 	SAFE_RELEASE(m_pInMemoryData);
+	m_bMapped = false;
+}
+
+#ifdef SUPPORT_MAPPED_PAKS
+//////////////////////////////////////////////////////////////////////////
+// Read-only file mapping of a whole pak.
+// The pages are backed by the page cache, so all processes mapping the same pak share the physical memory.
+class CMappedPakMemoryBlock : public ICustomMemoryBlock
+{
+public:
+	CMappedPakMemoryBlock(void* pData, size_t nSize) : m_pData(pData), m_nSize(nSize) {}
+	~CMappedPakMemoryBlock() { munmap(m_pData, m_nSize); }
+
+	virtual void* GetData()                                                       { return m_pData; }
+	// paks over 2GB are mapped whole, but the interface can't report their size
+	virtual int   GetSize()                                                       { return (int)min(m_nSize, (size_t)INT_MAX); }
+	virtual void  CopyMemoryRegion(void* pOutputBuffer, size_t nOffset, size_t nSize) { memcpy(pOutputBuffer, (char*)m_pData + nOffset, nSize); }
+
+private:
+	void*  m_pData;
+	size_t m_nSize;
+};
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+bool ZipDir::CZipFile::MapToMemory()
+{
+#ifdef SUPPORT_MAPPED_PAKS
+	LOADING_TIME_PROFILE_SECTION;
+
+	if (m_pInMemoryData)
+		return m_bMapped;
+	if (!m_file)
+		return false;
+
+	const int fd = fileno(m_file);
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+		return false;
+
+	// views into the mapping are only handed out for reading, see CCachedFileData::GetReadOnlyData
+	const size_t nFileSize = (size_t)fileStat.st_size;
+	void* pData = mmap(NULL, nFileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (pData == MAP_FAILED)
+	{
+		CryWarning(VALIDATOR_MODULE_SYSTEM, VALIDATOR_WARNING, "Failed to map pak %s (errno %d), falling back to stdio reads", m_szFilename ? m_szFilename : "<unknown>", errno);
+		return false;
+	}
+
+	m_pInMemoryData = new CMappedPakMemoryBlock(pData, nFileSize);
+	m_pInMemoryData->AddRef();
+	m_nSize = nFileSize;
+	m_nCursor = 0;
+	m_bMapped = true;
+	return true;
+#else
+	return false;
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,13 @@
 	#define SUPPORT_UNBUFFERED_IO
 #endif
 
+// paks can be mapped into the address space instead of being read through stdio, see sys_PakMapped
+// streaming reads use pread, which doesn't share the file position, so several reads can be in flight
+#if CRY_PLATFORM_LINUX
+	#define SUPPORT_MAPPED_PAKS
+	#define SUPPORT_POSITIONAL_READS
+#endif
+
 // this was enabled for last gen consoles, could be useful for durango & orbis
 //#define OPTIMIZED_READONLY_ZIP_ENTRY
 
@@ -68,6 +75,7 @@ struct CZipFile
 	int64               m_nCursor;
 	const char*         m_szFilename;
 	ICustomMemoryBlock* m_pInMemoryData;
+	bool                m_bMapped; // m_pInMemoryData is a read-only file mapping, its data can be referenced directly
 
 	CZipFile()
 		: m_file(0)
@@ -86,6 +94,7 @@ struct CZipFile
 		, m_nCursor(0)
 		, m_szFilename(0)
 		, m_pInMemoryData(0)
+		, m_bMapped(false)
 	{}
 
 	void Swap(CZipFile& other)
@@ -107,10 +116,15 @@ struct CZipFile
 		swap(m_nCursor, other.m_nCursor);
 		swap(m_szFilename, other.m_szFilename);
 		swap(m_pInMemoryData, other.m_pInMemoryData);
+		swap(m_bMapped, other.m_bMapped);
 	}
 
 	bool IsInMemory() const { return m_pInMemoryData != 0; }
+	bool IsMapped() const   { return m_bMapped; }
 	void LoadToMemory(IMemoryBlock* pData = 0);
+	// maps the whole file with copy-on-write semantics, the pages are shared via the page cache with other processes
+	// returns false if mapping isn't supported on this platform or failed, the file is read through stdio then
+	bool MapToMemory();
 	void UnloadFromMemory();
 	void Close(bool bUnloadFromMem = true);
 